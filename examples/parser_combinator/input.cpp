@@ -0,0 +1,39 @@
+#include "input.h"
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+mapped_file::mapped_file(const std::string& path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		throw std::runtime_error("cannot open " + path);
+
+	struct stat st;
+	if(fstat(fd, &st) != 0) {
+		close(fd);
+		throw std::runtime_error("cannot stat " + path);
+	}
+
+	length = static_cast<std::size_t>(st.st_size);
+
+	// Mapping zero bytes is an error, but an empty file is fine to parse
+	if(length > 0) {
+		void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(p == MAP_FAILED) {
+			close(fd);
+			throw std::runtime_error("cannot map " + path);
+		}
+
+		madvise(p, length, MADV_SEQUENTIAL);
+		data = static_cast<const char*>(p);
+	}
+
+	close(fd);
+}
+
+mapped_file::~mapped_file() {
+	if(data)
+		munmap(const_cast<char*>(data), length);
+}
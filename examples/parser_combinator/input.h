@@ -0,0 +1,253 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <ostream>
+
+#ifndef PARSER_INPUT_H
+#define PARSER_INPUT_H
+
+/**
+ * A contiguous range of characters that is not owned.
+ *
+ * Parsers yield slices of their input rather than copies of it. A slice is
+ * hence only valid for as long as the input it was taken from.
+ */
+class slice {
+public:
+	constexpr slice() noexcept = default;
+	constexpr slice(const char* b, std::size_t n) noexcept : b(b), n(n) {}
+
+	const char* begin() const noexcept {
+		return b;
+	}
+
+	const char* end() const noexcept {
+		return b + n;
+	}
+
+	const char* data() const noexcept {
+		return b;
+	}
+
+	std::size_t size() const noexcept {
+		return n;
+	}
+
+	bool empty() const noexcept {
+		return n == 0;
+	}
+
+	char operator[] (std::size_t i) const noexcept {
+		return b[i];
+	}
+
+	/// Copy the slice into a string of its own
+	std::string str() const {
+		return std::string(b, n);
+	}
+
+private:
+	const char* b = nullptr;
+	std::size_t n = 0;
+};
+
+inline bool operator== (slice a, slice b) noexcept {
+	return a.size() == b.size()
+		&& std::char_traits<char>::compare(a.data(), b.data(), a.size()) == 0;
+}
+
+inline bool operator!= (slice a, slice b) noexcept {
+	return !(a == b);
+}
+
+inline std::ostream& operator<< (std::ostream& os, slice s) {
+	return os.write(s.data(), s.size());
+}
+
+/**
+ * Set of characters, as a 256 bit bitmap.
+ *
+ * Testing for membership is a shift and a mask, regardless of how many
+ * characters are in the set.
+ */
+class charset {
+public:
+	charset() noexcept = default;
+
+	/// The set of characters in `s`
+	charset(const char* s) noexcept {
+		for(; *s; ++s)
+			insert(*s);
+	}
+
+	/// \overload
+	charset(const std::string& s) noexcept {
+		for(char c : s)
+			insert(c);
+	}
+
+	void insert(char c) noexcept {
+		auto u = static_cast<unsigned char>(c);
+		bits[u >> 6] |= std::uint64_t(1) << (u & 63);
+	}
+
+	bool contains(char c) const noexcept {
+		auto u = static_cast<unsigned char>(c);
+		return (bits[u >> 6] >> (u & 63)) & 1;
+	}
+
+private:
+	std::uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+class memo_table;
+
+/**
+ * Cursor into a contiguous input buffer.
+ *
+ * This is what parsers are run on. Looking at and consuming characters are
+ * plain pointer operations; the cursor is cheap to copy, which is how a
+ * position is saved and restored.
+ *
+ * An input may also carry the memo table of the parse it belongs to, which
+ * memoising parsers store their results in.
+ *
+ * An input that is _partial_ may be followed by more, as when parsing a
+ * stream of network buffers. Parsers that run into the end of a partial
+ * input leave it _starved_, meaning their result might have been different
+ * given more input.
+ */
+class input {
+public:
+	constexpr input(
+			const char* b, std::size_t n, memo_table* m = nullptr) noexcept
+	: first(b), cur(b), last(b + n), memo(m) {}
+
+	/// The string must outlive the input
+	explicit input(const std::string& s, memo_table* m = nullptr) noexcept
+	: input(s.data(), s.size(), m) {}
+
+	/**
+	 * Whether the end of input has been reached.
+	 *
+	 * If it has, and the input is partial, the input becomes starved.
+	 */
+	bool empty() const noexcept {
+		if(cur != last)
+			return false;
+
+		starving = starving || partial;
+		return true;
+	}
+
+	/// Make the input partial, or complete
+	void set_partial(bool p) noexcept {
+		partial = p;
+	}
+
+	/// Whether some parser ran into the end of a partial input
+	bool starved() const noexcept {
+		return starving;
+	}
+
+	/// Characters left to parse
+	std::size_t size() const noexcept {
+		return last - cur;
+	}
+
+	/// Number of characters consumed so far
+	std::size_t offset() const noexcept {
+		return cur - first;
+	}
+
+	/// The next character. Only valid if `!empty()`.
+	char peek() const noexcept {
+		return *cur;
+	}
+
+	/// Consume `k` characters. There must be at least `k` left.
+	void advance(std::size_t k = 1) noexcept {
+		cur += k;
+	}
+
+	const char* position() const noexcept {
+		return cur;
+	}
+
+	/// Everything consumed since `pos`, taken from this input earlier
+	slice since(const char* pos) const noexcept {
+		return slice(pos, cur - pos);
+	}
+
+	/// Consume characters for as long as they are in `set`
+	slice skip(const charset& set) noexcept {
+		auto start = cur;
+		auto p = cur;
+
+		// Four at a time while there are that many left, then one at a time
+		while(last - p >= 4
+				&& set.contains(p[0]) && set.contains(p[1])
+				&& set.contains(p[2]) && set.contains(p[3]))
+			p += 4;
+
+		while(p != last && set.contains(*p))
+			++p;
+
+		cur = p;
+		empty();
+		return slice(start, p - start);
+	}
+
+	/// Move to an absolute offset, forwards or backwards
+	void seek(std::size_t offset) noexcept {
+		cur = first + offset;
+	}
+
+	/// The memo table of this parse, if any
+	memo_table* memos() const noexcept {
+		return memo;
+	}
+
+	void set_memos(memo_table* m) noexcept {
+		memo = m;
+	}
+
+private:
+	const char* first;
+	const char* cur;
+	const char* last;
+	memo_table* memo;
+	bool partial = false;
+	mutable bool starving = false;
+};
+
+/**
+ * Read-only memory mapping of a file.
+ *
+ * Lets a parser run on a file directly, without reading it through a stream
+ * first. Throws `std::runtime_error` if the file cannot be mapped.
+ */
+class mapped_file {
+public:
+	explicit mapped_file(const std::string& path);
+	mapped_file(const mapped_file&) = delete;
+	~mapped_file();
+
+	mapped_file& operator= (const mapped_file&) = delete;
+
+	/// A cursor at the start of the file's contents
+	input contents() const noexcept {
+		return input(data, length);
+	}
+
+	std::size_t size() const noexcept {
+		return length;
+	}
+
+private:
+	const char* data = nullptr;
+	std::size_t length = 0;
+};
+
+#endif
+
@@ -0,0 +1,139 @@
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <vector>
+#include <ftl/executor.h>
+#include "parser_combinator.h"
+
+#ifndef PARSER_RECORDS_H
+#define PARSER_RECORDS_H
+
+namespace records_detail {
+	// Counts down the chunks still being parsed
+	class latch {
+	public:
+		explicit latch(std::size_t n) noexcept : n(n) {}
+
+		void arrive() {
+			std::lock_guard<std::mutex> lock(m);
+			if(--n == 0)
+				cv.notify_all();
+		}
+
+		void wait() {
+			std::unique_lock<std::mutex> lock(m);
+			cv.wait(lock, [this](){ return n == 0; });
+		}
+
+	private:
+		std::mutex m;
+		std::condition_variable cv;
+		std::size_t n;
+	};
+
+	// Start of the record following the first delimiter at or after p
+	inline const char* next_record(
+			const char* p, const char* last, char delimiter) noexcept {
+		if(p >= last)
+			return last;
+
+		auto d = static_cast<const char*>(std::memchr(p, delimiter, last - p));
+		return d ? d + 1 : last;
+	}
+
+	// Parse every record in [first, last) in turn
+	template<typename T>
+	void parse_chunk(
+			const parser<T>& p, const char* first, const char* last,
+			char delimiter, std::vector<ftl::either<error,T>>& out) {
+		while(first < last) {
+			auto d = static_cast<const char*>(
+				std::memchr(first, delimiter, last - first)
+			);
+			auto end = d ? d : last;
+
+			input in(first, end - first);
+			out.push_back(run(p, in));
+
+			first = d ? d + 1 : last;
+		}
+	}
+}
+
+/**
+ * Parse a stream of delimited records in parallel.
+ *
+ * `source` is split into chunks of roughly `chunk_size` characters, each
+ * ending at a delimiter, and the records of every chunk are parsed by a task
+ * of their own on `ex`. The results are returned in the order the records
+ * appear in, one per record; a delimiter at the very end of the input does
+ * not start another one. Error offsets are relative to the start of their
+ * record.
+ *
+ * Each record is parsed on an input of its own, which `p` need not consume
+ * completely. Slices in the results refer to `source`. Blocks until all of
+ * the records have been parsed; should a parser throw, the first exception
+ * is rethrown once every task has finished.
+ *
+ * \tparam E must satisfy ftl's Executor concept, e.g. ftl::thread_pool
+ */
+template<typename T, typename E>
+std::vector<ftl::either<error,T>> parseRecords(
+		parser<T> p, input source, char delimiter, E& ex,
+		std::size_t chunk_size = std::size_t(1) << 20) {
+	using namespace records_detail;
+
+	const char* first = source.position();
+	const char* last = first + source.size();
+
+	if(chunk_size == 0)
+		chunk_size = 1;
+
+	// Chunk boundaries, each the start of a record
+	std::vector<const char*> bounds{first};
+	while(bounds.back() < last) {
+		auto b = bounds.back();
+		auto split = last - b > std::ptrdiff_t(chunk_size) ? b + chunk_size : last;
+		bounds.push_back(next_record(split, last, delimiter));
+	}
+
+	auto chunks = bounds.size() - 1;
+	std::vector<std::vector<ftl::either<error,T>>> results(chunks);
+	std::vector<std::exception_ptr> errors(chunks);
+	latch done(chunks);
+
+	for(std::size_t i = 0; i < chunks; ++i) {
+		ex.execute([&p,&bounds,&results,&errors,&done,delimiter,i]() {
+			try {
+				parse_chunk(p, bounds[i], bounds[i+1], delimiter, results[i]);
+			}
+			catch(...) {
+				errors[i] = std::current_exception();
+			}
+
+			done.arrive();
+		});
+	}
+
+	done.wait();
+
+	std::vector<ftl::either<error,T>> r;
+	std::size_t n = 0;
+	for(std::size_t i = 0; i < chunks; ++i) {
+		if(errors[i])
+			std::rethrow_exception(errors[i]);
+
+		n += results[i].size();
+	}
+
+	r.reserve(n);
+	for(auto& rs : results)
+		for(auto& x : rs)
+			r.push_back(std::move(x));
+
+	return r;
+}
+
+#endif
+
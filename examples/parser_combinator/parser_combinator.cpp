@@ -1,88 +1,191 @@
 #include "parser_combinator.h" 
+#include <atomic>
 #include <sstream>
 
 using namespace ftl;
 
+memo_table::memo_table()
+: index(0, key_hash(), std::equal_to<key>(), &arena) {}
+
+memo_table::~memo_table() {
+	index.clear();
+	while(entries) {
+		auto e = entries;
+		entries = e->next;
+		e->~entry();
+	}
+}
+
+std::size_t memo_table::new_id() noexcept {
+	static std::atomic<std::size_t> next{0};
+	return next++;
+}
+
+void error::add(const expectation& e) noexcept {
+	if(n < capacity)
+		es[n++] = e;
+	else
+		truncated = true;
+}
+
+error merge(const error& e1, const error& e2) {
+	if(e2.empty() || (!e1.empty() && e1.pos > e2.pos))
+		return e1;
+
+	if(e1.empty() || e2.pos > e1.pos)
+		return e2;
+
+	error e(e1);
+	for(std::size_t i = 0; i < e2.n; ++i)
+		e.add(e2.es[i]);
+
+	e.truncated = e.truncated || e2.truncated;
+	return e;
+}
+
+std::string error::message() const {
+	std::ostringstream oss;
+
+	for(std::size_t i = 0; i < n; ++i) {
+		if(i > 0)
+			oss << " or ";
+
+		auto& e = es[i];
+		switch(e.kind) {
+		case expectation::any_char:
+			oss << "any character";
+			break;
+
+		case expectation::character:
+			oss << "'" << e.c << "'";
+			break;
+
+		case expectation::not_character:
+			oss << "any character but '" << e.c << "'";
+			break;
+
+		case expectation::one_of:
+			oss << "one of \"" << *e.text << "\"";
+			break;
+
+		case expectation::custom:
+			oss << *e.text;
+			break;
+		}
+	}
+
+	if(truncated)
+		oss << " or more";
+
+	return oss.str();
+}
+
 parser<char> anyChar() {
-	return parser<char>([](std::istream& s) {
-		char ch;
-		if(s.get(ch)) {
+	return parser<char>([](input& in) {
+		if(!in.empty()) {
+			char ch = in.peek();
+			in.advance();
 			return yield(ch);
 		}
 
-		return fail<char>("any character");
+		return fail<char>(expectation{expectation::any_char, 0, nullptr}, in);
 	});
 }
 
 parser<char> parseChar(char c) {
-	return parser<char>{[c](std::istream& s) {
-		if(s) {
-			char ch = s.peek();
-			if(ch == c) {
-				// Don't forget to acutally eat a char from the stream too
-				s.get();
-				return yield(c);
-			}
+	return parser<char>{[c](input& in) {
+		if(!in.empty() && in.peek() == c) {
+			// Don't forget to acutally eat a char from the input too
+			in.advance();
+			return yield(c);
 		}
 
-		std::ostringstream oss;
-		oss << "'" << c << "'";
-		return fail<char>(oss.str());
+		return fail<char>(expectation{expectation::character, c, nullptr}, in);
 	}};
 }
 
 parser<char> notChar(char c) {
-	return parser<char>([c](std::istream& s) {
-		if(s) {
-			char ch = s.peek();
+	return parser<char>([c](input& in) {
+		if(!in.empty()) {
+			char ch = in.peek();
 			if(ch != c) {
-				s.get();
+				in.advance();
 				return yield(ch);
 			}
 		}
 
-		std::ostringstream oss;
-		oss << "any character but '" << c << "'";
-		return fail<char>(oss.str());
+		return fail<char>(
+			expectation{expectation::not_character, c, nullptr}, in
+		);
 	});
 }
 
 parser<char> oneOf(std::string str) {
-	return parser<char>{[str](std::istream& s) {
-		if(s) {
-			char peek = s.peek();
-			auto pos = str.find(peek);
-			if(pos != std::string::npos) {
-				s.get();
+	// Shared with every error, rather than copied into them
+	auto text = std::make_shared<const std::string>(std::move(str));
+	charset set(*text);
+
+	return parser<char>{[text,set](input& in) {
+		if(!in.empty()) {
+			char peek = in.peek();
+			if(set.contains(peek)) {
+				in.advance();
 				return yield(peek);
 			}
 		}
 
-		std::ostringstream oss;
-		oss << "one of \"" << str << "\"";
-		return fail<char>(oss.str());
+		return fail<char>(expectation{expectation::one_of, 0, text}, in);
 	}};
 }
 
-parser<std::string> many(parser<char> p) {
-	return parser<std::string>([p](std::istream& s) {
-		auto r = (*p)(s);
-		std::ostringstream oss;
-		while(r.template is<Right<char>>()) {
-			oss << *get<Right<char>>(r);
-			r = (*p)(s);
-		}
+namespace {
+	// Runs p until it fails, leaving in where the failing attempt started
+	void skipMany(const parser<char>& p, input& in) {
+		auto pos = in;
+		while((*p)(in).template is<Right<char>>())
+			pos = in;
+
+		in = pos;
+	}
+}
 
-		return yield(oss.str());
+parser<slice> many(parser<char> p) {
+	return parser<slice>([p](input& in) {
+		auto start = in.position();
+		skipMany(p, in);
+
+		return yield(in.since(start));
 	});
 }
 
-std::string prepend(char c, std::string s) {
-	s.insert(s.begin(), c);
-	return s;
+parser<slice> many1(parser<char> p) {
+	return parser<slice>([p](input& in) {
+		auto start = in.position();
+		auto r = (*p)(in);
+		if(r.template is<Left<error>>())
+			return ftl::make_left<slice>(*get<Left<error>>(r));
+
+		skipMany(p, in);
+
+		return yield(in.since(start));
+	});
 }
 
-parser<std::string> many1(parser<char> p) {
-	return curry(prepend) % p * many(p);
+parser<slice> takeWhile(charset set) {
+	return parser<slice>([set](input& in) {
+		return yield(in.skip(set));
+	});
 }
 
+parser<slice> takeWhile1(std::string str) {
+	auto text = std::make_shared<const std::string>(std::move(str));
+	charset set(*text);
+
+	return parser<slice>([text,set](input& in) {
+		auto s = in.skip(set);
+		if(s.empty())
+			return fail<slice>(expectation{expectation::one_of, 0, text}, in);
+
+		return yield(s);
+	});
+}
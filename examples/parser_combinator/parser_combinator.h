@@ -1,47 +1,99 @@
-#include <sstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <ftl/either_trans.h>
 #include <ftl/functional.h>
+#include <ftl/maybe.h>
+#include <ftl/memory_resource.h>
+#include "input.h"
 
 #ifndef PARSER_GEN_H
 #define PARSER_GEN_H
 
+/**
+ * Description of something a parser expected to find.
+ *
+ * Cheap to create and copy: nothing is formatted until the error it is part
+ * of is turned into a message.
+ */
+struct expectation {
+	enum kind_t { any_char, character, not_character, one_of, custom };
+
+	kind_t kind;
+
+	/// The character of \c character and \c not_character
+	char c;
+
+	/// The character set of \c one_of, or the message of \c custom
+	std::shared_ptr<const std::string> text;
+};
+
 /**
  * Error reporting class.
- * 
- * We could have used a string directly, but this thin wrapper conveys more
- * semantic information to users of the library.
+ *
+ * Rather than a message, an error holds the input offset it occurred at and
+ * what would have been accepted there. Errors of alternatives are merged
+ * by keeping those that got the furthest, and only formatted on request.
  */
 class error {
 public:
-	// Default versions of c-tors default, copy, and move are acceptable
+	/// Maximum number of expectations kept per error
+	static constexpr std::size_t capacity = 4;
+
+	/// An error expecting nothing, at the start of input
+	error() noexcept = default;
+
+	error(expectation e, std::size_t offset) noexcept
+	: pos(offset), n(1) {
+		es[0] = std::move(e);
+	}
 
 	/// Construct from string error message
-	explicit error(const std::string& msg) noexcept : e(msg) {}
-	explicit error(std::string&& msg) noexcept : e(std::move(msg)) {}
+	explicit error(std::string msg, std::size_t offset = 0)
+	: error(expectation{
+		expectation::custom, 0,
+		std::make_shared<const std::string>(std::move(msg))
+	}, offset) {}
 
-	/// Access the error message
-	std::string message() const noexcept {
-		return e;
+	/// The input offset the error occurred at
+	std::size_t offset() const noexcept {
+		return pos;
 	}
 
+	/// Whether anything at all was expected
+	bool empty() const noexcept {
+		return n == 0;
+	}
+
+	/**
+	 * Format the error message.
+	 *
+	 * Lists everything that was expected, separated by "or".
+	 */
+	std::string message() const;
+
+	/// Merge two errors, keeping the one (or both) that got the furthest
+	friend error merge(const error& e1, const error& e2);
+
 private:
-	std::string e;
+	void add(const expectation& e) noexcept;
+
+	std::size_t pos = 0;
+	std::size_t n = 0;
+	bool truncated = false;
+	expectation es[capacity];
 };
 
 namespace ftl {
 	template<>
 	struct monoid<error> {
-		static error id() {
-			return error(std::string(""));
+		static error id() noexcept {
+			return error();
 		}
 
 		static error append(const error& e1, const error& e2) {
-			if(e1.message().empty())
-				return error(e2.message());
-			if(e2.message().empty())
-				return error(e1.message());
-
-			return error(e1.message() + " or " + e2.message());
+			return merge(e1, e2);
 		}
 
 		static constexpr bool instance = true;
@@ -50,8 +102,8 @@ namespace ftl {
 
 /// Convenience function to reduce template gibberish
 template<typename T>
-ftl::either<error,T> fail(const std::string& s) {
-	return ftl::make_left<T>(error(s));
+ftl::either<error,T> fail(expectation e, const input& in) {
+	return ftl::make_left<T>(error(std::move(e), in.offset()));
 }
 
 /// Convenience function to reduce template gibberish
@@ -70,16 +122,219 @@ auto yield(T&& t) -> decltype(ftl::make_right<error>(std::forward<T>(t))) {
  * \li MonoidAlternative
  */
 template<typename T>
-using parser = ftl::eitherT<error,ftl::function<T(std::istream&)>>;
+using parser = ftl::eitherT<error,ftl::function<T(input&)>>;
+
+/**
+ * Results of memoising parsers, for one parse.
+ *
+ * Entries are keyed on the memoising parser and the input offset it was run
+ * at. Both they and the table's index are allocated from an arena that is
+ * released all at once, when the table is destroyed.
+ */
+class memo_table {
+public:
+	memo_table();
+	memo_table(const memo_table&) = delete;
+	~memo_table();
+
+	memo_table& operator= (const memo_table&) = delete;
+
+	/// Result of the parser `id` at `offset`, or `nullptr` if there is none
+	template<typename T>
+	const std::pair<ftl::either<error,T>,std::size_t>*
+	find(std::size_t id, std::size_t offset) const {
+		auto it = index.find(key{id, offset});
+		if(it == index.end())
+			return nullptr;
+
+		return &static_cast<const result<T>*>(it->second)->r;
+	}
+
+	/// Store a result of the parser `id` at `offset`, ending at `end`
+	template<typename T>
+	void insert(
+			std::size_t id, std::size_t offset,
+			const ftl::either<error,T>& r, std::size_t end) {
+		void* p = arena.allocate(sizeof(result<T>), alignof(result<T>));
+		auto e = new (p) result<T>(r, end);
+
+		e->next = entries;
+		entries = e;
+		index.emplace(key{id, offset}, e);
+	}
+
+	/// A new, unique parser id
+	static std::size_t new_id() noexcept;
+
+private:
+	struct entry {
+		virtual ~entry() = default;
+		entry* next = nullptr;
+	};
+
+	template<typename T>
+	struct result : entry {
+		result(const ftl::either<error,T>& r, std::size_t end) : r(r, end) {}
+		std::pair<ftl::either<error,T>,std::size_t> r;
+	};
+
+	using key = std::pair<std::size_t,std::size_t>;
+
+	struct key_hash {
+		std::size_t operator() (const key& k) const noexcept {
+			return k.first * 0x9e3779b97f4a7c15ull ^ k.second;
+		}
+	};
+
+	using index_t = std::unordered_map<
+		key, entry*, key_hash, std::equal_to<key>,
+		ftl::resource_allocator<std::pair<const key,entry*>>
+	>;
+
+	ftl::monotonic_buffer_resource arena;
+	index_t index;
+	entry* entries = nullptr;
+};
 
 /**
  * Function for running parsers.
+ *
+ * On return, `in` is positioned after whatever the parser consumed. If `in`
+ * does not have a memo table, one is provided for the duration of the parse.
  */
 template<typename T>
-ftl::either<error,T> run(parser<T> p, std::istream& is) {
-	return (*p)(is);
+ftl::either<error,T> run(parser<T> p, input& in) {
+	if(in.memos())
+		return (*p)(in);
+
+	memo_table memos;
+	in.set_memos(&memos);
+	auto r = (*p)(in);
+	in.set_memos(nullptr);
+
+	return r;
+}
+
+/// Run a parser on all of `s`, which must outlive any slices in the result
+template<typename T>
+ftl::either<error,T> run(parser<T> p, const std::string& s) {
+	input in(s);
+	return run(std::move(p), in);
 }
 
+/// State of a resumable parse
+enum class parse_status {
+	/// The parser needs more input to decide
+	partial,
+	/// The parser succeeded
+	done,
+	/// The parser failed
+	failed
+};
+
+/**
+ * A parse that can be fed its input piece by piece.
+ *
+ * Each call to `feed` hands the parser more input, for example a buffer read
+ * from a socket, and parses what is available so far. If the parser runs
+ * out of input before it could decide, the parse is `partial`, and resumes
+ * when more arrives. Once a parse is done, `next` starts the parser over on
+ * the input that it left, allowing a stream of messages to be parsed.
+ *
+ * Only the input of the message currently being parsed is kept. Resuming
+ * runs the parser from the start of that message again, with a fresh memo
+ * table, which is cheap as long as messages are small compared to the
+ * stream as a whole.
+ *
+ * \note Slices in a result refer to the buffer of the parse, and are only
+ *       valid until the next call to `feed` or `next`.
+ */
+template<typename T>
+class resumable {
+public:
+	explicit resumable(parser<T> p)
+	: p(std::move(p)), r(ftl::nothing<ftl::either<error,T>>()) {}
+
+	/// Append `n` characters of input, and parse if still partial
+	parse_status feed(const char* data, std::size_t n) {
+		buffer.append(data, n);
+		if(st == parse_status::partial)
+			parse();
+
+		return st;
+	}
+
+	/// \overload
+	parse_status feed(const std::string& data) {
+		return feed(data.data(), data.size());
+	}
+
+	/**
+	 * Signal the end of input.
+	 *
+	 * A partial parse is run a last time, making parsers that were waiting
+	 * for more input decide with what they have.
+	 */
+	parse_status finish() {
+		more = false;
+		if(st == parse_status::partial)
+			parse();
+
+		return st;
+	}
+
+	/// Discard the input of the last result, and parse the next message
+	parse_status next() {
+		buffer.erase(0, used);
+		used = 0;
+		st = parse_status::partial;
+		r = ftl::nothing<ftl::either<error,T>>();
+
+		if(!buffer.empty() || !more)
+			parse();
+
+		return st;
+	}
+
+	parse_status status() const noexcept {
+		return st;
+	}
+
+	/// The result of a done or failed parse
+	const ftl::either<error,T>& result() const {
+		return ftl::get<ftl::either<error,T>>(r);
+	}
+
+	/// Input not yet consumed by a parser
+	std::size_t buffered() const noexcept {
+		return buffer.size() - used;
+	}
+
+private:
+	void parse() {
+		input in(buffer);
+		in.set_partial(more);
+
+		auto res = run(p, in);
+		if(in.starved())
+			return;
+
+		st = res.template is<ftl::Right<T>>()
+			? parse_status::done
+			: parse_status::failed;
+
+		used = in.offset();
+		r = ftl::just(std::move(res));
+	}
+
+	parser<T> p;
+	std::string buffer;
+	std::size_t used = 0;
+	bool more = true;
+	parse_status st = parse_status::partial;
+	ftl::maybe<ftl::either<error,T>> r;
+};
+
 /* What follows is a basic set of blocks that a user of the library can
  * combine with the various combinators available (operator||, monad instance,
  * applicative instance, functor instance).
@@ -88,14 +343,14 @@ ftl::either<error,T> run(parser<T> p, std::istream& is) {
 /**
  * Parses any one character.
  *
- * This parser can only fail if the end of stream has been reached.
+ * This parser can only fail if the end of input has been reached.
  */
 parser<char> anyChar();
 
 /**
  * Parses one specific character.
  *
- * This parser will fail if the next character in the stream is not equal
+ * This parser will fail if the next character in the input is not equal
  * to \c c.
  */
 parser<char> parseChar(char c);
@@ -110,7 +365,7 @@ parser<char> notChar(char c);
 /**
  * Parses one of the characters in str.
  *
- * This parser will fail if the next character in the stream does not appear
+ * This parser will fail if the next character in the input does not appear
  * in str.
  */
 parser<char> oneOf(std::string str);
@@ -118,17 +373,34 @@ parser<char> oneOf(std::string str);
 /**
  * Greedily parses 0 or more of p.
  *
- * This parser cannot fail. If end of stream is reached or p fails on the
- * first run, the result will be an empty string.
+ * This parser cannot fail. If end of input is reached or p fails on the
+ * first run, the result will be an empty slice. The result refers to the
+ * input consumed by the successful runs of p; it is not a copy.
  */
-parser<std::string> many(parser<char> p);
+parser<slice> many(parser<char> p);
 
 /**
  * Greedily parses 1 or more of p.
  *
  * This parser will fail if the first attempt at parsing p fails.
  */
-parser<std::string> many1(parser<char> p);
+parser<slice> many1(parser<char> p);
+
+/**
+ * Parses 0 or more characters in set.
+ *
+ * Equivalent of `many(oneOf(...))`, except the characters are scanned
+ * directly, without running a parser per character.
+ */
+parser<slice> takeWhile(charset set);
+
+/**
+ * Parses 1 or more characters in set.
+ *
+ * Equivalent of `many1(oneOf(str))`, and fails with the same error if the
+ * first character is not in set.
+ */
+parser<slice> takeWhile1(std::string str);
 
 /**
  * Lazily run the parser generated by f
@@ -137,16 +409,87 @@ parser<std::string> many1(parser<char> p);
  */
 template<typename T>
 parser<T> lazy(ftl::function<parser<T>()> f) {
-	return parser<T>([f](std::istream& is) {
-		return (*f())(is);
+	return parser<T>([f](input& in) {
+		return (*f())(in);
 	});
 }
 
 /// \overload
 template<typename T>
 parser<T> lazy(parser<T>(*f)()) {
-	return parser<T>([f](std::istream& is) {
-			return (*f())(is);
+	return parser<T>([f](input& in) {
+			return (*f())(in);
+	});
+}
+
+/**
+ * Refer to a parser without copying it.
+ *
+ * Copying a `parser<T>` copies the whole chain of function objects it is
+ * built from. A rule that refers to itself, or is run very often, can be
+ * referred to like this instead. `p` must outlive the returned parser.
+ */
+template<typename T>
+parser<T> refer(const parser<T>& p) {
+	auto q = &p;
+	return parser<T>([q](input& in) {
+		return (**q)(in);
+	});
+}
+
+/**
+ * Run p, but consume no input if it fails.
+ *
+ * Alternation does not backtrack by itself: if the left hand side of `||`
+ * fails after consuming input, the right hand side starts where it stopped.
+ * Wrapping the left hand side in `attempt` makes it start over.
+ */
+template<typename T>
+parser<T> attempt(parser<T> p) {
+	return parser<T>([p](input& in) {
+		auto pos = in.offset();
+		auto r = (*p)(in);
+		if(r.template is<ftl::Left<error>>())
+			in.seek(pos);
+
+		return r;
+	});
+}
+
+/**
+ * Memoise the results of p, packrat style.
+ *
+ * The first time the returned parser is run at some input offset, within
+ * one parse, its result and where it stopped are stored in the memo table
+ * of the input. Subsequent runs at the same offset, e.g. when an enclosing
+ * alternative backtracks, reuse that instead of parsing again. Memoising
+ * the rules of a recursive grammar thus bounds the work done at each
+ * offset by the number of rules, making the parse linear in its input.
+ *
+ * The identity of a memoised rule is that of the parser returned here, so
+ * create it once per rule (e.g. as a function local static) rather than
+ * each time the rule is referred to. Without a memo table in the input,
+ * p is run as is.
+ */
+template<typename T>
+parser<T> memo(parser<T> p) {
+	auto id = memo_table::new_id();
+
+	return parser<T>([p,id](input& in) {
+		auto table = in.memos();
+		if(!table)
+			return (*p)(in);
+
+		auto start = in.offset();
+		if(auto m = table->template find<T>(id, start)) {
+			in.seek(m->second);
+			return m->first;
+		}
+
+		auto r = (*p)(in);
+		table->insert(id, start, r, in.offset());
+
+		return r;
 	});
 }
 
@@ -0,0 +1,325 @@
+#include <memory>
+#include <string>
+#include <type_traits>
+#include "parser_combinator.h"
+
+#ifndef PARSER_STATIC_H
+#define PARSER_STATIC_H
+
+/**
+ * Statically typed parser combinators.
+ *
+ * The parsers in this namespace are plain function objects, each of a type
+ * of its own, rather than `parser<T>`s wrapping an `ftl::function`. Combining
+ * them yields a new type describing the whole expression, such that
+ * `ch('a') || ch('b')` can be inlined as one would a hand written loop.
+ *
+ * Type erasure only happens where asked for, using `erase`, which turns any
+ * static parser into a `parser<T>`. Going the other way, `rule` embeds a
+ * `parser<T>`, which is how recursive grammars refer back to themselves.
+ *
+ * Every static parser `P` has a `value_type`, and is callable as
+ * `ftl::either<error,value_type>(input&)`.
+ */
+namespace sp {
+	/// Base of all static parsers, used to find the operators below
+	struct parser_base {};
+
+	template<typename P>
+	using is_parser = std::is_base_of<parser_base,P>;
+
+	/// Parses any one character
+	struct any_char : parser_base {
+		using value_type = char;
+
+		ftl::either<error,char> operator() (input& in) const {
+			if(!in.empty()) {
+				char c = in.peek();
+				in.advance();
+				return yield(c);
+			}
+
+			return fail<char>(expectation{expectation::any_char, 0, nullptr}, in);
+		}
+	};
+
+	/// Parses one specific character
+	struct ch : parser_base {
+		using value_type = char;
+
+		explicit ch(char c) noexcept : c(c) {}
+
+		ftl::either<error,char> operator() (input& in) const {
+			if(!in.empty() && in.peek() == c) {
+				in.advance();
+				return yield(c);
+			}
+
+			return fail<char>(expectation{expectation::character, c, nullptr}, in);
+		}
+
+		char c;
+	};
+
+	/// Parses any character except one
+	struct not_ch : parser_base {
+		using value_type = char;
+
+		explicit not_ch(char c) noexcept : c(c) {}
+
+		ftl::either<error,char> operator() (input& in) const {
+			if(!in.empty() && in.peek() != c) {
+				char r = in.peek();
+				in.advance();
+				return yield(r);
+			}
+
+			return fail<char>(
+				expectation{expectation::not_character, c, nullptr}, in
+			);
+		}
+
+		char c;
+	};
+
+	/// Parses one of a set of characters
+	struct one_of : parser_base {
+		using value_type = char;
+
+		explicit one_of(std::string str)
+		: text(std::make_shared<const std::string>(std::move(str)))
+		, set(*text) {}
+
+		ftl::either<error,char> operator() (input& in) const {
+			if(!in.empty() && set.contains(in.peek())) {
+				char c = in.peek();
+				in.advance();
+				return yield(c);
+			}
+
+			return fail<char>(expectation{expectation::one_of, 0, text}, in);
+		}
+
+		std::shared_ptr<const std::string> text;
+		charset set;
+	};
+
+	/// Parses 0 or more (or 1 or more, if `min1`) characters of a set
+	template<bool min1>
+	struct take_while_p : parser_base {
+		using value_type = slice;
+
+		explicit take_while_p(std::string str)
+		: text(std::make_shared<const std::string>(std::move(str)))
+		, set(*text) {}
+
+		ftl::either<error,slice> operator() (input& in) const {
+			auto s = in.skip(set);
+			if(min1 && s.empty())
+				return fail<slice>(expectation{expectation::one_of, 0, text}, in);
+
+			return yield(s);
+		}
+
+		std::shared_ptr<const std::string> text;
+		charset set;
+	};
+
+	using take_while = take_while_p<false>;
+	using take_while1 = take_while_p<true>;
+
+	/// Greedily parses 0 or more of a parser of characters, as a slice
+	template<typename P>
+	struct many_p : parser_base {
+		using value_type = slice;
+
+		explicit many_p(P p) : p(std::move(p)) {}
+
+		ftl::either<error,slice> operator() (input& in) const {
+			auto start = in.position();
+			auto pos = in;
+			while(p(in).template is<ftl::Right<char>>())
+				pos = in;
+
+			in = pos;
+			return yield(in.since(start));
+		}
+
+		P p;
+	};
+
+	template<typename P, typename = ftl::Requires<is_parser<P>::value>>
+	many_p<P> many(P p) {
+		return many_p<P>(std::move(p));
+	}
+
+	/// Try `p1`, then `p2` if `p1` failed, like `||` on `parser<T>`
+	template<typename P1, typename P2>
+	struct alt_p : parser_base {
+		using value_type = typename P1::value_type;
+
+		static_assert(
+			std::is_same<value_type,typename P2::value_type>::value,
+			"Both alternatives must parse the same type"
+		);
+
+		alt_p(P1 p1, P2 p2) : p1(std::move(p1)), p2(std::move(p2)) {}
+
+		ftl::either<error,value_type> operator() (input& in) const {
+			auto r1 = p1(in);
+			if(r1.template is<ftl::Right<value_type>>())
+				return r1;
+
+			auto r2 = p2(in);
+			if(r2.template is<ftl::Right<value_type>>())
+				return r2;
+
+			return ftl::make_left<value_type>(merge(
+				*ftl::get<ftl::Left<error>>(r1),
+				*ftl::get<ftl::Left<error>>(r2)
+			));
+		}
+
+		P1 p1;
+		P2 p2;
+	};
+
+	/// Run `p1`, then `p2`, keeping the result of `p2` (or of `p1`)
+	template<typename P1, typename P2, bool keep_first>
+	struct seq_p : parser_base {
+		using value_type = typename std::conditional<
+			keep_first, typename P1::value_type, typename P2::value_type
+		>::type;
+
+		seq_p(P1 p1, P2 p2) : p1(std::move(p1)), p2(std::move(p2)) {}
+
+		ftl::either<error,value_type> operator() (input& in) const {
+			return run(in, std::integral_constant<bool,keep_first>{});
+		}
+
+	private:
+		ftl::either<error,value_type> run(input& in, std::false_type) const {
+			auto r1 = p1(in);
+			if(r1.template is<ftl::Left<error>>())
+				return ftl::make_left<value_type>(
+					*ftl::get<ftl::Left<error>>(r1)
+				);
+
+			return p2(in);
+		}
+
+		ftl::either<error,value_type> run(input& in, std::true_type) const {
+			auto r1 = p1(in);
+			if(r1.template is<ftl::Left<error>>())
+				return r1;
+
+			auto r2 = p2(in);
+			if(r2.template is<ftl::Left<error>>())
+				return ftl::make_left<value_type>(
+					*ftl::get<ftl::Left<error>>(r2)
+				);
+
+			return r1;
+		}
+
+	public:
+		P1 p1;
+		P2 p2;
+	};
+
+	/// Apply `f` to the result of `p`
+	template<typename F, typename P>
+	struct map_p : parser_base {
+		using value_type = ftl::plain_type<
+			ftl::result_of<F(const typename P::value_type&)>
+		>;
+
+		map_p(F f, P p) : f(std::move(f)), p(std::move(p)) {}
+
+		ftl::either<error,value_type> operator() (input& in) const {
+			using T = typename P::value_type;
+
+			auto r = p(in);
+			if(r.template is<ftl::Left<error>>())
+				return ftl::make_left<value_type>(
+					*ftl::get<ftl::Left<error>>(r)
+				);
+
+			return yield(f(*ftl::get<ftl::Right<T>>(r)));
+		}
+
+		F f;
+		P p;
+	};
+
+	/// Static parser running a type erased one
+	template<typename T>
+	struct rule_p : parser_base {
+		using value_type = T;
+
+		explicit rule_p(::parser<T> p) : p(std::move(p)) {}
+
+		ftl::either<error,T> operator() (input& in) const {
+			return (*p)(in);
+		}
+
+		::parser<T> p;
+	};
+
+	/**
+	 * Embed a `parser<T>` in a static expression.
+	 *
+	 * Use together with `lazy` for rules that refer to themselves.
+	 */
+	template<typename T>
+	rule_p<T> rule(::parser<T> p) {
+		return rule_p<T>(std::move(p));
+	}
+
+	/// Type erase a static parser
+	template<
+			typename P,
+			typename T = typename P::value_type,
+			typename = ftl::Requires<is_parser<P>::value>
+	>
+	::parser<T> erase(P p) {
+		return ::parser<T>(ftl::function<ftl::either<error,T>(input&)>(
+			std::move(p)
+		));
+	}
+
+	template<
+			typename P1, typename P2,
+			typename = ftl::Requires<is_parser<P1>::value && is_parser<P2>::value>
+	>
+	alt_p<P1,P2> operator|| (P1 p1, P2 p2) {
+		return alt_p<P1,P2>(std::move(p1), std::move(p2));
+	}
+
+	template<
+			typename P1, typename P2,
+			typename = ftl::Requires<is_parser<P1>::value && is_parser<P2>::value>
+	>
+	seq_p<P1,P2,false> operator>> (P1 p1, P2 p2) {
+		return seq_p<P1,P2,false>(std::move(p1), std::move(p2));
+	}
+
+	template<
+			typename P1, typename P2,
+			typename = ftl::Requires<is_parser<P1>::value && is_parser<P2>::value>
+	>
+	seq_p<P1,P2,true> operator<< (P1 p1, P2 p2) {
+		return seq_p<P1,P2,true>(std::move(p1), std::move(p2));
+	}
+
+	template<
+			typename F, typename P,
+			typename = ftl::Requires<is_parser<P>::value>
+	>
+	map_p<F,P> operator% (F f, P p) {
+		return map_p<F,P>(std::move(f), std::move(p));
+	}
+}
+
+#endif
+
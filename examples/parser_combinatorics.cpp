@@ -1,13 +1,23 @@
+#include <chrono>
 #include <iostream>
-#include <limits>
+#include <stdexcept>
+#include <thread>
 #include <vector>
+#include <algorithm>
 #include <string>
+#include <unistd.h>
 #include <ftl/prelude.h>
 #include "parser_combinator/parser_combinator.h"
+#include "parser_combinator/static_parser.h"
+#include "parser_combinator/parse_records.h"
 
-// Workaround because stoi is not unary
-int string2int(const std::string& str) {
-	return std::stoi(str);
+// Digits are all that parseNatural lets through, so no checks are needed
+int string2int(slice digits) {
+	int n = 0;
+	for(char c : digits)
+		n = n*10 + (c - '0');
+
+	return n;
 }
 
 template<typename T>
@@ -17,14 +27,15 @@ parser<T> option(parser<T> p, T&& t) {
 	return p | ftl::monad<parser<T>>::pure(std::forward<T>(t));
 }
 
+// Leaf rules are built statically, and only type erased as a whole
 parser<int> parseNatural() {
-	using ftl::operator%;
+	using sp::operator%;
 
-	return string2int % many1(oneOf("0123456789"));
+	return sp::erase(string2int % sp::take_while1("0123456789"));
 }
 
-parser<std::string> whitespace() {
-	return many1(oneOf(" \t\r\n"));
+parser<slice> whitespace() {
+	return sp::erase(sp::take_while1(" \t\r\n"));
 }
 
 std::vector<int> cons(int n, std::vector<int> v) {
@@ -32,42 +43,154 @@ std::vector<int> cons(int n, std::vector<int> v) {
 	return v;
 }
 
+// Memoised once, so that every recursive reference shares its results
 parser<std::vector<int>> parseList() {
 	using namespace ftl;
 
-	return curry(cons)
+	static parser<std::vector<int>> list = memo(curry(cons)
 		% (parseNatural())
 		* option(
-			whitespace() >> lazy(parseList),
-			std::vector<int>());
+			attempt(whitespace() >> refer(list)),
+			std::vector<int>()));
+
+	return list;
 }
 
 parser<std::vector<int>> parseLispList() {
-	using namespace ftl;
-	return parseChar('(') >> parseList() << parseChar(')');
+	using namespace sp;
+	return erase(ch('(') >> rule(parseList()) << ch(')'));
 }
 
-int main(int, char**) {
+void print(const std::vector<int>& v) {
+	for(auto e : v) {
+		std::cout << e << ", ";
+	}
 
-	using std::string;
+	std::cout << std::endl;
+}
 
-	auto parser = parseLispList();
-	auto res = run(parser, std::cin);
+/*
+ * Parses whitespace separated lists from standard input as they arrive,
+ * in whatever pieces the stream happens to deliver them.
+ */
+int stream(parser<std::vector<int>> list) {
+	using ftl::operator<<;
+
+	resumable<std::vector<int>> r(list << takeWhile(" \t\r\n"));
+	char buf[4096];
 
-	while(res.isTypeAt<0>()) {
-		std::cout << "expected " << ftl::get<0>(res)->message() << std::endl;
+	auto status = parse_status::partial;
+	ssize_t n;
+	while((n = read(0, buf, sizeof buf)) > 0) {
+		status = r.feed(buf, n);
 
-		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		while(status == parse_status::done) {
+			print(*ftl::get<1>(r.result()));
+			status = r.next();
+		}
 
-		res = run(parser, std::cin);
+		if(status == parse_status::failed)
+			break;
 	}
 
-	for(auto e : *ftl::get<1>(res)) {
-		std::cout << e << ", ";
+	status = r.finish();
+	while(status == parse_status::done && r.buffered() > 0) {
+		print(*ftl::get<1>(r.result()));
+		status = r.next();
 	}
 
-	std::cout << std::endl;
+	if(status == parse_status::done) {
+		print(*ftl::get<1>(r.result()));
+		return 0;
+	}
 
-	return 0;
+	auto& e = *ftl::get<0>(r.result());
+	std::cout << "expected " << e.message() << std::endl;
+	return 1;
 }
 
+/*
+ * Parses a file of one list per line, in parallel, and reports the number
+ * of lists parsed and the throughput.
+ */
+int records(const char* path) {
+	mapped_file f(path);
+	ftl::thread_pool pool;
+	auto threads = std::max(1u, std::thread::hardware_concurrency());
+
+	auto start = std::chrono::steady_clock::now();
+	auto rs = parseRecords(parseLispList(), f.contents(), '\n', pool);
+	std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+
+	std::size_t failed = 0;
+	for(auto& r : rs)
+		failed += r.isTypeAt<0>();
+
+	auto mbs = f.size() / t.count() / (1 << 20);
+	std::cout << rs.size() << " records, " << failed << " failed, "
+		<< mbs << " MB/s (" << mbs / threads << " MB/s per core)"
+		<< std::endl;
+
+	return failed ? 1 : 0;
+}
+
+/*
+ * Parses the file given as argument, memory mapped, or else one line at a
+ * time from standard input, until a line parses. Given -s, parses standard
+ * input as a stream of lists instead, and given -r and a file, the lines
+ * of the file as separate records.
+ */
+int main(int argc, char** argv) {
+	auto parser = parseLispList();
+
+	if(argc > 1 && std::string(argv[1]) == "-s")
+		return stream(parser);
+
+	if(argc > 2 && std::string(argv[1]) == "-r") {
+		try {
+			return records(argv[2]);
+		}
+		catch(std::runtime_error& e) {
+			std::cerr << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	if(argc > 1) {
+		try {
+			mapped_file f(argv[1]);
+			auto in = f.contents();
+			auto res = run(parser, in);
+
+			if(res.isTypeAt<0>()) {
+				auto& e = *ftl::get<0>(res);
+				std::cout << "at offset " << e.offset() << ": expected "
+					<< e.message() << std::endl;
+				return 1;
+			}
+
+			print(*ftl::get<1>(res));
+			return 0;
+		}
+		catch(std::runtime_error& e) {
+			std::cerr << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	std::string line;
+	while(std::getline(std::cin, line)) {
+		auto res = run(parser, line);
+
+		if(res.isTypeAt<1>()) {
+			print(*ftl::get<1>(res));
+			return 0;
+		}
+
+		auto& e = *ftl::get<0>(res);
+		std::cout << "at column " << e.offset() + 1 << ": expected "
+			<< e.message() << std::endl;
+	}
+
+	return 1;
+}
@@ -0,0 +1,1221 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_ASYNC_H
+#define FTL_ASYNC_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "maybe.h"
+#include "either.h"
+#include "executor.h"
+#include "cancellation.h"
+#include "instrument.h"
+#include "trace.h"
+#include "concepts/monad.h"
+#include "concepts/monoid.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup async Async
+	 *
+	 * Asynchronous values with continuations, and their concept instances.
+	 *
+	 * \code
+	 *   #include <ftl/async.h>
+	 * \endcode
+	 *
+	 * Unlike the instances for `std::future` found in \ref future, the
+	 * computations built using the instances in this module run as soon as
+	 * their inputs are available, rather than when someone waits for them.
+	 *
+	 * This module adds the following concept instances to ftl::future:
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref monoidpg
+	 *
+	 * \par Dependencies
+	 * - `<atomic>`
+	 * - `<condition_variable>`
+	 * - `<exception>`
+	 * - `<future>`
+	 * - `<memory>`
+	 * - `<mutex>`
+	 * - `<tuple>`
+	 * - `<utility>`
+	 * - `<vector>`
+	 * - \ref maybe
+	 * - \ref either
+	 * - \ref executor
+	 * - \ref cancellation
+	 * - \ref trace
+	 * - \ref monad
+	 * - \ref monoid
+	 */
+
+	template<typename T>
+	class future;
+
+	template<typename T>
+	class promise;
+
+	template<typename L, typename M>
+	class eitherT;
+
+	namespace _dtl {
+		struct async_access;
+
+		/*
+		 * State shared between a promise and all of its futures.
+		 *
+		 * Continuations registered before the value is set are kept in a
+		 * list, and run by whichever thread ends up setting the value.
+		 * Continuations registered afterwards run immediately.
+		 */
+		template<typename T>
+		class async_state
+		: public std::enable_shared_from_this<async_state<T>> {
+		public:
+			template<typename...Args>
+			void set_value(Args&&...args) {
+				std::unique_lock<std::mutex> lock(m);
+				check_unsatisfied();
+				value = maybe<T>{constructor<T>(), std::forward<Args>(args)...};
+				complete(lock);
+			}
+
+			void set_exception(std::exception_ptr e) {
+				std::unique_lock<std::mutex> lock(m);
+				check_unsatisfied();
+				error = e;
+				complete(lock);
+			}
+
+			// As set_value, but does nothing if the state is already
+			// complete, returning whether it was not
+			template<typename...Args>
+			bool try_set_value(Args&&...args) {
+				std::unique_lock<std::mutex> lock(m);
+				if(done)
+					return false;
+
+				value = maybe<T>{constructor<T>(), std::forward<Args>(args)...};
+				complete(lock);
+				return true;
+			}
+
+			bool try_set_exception(std::exception_ptr e) {
+				std::unique_lock<std::mutex> lock(m);
+				if(done)
+					return false;
+
+				error = e;
+				complete(lock);
+				return true;
+			}
+
+			void on_ready(unique_function<void()> f) {
+				{
+					std::lock_guard<std::mutex> lock(m);
+					if(!done) {
+						continuations.push_back(std::move(f));
+						return;
+					}
+				}
+
+				f();
+			}
+
+			bool ready() const {
+				std::lock_guard<std::mutex> lock(m);
+				return done;
+			}
+
+			void wait() const {
+				std::unique_lock<std::mutex> lock(m);
+				cv.wait(lock, [this](){ return done; });
+			}
+
+			// Only valid once ready() is true
+			bool failed() const noexcept {
+				return static_cast<bool>(error);
+			}
+
+			std::exception_ptr exception() const noexcept {
+				return error;
+			}
+
+			const T& get() const {
+				wait();
+				if(error)
+					std::rethrow_exception(error);
+
+				return ftl::get<T>(value);
+			}
+
+		private:
+			void check_unsatisfied() const {
+				if(done)
+					throw std::future_error(
+						std::future_errc::promise_already_satisfied
+					);
+			}
+
+			void complete(std::unique_lock<std::mutex>& lock) {
+				done = true;
+				std::vector<unique_function<void()>> cs;
+				cs.swap(continuations);
+				lock.unlock();
+
+				cv.notify_all();
+				for(auto& c : cs)
+					c();
+			}
+
+			mutable std::mutex m;
+			mutable std::condition_variable cv;
+			bool done = false;
+			std::exception_ptr error;
+			maybe<T> value{constructor<Nothing>()};
+			std::vector<unique_function<void()>> continuations;
+		};
+
+		// Completes p with the result of applying f to the value in s
+		template<typename F, typename T, typename U>
+		void async_fulfil(const promise<U>& p, const F& f, async_state<T>& s) {
+			if(s.failed()) {
+				p.set_exception(s.exception());
+				return;
+			}
+
+			try {
+				p.set_value(f(s.get()));
+			}
+			catch(...) {
+				p.set_exception(std::current_exception());
+			}
+		}
+
+		/*
+		 * Continuation completing p with f applied to the value of *s.
+		 *
+		 * S is either a plain or a shared pointer to the state, depending on
+		 * whether the continuation is kept alive by the state itself.
+		 */
+		template<typename F, typename S, typename U>
+		struct async_then {
+			void operator() () const {
+				FTL_TRACE_SCOPE(continuation, nullptr);
+				async_fulfil(p, f, *s);
+			}
+
+			promise<U> p;
+			F f;
+			S s;
+		};
+
+		// Continuation scheduling an async_then on some executor
+		template<typename E, typename F, typename T, typename U>
+		struct async_then_on {
+			void operator() () {
+				ex->execute(async_then<F,std::shared_ptr<async_state<T>>,U>{
+					std::move(p), std::move(f), s->shared_from_this()
+				});
+			}
+
+			E* ex;
+			promise<U> p;
+			F f;
+			async_state<T>* s;
+		};
+
+		/*
+		 * Join point of an apply, completing p once both sf and st are ready.
+		 *
+		 * Registered with both states, the last of which to become ready
+		 * applies the function. The states are kept alive until then.
+		 */
+		template<typename F, typename T, typename U>
+		struct async_join {
+			void arrive() {
+				if(pending.fetch_sub(1) != 1)
+					return;
+
+				if(sf->failed()) {
+					p.set_exception(sf->exception());
+					return;
+				}
+
+				FTL_TRACE_SCOPE(continuation, nullptr);
+				async_fulfil(p, sf->get(), *st);
+			}
+
+			std::atomic<int> pending{2};
+			promise<U> p;
+			std::shared_ptr<async_state<F>> sf;
+			std::shared_ptr<async_state<T>> st;
+		};
+
+		// Fails s with operation_cancelled, unless it is already complete
+		template<typename T>
+		void async_cancel(async_state<T>& s) {
+			s.try_set_exception(std::make_exception_ptr(operation_cancelled()));
+		}
+
+		/*
+		 * Continuation deregistering a cancellation callback.
+		 *
+		 * Does so when destroyed rather than when run, so that the callback
+		 * goes both when the state it was registered for is complete and
+		 * when that state is abandoned without ever completing.
+		 */
+		struct async_deregister {
+			explicit async_deregister(cancellation_registration r) noexcept
+			: r(std::move(r)) {}
+
+			async_deregister(async_deregister&&) noexcept = default;
+
+			~async_deregister() {
+				r.deregister();
+			}
+
+			void operator() () const noexcept {}
+
+			cancellation_registration r;
+		};
+
+		// Fails s as soon as t is cancelled, without keeping s alive
+		template<typename T>
+		void async_cancel_on(
+				const cancellation_token& t,
+				const std::shared_ptr<async_state<T>>& s) {
+			std::weak_ptr<async_state<T>> w = s;
+			auto r = t.on_cancel([w]() {
+				if(auto s = w.lock())
+					async_cancel(*s);
+			});
+
+			s->on_ready(async_deregister(std::move(r)));
+		}
+
+		// As async_fulfil, unless t is cancelled or r already complete
+		template<typename F, typename T, typename U>
+		void async_try_fulfil(
+				async_state<U>& r, const F& f, async_state<T>& s,
+				const cancellation_token& t) {
+			if(t.cancelled()) {
+				async_cancel(r);
+				return;
+			}
+
+			if(s.failed()) {
+				r.try_set_exception(s.exception());
+				return;
+			}
+
+			try {
+				r.try_set_value(f(s.get()));
+			}
+			catch(...) {
+				r.try_set_exception(std::current_exception());
+			}
+		}
+
+		// async_then, skipped if its token is cancelled
+		template<typename F, typename T, typename U>
+		struct async_then_cancellable {
+			void operator() () const {
+				FTL_TRACE_SCOPE(continuation, nullptr);
+				async_try_fulfil(*r, f, *s, t);
+			}
+
+			std::shared_ptr<async_state<U>> r;
+			F f;
+			async_state<T>* s;
+			cancellation_token t;
+		};
+
+		// Task computing the value of p from f
+		template<typename F, typename T>
+		struct async_task : trace_name {
+			async_task(promise<T> p, F f, trace_name n)
+			: trace_name(n), p(std::move(p)), f(std::move(f)) {}
+
+			void operator() () const {
+				FTL_TRACE_SCOPE(async, name());
+				try {
+					p.set_value(f());
+				}
+				catch(...) {
+					p.set_exception(std::current_exception());
+				}
+			}
+
+			promise<T> p;
+			F f;
+		};
+
+		// async_task, skipped if its token is cancelled before it starts
+		template<typename F, typename T>
+		struct async_cancellable_task : trace_name {
+			async_cancellable_task(
+					std::shared_ptr<async_state<T>> s, F f,
+					cancellation_token t, trace_name n)
+			: trace_name(n), s(std::move(s)), f(std::move(f)), t(std::move(t)) {}
+
+			void operator() () const {
+				FTL_TRACE_SCOPE(async, name());
+				if(t.cancelled()) {
+					async_cancel(*s);
+					return;
+				}
+
+				try {
+					s->try_set_value(f());
+				}
+				catch(...) {
+					s->try_set_exception(std::current_exception());
+				}
+			}
+
+			std::shared_ptr<async_state<T>> s;
+			F f;
+			cancellation_token t;
+		};
+	}
+
+	/**
+	 * The writing end of an asynchronous value.
+	 *
+	 * A promise is used to produce the value of its associated ftl::future.
+	 * Copies of a promise all refer to the same shared state, hence it can be
+	 * handed to whichever thread will eventually compute the value.
+	 *
+	 * \note Setting the value (or exception) of a promise more than once
+	 *       results in a `std::future_error` being thrown.
+	 *
+	 * \warning A future whose promise is never satisfied will never be
+	 *          ready. Waiting for it will block forever.
+	 *
+	 * \ingroup async
+	 */
+	template<typename T>
+	class promise {
+	public:
+		promise() : state(std::make_shared<_dtl::async_state<T>>()) {
+			FTL_COUNT_ALLOCATION(async, sizeof(_dtl::async_state<T>));
+		}
+
+		promise(const promise&) = default;
+		promise(promise&&) = default;
+		~promise() = default;
+
+		promise& operator= (const promise&) = default;
+		promise& operator= (promise&&) = default;
+
+		/// Get a future that will eventually be given this promise's value.
+		future<T> get_future() const {
+			return future<T>{state};
+		}
+
+		/**
+		 * Set the value.
+		 *
+		 * Any continuation waiting for the value is run on the calling
+		 * thread, or scheduled on the executor it was registered with.
+		 */
+		void set_value(const T& t) const {
+			state->set_value(t);
+		}
+
+		/// \overload
+		void set_value(T&& t) const {
+			state->set_value(std::move(t));
+		}
+
+		/// Fail the computation with an exception.
+		void set_exception(std::exception_ptr e) const {
+			state->set_exception(e);
+		}
+
+	private:
+		std::shared_ptr<_dtl::async_state<T>> state;
+	};
+
+	/**
+	 * A value that will be available at some point in the future.
+	 *
+	 * In contrast to `std::future`, an `ftl::future` is copyable. Much
+	 * like `ftl::lazy`, all copies refer to the same computation, which is
+	 * why the value can only be accessed by `const` reference.
+	 *
+	 * Computations depending on the value can be attached using `then`. These
+	 * are run as soon as the value is ready, either on the thread completing
+	 * the computation, or on an \ref executorpg of choice.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref assignable
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref monoidpg, if `T` is a monoid.
+	 *
+	 * \ingroup async
+	 */
+	template<typename T>
+	class future {
+	public:
+		future() = delete;
+		future(const future&) = default;
+		future(future&&) = default;
+		~future() = default;
+
+		future& operator= (const future&) = default;
+		future& operator= (future&&) = default;
+
+		/// Check whether the value (or an exception) is available yet.
+		bool ready() const {
+			return state->ready();
+		}
+
+		/// Block until the value (or an exception) is available.
+		void wait() const {
+			state->wait();
+		}
+
+		/**
+		 * Get the value, waiting for it if need be.
+		 *
+		 * If the computation failed, its exception is rethrown.
+		 */
+		const T& get() const {
+			return state->get();
+		}
+
+		/**
+		 * Attach a continuation.
+		 *
+		 * `f` is invoked with the value as soon as it becomes available, on
+		 * the thread that sets it. If the value is already available, `f` is
+		 * invoked immediately, on the calling thread.
+		 *
+		 * Exceptions, be they thrown by `f` or stored in this future, are
+		 * propagated to the returned future.
+		 *
+		 * \tparam F must satisfy \ref fn`<U(T)>`. It need only be move
+		 *           constructible.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		future<U> then(F f) const {
+			promise<U> p;
+			auto r = p.get_future();
+			state->on_ready(_dtl::async_then<F,_dtl::async_state<T>*,U>{
+				std::move(p), std::move(f), state.get()
+			});
+
+			return r;
+		}
+
+		/**
+		 * Attach a continuation to be run on a particular executor.
+		 *
+		 * Equivalent of `then(f)`, except `f` is scheduled on `ex` once the
+		 * value is available.
+		 *
+		 * \tparam E must satisfy \ref executorpg
+		 */
+		template<
+				typename E,
+				typename F,
+				typename = Requires<Executor<E>{}>,
+				typename U = result_of<F(T)>
+		>
+		future<U> then(E& ex, F f) const {
+			promise<U> p;
+			auto r = p.get_future();
+			state->on_ready(_dtl::async_then_on<E,F,T,U>{
+				&ex, std::move(p), std::move(f), state.get()
+			});
+
+			return r;
+		}
+
+		/**
+		 * Attach a continuation that may be cancelled.
+		 *
+		 * Equivalent of `then(f)`, except that once `t` is cancelled, `f` is
+		 * no longer invoked, and the returned future fails with
+		 * ftl::operation_cancelled right away, whether or not this future
+		 * has become ready. An invocation of `f` already underway is not
+		 * interrupted, though its result is then discarded.
+		 *
+		 * \see \ref cancellation
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		future<U> then(const cancellation_token& t, F f) const {
+			promise<U> p;
+			auto r = p.get_future();
+			auto s = r.state;
+
+			_dtl::async_cancel_on(t, s);
+			state->on_ready(_dtl::async_then_cancellable<F,T,U>{
+				std::move(s), std::move(f), state.get(), t
+			});
+
+			return r;
+		}
+
+	private:
+		friend class promise<T>;
+
+		// bind needs to forward the state of futures of any type
+		template<typename>
+		friend struct monad;
+
+		friend struct _dtl::async_access;
+
+		explicit future(std::shared_ptr<_dtl::async_state<T>> s) noexcept
+		: state(std::move(s)) {}
+
+		std::shared_ptr<_dtl::async_state<T>> state;
+	};
+
+	/**
+	 * Run `f` on an executor, yielding its future result.
+	 *
+	 * \tparam E must satisfy \ref executorpg
+	 * \tparam F must satisfy \ref fn`<T()>`. It need only be move
+	 *           constructible.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::thread_executor ex;
+	 *   auto f = ftl::async(ex, [](){ return expensive(); });
+	 *   auto g = [](int x){ return x*2; } % f;
+	 *
+	 *   use(g.get());
+	 * \endcode
+	 *
+	 * \ingroup async
+	 */
+	template<typename E, typename F, typename T = result_of<F()>>
+	future<T> async(E& ex, F f) {
+		promise<T> p;
+		auto r = p.get_future();
+		ex.execute(_dtl::async_task<F,T>{
+			std::move(p), std::move(f), _dtl::trace_name{}
+		});
+
+		return r;
+	}
+
+	/**
+	 * Start a labelled asynchronous computation.
+	 *
+	 * Otherwise equivalent of the regular `async`. `l` names the trace
+	 * events of running `f`, and is ignored unless `FTL_TRACE` is defined.
+	 *
+	 * \see \ref trace
+	 *
+	 * \ingroup async
+	 */
+	template<typename E, typename F, typename T = result_of<F()>>
+	future<T> async(E& ex, trace_label l, F f) {
+		promise<T> p;
+		auto r = p.get_future();
+		ex.execute(_dtl::async_task<F,T>{
+			std::move(p), std::move(f), _dtl::trace_name{l}
+		});
+
+		return r;
+	}
+
+	/**
+	 * Monad instance for ftl::future.
+	 *
+	 * Every computation built using this instance is started as soon as
+	 * the values it depends on are ready. In particular, this means that
+	 * applying a function to several independent futures using `apply` lets
+	 * the computations of those futures run concurrently.
+	 *
+	 * Exceptions propagate through all operations.
+	 *
+	 * \ingroup async
+	 */
+	template<typename T>
+	struct monad<future<T>>
+	: deriving_join<in_terms_of_bind<future<T>>> {
+
+		/// Creates an already available future, holding `t`.
+		static future<T> pure(T t) {
+			promise<T> p;
+			p.set_value(std::move(t));
+			return p.get_future();
+		}
+
+		/// Equivalent of `f.then(fn)`
+		template<typename F, typename U = result_of<F(T)>>
+		static future<U> map(F fn, const future<T>& f) {
+			return f.then(std::move(fn));
+		}
+
+		/**
+		 * Apply a future function to a future value.
+		 *
+		 * The result is ready once _both_ `ff` and `f` are. Neither is waited
+		 * for by the calling thread, nor for each other: the function is
+		 * applied by whichever of the two is the last to become ready. Hence,
+		 * `g % a * b * c` is ready as soon as the slowest of `a`, `b`, and `c`.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		static future<U> apply(const future<F>& ff, const future<T>& f) {
+			using join = _dtl::async_join<F,T,U>;
+
+			auto j = std::make_shared<join>();
+			FTL_COUNT_ALLOCATION(async, sizeof(join));
+			j->sf = ff.state;
+			j->st = f.state;
+			auto r = j->p.get_future();
+
+			ff.state->on_ready([j](){ j->arrive(); });
+			f.state->on_ready([j](){ j->arrive(); });
+
+			return r;
+		}
+
+		/**
+		 * Sequence a future value with a computation depending on it.
+		 *
+		 * Once `f` is ready, `fn` is invoked with its value, and the
+		 * resulting future is forwarded to the future returned by `bind`.
+		 */
+		template<
+				typename F,
+				typename U = Value_type<result_of<F(T)>>
+		>
+		static future<U> bind(const future<T>& f, F fn) {
+			promise<U> p;
+			auto s = f.state.get();
+			f.state->on_ready([p,fn,s]() {
+				if(s->failed()) {
+					p.set_exception(s->exception());
+					return;
+				}
+
+				try {
+					auto fu = fn(s->get());
+					auto su = fu.state.get();
+					fu.state->on_ready([p,su]() {
+						_dtl::async_fulfil(p, [](const U& u){ return u; }, *su);
+					});
+				}
+				catch(...) {
+					p.set_exception(std::current_exception());
+				}
+			});
+
+			return p.get_future();
+		}
+
+#ifdef DOCUMENTATION_GENERATOR
+		/// Flattens a future of a future.
+		static future<T> join(const future<future<T>>& f);
+#endif
+
+		static constexpr bool instance = true;
+	};
+
+	/// The operands of an `apply` on ftl::future run concurrently
+	template<typename T>
+	struct independent_apply<future<T>> : std::true_type {};
+
+	namespace _dtl {
+		struct async_access {
+			template<typename T>
+			static const std::shared_ptr<async_state<T>>& state(
+					const future<T>& f) noexcept {
+				return f.state;
+			}
+		};
+
+		/*
+		 * Join point of a when_all over a vector, completing p once every
+		 * state is ready. The first failure completes p straight away; the
+		 * last state to become ready gathers the values, unless one failed.
+		 */
+		template<typename T>
+		struct async_all {
+			void arrive(const async_state<T>& s) {
+				if(s.failed() && !failed.exchange(true))
+					p.set_exception(s.exception());
+
+				if(pending.fetch_sub(1) != 1 || failed)
+					return;
+
+				try {
+					std::vector<T> v;
+					v.reserve(states.size());
+					for(auto& st : states)
+						v.push_back(st->get());
+
+					p.set_value(std::move(v));
+				}
+				catch(...) {
+					p.set_exception(std::current_exception());
+				}
+			}
+
+			std::atomic<std::size_t> pending;
+			std::atomic<bool> failed{false};
+			promise<std::vector<T>> p;
+			std::vector<std::shared_ptr<async_state<T>>> states;
+		};
+
+		// As async_all, for a fixed number of futures of different types
+		template<typename...Ts>
+		struct async_all_of {
+			template<typename S>
+			void arrive(const S& s) {
+				if(s.failed() && !failed.exchange(true))
+					p.set_exception(s.exception());
+
+				if(pending.fetch_sub(1) != 1 || failed)
+					return;
+
+				gather(gen_seq<0,sizeof...(Ts)-1>{});
+			}
+
+			template<std::size_t...I>
+			void gather(seq<I...>) {
+				try {
+					p.set_value(std::tuple<Ts...>(std::get<I>(states)->get()...));
+				}
+				catch(...) {
+					p.set_exception(std::current_exception());
+				}
+			}
+
+			template<std::size_t...I>
+			void listen(
+					const std::shared_ptr<async_all_of>& self, seq<I...>) {
+				int dummy[] = {(listen_to<I>(self), 0)...};
+				(void)dummy;
+			}
+
+			template<std::size_t I>
+			void listen_to(const std::shared_ptr<async_all_of>& self) {
+				auto s = std::get<I>(states).get();
+				s->on_ready([self,s](){ self->arrive(*s); });
+			}
+
+			std::atomic<std::size_t> pending{sizeof...(Ts)};
+			std::atomic<bool> failed{false};
+			promise<std::tuple<Ts...>> p;
+			std::tuple<std::shared_ptr<async_state<Ts>>...> states;
+		};
+
+		// Completes p with whichever of the states is the first to be ready
+		template<typename T>
+		struct async_any {
+			void arrive(std::size_t i, const async_state<T>& s) {
+				if(done.exchange(true))
+					return;
+
+				if(s.failed()) {
+					p.set_exception(s.exception());
+					return;
+				}
+
+				try {
+					p.set_value(std::make_pair(i, s.get()));
+				}
+				catch(...) {
+					p.set_exception(std::current_exception());
+				}
+			}
+
+			std::atomic<bool> done{false};
+			promise<std::pair<std::size_t,T>> p;
+		};
+	}
+
+	/**
+	 * Start an asynchronous computation that may be cancelled.
+	 *
+	 * Equivalent of the regular `async`, except that `f` is not run if `t`
+	 * is cancelled before `ex` gets around to it, and that the returned
+	 * future fails with ftl::operation_cancelled as soon as `t` is
+	 * cancelled. To stop once it has started, `f` should check `t` itself,
+	 * e.g. using `throw_if_cancelled`.
+	 *
+	 * \see \ref cancellation
+	 *
+	 * \ingroup async
+	 */
+	template<typename E, typename F, typename T = result_of<F()>>
+	future<T> async(E& ex, const cancellation_token& t, F f) {
+		promise<T> p;
+		auto r = p.get_future();
+		auto s = _dtl::async_access::state(r);
+
+		_dtl::async_cancel_on(t, s);
+		ex.execute(_dtl::async_cancellable_task<F,T>{
+			s, std::move(f), t, _dtl::trace_name{}
+		});
+
+		return r;
+	}
+
+	/**
+	 * Start an asynchronous computation on a `cancellable_executor`.
+	 *
+	 * The executor drops the task once its token is cancelled, so this
+	 * behaves as `async(ex, ex.token(), f)`, failing the returned future
+	 * with ftl::operation_cancelled, rather than leaving it to never
+	 * complete.
+	 *
+	 * \see \ref cancellation
+	 *
+	 * \ingroup async
+	 */
+	template<typename E, typename F, typename T = result_of<F()>>
+	future<T> async(cancellable_executor<E>& ex, F f) {
+		return async(ex, ex.token(), std::move(f));
+	}
+
+	/**
+	 * Start a labelled asynchronous computation on a `cancellable_executor`.
+	 *
+	 * Equivalent of the unlabelled version, with `l` naming the trace
+	 * events of running `f`, as in the regular labelled `async`.
+	 *
+	 * \ingroup async
+	 */
+	template<typename E, typename F, typename T = result_of<F()>>
+	future<T> async(cancellable_executor<E>& ex, trace_label l, F f) {
+		promise<T> p;
+		auto r = p.get_future();
+		auto s = _dtl::async_access::state(r);
+
+		_dtl::async_cancel_on(ex.token(), s);
+		ex.execute(_dtl::async_cancellable_task<F,T>{
+			s, std::move(f), ex.token(), _dtl::trace_name{l}
+		});
+
+		return r;
+	}
+
+	/**
+	 * Cancel `s` should `f` fail.
+	 *
+	 * Lets the failure of one part of a computation stop the others. For
+	 * instance, given a `when_all` or an `apply` over futures started using
+	 * tokens of `s`, the first of them to fail cancels those still pending
+	 * or running.
+	 *
+	 * \return `f`
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::cancellation_source stop;
+	 *   auto a = ftl::async(pool, stop.token(), fetch_a);
+	 *   auto b = ftl::async(pool, stop.token(), fetch_b);
+	 *
+	 *   auto both = ftl::cancel_on_failure(ftl::when_all(a, b), stop);
+	 * \endcode
+	 *
+	 * \ingroup async
+	 */
+	template<typename T>
+	future<T> cancel_on_failure(const future<T>& f, cancellation_source s) {
+		auto st = _dtl::async_access::state(f).get();
+		st->on_ready([st,s]() {
+			if(st->failed())
+				s.cancel();
+		});
+
+		return f;
+	}
+
+	/**
+	 * Cancel `s` should `f` fail, or result in a left value.
+	 *
+	 * Equivalent of `cancel_on_failure` for computations reporting errors
+	 * as `ftl::either`, such as an ftl::eitherT over ftl::future.
+	 *
+	 * A left value is not a failure of the future holding it, so applying
+	 * over such futures still waits for all of their operands. Attach this
+	 * to the operands, rather than to the result, to stop the others.
+	 *
+	 * \return `f`
+	 *
+	 * \ingroup async
+	 */
+	template<typename L, typename R>
+	future<either<L,R>> cancel_on_left(
+			const future<either<L,R>>& f, cancellation_source s) {
+		auto st = _dtl::async_access::state(f).get();
+		st->on_ready([st,s]() {
+			if(st->failed() || st->get().template is<Left<L>>())
+				s.cancel();
+		});
+
+		return f;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   using result = ftl::eitherT<error,ftl::future<int>>;
+	 *
+	 *   ftl::cancellation_source stop;
+	 *   // The first left value, or exception, stops the other lookup
+	 *   result a = ftl::cancel_on_left(
+	 *       result{ftl::async(pool, stop.token(), lookup_a)}, stop
+	 *   );
+	 *   result b = ftl::cancel_on_left(
+	 *       result{ftl::async(pool, stop.token(), lookup_b)}, stop
+	 *   );
+	 *
+	 *   auto sum = add % a * b;
+	 * \endcode
+	 *
+	 * \ingroup async
+	 */
+	template<typename L, typename T>
+	eitherT<L,future<T>> cancel_on_left(
+			const eitherT<L,future<T>>& e, cancellation_source s) {
+		cancel_on_left(*e, std::move(s));
+		return e;
+	}
+
+	/**
+	 * Future of the values of all of `fs`, once they are all available.
+	 *
+	 * No thread is blocked waiting for `fs`. Instead, all of them share a
+	 * single join point, holding a counter of the futures still pending, and
+	 * the last of them to become ready completes the result. It does so on
+	 * the thread that completes that last future; use `then(ex, f)` on the
+	 * result to continue on some particular executor.
+	 *
+	 * Should any of `fs` fail, the result fails with the exception of
+	 * whichever did so first, without waiting for the others.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<ftl::future<response>> calls;
+	 *   for(auto& b : backends)
+	 *       calls.push_back(ftl::async(pool, [&b](){ return b.query(); }));
+	 *
+	 *   auto all = ftl::when_all(calls).then(
+	 *       [](const std::vector<response>& rs){ return merge(rs); }
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup async
+	 */
+	template<typename T>
+	future<std::vector<T>> when_all(const std::vector<future<T>>& fs) {
+		using join = _dtl::async_all<T>;
+
+		if(fs.empty())
+			return monad<future<std::vector<T>>>::pure(std::vector<T>());
+
+		auto j = std::make_shared<join>();
+		FTL_COUNT_ALLOCATION(async, sizeof(join));
+		j->pending = fs.size();
+		j->states.reserve(fs.size());
+		for(auto& f : fs)
+			j->states.push_back(_dtl::async_access::state(f));
+
+		auto r = j->p.get_future();
+		for(auto& st : j->states) {
+			auto s = st.get();
+			s->on_ready([j,s](){ j->arrive(*s); });
+		}
+
+		return r;
+	}
+
+	/**
+	 * Future of a tuple of the values of `fs...`, once they are all ready.
+	 *
+	 * Works just like the version for vectors of futures, except the
+	 * futures may be of different types.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto r = ftl::when_all(user, orders).then(
+	 *       [](const std::tuple<user_info,std::vector<order>>& t) { ... }
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup async
+	 */
+	template<typename T, typename...Ts>
+	future<std::tuple<T,Ts...>> when_all(
+			const future<T>& f, const future<Ts>&...fs) {
+		using join = _dtl::async_all_of<T,Ts...>;
+
+		auto j = std::make_shared<join>();
+		FTL_COUNT_ALLOCATION(async, sizeof(join));
+		j->states = std::make_tuple(
+			_dtl::async_access::state(f), _dtl::async_access::state(fs)...
+		);
+
+		auto r = j->p.get_future();
+		j->listen(j, gen_seq<0,sizeof...(Ts)>{});
+
+		return r;
+	}
+
+	/**
+	 * Future of whichever of `fs` is the first to become available.
+	 *
+	 * The result is the index of that future in `fs`, along with its value.
+	 * Should it have failed, the result fails with that same exception.
+	 * Like ftl::when_all, `when_any` blocks no thread, and is completed by
+	 * the thread completing the first of `fs`.
+	 *
+	 * If `fs` is empty, the result fails with a `std::future_error` of
+	 * `std::future_errc::broken_promise`, as it could never be completed.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   // Use whichever replica answers first
+	 *   auto fastest = ftl::when_any(std::vector<ftl::future<int>>{
+	 *       ftl::async(pool, ask_primary), ftl::async(pool, ask_replica)
+	 *   });
+	 * \endcode
+	 *
+	 * \ingroup async
+	 */
+	template<typename T>
+	future<std::pair<std::size_t,T>> when_any(
+			const std::vector<future<T>>& fs) {
+		using join = _dtl::async_any<T>;
+
+		auto j = std::make_shared<join>();
+		FTL_COUNT_ALLOCATION(async, sizeof(join));
+		auto r = j->p.get_future();
+
+		if(fs.empty()) {
+			j->p.set_exception(std::make_exception_ptr(
+				std::future_error(std::future_errc::broken_promise)
+			));
+		}
+
+		for(std::size_t i = 0; i < fs.size(); ++i) {
+			auto s = _dtl::async_access::state(fs[i]).get();
+			s->on_ready([j,i,s](){ j->arrive(i, *s); });
+		}
+
+		return r;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup async
+	 */
+	template<typename T, typename...Ts>
+	future<std::pair<std::size_t,T>> when_any(
+			const future<T>& f, const future<Ts>&...fs) {
+		return when_any(std::vector<future<T>>{f, fs...});
+	}
+
+	/**
+	 * Monoid instance for ftl::future.
+	 *
+	 * \tparam T must satisfy \ref monoidpg
+	 *
+	 * \ingroup async
+	 */
+	template<typename T>
+	struct monoid<future<T>> {
+
+		/// Already available future holding `monoid<T>::id()`
+		static auto id()
+		-> typename std::enable_if<monoid<T>::instance,future<T>>::type {
+			return monad<future<T>>::pure(monoid<T>::id());
+		}
+
+		/**
+		 * Future of `f1.get() ^ f2.get()`.
+		 *
+		 * Neither `f1` nor `f2` is waited for by the calling thread.
+		 */
+		static auto append(const future<T>& f1, future<T> f2)
+		-> typename std::enable_if<monoid<T>::instance,future<T>>::type {
+			return monad<future<T>>::bind(f1, [f2](const T& a) {
+				return f2.then([a](const T& b) {
+					return monoid<T>::append(a, b);
+				});
+			});
+		}
+
+		/**
+		 * Future of the combination of all of `fs`.
+		 *
+		 * Waits for all of the futures at once, as by ftl::when_all, and
+		 * combines their values using `mconcat` once they are ready.
+		 *
+		 * \tparam I must satisfy \ref fwditerable, with futures as elements
+		 */
+		template<
+				typename I,
+				typename = Requires<
+					monoid<T>::instance && ForwardIterable<I>()
+				>
+		>
+		static future<T> mconcat(const I& fs) {
+			std::vector<future<T>> v(fs.begin(), fs.end());
+			return when_all(v).then([](const std::vector<T>& ts) {
+				return ftl::mconcat(ts);
+			});
+		}
+
+		static constexpr bool instance = monoid<T>::instance;
+	};
+}
+
+#endif
+
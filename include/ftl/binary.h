@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_BINARY_H
+#define FTL_BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include "sum_type.h"
+
+namespace ftl {
+	/**
+	 * \defgroup binary Binary Layout
+	 *
+	 * A stable binary layout for sum types, and views reading it in place.
+	 *
+	 * Any `sum_type` whose alternatives are all trivially copyable, such as
+	 * `maybe<int>` or `either<error_code,payload>`, can be written to a
+	 * buffer and matched on directly from there, without deserialising it
+	 * first. This is intended for passing values between processes, e.g.
+	 * through shared memory.
+	 *
+	 * \code
+	 *   #include <ftl/binary.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<cstddef>`
+	 * - `<cstdint>`
+	 * - `<cstring>`
+	 * - `<stdexcept>`
+	 * - `<type_traits>`
+	 * - \ref sum_type
+	 */
+
+	namespace _dtl {
+		constexpr std::size_t max_of(std::size_t n) noexcept {
+			return n;
+		}
+
+		template<typename...Ns>
+		constexpr std::size_t max_of(std::size_t n, std::size_t m, Ns...ns)
+		noexcept {
+			return max_of(n > m ? n : m, ns...);
+		}
+
+		constexpr std::size_t round_up(std::size_t n, std::size_t a) noexcept {
+			return (n + a - 1) / a * a;
+		}
+
+		// Empty alternatives take up no payload at all
+		template<typename T>
+		constexpr std::size_t payload_size() noexcept {
+			return std::is_empty<T>::value ? 0 : sizeof(T);
+		}
+	}
+
+	/**
+	 * Layout of a sum type written to a buffer.
+	 *
+	 * The layout is
+	 * - the index of the active alternative, in `tag_size` bytes, little
+	 *   endian, followed by
+	 * - padding up to `payload_offset`, and
+	 * - the object representation of the active alternative, padded with
+	 *   zeroes up to `size`.
+	 *
+	 * The payload is aligned to `alignment`, the strictest alignment of the
+	 * alternatives, provided the whole buffer is. `size` is a multiple of
+	 * it, so that arrays of written values stay aligned too.
+	 *
+	 * The tag means the same on any platform, while the payload is copied
+	 * byte for byte. Both sides hence need to agree on the representation
+	 * of the alternatives, as is the case between processes of one machine.
+	 * A sum type nested inside an alternative is copied as it is in memory,
+	 * not in this layout.
+	 *
+	 * \ingroup binary
+	 */
+	template<typename S>
+	struct binary_layout;
+
+	template<typename...Ts>
+	struct binary_layout<sum_type<Ts...>> {
+		static_assert(
+			All<std::is_trivially_copyable,Ts...>::value,
+			"Only sum types of trivially copyable alternatives have a layout"
+		);
+
+		/// Number of bytes the tag is stored in
+		static constexpr std::size_t tag_size = sizeof(
+			_dtl::index_type<sizeof...(Ts)>
+		);
+
+		/// Alignment the buffer must have for the payload to be aligned
+		static constexpr std::size_t alignment = _dtl::max_of(alignof(Ts)...);
+
+		/// Offset of the payload from the start of the buffer
+		static constexpr std::size_t payload_offset =
+			_dtl::round_up(tag_size, alignment);
+
+		/// Total number of bytes written
+		static constexpr std::size_t size = _dtl::round_up(
+			payload_offset + _dtl::max_of(_dtl::payload_size<Ts>()...),
+			alignment
+		);
+	};
+
+	template<typename...Ts>
+	constexpr std::size_t binary_layout<sum_type<Ts...>>::tag_size;
+
+	template<typename...Ts>
+	constexpr std::size_t binary_layout<sum_type<Ts...>>::alignment;
+
+	template<typename...Ts>
+	constexpr std::size_t binary_layout<sum_type<Ts...>>::payload_offset;
+
+	template<typename...Ts>
+	constexpr std::size_t binary_layout<sum_type<Ts...>>::size;
+
+	namespace _dtl {
+		struct write_payload {
+			template<typename T>
+			void operator() (const T& t) const noexcept {
+				std::memcpy(p, std::addressof(t), payload_size<T>());
+			}
+
+			unsigned char* p;
+		};
+
+		template<typename S, typename...Ts>
+		struct binary_access;
+
+		template<typename S, size_t...I, typename...Ts>
+		struct binary_access<S,seq<I...>,Ts...> {
+			template<size_t J>
+			static const type_at<J,Ts...>& ref(const unsigned char* p) noexcept {
+				return *reinterpret_cast<const type_at<J,Ts...>*>(p);
+			}
+
+			template<size_t J>
+			static S value_at(const unsigned char* p) {
+				using T = type_at<J,Ts...>;
+				return S{constructor<T>(), ref<J>(p)};
+			}
+
+			template<typename R, size_t J, typename...Fs>
+			static R visit_at(const unsigned char* p, Fs&&...fs) {
+				using T = type_at<J,Ts...>;
+				return union_visitor<R,T>::visit(
+					overload_tag<T>{}, ref<J>(p), std::forward<Fs>(fs)...
+				);
+			}
+
+			static S value(size_t i, const unsigned char* p) {
+				static constexpr S (*table[])(const unsigned char*) = {
+					&value_at<I>...
+				};
+
+				return table[i](p);
+			}
+
+			template<typename R, typename...Fs>
+			static R visit(size_t i, const unsigned char* p, Fs&&...fs) {
+				static constexpr R (*table[])(const unsigned char*, Fs&&...) = {
+					&visit_at<R,I,Fs...>...
+				};
+
+				return table[i](p, std::forward<Fs>(fs)...);
+			}
+		};
+	}
+
+	/**
+	 * Write `s` to `buffer` in its binary_layout.
+	 *
+	 * `buffer` must have room for `binary_layout<sum_type<Ts...>>::size`
+	 * bytes, which is also what is returned. It need not be aligned, but
+	 * a binary_view of it can only be taken if it is.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   using layout = ftl::binary_layout<ftl::maybe<int>>;
+	 *
+	 *   alignas(layout::alignment) unsigned char buf[layout::size];
+	 *   ftl::write(ftl::just(12), buf);
+	 * \endcode
+	 *
+	 * \ingroup binary
+	 */
+	template<typename...Ts>
+	std::size_t write(const sum_type<Ts...>& s, void* buffer) noexcept {
+		using layout = binary_layout<sum_type<Ts...>>;
+
+		auto b = static_cast<unsigned char*>(buffer);
+		auto i = _dtl::sum_type_accessor::activeIndex(s);
+
+		std::memset(b, 0, layout::size);
+		for(std::size_t k = 0; k < layout::tag_size; ++k)
+			b[k] = static_cast<unsigned char>(i >> (8 * k));
+
+		_dtl::sum_type_accessor::visit<void>(
+			s, _dtl::write_payload{b + layout::payload_offset}
+		);
+		return layout::size;
+	}
+
+	/**
+	 * Read-only view of a sum type written by ftl::write.
+	 *
+	 * Matching on a view hands the clauses references into the buffer
+	 * itself, so nothing is copied. The buffer must remain valid and
+	 * unchanged for as long as the view is used.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::binary_view<ftl::either<int,float>> v(shared_memory);
+	 *
+	 *   v.match(
+	 *       [](ftl::Left<int> e){ ... },
+	 *       [](ftl::Right<float> x){ ... }
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup binary
+	 */
+	template<typename S>
+	class binary_view;
+
+	template<typename...Ts>
+	class binary_view<sum_type<Ts...>> {
+		using access = _dtl::binary_access<
+			sum_type<Ts...>,gen_seq<0,sizeof...(Ts)-1>,Ts...
+		>;
+
+	public:
+		using layout = binary_layout<sum_type<Ts...>>;
+
+		/**
+		 * View the value at `buffer`.
+		 *
+		 * `buffer` must be aligned to `layout::alignment` and hold
+		 * `layout::size` bytes. Throws `invalid_sum_type_access` if the
+		 * tag does not name an alternative.
+		 */
+		explicit binary_view(const void* buffer)
+		: p(static_cast<const unsigned char*>(buffer)) {
+			if(index() >= sizeof...(Ts))
+				throw invalid_sum_type_access(
+					std::string("Buffer holds tag ")
+					+ std::to_string(index())
+					+ std::string(" of a sum type with ")
+					+ std::to_string(sizeof...(Ts))
+					+ std::string(" alternatives")
+				);
+		}
+
+		/**
+		 * View the value at `buffer`, of `n` bytes.
+		 *
+		 * Also throws `std::invalid_argument` if `buffer` is too small or
+		 * not suitably aligned.
+		 */
+		binary_view(const void* buffer, std::size_t n)
+		: binary_view(checked(buffer, n)) {}
+
+		/// Index of the alternative the buffer holds
+		std::size_t index() const noexcept {
+			std::size_t i = 0;
+			for(std::size_t k = 0; k < layout::tag_size; ++k)
+				i |= std::size_t(p[k]) << (8 * k);
+
+			return i;
+		}
+
+		template<typename T>
+		bool is() const noexcept {
+			return index() == index_of<T,Ts...>::value;
+		}
+
+		/**
+		 * Pattern match on the viewed value.
+		 *
+		 * Works exactly like sum_type::match, except the clauses are given
+		 * references into the buffer.
+		 */
+		template<typename...Fs>
+		auto match(Fs&&...fs) const -> typename ::ftl::_dtl::common_return_type<
+			type_seq<Ts...>,type_seq<Fs...>
+		>::type {
+			using return_type = typename _dtl::common_return_type<
+				type_seq<Ts...>,type_seq<Fs...>
+			>::type;
+
+			return access::template visit<return_type>(
+				index(), payload(), std::forward<Fs>(fs)...
+			);
+		}
+
+		/// Copy of the viewed value
+		sum_type<Ts...> value() const {
+			return access::value(index(), payload());
+		}
+
+		const void* data() const noexcept {
+			return p;
+		}
+
+	private:
+		template<typename T, typename...Us>
+		friend const T& get(const binary_view<sum_type<Us...>>&);
+
+		static const void* checked(const void* buffer, std::size_t n) {
+			if(n < layout::size)
+				throw std::invalid_argument("Buffer too small for a sum type");
+
+			if(reinterpret_cast<std::uintptr_t>(buffer) % layout::alignment)
+				throw std::invalid_argument("Buffer not aligned for a sum type");
+
+			return buffer;
+		}
+
+		const unsigned char* payload() const noexcept {
+			return p + layout::payload_offset;
+		}
+
+		const unsigned char* p;
+	};
+
+	/**
+	 * Reference to the alternative `T` of a viewed value, in the buffer.
+	 *
+	 * Throws `invalid_sum_type_access` if `T` is not the active alternative.
+	 *
+	 * \ingroup binary
+	 */
+	template<typename T, typename...Ts>
+	const T& get(const binary_view<sum_type<Ts...>>& v) {
+		constexpr auto I = index_of<T,Ts...>::value;
+
+		if(v.index() != I)
+			throw invalid_sum_type_access(
+				std::string("Viewing alternative ")
+				+ std::to_string(I)
+				+ std::string(", but active index is ")
+				+ std::to_string(v.index())
+			);
+
+		return *reinterpret_cast<const T*>(v.payload());
+	}
+
+	/**
+	 * Read a sum type written by ftl::write.
+	 *
+	 * Unlike a binary_view, `buffer` need not be aligned. Throws
+	 * `invalid_sum_type_access` if it does not hold a valid tag.
+	 *
+	 * \ingroup binary
+	 */
+	template<typename S>
+	S read(const void* buffer) {
+		using layout = binary_layout<S>;
+
+		alignas(layout::alignment) unsigned char b[layout::size];
+		std::memcpy(b, buffer, layout::size);
+
+		return binary_view<S>(b).value();
+	}
+}
+
+#endif
+
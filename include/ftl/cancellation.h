@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_CANCELLATION_H
+#define FTL_CANCELLATION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "function.h"
+#include "executor.h"
+#include "instrument.h"
+
+namespace ftl {
+	/**
+	 * \defgroup cancellation Cancellation
+	 *
+	 * Cooperative cancellation of asynchronous work.
+	 *
+	 * A `cancellation_source` is the side that decides work is no longer
+	 * wanted, and hands out `cancellation_token`s to the side doing it.
+	 * Nothing is ever interrupted: work that has not yet started is
+	 * skipped, and work in progress is expected to check its token at
+	 * convenient points, e.g. once per iteration of a long loop.
+	 *
+	 * \ref async uses tokens to skip tasks and continuations, and to fail
+	 * their futures with `ftl::operation_cancelled` as soon as the token is
+	 * cancelled.
+	 *
+	 * \code
+	 *   #include <ftl/cancellation.h>
+	 * \endcode
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::cancellation_source stop;
+	 *   auto t = stop.token();
+	 *
+	 *   auto f = ftl::async(pool, t, [t](){
+	 *       for(auto& chunk : chunks) {
+	 *           t.throw_if_cancelled();
+	 *           process(chunk);
+	 *       }
+	 *       return done();
+	 *   });
+	 *
+	 *   stop.cancel(); // f fails with ftl::operation_cancelled
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<algorithm>`
+	 * - `<atomic>`
+	 * - `<cstddef>`
+	 * - `<exception>`
+	 * - `<memory>`
+	 * - `<mutex>`
+	 * - `<type_traits>`
+	 * - `<utility>`
+	 * - `<vector>`
+	 * - \ref function
+	 * - \ref executor
+	 */
+
+	/**
+	 * Exception reporting that some work was cancelled.
+	 *
+	 * \ingroup cancellation
+	 */
+	class operation_cancelled : public std::exception {
+	public:
+		const char* what() const noexcept override {
+			return "operation cancelled";
+		}
+	};
+
+	namespace _dtl {
+		/*
+		 * Shared by a source and its tokens.
+		 *
+		 * Callbacks are run once, by whichever thread cancels, and dropped
+		 * afterwards. Until then, they are kept under an id by which they
+		 * can be deregistered; 0 is never used, and means there was nothing
+		 * to keep.
+		 */
+		class cancel_state {
+		public:
+			bool cancelled() const noexcept {
+				return flag.load(std::memory_order_acquire);
+			}
+
+			bool cancel() {
+				std::vector<callback> cs;
+				{
+					std::lock_guard<std::mutex> lock(m);
+					if(flag.load(std::memory_order_relaxed))
+						return false;
+
+					flag.store(true, std::memory_order_release);
+					cs.swap(callbacks);
+				}
+
+				for(auto& c : cs)
+					c.f();
+
+				return true;
+			}
+
+			std::size_t on_cancel(unique_function<void()> f) {
+				{
+					std::lock_guard<std::mutex> lock(m);
+					if(!flag.load(std::memory_order_relaxed)) {
+						callbacks.push_back(callback{++last_id, std::move(f)});
+						return last_id;
+					}
+				}
+
+				f();
+				return 0;
+			}
+
+			// Whether the callback was still kept, and thus never runs
+			bool deregister(std::size_t id) {
+				std::lock_guard<std::mutex> lock(m);
+				auto it = std::find_if(
+					callbacks.begin(), callbacks.end(),
+					[id](const callback& c){ return c.id == id; }
+				);
+
+				if(it == callbacks.end())
+					return false;
+
+				callbacks.erase(it);
+				return true;
+			}
+
+		private:
+			struct callback {
+				std::size_t id;
+				unique_function<void()> f;
+			};
+
+			std::atomic<bool> flag{false};
+			std::mutex m;
+			std::size_t last_id = 0;
+			std::vector<callback> callbacks;
+		};
+	}
+
+	/**
+	 * Handle to a callback registered with `cancellation_token::on_cancel`.
+	 *
+	 * Work that completes before being cancelled should deregister its
+	 * callbacks, or they stay with the source, along with everything they
+	 * refer to, for as long as it lives. Letting a registration go out of
+	 * scope leaves the callback registered.
+	 *
+	 * \par Concepts
+	 * - \ref defcons
+	 * - \ref movecons
+	 * - \ref moveassignable
+	 *
+	 * \ingroup cancellation
+	 */
+	class cancellation_registration {
+	public:
+		/// A registration of nothing
+		cancellation_registration() noexcept = default;
+
+		cancellation_registration(const cancellation_registration&) = delete;
+		cancellation_registration(cancellation_registration&&) noexcept
+			= default;
+
+		cancellation_registration& operator= (
+				const cancellation_registration&) = delete;
+		cancellation_registration& operator= (
+				cancellation_registration&&) noexcept = default;
+
+		/**
+		 * Remove the callback from its source.
+		 *
+		 * \return `true` if the callback was removed, `false` if it has
+		 *         already run, is running, or this registration is empty.
+		 *         The registration is empty afterwards.
+		 */
+		bool deregister() {
+			auto state = std::move(s);
+			return state && state->deregister(id);
+		}
+
+	private:
+		friend class cancellation_token;
+
+		cancellation_registration(
+				std::shared_ptr<_dtl::cancel_state> s, std::size_t id) noexcept
+		: s(id ? std::move(s) : nullptr), id(id) {}
+
+		std::shared_ptr<_dtl::cancel_state> s;
+		std::size_t id = 0;
+	};
+
+	class cancellation_source;
+
+	/**
+	 * The receiving end of a cancellation request.
+	 *
+	 * Copies all refer to the same source. A default constructed token has
+	 * no source, and is never cancelled.
+	 *
+	 * \par Concepts
+	 * - \ref defcons
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref assignable
+	 *
+	 * \ingroup cancellation
+	 */
+	class cancellation_token {
+	public:
+		/// A token that is never cancelled
+		cancellation_token() noexcept = default;
+
+		/// Whether cancellation has been requested.
+		bool cancelled() const noexcept {
+			return s && s->cancelled();
+		}
+
+		/// Whether the token has a source, and hence may ever be cancelled.
+		bool can_be_cancelled() const noexcept {
+			return static_cast<bool>(s);
+		}
+
+		/// Throw ftl::operation_cancelled if cancellation has been requested.
+		void throw_if_cancelled() const {
+			if(cancelled())
+				throw operation_cancelled();
+		}
+
+		/**
+		 * Have `f` invoked when cancellation is requested.
+		 *
+		 * `f` is run by the thread calling `cancel`, or right away if that
+		 * has already happened. It must not throw. Callbacks are kept by the
+		 * source until it is cancelled or destroyed, unless deregistered,
+		 * and are never invoked by a token that cannot be cancelled.
+		 *
+		 * \return A registration by which `f` can be removed again, empty
+		 *         if `f` has already run or never will.
+		 */
+		cancellation_registration on_cancel(unique_function<void()> f) const {
+			if(!s)
+				return cancellation_registration();
+
+			auto id = s->on_cancel(std::move(f));
+			return cancellation_registration(s, id);
+		}
+
+	private:
+		friend class cancellation_source;
+
+		explicit cancellation_token(std::shared_ptr<_dtl::cancel_state> s)
+		noexcept
+		: s(std::move(s)) {}
+
+		std::shared_ptr<_dtl::cancel_state> s;
+	};
+
+	/**
+	 * The requesting end of cancellation.
+	 *
+	 * Copies all refer to the same state, so a source may be handed to
+	 * whichever component gets to decide that work is no longer wanted.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref assignable
+	 *
+	 * \ingroup cancellation
+	 */
+	class cancellation_source {
+	public:
+		cancellation_source() : s(std::make_shared<_dtl::cancel_state>()) {
+			FTL_COUNT_ALLOCATION(async, sizeof(_dtl::cancel_state));
+		}
+
+		/// Get a token observing this source.
+		cancellation_token token() const noexcept {
+			return cancellation_token(s);
+		}
+
+		/**
+		 * Request cancellation.
+		 *
+		 * Runs every callback registered with the tokens of this source, on
+		 * the calling thread.
+		 *
+		 * \return `true` if this was the first request.
+		 */
+		bool cancel() const {
+			return s->cancel();
+		}
+
+		/// Whether cancellation has been requested.
+		bool cancelled() const noexcept {
+			return s->cancelled();
+		}
+
+	private:
+		std::shared_ptr<_dtl::cancel_state> s;
+	};
+
+	/**
+	 * Cancels a source when going out of scope.
+	 *
+	 * Ties the lifetime of some asynchronous work to that of a scope, so
+	 * that a caller that stops waiting for a result, be it by returning or
+	 * by throwing, also stops the work producing it.
+	 *
+	 * \ingroup cancellation
+	 */
+	class cancellation_guard {
+	public:
+		explicit cancellation_guard(cancellation_source s) noexcept
+		: s(std::move(s)) {}
+
+		cancellation_guard(const cancellation_guard&) = delete;
+		cancellation_guard& operator= (const cancellation_guard&) = delete;
+
+		~cancellation_guard() {
+			if(armed)
+				s.cancel();
+		}
+
+		/// Keep the source from being cancelled by the guard.
+		void release() noexcept {
+			armed = false;
+		}
+
+	private:
+		cancellation_source s;
+		bool armed = true;
+	};
+
+	namespace _dtl {
+		template<typename F>
+		struct cancellable_task {
+			void operator() () {
+				if(!token.cancelled())
+					f();
+			}
+
+			cancellation_token token;
+			F f;
+		};
+	}
+
+	/**
+	 * Executor skipping the tasks that have not started once cancelled.
+	 *
+	 * Wraps another executor, which does the actual running. Tasks already
+	 * running when the token is cancelled are left to finish.
+	 *
+	 * Dropped tasks are simply destroyed. `async` on this executor knows to
+	 * fail its future with ftl::operation_cancelled instead, but anything
+	 * else scheduled on it, such as a `future::then(ex, f)` continuation,
+	 * should be given the same token, or its result never completes.
+	 *
+	 * \tparam E must satisfy \ref executorpg
+	 *
+	 * \ingroup cancellation
+	 */
+	template<typename E>
+	class cancellable_executor {
+	public:
+		cancellable_executor(E& ex, cancellation_token t) noexcept
+		: ex(&ex), t(std::move(t)) {}
+
+		void execute(unique_function<void()> f) const {
+			if(t.cancelled())
+				return;
+
+			ex->execute(
+				_dtl::cancellable_task<unique_function<void()>>{t, std::move(f)}
+			);
+		}
+
+		/// The token tasks are checked against.
+		const cancellation_token& token() const noexcept {
+			return t;
+		}
+
+	private:
+		E* ex;
+		cancellation_token t;
+	};
+
+	/**
+	 * Wrap `ex` in a `cancellable_executor` observing `t`.
+	 *
+	 * \ingroup cancellation
+	 */
+	template<
+			typename E,
+			typename = typename std::enable_if<Executor<E>::value>::type
+	>
+	cancellable_executor<E> cancellable(E& ex, cancellation_token t) noexcept {
+		return cancellable_executor<E>(ex, std::move(t));
+	}
+}
+
+#endif
+
@@ -0,0 +1,631 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_CHANNEL_H
+#define FTL_CHANNEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "maybe.h"
+#include "executor.h"
+#include "instrument.h"
+#include "concepts/foldable.h"
+#include "concepts/monoid.h"
+
+namespace ftl {
+	/**
+	 * \defgroup channel Channel
+	 *
+	 * Bounded, concurrent queues connecting the stages of a pipeline.
+	 *
+	 * \code
+	 *   #include <ftl/channel.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to `ftl::channel`:
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 * - \ref monoidpg
+	 *
+	 * \par Dependencies
+	 * - `<atomic>`
+	 * - `<condition_variable>`
+	 * - `<mutex>`
+	 * - \ref maybe
+	 * - \ref executor
+	 * - \ref foldable
+	 * - \ref monoid
+	 */
+
+	template<typename T>
+	class channel;
+
+	namespace _dtl {
+		/*
+		 * Bounded multi-producer, multi-consumer ring buffer.
+		 *
+		 * Each slot carries a sequence number telling whether it is free for
+		 * the producer whose turn it is, or holds the element of the consumer
+		 * whose turn it is. Claiming a turn is a single compare and swap on
+		 * the producer or consumer position, so pushing and popping never
+		 * take a lock.
+		 *
+		 * Only blocking on a full or empty buffer does. Threads about to
+		 * block announce themselves in a waiter count, and the other side
+		 * only takes the mutex to wake them when that count is non-zero.
+		 */
+		template<typename T>
+		class channel_state {
+		public:
+			channel_state(
+					std::size_t capacity,
+					function<void(unique_function<void()>)> s)
+			: spawn(std::move(s)) {
+				std::size_t n = 1;
+				while(n < capacity)
+					n <<= 1;
+
+				mask = n - 1;
+				slots.reset(new slot[n]);
+				for(std::size_t i = 0; i < n; ++i)
+					slots[i].seq.store(i, std::memory_order_relaxed);
+			}
+
+			channel_state(const channel_state&) = delete;
+			channel_state& operator= (const channel_state&) = delete;
+
+			~channel_state() {
+				while(try_pop().template is<T>()) {}
+			}
+
+			std::size_t capacity() const noexcept {
+				return mask + 1;
+			}
+
+			template<typename U>
+			bool try_push(U&& u) {
+				auto pos = tail.load(std::memory_order_relaxed);
+				slot* s;
+				while(true) {
+					s = &slots[pos & mask];
+					auto seq = s->seq.load(std::memory_order_acquire);
+					auto diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+
+					if(diff == 0) {
+						if(tail.compare_exchange_weak(
+								pos, pos + 1, std::memory_order_relaxed))
+							break;
+					}
+					else if(diff < 0)
+						return false;
+					else
+						pos = tail.load(std::memory_order_relaxed);
+				}
+
+				new (&s->storage) T(std::forward<U>(u));
+				s->seq.store(pos + 1, std::memory_order_release);
+				wake(pop_waiters, not_empty);
+
+				return true;
+			}
+
+			maybe<T> try_pop() {
+				auto pos = head.load(std::memory_order_relaxed);
+				slot* s;
+				while(true) {
+					s = &slots[pos & mask];
+					auto seq = s->seq.load(std::memory_order_acquire);
+					auto diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos + 1);
+
+					if(diff == 0) {
+						if(head.compare_exchange_weak(
+								pos, pos + 1, std::memory_order_relaxed))
+							break;
+					}
+					else if(diff < 0)
+						return nothing<T>();
+					else
+						pos = head.load(std::memory_order_relaxed);
+				}
+
+				auto p = reinterpret_cast<T*>(&s->storage);
+				maybe<T> r = just(std::move(*p));
+				p->~T();
+				s->seq.store(pos + mask + 1, std::memory_order_release);
+				wake(push_waiters, not_full);
+
+				return r;
+			}
+
+			template<typename U>
+			bool push(U&& u) {
+				while(!is_closed()) {
+					if(try_push(std::forward<U>(u)))
+						return true;
+
+					wait(push_waiters, not_full, [this](){
+						return is_closed() || !full();
+					});
+				}
+
+				return false;
+			}
+
+			maybe<T> pop() {
+				while(true) {
+					auto r = try_pop();
+					if(r.template is<T>())
+						return r;
+
+					// Elements pushed before closing are still delivered
+					if(is_closed() && empty())
+						return r;
+
+					wait(pop_waiters, not_empty, [this](){
+						return is_closed() || !empty();
+					});
+				}
+			}
+
+			void close() {
+				closed.store(true, std::memory_order_seq_cst);
+
+				std::lock_guard<std::mutex> lock(m);
+				not_empty.notify_all();
+				not_full.notify_all();
+			}
+
+			bool is_closed() const noexcept {
+				return closed.load(std::memory_order_seq_cst);
+			}
+
+			// Where the stages reading from this channel are run
+			function<void(unique_function<void()>)> spawn;
+
+		private:
+			static_assert(
+				std::is_nothrow_move_constructible<T>::value,
+				"Elements of a channel must be nothrow move constructible"
+			);
+
+			struct slot {
+				std::atomic<std::size_t> seq;
+				typename std::aligned_storage<
+					sizeof(T), alignof(T)
+				>::type storage;
+			};
+
+			// Both only approximate while other threads are at work
+			bool empty() const noexcept {
+				return head.load(std::memory_order_seq_cst)
+					>= tail.load(std::memory_order_seq_cst);
+			}
+
+			bool full() const noexcept {
+				return tail.load(std::memory_order_seq_cst)
+					- head.load(std::memory_order_seq_cst) > mask;
+			}
+
+			void wake(std::atomic<int>& waiters, std::condition_variable& cv) {
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if(waiters.load(std::memory_order_seq_cst) > 0) {
+					std::lock_guard<std::mutex> lock(m);
+					cv.notify_all();
+				}
+			}
+
+			template<typename P>
+			void wait(
+					std::atomic<int>& waiters, std::condition_variable& cv,
+					P ready) {
+				std::unique_lock<std::mutex> lock(m);
+				waiters.fetch_add(1, std::memory_order_seq_cst);
+				cv.wait(lock, ready);
+				waiters.fetch_sub(1, std::memory_order_seq_cst);
+			}
+
+			// Producers and consumers kept on cache lines of their own
+			std::atomic<std::size_t> head{0};
+			char pad0[64 - sizeof(std::atomic<std::size_t>)];
+			std::atomic<std::size_t> tail{0};
+			char pad1[64 - sizeof(std::atomic<std::size_t>)];
+
+			std::unique_ptr<slot[]> slots;
+			std::size_t mask;
+			std::atomic<bool> closed{false};
+
+			std::mutex m;
+			std::condition_variable not_empty;
+			std::condition_variable not_full;
+			std::atomic<int> pop_waiters{0};
+			std::atomic<int> push_waiters{0};
+		};
+
+		template<typename E>
+		struct executor_spawn {
+			void operator() (unique_function<void()> f) const {
+				ex->execute(std::move(f));
+			}
+
+			E* ex;
+		};
+	}
+
+	/**
+	 * A bounded queue for passing values between threads.
+	 *
+	 * Any number of threads may push values into a channel, and any number
+	 * of threads may pop them. Values are delivered in the order they were
+	 * pushed, each to exactly one consumer. Pushing and popping never take a
+	 * lock; only producers finding the channel full, and consumers finding
+	 * it empty, block until that changes. This is the channel's back
+	 * pressure: a stage can never get more than `capacity()` values ahead
+	 * of the stage after it.
+	 *
+	 * Once a channel is closed, pushing fails, and popping returns the
+	 * values still in the channel, and then `nothing`.
+	 *
+	 * Copies of a channel refer to the same queue. The queue lives for as
+	 * long as any copy does.
+	 *
+	 * Stages created by mapping a function over a channel, or by appending
+	 * channels, run as tasks on the executor given at construction, which
+	 * defaults to starting a thread per stage. Each stage occupies its task
+	 * until its input is closed, so an executor with fewer threads than the
+	 * pipeline has stages would deadlock.
+	 *
+	 * \tparam T must be nothrow move constructible.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref functorpg
+	 * - \ref foldablepg, consuming the channel until it is closed
+	 * - \ref monoidpg, merging channels
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::thread_pool pool(4);
+	 *   ftl::channel<std::string> lines(64, pool);
+	 *
+	 *   // Parsing runs concurrently with reading, and summing
+	 *   auto sizes = [](const std::string& s){ return s.size(); } % lines;
+	 *
+	 *   pool.execute([lines]() {
+	 *       std::string l;
+	 *       while(std::getline(std::cin, l))
+	 *           lines.push(l);
+	 *
+	 *       lines.close();
+	 *   });
+	 *
+	 *   auto total = ftl::foldl(std::plus<std::size_t>(), 0, sizes);
+	 * \endcode
+	 *
+	 * \ingroup channel
+	 */
+	template<typename T>
+	class channel {
+	public:
+		/// A channel of at least `capacity` values, starting stages as threads
+		explicit channel(std::size_t capacity)
+		: channel(capacity, function<void(unique_function<void()>)>{
+			_dtl::executor_spawn<const thread_executor>{&detached()}
+		})
+		{}
+
+		/**
+		 * A channel whose stages are run on `ex`.
+		 *
+		 * The executor must outlive every stage started on it.
+		 *
+		 * \tparam E must satisfy \ref executorpg
+		 */
+		template<typename E, typename = Requires<Executor<E>{}>>
+		channel(std::size_t capacity, E& ex)
+		: channel(capacity, function<void(unique_function<void()>)>{
+			_dtl::executor_spawn<E>{&ex}
+		})
+		{}
+
+		channel(const channel&) = default;
+		channel(channel&&) = default;
+		~channel() = default;
+
+		channel& operator= (const channel&) = default;
+		channel& operator= (channel&&) = default;
+
+		/**
+		 * Push a value, waiting for room if the channel is full.
+		 *
+		 * \return `false` if the channel is, or becomes, closed before the
+		 *         value could be pushed.
+		 */
+		bool push(const T& t) const {
+			return state->push(t);
+		}
+
+		/// \overload
+		bool push(T&& t) const {
+			return state->push(std::move(t));
+		}
+
+		/**
+		 * Push a value, unless the channel is full.
+		 *
+		 * Does not check whether the channel is closed.
+		 */
+		bool try_push(const T& t) const {
+			return state->try_push(t);
+		}
+
+		/// \overload
+		bool try_push(T&& t) const {
+			return state->try_push(std::move(t));
+		}
+
+		/**
+		 * Pop a value, waiting for one if the channel is empty.
+		 *
+		 * \return `nothing` once the channel is closed and empty.
+		 */
+		maybe<T> pop() const {
+			return state->pop();
+		}
+
+		/// Pop a value if there is one, without waiting
+		maybe<T> try_pop() const {
+			return state->try_pop();
+		}
+
+		/**
+		 * Close the channel.
+		 *
+		 * Wakes every producer and consumer that is waiting. Values already
+		 * in the channel may still be popped.
+		 */
+		void close() const {
+			state->close();
+		}
+
+		bool closed() const noexcept {
+			return state->is_closed();
+		}
+
+		/// The number of values the channel holds when full
+		std::size_t capacity() const noexcept {
+			return state->capacity();
+		}
+
+	private:
+		template<typename U> friend class channel;
+		template<typename> friend struct functor;
+		friend struct monoid<channel<T>>;
+
+		channel(std::size_t capacity, function<void(unique_function<void()>)> s)
+		: state((
+			FTL_COUNT_ALLOCATION(async, sizeof(_dtl::channel_state<T>)),
+			std::make_shared<_dtl::channel_state<T>>(
+				capacity == 0 ? 1 : capacity, std::move(s)
+			)
+		))
+		{}
+
+		static const thread_executor& detached() noexcept {
+			static const thread_executor ex{};
+			return ex;
+		}
+
+		// A new channel, running its stages where those of like are run
+		template<typename U>
+		static channel similar(const channel<U>& like, std::size_t capacity) {
+			return channel(capacity, like.state->spawn);
+		}
+
+		// Run f on the executor of this channel
+		void spawn(unique_function<void()> f) const {
+			state->spawn(std::move(f));
+		}
+
+		std::shared_ptr<_dtl::channel_state<T>> state;
+	};
+
+	template<typename T>
+	struct parametric_type_traits<channel<T>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = channel<U>;
+	};
+
+	namespace _dtl {
+		// Pops every value of in, as `f(x)` into out
+		template<typename F, typename T, typename U>
+		struct map_stage {
+			void operator() () {
+				try {
+					while(true) {
+						auto x = in.pop();
+						if(!x.template is<T>())
+							break;
+
+						if(!out.push(f(std::move(get<T>(x)))))
+							break;
+					}
+				}
+				catch(...) {}
+
+				out.close();
+			}
+
+			F f;
+			channel<T> in;
+			channel<U> out;
+		};
+
+		// Forwards in to out, closing out if it is the last one left
+		template<typename T>
+		struct merge_stage {
+			void operator() () {
+				while(true) {
+					auto x = in.pop();
+					if(!x.template is<T>() || !out.push(std::move(get<T>(x))))
+						break;
+				}
+
+				if(left->fetch_sub(1, std::memory_order_acq_rel) == 1)
+					out.close();
+			}
+
+			channel<T> in;
+			channel<T> out;
+			std::shared_ptr<std::atomic<int>> left;
+		};
+	}
+
+	/**
+	 * Functor instance for channels.
+	 *
+	 * Mapping a function over a channel starts a stage on the channel's
+	 * executor, which pops values from it, and pushes the results into the
+	 * new channel that is returned. That channel has the capacity and
+	 * executor of the original, and is closed when the original is closed
+	 * and drained, when the result channel is closed by its consumers, or
+	 * when the function throws.
+	 *
+	 * \ingroup channel
+	 */
+	template<typename T>
+	struct functor<channel<T>> {
+		template<typename F, typename U = result_of<F(T)>>
+		static channel<U> map(F f, const channel<T>& c) {
+			auto out = channel<U>::similar(c, c.capacity());
+			c.spawn(_dtl::map_stage<F,T,U>{std::move(f), c, out});
+
+			return out;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for channels.
+	 *
+	 * Folding a channel pops every value from it, until it is closed, and
+	 * hence blocks until then. Values popped by other consumers in the
+	 * meantime are not part of the fold. Right folds first collect every
+	 * value.
+	 *
+	 * \ingroup channel
+	 */
+	template<typename T>
+	struct foldable<channel<T>>
+	: deriving_foldMap<channel<T>>, deriving_fold<channel<T>> {
+		template<
+				typename Fn,
+				typename U,
+				typename = Requires<
+					std::is_convertible<U, result_of<Fn(U,T)>>::value
+				>
+		>
+		static U foldl(Fn&& fn, U z, const channel<T>& c) {
+			while(true) {
+				auto x = c.pop();
+				if(!x.template is<T>())
+					return z;
+
+				z = fn(std::move(z), std::move(get<T>(x)));
+			}
+		}
+
+		template<
+				typename Fn,
+				typename U,
+				typename = Requires<
+					std::is_convertible<U, result_of<Fn(T,U)>>::value
+				>
+		>
+		static U foldr(Fn&& fn, U z, const channel<T>& c) {
+			std::vector<T> v;
+			while(true) {
+				auto x = c.pop();
+				if(!x.template is<T>())
+					break;
+
+				v.push_back(std::move(get<T>(x)));
+			}
+
+			for(auto it = v.rbegin(); it != v.rend(); ++it) {
+				z = fn(std::move(*it), std::move(z));
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid instance for channels, merging them.
+	 *
+	 * The identity is a closed, empty channel. Appending two channels starts
+	 * a stage per operand on the executor of the first, forwarding its
+	 * values to a new channel, which is closed once both operands are. The
+	 * values of each operand arrive in order, but they are interleaved in
+	 * whatever order they happen to be pushed.
+	 *
+	 * \ingroup channel
+	 */
+	template<typename T>
+	struct monoid<channel<T>> {
+		static channel<T> id() {
+			channel<T> c(1);
+			c.close();
+
+			return c;
+		}
+
+		static channel<T> append(const channel<T>& c1, const channel<T>& c2) {
+			auto out = channel<T>::similar(
+				c1, std::max(c1.capacity(), c2.capacity())
+			);
+
+			auto left = std::make_shared<std::atomic<int>>(2);
+			c1.spawn(_dtl::merge_stage<T>{c1, out, left});
+			c1.spawn(_dtl::merge_stage<T>{c2, out, left});
+
+			return out;
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
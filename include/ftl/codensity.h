@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_CODENSITY_H
+#define FTL_CODENSITY_H
+
+#include <memory>
+#include "function.h"
+#include "instrument.h"
+#include "concepts/monad.h"
+
+namespace ftl {
+	/**
+	 * \defgroup codensity Codensity
+	 *
+	 * A continuation passing wrapper that reassociates binds to the right.
+	 *
+	 * \code
+	 *   #include <ftl/codensity.h>
+	 * \endcode
+	 *
+	 * A left nested chain of binds, `((m >>= f) >>= g) >>= h`, makes many
+	 * monads rebuild or re-traverse the result of every prefix of the chain
+	 * once per level. Lifting `m` into `codensity` first turns the chain
+	 * into `m >>= [](x){ return f(x) >>= [](y){ return g(y) >>= h; }; }`,
+	 * so that `m` is bound exactly once, and the cost of the chain becomes
+	 * linear in its length.
+	 *
+	 * \par Dependencies
+	 * - <memory>
+	 * - \ref function
+	 * - \ref monad
+	 */
+
+	namespace _dtl {
+		/* Continuations are shared, as they are handed down every level of
+		 * a chain on each run; copying them by value would make running a
+		 * chain quadratic in its length again.
+		 */
+		template<typename T, typename R>
+		class codensity_k {
+		public:
+			template<
+					typename F,
+					typename = Requires<
+						!std::is_same<plain_type<F>, codensity_k>::value
+					>
+			>
+			codensity_k(F&& f)
+			: k(std::make_shared<const function<R(T)>>(std::forward<F>(f))) {
+				FTL_COUNT_ALLOCATION(monad, sizeof(function<R(T)>));
+			}
+
+			R operator() (T t) const {
+				return (*k)(std::move(t));
+			}
+
+		private:
+			std::shared_ptr<const function<R(T)>> k;
+		};
+	}
+
+	/**
+	 * The codensity monad over the monad `R`.
+	 *
+	 * A `codensity<T,R>` is a computation that, given a continuation from
+	 * `T` to `R`, produces an `R`. Binding on a `codensity` never touches the
+	 * underlying monad; it only extends the continuation the computation
+	 * will eventually be run with. The underlying monad is entered once,
+	 * when the whole chain is run by `lowerCodensity`.
+	 *
+	 * Copying a `codensity` is cheap, as the computation is shared. Running
+	 * it is recursive, however, and uses stack space in proportion to the
+	 * length of the chain.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 *
+	 * \tparam T The value type of the computation.
+	 * \tparam R The monad that results from running it, e.g. `std::list<int>`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto c = ftl::liftCodensity<std::list<int>>(std::list<int>{0});
+	 *   for(int i = 0; i < 10000; ++i) {
+	 *       c = c >>= [](int x){ return std::list<int>{x, x+1}; };
+	 *   }
+	 *
+	 *   auto l = ftl::lowerCodensity(c);
+	 * \endcode
+	 *
+	 * \ingroup codensity
+	 */
+	template<typename T, typename R>
+	class codensity {
+	public:
+		/// The type of continuations the computation is run with
+		using continuation = _dtl::codensity_k<T,R>;
+
+		/**
+		 * Construct from a function from continuations to `R`.
+		 *
+		 * `f` must be callable as `R(const continuation&)`.
+		 */
+		template<
+				typename F,
+				typename = Requires<
+					!std::is_same<plain_type<F>, codensity>::value
+				>
+		>
+		explicit codensity(F&& f)
+		: c(std::make_shared<const function<R(const continuation&)>>(
+			std::forward<F>(f)
+		)) {
+			FTL_COUNT_ALLOCATION(monad, sizeof(function<R(const continuation&)>));
+		}
+
+		codensity(const codensity&) = default;
+		codensity(codensity&&) = default;
+		codensity& operator= (const codensity&) = default;
+		codensity& operator= (codensity&&) = default;
+
+		/// Run the computation with the continuation `k`
+		R run(const continuation& k) const {
+			return (*c)(k);
+		}
+
+	private:
+		std::shared_ptr<const function<R(const continuation&)>> c;
+	};
+
+	namespace _dtl {
+		template<typename T, typename R, typename M>
+		struct codensity_lift {
+			R operator() (const codensity_k<T,R>& k) const {
+				return m >>= k;
+			}
+
+			M m;
+		};
+
+		template<typename R>
+		struct codensity_pure_k {
+			template<typename T>
+			R operator() (T&& t) const {
+				return monad<R>::pure(std::forward<T>(t));
+			}
+		};
+	}
+
+	/**
+	 * Lift a computation in the monad `M` into `codensity`.
+	 *
+	 * `R` is the type the chain eventually results in, and must be `M`
+	 * rebound to some other type.
+	 *
+	 * \ingroup codensity
+	 */
+	template<
+			typename R, typename M,
+			typename M_ = plain_type<M>,
+			typename T = Value_type<M_>
+	>
+	codensity<T,R> liftCodensity(M&& m) {
+		static_assert(Monad<M_>(), "M must be a Monad");
+		static_assert(
+			std::is_same<Rebind<M_,Value_type<R>>, R>::value,
+			"R must be the same monad as M"
+		);
+
+		return codensity<T,R>(
+			_dtl::codensity_lift<T,R,M_>{std::forward<M>(m)}
+		);
+	}
+
+	/**
+	 * Run a codensity computation, getting back to the underlying monad.
+	 *
+	 * The final continuation is `R`'s `pure`.
+	 *
+	 * \ingroup codensity
+	 */
+	template<typename T, typename R>
+	R lowerCodensity(const codensity<T,R>& c) {
+		static_assert(
+			std::is_same<T, Value_type<R>>::value,
+			"Only codensity<T,R> where T is the value type of R can be lowered"
+		);
+
+		return c.run(_dtl::codensity_pure_k<R>{});
+	}
+
+	namespace _dtl {
+		template<typename>
+		struct is_codensity : std::false_type {};
+
+		template<typename T, typename R>
+		struct is_codensity<codensity<T,R>> : std::true_type {};
+
+		template<typename R, typename U>
+		const codensity<U,R>& to_codensity(const codensity<U,R>& c) noexcept {
+			return c;
+		}
+
+		// Binding with plain computations in the underlying monad lifts them
+		template<
+				typename R, typename M,
+				typename = Requires<
+					Monad<plain_type<M>>{} && !is_codensity<plain_type<M>>::value
+				>
+		>
+		codensity<Value_type<plain_type<M>>,R> to_codensity(M&& m) {
+			return liftCodensity<R>(std::forward<M>(m));
+		}
+
+		template<typename T, typename R>
+		struct codensity_pure {
+			R operator() (const codensity_k<T,R>& k) const {
+				return k(t);
+			}
+
+			T t;
+		};
+
+		template<typename T, typename U, typename R, typename F>
+		struct codensity_map {
+			struct step {
+				R operator() (T t) const {
+					return k(f(std::move(t)));
+				}
+
+				F f;
+				codensity_k<U,R> k;
+			};
+
+			R operator() (const codensity_k<U,R>& k) const {
+				return c.run(codensity_k<T,R>(step{f, k}));
+			}
+
+			F f;
+			codensity<T,R> c;
+		};
+
+		template<typename T, typename U, typename R, typename F>
+		struct codensity_bind {
+			struct step {
+				R operator() (T t) const {
+					return to_codensity<R>(f(std::move(t))).run(k);
+				}
+
+				F f;
+				codensity_k<U,R> k;
+			};
+
+			R operator() (const codensity_k<U,R>& k) const {
+				return c.run(codensity_k<T,R>(step{f, k}));
+			}
+
+			F f;
+			codensity<T,R> c;
+		};
+	}
+
+	/**
+	 * Monad instance for codensity.
+	 *
+	 * Functions given to `bind` may return either a `codensity<U,R>` or
+	 * a plain `Rebind<R,U>`, the latter of which is lifted automatically.
+	 *
+	 * \ingroup codensity
+	 */
+	template<typename T, typename R>
+	struct monad<codensity<T,R>>
+	: deriving_join<in_terms_of_bind<codensity<T,R>>>
+	, deriving_apply<in_terms_of_bind<codensity<T,R>>> {
+
+		static codensity<T,R> pure(T t) {
+			return codensity<T,R>(_dtl::codensity_pure<T,R>{std::move(t)});
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static codensity<U,R> map(F f, const codensity<T,R>& c) {
+			return codensity<U,R>(
+				_dtl::codensity_map<T,U,R,F>{std::move(f), c}
+			);
+		}
+
+		template<typename F, typename U = Value_type<result_of<F(T)>>>
+		static codensity<U,R> bind(const codensity<T,R>& c, F f) {
+			return codensity<U,R>(
+				_dtl::codensity_bind<T,U,R,F>{std::move(f), c}
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
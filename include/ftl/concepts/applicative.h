@@ -23,6 +23,7 @@
 #ifndef FTL_APPLICATIVE_H
 #define FTL_APPLICATIVE_H
 
+#include <tuple>
 #include "basic.h"
 #include "functor.h"
 
@@ -114,6 +115,10 @@ namespace ftl {
 		}
 
 		/// \overload
+		template<
+				typename U = T,
+				typename = Requires<!std::is_reference<U>::value>
+		>
 		static F<T> pure(T&& x) {
 			return monad<F_>::pure(std::move(x));
 		}
@@ -172,6 +177,53 @@ namespace ftl {
 		static constexpr bool instance = monad<F_>::instance;
 	};
 
+	/**
+	 * Whether `apply` on `F` evaluates its two operands independently.
+	 *
+	 * Specialised to `std::true_type` by applicatives whose `apply` lets the
+	 * effects of the function and of the argument run concurrently, rather
+	 * than sequencing them the way an `apply` in terms of `bind` must.
+	 *
+	 * Monad transformers over such base monads build their own `apply` from
+	 * the base monad's, instead of from their `bind`, so that something like
+	 * `f % a * b * c` takes as long as the slowest of `a`, `b`, and `c`, not
+	 * as long as all of them in turn. The price is that the effects of every
+	 * operand are run, even when an earlier operand fails.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   template<typename T>
+	 *   struct independent_apply<my_remote<T>> : std::true_type {};
+	 * \endcode
+	 *
+	 * \ingroup applicative
+	 */
+	template<typename F>
+	struct independent_apply : std::false_type {};
+
+	/**
+	 * Whether `apply` on the container `F` takes the cartesian product.
+	 *
+	 * Specialised to `std::true_type` by containers whose `apply` applies
+	 * every function to every element, in order, and which can be built by
+	 * `insert(end(), x)`. For these, ftl::liftA computes `f(x, y, ...)` for
+	 * every combination of elements in one nested loop, straight into a
+	 * result reserved to its exact size, rather than through containers of
+	 * partially applied functions.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   template<typename T>
+	 *   struct cartesian_apply<my_container<T>> : std::true_type {};
+	 * \endcode
+	 *
+	 * \ingroup applicative
+	 */
+	template<typename F>
+	struct cartesian_apply : std::false_type {};
+
 	/**
 	 * Concepts lite-compatible predicate for applicative instances.
 	 *
@@ -349,6 +401,357 @@ namespace ftl {
 	aapply;
 #endif
 
+	/**
+	 * \interface short_circuiting
+	 *
+	 * Applicatives whose `apply` stops at the first failure.
+	 *
+	 * Specialised by applicatives like ftl::maybe and ftl::either, where
+	 * applying anything to a failed computation just passes the failure on.
+	 * Functions such as ftl::traverse use the instance to stop as soon as
+	 * they see a failure, and to pull values out of successes directly,
+	 * rather than by a chain of `apply`.
+	 *
+	 * \ingroup applicative
+	 */
+	template<typename F>
+	struct short_circuiting {
+#ifdef DOCUMENTATION_GENERATOR
+		/// Whether `f` is a failure, that would absorb any `apply`
+		static bool failed(const F& f);
+
+		/// Move the value out of `f`, which must not have failed
+		static Value_type<F>&& value(F&& f);
+
+		/// Pass the failure `f` on as an `F` of some other type `U`
+		template<typename U>
+		static Rebind<F,U> propagate(F&& f);
+#endif
+
+		static constexpr bool instance = false;
+	};
+
+	namespace _dtl {
+		template<typename C>
+		auto reserve_for(C& c, std::size_t n, int) -> decltype(c.reserve(n)) {
+			c.reserve(n);
+		}
+
+		template<typename C>
+		void reserve_for(C&, std::size_t, ...) noexcept {}
+
+		template<typename C>
+		auto size_of(const C& c, int) -> decltype(std::size_t(c.size())) {
+			return c.size();
+		}
+
+		template<typename C>
+		std::size_t size_of(const C&, ...) noexcept {
+			return 0;
+		}
+
+		// A copy of c with one more element, as a function of that element
+		template<typename C, typename U>
+		struct snoc {
+			C operator() (U u) const {
+				C r = c;
+				r.emplace_back(std::move(u));
+				return r;
+			}
+
+			C c;
+		};
+
+		template<typename C, typename U>
+		struct make_snoc {
+			snoc<C,U> operator() (C c) const {
+				return snoc<C,U>{std::move(c)};
+			}
+		};
+
+		// Elements of an rvalue container are passed on as rvalues
+		template<typename T>
+		const T& elem(const T& t, std::false_type) noexcept {
+			return t;
+		}
+
+		template<typename T>
+		T&& elem(T& t, std::true_type) noexcept {
+			return std::move(t);
+		}
+
+		template<typename A, typename C, typename Fn, typename Cs>
+		Rebind<A,C> traverse(Fn&& fn, Cs&& cs, std::true_type) {
+			using move_elems = std::integral_constant<
+				bool, !std::is_lvalue_reference<Cs>::value
+			>;
+
+			C r;
+			reserve_for(r, size_of(cs, 0), 0);
+
+			for(auto& e : cs) {
+				A a = fn(elem(e, move_elems{}));
+				if(short_circuiting<A>::failed(a))
+					return short_circuiting<A>::template propagate<C>(
+						std::move(a)
+					);
+
+				r.emplace_back(short_circuiting<A>::value(std::move(a)));
+			}
+
+			return applicative<Rebind<A,C>>::pure(std::move(r));
+		}
+
+		template<
+				typename A, typename C, typename Fn, typename Cs,
+				typename U = Value_type<A>
+		>
+		Rebind<A,C> traverse(Fn&& fn, Cs&& cs, std::false_type) {
+			using move_elems = std::integral_constant<
+				bool, !std::is_lvalue_reference<Cs>::value
+			>;
+
+			auto r = applicative<Rebind<A,C>>::pure(C());
+
+			for(auto& e : cs) {
+				auto f = applicative<Rebind<A,C>>::map(
+					make_snoc<C,U>{}, std::move(r)
+				);
+
+				r = applicative<A>::apply(
+					std::move(f), fn(elem(e, move_elems{}))
+				);
+			}
+
+			return r;
+		}
+
+		template<typename A>
+		struct pass_on {
+			const A& operator() (const A& a) const noexcept {
+				return a;
+			}
+
+			A operator() (A&& a) const {
+				return std::move(a);
+			}
+		};
+	}
+
+#ifndef DOCUMENTATION_GENERATOR
+	constexpr struct _traverse : make_curried_n<2,_traverse> {
+		template<
+				typename Fn,
+				typename Cs,
+				typename Cs_ = plain_type<Cs>,
+				typename A = plain_type<result_of<Fn(Value_type<Cs_>)>>,
+				typename C = Rebind<Cs_,Value_type<A>>
+		>
+		Rebind<A,C> operator() (Fn&& fn, Cs&& cs) const {
+			static_assert(
+				Applicative<A>(), "Fn must return an ftl::Applicative"
+			);
+
+			return _dtl::traverse<A,C>(
+				std::forward<Fn>(fn), std::forward<Cs>(cs),
+				std::integral_constant<bool,short_circuiting<A>::instance>{}
+			);
+		}
+
+		using make_curried_n<2,_traverse>::operator();
+	} traverse{};
+
+	constexpr struct _sequence {
+		template<
+				typename Cs,
+				typename Cs_ = plain_type<Cs>,
+				typename A = Value_type<Cs_>
+		>
+		auto operator() (Cs&& cs) const
+		-> decltype(traverse(_dtl::pass_on<A>{}, std::forward<Cs>(cs))) {
+			return traverse(_dtl::pass_on<A>{}, std::forward<Cs>(cs));
+		}
+	} sequence{};
+#else
+	struct ImplementationDefined {
+	}
+	/**
+	 * Map an applicative action over a container, and collect the results.
+	 *
+	 * Behaves as if it were a curried function of type
+	 * \code
+	 *   ((T) -> A<U>, C<T>) -> A<C<U>>
+	 * \endcode
+	 * where `A` is an \ref applicativepg and `C` a container with an
+	 * `emplace_back`.
+	 *
+	 * For \ref short_circuiting applicatives, such as ftl::maybe and
+	 * ftl::either, the result container is reserved up front, values are
+	 * moved straight into it, and traversal stops at the first failure,
+	 * which is then returned. Other applicatives are combined element by
+	 * element using `apply`, which copies the partial result at each step.
+	 *
+	 * If `cs` is an rvalue, its elements are passed to `fn` as rvalues.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto parse = [](const std::string& s) -> ftl::maybe<int> { ... };
+	 *   std::vector<std::string> v{"1", "2", "three", "4"};
+	 *
+	 *   // Calls parse three times, r == nothing
+	 *   ftl::maybe<std::vector<int>> r = ftl::traverse(parse, v);
+	 * \endcode
+	 *
+	 * \ingroup applicative
+	 */
+	traverse;
+
+	/**
+	 * Turn a container of applicatives into an applicative of a container.
+	 *
+	 * Equivalent of `traverse(id, cs)`, but passes elements on without
+	 * copying them when `cs` is an rvalue.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<ftl::maybe<int>> v{ftl::just(1), ftl::just(2)};
+	 *
+	 *   // r == just(std::vector<int>{1,2})
+	 *   auto r = ftl::sequence(v);
+	 * \endcode
+	 *
+	 * \ingroup applicative
+	 */
+	sequence;
+#endif
+
+	namespace _dtl {
+		inline constexpr std::size_t size_product() noexcept {
+			return 1;
+		}
+
+		template<typename C, typename...Cs>
+		std::size_t size_product(const C& c, const Cs&...cs) {
+			return size_of(c, 0) * size_product(cs...);
+		}
+
+		// One loop per container, the innermost of which calls fn
+		template<std::size_t I, std::size_t N>
+		struct cartesian_loop {
+			template<typename R, typename Fn, typename Cs, typename...Xs>
+			static void run(R& r, Fn& fn, const Cs& cs, const Xs&...xs) {
+				for(auto& x : std::get<I>(cs)) {
+					cartesian_loop<I+1,N>::run(r, fn, cs, xs..., x);
+				}
+			}
+		};
+
+		template<std::size_t N>
+		struct cartesian_loop<N,N> {
+			template<typename R, typename Fn, typename Cs, typename...Xs>
+			static void run(R& r, Fn& fn, const Cs&, const Xs&...xs) {
+				r.insert(r.end(), fn(xs...));
+			}
+		};
+
+		template<typename R, typename Fn, typename...As>
+		R lift_cartesian(Fn& fn, const As&...as) {
+			R r;
+			reserve_for(r, size_product(as...), 0);
+			cartesian_loop<0,sizeof...(As)>::run(r, fn, std::tie(as...));
+
+			return r;
+		}
+
+		template<typename R, typename Ff>
+		R lift_chain(Ff&& f) {
+			return std::forward<Ff>(f);
+		}
+
+		template<typename R, typename Ff, typename A, typename...As>
+		R lift_chain(Ff&& f, A&& a, As&&...as) {
+			return lift_chain<R>(
+				std::forward<Ff>(f) * std::forward<A>(a),
+				std::forward<As>(as)...
+			);
+		}
+
+		template<typename R, typename Fn, typename A, typename...As>
+		R lift(std::true_type, Fn&& fn, A&& a, As&&...as) {
+			return lift_cartesian<R>(fn, a, as...);
+		}
+
+		template<typename R, typename Fn, typename A>
+		R lift(std::false_type, Fn&& fn, A&& a) {
+			return std::forward<Fn>(fn) % std::forward<A>(a);
+		}
+
+		template<typename R, typename Fn, typename A, typename A2, typename...As>
+		R lift(std::false_type, Fn&& fn, A&& a, A2&& a2, As&&...as) {
+			return lift_chain<R>(
+				curry<2+sizeof...(As)>(std::forward<Fn>(fn))
+					% std::forward<A>(a),
+				std::forward<A2>(a2),
+				std::forward<As>(as)...
+			);
+		}
+	}
+
+#ifndef DOCUMENTATION_GENERATOR
+	constexpr struct _liftA {
+		template<
+				typename Fn,
+				typename A,
+				typename...As,
+				typename A_ = plain_type<A>,
+				typename U = plain_type<result_of<
+					Fn(Value_type<A_>, Value_type<plain_type<As>>...)
+				>>
+		>
+		Rebind<A_,U> operator() (Fn&& fn, A&& a, As&&...as) const {
+			static_assert(
+				Applicative<A_>(), "liftA requires ftl::Applicative operands"
+			);
+
+			return _dtl::lift<Rebind<A_,U>>(
+				std::integral_constant<bool,cartesian_apply<A_>::value>{},
+				std::forward<Fn>(fn), std::forward<A>(a),
+				std::forward<As>(as)...
+			);
+		}
+	} liftA{};
+#else
+	struct ImplementationDefined {
+	}
+	/**
+	 * Apply an n-ary function to the values of n applicatives.
+	 *
+	 * Equivalent of `curry<N>(fn) % a * as...`, without currying `fn`. For
+	 * containers with a \ref cartesian_apply, `fn` is called directly on
+	 * every combination of elements, in the order `apply` would produce
+	 * them, and the result is reserved to its exact size up front.
+	 *
+	 * The operands may be applicatives of different value types, but must
+	 * otherwise be of the same kind.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<int> v1{1, 2}, v2{10, 20}, v3{100};
+	 *
+	 *   auto sum3 = [](int x, int y, int z){ return x + y + z; };
+	 *
+	 *   // r == {111, 121, 112, 122}, with a single allocation
+	 *   auto r = ftl::liftA(sum3, v1, v2, v3);
+	 * \endcode
+	 *
+	 * \ingroup applicative
+	 */
+	liftA;
+#endif
+
 	/**
 	 * \page monoidapg Monoidal Alternatives
 	 *
@@ -343,6 +343,11 @@ namespace ftl {
 		}
 	};
 
+	namespace _dtl {
+		template<bool...>
+		struct bool_seq {};
+	}
+
 	/**
 	 * Check that a compile-time predicate holds for an arbitrary list of types.
 	 *
@@ -362,20 +367,13 @@ namespace ftl {
 	 * \ingroup concepts_basic
 	 */
 	template<template<typename> class Pred, typename...Ts>
-	struct All;
-
-	template<template<typename> class Pred>
-	struct All<Pred> {
-		static constexpr bool value = true;
-
-		constexpr operator bool() const noexcept {
-			return true;
-		}
-	};
-
-	template<template<typename> class Pred, typename T, typename...Ts>
-	struct All<Pred, T, Ts...> {
-		static constexpr bool value = Pred<T>::value && All<Pred,Ts...>::value;
+	struct All {
+		// Every predicate holds iff shifting them one step changes nothing,
+		// which takes no recursion over Ts
+		static constexpr bool value = std::is_same<
+			_dtl::bool_seq<true, static_cast<bool>(Pred<Ts>::value)...>,
+			_dtl::bool_seq<static_cast<bool>(Pred<Ts>::value)..., true>
+		>::value;
 
 		constexpr operator bool() const noexcept {
 			return value;
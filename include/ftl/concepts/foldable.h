@@ -23,6 +23,7 @@
 #ifndef FTL_FOLDABLE_H
 #define FTL_FOLDABLE_H
 
+#include <vector>
 #include "monoid.h"
 #include "../prelude.h"
 #include "common.h"
@@ -56,6 +57,7 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * \par Dependencies
+	 * - `<vector>`
 	 * - \ref prelude
 	 * - \ref monoid
 	 */
@@ -200,9 +202,29 @@ namespace ftl {
 		}
 	};
 
+	/**
+	 * \interface parallel_foldable
+	 *
+	 * Struct specialised by types that can be folded in parallel.
+	 *
+	 * Instances provide a static `foldMap(policy, fn, f)`, where `policy` is a
+	 * parallel execution policy, such as `ftl::par`. This is what `foldMap`
+	 * and `fold` invoke when given an execution policy as their first
+	 * argument. As the reduction is performed as a tree, it relies on the
+	 * associativity of the monoid operation, but never on commutativity.
+	 *
+	 * The instances for the standard containers are found in \ref parallel.
+	 *
+	 * \ingroup foldable
+	 */
+	template<typename F>
+	struct parallel_foldable {
+		static constexpr bool instance = false;
+	};
+
 	template<typename>
 	struct deriving_foldable {};
-	
+
 	/**
 	 * An inheritable implementation of `foldable::foldl`.
 	 *
@@ -210,6 +232,9 @@ namespace ftl {
 	 * instance simply inherit this implementation of `foldl` instead of
 	 * implementing it manually.
 	 *
+	 * The accumulated value is moved into the folding function at every
+	 * step, so folding into e.g. a container does not copy it each time.
+	 *
 	 * \par Examples
 	 *
 	 * \code
@@ -240,7 +265,7 @@ namespace ftl {
 			);
 
 			for(auto& e : f) {
-				z = fn(z, e);
+				z = fn(std::move(z), e);
 			}
 
 			return z;
@@ -256,7 +281,7 @@ namespace ftl {
 			);
 
 			for(auto& e : f) {
-				z = fn(z, std::move(e));
+				z = fn(std::move(z), std::move(e));
 			}
 
 			return z;
@@ -270,6 +295,9 @@ namespace ftl {
 	 * instance simply inherit this implementation of `foldr` instead of
 	 * implementing it manually.
 	 *
+	 * The accumulated value is moved into the folding function at every
+	 * step, so folding into e.g. a container does not copy it each time.
+	 *
 	 * \par Examples
 	 *
 	 * \code
@@ -295,7 +323,7 @@ namespace ftl {
 			);
 
 			for(auto it = f.rbegin(); it != f.rend(); ++it) {
-				z = fn(*it, z);
+				z = fn(*it, std::move(z));
 			}
 
 			return z;
@@ -311,7 +339,7 @@ namespace ftl {
 			);
 
 			for(auto it = f.rbegin(); it != f.rend(); ++it) {
-				z = fn(std::move(*it), z);
+				z = fn(std::move(*it), std::move(z));
 			}
 
 			return z;
@@ -325,6 +353,13 @@ namespace ftl {
 	 * this struct to get `foldable::foldMap` for "free". Naturally, it works
 	 * together with `ftl::deriving_foldl`.
 	 *
+	 * If `F` is iterable and the resulting monoid has an absorbing
+	 * element (see `AbsorbingMonoid`), the traversal stops as soon as the
+	 * accumulated value has been absorbed, without calling `fn` for any
+	 * of the remaining elements. Otherwise, if the monoid has an n-way
+	 * `monoid::mconcat`, the results of `fn` are collected and concatenated
+	 * with it in one step.
+	 *
 	 * \par Examples
 	 *
 	 * \code
@@ -349,22 +384,61 @@ namespace ftl {
 				"The result of Fn(T) is not an instance of Monoid."
 			);
 
+			return foldMap_<M>(
+				fn, f,
+				std::integral_constant<
+					int,
+					!_dtl::iterates_values<F>::value ? 0
+					: AbsorbingMonoid<M>() ? 1
+					: _dtl::has_mconcat<M>::value ? 2
+					: 0
+				>{}
+			);
+		}
+
+	private:
+		template<typename M, typename Fn, typename T = Value_type<F>>
+		static M foldMap_(Fn& fn, const F& f, std::integral_constant<int,0>) {
 			return foldable<F>::foldl(
-					[fn](const T& a, const M& b) {
+					[fn](M b, const T& a) {
 						return monoid<M>::append(
-							fn(a),
-							b);
+							std::move(b),
+							fn(a));
 					},
 					monoid<M>::id(),
 					f);
 		}
+
+		template<typename M, typename Fn>
+		static M foldMap_(Fn& fn, const F& f, std::integral_constant<int,1>) {
+			auto z = monoid<M>::id();
+			for(auto& e : f) {
+				z = monoid<M>::append(std::move(z), fn(e));
+				if(monoid<M>::absorbing(z))
+					break;
+			}
+
+			return z;
+		}
+
+		// Collects the results, to be concatenated in one go
+		template<typename M, typename Fn>
+		static M foldMap_(Fn& fn, const F& f, std::integral_constant<int,2>) {
+			std::vector<M> ms;
+			for(auto& e : f) {
+				ms.push_back(fn(e));
+			}
+
+			return monoid<M>::mconcat(std::move(ms));
+		}
 	};
 
 	/**
 	 * Inheritable implementation of foldable::fold.
 	 *
 	 * Foldable specialisations implementing foldable::foldMap can inherit from
-	 * this struct to get `foldable::fold` for "free".
+	 * this struct to get `foldable::fold` for "free". Iterable foldables of
+	 * monoids with an n-way `monoid::mconcat` are concatenated with that.
 	 *
 	 * It is entirely possible for a foldable implementation to use both 
 	 * `deriving_foldMap<F>` and `deriving_fold<F>`, even in reverse order.
@@ -388,6 +462,25 @@ namespace ftl {
 		static M fold(const F& f) {
 			static_assert(Monoid<M>(), "M must satisfy Monoid");
 
+			return fold_<M>(
+				f,
+				std::integral_constant<
+					bool,
+					_dtl::has_mconcat<M>::value
+					&& _dtl::iterates_values<F>::value
+					&& std::is_same<M,Value_type<F>>::value
+				>{}
+			);
+		}
+
+	private:
+		template<typename M>
+		static M fold_(const F& f, std::true_type) {
+			return monoid<M>::mconcat(f);
+		}
+
+		template<typename M>
+		static M fold_(const F& f, std::false_type) {
 			return foldable<F>::foldMap(id, f);
 		}
 	};
@@ -424,6 +517,17 @@ namespace ftl {
 			return foldable<F>::fold(f);
 		}
 
+		template<
+				typename P,
+				typename F,
+				typename M = Value_type<F>,
+				typename = Requires<parallel_foldable<F>::instance && Monoid<M>()>
+		>
+		auto operator() (const P& p, const F& f) const
+		-> decltype(parallel_foldable<F>::foldMap(p, id, f)) {
+			return parallel_foldable<F>::foldMap(p, id, f);
+		}
+
 	} fold {};
 #else
 	struct ImplementationDefined {
@@ -448,6 +552,12 @@ namespace ftl {
 	 *   // r == {sum(3), sum(7)}
 	 * \endcode
 	 *
+	 * Given an execution policy as first argument, for types with a
+	 * `parallel_foldable` instance, the fold is computed in parallel:
+	 * \code
+	 *   auto r = ftl::fold(ftl::par, v);
+	 * \endcode
+	 *
 	 * \ingroup foldable
 	 */
 	fold;
@@ -466,6 +576,12 @@ namespace ftl {
 			return foldable<F>::foldMap(std::forward<Fn>(fn), f);
 		}
 
+		template<typename P, typename Fn, typename F>
+		auto operator() (const P& p, Fn&& fn, const F& f) const
+		-> decltype(parallel_foldable<F>::foldMap(p, std::forward<Fn>(fn), f)) {
+			return parallel_foldable<F>::foldMap(p, std::forward<Fn>(fn), f);
+		}
+
 		using curried_binf<_foldMap>::operator();
 	} foldMap {};
 #else
@@ -489,6 +605,9 @@ namespace ftl {
 	 *
 	 *   auto r = ftl::foldMap(ftl::sum<int>, v);
 	 *   // r == ftl::sum(10)
+	 *
+	 *   // In parallel
+	 *   auto p = ftl::foldMap(ftl::par, ftl::sum<int>, v);
 	 * \endcode
 	 *
 	 * \ingroup foldable
@@ -605,6 +724,62 @@ namespace ftl {
 	 */
 	foldl;
 #endif
+
+#ifndef DOCUMENTATION_GENERATOR
+	constexpr struct _foldInto : public _dtl::curried_ternf<_foldInto> {
+		template<
+				typename F,
+				typename Fn,
+				typename U,
+				typename T = Value_type<F>,
+				typename = Requires<Foldable<F>{}>
+		>
+		plain_type<U> operator() (Fn&& fn, U&& z, const F& f) const {
+			using V = plain_type<U>;
+
+			return foldable<F>::foldl(
+				[&fn](V acc, const T& e) {
+					fn(acc, e);
+					return acc;
+				},
+				V(std::forward<U>(z)),
+				f
+			);
+		}
+
+		using curried_ternf<_foldInto>::operator();
+	} foldInto{};
+#else
+	struct ImplementationDefined {
+	}
+	/**
+	 * Left fold that updates the accumulator in place.
+	 *
+	 * Behaves as if it were a curried function of type
+	 * \code
+	 *   ((U&,T) -> void, U, F<T>) -> U
+	 * \endcode
+	 *
+	 * Rather than returning a new accumulated value, `fn` modifies the one it
+	 * is given. The accumulator is moved from step to step and never copied,
+	 * which makes building e.g. a container with a fold linear in the number
+	 * of elements.
+	 *
+	 * \par Examples
+	 *
+	 * Concatenating the values of a map:
+	 * \code
+	 *   std::map<int,std::string> m{{1,"a"}, {2,"b"}};
+	 *   auto push = [](std::string& s, const std::string& x){ s += x; };
+	 *
+	 *   auto s = ftl::foldInto(push, std::string{}, m);
+	 *   // s == "ab"
+	 * \endcode
+	 *
+	 * \ingroup foldable
+	 */
+	foldInto;
+#endif
 }
 
 #endif
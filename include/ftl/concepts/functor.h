@@ -118,6 +118,23 @@ namespace ftl {
 			return applicative<F_>::map(std::forward<Fn>(fn), std::move(f));
 		}
 
+		/**
+		 * Apply a function to the contained value(s) for its side effects.
+		 *
+		 * This method is optional. It is what `fmap` and ftl::forEach use
+		 * when the mapped function returns `void`, and should visit every
+		 * value without building any result. Instances that are
+		 * \ref fwditerable need not provide it, as they are simply iterated.
+		 * Any other instance without a `forEach` has its values visited by
+		 * mapping, and throwing away the result of, a function returning a
+		 * dummy value.
+		 *
+		 * \code
+		 *   template<typename Fn>
+		 *   static void forEach(Fn&& fn, const F<T>& f);
+		 * \endcode
+		 */
+
 		/**
 		 * Compile time check whether a type is a functor.
 		 *
@@ -151,6 +168,23 @@ namespace ftl {
 		}
 	};
 
+	/**
+	 * \interface parallel_functor
+	 *
+	 * Struct specialised by types that can be mapped in parallel.
+	 *
+	 * Instances provide a static `map(policy, fn, f)`, where `policy` is a
+	 * parallel execution policy, such as `ftl::par`. This is what `fmap`
+	 * invokes when given an execution policy as its first argument. The
+	 * instances for the standard containers are found in \ref parallel.
+	 *
+	 * \ingroup functor
+	 */
+	template<typename F>
+	struct parallel_functor {
+		static constexpr bool instance = false;
+	};
+
 	template<typename F>
 	struct deriving_map;
 
@@ -226,7 +260,7 @@ namespace ftl {
 				e = fn(std::move(e));
 			}
 
-			return f;
+			return std::move(f);
 		}
 	};
 
@@ -312,6 +346,148 @@ namespace ftl {
 		return functor<F_>::map(std::mem_fn(fn), std::forward<F>(f));
 	}
 
+	namespace _dtl {
+		// Stand-in for the function given to functor<F>::forEach
+		struct forEach_probe {
+			template<typename T>
+			void operator() (T&&) const;
+		};
+
+		template<typename F>
+		bool test_forEach(
+			decltype(
+				functor<F>::forEach(
+					std::declval<forEach_probe>(), std::declval<const F&>()
+				)
+			)*
+		);
+
+		template<typename F>
+		no test_forEach(...);
+
+		// Whether functor<F> has a forEach of its own
+		template<typename F>
+		struct has_forEach
+		: std::integral_constant<
+			bool,
+			!std::is_same<decltype(test_forEach<F>(nullptr)), no>::value
+		> {};
+	}
+
+#ifndef DOCUMENTATION_GENERATOR
+	constexpr struct _forEach : make_curried_n<2,_forEach> {
+		template<
+				typename Fn,
+				typename F,
+				typename F_ = plain_type<F>,
+				typename = Requires<!std::is_member_function_pointer<Fn>::value>
+		>
+		void operator() (Fn&& fn, F&& f) const {
+			static_assert(Functor<F_>(), "F is not an instance of Functor");
+
+			visit<F_>(
+				std::forward<Fn>(fn), std::forward<F>(f),
+				std::integral_constant<
+					int,
+					_dtl::has_forEach<F_>::value ? 0
+					: _dtl::iterates_values<F_>::value ? 1
+					: 2
+				>{}
+			);
+		}
+
+		using make_curried_n<2,_forEach>::operator();
+
+	private:
+		template<typename F_, typename Fn, typename F>
+		static void visit(Fn&& fn, F&& f, std::integral_constant<int,0>) {
+			functor<F_>::forEach(std::forward<Fn>(fn), std::forward<F>(f));
+		}
+
+		template<typename F_, typename Fn>
+		static void visit(Fn&& fn, const F_& f, std::integral_constant<int,1>) {
+			for(auto& e : f) {
+				fn(e);
+			}
+		}
+
+		template<typename F_, typename Fn>
+		static void visit(Fn&& fn, F_&& f, std::integral_constant<int,1>) {
+			for(auto& e : f) {
+				fn(std::move(e));
+			}
+		}
+
+		template<typename F_, typename Fn>
+		static void visit(Fn&& fn, F_& f, std::integral_constant<int,1>) {
+			visit<F_>(
+				std::forward<Fn>(fn), static_cast<const F_&>(f),
+				std::integral_constant<int,1>{}
+			);
+		}
+
+		template<typename F_, typename Fn>
+		static void visit(Fn fn, const F_& f, std::integral_constant<int,2>) {
+			functor<F_>::map(
+				[fn](const Value_type<F_>& t) -> int {
+					fn(t);
+					return 0;
+				},
+				f
+			);
+		}
+
+		template<typename F_, typename Fn>
+		static void visit(Fn fn, F_&& f, std::integral_constant<int,2>) {
+			functor<F_>::map(
+				[fn](Value_type<F_>&& t) -> int {
+					fn(std::move(t));
+					return 0;
+				},
+				std::move(f)
+			);
+		}
+
+		template<typename F_, typename Fn>
+		static void visit(Fn&& fn, F_& f, std::integral_constant<int,2>) {
+			visit<F_>(
+				std::forward<Fn>(fn), static_cast<const F_&>(f),
+				std::integral_constant<int,2>{}
+			);
+		}
+	} forEach{};
+#else
+	struct ImplementationDefined {
+	}
+	/**
+	 * Apply a function to every value in a functor, for its side effects.
+	 *
+	 * Behaves as if it were a curried function of type
+	 * \code
+	 *   ((T) -> void, F<T>) -> void
+	 * \endcode
+	 *
+	 * Unlike mapping a function with side effects, this builds no result.
+	 * \ref fwditerable types are simply iterated, other types use their
+	 * `functor::forEach`, if any, and fall back to `functor::map` otherwise.
+	 * Calling `fmap` with a function returning `void` is equivalent.
+	 *
+	 * If `f` is an rvalue, its values are passed on as rvalues.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<int> v{1,2,3};
+	 *
+	 *   // Output: "1, 2, 3, "; no vector is allocated
+	 *   ftl::forEach([](int x){ std::cout << x << ", "; }, v);
+	 * \endcode
+	 *
+	 * \ingroup functor
+	 */
+	forEach;
+#endif
+
 #ifndef DOCUMENTATION_GENERATOR
 	constexpr struct _fmap : make_curried_n<2,_fmap> {
 		template<
@@ -349,7 +525,7 @@ namespace ftl {
 		void operator() (Fn&& fn, F&& f) const {
 			static_assert(Functor<F_>(), "F is not an instance of Functor");
 
-			mapM<F_>::apply(std::forward<Fn>(fn), std::forward<F>(f));
+			forEach(std::forward<Fn>(fn), std::forward<F>(f));
 		}
 
 		template<
@@ -382,33 +558,22 @@ namespace ftl {
 			functor<F_>::map(std::mem_fn(fn), std::forward<F>(f));
 		}
 
-		using make_curried_n<2,_fmap>::operator();
-
-	private:
-		template<typename F>
-		struct mapM {
-			template<typename Fn>
-			static void apply(Fn fn, const F& f) {
-				functor<F>::map(
-					[fn](const Value_type<F>& t) -> int {
-						fn(t);
-						return 0;
-					},
-					f
-				);
-			}
+		template<
+				typename P,
+				typename Fn,
+				typename F,
+				typename F_ = plain_type<F>
+		>
+		auto operator() (const P& p, Fn&& fn, F&& f) const
+		-> decltype(parallel_functor<F_>::map(
+				p, std::forward<Fn>(fn), std::forward<F>(f)
+		)) {
+			return parallel_functor<F_>::map(
+				p, std::forward<Fn>(fn), std::forward<F>(f)
+			);
+		}
 
-			template<typename Fn>
-			static void apply(Fn fn, F&& f) {
-				functor<F>::map(
-					[fn](Value_type<F>&& t) -> int {
-						fn(std::move(t));
-						return 0;
-					},
-					std::move(f)
-				);
-			}
-		};
+		using make_curried_n<2,_fmap>::operator();
 	} fmap{};
 #else
 	struct ImplementationDefined {
@@ -425,6 +590,7 @@ namespace ftl {
 	 * \code
 	 *   ((T) -> void, F<T>) -> void
 	 * \endcode
+	 * and behave as ftl::forEach, building no result.
 	 *
 	 * Makes for a good alternative to `ftl::operator%` for those who prefer
 	 * to keep their code clear of potentially confusing operators.
@@ -459,6 +625,13 @@ namespace ftl {
 	 *   auto r = ftl::fmap(ftl::fmap(plusOne), l); // r == {{2,3}, {4,5}}
 	 * \endcode
 	 *
+	 * In parallel, for types with a `parallel_functor` instance:
+	 * \code
+	 *   std::vector<int> v = ...;
+	 *
+	 *   auto r = ftl::fmap(ftl::par, plusOne, v);
+	 * \endcode
+	 *
 	 * \ingroup functor
 	 */
 	fmap;
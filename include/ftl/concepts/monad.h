@@ -485,15 +485,61 @@ namespace ftl {
 		}
 	};
 
+	namespace _dtl {
+		template<typename R, typename C>
+		void insert_moved(R& r, C& c) {
+			r.insert(
+				r.end(),
+				std::make_move_iterator(c.begin()),
+				std::make_move_iterator(c.end())
+			);
+		}
+
+		template<typename R, typename C>
+		void bind_append(R& r, C& c, long) {
+			insert_moved(r, c);
+		}
+
+		// Containers that can, relink the nodes of c instead
+		template<typename R, typename C>
+		auto bind_append(R& r, C& c, int)
+		-> decltype(r.splice(r.end(), c), void()) {
+			if(r.get_allocator() == c.get_allocator())
+				r.splice(r.end(), c);
+			else
+				insert_moved(r, c);
+		}
+
+		// Moves the elements of c to the end of r
+		template<typename R, typename C>
+		void bind_append(R& r, C& c) {
+			bind_append(r, c, 0);
+		}
+
+		// The first result can simply become r
+		template<typename R>
+		void bind_append(R& r, R& c) {
+			if(r.empty() && r.get_allocator() == c.get_allocator())
+				r = std::move(c);
+			else
+				bind_append(r, c, 0);
+		}
+	}
+
 	/**
 	 * Inheritable `bind` implementation for containers supporting `insert`.
 	 *
 	 * The following requirements must be met by `M_`:
-	 * - There must exist an `M::insert(iterator pos, const T& value)`,
-	 *   returning an iterator to the inserted element. An R-value version is
-	 *   also beneficial in some cases.
-	 * - There must be an implementation of `monad::map` available for `M_`
-	 *   that is _not_ derived in terms of `bind`.
+	 * - There must exist an `M::insert(const_iterator pos, It first, It last)`,
+	 *   inserting a range of elements.
+	 * - `M_` must have `empty` and `get_allocator`, like the standard
+	 *   containers.
+	 *
+	 * The result of `f` for each element is appended to the output
+	 * right away, so no more than one of them is alive at any time. Where
+	 * `f` returns an `M<U>`, the first result becomes the output, and if
+	 * `M_` has a list-like `splice`, the nodes of the others are relinked
+	 * rather than moved one element at a time.
 	 *
 	 * Also note that types using this construct to generate a `bind`
 	 * implementation will be capable of binding with any function returning
@@ -558,11 +604,10 @@ namespace ftl {
 				"F(T) does not return an instance of ForwardIterable"
 			);
 
-			auto m2 = std::forward<F>(f) % m;
 			M<U> result;
-			auto it = std::inserter(result, result.begin());
-			for(auto& c : m2) {
-				it = std::move(c.begin(), c.end(), it);
+			for(auto& e : m) {
+				auto c = f(e);
+				_dtl::bind_append(result, c);
 			}
 
 			return result;
@@ -585,11 +630,10 @@ namespace ftl {
 				"F(T) does not return an instance of ForwardIterable"
 			);
 
-			auto m2 = std::forward<F>(f) % std::move(m);
 			M<U> result;
-			auto it = std::inserter(result, result.begin());
-			for(auto& c : m2) {
-				it = std::move(c.begin(), c.end(), it);
+			for(auto& e : m) {
+				auto c = f(std::move(e));
+				_dtl::bind_append(result, c);
 			}
 
 			return result;
@@ -647,6 +691,54 @@ namespace ftl {
 
 	};
 
+	/**
+	 * Inheritable implementation of `monad::apply` for containers.
+	 *
+	 * Applies every function in `fs` to every element of `m` in a plain
+	 * double loop, appending to a result that is, if it has a `reserve`,
+	 * reserved to its exact size of `fs.size() * m.size()` first.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   template<typename T>
+	 *   struct monad<MyContainer<T>>
+	 *   : deriving_apply<back_insertable_container<MyContainer<T>>> {
+	 *       // Implementation of pure, map, and bind
+	 *   };
+	 * \endcode
+	 *
+	 * \ingroup monad
+	 */
+	template<typename M>
+	struct deriving_apply<back_insertable_container<M>> {
+		using T = Value_type<M>;
+
+		template<typename U>
+		using M_ = Rebind<M,U>;
+
+		template<
+				typename Mf,
+				typename Mf_ = plain_type<Mf>,
+				typename F = Value_type<Mf_>,
+				typename U = result_of<F(T)>
+		>
+		static M_<U> apply(Mf&& fs, const M& m) {
+			M_<U> result;
+			_dtl::reserve_for(
+				result, _dtl::size_of(fs, 0) * _dtl::size_of(m, 0), 0
+			);
+
+			for(auto& f : fs) {
+				for(auto& e : m) {
+					result.emplace_back(f(e));
+				}
+			}
+
+			return result;
+		}
+	};
+
 	template<typename M>
 	struct deriving_monad;
 
@@ -679,7 +771,7 @@ namespace ftl {
 	: deriving_pure<M>, deriving_map<back_insertable_container<M>>
 	, deriving_bind<back_insertable_container<M>>
 	, deriving_join<in_terms_of_bind<M>>
-	, deriving_apply<in_terms_of_bind<M>> {
+	, deriving_apply<back_insertable_container<M>> {
 
 		static constexpr bool instance = true;
 	};
@@ -23,6 +23,7 @@
 #ifndef FTL_MONOID_H
 #define FTL_MONOID_H
 
+#include <initializer_list>
 #include <type_traits>
 #include "../prelude.h"
 
@@ -70,6 +71,7 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * \par Dependencies
+	 * - `<initializer_list>`
 	 * - `<type_traits>`
 	 * - \ref prelude
 	 */
@@ -82,6 +84,42 @@ namespace ftl {
 	 * For any type to be an instance of the monoid concept, it must specialise
 	 * this interface.
 	 *
+	 * Instances that have an _absorbing element_ (sometimes called a zero),
+	 * that is, some `z` such that
+	 * \code
+	 *   a • z = z
+	 *   z • a = z
+	 * \endcode
+	 * for every `a`, may additionally define
+	 * \code
+	 *   static bool absorbing(const M& m);
+	 * \endcode
+	 * returning `true` for exactly such elements. Folds make use of this to
+	 * stop early, as once the accumulated value is absorbing, there is no way
+	 * the remaining elements could change the result. See `AbsorbingMonoid`.
+	 *
+	 * Instances that can concatenate any number of elements faster than by
+	 * appending them pairwise, such as containers that can size their result
+	 * once, may also define
+	 * \code
+	 *   template<typename I>
+	 *   static M mconcat(const I& ms);
+	 * \endcode
+	 * for any \ref fwditerable `I` of `M`s, optionally with an overload
+	 * taking `I&&` that moves from the elements. `ftl::mconcat`, `fold` and
+	 * `foldMap` make use of it whenever it is present.
+	 *
+	 * Instances whose operation is also commutative, that is
+	 * \code
+	 *   a • b = b • a
+	 * \endcode
+	 * for every `a` and `b`, may declare so by defining
+	 * \code
+	 *   static constexpr bool commutative = true;
+	 * \endcode
+	 * which lets parallel folds combine partial results in whatever order
+	 * they are finished in. See `CommutativeMonoid`.
+	 *
 	 * \ingroup monoid
 	 */
 	template<typename M>
@@ -147,6 +185,124 @@ namespace ftl {
 		}
 	};
 
+	namespace _dtl {
+		template<typename M>
+		bool test_absorbing(
+			decltype(monoid<M>::absorbing(std::declval<const M&>()))*
+		);
+
+		template<typename M>
+		no test_absorbing(...);
+	}
+
+	/**
+	 * Check whether a monoid instance defines an absorbing element.
+	 *
+	 * True for monoids whose instance implements the optional
+	 * `monoid::absorbing` predicate.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   static_assert(ftl::AbsorbingMonoid<ftl::any>{}, "");
+	 *   static_assert(!ftl::AbsorbingMonoid<ftl::sum_monoid<int>>{}, "");
+	 * \endcode
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename M>
+	struct AbsorbingMonoid {
+		static constexpr bool value = Monoid<M>::value
+			&& !std::is_same<
+				decltype(_dtl::test_absorbing<M>(nullptr)),
+				_dtl::no
+			>::value;
+
+		constexpr operator bool() const noexcept {
+			return value;
+		}
+	};
+
+	namespace _dtl {
+		template<typename M>
+		constexpr bool test_commutative(decltype(&monoid<M>::commutative)) {
+			return monoid<M>::commutative;
+		}
+
+		template<typename M>
+		constexpr bool test_commutative(...) {
+			return false;
+		}
+	}
+
+	/**
+	 * Check whether a monoid instance is declared commutative.
+	 *
+	 * True for monoids whose instance defines `monoid::commutative` as
+	 * `true`. Parallel folds into such monoids need not preserve the order
+	 * of the elements.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   static_assert(ftl::CommutativeMonoid<ftl::sum_monoid<int>>{}, "");
+	 *   static_assert(!ftl::CommutativeMonoid<std::string>{}, "");
+	 * \endcode
+	 *
+	 * \ingroup monoid
+	 */
+	template<typename M>
+	struct CommutativeMonoid {
+		static constexpr bool value = Monoid<M>::value
+			&& _dtl::test_commutative<M>(nullptr);
+
+		constexpr operator bool() const noexcept {
+			return value;
+		}
+	};
+
+	namespace _dtl {
+		template<typename M, bool = AbsorbingMonoid<M>::value>
+		struct absorption {
+			static constexpr bool absorbed(const M& m) {
+				return monoid<M>::absorbing(m);
+			}
+		};
+
+		template<typename M>
+		struct absorption<M,false> {
+			static constexpr bool absorbed(const M&) noexcept {
+				return false;
+			}
+		};
+
+		// Whether m is known to absorb anything appended to it
+		template<typename M>
+		constexpr bool absorbed(const M& m) {
+			return absorption<M>::absorbed(m);
+		}
+
+		template<typename M>
+		bool test_mconcat(
+			decltype(
+				monoid<M>::mconcat(
+					std::declval<const std::initializer_list<M>&>()
+				)
+			)*
+		);
+
+		template<typename M>
+		no test_mconcat(...);
+
+		// Whether monoid<M> has an n-way mconcat of its own
+		template<typename M>
+		struct has_mconcat
+		: std::integral_constant<
+			bool,
+			!std::is_same<decltype(test_mconcat<M>(nullptr)), no>::value
+		> {};
+	}
+
 	/**
 	 * Convenience operator to ease use of append.
 	 *
@@ -242,6 +398,63 @@ namespace ftl {
 	mappend;
 #endif
 
+#ifndef DOCUMENTATION_GENERATOR
+	constexpr struct _mconcat {
+		template<
+				typename I,
+				typename M = plain_type<
+					decltype(*std::declval<_dtl::begin_type<I&>>())
+				>,
+				typename = Requires<Monoid<M>{}>
+		>
+		M operator() (I&& ms) const {
+			return concat<M>(std::forward<I>(ms), _dtl::has_mconcat<M>{});
+		}
+
+	private:
+		template<typename M, typename I>
+		static M concat(I&& ms, std::true_type) {
+			return monoid<M>::mconcat(std::forward<I>(ms));
+		}
+
+		template<typename M, typename I>
+		static M concat(I&& ms, std::false_type) {
+			using E = typename std::conditional<
+				std::is_lvalue_reference<I>::value, const M&, M&&
+			>::type;
+
+			auto z = monoid<M>::id();
+			for(auto& m : ms) {
+				z = monoid<M>::append(std::move(z), static_cast<E>(m));
+			}
+
+			return z;
+		}
+	} mconcat{};
+#else
+	struct ImplementationDefined {
+	}
+	/**
+	 * Concatenates a whole sequence of monoids.
+	 *
+	 * Equivalent to appending all the elements of `ms` in order, starting
+	 * with `monoid::id()`, but uses the instance's own `monoid::mconcat` if
+	 * it has one. If `ms` is an rvalue, its elements are moved from.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<std::string> words{"con", "cat", "en", "ate"};
+	 *
+	 *   // Sizes the result once, rather than for every append
+	 *   std::string s = ftl::mconcat(words);
+	 * \endcode
+	 *
+	 * \ingroup monoid
+	 */
+	mconcat;
+#endif
+
 	/**
 	 * Tag that can be used to specify which concept implementation to derive.
 	 *
@@ -423,7 +636,9 @@ namespace ftl {
 	 */
 	template<typename N>
 	struct monoid<sum_monoid<N>>
-	: deriving_monoid<in_terms_of_plus<sum_monoid<N>>> {};
+	: deriving_monoid<in_terms_of_plus<sum_monoid<N>>> {
+		static constexpr bool commutative = true;
+	};
 
 	/**
 	 * Implementation of monoid for numbers, when interpreted as products.
@@ -529,6 +744,14 @@ namespace ftl {
 			return n1 * n2;
 		}
 
+		/// `0` for integral `N`; floating point zeros do not absorb `NaN`
+		template<typename U = N, typename = Requires<std::is_integral<U>::value>>
+		static constexpr bool absorbing(const prod_monoid<N>& n) noexcept {
+			return n.n == N(0);
+		}
+
+		static constexpr bool commutative = true;
+
 		static constexpr bool instance = true;
 	};
 
@@ -606,6 +829,13 @@ namespace ftl {
 			return a1.b || a2.b;
 		}
 
+		/// `true` absorbs anything
+		static constexpr bool absorbing(any a) noexcept {
+			return a.b;
+		}
+
+		static constexpr bool commutative = true;
+
 		static constexpr bool instance = true;
 	};
 
@@ -674,6 +904,13 @@ namespace ftl {
 			return a1 && a2;
 		}
 
+		/// `false` absorbs anything
+		static constexpr bool absorbing(all a) noexcept {
+			return !a.b;
+		}
+
+		static constexpr bool commutative = true;
+
 		static constexpr bool instance = true;
 	};
 
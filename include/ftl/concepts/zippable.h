@@ -24,6 +24,9 @@
 #define FTL_ZIPPABLE_H
 
 #include <tuple>
+#include <limits>
+#include <algorithm>
+#include <initializer_list>
 #include "../prelude.h"
 #include "common.h"
 
@@ -57,6 +60,9 @@ namespace ftl {
 	 *
 	 * \par Dependencies
 	 * - `<tuple>`
+ * - `<limits>`
+ * - `<algorithm>`
+ * - `<initializer_list>`
 	 * - \ref prelude
 	 */
 
@@ -102,6 +108,19 @@ namespace ftl {
 		template<typename U, typename F, typename V = result_of<F(T,U)>>
 		static Z<V> zipWith(F f, const Z<T>& z1, const Z<U>& z2);
 
+		/**
+		 * Zips together any number of zippables using a function.
+		 *
+		 * Instances are encouraged, but not required, to provide this
+		 * overload. `f` is called with one element from each argument, and
+		 * the result is as long as the shortest of them.
+		 */
+		template<
+				typename F, typename...Us,
+				typename V = result_of<F(T,Us...)>
+		>
+		static Z<V> zipWith(F f, const Z<T>& z, const Z<Us>&...zs);
+
 #endif
 
 		/// Compile time constant to check if a type is an instance.
@@ -136,6 +155,90 @@ namespace ftl {
 		}
 	};
 
+	namespace _dtl {
+		template<typename...Is>
+		struct forward_iterables : std::true_type {};
+
+		template<typename I, typename...Is>
+		struct forward_iterables<I,Is...> : std::integral_constant<
+			bool, ForwardIterable<I>() && forward_iterables<Is...>::value
+		> {};
+
+		template<typename...Its, size_t...I>
+		bool zip_done(
+				const std::tuple<Its...>& its, const std::tuple<Its...>& ends,
+				seq<I...>) {
+			bool done = false;
+			(void)std::initializer_list<bool>{
+				(done = done || std::get<I>(its) == std::get<I>(ends))...
+			};
+			return done;
+		}
+
+		template<typename...Its, size_t...I>
+		void zip_next(std::tuple<Its...>& its, seq<I...>) {
+			(void)std::initializer_list<int>{(++std::get<I>(its), 0)...};
+		}
+
+		template<typename F, typename...Its, size_t...I>
+		auto zip_apply(F& f, const std::tuple<Its...>& its, seq<I...>)
+		-> decltype(f(*std::get<I>(its)...)) {
+			return f(*std::get<I>(its)...);
+		}
+
+		/* Walks all of is in lockstep, handing f's combination of each
+		 * position to sink, until the shortest of them runs out. Nothing but
+		 * the iterators themselves is stored along the way.
+		 */
+		template<typename Sink, typename F, typename...Is>
+		void zip_each(Sink&& sink, F& f, const Is&...is) {
+			using S = index_seq<sizeof...(Is)>;
+
+			auto its = std::make_tuple(begin(is)...);
+			const auto ends = std::make_tuple(end(is)...);
+
+			while(!zip_done(its, ends, S{})) {
+				sink(zip_apply(f, its, S{}));
+				zip_next(its, S{});
+			}
+		}
+
+		template<typename C>
+		struct push_back_sink {
+			template<typename X>
+			void operator() (X&& x) const {
+				c.push_back(std::forward<X>(x));
+			}
+
+			C& c;
+		};
+
+		template<typename I>
+		auto zip_size(const I& i, bool&, int) -> decltype(size_t(i.size())) {
+			return i.size();
+		}
+
+		template<typename I>
+		size_t zip_size(const I&, bool& known, ...) {
+			known = false;
+			return 0;
+		}
+
+		/* Length of the result of zipping is, if every one of them knows its
+		 * size, and 0 otherwise. Reserving by the known sizes alone could
+		 * vastly overshoot, e.g. when zipping a large vector with a maybe.
+		 */
+		template<typename...Is>
+		size_t zip_size_hint(const Is&...is) {
+			bool known = true;
+			size_t n = std::numeric_limits<size_t>::max();
+			(void)std::initializer_list<int>{
+				(n = std::min(n, zip_size(is, known, 0)), 0)...
+			};
+			return known ? n : 0;
+		}
+	}
+
 	template<typename>
 	struct deriving_zippable {};
 
@@ -152,10 +255,11 @@ namespace ftl {
 	 * preferable due to details that cannot be known by this generalised
 	 * implementation.
 	 *
-	 * Note that deriving this implementation results in a `zipWith` that for
-	 * second parameter accepts an instance of any type that satisfies
-	 * \ref fwditerable. In other words, it would be possible to zip a list
-	 * deriving this implementation with e.g. a `maybe<SomeType>`.
+	 * Note that deriving this implementation results in a `zipWith` that
+	 * after the first parameter accepts any number of instances of any types
+	 * that satisfy \ref fwditerable. In other words, it would be possible to
+	 * zip a list deriving this implementation with e.g. a `maybe<SomeType>`
+	 * and a `vector<OtherType>` at once.
 	 *
 	 * \par Examples
 	 *
@@ -175,22 +279,16 @@ namespace ftl {
 		using Z_ = Rebind<Z,U>;
 
 		template<
-				typename F, typename Iterable,
-				typename U = result_of<F(T,Value_type<Iterable>)>,
+				typename F, typename...Iterables,
+				typename U = result_of<F(T,Value_type<Iterables>...)>,
 				typename = Requires<
-					ForwardIterable<Iterable>()
+					_dtl::forward_iterables<Iterables...>::value
 				>
 		>
-		static Z_<U> zipWith(F f, const Z_<T>& z, const Iterable& i) {
-			auto it1 = z.begin();
-			auto it2 = i.begin();
-
+		static Z_<U> zipWith(F f, const Z_<T>& z, const Iterables&...is) {
 			Z_<U> result;
 
-			while(it1 != z.end() && it2 != i.end()) {
-				result.push_back(f(*it1, *it2));
-				++it1; ++it2;
-			}
+			_dtl::zip_each(_dtl::push_back_sink<Z_<U>>{result}, f, z, is...);
 
 			return result;
 		}
@@ -211,6 +309,18 @@ namespace ftl {
 			return zippable<Z>::zipWith(std::forward<F>(f), z, i);
 		}
 
+		template<
+				typename F, typename Z, typename I, typename I2,
+				typename...Is,
+				typename = Requires<Zippable<Z>{}>
+		>
+		auto operator() (
+				F&& f, const Z& z, const I& i, const I2& i2, const Is&...is
+		) const
+		-> decltype(zippable<Z>::zipWith(std::forward<F>(f), z, i, i2, is...)) {
+			return zippable<Z>::zipWith(std::forward<F>(f), z, i, i2, is...);
+		}
+
 		using curried_ternf<_zipWith>::operator();
 	} zipWith{};
 #else
@@ -224,12 +334,17 @@ namespace ftl {
 	 *   ((T,U) -> V, Z<T>, Z<U>) -> Z<V>
 	 * \endcode
 	 *
-	 * Allows a clean and terse call syntax of the concept method.
+	 * Allows a clean and terse call syntax of the concept method. Given more
+	 * than two zippables, `f` must accept as many arguments; the curried
+	 * forms are only available for the binary case.
 	 *
 	 * \par Examples
 	 *
 	 * \code
 	 *   auto z = ftl::zipWith(foo, std::list{...}, std::list{...});
+	 *
+	 *   auto sum3 = [](int x, int y, int w){ return x + y + w; };
+	 *   auto s = ftl::zipWith(sum3, std::vector{...}, std::list{...}, ...);
 	 * \endcode
 	 *
 	 * \ingroup zippable
@@ -240,34 +355,24 @@ namespace ftl {
 #ifndef DOCUMENTATION_GENERATOR
 	constexpr struct _zip : public _dtl::curried_binf<_zip> {
 	private:
-		template<typename T, typename U>
+		template<typename...Ts>
 		struct mktup {
-			std::tuple<T,U> operator() (const T& t, const U& u) const {
-				return std::make_tuple(t, u);
-			}
-
-			std::tuple<T,U> operator() (T&& t, const U& u) const {
-				return std::make_tuple(std::move(t), u);
-			}
-
-			std::tuple<T,U> operator() (const T& t, U&& u) const {
-				return std::make_tuple(t, std::move(u));
-			}
-
-			std::tuple<T,U> operator() (T&& t, U&& u) const {
-				return std::make_tuple(std::move(t), std::move(u));
+			template<typename...Xs>
+			std::tuple<Ts...> operator() (Xs&&...xs) const {
+				return std::tuple<Ts...>(std::forward<Xs>(xs)...);
 			}
 		};
 
 	public:
 		template<
-				typename Z, typename I,
+				typename Z, typename I, typename...Is,
+				typename M = mktup<Value_type<Z>,Value_type<I>,Value_type<Is>...>,
 				typename = Requires<Zippable<Z>{}>
 		>
-		auto operator() (const Z& z, const I& i) const
-		-> decltype(zippable<Z>::zipWith(mktup<Value_type<Z>,Value_type<I>>{}, z, i)) {
+		auto operator() (const Z& z, const I& i, const Is&...is) const
+		-> decltype(zippable<Z>::zipWith(M{}, z, i, is...)) {
 
-			return zippable<Z>::zipWith(mktup<Value_type<Z>,Value_type<I>>{}, z, i);
+			return zippable<Z>::zipWith(M{}, z, i, is...);
 		}
 
 		using curried_binf<_zip>::operator();
@@ -284,7 +389,8 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * In other words, zipping two lists with this function object results in
-	 * a list containing pairs of elements.
+	 * a list containing pairs of elements. Any number of further zippables
+	 * may be given, in which case the tuples grow accordingly.
 	 *
 	 * \par Examples
 	 *
@@ -0,0 +1,484 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_COROUTINE_H
+#define FTL_COROUTINE_H
+
+#ifdef __cpp_impl_coroutine
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <utility>
+#include "maybe.h"
+#include "either.h"
+#include "either_trans.h"
+#include "async.h"
+#include "memory_resource.h"
+#include "instrument.h"
+
+/// Defined when the compiler supports the coroutines of \ref coroutine
+#define FTL_COROUTINES 1
+
+namespace ftl {
+
+	/**
+	 * \defgroup coroutine Coroutines
+	 *
+	 * Do-notation for some of FTL's monads, by way of C++20 coroutines.
+	 *
+	 * \code
+	 *   #include <ftl/coroutine.h>
+	 * \endcode
+	 *
+	 * Functions returning one of the following types may be written as
+	 * coroutines:
+	 * - `ftl::maybe<T>`
+	 * - `ftl::either<L,T>`
+	 * - `ftl::future<T>`
+	 * - `ftl::eitherT<L,ftl::future<T>>`
+	 *
+	 * Inside such a function, `co_await` on a value of the same monad (with
+	 * any value type, but the same left type for `either` and `eitherT`)
+	 * stands in for `bind`: it yields the contained value, or, should there
+	 * be none, ends the coroutine with that same failure. `co_return` stands
+	 * in for `pure`. A whole monadic block hence compiles into a single
+	 * coroutine, with none of the closures a chain of `>>=` would create:
+	 * \code
+	 *   ftl::maybe<int> add(ftl::maybe<int> a, ftl::maybe<int> b) {
+	 *       int x = co_await a;
+	 *       int y = co_await b;
+	 *       co_return x + y;
+	 *   }
+	 * \endcode
+	 *
+	 * Coroutines returning `maybe` or `either` run to completion before
+	 * returning, and their frames never outlive the call. Compilers are thus
+	 * free to elide their allocation entirely. Coroutines returning futures
+	 * suspend whenever they await a future that is not yet ready, and are
+	 * resumed by whichever thread completes that future. No thread blocks.
+	 *
+	 * Frames that are allocated are counted as ftl::alloc_source::monad. A
+	 * free function coroutine taking `std::allocator_arg` followed by an
+	 * ftl::resource_allocator as its first parameters has its frame
+	 * allocated from that allocator's resource instead:
+	 * \code
+	 *   ftl::future<int> f(std::allocator_arg_t, ftl::resource_allocator<char> a);
+	 * \endcode
+	 *
+	 * Only available when compiling with coroutine support, in which case
+	 * `FTL_COROUTINES` is defined. Otherwise, including this header has no
+	 * effect.
+	 *
+	 * \par Dependencies
+	 * - <coroutine>
+	 * - \ref maybe
+	 * - \ref either
+	 * - \ref eitherT
+	 * - \ref async
+	 * - \ref memory_resource
+	 */
+
+	namespace _dtl {
+		/*
+		 * Allocation of coroutine frames, inherited by every promise type.
+		 *
+		 * The resource a frame is allocated from, if any, is stored in front
+		 * of it, so that it can be given back on destruction.
+		 */
+		struct coroutine_frame {
+			static void* operator new(std::size_t n) {
+				FTL_COUNT_ALLOCATION(monad, n);
+				return allocate(n, nullptr);
+			}
+
+			template<typename A, typename...Args>
+			static void* operator new(
+					std::size_t n, std::allocator_arg_t,
+					const resource_allocator<A>& a, Args&...) {
+				return allocate(n, a.resource());
+			}
+
+			static void operator delete(void* p, std::size_t n) noexcept {
+				auto h = static_cast<char*>(p) - header;
+				auto r = *reinterpret_cast<memory_resource**>(h);
+
+				if(r)
+					r->deallocate(h, n + header, memory_resource::max_align);
+				else
+					::operator delete(h);
+			}
+
+		private:
+			static constexpr std::size_t header = memory_resource::max_align;
+
+			static void* allocate(std::size_t n, memory_resource* r) {
+				auto h = static_cast<char*>(
+					r ? r->allocate(n + header, memory_resource::max_align)
+						: ::operator new(n + header)
+				);
+
+				*reinterpret_cast<memory_resource**>(h) = r;
+				return h + header;
+			}
+		};
+
+		/*
+		 * What a maybe or either coroutine returns to begin with.
+		 *
+		 * Converted to the actual return type once the coroutine has run, at
+		 * which point it owns the finished frame and takes the result from
+		 * it.
+		 */
+		template<typename P, typename R>
+		class coroutine_result {
+		public:
+			explicit coroutine_result(std::coroutine_handle<P> h) noexcept
+			: h(h) {}
+
+			coroutine_result(const coroutine_result&) = delete;
+			coroutine_result(coroutine_result&& r) noexcept
+			: h(std::exchange(r.h, nullptr)) {}
+
+			~coroutine_result() {
+				if(h)
+					h.destroy();
+			}
+
+			operator R() {
+				auto& p = h.promise();
+				if(p.error)
+					std::rethrow_exception(p.error);
+
+				return std::move(get<R>(p.result));
+			}
+
+		private:
+			std::coroutine_handle<P> h;
+		};
+
+		// Common parts of maybe and either promises
+		template<typename P, typename R>
+		struct sync_promise : coroutine_frame {
+			coroutine_result<P,R> get_return_object() noexcept {
+				return coroutine_result<P,R>{
+					std::coroutine_handle<P>::from_promise(
+						static_cast<P&>(*this)
+					)
+				};
+			}
+
+			std::suspend_never initial_suspend() const noexcept {
+				return {};
+			}
+
+			std::suspend_always final_suspend() const noexcept {
+				return {};
+			}
+
+			void unhandled_exception() noexcept {
+				error = std::current_exception();
+			}
+
+			// Set to a failure, or by co_return, before the caller gets it
+			maybe<R> result{constructor<Nothing>()};
+			std::exception_ptr error;
+		};
+
+		// Awaits a value of type M in a coroutine with the promise P
+		template<typename P, typename M, typename U>
+		struct sync_awaiter {
+			bool await_ready() const noexcept {
+				return !P::failed(m);
+			}
+
+			void await_suspend(std::coroutine_handle<P> h) {
+				h.promise().fail(std::forward<M>(m));
+			}
+
+			U await_resume() {
+				return P::value(std::forward<M>(m));
+			}
+
+			M&& m;
+		};
+
+		template<typename T>
+		struct maybe_promise : sync_promise<maybe_promise<T>,maybe<T>> {
+			template<
+					typename U = T,
+					typename = Requires<std::is_constructible<T,U>::value>
+			>
+			void return_value(U&& u) {
+				this->result = just(maybe<T>{
+					constructor<T>(), std::forward<U>(u)
+				});
+			}
+
+			// co_return of a whole maybe, e.g. nothing<T>()
+			void return_value(maybe<T> m) {
+				this->result = just(std::move(m));
+			}
+
+			template<typename M, typename U = Value_type<plain_type<M>>>
+			sync_awaiter<
+				maybe_promise,M,
+				typename std::conditional<
+					std::is_lvalue_reference<M>::value, const U&, U
+				>::type
+			>
+			await_transform(M&& m) noexcept {
+				static_assert(
+					std::is_same<plain_type<M>,maybe<U>>::value,
+					"Only maybes can be awaited in a maybe coroutine"
+				);
+
+				return {std::forward<M>(m)};
+			}
+
+			template<typename U>
+			static bool failed(const maybe<U>& m) noexcept {
+				return !m.template is<U>();
+			}
+
+			template<typename U>
+			static const U& value(const maybe<U>& m) noexcept {
+				return get<U>(m);
+			}
+
+			template<typename U>
+			static U&& value(maybe<U>&& m) noexcept {
+				return std::move(get<U>(m));
+			}
+
+			template<typename M>
+			void fail(M&&) noexcept {
+				this->result = just(nothing<T>());
+			}
+		};
+
+		template<typename L, typename T>
+		struct either_promise
+		: sync_promise<either_promise<L,T>,either<L,T>> {
+			template<
+					typename U = T,
+					typename = Requires<std::is_constructible<T,U>::value>
+			>
+			void return_value(U&& u) {
+				this->result = just(either<L,T>{
+					constructor<Right<T>>(), std::forward<U>(u)
+				});
+			}
+
+			// co_return of a whole either, e.g. make_left<T>(l)
+			void return_value(either<L,T> e) {
+				this->result = just(std::move(e));
+			}
+
+			template<typename M, typename U = Value_type<plain_type<M>>>
+			sync_awaiter<
+				either_promise,M,
+				typename std::conditional<
+					std::is_lvalue_reference<M>::value, const U&, U
+				>::type
+			>
+			await_transform(M&& m) noexcept {
+				static_assert(
+					std::is_same<plain_type<M>,either<L,U>>::value,
+					"Only eithers of the same left type can be awaited in an "
+					"either coroutine"
+				);
+
+				return {std::forward<M>(m)};
+			}
+
+			template<typename U>
+			static bool failed(const either<L,U>& e) noexcept {
+				return e.template is<Left<L>>();
+			}
+
+			template<typename U>
+			static const U& value(const either<L,U>& e) noexcept {
+				return get<Right<U>>(e).val;
+			}
+
+			template<typename U>
+			static U&& value(either<L,U>&& e) noexcept {
+				return std::move(get<Right<U>>(e).val);
+			}
+
+			template<typename U>
+			void fail(const either<L,U>& e) {
+				this->result = just(make_left<T>(get<Left<L>>(e).val));
+			}
+
+			template<typename U>
+			void fail(either<L,U>&& e) {
+				this->result = just(make_left<T>(std::move(get<Left<L>>(e).val)));
+			}
+		};
+
+		// Common parts of the promises of coroutines returning futures
+		template<typename R>
+		struct async_promise : coroutine_frame {
+			std::suspend_never initial_suspend() const noexcept {
+				return {};
+			}
+
+			std::suspend_never final_suspend() const noexcept {
+				return {};
+			}
+
+			void unhandled_exception() {
+				p.set_exception(std::current_exception());
+			}
+
+			promise<R> p;
+		};
+
+		// Resumes the coroutine once a future is ready
+		template<typename U>
+		struct future_awaiter {
+			bool await_ready() const {
+				return f.ready();
+			}
+
+			void await_suspend(std::coroutine_handle<> h) {
+				async_access::state(f)->on_ready([h](){ h.resume(); });
+			}
+
+			const U& await_resume() const {
+				return f.get();
+			}
+
+			future<U> f;
+		};
+
+		template<typename T>
+		struct future_promise : async_promise<T> {
+			future<T> get_return_object() {
+				return this->p.get_future();
+			}
+
+			template<typename U = T>
+			void return_value(U&& u) {
+				this->p.set_value(std::forward<U>(u));
+			}
+
+			template<typename U>
+			future_awaiter<U> await_transform(const future<U>& f) {
+				return {f};
+			}
+		};
+
+		/*
+		 * Awaits an eitherT over a future.
+		 *
+		 * A right value resumes the coroutine. A left value, or an
+		 * exception, completes the coroutine's own future instead, and the
+		 * coroutine is destroyed without being resumed.
+		 */
+		template<typename L, typename T, typename U>
+		struct either_future_awaiter {
+			bool await_ready() const {
+				return f.ready() && f.get().template is<Right<U>>();
+			}
+
+			template<typename P>
+			void await_suspend(std::coroutine_handle<P> h) {
+				auto s = async_access::state(f).get();
+				s->on_ready([h,s]() {
+					if(!s->failed() && s->get().template is<Right<U>>()) {
+						h.resume();
+						return;
+					}
+
+					auto p = h.promise().p;
+					h.destroy();
+
+					if(s->failed())
+						p.set_exception(s->exception());
+					else
+						p.set_value(make_left<T>(get<Left<L>>(s->get()).val));
+				});
+			}
+
+			const U& await_resume() const {
+				return get<Right<U>>(f.get()).val;
+			}
+
+			future<either<L,U>> f;
+		};
+
+		template<typename L, typename T>
+		struct either_future_promise : async_promise<either<L,T>> {
+			eitherT<L,future<T>> get_return_object() {
+				return eitherT<L,future<T>>{this->p.get_future()};
+			}
+
+			template<
+					typename U = T,
+					typename = Requires<std::is_constructible<T,U>::value>
+			>
+			void return_value(U&& u) {
+				this->p.set_value(either<L,T>{
+					constructor<Right<T>>(), std::forward<U>(u)
+				});
+			}
+
+			// co_return of a whole either, e.g. make_left<T>(l)
+			void return_value(either<L,T> e) {
+				this->p.set_value(std::move(e));
+			}
+
+			template<typename U>
+			either_future_awaiter<L,T,U> await_transform(
+					const eitherT<L,future<U>>& e) {
+				return {*e};
+			}
+		};
+	}
+}
+
+template<typename T, typename...Args>
+struct std::coroutine_traits<ftl::maybe<T>,Args...> {
+	using promise_type = ftl::_dtl::maybe_promise<T>;
+};
+
+template<typename L, typename T, typename...Args>
+struct std::coroutine_traits<ftl::either<L,T>,Args...> {
+	using promise_type = ftl::_dtl::either_promise<L,T>;
+};
+
+template<typename T, typename...Args>
+struct std::coroutine_traits<ftl::future<T>,Args...> {
+	using promise_type = ftl::_dtl::future_promise<T>;
+};
+
+template<typename L, typename T, typename...Args>
+struct std::coroutine_traits<ftl::eitherT<L,ftl::future<T>>,Args...> {
+	using promise_type = ftl::_dtl::either_future_promise<L,T>;
+};
+
+#endif
+#endif
+
@@ -170,6 +170,9 @@ namespace ftl {
 		Left(Left&&) = default;
 		~Left() = default;
 
+		Left& operator= (const Left&) = default;
+		Left& operator= (Left&&) = default;
+
 		explicit constexpr Left(const T& t) : val(t) {}
 		explicit constexpr Left(T&& t) : val(std::move(t)) {}
 
@@ -373,10 +376,14 @@ namespace ftl {
 		 */
 		static constexpr either<L,T> pure(const T& t)
 		noexcept(std::is_nothrow_copy_constructible<T>::value) {
-			return make_right<L>(t);
+			return either<L,T>{constructor<Right<T>>(), t};
 		}
 
 		/// \overload
+		template<
+				typename U = T,
+				typename = Requires<!std::is_reference<U>::value>
+		>
 		static constexpr either<L,T> pure(T&& t)
 		noexcept(std::is_nothrow_move_constructible<T>::value) {
 			return make_right<L>(std::move(t));
@@ -403,20 +410,18 @@ namespace ftl {
 		 * \endcode
 		 */
 		template<typename F, typename U = result_of<F(T)>>
-		static either<L,U> map(F f, const either<L,T>& e) {
-			return e.match(
-				[f](const Right<T>& r){ return make_right<L>(f(*r)); },
-				[](const Left<L>& l){ return make_left<U>(*l); }
-			);
+		static constexpr either<L,U> map(F f, const either<L,T>& e) {
+			return e.template is<Right<T>>()
+				? make_right<L>(f(*get<Right<T>>(e)))
+				: make_left<U>(*get<Left<L>>(e));
 		}
 
 		/// \overload
 		template<typename F, typename U = result_of<F(T)>>
-		static either<L,U> map(F f, either<L,T>&& e) {
-			return e.match(
-				[f](Right<T>& r){ return make_right<L>(f(std::move(*r))); },
-				[](Left<L>& l){ return make_left<U>(std::move(*l)); }
-			);
+		static constexpr either<L,U> map(F f, either<L,T>&& e) {
+			return e.template is<Right<T>>()
+				? make_right<L>(f(std::forward<T>(get<Right<T>>(e).val)))
+				: make_left<U>(std::move(get<Left<L>>(e).val));
 		}
 
 		/**
@@ -431,25 +436,56 @@ namespace ftl {
 		 *           type that can be contained in an `either`.
 		 */
 		template<typename F, typename U = Value_type<result_of<F(T)>>>
-		static either<L,U> bind(const either<L,T>& e, F f) {
-			return e.match(
-				[](const Left<L>& l){ return make_left<U>(*l); },
-				[f](const Right<T>& r){ return f(*r); }
-			);
+		static constexpr either<L,U> bind(const either<L,T>& e, F f) {
+			return e.template is<Right<T>>()
+				? either<L,U>(f(*get<Right<T>>(e)))
+				: make_left<U>(*get<Left<L>>(e));
 		}
 
 		/// \overload
 		template<typename F, typename U = Value_type<result_of<F(T)>>>
-		static either<L,U> bind(either<L,T>&& e, F f) {
-			return e.match(
-				[](Left<L>& l){ return make_left<U>(std::move(*l)); },
-				[f](Right<T>& r){ return f(std::move(*r)); }
-			);
+		static constexpr either<L,U> bind(either<L,T>&& e, F f) {
+			return e.template is<Right<T>>()
+				? either<L,U>(f(std::forward<T>(get<Right<T>>(e).val)))
+				: make_left<U>(std::move(get<Left<L>>(e).val));
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Left values are failures that absorb any `apply`.
+	 *
+	 * \ingroup either
+	 */
+	template<typename L, typename T>
+	struct short_circuiting<either<L,T>> {
+		static bool failed(const either<L,T>& e) noexcept {
+			return e.template is<Left<L>>();
+		}
+
+		static T&& value(either<L,T>&& e) noexcept {
+			return std::move(get<Right<T>>(e).val);
+		}
+
+		template<typename U>
+		static either<L,U> propagate(either<L,T>&& e) {
+			return make_left<U>(std::move(get<Left<L>>(e).val));
 		}
 
 		static constexpr bool instance = true;
 	};
 }
 
+namespace std {
+	/// Hash of the wrapped value
+	template<typename T>
+	struct hash<ftl::Left<T>> {
+		size_t operator() (const ftl::Left<T>& l) const {
+			return hash<T>()(l.val);
+		}
+	};
+}
+
 #endif
 
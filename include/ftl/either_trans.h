@@ -26,6 +26,7 @@
 #include "prelude.h"
 #include "either.h"
 #include "concepts/monoid.h"
+#include "implementation/function_fwd.h"
 
 namespace ftl {
 	/**
@@ -142,18 +143,143 @@ namespace ftl {
 		using rebind = eitherT<L,Rebind<M,T>>;
 	};
 
+	namespace _dtl {
+		template<typename L, typename M>
+		struct fused_eithert {
+			static constexpr bool value = false;
+		};
+
+		/* When the transformed monad is a function, going through its own
+		 * map and bind costs an extra function object per step, and on
+		 * every Left a pure function object made only to be called at once.
+		 * Instead, each step here is a single function that runs the
+		 * previous one and inspects its either directly, so a chain of n
+		 * binds is n function objects deep, short-circuiting on Left.
+		 */
+		template<typename L, typename T, typename P, typename...Ps>
+		struct fused_eithert<L,function<T(P,Ps...)>> {
+			static constexpr bool value = true;
+
+			template<typename U>
+			using Fn = function<either<L,U>(P,Ps...)>;
+
+			template<typename U, typename F>
+			static Fn<U> map(F f, Fn<T> m) {
+				return [f,m](P p, Ps...ps) -> either<L,U> {
+					return f % m(p, ps...);
+				};
+			}
+
+			// f returns an eitherT<L,function<U(P,Ps...)>>
+			template<typename U, typename F>
+			static Fn<U> bind(Fn<T> m, F f) {
+				return [m,f](P p, Ps...ps) -> either<L,U> {
+					auto e = m(p, ps...);
+					if(e.template is<Left<L>>())
+						return make_left<U>(std::move(*get<Left<L>>(e)));
+
+					return (*f(std::move(*get<Right<T>>(e))))(p, ps...);
+				};
+			}
+
+			// f returns a plain function<U(P,Ps...)>
+			template<typename U, typename F>
+			static Fn<U> lift(Fn<T> m, F f) {
+				return [m,f](P p, Ps...ps) -> either<L,U> {
+					auto e = m(p, ps...);
+					if(e.template is<Left<L>>())
+						return make_left<U>(std::move(*get<Left<L>>(e)));
+
+					return make_right<L>(
+						f(std::move(*get<Right<T>>(e)))(p, ps...)
+					);
+				};
+			}
+
+			// f returns a plain either<L,U>
+			template<typename U, typename F>
+			static Fn<U> hoist(Fn<T> m, F f) {
+				return [m,f](P p, Ps...ps) -> either<L,U> {
+					auto e = m(p, ps...);
+					if(e.template is<Left<L>>())
+						return make_left<U>(std::move(*get<Left<L>>(e)));
+
+					return f(std::move(*get<Right<T>>(e)));
+				};
+			}
+		};
+	}
+
+	namespace _dtl {
+		// Applies an either<L,F> to an either<L,T>, left-biased
+		template<typename L, typename F, typename T, typename U>
+		struct eithert_ap {
+			either<L,U> operator() (const either<L,T>& t) const {
+				if(f.template is<Left<L>>())
+					return make_left<U>(*get<Left<L>>(f));
+
+				if(t.template is<Left<L>>())
+					return make_left<U>(*get<Left<L>>(t));
+
+				return make_right<L>((*get<Right<F>>(f))(*get<Right<T>>(t)));
+			}
+
+			either<L,F> f;
+		};
+
+		template<typename L, typename M, bool = independent_apply<M>::value>
+		struct eithert_apply : deriving_apply<in_terms_of_bind<eitherT<L,M>>> {};
+
+		/*
+		 * Base monads that apply independently are applied through without
+		 * binding, so their effects may overlap.
+		 */
+		template<typename L, typename M>
+		struct eithert_apply<L,M,true> {
+			using T = Value_type<M>;
+
+			template<typename U>
+			using M_ = Rebind<M,U>;
+
+			template<
+					typename Ef,
+					typename F = Value_type<plain_type<Ef>>,
+					typename U = result_of<F(T)>
+			>
+			static eitherT<L,M_<U>> apply(const Ef& ef, const eitherT<L,M>& e) {
+				using ap = eithert_ap<L,F,T,U>;
+
+				auto mf = monad<M_<either<L,F>>>::map(
+					[](const either<L,F>& f) { return ap{f}; },
+					*ef
+				);
+
+				return eitherT<L,M_<U>>{
+					monad<M_<either<L,T>>>::apply(mf, *e)
+				};
+			}
+		};
+	}
+
 	/**
 	 * Monad instance for `eitherT`.
 	 *
 	 * In essence, composes the basic monadic operations of `M` with
-	 * `ftl::either`.
+	 * `ftl::either`. If `M` is an `ftl::function`, `map` and `bind` instead
+	 * build a single function object per step, which checks the result of
+	 * the previous step directly.
+	 *
+	 * If `M` is an \ref independent_apply "independent applicative", such as
+	 * ftl::future, `apply` is that of `M` rather than one in terms of `bind`.
+	 * Both operands' effects are then run, even if the first results in a
+	 * left value.
 	 *
 	 * \ingroup eitherT
 	 */
 	template<typename L, typename M>
 	struct monad<eitherT<L,M>>
 	: deriving_join<in_terms_of_bind<eitherT<L,M>>>
-	, deriving_apply<in_terms_of_bind<eitherT<L,M>>> {
+	, _dtl::eithert_apply<L,M> {
 		using T = typename eitherT<L,M>::T;
 
 		template<typename U>
@@ -192,17 +318,13 @@ namespace ftl {
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static eT<U> map(F f, const eT<T>& e) {
-			return eT<U>{
-				[f](const either<L,T>& e) { return f % e; } % *e
-			};
+			return map_<U>(std::move(f), e, fused{});
 		}
 
 		/// \overload
 		template<typename F, typename U = result_of<F(T)>>
 		static eT<U> map(F f, eT<T>&& e) {
-			return eT<U>{
-				[f](either<L,T>&& e) {return f % std::move(e);} % std::move(*e)
-			};
+			return map_<U>(std::move(f), std::move(e), fused{});
 		}
 
 		/**
@@ -228,8 +350,32 @@ namespace ftl {
 		static constexpr bool instance = true;
 
 	private:
+		using fused_ops = _dtl::fused_eithert<L,M>;
+		using fused = std::integral_constant<bool, fused_ops::value>;
+
+		template<typename U, typename F>
+		static eT<U> map_(F f, const eT<T>& e, std::false_type) {
+			return eT<U>{
+				[f](const either<L,T>& e) { return f % e; } % *e
+			};
+		}
+
+		template<typename U, typename F>
+		static eT<U> map_(F f, eT<T>&& e, std::false_type) {
+			return eT<U>{
+				[f](either<L,T> e) { return f % std::move(e); } % std::move(*e)
+			};
+		}
+
+		template<typename U, typename F, typename E>
+		static eT<U> map_(F f, E&& e, std::true_type) {
+			return eT<U>{
+				fused_ops::template map<U>(std::move(f), *std::forward<E>(e))
+			};
+		}
+
 		// Helper struct required to implement automatic lift and hoist
-		template<typename M2>
+		template<typename M2, bool = fused::value>
 		struct bind_helper {
 			using U = Value_type<M2>;
 
@@ -271,7 +417,7 @@ namespace ftl {
 
 		// Normal case, we're binding with a computation in eitherT
 		template<typename M2>
-		struct bind_helper<eitherT<L,M2>> {
+		struct bind_helper<eitherT<L,M2>,false> {
 			using U = Value_type<M2>;
 
 			template<typename F>
@@ -301,7 +447,7 @@ namespace ftl {
 
 		// Automatic hoisting of plain either
 		template<typename U>
-		struct bind_helper<either<L,U>> {
+		struct bind_helper<either<L,U>,false> {
 
 			template<typename F>
 			static eT<U> bind(const eT<T>& e, F f) {
@@ -325,9 +471,69 @@ namespace ftl {
 				};
 			}
 		};
+
+		// The same three cases, each step fused into a single function
+		template<typename M2>
+		struct bind_helper<M2,true> {
+			using U = Value_type<M2>;
+
+			template<
+					typename F,
+					typename = Requires<std::is_same<Rebind<M,U>, M2>::value>
+			>
+			static eT<U> bind(const eT<T>& e, F f) {
+				return eT<U>{fused_ops::template lift<U>(*e, std::move(f))};
+			}
+
+			template<
+					typename F,
+					typename = Requires<std::is_same<Rebind<M,U>, M2>::value>
+			>
+			static eT<U> bind(eT<T>&& e, F f) {
+				return eT<U>{
+					fused_ops::template lift<U>(std::move(*e), std::move(f))
+				};
+			}
+		};
+
+		template<typename M2>
+		struct bind_helper<eitherT<L,M2>,true> {
+			using U = Value_type<M2>;
+
+			template<typename F>
+			static eT<U> bind(const eT<T>& e, F f) {
+				return eT<U>{fused_ops::template bind<U>(*e, std::move(f))};
+			}
+
+			template<typename F>
+			static eT<U> bind(eT<T>&& e, F f) {
+				return eT<U>{
+					fused_ops::template bind<U>(std::move(*e), std::move(f))
+				};
+			}
+		};
+
+		template<typename U>
+		struct bind_helper<either<L,U>,true> {
+			template<typename F>
+			static eT<U> bind(const eT<T>& e, F f) {
+				return eT<U>{fused_ops::template hoist<U>(*e, std::move(f))};
+			}
+
+			template<typename F>
+			static eT<U> bind(eT<T>&& e, F f) {
+				return eT<U>{
+					fused_ops::template hoist<U>(std::move(*e), std::move(f))
+				};
+			}
+		};
 	};
 
 	// Forward declarations
+	/// eitherT applies independently whenever its base monad does
+	template<typename L, typename M>
+	struct independent_apply<eitherT<L,M>> : independent_apply<M> {};
+
 	template<typename> struct foldable;
 	template<typename> struct deriving_fold;
 	template<typename> struct deriving_foldMap;
@@ -354,12 +560,12 @@ namespace ftl {
 		static U foldl(F f, U z, const eitherT<L,M>& me) {
 			return foldable<Met>::foldl(
 				[f](U z, const either<L,T>& e){
-					return e.match(
-						[z](Left<L>){ return z; },
-						[f,z](const Right<T>& r){ return f(z, *r); }
-					); 
+					if(e.template is<Right<T>>())
+						return f(std::move(z), *get<Right<T>>(e));
+
+					return z;
 				},
-				z,
+				std::move(z),
 				*me
 			);
 		}
@@ -374,12 +580,12 @@ namespace ftl {
 		static U foldr(F f, U z, const eitherT<L,M>& me) {
 			return foldable<Met>::foldr(
 				[f](const either<L,T>& e, U z){
-					return e.match(
-						[z](Left<L>){ return z; },
-						[f,z](const Right<T>& r){ return f(*r, z); }
-					); 
+					if(e.template is<Right<T>>())
+						return f(*get<Right<T>>(e), std::move(z));
+
+					return z;
 				},
-				z,
+				std::move(z),
 				*me
 			);
 		}
@@ -0,0 +1,485 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_EVICTABLE_LAZY_H
+#define FTL_EVICTABLE_LAZY_H
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include "lazy.h"
+
+namespace ftl {
+	/**
+	 * \defgroup evictable_lazy Evictable Lazy
+	 *
+	 * Lazy values whose memoised results may be dropped, and recomputed.
+	 *
+	 * \code
+	 *   #include <ftl/evictable_lazy.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - \ref lazy
+	 */
+
+	class eviction_pool;
+
+	namespace _dtl {
+		template<typename> class evictable_cell;
+
+		// Link of an evictable value in the LRU list of its pool
+		struct evictable_node {
+			virtual ~evictable_node() = default;
+
+			// Drops the cached value, called by the pool only
+			virtual void drop() noexcept = 0;
+
+			evictable_node* prev = nullptr;
+			evictable_node* next = nullptr;
+			std::size_t cost = 0;
+			bool linked = false;
+		};
+	}
+
+	/**
+	 * A memory budget shared by a set of evictable lazy values.
+	 *
+	 * Every forced ftl::evictable_lazy created with a pool counts the cost
+	 * of its value, by default its size in bytes, against the pool. Whenever
+	 * forcing a value takes the total over budget, the least recently used
+	 * values are evicted until it is back within budget. The value being
+	 * forced is never evicted to make room for itself, so a single value
+	 * larger than the whole budget stays until something else is forced.
+	 *
+	 * Values are _used_ whenever they are forced, whether they needed to be
+	 * computed or not.
+	 *
+	 * Keeping track of use is a constant time operation on an intrusive
+	 * list. The pool is not synchronised: all of the values sharing it must
+	 * be used from one thread at a time. A pool must outlive every value
+	 * that was created with it.
+	 *
+	 * \ingroup evictable_lazy
+	 */
+	class eviction_pool {
+	public:
+		/// A pool evicting values once their costs exceed `budget`
+		explicit eviction_pool(
+				std::size_t budget = std::numeric_limits<std::size_t>::max())
+		noexcept
+		: limit(budget) {}
+
+		eviction_pool(const eviction_pool&) = delete;
+		eviction_pool& operator= (const eviction_pool&) = delete;
+
+		~eviction_pool() {
+			evict_all();
+		}
+
+		/// The total cost of the values currently held
+		std::size_t used() const noexcept {
+			return total;
+		}
+
+		std::size_t budget() const noexcept {
+			return limit;
+		}
+
+		/// Change the budget, evicting values right away if it shrank
+		void set_budget(std::size_t budget) noexcept {
+			limit = budget;
+			shrink(nullptr);
+		}
+
+		/// Number of values currently held
+		std::size_t size() const noexcept {
+			return count;
+		}
+
+		/// Evict every value held by the pool
+		void evict_all() noexcept {
+			while(head)
+				head->drop();
+		}
+
+	private:
+		template<typename> friend class _dtl::evictable_cell;
+
+		// Most recently used first
+		void push_front(_dtl::evictable_node* n) noexcept {
+			n->prev = nullptr;
+			n->next = head;
+			if(head)
+				head->prev = n;
+			else
+				tail = n;
+
+			head = n;
+			n->linked = true;
+		}
+
+		void unlink(_dtl::evictable_node* n) noexcept {
+			if(n->prev)
+				n->prev->next = n->next;
+			else
+				head = n->next;
+
+			if(n->next)
+				n->next->prev = n->prev;
+			else
+				tail = n->prev;
+
+			n->prev = n->next = nullptr;
+			n->linked = false;
+		}
+
+		void insert(_dtl::evictable_node* n) noexcept {
+			push_front(n);
+			total += n->cost;
+			++count;
+			shrink(n);
+		}
+
+		void touch(_dtl::evictable_node* n) noexcept {
+			if(head != n) {
+				unlink(n);
+				push_front(n);
+			}
+		}
+
+		void remove(_dtl::evictable_node* n) noexcept {
+			unlink(n);
+			total -= n->cost;
+			--count;
+		}
+
+		// Evicts from the back, sparing keep
+		void shrink(_dtl::evictable_node* keep) noexcept {
+			while(total > limit && tail && tail != keep)
+				tail->drop();
+		}
+
+		_dtl::evictable_node* head = nullptr;
+		_dtl::evictable_node* tail = nullptr;
+		std::size_t total = 0;
+		std::size_t count = 0;
+		std::size_t limit;
+	};
+
+	namespace _dtl {
+		template<typename T>
+		struct value_size {
+			std::size_t operator() (const T&) const noexcept {
+				return sizeof(T);
+			}
+		};
+
+		/*
+		 * Shared state of a set of evictable_lazy copies.
+		 *
+		 * Unlike lazy_cell, the thunk is kept once the value is computed,
+		 * so that it can be run again after an eviction. The value is held
+		 * by a shared_ptr, such that values pinned by users outlive their
+		 * eviction.
+		 */
+		template<typename T>
+		class evictable_cell : public evictable_node {
+		public:
+			evictable_cell(
+					eviction_pool* p,
+					unique_function<T()>&& f,
+					unique_function<std::size_t(const T&)>&& c) noexcept
+			: thunk(std::move(f)), cost_of(std::move(c)), pool(p) {}
+
+			~evictable_cell() override {
+				evict();
+			}
+
+			const std::shared_ptr<const T>& force() {
+				if(value) {
+					if(pool)
+						pool->touch(this);
+				}
+				else {
+					// Only published once linked, so that should either the
+					// thunk or the cost function throw, the cell is left
+					// just as it was
+					auto v = std::make_shared<const T>(thunk());
+					if(pool) {
+						cost = cost_of(*v);
+						pool->insert(this);
+					}
+
+					value = std::move(v);
+				}
+
+				return value;
+			}
+
+			bool is_ready() const noexcept {
+				return bool(value);
+			}
+
+			void evict() noexcept {
+				if(linked)
+					pool->remove(this);
+
+				value.reset();
+			}
+
+			void drop() noexcept override {
+				evict();
+			}
+
+			eviction_pool* owner() const noexcept {
+				return pool;
+			}
+
+		private:
+			unique_function<T()> thunk;
+			unique_function<std::size_t(const T&)> cost_of;
+			eviction_pool* pool;
+			std::shared_ptr<const T> value;
+		};
+	}
+
+	/**
+	 * A lazy value that may forget its value, and compute it again.
+	 *
+	 * Behaves like ftl::lazy, in that copies share one computation, which is
+	 * not run until some copy is forced. Rather than keeping the value for as
+	 * long as any copy lives, however, an evictable lazy may drop it, while
+	 * keeping the computation around. The next time it is forced, the value
+	 * is simply computed again. Values are dropped either explicitly, by
+	 * `evict`, or by the ftl::eviction_pool the lazy was created with, when
+	 * the pool runs out of budget.
+	 *
+	 * As the computation may run any number of times, it should be pure.
+	 *
+	 * References to the value obtained by `operator*` or `operator->` are
+	 * only valid until the value is evicted, which may happen whenever some
+	 * other value of the same pool is forced. Use `pin` to hold on to the
+	 * value regardless.
+	 *
+	 * \note Like ftl::lazy, evictable lazies must not be forced concurrently.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref assignable
+	 * - \ref deref to `T` (_forces_ evaluation).
+	 * - \ref functor
+	 * - \ref applicative
+	 * - \ref monad
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::eviction_pool pool(1 << 20);
+	 *
+	 *   auto blob = ftl::evictable_lazy<std::string>(
+	 *       pool,
+	 *       [](){ return load_blob(); },
+	 *       [](const std::string& s){ return s.size(); }
+	 *   );
+	 *
+	 *   use(*blob); // Computed, and counted against pool
+	 *   use(*blob); // Memoised, unless evicted in between
+	 * \endcode
+	 *
+	 * \ingroup evictable_lazy
+	 */
+	template<typename T>
+	class evictable_lazy {
+	public:
+		evictable_lazy() = delete;
+		evictable_lazy(const evictable_lazy&) = default;
+		evictable_lazy(evictable_lazy&&) = default;
+		~evictable_lazy() = default;
+
+		/**
+		 * Construct from a function object, outside of any pool.
+		 *
+		 * The value is only ever dropped by `evict`.
+		 */
+		explicit evictable_lazy(unique_function<T()> f)
+		: cell(make_cell(nullptr, std::move(f), _dtl::value_size<T>{}))
+		{}
+
+		/**
+		 * Construct from a function object, counting against a pool.
+		 *
+		 * Values are counted as `sizeof(T)`, unless a cost function is
+		 * given, which is called on every newly computed value.
+		 */
+		evictable_lazy(eviction_pool& pool, unique_function<T()> f)
+		: cell(make_cell(&pool, std::move(f), _dtl::value_size<T>{}))
+		{}
+
+		/// \overload
+		evictable_lazy(
+				eviction_pool& pool,
+				unique_function<T()> f,
+				unique_function<std::size_t(const T&)> cost)
+		: cell(make_cell(&pool, std::move(f), std::move(cost)))
+		{}
+
+		/**
+		 * Get a reference to the value.
+		 *
+		 * This method forces evaluation.
+		 */
+		const T& operator*() const {
+			return *cell->force();
+		}
+
+		/**
+		 * Access members of the lazy value.
+		 *
+		 * This method forces evaluation.
+		 */
+		const T* operator->() const {
+			return cell->force().get();
+		}
+
+		/**
+		 * Force the value, and keep it alive for as long as the result.
+		 *
+		 * Evicting the value in the meantime merely stops this lazy from
+		 * referring to it.
+		 */
+		std::shared_ptr<const T> pin() const {
+			return cell->force();
+		}
+
+		evictable_lazy& operator= (const evictable_lazy&) = default;
+		evictable_lazy& operator= (evictable_lazy&&) = default;
+
+		/**
+		 * Drop the value, if it has been computed.
+		 *
+		 * Affects every copy of this lazy. The value is computed again the
+		 * next time it is forced.
+		 */
+		void evict() const noexcept {
+			cell->evict();
+		}
+
+		/**
+		 * Check the state of the deferred computation.
+		 *
+		 * \return value_status::deferred if the value has not been computed
+		 *         yet, or has been evicted since, and value_status::ready if
+		 *         it is held.
+		 */
+		value_status status() const noexcept {
+			if(cell->is_ready())
+				return value_status::ready;
+
+			return value_status::deferred;
+		}
+
+		/// The pool this lazy counts against, if any
+		eviction_pool* pool() const noexcept {
+			return cell->owner();
+		}
+
+	private:
+		using cell_type = _dtl::evictable_cell<T>;
+
+		static std::shared_ptr<cell_type> make_cell(
+				eviction_pool* p,
+				unique_function<T()>&& f,
+				unique_function<std::size_t(const T&)>&& c) {
+			FTL_COUNT_ALLOCATION(lazy, sizeof(cell_type));
+			return std::make_shared<cell_type>(p, std::move(f), std::move(c));
+		}
+
+		std::shared_ptr<cell_type> cell;
+	};
+
+	namespace _dtl {
+		// Defers f on the pool of src, if it has one
+		template<typename U, typename T, typename F>
+		evictable_lazy<U> defer_like(const evictable_lazy<T>& src, F&& f) {
+			if(eviction_pool* p = src.pool())
+				return evictable_lazy<U>(*p, std::forward<F>(f));
+
+			return evictable_lazy<U>(std::forward<F>(f));
+		}
+	}
+
+	/**
+	 * Monad instance for evictable lazy values.
+	 *
+	 * Equivalent of the instance for ftl::lazy. The computations built
+	 * count against the pool of the one they were built from, if any, and
+	 * force it again if it has been evicted when they are.
+	 *
+	 * \ingroup evictable_lazy
+	 */
+	template<typename T>
+	struct monad<evictable_lazy<T>>
+	: deriving_join<in_terms_of_bind<evictable_lazy<T>>>
+	, deriving_apply<in_terms_of_bind<evictable_lazy<T>>> {
+
+		/// Create a computation that computes `t`
+		static evictable_lazy<T> pure(T t) {
+			return evictable_lazy<T>{[t](){ return t; }};
+		}
+
+		/**
+		 * Map a function to the deferred value, without forcing it.
+		 *
+		 * The value is pinned while `f` runs, so that `f` never sees it
+		 * evicted from under it.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		static evictable_lazy<U> map(F f, evictable_lazy<T> l) {
+			return _dtl::defer_like<U>(l, [f,l]() {
+				auto p = l.pin();
+				return f(*p);
+			});
+		}
+
+		/**
+		 * Sequences two evictable computations, without forcing either.
+		 *
+		 * Both values are pinned while in use, as in `map`.
+		 */
+		template<
+				typename F,
+				typename U = Value_type<result_of<F(T)>>
+		>
+		static evictable_lazy<U> bind(evictable_lazy<T> l, F f) {
+			return _dtl::defer_like<U>(l, [f,l]() {
+				auto p = l.pin();
+				return U(*f(*p).pin());
+			});
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_EXECUTOR_H
+#define FTL_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "function.h"
+#include "trace.h"
+#include "type_traits.h"
+
+namespace ftl {
+	/**
+	 * \page executorpg Executor
+	 *
+	 * Abstraction of something that runs tasks.
+	 *
+	 * An executor decides _where_ and _when_ a piece of work is run. It could
+	 * be run immediately on the calling thread, on a newly created thread, or
+	 * be queued up for some pool of threads.
+	 *
+	 * For a type `E` to be an executor, the expression
+	 * \code
+	 *   e.execute(f)
+	 * \endcode
+	 * where `e` is an lvalue of type `E` and `f` is a `unique_function<void()>`,
+	 * must be valid. Tasks are hence free to capture move-only state.
+	 * Executors are always referred to by reference, the executor object must
+	 * therefore outlive any work scheduled on it.
+	 *
+	 * \see \ref executor (module)
+	 */
+
+	/**
+	 * \defgroup executor Executor
+	 *
+	 * The \ref executorpg concept and a number of basic executors.
+	 *
+	 * \code
+	 *   #include <ftl/executor.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<atomic>`
+	 * - `<condition_variable>`
+	 * - `<deque>`
+	 * - `<memory>`
+	 * - `<mutex>`
+	 * - `<thread>`
+	 * - `<vector>`
+	 * - \ref function
+	 * - \ref trace
+	 * - \ref typetraits
+	 */
+
+	namespace _dtl {
+		template<typename E>
+		bool test_execute(
+			decltype(std::declval<E&>().execute(unique_function<void()>{}))*
+		);
+
+		template<typename E>
+		no test_execute(...);
+	}
+
+	/**
+	 * Predicate to check if a type is an \ref executorpg.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   template<typename E, typename = Requires<Executor<E>{}>>
+	 *   void foo(E& ex) {
+	 *       ex.execute([](){ doWork(); });
+	 *   }
+	 * \endcode
+	 *
+	 * \ingroup executor
+	 */
+	template<typename E>
+	struct Executor {
+		static constexpr bool value = !std::is_same<
+			decltype(_dtl::test_execute<E>(nullptr)),
+			_dtl::no
+		>::value;
+
+		constexpr operator bool() const noexcept {
+			return value;
+		}
+	};
+
+	/**
+	 * Executor running every task immediately, on the calling thread.
+	 *
+	 * \ingroup executor
+	 */
+	struct inline_executor {
+		void execute(const unique_function<void()>& f) const {
+			f();
+		}
+	};
+
+	/**
+	 * Executor running every task on a new, detached thread.
+	 *
+	 * \ingroup executor
+	 */
+	struct thread_executor {
+		void execute(unique_function<void()> f) const {
+			std::thread(std::move(f)).detach();
+		}
+	};
+
+	/**
+	 * Executor running tasks on a fixed set of threads.
+	 *
+	 * Tasks are kept in a single first-in-first-out queue shared by all of
+	 * the pool's threads. Destroying the pool waits until every task already
+	 * scheduled on it has been run.
+	 *
+	 * \warning Tasks must not throw. Should they do so, `std::terminate` is
+	 *          invoked.
+	 *
+	 * \ingroup executor
+	 */
+	class thread_pool {
+	public:
+		/// Start a pool of `n` threads.
+		explicit thread_pool(
+				std::size_t n = std::thread::hardware_concurrency()) {
+			if(n == 0)
+				n = 1;
+
+			for(std::size_t i = 0; i < n; ++i) {
+				threads.emplace_back([this](){ run(); });
+			}
+		}
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator= (const thread_pool&) = delete;
+
+		~thread_pool() {
+			{
+				std::lock_guard<std::mutex> lock(m);
+				stopping = true;
+			}
+
+			cv.notify_all();
+			for(auto& t : threads)
+				t.join();
+		}
+
+		/// Schedule `f` to be run by one of the pool's threads.
+		void execute(unique_function<void()> f) {
+			{
+				std::lock_guard<std::mutex> lock(m);
+				tasks.push_back(std::move(f));
+			}
+
+			cv.notify_one();
+		}
+
+		/// Number of threads in the pool.
+		std::size_t size() const noexcept {
+			return threads.size();
+		}
+
+	private:
+		void run() {
+			while(true) {
+				unique_function<void()> f;
+				{
+					std::unique_lock<std::mutex> lock(m);
+					cv.wait(lock, [this](){ return stopping || !tasks.empty(); });
+
+					if(tasks.empty())
+						return;
+
+					f = std::move(tasks.front());
+					tasks.pop_front();
+				}
+
+				FTL_TRACE_SCOPE(executor, nullptr);
+				f();
+			}
+		}
+
+		std::mutex m;
+		std::condition_variable cv;
+		std::deque<unique_function<void()>> tasks;
+		bool stopping = false;
+		std::vector<std::thread> threads;
+	};
+
+	/**
+	 * Executor running tasks on a fixed set of work stealing threads.
+	 *
+	 * Every thread in the pool has a task queue of its own. Tasks scheduled
+	 * from within one of the pool's threads are added to that thread's queue,
+	 * and are run in last-in-first-out order, which tends to keep recursively
+	 * spawned work cache local. Tasks scheduled from elsewhere are spread over
+	 * the queues in a round-robin manner. A thread running out of work steals
+	 * the oldest task of some other thread.
+	 *
+	 * Destroying the pool waits until every task already scheduled on it has
+	 * been run.
+	 *
+	 * \warning Tasks must not throw. Should they do so, `std::terminate` is
+	 *          invoked.
+	 *
+	 * \ingroup executor
+	 */
+	class work_stealing_pool {
+	public:
+		/// Start a pool of `n` threads.
+		explicit work_stealing_pool(
+				std::size_t n = std::thread::hardware_concurrency()) {
+			if(n == 0)
+				n = 1;
+
+			for(std::size_t i = 0; i < n; ++i) {
+				queues.emplace_back(new task_queue);
+			}
+
+			for(std::size_t i = 0; i < n; ++i) {
+				threads.emplace_back([this,i](){ run(i); });
+			}
+		}
+
+		work_stealing_pool(const work_stealing_pool&) = delete;
+		work_stealing_pool& operator= (const work_stealing_pool&) = delete;
+
+		~work_stealing_pool() {
+			{
+				std::lock_guard<std::mutex> lock(m);
+				stopping = true;
+			}
+
+			cv.notify_all();
+			for(auto& t : threads)
+				t.join();
+		}
+
+		/// Schedule `f` to be run by one of the pool's threads.
+		void execute(unique_function<void()> f) {
+			auto& w = current_worker();
+			std::size_t i = w.pool == this
+				? w.index
+				: next.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+			// Counted before it is queued, so a thread taking it can never
+			// see the count drop below zero
+			pending.fetch_add(1, std::memory_order_seq_cst);
+
+			{
+				std::lock_guard<std::mutex> lock(queues[i]->m);
+				queues[i]->tasks.push_back(std::move(f));
+			}
+
+			wake();
+		}
+
+		/// Number of threads in the pool.
+		std::size_t size() const noexcept {
+			return threads.size();
+		}
+
+	private:
+		struct task_queue {
+			std::mutex m;
+			std::deque<unique_function<void()>> tasks;
+		};
+
+		struct worker {
+			work_stealing_pool* pool;
+			std::size_t index;
+		};
+
+		static worker& current_worker() noexcept {
+			static thread_local worker w{nullptr, 0};
+			return w;
+		}
+
+		bool pop(std::size_t i, unique_function<void()>& f) {
+			auto& q = *queues[i];
+			std::lock_guard<std::mutex> lock(q.m);
+			if(q.tasks.empty())
+				return false;
+
+			f = std::move(q.tasks.back());
+			q.tasks.pop_back();
+			return true;
+		}
+
+		bool steal(std::size_t i, unique_function<void()>& f) {
+			for(std::size_t j = 1; j < queues.size(); ++j) {
+				auto& q = *queues[(i + j) % queues.size()];
+				std::lock_guard<std::mutex> lock(q.m);
+				if(!q.tasks.empty()) {
+					f = std::move(q.tasks.front());
+					q.tasks.pop_front();
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void run(std::size_t i) {
+			current_worker() = worker{this, i};
+
+			while(true) {
+				unique_function<void()> f;
+				if(pop(i, f) || steal(i, f)) {
+					pending.fetch_sub(1, std::memory_order_seq_cst);
+
+					FTL_TRACE_SCOPE(executor, nullptr);
+					f();
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(m);
+				sleepers.fetch_add(1, std::memory_order_seq_cst);
+				cv.wait(lock, [this](){
+					return stopping
+						|| pending.load(std::memory_order_seq_cst) > 0;
+				});
+				sleepers.fetch_sub(1, std::memory_order_seq_cst);
+
+				if(stopping && pending.load(std::memory_order_seq_cst) == 0)
+					return;
+			}
+		}
+
+		/*
+		 * Wake a thread for a task just counted in pending.
+		 *
+		 * Threads about to sleep announce themselves in sleepers before
+		 * checking pending, so the mutex is only needed when some have.
+		 */
+		void wake() {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(sleepers.load(std::memory_order_seq_cst) > 0) {
+				std::lock_guard<std::mutex> lock(m);
+				cv.notify_one();
+			}
+		}
+
+		std::vector<std::unique_ptr<task_queue>> queues;
+		std::mutex m;
+		std::condition_variable cv;
+		std::atomic<std::size_t> pending{0};
+		std::atomic<int> sleepers{0};
+		bool stopping = false;
+		std::atomic<std::size_t> next{0};
+		std::vector<std::thread> threads;
+	};
+}
+
+#endif
+
@@ -0,0 +1,629 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_FLAT_MAP_H
+#define FTL_FLAT_MAP_H
+
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include "flat_set.h"
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+#include "maybe.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup flat_map Flat Map
+	 *
+	 * An associative container stored as a sorted vector, and its concept
+	 * instances.
+	 *
+	 * Adds the \ref foldablepg, \ref monoidpg, and \ref functorpg concept
+	 * instances, mapping and folding over the values of the map.
+	 *
+	 * \code
+	 *   #include <ftl/flat_map.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - <vector>
+	 * - <utility>
+	 * - <stdexcept>
+	 * - \ref flat_set
+	 * - \ref functor
+	 * - \ref foldable
+	 * - \ref maybe
+	 */
+
+	/**
+	 * An ordered map from unique keys to values, kept in one contiguous
+	 * buffer.
+	 *
+	 * Presents much the same interface as `std::map`, but the key/value
+	 * pairs are stored in a `std::vector` sorted by key. Lookups are binary
+	 * searches over contiguous memory, while single insertions and erasures
+	 * are linear. This makes `flat_map` a good fit for read-mostly lookup
+	 * tables.
+	 *
+	 * Elements are `std::pair<K,V>`, rather than `std::pair<const K,V>`.
+	 * The values may be modified through iterators, but the keys must not.
+	 * Any insertion or erasure invalidates all iterators.
+	 *
+	 * \par Concepts
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 *
+	 * \ingroup flat_map
+	 */
+	template<
+			typename K,
+			typename V,
+			typename Cmp = std::less<K>,
+			typename A = std::allocator<std::pair<K,V>>
+	>
+	class flat_map {
+	public:
+		/// Type of the underlying storage
+		using sequence_type = std::vector<std::pair<K,V>,A>;
+
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<K,V>;
+		using key_compare = Cmp;
+		using allocator_type = A;
+		using size_type = typename sequence_type::size_type;
+		using difference_type = typename sequence_type::difference_type;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+
+		using iterator = typename sequence_type::iterator;
+		using const_iterator = typename sequence_type::const_iterator;
+		using reverse_iterator = typename sequence_type::reverse_iterator;
+		using const_reverse_iterator =
+			typename sequence_type::const_reverse_iterator;
+
+		/// Orders elements by their keys
+		struct value_compare {
+			bool operator() (const value_type& a, const value_type& b) const {
+				return cmp(a.first, b.first);
+			}
+
+			bool operator() (const value_type& a, const K& k) const {
+				return cmp(a.first, k);
+			}
+
+			bool operator() (const K& k, const value_type& b) const {
+				return cmp(k, b.first);
+			}
+
+			Cmp cmp;
+		};
+
+		flat_map() = default;
+
+		explicit flat_map(const Cmp& cmp, const A& a = A())
+		: cmp{cmp}, seq(a) {}
+
+		/**
+		 * Constructs from an arbitrary, unsorted range.
+		 *
+		 * Should a key occur several times, the first occurrence is kept.
+		 */
+		template<typename It>
+		flat_map(It first, It last, const Cmp& cmp = Cmp(), const A& a = A())
+		: cmp{cmp}, seq(first, last, a) {
+			_dtl::sort_unique(seq, this->cmp);
+		}
+
+		/// \overload
+		flat_map(
+				std::initializer_list<value_type> l,
+				const Cmp& cmp = Cmp(), const A& a = A())
+		: flat_map(l.begin(), l.end(), cmp, a) {}
+
+		/// Sorts and removes duplicate keys from `v`, then adopts it
+		explicit flat_map(sequence_type v, const Cmp& cmp = Cmp())
+		: cmp{cmp}, seq(std::move(v)) {
+			_dtl::sort_unique(seq, this->cmp);
+		}
+
+		/**
+		 * Adopts `v` as storage, without any checks.
+		 *
+		 * \note `v` must already be sorted by key according to `cmp`, and
+		 *       every key must be unique.
+		 */
+		flat_map(ordered_unique_t, sequence_type v, const Cmp& cmp = Cmp())
+		: cmp{cmp}, seq(std::move(v)) {}
+
+		iterator begin() noexcept {
+			return seq.begin();
+		}
+
+		const_iterator begin() const noexcept {
+			return seq.begin();
+		}
+
+		iterator end() noexcept {
+			return seq.end();
+		}
+
+		const_iterator end() const noexcept {
+			return seq.end();
+		}
+
+		const_iterator cbegin() const noexcept {
+			return seq.cbegin();
+		}
+
+		const_iterator cend() const noexcept {
+			return seq.cend();
+		}
+
+		reverse_iterator rbegin() noexcept {
+			return seq.rbegin();
+		}
+
+		const_reverse_iterator rbegin() const noexcept {
+			return seq.rbegin();
+		}
+
+		reverse_iterator rend() noexcept {
+			return seq.rend();
+		}
+
+		const_reverse_iterator rend() const noexcept {
+			return seq.rend();
+		}
+
+		bool empty() const noexcept {
+			return seq.empty();
+		}
+
+		size_type size() const noexcept {
+			return seq.size();
+		}
+
+		size_type capacity() const noexcept {
+			return seq.capacity();
+		}
+
+		void reserve(size_type n) {
+			seq.reserve(n);
+		}
+
+		void clear() noexcept {
+			seq.clear();
+		}
+
+		/// The sorted vector the elements are kept in
+		const sequence_type& sequence() const noexcept {
+			return seq;
+		}
+
+		/// Move the underlying vector out, leaving the map empty
+		sequence_type extract() && {
+			return std::move(seq);
+		}
+
+		key_compare key_comp() const {
+			return cmp.cmp;
+		}
+
+		value_compare value_comp() const {
+			return cmp;
+		}
+
+		allocator_type get_allocator() const {
+			return seq.get_allocator();
+		}
+
+		iterator lower_bound(const K& k) {
+			return std::lower_bound(seq.begin(), seq.end(), k, cmp);
+		}
+
+		const_iterator lower_bound(const K& k) const {
+			return std::lower_bound(seq.begin(), seq.end(), k, cmp);
+		}
+
+		iterator upper_bound(const K& k) {
+			return std::upper_bound(seq.begin(), seq.end(), k, cmp);
+		}
+
+		const_iterator upper_bound(const K& k) const {
+			return std::upper_bound(seq.begin(), seq.end(), k, cmp);
+		}
+
+		iterator find(const K& k) {
+			auto it = lower_bound(k);
+			return it != end() && !cmp(k, *it) ? it : end();
+		}
+
+		const_iterator find(const K& k) const {
+			auto it = lower_bound(k);
+			return it != end() && !cmp(k, *it) ? it : end();
+		}
+
+		size_type count(const K& k) const {
+			return find(k) == end() ? 0 : 1;
+		}
+
+		/// Access the value of `k`, throwing `std::out_of_range` if missing
+		V& at(const K& k) {
+			auto it = find(k);
+			if(it == end())
+				throw std::out_of_range("ftl::flat_map::at");
+
+			return it->second;
+		}
+
+		/// \overload
+		const V& at(const K& k) const {
+			auto it = find(k);
+			if(it == end())
+				throw std::out_of_range("ftl::flat_map::at");
+
+			return it->second;
+		}
+
+		/// Access the value of `k`, default constructing it if missing
+		V& operator[] (const K& k) {
+			auto it = lower_bound(k);
+			if(it == end() || cmp(k, *it))
+				it = seq.emplace(it, k, V());
+
+			return it->second;
+		}
+
+		/// \overload
+		V& operator[] (K&& k) {
+			auto it = lower_bound(k);
+			if(it == end() || cmp(k, *it))
+				it = seq.emplace(it, std::move(k), V());
+
+			return it->second;
+		}
+
+		std::pair<iterator,bool> insert(const value_type& kv) {
+			return emplace_at(lower_bound(kv.first), kv);
+		}
+
+		std::pair<iterator,bool> insert(value_type&& kv) {
+			auto it = lower_bound(kv.first);
+			return emplace_at(it, std::move(kv));
+		}
+
+		/// Inserts a range of elements, merging them in linear time
+		template<typename It>
+		void insert(It first, It last) {
+			_dtl::insert_unique(seq, first, last, cmp);
+		}
+
+		/// \overload
+		void insert(std::initializer_list<value_type> l) {
+			insert(l.begin(), l.end());
+		}
+
+		template<typename...Args>
+		std::pair<iterator,bool> emplace(Args&&...args) {
+			value_type kv(std::forward<Args>(args)...);
+			auto it = lower_bound(kv.first);
+			return emplace_at(it, std::move(kv));
+		}
+
+		/**
+		 * Inserts an element, looking near `hint` first.
+		 *
+		 * Emplacing at `end()` keys that are greater than all those already
+		 * in the map is amortised constant time.
+		 */
+		template<typename...Args>
+		iterator emplace_hint(const_iterator hint, Args&&...args) {
+			value_type kv(std::forward<Args>(args)...);
+			if((hint == cbegin() || cmp(*(hint - 1), kv))
+					&& (hint == cend() || cmp(kv, *hint))) {
+				return seq.emplace(hint, std::move(kv));
+			}
+
+			auto it = lower_bound(kv.first);
+			return emplace_at(it, std::move(kv)).first;
+		}
+
+		iterator insert(const_iterator hint, const value_type& kv) {
+			return emplace_hint(hint, kv);
+		}
+
+		iterator insert(const_iterator hint, value_type&& kv) {
+			return emplace_hint(hint, std::move(kv));
+		}
+
+		iterator erase(const_iterator it) {
+			return seq.erase(it);
+		}
+
+		iterator erase(const_iterator first, const_iterator last) {
+			return seq.erase(first, last);
+		}
+
+		size_type erase(const K& k) {
+			auto it = find(k);
+			if(it == end())
+				return 0;
+
+			seq.erase(it);
+			return 1;
+		}
+
+		void swap(flat_map& m) {
+			using std::swap;
+			swap(cmp, m.cmp);
+			seq.swap(m.seq);
+		}
+
+		friend bool operator== (const flat_map& m1, const flat_map& m2) {
+			return m1.seq == m2.seq;
+		}
+
+		friend bool operator!= (const flat_map& m1, const flat_map& m2) {
+			return m1.seq != m2.seq;
+		}
+
+		friend bool operator< (const flat_map& m1, const flat_map& m2) {
+			return m1.seq < m2.seq;
+		}
+
+	private:
+		template<typename KV>
+		std::pair<iterator,bool> emplace_at(iterator it, KV&& kv) {
+			if(it != end() && !cmp(kv, *it))
+				return std::make_pair(it, false);
+
+			return std::make_pair(seq.emplace(it, std::forward<KV>(kv)), true);
+		}
+
+		value_compare cmp;
+		sequence_type seq;
+	};
+
+	template<typename K, typename V, typename Cmp, typename A>
+	struct parametric_type_traits<flat_map<K,V,Cmp,A>> {
+	private:
+		template<typename U>
+		using rebind_allocator
+			= typename std::allocator_traits<A>::template rebind_alloc<U>;
+
+	public:
+		using value_type = V;
+
+		template<typename W>
+		using rebind = flat_map<K,W,Cmp,rebind_allocator<std::pair<K,W>>>;
+	};
+
+	/**
+	 * Implementation of the \ref monoidpg concept.
+	 *
+	 * Behaviour:
+	 * \code
+	 *   id()         <=> flat_map{}
+	 *   append(a, b) <=> the union of a and b
+	 * \endcode
+	 *
+	 * The union is left biased; should a key be present in both maps, the
+	 * value in `a` is kept. It is computed by a single linear merge.
+	 *
+	 * \ingroup flat_map
+	 */
+	template<typename K, typename V, typename Cmp, typename A>
+	struct monoid<flat_map<K,V,Cmp,A>> {
+		using map = flat_map<K,V,Cmp,A>;
+
+		static map id()
+		noexcept(std::is_nothrow_default_constructible<map>::value) {
+			return map{};
+		}
+
+		static map append(const map& m1, const map& m2) {
+			return map(
+				ordered_unique,
+				_dtl::merge_unique(m1.sequence(), m2.sequence(), m1.value_comp()),
+				m1.key_comp()
+			);
+		}
+
+		static map append(map&& m1, const map& m2) {
+			auto cmp = m1.value_comp();
+			return map(
+				ordered_unique,
+				_dtl::merge_unique(std::move(m1).extract(), m2.sequence(), cmp),
+				cmp.cmp
+			);
+		}
+
+		static map append(const map& m1, map&& m2) {
+			auto cmp = m1.value_comp();
+			return map(
+				ordered_unique,
+				_dtl::merge_unique(m1.sequence(), std::move(m2).extract(), cmp),
+				cmp.cmp
+			);
+		}
+
+		static map append(map&& m1, map&& m2) {
+			auto cmp = m1.value_comp();
+			return map(
+				ordered_unique,
+				_dtl::merge_unique(
+					std::move(m1).extract(), std::move(m2).extract(), cmp
+				),
+				cmp.cmp
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Functor instance for `ftl::flat_map`.
+	 *
+	 * As only the values are mapped, the keys stay in order and the result
+	 * adopts them without any sorting.
+	 *
+	 * \ingroup flat_map
+	 */
+	template<typename K, typename T, typename C, typename A>
+	struct functor<flat_map<K,T,C,A>> {
+
+		/// Type alias for more easily read type signatures.
+		template<typename U>
+		using Map = Rebind<flat_map<K,T,C,A>,U>;
+
+		/// Maps the function `f` over all values in `m`.
+		template<typename F, typename U = result_of<F(T)>>
+		static Map<U> map(F&& f, const Map<T>& m) {
+			typename Map<U>::sequence_type v;
+			v.reserve(m.size());
+			for(const auto& kv : m) {
+				v.emplace_back(kv.first, f(kv.second));
+			}
+
+			return Map<U>(ordered_unique, std::move(v), m.key_comp());
+		}
+
+		/**
+		 * R-value overload.
+		 *
+		 * Moves keys and values from `m`.
+		 */
+		template<
+				typename F,
+				typename U = result_of<F(T)>,
+				typename = Requires<!std::is_same<T,U>::value>
+		>
+		static Map<U> map(F&& f, Map<T>&& m) {
+			auto cmp = m.key_comp();
+			auto src = std::move(m).extract();
+
+			typename Map<U>::sequence_type v;
+			v.reserve(src.size());
+			for(auto& kv : src) {
+				v.emplace_back(std::move(kv.first), f(std::move(kv.second)));
+			}
+
+			return Map<U>(ordered_unique, std::move(v), cmp);
+		}
+
+		/**
+		 * No-copy overload for endofunctions on temporary maps.
+		 *
+		 * \note Requires a \ref moveassignable `T`.
+		 */
+		template<
+				typename F,
+				typename = Requires<
+					std::is_same<T,result_of<F(T)>>::value
+				>
+		>
+		static Map<T> map(F&& f, Map<T>&& m) {
+			for(auto& kv : m) {
+				kv.second = f(std::move(kv.second));
+			}
+
+			return std::move(m);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Implementation of Foldable for `ftl::flat_map`.
+	 *
+	 * \ingroup flat_map
+	 */
+	template<typename K, typename T, typename C, typename A>
+	struct foldable<flat_map<K,T,C,A>>
+	: deriving_fold<flat_map<K,T,C,A>>, deriving_foldMap<flat_map<K,T,C,A>> {
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(U,T)>>::value
+				>
+		>
+		static U foldl(F&& f, U z, const flat_map<K,T,C,A>& m) {
+			for(auto& kv : m) {
+				z = f(std::move(z), kv.second);
+			}
+
+			return z;
+		}
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(T,U)>>::value
+				>
+		>
+		static U foldr(F&& f, U z, const flat_map<K,T,C,A>& m) {
+			for(auto it = m.rbegin(); it != m.rend(); ++it) {
+				z = f(it->second, std::move(z));
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Find the value associated with `k` in `m`, without copying it.
+	 *
+	 * \see lookup(const K&, std::map<K,T,C,A>&)
+	 *
+	 * \ingroup flat_map
+	 */
+	template<typename K, typename T, typename C, typename A>
+	maybe<T&> lookup(const K& k, flat_map<K,T,C,A>& m) {
+		auto it = m.find(k);
+		if(it == m.end())
+			return nothing<T&>();
+
+		return maybe<T&>{constructor<T&>(), it->second};
+	}
+
+	/// \overload
+	template<typename K, typename T, typename C, typename A>
+	maybe<const T&> lookup(const K& k, const flat_map<K,T,C,A>& m) {
+		auto it = m.find(k);
+		if(it == m.end())
+			return nothing<const T&>();
+
+		return maybe<const T&>{constructor<const T&>(), it->second};
+	}
+
+}
+
+#endif
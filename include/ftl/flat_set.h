@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_FLAT_SET_H
+#define FTL_FLAT_SET_H
+
+#include <vector>
+#include <functional>
+#include <initializer_list>
+#include "concepts/monad.h"
+#include "concepts/foldable.h"
+#include "implementation/sorted_vector.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup flat_set Flat Set
+	 *
+	 * A set stored as a sorted vector, and its concept instances.
+	 *
+	 * \code
+	 *   #include <ftl/flat_set.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to `ftl::flat_set`:
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 *
+	 * \par Dependencies
+	 * - <vector>
+	 * - <functional>
+	 * - <initializer_list>
+	 * - \ref monad
+	 * - \ref foldable
+	 */
+
+	/**
+	 * Tag type selecting the constructors of flat containers that adopt
+	 * already sorted, duplicate free data as is.
+	 *
+	 * \ingroup flat_set
+	 */
+	struct ordered_unique_t {};
+
+	/**
+	 * Value of `ordered_unique_t`.
+	 *
+	 * \ingroup flat_set
+	 */
+	constexpr ordered_unique_t ordered_unique{};
+
+	/**
+	 * An ordered set of unique elements, kept in one contiguous buffer.
+	 *
+	 * Presents much the same interface as `std::set`, but lookups binary
+	 * search a sorted `std::vector`, which is considerably more cache
+	 * friendly than walking a tree of nodes. The price is that inserting or
+	 * erasing single elements is linear, making `flat_set` best suited for
+	 * data that is mostly read after having been built in bulk.
+	 *
+	 * Any insertion or erasure invalidates all iterators.
+	 *
+	 * \par Concepts
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 *
+	 * \ingroup flat_set
+	 */
+	template<
+			typename T,
+			typename Cmp = std::less<T>,
+			typename A = std::allocator<T>
+	>
+	class flat_set {
+	public:
+		/// Type of the underlying storage
+		using sequence_type = std::vector<T,A>;
+
+		using key_type = T;
+		using value_type = T;
+		using key_compare = Cmp;
+		using value_compare = Cmp;
+		using allocator_type = A;
+		using size_type = typename sequence_type::size_type;
+		using difference_type = typename sequence_type::difference_type;
+		using reference = const T&;
+		using const_reference = const T&;
+
+		/// Elements of the set are never mutable
+		using iterator = typename sequence_type::const_iterator;
+		using const_iterator = iterator;
+		using reverse_iterator = typename sequence_type::const_reverse_iterator;
+		using const_reverse_iterator = reverse_iterator;
+
+		flat_set() = default;
+
+		explicit flat_set(const Cmp& cmp, const A& a = A())
+		: cmp(cmp), seq(a) {}
+
+		/// Constructs from an arbitrary, unsorted range
+		template<typename It>
+		flat_set(It first, It last, const Cmp& cmp = Cmp(), const A& a = A())
+		: cmp(cmp), seq(first, last, a) {
+			_dtl::sort_unique(seq, this->cmp);
+		}
+
+		/// \overload
+		flat_set(
+				std::initializer_list<T> l,
+				const Cmp& cmp = Cmp(), const A& a = A())
+		: flat_set(l.begin(), l.end(), cmp, a) {}
+
+		/// Sorts and removes duplicates from `v`, then adopts it as storage
+		explicit flat_set(sequence_type v, const Cmp& cmp = Cmp())
+		: cmp(cmp), seq(std::move(v)) {
+			_dtl::sort_unique(seq, this->cmp);
+		}
+
+		/**
+		 * Adopts `v` as storage, without any checks.
+		 *
+		 * \note `v` must already be sorted according to `cmp`, and be free of
+		 *       duplicates.
+		 */
+		flat_set(ordered_unique_t, sequence_type v, const Cmp& cmp = Cmp())
+		: cmp(cmp), seq(std::move(v)) {}
+
+		iterator begin() const noexcept {
+			return seq.cbegin();
+		}
+
+		iterator end() const noexcept {
+			return seq.cend();
+		}
+
+		iterator cbegin() const noexcept {
+			return seq.cbegin();
+		}
+
+		iterator cend() const noexcept {
+			return seq.cend();
+		}
+
+		reverse_iterator rbegin() const noexcept {
+			return seq.crbegin();
+		}
+
+		reverse_iterator rend() const noexcept {
+			return seq.crend();
+		}
+
+		bool empty() const noexcept {
+			return seq.empty();
+		}
+
+		size_type size() const noexcept {
+			return seq.size();
+		}
+
+		size_type capacity() const noexcept {
+			return seq.capacity();
+		}
+
+		void reserve(size_type n) {
+			seq.reserve(n);
+		}
+
+		void clear() noexcept {
+			seq.clear();
+		}
+
+		/// The sorted vector the elements are kept in
+		const sequence_type& sequence() const noexcept {
+			return seq;
+		}
+
+		/// Move the underlying vector out, leaving the set empty
+		sequence_type extract() && {
+			return std::move(seq);
+		}
+
+		key_compare key_comp() const {
+			return cmp;
+		}
+
+		value_compare value_comp() const {
+			return cmp;
+		}
+
+		allocator_type get_allocator() const {
+			return seq.get_allocator();
+		}
+
+		iterator lower_bound(const T& t) const {
+			return std::lower_bound(seq.begin(), seq.end(), t, cmp);
+		}
+
+		iterator upper_bound(const T& t) const {
+			return std::upper_bound(seq.begin(), seq.end(), t, cmp);
+		}
+
+		std::pair<iterator,iterator> equal_range(const T& t) const {
+			auto it = lower_bound(t);
+			if(it != end() && !cmp(t, *it))
+				return std::make_pair(it, it + 1);
+
+			return std::make_pair(it, it);
+		}
+
+		iterator find(const T& t) const {
+			auto it = lower_bound(t);
+			if(it != end() && !cmp(t, *it))
+				return it;
+
+			return end();
+		}
+
+		size_type count(const T& t) const {
+			return find(t) == end() ? 0 : 1;
+		}
+
+		std::pair<iterator,bool> insert(const T& t) {
+			return emplace_at(lower_bound(t), t);
+		}
+
+		std::pair<iterator,bool> insert(T&& t) {
+			auto it = lower_bound(t);
+			return emplace_at(it, std::move(t));
+		}
+
+		/// Inserts a range of elements, merging them in linear time
+		template<typename It>
+		void insert(It first, It last) {
+			_dtl::insert_unique(seq, first, last, cmp);
+		}
+
+		/// \overload
+		void insert(std::initializer_list<T> l) {
+			insert(l.begin(), l.end());
+		}
+
+		template<typename...Args>
+		std::pair<iterator,bool> emplace(Args&&...args) {
+			T t(std::forward<Args>(args)...);
+			auto it = lower_bound(t);
+			return emplace_at(it, std::move(t));
+		}
+
+		/**
+		 * Inserts an element, looking near `hint` first.
+		 *
+		 * Emplacing at `end()` elements that are greater than all those
+		 * already in the set is amortised constant time.
+		 */
+		template<typename...Args>
+		iterator emplace_hint(iterator hint, Args&&...args) {
+			T t(std::forward<Args>(args)...);
+			if((hint == begin() || cmp(*(hint - 1), t))
+					&& (hint == end() || cmp(t, *hint))) {
+				return seq.emplace(hint, std::move(t));
+			}
+
+			auto it = lower_bound(t);
+			return emplace_at(it, std::move(t)).first;
+		}
+
+		iterator insert(iterator hint, const T& t) {
+			return emplace_hint(hint, t);
+		}
+
+		iterator insert(iterator hint, T&& t) {
+			return emplace_hint(hint, std::move(t));
+		}
+
+		iterator erase(iterator it) {
+			return seq.erase(it);
+		}
+
+		iterator erase(iterator first, iterator last) {
+			return seq.erase(first, last);
+		}
+
+		size_type erase(const T& t) {
+			auto it = find(t);
+			if(it == end())
+				return 0;
+
+			seq.erase(it);
+			return 1;
+		}
+
+		void swap(flat_set& s) {
+			using std::swap;
+			swap(cmp, s.cmp);
+			seq.swap(s.seq);
+		}
+
+		friend bool operator== (const flat_set& s1, const flat_set& s2) {
+			return s1.seq == s2.seq;
+		}
+
+		friend bool operator!= (const flat_set& s1, const flat_set& s2) {
+			return s1.seq != s2.seq;
+		}
+
+		friend bool operator< (const flat_set& s1, const flat_set& s2) {
+			return s1.seq < s2.seq;
+		}
+
+	private:
+		template<typename U>
+		std::pair<iterator,bool> emplace_at(iterator it, U&& u) {
+			if(it != end() && !cmp(u, *it))
+				return std::make_pair(it, false);
+
+			return std::make_pair(seq.emplace(it, std::forward<U>(u)), true);
+		}
+
+		Cmp cmp;
+		sequence_type seq;
+	};
+
+	template<typename T, typename Cmp, typename A>
+	struct parametric_type_traits<flat_set<T,Cmp,A>> {
+	private:
+		template<typename U>
+		using rebind_allocator
+			= typename std::allocator_traits<A>::template rebind_alloc<U>;
+
+	public:
+		using value_type = T;
+
+		template<typename U>
+		using rebind = flat_set<U,Rebind<Cmp,U>,rebind_allocator<U>>;
+	};
+
+	/**
+	 * Implementation of the \ref monoidpg concept.
+	 *
+	 * Behaves just as the instance for `std::set`, except that `append` is a
+	 * single linear merge of the two sorted sequences.
+	 *
+	 * \ingroup flat_set
+	 */
+	template<typename T, typename Cmp, typename A>
+	struct monoid<flat_set<T,Cmp,A>> {
+		using set = flat_set<T,Cmp,A>;
+
+		static set id()
+		noexcept(std::is_nothrow_default_constructible<set>::value) {
+			return set{};
+		}
+
+		static set append(const set& s1, const set& s2) {
+			return set(
+				ordered_unique,
+				_dtl::merge_unique(s1.sequence(), s2.sequence(), s1.value_comp()),
+				s1.key_comp()
+			);
+		}
+
+		static set append(set&& s1, const set& s2) {
+			auto cmp = s1.key_comp();
+			return set(
+				ordered_unique,
+				_dtl::merge_unique(std::move(s1).extract(), s2.sequence(), cmp),
+				cmp
+			);
+		}
+
+		static set append(const set& s1, set&& s2) {
+			auto cmp = s1.key_comp();
+			return set(
+				ordered_unique,
+				_dtl::merge_unique(s1.sequence(), std::move(s2).extract(), cmp),
+				cmp
+			);
+		}
+
+		static set append(set&& s1, set&& s2) {
+			auto cmp = s1.key_comp();
+			return set(
+				ordered_unique,
+				_dtl::merge_unique(
+					std::move(s1).extract(), std::move(s2).extract(), cmp
+				),
+				cmp
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * \ref monadpg implementation for `ftl::flat_set`.
+	 *
+	 * Mapping collects all results in one vector and then sorts it, unless
+	 * the function preserved the order, in which case no sorting is done at
+	 * all. As with `std::set`, results that coincide are merged.
+	 *
+	 * \ingroup flat_set
+	 */
+	template<typename T, typename Cmp, typename A>
+	struct monad<flat_set<T,Cmp,A>>
+	: deriving_bind<flat_set<T,Cmp,A>>
+	, deriving_apply<in_terms_of_bind<flat_set<T,Cmp,A>>> {
+
+		/// Alias for cleaner type signatures
+		template<typename U>
+		using set = Rebind<flat_set<T,Cmp,A>,U>;
+
+		/// Embeds a single value in a set
+		static set<T> pure(const T& t) {
+			return set<T>{t};
+		}
+
+		/// \overload
+		static set<T> pure(T&& t) {
+			typename set<T>::sequence_type v;
+			v.push_back(std::move(t));
+			return set<T>(ordered_unique, std::move(v));
+		}
+
+		/**
+		 * Maps a function to every element of the set.
+		 *
+		 * \tparam F must satisfy \ref fn`<U(T)>`, for some type `U` that is
+		 *           strictly orderable by `Cmp<U>`.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		static set<U> map(F&& f, const set<T>& s) {
+			typename set<U>::sequence_type v;
+			v.reserve(s.size());
+			for(const auto& e : s) {
+				v.push_back(f(e));
+			}
+
+			return set<U>(std::move(v));
+		}
+
+		/// \overload
+		template<typename F, typename U = result_of<F(T)>>
+		static set<U> map(F&& f, set<T>&& s) {
+			auto src = std::move(s).extract();
+
+			typename set<U>::sequence_type v;
+			v.reserve(src.size());
+			for(auto& e : src) {
+				v.push_back(f(std::move(e)));
+			}
+
+			return set<U>(std::move(v));
+		}
+
+		/// Flattens a set of sets, sorting all elements together once
+		static set<T> join(const set<set<T>>& s) {
+			typename set<T>::sequence_type v;
+			for(const auto& ss : s) {
+				v.insert(v.end(), ss.begin(), ss.end());
+			}
+
+			return set<T>(std::move(v));
+		}
+
+		/// \overload
+		static set<T> join(set<set<T>>&& s) {
+			auto src = std::move(s).extract();
+
+			typename set<T>::sequence_type v;
+			for(auto& ss : src) {
+				auto e = std::move(ss).extract();
+				v.insert(
+					v.end(),
+					std::make_move_iterator(e.begin()),
+					std::make_move_iterator(e.end())
+				);
+			}
+
+			return set<T>(std::move(v));
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for `ftl::flat_set`.
+	 *
+	 * \ingroup flat_set
+	 */
+	template<typename T, typename Cmp, typename A>
+	struct foldable<flat_set<T,Cmp,A>>
+	: deriving_foldable<bidirectional_iterable<flat_set<T,Cmp,A>>> {};
+
+}
+
+#endif
@@ -68,9 +68,55 @@ namespace ftl {
 		using rebind = std::forward_list<U,rebind_allocator<U>>;
 	};
 
+	namespace _dtl {
+		// Moves the elements of c to after it, returning the last one
+		template<typename T, typename A, typename C>
+		typename std::forward_list<T,A>::iterator append_moved(
+				std::forward_list<T,A>& l,
+				typename std::forward_list<T,A>::iterator it,
+				C& c
+		) {
+			return l.insert_after(
+				it,
+				std::make_move_iterator(c.begin()),
+				std::make_move_iterator(c.end())
+			);
+		}
+
+		// Relinks the nodes of c instead, when they can be shared
+		template<typename T, typename A>
+		typename std::forward_list<T,A>::iterator append_moved(
+				std::forward_list<T,A>& l,
+				typename std::forward_list<T,A>::iterator it,
+				std::forward_list<T,A>& c
+		) {
+			if(c.empty())
+				return it;
+
+			if(l.get_allocator() != c.get_allocator()) {
+				return l.insert_after(
+					it,
+					std::make_move_iterator(c.begin()),
+					std::make_move_iterator(c.end())
+				);
+			}
+
+			// Iterators to spliced nodes remain valid, now referring into l
+			auto last = c.begin();
+			for(auto next = std::next(last); next != c.end(); ++next)
+				last = next;
+
+			l.splice_after(it, c);
+			return last;
+		}
+	}
+
 	/**
 	 * Maps and concatenates in one step.
 	 *
+	 * If `f` returns lists of the same type as the result, their nodes are
+	 * spliced into it rather than copied.
+	 *
 	 * \tparam F must satisfy \ref fn`<`\ref fwditerable`<U>(T)>`
 	 *
 	 * \ingroup fwdlist
@@ -87,15 +133,11 @@ namespace ftl {
 			const std::forward_list<T,A>& l) {
 
 		std::forward_list<U,Au> result;
-		auto nested = std::forward<F>(f) % l;
 
 		auto it = result.before_begin();
-		for(auto& el : nested) {
-			it = result.insert_after(
-					it,
-					std::make_move_iterator(el.begin()),
-					std::make_move_iterator(el.end())
-			);
+		for(const auto& e : l) {
+			auto c = f(e);
+			it = _dtl::append_moved(result, it, c);
 		}
 
 		return result;
@@ -117,17 +159,112 @@ namespace ftl {
 			F&& f,
 			std::forward_list<T,A>&& l) {
 
-		auto nested = std::forward<F>(f) % std::move(l);
-
 		std::forward_list<U,Au> result;
 
 		auto it = result.before_begin();
-		for(auto& el : nested) {
-			it = result.insert_after(
-					it,
-					std::make_move_iterator(el.begin()),
-					std::make_move_iterator(el.end())
-			);
+		for(auto& e : l) {
+			auto c = f(std::move(e));
+			it = _dtl::append_moved(result, it, c);
+		}
+
+		return result;
+	}
+
+	/**
+	 * The elements of `l` that satisfy `p`, in order.
+	 *
+	 * \tparam P must satisfy \ref fn`<bool(T)>`
+	 *
+	 * \ingroup fwdlist
+	 */
+	template<typename P, typename T, typename A>
+	std::forward_list<T,A> filter(P&& p, const std::forward_list<T,A>& l) {
+		std::forward_list<T,A> result(l.get_allocator());
+
+		auto it = result.before_begin();
+		for(auto& e : l) {
+			if(p(e))
+				it = result.insert_after(it, e);
+		}
+
+		return result;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Unlinks the elements of `l` that fail `p`, keeping the nodes of the
+	 * others. Nothing is allocated, or moved.
+	 *
+	 * \ingroup fwdlist
+	 */
+	template<typename P, typename T, typename A>
+	std::forward_list<T,A> filter(P&& p, std::forward_list<T,A>&& l) {
+		l.remove_if([&p](const T& t){ return !p(t); });
+		return std::move(l);
+	}
+
+	/**
+	 * Maps and keeps only the results that are present.
+	 *
+	 * Equivalent of `concatMap(f, l)` for an `f` returning ftl::maybe, but
+	 * the values are moved straight out of each result into the output.
+	 *
+	 * \tparam F must satisfy \ref fn`<maybe<U>(T)>`, or more generally,
+	 *           return any \ref fwditerable of at most one element.
+	 *
+	 * \ingroup fwdlist
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			typename U = Value_type<result_of<F(T)>>,
+			typename Au = Rebind<A,U>
+	>
+	std::forward_list<U,Au> mapMaybe(
+			F&& f,
+			const std::forward_list<T,A>& l) {
+
+		std::forward_list<U,Au> result{Au(l.get_allocator())};
+
+		auto it = result.before_begin();
+		for(auto& e : l) {
+			auto m = f(e);
+			for(auto& u : m) {
+				it = result.insert_after(it, std::move(u));
+			}
+		}
+
+		return result;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Elements are moved into `f`.
+	 *
+	 * \ingroup fwdlist
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			typename U = Value_type<result_of<F(T)>>,
+			typename Au = Rebind<A,U>
+	>
+	std::forward_list<U,Au> mapMaybe(
+			F&& f,
+			std::forward_list<T,A>&& l) {
+
+		std::forward_list<U,Au> result{Au(l.get_allocator())};
+
+		auto it = result.before_begin();
+		for(auto& e : l) {
+			auto m = f(std::move(e));
+			for(auto& u : m) {
+				it = result.insert_after(it, std::move(u));
+			}
 		}
 
 		return result;
@@ -203,8 +340,7 @@ namespace ftl {
 	template<typename T, typename A>
 	struct monad<std::forward_list<T,A>>
 	: deriving_pure<std::forward_list<T,A>>
-	, deriving_join<in_terms_of_bind<std::forward_list<T,A>>>
-	, deriving_apply<in_terms_of_bind<std::forward_list<T,A>>> {
+	, deriving_join<in_terms_of_bind<std::forward_list<T,A>>> {
 
 		/// Alias to make type signatures more easily read.
 		template<typename U>
@@ -272,7 +408,7 @@ namespace ftl {
 
 			auto rl = std::move(l);
 			for(auto& e : rl) {
-				e = f(e);
+				e = f(std::move(e));
 			}
 
 			return rl;
@@ -314,11 +450,45 @@ namespace ftl {
 			return concatMap(std::forward<F>(f), std::move(l));
 		}
 
+		/**
+		 * Applies every function in `fs` to every element of `l`.
+		 *
+		 * The results are linked in one after the other, rather than by way
+		 * of `bind` and a temporary list for each function.
+		 */
+		template<
+				typename Lf,
+				typename F = Value_type<plain_type<Lf>>,
+				typename U = result_of<F(T)>
+		>
+		static forward_list<U> apply(Lf&& fs, const forward_list<T>& l) {
+			forward_list<U> rl;
+			auto it = rl.before_begin();
+			for(auto& f : fs) {
+				for(auto& e : l) {
+					it = rl.insert_after(it, f(e));
+				}
+			}
+
+			return rl;
+		}
+
 		static constexpr bool instance = true;
 
 	};
 
 	namespace _dtl {
+		template<typename L>
+		struct insert_after_sink {
+			template<typename X>
+			void operator() (X&& x) {
+				it = l.insert_after(it, std::forward<X>(x));
+			}
+
+			L& l;
+			typename L::iterator it;
+		};
+
 		template<typename F, typename Z, typename It>
 		Z fwdfoldr(F&& f, Z&& z, It it, It end) {
 			if(it != end) {
@@ -368,8 +538,8 @@ namespace ftl {
 	 * \ref zippablepg implementation for `std::forward_list`.
 	 *
 	 * This particular instance allows a `forward_list` to be zipped with
-	 * any type that satisfies \ref fwditerable. Thus, one can zip a
-	 * `forward_list` with a `vector`, `list` or even `maybe`.
+	 * any number of values of types that satisfy \ref fwditerable. Thus, one
+	 * can zip a `forward_list` with a `vector`, `list` or even `maybe`.
 	 *
 	 * \ingroup fwdlist
 	 */
@@ -381,25 +551,21 @@ namespace ftl {
 
 		template<
 				typename F,
-				typename FwdIt,
-				typename U = Value_type<FwdIt>,
-				typename V = result_of<F(T,U)>,
-				typename = Requires<ForwardIterable<FwdIt>()>
+				typename...FwdIts,
+				typename V = result_of<F(T,Value_type<FwdIts>...)>,
+				typename = Requires<_dtl::forward_iterables<FwdIts...>::value>
 		>
 		static std::forward_list<V,A_<V>> zipWith(
-				F f, const std::forward_list<T,A>& l, const FwdIt& it
+				F f, const std::forward_list<T,A>& l, const FwdIts&...its
 		) {
 			std::forward_list<V,A_<V>> result;
 
-			auto insert_it = result.before_begin();
-			auto it1 = l.begin();
-			auto it2 = it.begin();
-			while(it1 != l.end() && it2 != std::end(it)) {
-				insert_it = result.insert_after(insert_it, f(*it1, *it2));
-
-				++it1;
-				++it2;
-			}
+			_dtl::zip_each(
+				_dtl::insert_after_sink<std::forward_list<V,A_<V>>>{
+					result, result.before_begin()
+				},
+				f, l, its...
+			);
 
 			return result;
 		}
@@ -48,6 +48,7 @@ namespace ftl {
 	 * - `<stdexcept>`
 	 * - `<functional>`
 	 * - \ref typelevel
+	 * - \ref pooled_allocator
 	 */
 
 	/**
@@ -55,6 +56,9 @@ namespace ftl {
 	 *
 	 * \tparam R Return value of the wrapped function or function object.
 	 * \tparam Ps Parameter pack of the wrapped function's `operator()`.
+	 * \tparam N Number of bytes of in-place storage. Function objects that
+	 *           fit (and are nothrow move constructible) are stored without
+	 *           any allocation. Defaults to the size of two `size_t`.
 	 *
 	 * The point of including this data type is that, unlike `std::function`,
 	 * it provides built-in support for curried calling.
@@ -90,13 +94,34 @@ namespace ftl {
 	 *          made. Every time you invoke `operator()` without filling the
 	 *          complete parameter list, you are creating copies.
 	 *
+	 * Function objects that do not fit are kept in blocks taken from the
+	 * thread caching \ref pooled_allocator "pool", unless constructed with
+	 * an allocator of their own. Callbacks capturing more than a couple of
+	 * words can be kept off the heap altogether by increasing `N`:
+	 * \code
+	 *   using callback = ftl::function<void(int), 48>;
+	 *
+	 *   auto f = [a,b,c,d](int x){ ... };
+	 *   static_assert(callback::stores_inline<decltype(f)>(), "");
+	 *   callback cb = f;
+	 * \endcode
+	 *
+	 * Functions of different storage sizes are distinct types, though one
+	 * can wrap the other like any function object. Concept instances are
+	 * provided for the default size.
+	 *
 	 * \ingroup function
 	 */
-	template<typename>
+	template<typename, std::size_t>
 	class function {};
 
-	template<typename R, typename...Ps>
-	class function<R(Ps...)> : private ::ftl::_dtl::curried<R,Ps...> {
+	template<typename R, typename...Ps, std::size_t N>
+	class function<R(Ps...),N> : private ::ftl::_dtl::curried<N,R,Ps...> {
+		static_assert(
+			N >= sizeof(void*),
+			"The in-place storage of ftl::function must fit at least a pointer"
+		);
+
 	public:
 		/**
 		 * Type sequence representation of the function's parameter list.
@@ -109,6 +134,20 @@ namespace ftl {
 		/// Type returned when calling the function object.
 		using result_type = R;
 
+		/**
+		 * Check whether a function object of type `F` will be stored in-place.
+		 *
+		 * Objects that do not fit are allocated on the heap instead. Intended
+		 * for `static_assert`s guarding callbacks that must never allocate.
+		 */
+		template<typename F>
+		static constexpr bool stores_inline() noexcept {
+			using functor_type = typename ::ftl::_dtl::functor_type<F>::type;
+			return ::ftl::_dtl::is_inplace_allocated<
+				functor_type, std::allocator<functor_type>, N
+			>::value;
+		}
+
 		/// Equivalent of function(std::nullptr_t)
 		function() noexcept {
 			initialise_empty();
@@ -122,7 +161,7 @@ namespace ftl {
 		function(const function& f) : call(f.call) {
 			f.manager_storage.manager(
 					&manager_storage,
-					const_cast<::ftl::_dtl::manager_storage_type*>(&f.manager_storage),
+					const_cast<::ftl::_dtl::manager_storage_type<N>*>(&f.manager_storage),
 					::ftl::_dtl::call_copy);
 		}
 
@@ -141,12 +180,13 @@ namespace ftl {
 		function(
 				F f,
 				typename std::enable_if<
-					::ftl::_dtl::is_valid_function_argument<F, R (Ps...)>::value,
+					::ftl::_dtl::is_valid_function_argument<F, R (Ps...), N>::value,
 					::ftl::_dtl::empty_struct>::type = ::ftl::_dtl::empty_struct()
 		)
 		noexcept(::ftl::_dtl::is_inplace_allocated<
 				F,
-				std::allocator<typename ::ftl::_dtl::functor_type<F>::type>>::value
+				std::allocator<typename ::ftl::_dtl::functor_type<F>::type>,
+				N>::value
 		)
 		{
 			if(::ftl::_dtl::is_null(f))
@@ -158,7 +198,7 @@ namespace ftl {
 					::ftl::_dtl::to_functor(
 						std::forward<F>(f)
 					),
-					std::allocator<functor_type>()
+					pooled_allocator<functor_type>()
 				);
 			}
 		}
@@ -179,6 +219,10 @@ namespace ftl {
 
 		/**
 		 * Construct from arbitrary function object using a custom allocator.
+		 *
+		 * Stateless allocators are used as is. A stateful allocator, such as
+		 * ftl::resource_allocator, is only used if the function object does
+		 * not fit in place; it is then kept alongside the object it allocated.
 		 */
 		template<typename Allocator, typename F>
 		function(
@@ -186,16 +230,25 @@ namespace ftl {
 				const Allocator& allocator,
 				F functor,
 				typename std::enable_if<
-					::ftl::_dtl::is_valid_function_argument<F, R (Ps...)>::value,
+					::ftl::_dtl::is_valid_function_argument<F, R (Ps...), N>::value,
 					::ftl::_dtl::empty_struct>::type = ::ftl::_dtl::empty_struct())
-		noexcept(::ftl::_dtl::is_inplace_allocated<F, Allocator>::value) {
+		noexcept(::ftl::_dtl::allocator_storage<
+			typename ::ftl::_dtl::functor_type<F>::type, Allocator, N
+		>::nothrow) {
+
+			using storage = ::ftl::_dtl::allocator_storage<
+				typename ::ftl::_dtl::functor_type<F>::type, Allocator, N
+			>;
 
 			if(::ftl::_dtl::is_null(functor))
 				initialise_empty();
 
 			else {
-				initialise(::ftl::_dtl::to_functor(
-					std::forward<F>(functor)), Allocator(allocator)
+				initialise(
+					storage::wrap(
+						::ftl::_dtl::to_functor(std::forward<F>(functor)), allocator
+					),
+					storage::allocator(allocator)
 				);
 			}
 		}
@@ -204,8 +257,10 @@ namespace ftl {
 		template<typename Allocator>
 		function(std::allocator_arg_t,
 				const Allocator& allocator,
-				const function& other
-		)
+				const function& other,
+				typename std::enable_if<
+					std::is_empty<Allocator>::value,
+					::ftl::_dtl::empty_struct>::type = ::ftl::_dtl::empty_struct())
 		: call(other.call) {
 
 			using alloc_traits = std::allocator_traits<Allocator>;
@@ -215,20 +270,20 @@ namespace ftl {
 			// first try to see if the allocator matches the target type
 			::ftl::_dtl::manager_type manager_for_allocator =
 				&::ftl::_dtl::function_manager<
-					typename alloc_traits::value_type, Allocator
+					typename alloc_traits::value_type, Allocator, N
 				>;
 
 			if(other.manager_storage.manager == manager_for_allocator) {
 
 				::ftl::_dtl::create_manager<
-					typename alloc_traits::value_type, Allocator
+					typename alloc_traits::value_type, Allocator, N
 				> (
 					manager_storage, Allocator(allocator)
 				);
 
 				manager_for_allocator(
 					&manager_storage,
-					const_cast<::ftl::_dtl::manager_storage_type*>(
+					const_cast<::ftl::_dtl::manager_storage_type<N>*>(
 						&other.manager_storage
 					),
 					::ftl::_dtl::call_copy_functor_only
@@ -239,17 +294,17 @@ namespace ftl {
 			// breaks the recursion of the last case. otherwise repeated copies
 			// would allocate more and more memory
 			else if(other.manager_storage.manager
-					== &::ftl::_dtl::function_manager<function, MyAllocator>
+					== &::ftl::_dtl::function_manager<function, MyAllocator, N>
 			) {
 
-				::ftl::_dtl::create_manager<function, MyAllocator>(
+				::ftl::_dtl::create_manager<function, MyAllocator, N>(
 					manager_storage,
 					MyAllocator(allocator)
 				);
 
-				::ftl::_dtl::function_manager<function, MyAllocator>(
+				::ftl::_dtl::function_manager<function, MyAllocator, N>(
 					&manager_storage,
-					const_cast<::ftl::_dtl::manager_storage_type*>(
+					const_cast<::ftl::_dtl::manager_storage_type<N>*>(
 						&other.manager_storage
 					),
 					::ftl::_dtl::call_copy_functor_only
@@ -263,6 +318,21 @@ namespace ftl {
 			}
 		}
 
+		/**
+		 * Copy construct using a stateful allocator.
+		 *
+		 * Copies `other` as is: any stateful allocator of its target is kept
+		 * with the target and reused by the copy.
+		 */
+		template<typename Allocator>
+		function(std::allocator_arg_t,
+				const Allocator&,
+				const function& other,
+				typename std::enable_if<
+					!std::is_empty<Allocator>::value,
+					::ftl::_dtl::empty_struct>::type = ::ftl::_dtl::empty_struct())
+		: function(other) {}
+
 		/// Move construct using a custom allocator
 		template<typename Allocator>
 		function(std::allocator_arg_t, const Allocator&, function&& other) noexcept {
@@ -284,7 +354,7 @@ namespace ftl {
 		}
 
 		// Inherit the curried function call operator(s)
-		using ::ftl::_dtl::curried<R,Ps...>::operator();
+		using ::ftl::_dtl::curried<N,R,Ps...>::operator();
 
 		/// Call the wrapped function object
 		R operator()(Ps...ps) const {
@@ -293,12 +363,12 @@ namespace ftl {
 
 		template<typename F, typename Allocator>
 		void assign(F&& f, const Allocator& alloc)
-		noexcept(::ftl::_dtl::is_inplace_allocated<F, Allocator>::value) {
+		noexcept(::ftl::_dtl::is_inplace_allocated<F, Allocator, N>::value) {
 			function(std::allocator_arg, alloc, f).swap(*this);
 		}
 
 		void swap(function& other) noexcept {
-			::ftl::_dtl::manager_storage_type temp_storage;
+			::ftl::_dtl::manager_storage_type<N> temp_storage;
 
 			other.manager_storage.manager(
 					&temp_storage,
@@ -320,24 +390,29 @@ namespace ftl {
 
 		/// Check if function is nullary
 		constexpr operator bool() const noexcept {
-			return call != &::ftl::_dtl::empty_call<R, Ps...>;
+			return call != &::ftl::_dtl::empty_call<N, R, Ps...>;
 		}
 
 	private:
-		::ftl::_dtl::manager_storage_type manager_storage;
-		R (*call)(const ::ftl::_dtl::functor_padding&, Ps...);
+		// Adopts the storage of functions moved into it
+		template<typename, std::size_t>
+		friend class unique_function;
+
+		::ftl::_dtl::manager_storage_type<N> manager_storage;
+		R (*call)(const ::ftl::_dtl::functor_padding<N>&, Ps...);
 
 		template<typename F, typename Allocator>
 		void initialise(F f, Allocator&& alloc) {
 
-			call = &::ftl::_dtl::function_manager_inplace_specialisation<F,Allocator>
-				::template call<R, Ps...>;
+			call = &::ftl::_dtl::function_manager_inplace_specialisation<
+				F,Allocator,N
+			>::template call<R, Ps...>;
 
-			::ftl::_dtl::create_manager<F,Allocator>(
+			::ftl::_dtl::create_manager<F,Allocator,N>(
 					manager_storage,
 					std::forward<Allocator>(alloc));
 
-			::ftl::_dtl::function_manager_inplace_specialisation<F, Allocator>
+			::ftl::_dtl::function_manager_inplace_specialisation<F,Allocator,N>
 				::store_functor(manager_storage, std::forward<F>(f));
 		}
 
@@ -347,28 +422,442 @@ namespace ftl {
 			using Allocator = std::allocator<empty_fn_type>;
 
 			static_assert(
-				::ftl::_dtl::is_inplace_allocated<empty_fn_type, Allocator>::value,
+				::ftl::_dtl::is_inplace_allocated<empty_fn_type, Allocator, N>::value,
 				"The empty function should benefit from small functor optimization");
 
-			::ftl::_dtl::create_manager<empty_fn_type,Allocator>(
+			::ftl::_dtl::create_manager<empty_fn_type,Allocator,N>(
 					manager_storage,
 					Allocator()
 			);
 
 			::ftl::_dtl
-				::function_manager_inplace_specialisation<empty_fn_type,Allocator>
+				::function_manager_inplace_specialisation<empty_fn_type,Allocator,N>
 					::store_functor(manager_storage, nullptr);
 
-			call = &::ftl::_dtl::empty_call<R, Ps...>;
+			call = &::ftl::_dtl::empty_call<N, R, Ps...>;
 		}
 	};
 
-	template<typename R, typename...Ps>
-	struct parametric_type_traits<function<R(Ps...)>> {
+	template<typename R, typename...Ps, std::size_t N>
+	struct parametric_type_traits<function<R(Ps...),N>> {
 		using value_type = R;
 
 		template<typename S>
-		using rebind = function<S(Ps...)>;
+		using rebind = function<S(Ps...),N>;
+	};
+
+	/**
+	 * Move-only counterpart of ftl::function.
+	 *
+	 * Behaves exactly like `ftl::function`, including the small object
+	 * optimisation, custom allocators, and curried calling, except that it
+	 * can neither be copied, nor does it require the function objects it
+	 * wraps to be copyable. This makes it possible to capture e.g. a
+	 * `std::unique_ptr` or a large buffer by move, without resorting to a
+	 * `std::shared_ptr`.
+	 *
+	 * An `ftl::function` of the same signature and storage size can be moved
+	 * into a `unique_function`, in which case its function object is simply
+	 * taken over, without allocating or wrapping it.
+	 *
+	 * As a `unique_function` cannot be copied, curried calling requires an
+	 * rvalue, and moves the original function into the partially applied
+	 * one:
+	 * \code
+	 *   auto p = std::unique_ptr<int>(new int(1));
+	 *   ftl::unique_function<int(int,int)> f =
+	 *       std::bind([](const std::unique_ptr<int>& p, int x, int y) {
+	 *           return *p + x + y;
+	 *       }, std::move(p), std::placeholders::_1, std::placeholders::_2);
+	 *
+	 *   auto g = std::move(f)(2);
+	 *   g(3); // 6
+	 * \endcode
+	 *
+	 * \par Concepts
+	 * - \ref movecons
+	 * - \ref moveassignable
+	 * - \ref fn`<R(Ps...)>`
+	 *
+	 * \see function
+	 *
+	 * \ingroup function
+	 */
+	template<typename, std::size_t>
+	class unique_function {};
+
+	template<typename R, typename...Ps, std::size_t N>
+	class unique_function<R(Ps...),N>
+	: private ::ftl::_dtl::unique_curried<N,R,Ps...> {
+		static_assert(
+			N >= sizeof(void*),
+			"The in-place storage of ftl::unique_function must fit at least a "
+			"pointer"
+		);
+
+	public:
+		/// \see function::parameter_types
+		using parameter_types = type_seq<Ps...>;
+
+		/// Type returned when calling the function object.
+		using result_type = R;
+
+		/// \see function::stores_inline
+		template<typename F>
+		static constexpr bool stores_inline() noexcept {
+			using functor_type = typename ::ftl::_dtl::functor_type<F>::type;
+			return ::ftl::_dtl::is_inplace_allocated<
+				functor_type, std::allocator<functor_type>, N
+			>::value;
+		}
+
+		unique_function() noexcept {
+			initialise_empty();
+		}
+
+		unique_function(std::nullptr_t) noexcept {
+			initialise_empty();
+		}
+
+		unique_function(const unique_function&) = delete;
+
+		unique_function(unique_function&& f) noexcept {
+			initialise_empty();
+			swap(f);
+		}
+
+		/// Take over the function object of `f`, leaving it empty
+		unique_function(function<R(Ps...),N>&& f) noexcept : call(f.call) {
+			f.manager_storage.manager(
+					&manager_storage,
+					&f.manager_storage,
+					::ftl::_dtl::call_move_and_destroy);
+
+			f.initialise_empty();
+		}
+
+		/// Copy the function object of `f`
+		unique_function(const function<R(Ps...),N>& f)
+		: unique_function(function<R(Ps...),N>(f)) {}
+
+		/**
+		 * Construct from arbitrary function object.
+		 *
+		 * \tparam F must have a function call operator matching the type the
+		 *           `ftl::unique_function` is declared as. It must be move
+		 *           constructible, but need not be copyable.
+		 */
+		template<typename F>
+		unique_function(
+				F f,
+				typename std::enable_if<
+					::ftl::_dtl::is_valid_function_argument<F, R (Ps...), N>::value
+					&& !std::is_same<F, function<R(Ps...),N>>::value,
+					::ftl::_dtl::empty_struct>::type = ::ftl::_dtl::empty_struct()
+		)
+		noexcept(::ftl::_dtl::is_inplace_allocated<
+				F,
+				std::allocator<typename ::ftl::_dtl::functor_type<F>::type>,
+				N>::value
+		)
+		{
+			if(::ftl::_dtl::is_null(f))
+				initialise_empty();
+
+			else {
+				using functor_type = typename ::ftl::_dtl::functor_type<F>::type;
+				initialise(
+					::ftl::_dtl::to_functor(std::move(f)),
+					pooled_allocator<functor_type>()
+				);
+			}
+		}
+
+		/// Default construct using a custom allocator
+		template<typename Allocator>
+		unique_function(std::allocator_arg_t, const Allocator&) noexcept {
+			initialise_empty();
+		}
+
+		/// Null construct using a custom allocator
+		template<typename Allocator>
+		unique_function(std::allocator_arg_t, const Allocator&, std::nullptr_t)
+		noexcept {
+			initialise_empty();
+		}
+
+		/**
+		 * Construct from arbitrary function object using a custom allocator.
+		 *
+		 * Stateless allocators are used as is. A stateful allocator, such as
+		 * ftl::resource_allocator, is only used if the function object does
+		 * not fit in place; it is then kept alongside the object it allocated.
+		 */
+		template<typename Allocator, typename F>
+		unique_function(
+				std::allocator_arg_t,
+				const Allocator& allocator,
+				F functor,
+				typename std::enable_if<
+					::ftl::_dtl::is_valid_function_argument<F, R (Ps...), N>::value,
+					::ftl::_dtl::empty_struct>::type = ::ftl::_dtl::empty_struct())
+		noexcept(::ftl::_dtl::allocator_storage<
+			typename ::ftl::_dtl::functor_type<F>::type, Allocator, N
+		>::nothrow) {
+
+			using storage = ::ftl::_dtl::allocator_storage<
+				typename ::ftl::_dtl::functor_type<F>::type, Allocator, N
+			>;
+
+			if(::ftl::_dtl::is_null(functor))
+				initialise_empty();
+
+			else {
+				initialise(
+					storage::wrap(
+						::ftl::_dtl::to_functor(std::move(functor)), allocator
+					),
+					storage::allocator(allocator)
+				);
+			}
+		}
+
+		/// Move construct using a custom allocator
+		template<typename Allocator>
+		unique_function(
+				std::allocator_arg_t, const Allocator&, unique_function&& other
+		) noexcept {
+			// ignore the allocator because there's no allocation
+			initialise_empty();
+			swap(other);
+		}
+
+		~unique_function() noexcept {
+			manager_storage.manager(
+					&manager_storage,
+					nullptr,
+					::ftl::_dtl::call_destroy);
+		}
+
+		unique_function& operator= (unique_function other) noexcept {
+			swap(other);
+			return *this;
+		}
+
+		// Inherit the curried function call operator(s)
+		using ::ftl::_dtl::unique_curried<N,R,Ps...>::operator();
+
+		/// Call the wrapped function object
+		R operator()(Ps...ps) const {
+			return call(manager_storage.functor, std::forward<Ps>(ps)...);
+		}
+
+		void swap(unique_function& other) noexcept {
+			::ftl::_dtl::manager_storage_type<N> temp_storage;
+
+			other.manager_storage.manager(
+					&temp_storage,
+					&other.manager_storage,
+					::ftl::_dtl::call_move_and_destroy);
+
+			manager_storage.manager(
+					&other.manager_storage,
+					&manager_storage,
+					::ftl::_dtl::call_move_and_destroy);
+
+			temp_storage.manager(
+					&manager_storage,
+					&temp_storage,
+					::ftl::_dtl::call_move_and_destroy);
+
+			std::swap(call, other.call);
+		}
+
+		/// Check if function is nullary
+		constexpr operator bool() const noexcept {
+			return call != &::ftl::_dtl::empty_call<N, R, Ps...>;
+		}
+
+	private:
+		::ftl::_dtl::manager_storage_type<N> manager_storage;
+		R (*call)(const ::ftl::_dtl::functor_padding<N>&, Ps...);
+
+		template<typename F, typename Allocator>
+		void initialise(F f, Allocator&& alloc) {
+
+			call = &::ftl::_dtl::function_manager_inplace_specialisation<
+				F,Allocator,N
+			>::template call<R, Ps...>;
+
+			::ftl::_dtl::create_manager<F,Allocator,N,false>(
+					manager_storage,
+					std::forward<Allocator>(alloc));
+
+			::ftl::_dtl::function_manager_inplace_specialisation<F,Allocator,N>
+				::store_functor(manager_storage, std::move(f));
+		}
+
+		using empty_fn_type = R(*)(Ps...);
+
+		void initialise_empty() noexcept {
+			using Allocator = std::allocator<empty_fn_type>;
+
+			::ftl::_dtl::create_manager<empty_fn_type,Allocator,N>(
+					manager_storage,
+					Allocator()
+			);
+
+			::ftl::_dtl
+				::function_manager_inplace_specialisation<empty_fn_type,Allocator,N>
+					::store_functor(manager_storage, nullptr);
+
+			call = &::ftl::_dtl::empty_call<N, R, Ps...>;
+		}
+	};
+
+	template<typename R, typename...Ps, std::size_t N>
+	struct parametric_type_traits<unique_function<R(Ps...),N>> {
+		using value_type = R;
+
+		template<typename S>
+		using rebind = unique_function<S(Ps...),N>;
+	};
+
+	namespace _dtl {
+		template<typename F, typename Sig>
+		struct is_valid_function_ref_argument {
+			static constexpr bool value = false;
+		};
+
+		template<typename F, typename R, typename...Ps>
+		struct is_valid_function_ref_argument<F, R (Ps...)> {
+
+			template<typename U>
+			static decltype(std::declval<U&>()(std::declval<Ps>()...))
+			check(U *);
+
+			template<typename>
+			static empty_struct check(...);
+
+			using result = decltype(check<F>(nullptr));
+
+			static constexpr bool value
+				= !std::is_same<result, empty_struct>::value
+				&& (std::is_void<R>::value
+					|| std::is_convertible<result, R>::value);
+		};
+	}
+
+	/**
+	 * Non-owning reference to a callable object.
+	 *
+	 * A `function_ref` is nothing but a pointer to some function object and
+	 * a pointer to a function that knows how to call it. Constructing and
+	 * copying one never allocates, nor does it invoke anything but trivial
+	 * copies, making it the cheaper alternative to `ftl::function` wherever
+	 * the callable is only invoked while the call that received it is still
+	 * running.
+	 *
+	 * This matters most to algorithms such as `std::sort`, which copy the
+	 * predicates they are given many times over. The `function_ref`
+	 * overloads of `ftl::asc`, `ftl::desc` and `ftl::equal` exist for that
+	 * reason: their predicates stay trivially copyable.
+	 *
+	 * \warning As the name implies, the referenced function object is not
+	 *          copied. Keeping a `function_ref` around after the object it
+	 *          refers to has been destroyed is undefined behaviour.
+	 *
+	 * Unlike `ftl::function`, curried calling is not supported, as partially
+	 * applying a parameter would require storage of its own.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref assignable
+	 * - \ref fn`<R(Ps...)>`
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   int apply_twice(ftl::function_ref<int(int)> f, int x) {
+	 *       return f(f(x));
+	 *   }
+	 *
+	 *   apply_twice([](int x){ return x*2; }, 3); // 12
+	 * \endcode
+	 *
+	 * \ingroup function
+	 */
+	template<typename>
+	class function_ref {};
+
+	template<typename R, typename...Ps>
+	class function_ref<R(Ps...)> {
+	public:
+		/// \see function::parameter_types
+		using parameter_types = type_seq<Ps...>;
+
+		/// Type returned when calling the referenced object.
+		using result_type = R;
+
+		/**
+		 * Refer to an arbitrary function object.
+		 *
+		 * \tparam F must have a function call operator matching `R(Ps...)`.
+		 */
+		template<
+				typename F,
+				typename = typename std::enable_if<
+					!std::is_same<plain_type<F>, function_ref>::value
+					&& !std::is_function<
+						typename std::remove_reference<F>::type
+					>::value
+					&& !std::is_pointer<plain_type<F>>::value
+					&& ::ftl::_dtl::is_valid_function_ref_argument<
+						typename std::remove_reference<F>::type, R (Ps...)
+					>::value
+				>::type
+		>
+		function_ref(F&& f) noexcept
+		: call(&call_object<typename std::remove_reference<F>::type>) {
+			target.object =
+				const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+		}
+
+		/**
+		 * Refer to a plain function.
+		 *
+		 * The pointer itself is stored, so there is no need for it to outlive
+		 * the `function_ref`.
+		 */
+		function_ref(R (*f)(Ps...)) noexcept
+		: call(&call_pointer) {
+			target.pointer = f;
+		}
+
+		/// Call the referenced function object
+		R operator()(Ps...ps) const {
+			return call(target, std::forward<Ps>(ps)...);
+		}
+
+	private:
+		union storage {
+			void* object;
+			R (*pointer)(Ps...);
+		};
+
+		template<typename F>
+		static R call_object(storage s, Ps...ps) {
+			return static_cast<R>(
+				(*static_cast<F*>(s.object))(std::forward<Ps>(ps)...)
+			);
+		}
+
+		static R call_pointer(storage s, Ps...ps) {
+			return s.pointer(std::forward<Ps>(ps)...);
+		}
+
+		storage target;
+		R (*call)(storage, Ps...);
 	};
 
 }
@@ -70,6 +70,33 @@ namespace ftl {
 	 * - \ref monad
 	 */
 
+	namespace _dtl {
+		// Function of any parameters, always returning r
+		template<typename R, typename...Ps>
+		struct fn_const {
+			R operator() (Ps...) const {
+				return r;
+			}
+
+			R r;
+		};
+
+		// f . g, calling f with the result of g
+		template<typename F, typename G>
+		using fn_compose = composed<F,G>;
+
+		// Monadic bind of functions: fn(f(ps...))(ps...)
+		template<typename F, typename Fn, typename S, typename...Ps>
+		struct fn_bind {
+			S operator() (Ps...ps) const {
+				return fn(f(ps...))(ps...);
+			}
+
+			F f;
+			Fn fn;
+		};
+	}
+
 	/**
 	 * Monad instance for `ftl::functions`.
 	 *
@@ -80,26 +107,29 @@ namespace ftl {
 	: deriving_join<in_terms_of_bind<function<R(P,Ps...)>>>
 	, deriving_apply<in_terms_of_bind<function<R(P,Ps...)>>> {
 
-		// TODO: C++14 - Create version that lambda captures a by move
 		/// Creates a function that returns `a`, regardless of its parameters.
 		static function<R(P,Ps...)> pure(R a) {
-			return [a](P,Ps...) { return a; };
+			return _dtl::fn_const<R,P,Ps...>{std::move(a)};
 		}
 
-
-		// TODO: C++14 - Create version that lambda captures f and fn by move
-		/// Equivalent of function composition
+		/**
+		 * Equivalent of function composition.
+		 *
+		 * Both `f` and `fn` are moved into the result, not copied. The result
+		 * is another type erased function however, so mapping `n` times makes
+		 * a call go through `n` indirections. See ftl::reader for composition
+		 * that is resolved at compile time.
+		 */
 		template<
 				typename F,
 				typename S = typename std::result_of<F(R)>::type
 		>
 		static function<S(P,Ps...)> map(F f, function<R(P,Ps...)> fn) {
-			return [f,fn] (P&& p, Ps&&...ps) {
-				return f(fn(std::forward<P>(p), std::forward<Ps>(ps)...));
+			return _dtl::fn_compose<F,function<R(P,Ps...)>>{
+				std::move(f), std::move(fn)
 			};
 		}
 
-		// TODO: C++14 - Create version that lambda captures f and fn by move
 		/**
 		 * Monadic bind for functions.
 		 *
@@ -131,8 +161,8 @@ namespace ftl {
 				typename S = typename std::result_of<Fs(P,Ps...)>::type
 		>
 		static function<S(P,Ps...)> bind(function<R(P,Ps...)> f, Fn fn) {
-			return [=](P p, Ps...ps) {
-				return fn(f(p, ps...))(p, ps...);
+			return _dtl::fn_bind<function<R(P,Ps...)>,Fn,S,P,Ps...>{
+				std::move(f), std::move(fn)
 			};
 		}
 
@@ -259,17 +289,13 @@ namespace ftl {
 	: deriving_join<in_terms_of_bind<std::function<R(P,Ps...)>>>
 	, deriving_apply<in_terms_of_bind<std::function<R(P,Ps...)>>> {
 		static std::function<R(P,Ps...)> pure(R r) {
-			return std::function<R(P,Ps...)> {
-				[r](P,Ps...) { return r; }
-			};
+			return _dtl::fn_const<R,P,Ps...>{std::move(r)};
 		}
 
 		template<typename F, typename S = typename std::result_of<F(R)>::type>
 		static std::function<S(P,Ps...)> map(F fn, std::function<R(P,Ps...)> f) {
-			return std::function<S(P,Ps...)>{
-				[fn, f](P&& p,Ps&&...ps) {
-					return fn(f(std::forward<P>(p), std::forward<Ps>(ps)...));
-				}
+			return _dtl::fn_compose<F,std::function<R(P,Ps...)>>{
+				std::move(fn), std::move(f)
 			};
 		}
 
@@ -279,14 +305,95 @@ namespace ftl {
 				typename S = typename std::result_of<Fs(P,Ps...)>::type
 		>
 		static std::function<S(P,Ps...)> bind(std::function<R(P,Ps...)> f, Fn fn) {
-			return [=](P p, Ps...ps) {
-				return fn(f(p, ps...))(p, ps...);
+			return _dtl::fn_bind<std::function<R(P,Ps...)>,Fn,S,P,Ps...>{
+				std::move(f), std::move(fn)
 			};
 		}
 
 		static constexpr bool instance = true;
 	};
 
+	/**
+	 * A function whose composition is resolved at compile time.
+	 *
+	 * Mapping over an ftl::function yields another ftl::function, which calls
+	 * the original through its type erased wrapper. Mapping over a `reader`
+	 * instead yields a `reader` of the concrete composition, so that any
+	 * number of maps are compiled into one call that can be inlined.
+	 *
+	 * A `reader` converts to ftl::function or `std::function` like any other
+	 * callable, which is where its type is erased, if ever.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto f = [](int x){ return x + 1; };
+	 *   auto g = ftl::make_reader([](int x){ return x * 2; });
+	 *   auto h = ftl::make_reader([](int x){ return x - 3; });
+	 *
+	 *   auto k = f % g % h;
+	 *   // k(5) == (5 - 3) * 2 + 1
+	 *
+	 *   ftl::function<int(int)> erased = k;
+	 * \endcode
+	 *
+	 * \tparam F must satisfy \ref fn
+	 *
+	 * \ingroup functional
+	 */
+	template<typename F>
+	class reader {
+	public:
+		explicit constexpr reader(F f) : f(std::move(f)) {}
+
+		template<typename...Ps>
+		auto operator() (Ps&&...ps) const
+		-> decltype(std::declval<const F&>()(std::forward<Ps>(ps)...)) {
+			return f(std::forward<Ps>(ps)...);
+		}
+
+	private:
+		friend struct functor<reader>;
+
+		F f;
+	};
+
+	/**
+	 * Wrap `f` in a ftl::reader of the appropriate type.
+	 *
+	 * \ingroup functional
+	 */
+	template<typename F>
+	constexpr reader<plain_type<F>> make_reader(F&& f) {
+		return reader<plain_type<F>>(std::forward<F>(f));
+	}
+
+	/**
+	 * Functor instance for ftl::reader.
+	 *
+	 * `map(f, r)` is the reader of `f . r`, where neither is type erased.
+	 *
+	 * \ingroup functional
+	 */
+	template<typename F>
+	struct functor<reader<F>> {
+		template<typename G, typename G_ = plain_type<G>>
+		static reader<_dtl::fn_compose<G_,F>> map(G&& g, const reader<F>& r) {
+			return reader<_dtl::fn_compose<G_,F>>(
+				_dtl::fn_compose<G_,F>{std::forward<G>(g), r.f}
+			);
+		}
+
+		template<typename G, typename G_ = plain_type<G>>
+		static reader<_dtl::fn_compose<G_,F>> map(G&& g, reader<F>&& r) {
+			return reader<_dtl::fn_compose<G_,F>>(
+				_dtl::fn_compose<G_,F>{std::forward<G>(g), std::move(r.f)}
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
 }
 
 #endif
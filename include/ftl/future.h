@@ -50,28 +50,6 @@ namespace ftl {
 	 * - \ref monoid
 	 */
 
-	// Because futures cannot be copied, only moved, we need to specialise
-	// apply to make applicative's apply/operator* work.
-
-	// TODO: When lambdas can capture by move, this won't be necessary
-	namespace _dtl {
-		template<typename A, typename B>
-		struct inner_ap {
-			using result_type = B;
-
-			explicit inner_ap(std::future<A>&& f) noexcept
-			: _f(std::move(f)) {}
-
-			std::future<B> operator() (function<B(A)> fn) {
-				return std::move(_f) >>= [fn](A&& a) {
-					return monad<std::future<B>>::pure(fn(std::forward<A>(a)));
-				};
-			}
-
-			std::future<A> _f;
-		};
-	}
-
 	/**
 	 * Monad instance for `std::future`.
 	 *
@@ -151,13 +129,24 @@ namespace ftl {
 		 * Neither `f` nor `m` is waited on until the _resulting future_
 		 * is waited on.
 		 *
+		 * Once it is, a single deferred call waits for `f` and `m`, without
+		 * the intermediate future an apply in terms of `bind` would introduce.
+		 *
 		 * As always with `apply`, if `f` supports curried calling, several
 		 * applies can be chained together, resulting in arbitrary arity
 		 * function applications.
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static std::future<U> apply(std::future<F>&& f, std::future<T>&& m) {
-			return std::move(f) >>= _dtl::inner_ap<T,U>(std::move(m));
+			return std::async(
+				std::launch::deferred,
+				[](std::future<F>&& f, std::future<T>&& m) {
+					auto fn = f.get();
+					return fn(m.get());
+				},
+				std::move(f),
+				std::move(m)
+			);
 		}
 
 
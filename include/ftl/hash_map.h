@@ -0,0 +1,990 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_HASH_MAP_H
+#define FTL_HASH_MAP_H
+
+#include <memory>
+#include <utility>
+#include <tuple>
+#include <stdexcept>
+#include <functional>
+#include <initializer_list>
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+#include "implementation/mix_hash.h"
+#include "instrument.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup hash_map Hash Map
+	 *
+	 * An open addressing hash map, and its concept instances.
+	 *
+	 * Adds the \ref functorpg, \ref foldablepg and \ref monoidpg concept
+	 * instances, all of which work on the values of the map.
+	 *
+	 * \code
+	 *   #include <ftl/hash_map.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - <memory>
+	 * - <utility>
+	 * - <tuple>
+	 * - <stdexcept>
+	 * - <functional>
+	 * - <initializer_list>
+	 * - \ref functor
+	 * - \ref foldable
+	 */
+
+	template<typename K, typename V, typename H, typename Eq, typename A>
+	class hash_map;
+
+	namespace _dtl {
+		/*
+		 * Every slot of a hash_map has a control byte, which is
+		 * - ctrl_empty, if the slot has never been used since the last rehash,
+		 * - ctrl_deleted, if its element was erased, or
+		 * - the 7 lowest bits of the hash of its key, if it holds an element.
+		 *
+		 * Slots are probed a group at a time, and a lookup only needs to
+		 * compare keys whose hash bits match. Probing stops at the first
+		 * group with an empty slot.
+		 */
+		using hash_ctrl = signed char;
+
+		constexpr hash_ctrl ctrl_empty = -128;
+		constexpr hash_ctrl ctrl_deleted = -2;
+
+		constexpr std::size_t hash_group = 16;
+
+		struct hash_map_access;
+	}
+
+	/**
+	 * Unordered associative container using open addressing.
+	 *
+	 * Elements are kept in a single array of slots, with a separate array of
+	 * one control byte per slot, in the style of Abseil's `flat_hash_map`
+	 * ("SwissTable"). Compared to `std::unordered_map`, there is no
+	 * allocation per element, and both lookups and iteration are a linear
+	 * scan of contiguous memory.
+	 *
+	 * The interface follows that of `std::unordered_map`, except that any
+	 * insertion may move elements, invalidating all references and
+	 * iterators. The table never grows beyond a load factor of 7/8.
+	 *
+	 * \par Concepts
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 * - \ref monoidpg, if `V` is a monoid
+	 *
+	 * \ingroup hash_map
+	 */
+	template<
+			typename K,
+			typename V,
+			typename H = std::hash<K>,
+			typename Eq = std::equal_to<K>,
+			typename A = std::allocator<std::pair<const K,V>>
+	>
+	class hash_map {
+		using ctrl_t = _dtl::hash_ctrl;
+		using slot_traits = typename std::allocator_traits<A>::template
+			rebind_traits<std::pair<const K,V>>;
+		using slot_alloc = typename slot_traits::allocator_type;
+		using ctrl_alloc = typename std::allocator_traits<A>::template
+			rebind_alloc<ctrl_t>;
+
+		static constexpr std::size_t G = _dtl::hash_group;
+
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<const K,V>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using hasher = H;
+		using key_equal = Eq;
+		using allocator_type = A;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+
+	private:
+		template<typename E>
+		class basic_iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename std::remove_const<E>::type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = E*;
+			using reference = E&;
+
+			basic_iterator() = default;
+
+			// Allows the conversion of iterators to const_iterators
+			template<
+					typename E2,
+					typename = Requires<std::is_convertible<E2*,E*>::value>
+			>
+			basic_iterator(const basic_iterator<E2>& it)
+			: c(it.c), e(it.e), s(it.s) {}
+
+			reference operator* () const {
+				return *s;
+			}
+
+			pointer operator-> () const {
+				return s;
+			}
+
+			basic_iterator& operator++ () {
+				++c; ++s;
+				skip();
+				return *this;
+			}
+
+			basic_iterator operator++ (int) {
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			bool operator== (const basic_iterator& it) const {
+				return c == it.c;
+			}
+
+			bool operator!= (const basic_iterator& it) const {
+				return c != it.c;
+			}
+
+		private:
+			friend class hash_map;
+			template<typename> friend class basic_iterator;
+
+			basic_iterator(const ctrl_t* c, const ctrl_t* e, E* s)
+			: c(c), e(e), s(s) {
+				skip();
+			}
+
+			void skip() {
+				while(c != e && *c < 0) {
+					++c; ++s;
+				}
+			}
+
+			const ctrl_t* c = nullptr;
+			const ctrl_t* e = nullptr;
+			E* s = nullptr;
+		};
+
+	public:
+		using iterator = basic_iterator<value_type>;
+		using const_iterator = basic_iterator<const value_type>;
+
+		hash_map() = default;
+
+		/// Constructs an empty map with room for at least `n` elements
+		explicit hash_map(
+				size_type n,
+				const H& h = H(), const Eq& eq = Eq(), const A& a = A())
+		: hash(h), eq(eq), salloc(a) {
+			reserve(n);
+		}
+
+		template<typename It>
+		hash_map(
+				It first, It last, size_type n = 0,
+				const H& h = H(), const Eq& eq = Eq(), const A& a = A())
+		: hash_map(n, h, eq, a) {
+			insert(first, last);
+		}
+
+		hash_map(
+				std::initializer_list<value_type> l, size_type n = 0,
+				const H& h = H(), const Eq& eq = Eq(), const A& a = A())
+		: hash_map(l.begin(), l.end(), n, h, eq, a) {}
+
+		/// Copies keep the exact layout of the original, without rehashing
+		hash_map(const hash_map& m)
+		: hash(m.hash), eq(m.eq)
+		, salloc(slot_traits::select_on_container_copy_construction(m.salloc)) {
+			copy_layout(m, [](const V& v) -> const V& { return v; });
+		}
+
+		hash_map(hash_map&& m) noexcept
+		: ctrl(m.ctrl), slots(m.slots), cap(m.cap), len(m.len), growth(m.growth)
+		, hash(std::move(m.hash)), eq(std::move(m.eq))
+		, salloc(std::move(m.salloc)) {
+			m.release();
+		}
+
+		~hash_map() {
+			destroy();
+		}
+
+		hash_map& operator= (hash_map m) noexcept {
+			swap(m);
+			return *this;
+		}
+
+		iterator begin() noexcept {
+			return iterator(ctrl, ctrl + cap, slots);
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator(ctrl, ctrl + cap, slots);
+		}
+
+		iterator end() noexcept {
+			return iterator(ctrl + cap, ctrl + cap, slots + cap);
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator(ctrl + cap, ctrl + cap, slots + cap);
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		bool empty() const noexcept {
+			return len == 0;
+		}
+
+		size_type size() const noexcept {
+			return len;
+		}
+
+		/// Number of slots in the table
+		size_type capacity() const noexcept {
+			return cap;
+		}
+
+		float load_factor() const noexcept {
+			return cap ? float(len) / float(cap) : 0.f;
+		}
+
+		hasher hash_function() const {
+			return hash;
+		}
+
+		key_equal key_eq() const {
+			return eq;
+		}
+
+		allocator_type get_allocator() const {
+			return salloc;
+		}
+
+		/// Makes room for at least `n` elements without further rehashing
+		void reserve(size_type n) {
+			size_type c = G;
+			while(max_load(c) < n) {
+				c *= 2;
+			}
+
+			if(c > cap)
+				rehash_to(c);
+		}
+
+		void clear() noexcept {
+			for(size_type i = 0; i < cap; ++i) {
+				if(ctrl[i] >= 0)
+					slot_traits::destroy(salloc, slots + i);
+
+				ctrl[i] = _dtl::ctrl_empty;
+			}
+
+			len = 0;
+			growth = max_load(cap);
+		}
+
+		iterator find(const K& k) {
+			return iterator_at(find_index(k, hash_of(k)));
+		}
+
+		const_iterator find(const K& k) const {
+			auto i = find_index(k, hash_of(k));
+			return const_iterator(ctrl + i, ctrl + cap, slots + i);
+		}
+
+		size_type count(const K& k) const {
+			return find_index(k, hash_of(k)) == cap ? 0 : 1;
+		}
+
+		V& at(const K& k) {
+			auto i = find_index(k, hash_of(k));
+			if(i == cap)
+				throw std::out_of_range("ftl::hash_map::at");
+
+			return slots[i].second;
+		}
+
+		const V& at(const K& k) const {
+			auto i = find_index(k, hash_of(k));
+			if(i == cap)
+				throw std::out_of_range("ftl::hash_map::at");
+
+			return slots[i].second;
+		}
+
+		V& operator[] (const K& k) {
+			return try_emplace(k).first->second;
+		}
+
+		V& operator[] (K&& k) {
+			return try_emplace(std::move(k)).first->second;
+		}
+
+		/// Constructs a value from `args` if, and only if, `k` is missing
+		template<typename...Args>
+		std::pair<iterator,bool> try_emplace(const K& k, Args&&...args) {
+			return emplace_key(k, std::forward<Args>(args)...);
+		}
+
+		/// \overload
+		template<typename...Args>
+		std::pair<iterator,bool> try_emplace(K&& k, Args&&...args) {
+			return emplace_key(std::move(k), std::forward<Args>(args)...);
+		}
+
+		template<typename...Args>
+		std::pair<iterator,bool> emplace(Args&&...args) {
+			std::pair<K,V> kv(std::forward<Args>(args)...);
+			return emplace_key(std::move(kv.first), std::move(kv.second));
+		}
+
+		std::pair<iterator,bool> insert(const value_type& kv) {
+			return emplace_key(kv.first, kv.second);
+		}
+
+		std::pair<iterator,bool> insert(value_type&& kv) {
+			return emplace_key(kv.first, std::move(kv.second));
+		}
+
+		template<typename It>
+		void insert(It first, It last) {
+			for(; first != last; ++first) {
+				insert(*first);
+			}
+		}
+
+		void insert(std::initializer_list<value_type> l) {
+			insert(l.begin(), l.end());
+		}
+
+		iterator erase(const_iterator it) {
+			auto i = size_type(it.c - ctrl);
+			erase_at(i);
+			return iterator(ctrl + i + 1, ctrl + cap, slots + i + 1);
+		}
+
+		size_type erase(const K& k) {
+			auto i = find_index(k, hash_of(k));
+			if(i == cap)
+				return 0;
+
+			erase_at(i);
+			return 1;
+		}
+
+		void swap(hash_map& m) noexcept {
+			using std::swap;
+			swap(ctrl, m.ctrl);
+			swap(slots, m.slots);
+			swap(cap, m.cap);
+			swap(len, m.len);
+			swap(growth, m.growth);
+			swap(hash, m.hash);
+			swap(eq, m.eq);
+			swap(salloc, m.salloc);
+		}
+
+		friend bool operator== (const hash_map& m1, const hash_map& m2) {
+			if(m1.size() != m2.size())
+				return false;
+
+			for(auto& kv : m1) {
+				auto it = m2.find(kv.first);
+				if(it == m2.end() || !(it->second == kv.second))
+					return false;
+			}
+
+			return true;
+		}
+
+		friend bool operator!= (const hash_map& m1, const hash_map& m2) {
+			return !(m1 == m2);
+		}
+
+	private:
+		friend struct _dtl::hash_map_access;
+
+		template<typename, typename, typename, typename, typename>
+		friend class hash_map;
+
+		static constexpr size_type max_load(size_type c) noexcept {
+			return c - c / 8;
+		}
+
+		size_type hash_of(const K& k) const {
+			return _dtl::mix_hash(hash(k));
+		}
+
+		static ctrl_t h2(size_type h) noexcept {
+			return ctrl_t(h & 0x7F);
+		}
+
+		iterator iterator_at(size_type i) noexcept {
+			return iterator(ctrl + i, ctrl + cap, slots + i);
+		}
+
+		// The groups are visited in triangular order, which reaches every
+		// one of them as long as their number is a power of two.
+		size_type find_index(const K& k, size_type h) const {
+			if(len == 0)
+				return cap;
+
+			auto mask = cap / G - 1;
+			auto g = (h >> 7) & mask;
+			auto tag = h2(h);
+
+			for(size_type step = 1; step <= cap / G; ++step) {
+				bool stop = false;
+				for(auto i = g * G; i < g * G + G; ++i) {
+					if(ctrl[i] == tag && eq(slots[i].first, k))
+						return i;
+
+					stop |= ctrl[i] == _dtl::ctrl_empty;
+				}
+
+				if(stop)
+					break;
+
+				g = (g + step) & mask;
+			}
+
+			return cap;
+		}
+
+		// First slot not holding an element, along the probe sequence of h
+		static size_type free_index(const ctrl_t* ctrl, size_type cap, size_type h) {
+			auto mask = cap / G - 1;
+			auto g = (h >> 7) & mask;
+
+			for(size_type step = 1; ; ++step) {
+				for(auto i = g * G; i < g * G + G; ++i) {
+					if(ctrl[i] < 0)
+						return i;
+				}
+
+				g = (g + step) & mask;
+			}
+		}
+
+		template<typename KK, typename...Args>
+		std::pair<iterator,bool> emplace_key(KK&& k, Args&&...args) {
+			auto h = hash_of(k);
+			auto i = find_index(k, h);
+			if(i != cap)
+				return std::make_pair(iterator_at(i), false);
+
+			if(growth == 0)
+				grow();
+
+			i = free_index(ctrl, cap, h);
+			slot_traits::construct(
+				salloc, slots + i,
+				std::piecewise_construct,
+				std::forward_as_tuple(std::forward<KK>(k)),
+				std::forward_as_tuple(std::forward<Args>(args)...)
+			);
+
+			if(ctrl[i] == _dtl::ctrl_empty)
+				--growth;
+
+			ctrl[i] = h2(h);
+			++len;
+
+			return std::make_pair(iterator_at(i), true);
+		}
+
+		void erase_at(size_type i) {
+			slot_traits::destroy(salloc, slots + i);
+			--len;
+
+			// Probes only ever stop at groups with an empty slot, so if this
+			// group has one, no probe can pass through it for this slot.
+			auto g = i - i % G;
+			for(auto j = g; j < g + G; ++j) {
+				if(ctrl[j] == _dtl::ctrl_empty) {
+					ctrl[i] = _dtl::ctrl_empty;
+					++growth;
+					return;
+				}
+			}
+
+			ctrl[i] = _dtl::ctrl_deleted;
+		}
+
+		// Doubles the table, unless it is mostly filled with tombstones
+		void grow() {
+			if(cap == 0)
+				rehash_to(G);
+			else if(len < max_load(cap) / 2)
+				rehash_to(cap);
+			else
+				rehash_to(cap * 2);
+		}
+
+		void allocate(size_type c) {
+			ctrl_alloc ca(salloc);
+			ctrl = std::allocator_traits<ctrl_alloc>::allocate(ca, c);
+			try {
+				slots = slot_traits::allocate(salloc, c);
+			}
+			catch(...) {
+				std::allocator_traits<ctrl_alloc>::deallocate(ca, ctrl, c);
+				ctrl = nullptr;
+				throw;
+			}
+
+			FTL_COUNT_ALLOCATION(hash_map, c * sizeof(ctrl_t));
+			FTL_COUNT_ALLOCATION(hash_map, c * sizeof(value_type));
+			cap = c;
+		}
+
+		void deallocate() noexcept {
+			if(!cap)
+				return;
+
+			ctrl_alloc ca(salloc);
+			std::allocator_traits<ctrl_alloc>::deallocate(ca, ctrl, cap);
+			slot_traits::deallocate(salloc, slots, cap);
+		}
+
+		void release() noexcept {
+			ctrl = nullptr;
+			slots = nullptr;
+			cap = len = growth = 0;
+		}
+
+		void destroy() noexcept {
+			for(size_type i = 0; i < cap; ++i) {
+				if(ctrl[i] >= 0)
+					slot_traits::destroy(salloc, slots + i);
+			}
+
+			deallocate();
+		}
+
+		void rehash_to(size_type c) {
+			hash_map m(hash, eq, salloc);
+			m.allocate(c);
+			std::fill(m.ctrl, m.ctrl + c, _dtl::ctrl_empty);
+			m.growth = max_load(c);
+
+			for(size_type i = 0; i < cap; ++i) {
+				if(ctrl[i] < 0)
+					continue;
+
+				auto h = hash_of(slots[i].first);
+				auto j = free_index(m.ctrl, c, h);
+				slot_traits::construct(
+					m.salloc, m.slots + j,
+					std::piecewise_construct,
+					std::forward_as_tuple(std::move_if_noexcept(
+						const_cast<K&>(slots[i].first)
+					)),
+					std::forward_as_tuple(std::move_if_noexcept(slots[i].second))
+				);
+				m.ctrl[j] = h2(h);
+				++m.len;
+				--m.growth;
+			}
+
+			swap(m);
+		}
+
+		/*
+		 * Fills this, empty, map with the elements of m, at the very same
+		 * positions, and with the values transformed by f. Slots are marked
+		 * as holding an element only once it is constructed, so should f
+		 * throw, the partial result can still be destroyed.
+		 */
+		template<typename M, typename F>
+		void copy_layout(M& m, F&& f) {
+			if(m.cap == 0)
+				return;
+
+			allocate(m.cap);
+			for(size_type i = 0; i < cap; ++i) {
+				ctrl[i] = m.ctrl[i] < 0 ? m.ctrl[i] : _dtl::ctrl_deleted;
+			}
+
+			growth = m.growth;
+			for(size_type i = 0; i < cap; ++i) {
+				if(m.ctrl[i] < 0)
+					continue;
+
+				slot_traits::construct(
+					salloc, slots + i, m.slots[i].first, f(m.slots[i].second)
+				);
+				ctrl[i] = m.ctrl[i];
+				++len;
+			}
+		}
+
+		/*
+		 * As copy_layout, but moves the elements of m, and takes over its
+		 * control bytes instead of copying them, if their allocators allow.
+		 */
+		template<typename M, typename F>
+		void take_layout(M& m, F&& f) {
+			if(!std::is_same<typename M::ctrl_alloc, ctrl_alloc>::value
+					|| !(ctrl_alloc(m.salloc) == ctrl_alloc(salloc))) {
+				copy_layout(m, [&f](typename M::mapped_type& v) {
+					return f(std::move(v));
+				});
+				return;
+			}
+
+			if(m.cap == 0)
+				return;
+
+			slots = slot_traits::allocate(salloc, m.cap);
+			FTL_COUNT_ALLOCATION(hash_map, m.cap * sizeof(value_type));
+			ctrl = m.ctrl;
+			cap = m.cap;
+			growth = m.growth;
+
+			size_type i = 0;
+			try {
+				for(; i < cap; ++i) {
+					auto tag = ctrl[i];
+					if(tag < 0)
+						continue;
+
+					ctrl[i] = _dtl::ctrl_deleted;
+					slot_traits::construct(
+						salloc, slots + i,
+						std::piecewise_construct,
+						std::forward_as_tuple(
+							std::move(const_cast<K&>(m.slots[i].first))
+						),
+						std::forward_as_tuple(f(std::move(m.slots[i].second)))
+					);
+					ctrl[i] = tag;
+					++len;
+
+					M::slot_traits::destroy(m.salloc, m.slots + i);
+				}
+			}
+			catch(...) {
+				// The rest of m's elements are only referred to by tags that
+				// now belong to this map
+				for(auto j = i; j < cap; ++j) {
+					if(j == i || ctrl[j] >= 0) {
+						M::slot_traits::destroy(m.salloc, m.slots + j);
+						ctrl[j] = _dtl::ctrl_deleted;
+					}
+				}
+
+				M::slot_traits::deallocate(m.salloc, m.slots, cap);
+				m.release();
+				throw;
+			}
+
+			M::slot_traits::deallocate(m.salloc, m.slots, cap);
+			m.release();
+		}
+
+		hash_map(const H& h, const Eq& eq, const slot_alloc& a)
+		: hash(h), eq(eq), salloc(a) {}
+
+		ctrl_t* ctrl = nullptr;
+		value_type* slots = nullptr;
+		size_type cap = 0;
+		size_type len = 0;
+		size_type growth = 0;
+
+		H hash;
+		Eq eq;
+		slot_alloc salloc;
+	};
+
+	namespace _dtl {
+		struct hash_map_access {
+			template<typename M, typename F, typename Src>
+			static M map(F& f, const Src& src) {
+				M m(
+					src.hash, src.eq,
+					typename M::slot_alloc(src.salloc)
+				);
+				m.copy_layout(src, f);
+
+				return m;
+			}
+
+			template<typename M, typename F, typename Src>
+			static M map_moved(F& f, Src& src) {
+				M m(
+					src.hash, src.eq,
+					typename M::slot_alloc(src.salloc)
+				);
+				m.take_layout(src, f);
+
+				return m;
+			}
+		};
+	}
+
+	template<typename K, typename V, typename H, typename Eq, typename A>
+	struct parametric_type_traits<hash_map<K,V,H,Eq,A>> {
+	private:
+		template<typename U>
+		using rebind_allocator
+			= typename std::allocator_traits<A>::template rebind_alloc<U>;
+
+	public:
+		using value_type = V;
+
+		template<typename W>
+		using rebind =
+			hash_map<K,W,H,Eq,rebind_allocator<std::pair<const K,W>>>;
+	};
+
+	/**
+	 * Functor instance for `ftl::hash_map`.
+	 *
+	 * As the keys do not change, the result is laid out exactly as the
+	 * original: control bytes are copied and every value is constructed in
+	 * the very slot its key had. Nothing is rehashed.
+	 *
+	 * \ingroup hash_map
+	 */
+	template<typename K, typename T, typename H, typename Eq, typename A>
+	struct functor<hash_map<K,T,H,Eq,A>> {
+
+		/// Type alias for more easily read type signatures.
+		template<typename U>
+		using Map = Rebind<hash_map<K,T,H,Eq,A>,U>;
+
+		/// Maps the function `f` over all values in `m`.
+		template<typename F, typename U = result_of<F(T)>>
+		static Map<U> map(F&& f, const Map<T>& m) {
+			return _dtl::hash_map_access::map<Map<U>>(f, m);
+		}
+
+		/**
+		 * R-value overload.
+		 *
+		 * Moves keys and values from `m`, and takes over its control bytes.
+		 */
+		template<
+				typename F,
+				typename U = result_of<F(T)>,
+				typename = Requires<!std::is_same<T,U>::value>
+		>
+		static Map<U> map(F&& f, Map<T>&& m) {
+			return _dtl::hash_map_access::map_moved<Map<U>>(f, m);
+		}
+
+		/**
+		 * No-copy overload for endofunctions on temporary maps.
+		 *
+		 * \note Requires a \ref moveassignable `T`.
+		 */
+		template<
+				typename F,
+				typename = Requires<
+					std::is_same<T,result_of<F(T)>>::value
+				>
+		>
+		static Map<T> map(F&& f, Map<T>&& m) {
+			for(auto& kv : m) {
+				kv.second = f(std::move(kv.second));
+			}
+
+			return std::move(m);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for `ftl::hash_map`.
+	 *
+	 * Folds visit the values in the order they are laid out in the table,
+	 * which depends on the hash function and on the history of the map.
+	 * Hence, `foldl` and `foldr` only give well defined results for folding
+	 * functions that do not depend on the order of the elements, and the
+	 * same goes for the monoid of `foldMap` and `fold`.
+	 *
+	 * \ingroup hash_map
+	 */
+	template<typename K, typename T, typename H, typename Eq, typename A>
+	struct foldable<hash_map<K,T,H,Eq,A>>
+	: deriving_fold<hash_map<K,T,H,Eq,A>>
+	, deriving_foldMap<hash_map<K,T,H,Eq,A>> {
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(U,T)>>::value
+				>
+		>
+		static U foldl(F&& f, U z, const hash_map<K,T,H,Eq,A>& m) {
+			for(auto& kv : m) {
+				z = f(std::move(z), kv.second);
+			}
+
+			return z;
+		}
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(T,U)>>::value
+				>
+		>
+		static U foldr(F&& f, U z, const hash_map<K,T,H,Eq,A>& m) {
+			for(auto& kv : m) {
+				z = f(kv.second, std::move(z));
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid instance for `ftl::hash_map`, given a monoid of values.
+	 *
+	 * Behaviour:
+	 * \code
+	 *   id()         <=> hash_map{}
+	 *   append(a, b) <=> the union of a and b
+	 * \endcode
+	 *
+	 * Where a key is in both maps, its values are combined with the monoid
+	 * operation of `V`, `a`'s value on the left. This is what Haskell calls
+	 * `unionWith mappend`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   using counts = ftl::hash_map<std::string,ftl::sum_monoid<int>>;
+	 *
+	 *   auto c = counts{{"a", ftl::sum(1)}} ^ counts{{"a", ftl::sum(2)}};
+	 *   // c.at("a") == 3
+	 * \endcode
+	 *
+	 * \ingroup hash_map
+	 */
+	template<typename K, typename V, typename H, typename Eq, typename A>
+	struct monoid<hash_map<K,V,H,Eq,A>> {
+	private:
+		using map = hash_map<K,V,H,Eq,A>;
+
+		template<typename M>
+		using element = typename std::conditional<
+			std::is_lvalue_reference<M>::value,
+			const V&,
+			V&&
+		>::type;
+
+		// Merges from into into, from being the right-hand side if Right
+		template<bool Right, typename M>
+		static void merge(map& into, M&& from) {
+			into.reserve(into.size() + from.size());
+			for(auto& kv : from) {
+				auto it = into.find(kv.first);
+				if(it == into.end()) {
+					into.try_emplace(
+						kv.first, static_cast<element<M>>(kv.second)
+					);
+				}
+				else if(Right) {
+					it->second = monoid<V>::append(
+						std::move(it->second),
+						static_cast<element<M>>(kv.second)
+					);
+				}
+				else {
+					it->second = monoid<V>::append(
+						static_cast<element<M>>(kv.second),
+						std::move(it->second)
+					);
+				}
+			}
+		}
+
+	public:
+		static map id() {
+			return map{};
+		}
+
+		static map append(const map& m1, const map& m2) {
+			map m(m1);
+			merge<true>(m, m2);
+			return m;
+		}
+
+		static map append(map&& m1, const map& m2) {
+			merge<true>(m1, m2);
+			return std::move(m1);
+		}
+
+		static map append(const map& m1, map&& m2) {
+			merge<false>(m2, m1);
+			return std::move(m2);
+		}
+
+		// Merges the smaller map into the larger
+		static map append(map&& m1, map&& m2) {
+			if(m1.size() < m2.size()) {
+				merge<false>(m2, std::move(m1));
+				return std::move(m2);
+			}
+
+			merge<true>(m1, std::move(m2));
+			return std::move(m1);
+		}
+
+		static constexpr bool instance = Monoid<V>();
+	};
+
+}
+
+#endif
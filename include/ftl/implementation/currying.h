@@ -23,53 +23,182 @@
 #ifndef FTL_IMPL_CURRYING_H
 #define FTL_IMPL_CURRYING_H
 
+#include <tuple>
 #include <type_traits>
 #include "../type_functions.h"
 #include "../type_traits.h"
 #include "tuple_apply.h"
 
+// Constexpr member functions are implicitly const in C++11
+#ifdef FTL_CPP14
+#define FTL_CONSTEXPR14 constexpr
+#else
+#define FTL_CONSTEXPR14
+#endif
+
 namespace ftl {
 	namespace _dtl {
+		// seq<0,...,N-1>, also for N == 0
+		template<size_t N>
+		using index_seq = make_index_seq<N>;
+
+		// Tags selecting the constructors of partial_application
+		struct bind_args_t {};
+		struct extend_args_t {};
+
+		/*
+		 * A function object with some of its leading arguments bound.
+		 *
+		 * Every argument is stored by value, exactly once. Binding further
+		 * arguments to a partial_application does not nest it in a new one,
+		 * but moves or copies its contents into a single, flat
+		 * partial_application, so that calling the end result is a single
+		 * call of `F` regardless of how many steps it was built in.
+		 */
+		template<typename F, typename...Args>
+		class partial_application {
+			F f;
+			std::tuple<Args...> args;
+
+			using indices = index_seq<sizeof...(Args)>;
+
+			template<size_t...I, typename...Qs>
+			constexpr auto call(seq<I...>, Qs&&...qs) const &
+			-> decltype(std::declval<const F&>()(
+				std::declval<const Args&>()..., std::declval<Qs>()...
+			)) {
+				return f(std::get<I>(args)..., std::forward<Qs>(qs)...);
+			}
+
+			template<size_t...I, typename...Qs>
+			FTL_CONSTEXPR14 auto call(seq<I...>, Qs&&...qs) &&
+			-> decltype(std::declval<F>()(
+				std::declval<Args>()..., std::declval<Qs>()...
+			)) {
+				return std::move(f)(
+					std::get<I>(std::move(args))..., std::forward<Qs>(qs)...
+				);
+			}
+
+		public:
+			template<typename G, typename...Qs>
+			constexpr partial_application(bind_args_t, G&& g, Qs&&...qs)
+			noexcept(std::is_nothrow_constructible<F,G&&>::value
+					&& std::is_nothrow_constructible<
+						std::tuple<Args...>, Qs&&...
+					>::value)
+			: f(std::forward<G>(g)), args(std::forward<Qs>(qs)...) {}
+
+			// Take f from g and the leading arguments from t
+			template<typename G, typename Tuple, size_t...I, typename...Qs>
+			constexpr partial_application(
+					extend_args_t, G&& g, Tuple&& t, seq<I...>, Qs&&...qs
+			)
+			: f(std::forward<G>(g))
+			, args(std::get<I>(std::forward<Tuple>(t))..., std::forward<Qs>(qs)...)
+			{}
+
+			template<typename...Qs>
+			constexpr auto operator() (Qs&&...qs) const &
+			-> decltype(std::declval<const F&>()(
+				std::declval<const Args&>()..., std::declval<Qs>()...
+			)) {
+				return call(indices{}, std::forward<Qs>(qs)...);
+			}
+
+			template<typename...Qs>
+			FTL_CONSTEXPR14 auto operator() (Qs&&...qs) &&
+			-> decltype(std::declval<F>()(
+				std::declval<Args>()..., std::declval<Qs>()...
+			)) {
+				return std::move(*this).call(indices{}, std::forward<Qs>(qs)...);
+			}
+
+			// Bind further arguments after the ones already bound
+			template<typename...Qs>
+			constexpr partial_application<F,Args...,plain_type<Qs>...>
+			extend(Qs&&...qs) const & {
+				return partial_application<F,Args...,plain_type<Qs>...>(
+					extend_args_t{}, f, args, indices{}, std::forward<Qs>(qs)...
+				);
+			}
+
+			template<typename...Qs>
+			partial_application<F,Args...,plain_type<Qs>...>
+			extend(Qs&&...qs) && {
+				return partial_application<F,Args...,plain_type<Qs>...>(
+					extend_args_t{},
+					std::move(f), std::move(args), indices{},
+					std::forward<Qs>(qs)...
+				);
+			}
+		};
+
+		template<typename>
+		struct is_partial_application : std::false_type {};
+
+		template<typename F, typename...Args>
+		struct is_partial_application<partial_application<F,Args...>>
+		: std::true_type {};
+
+		template<typename F>
+		constexpr F part( F&& f ) {
+			return std::forward<F>(f);
+		}
+
+		template<
+			typename F, typename Arg1, typename...Args,
+			typename = typename std::enable_if<
+				!is_partial_application<plain_type<F>>::value
+			>::type
+		>
+		constexpr partial_application<
+			plain_type<F>, plain_type<Arg1>, plain_type<Args>...
+		>
+		part(F&& f, Arg1&& arg1, Args&&...args) {
+			return partial_application<
+				plain_type<F>, plain_type<Arg1>, plain_type<Args>...
+			>(
+				bind_args_t{},
+				std::forward<F>(f),
+				std::forward<Arg1>(arg1), std::forward<Args>(args)...
+			);
+		}
+
+		// Partially applying a partial application flattens the two
+		template<
+			typename P, typename Arg1, typename...Args,
+			typename = typename std::enable_if<
+				is_partial_application<plain_type<P>>::value
+			>::type
+		>
+		constexpr auto part(P&& p, Arg1&& arg1, Args&&...args)
+		-> decltype(std::forward<P>(p).extend(
+			std::forward<Arg1>(arg1), std::forward<Args>(args)...
+		)) {
+			return std::forward<P>(p).extend(
+				std::forward<Arg1>(arg1), std::forward<Args>(args)...
+			);
+		}
+
 		// This struct is used to generate curried calling convention for
 		// arbitrary binary functions
 		template<typename F>
 		struct curried_binf {
-		private:
-			template<typename P>
-			struct curried {
-				curried(const F& f, const P& p) : f(f), p(p) {}
-				curried(const F& f, P&& p) : f(f), p(std::move(p)) {}
-				curried(F&& f, const P& p) : f(std::move(f)), p(p) {}
-				curried(F&& f, P&& p) : f(std::move(f)), p(std::move(p)) {}
-
-				F f;
-				P p;
-
-				template<typename T>
-				auto operator() (T&& t) const &
-				-> decltype(f(p, std::forward<T>(t))) {
-					return f(p, std::forward<T>(t));
-				}
-
-				template<typename T>
-				auto operator() (T&& t) &&
-				-> decltype(std::move(f)(std::move(p), std::forward<T>(t))) {
-					return std::move(f)(std::move(p), std::forward<T>(t));
-				}
-			};
-
-		public:
 			template<typename P>
-			curried<plain_type<P>> operator() (P&& p) const & {
-				return curried<plain_type<P>>(
+			constexpr partial_application<F,plain_type<P>>
+			operator() (P&& p) const & {
+				return partial_application<F,plain_type<P>>(
+						bind_args_t{},
 						*static_cast<const F*>(this),
 						std::forward<P>(p)
 				);
 			}
 
 			template<typename P>
-			curried<plain_type<P>> operator() (P&& p) && {
-				return curried<plain_type<P>>(
+			partial_application<F,plain_type<P>> operator() (P&& p) && {
+				return partial_application<F,plain_type<P>>(
+						bind_args_t{},
 						std::move(*static_cast<F*>(this)),
 						std::forward<P>(p)
 				);
@@ -77,338 +206,128 @@ namespace ftl {
 		};
 
 		// This struct is used to generate curried calling convention for
-		// arbitrary ternary functions
+		// arbitrary ternary functions. Applying one argument to the result of
+		// applying the first goes through F's own binary overload below,
+		// which keeps the result flat.
 		template<typename F>
 		struct curried_ternf {
-		private:
-			template<typename P1>
-			struct curried1 {
-			private:
-				template<typename P2>
-				struct curried {
-					curried(const F& f, const P1& p1, const P2& p2)
-					: f(f), p1(p1), p2(p2) {}
-
-					curried(const F& f, const P1& p1, P2&& p2)
-					: f(f), p1(p1), p2(std::move(p2)) {}
-
-					curried(const F& f, P1&& p1, const P2& p2)
-					: f(f), p1(std::move(p1)), p2(p2) {}
-
-					curried(F&& f, const P1& p1, const P2& p2)
-					: f(std::move(f)), p1(p1), p2(p2) {}
-
-					curried(const F& f, P1&& p1, P2&& p2)
-					: f(f), p1(std::move(p1)), p2(std::move(p2)) {}
-
-					curried(F&& f, const P1& p1, P2&& p2)
-					: f(std::move(f)), p1(p1), p2(std::move(p2)) {}
-
-					curried(F&& f, P1&& p1, const P2& p2)
-					: f(std::move(f)), p1(std::move(p1)), p2(p2) {}
-
-					curried(F&& f, P1&& p1, P2&& p2)
-					: f(std::move(f)), p1(std::move(p1)), p2(std::move(p2)) {}
-
-					F f;
-					P1 p1;
-					P2 p2;
-
-					template<typename P3>
-					auto operator() (P3&& p3) const &
-					-> decltype(f(p1, p2, std::forward<P3>(p3))) {
-						return f(p1, p2, std::forward<P3>(p3));
-					}
-
-					template<typename P3>
-					auto operator() (P3&& p3) &&
-					-> decltype(std::move(f)(
-								std::move(p1), std::move(p2), std::forward<P3>(p3)
-					)) {
-						return std::move(f)(
-								std::move(p1), std::move(p2), std::forward<P3>(p3)
-						);
-					}
-				};
-
-			public:
-				curried1(const F& f, const P1& p) : f(f), p(p) {}
-				curried1(const F& f, P1&& p) : f(f), p(std::move(p)) {}
-				curried1(F&& f, const P1& p) : f(std::move(f)), p(p) {}
-				curried1(F&& f, P1&& p) : f(std::move(f)), p(std::move(p)) {}
-
-				F f;
-				P1 p;
-
-				template<typename P2, typename P3>
-				auto operator() (P2&& p2, P3&& p3) const &
-				-> decltype(f(p, std::forward<P2>(p2), std::forward<P3>(p3))) {
-					return f(p, std::forward<P2>(p2), std::forward<P3>(p3));
-				}
-
-				template<typename P2, typename P3>
-				auto operator() (P2&& p2, P3&& p3) &&
-				-> decltype(std::move(f)(
-						std::move(p), std::forward<P2>(p2), std::forward<P3>(p3)
-				)) {
-					return std::move(f)(
-						std::move(p), std::forward<P2>(p2), std::forward<P3>(p3)
-					);
-				}
-
-				template<typename P2>
-				curried<plain_type<P2>> operator() (P2&& p2) const &  {
-					return curried<plain_type<P2>>(f, p, std::forward<P2>(p2));
-				}
-
-				template<typename P2>
-				curried<plain_type<P2>> operator() (P2&& p2) && {
-					return curried<plain_type<P2>>(
-							std::move(f), std::move(p), std::forward<P2>(p2)
-					);
-				}
-			};
-
-			template<typename P1, typename P2>
-			struct curried2 {
-				F f;
-				P1 p1;
-				P2 p2;
-
-				curried2(const F& f, const P1& p1, const P2& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(f), p1(p1), p2(p2) {}
-
-				curried2(const F& f, const P1& p1, P2&& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(f), p1(p1), p2(std::move(p2)) {}
-
-				curried2(const F& f, P1&& p1, const P2& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(f), p1(std::move(p1)), p2(p2) {}
-
-				curried2(F&& f, const P1& p1, const P2& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(std::move(f)), p1(p1), p2(p2) {}
-
-				curried2(const F& f, P1&& p1, P2&& p2)
-				noexcept(std::is_nothrow_copy_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(f), p1(std::move(p1)), p2(std::move(p2)) {}
-
-				curried2(F&& f, const P1& p1, P2&& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_copy_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(std::move(f)), p1(p1), p2(std::move(p2)) {}
-
-				curried2(F&& f, P1&& p1, const P2& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_copy_constructible<P2>::value)
-				: f(std::move(f)), p1(std::move(p1)), p2(p2) {}
-
-				curried2(F&& f, P1&& p1, P2&& p2)
-				noexcept(std::is_nothrow_move_constructible<F>::value
-						&& std::is_nothrow_move_constructible<P1>::value
-						&& std::is_nothrow_move_constructible<P2>::value)
-				: f(std::move(f)), p1(std::move(p1)), p2(std::move(p2)) {}
-
-				template<typename P3>
-				auto operator() (P3&& p3) const &
-				-> decltype(f(p1, p2, std::forward<P3>(p3))) {
-					return f(p1, p2, std::forward<P3>(p3));
-				}
-
-				template<typename P3>
-				auto operator() (P3&& p3) &&
-				-> decltype(std::move(f)(
-							std::move(p1), std::move(p2), std::forward<P3>(p3)
-				)) {
-					return std::move(f)(
-							std::move(p1), std::move(p2), std::forward<P3>(p3)
-					);
-				}
-			};
-
-		public:
 			template<typename P>
-			curried1<plain_type<P>> operator() (P&& p) const & {
-				return curried1<plain_type<P>>(
+			constexpr partial_application<F,plain_type<P>>
+			operator() (P&& p) const & {
+				return partial_application<F,plain_type<P>>(
+						bind_args_t{},
 						*static_cast<const F*>(this),
 						std::forward<P>(p)
 				);
 			}
 
 			template<typename P>
-			curried1<plain_type<P>> operator() (P&& p) && {
-				return curried1<plain_type<P>>(
+			partial_application<F,plain_type<P>> operator() (P&& p) && {
+				return partial_application<F,plain_type<P>>(
+						bind_args_t{},
 						std::move(*static_cast<F*>(this)),
 						std::forward<P>(p)
 				);
 			}
 
 			template<typename P1, typename P2>
-			curried2<plain_type<P1>,plain_type<P2>>
+			constexpr partial_application<F,plain_type<P1>,plain_type<P2>>
 			operator() (P1&& p1, P2&& p2) const & {
-				return curried2<plain_type<P1>,plain_type<P2>>(
+				return partial_application<F,plain_type<P1>,plain_type<P2>>(
+					bind_args_t{},
 					*static_cast<const F*>(this),
 					std::forward<P1>(p1), std::forward<P2>(p2)
 				);
 			}
 
 			template<typename P1, typename P2>
-			curried2<plain_type<P1>,plain_type<P2>>
+			partial_application<F,plain_type<P1>,plain_type<P2>>
 			operator() (P1&& p1, P2&& p2) && {
-				return curried2<plain_type<P1>,plain_type<P2>>(
+				return partial_application<F,plain_type<P1>,plain_type<P2>>(
+					bind_args_t{},
 					std::move(*static_cast<F*>(this)),
 					std::forward<P1>(p1), std::forward<P2>(p2)
 				);
 			}
 		};
 
+		// Accumulates arguments until F can be called with them
 		template<typename F, typename...Args1>
 		class curried_fn {
-			F f;
-			std::tuple<Args1...> args1;
+			partial_application<F,Args1...> p;
 
 		public:
-			curried_fn(const F& f, const std::tuple<Args1...>& args)
-			: f(f), args1(args) {}
-
-			curried_fn(F&& f, const std::tuple<Args1...>& args)
-			: f(std::move(f)), args1(args) {}
+			explicit curried_fn(const F& f)
+			noexcept(std::is_nothrow_copy_constructible<F>::value)
+			: p(bind_args_t{}, f) {}
 
-			curried_fn(const F& f, std::tuple<Args1...>&& args)
-			: f(f), args1(std::move(args)) {}
+			explicit curried_fn(F&& f)
+			noexcept(std::is_nothrow_move_constructible<F>::value)
+			: p(bind_args_t{}, std::move(f)) {}
 
-			curried_fn(F&& f, std::tuple<Args1...>&& args)
-			: f(std::move(f)), args1(std::move(args)) {}
+			explicit curried_fn(partial_application<F,Args1...>&& p)
+			noexcept(std::is_nothrow_move_constructible<
+				partial_application<F,Args1...>
+			>::value)
+			: p(std::move(p)) {}
 
 			template<
 					typename...Args2,
 					typename = typename std::enable_if<
-						is_callable<F,Args1...,Args2...>::value
+						is_callable<
+							const partial_application<F,Args1...>&, Args2...
+						>::value
 					>::type
 			>
-			auto operator() (Args2&&...args2) const
-			-> typename std::result_of<F(Args1...,Args2...)>::type {
-				return tup_apply(
-					f,
-					std::tuple_cat(
-						args1,
-						std::forward_as_tuple(std::forward<Args2>(args2)...)
-					)
-				);
+			constexpr auto operator() (Args2&&...args2) const &
+			-> decltype(p(std::forward<Args2>(args2)...)) {
+				return p(std::forward<Args2>(args2)...);
 			}
 
 			template<
 					typename...Args2,
 					typename = typename std::enable_if<
-						!is_callable<F,Args1...,Args2...>::value
+						is_callable<
+							partial_application<F,Args1...>, Args2...
+						>::value
 					>::type
 			>
-			auto operator() (Args2&&...args2) const
-			-> curried_fn<F,Args1...,Args2...> {
-				return curried_fn<F,Args1...,Args2...>{
-					f,
-					std::tuple_cat(
-						args1,
-						std::make_tuple(std::forward<Args2>(args2)...)
-					)
-				};
+			auto operator() (Args2&&...args2) &&
+			-> decltype(std::move(p)(std::forward<Args2>(args2)...)) {
+				return std::move(p)(std::forward<Args2>(args2)...);
 			}
 
-		};
-
-		template<typename F>
-		class curried_fn<F> {
-			F f;
-
-		public:
-			explicit curried_fn(const F& f)
-			noexcept(std::is_nothrow_copy_constructible<F>::value)
-			: f(f) {}
-
-			explicit curried_fn(F&& f)
-			noexcept(std::is_nothrow_move_constructible<F>::value)
-			: f(std::move(f)) {}
-
 			template<
-					typename...Args,
+					typename...Args2,
 					typename = typename std::enable_if<
-						is_callable<F,Args...>::value
+						!is_callable<
+							const partial_application<F,Args1...>&, Args2...
+						>::value
 					>::type
 			>
-			auto operator() (Args&&...args) const
-			-> decltype(f(std::forward<Args>(args)...)) {
-				return f(std::forward<Args>(args)...);
+			constexpr curried_fn<F,Args1...,plain_type<Args2>...>
+			operator() (Args2&&...args2) const & {
+				return curried_fn<F,Args1...,plain_type<Args2>...>(
+					p.extend(std::forward<Args2>(args2)...)
+				);
 			}
 
 			template<
-					typename...Args,
+					typename...Args2,
 					typename = typename std::enable_if<
-						!is_callable<F,Args...>::value
+						!is_callable<
+							partial_application<F,Args1...>, Args2...
+						>::value
 					>::type
 			>
-			auto operator() (Args&&...args) const
-			-> curried_fn<F,plain_type<Args>...> {
-				return curried_fn<F,plain_type<Args>...>(
-					f,
-					std::make_tuple(std::forward<Args>(args)...)
+			curried_fn<F,Args1...,plain_type<Args2>...>
+			operator() (Args2&&...args2) && {
+				return curried_fn<F,Args1...,plain_type<Args2>...>(
+					std::move(p).extend(std::forward<Args2>(args2)...)
 				);
 			}
 		};
 
-		template<typename F, typename Arg>
-		class partial_application {
-			F f;
-			Arg arg;
-
-		public:
-			constexpr partial_application(F f, Arg arg) 
-				: f(std::move(f)), arg(std::move(arg)) 
-			{ }
-
-			template<typename...Args>
-			constexpr auto operator()(Args&&...args) const &
-			-> result_of<F(Arg,Args...)> {
-				return f(arg, std::forward<Args>(args)...);
-			}
-
-			template<typename...Args>
-			auto operator()(Args&&...args) &&
-			-> result_of<F(Arg,Args...)> {
-				return std::move(f)(arg, std::forward<Args>(args)...);
-			}
-		};
-
-		template<typename F>
-		constexpr F part( F&& f ) {
-			return std::forward<F>(f);
-		}
-
-		template<
-			typename F, typename Arg1, typename...Args,
-			typename PartOne = partial_application<F,Arg1>
-		>
-		constexpr auto part(F f, Arg1 arg1, Args...args) 
-		-> decltype( part(std::declval<PartOne>(), std::declval<Args>()...) ) {
-			return part(
-				PartOne(std::move(f), std::move(arg1)),
-				std::move(args)...
-			);
-		}
-
 		template<size_t N, typename F>
 		class curried_fn_n {
 			F f;
@@ -438,10 +357,10 @@ namespace ftl {
 			template<typename...Args>
 			using applied_type = curried_fn_n<
 				left_over<Args...>::value,
-				decltype(part(f,std::declval<Args>()...))
+				decltype(part(std::declval<F>(),std::declval<Args>()...))
 			>;
 		public:
-			constexpr curried_fn_n(F f) : f(f) { }
+			constexpr curried_fn_n(F f) : f(std::move(f)) { }
 			
 			// Call f.
 			template<typename...Args, typename = EnableCall<Args...>>
@@ -450,23 +369,22 @@ namespace ftl {
 			}
 
 			template<typename...Args, typename = EnableCall<Args...>>
-			result_of<F(Args...)>  operator()(Args&&...args) && {
+			FTL_CONSTEXPR14 result_of<F(Args...)> operator()(Args&&...args) && {
 				return std::move(f)(std::forward<Args>(args)...);
 			}
 
-            // Curry f.
+			// Curry f.
 			template<typename...Args, typename = EnableCurry<Args...>>
 			constexpr applied_type<Args...> operator()(Args&&...args) const & {
 				return part(f,std::forward<Args>(args)...);
 			}
 
 			template<typename...Args, typename = EnableCurry<Args...>>
-			applied_type<Args...> operator()(Args&&...args) && {
-				return part(f,std::forward<Args>(args)...);
+			FTL_CONSTEXPR14 applied_type<Args...> operator()(Args&&...args) && {
+				return part(std::move(f),std::forward<Args>(args)...);
 			}
 		};
 	}
 }
 #endif
 
-
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_FOLD_KERNELS_H
+#define FTL_FOLD_KERNELS_H
+
+#include <cstddef>
+#include <type_traits>
+#include "../concepts/monoid.h"
+
+namespace ftl {
+	namespace _dtl {
+		/*
+		 * Specialised loops for folding contiguous storage into arithmetic
+		 * sums and products.
+		 *
+		 * Rather than appending wrapped values one at a time, the kernels
+		 * keep several independent accumulators of the underlying number
+		 * type. This breaks the dependency chain between iterations, which
+		 * is what allows compilers to vectorise the loop (SSE/AVX/NEON,
+		 * depending on the target) once fn is inlined.
+		 *
+		 * As a consequence, floating point results may differ from a
+		 * strictly sequential fold in the last few bits, just as they may
+		 * for any other reassociation permitted by the monoid laws.
+		 */
+		template<typename M>
+		struct fold_kernel {
+			static constexpr bool instance = false;
+		};
+
+		constexpr std::size_t fold_kernel_lanes = 4;
+
+		template<typename N>
+		struct fold_kernel<sum_monoid<N>> {
+			static constexpr bool instance = std::is_arithmetic<N>::value;
+
+			template<typename Fn, typename T>
+			static sum_monoid<N> run(Fn& fn, const T* xs, std::size_t n) {
+				N acc[fold_kernel_lanes] = {N(0), N(0), N(0), N(0)};
+
+				std::size_t i = 0;
+				for(; i + fold_kernel_lanes <= n; i += fold_kernel_lanes) {
+					acc[0] += fn(xs[i]).n;
+					acc[1] += fn(xs[i+1]).n;
+					acc[2] += fn(xs[i+2]).n;
+					acc[3] += fn(xs[i+3]).n;
+				}
+
+				for(; i < n; ++i) {
+					acc[0] += fn(xs[i]).n;
+				}
+
+				return sum_monoid<N>((acc[0] + acc[1]) + (acc[2] + acc[3]));
+			}
+		};
+
+		template<typename N>
+		struct fold_kernel<prod_monoid<N>> {
+			static constexpr bool instance = std::is_arithmetic<N>::value;
+
+			template<typename Fn, typename T>
+			static prod_monoid<N> run(Fn& fn, const T* xs, std::size_t n) {
+				N acc[fold_kernel_lanes] = {N(1), N(1), N(1), N(1)};
+
+				std::size_t i = 0;
+				for(; i + fold_kernel_lanes <= n; i += fold_kernel_lanes) {
+					acc[0] *= fn(xs[i]).n;
+					acc[1] *= fn(xs[i+1]).n;
+					acc[2] *= fn(xs[i+2]).n;
+					acc[3] *= fn(xs[i+3]).n;
+				}
+
+				for(; i < n; ++i) {
+					acc[0] *= fn(xs[i]).n;
+				}
+
+				return prod_monoid<N>((acc[0] * acc[1]) * (acc[2] * acc[3]));
+			}
+		};
+
+		// Whether folding T into M over contiguous storage has a kernel
+		template<typename T, typename M>
+		struct has_fold_kernel {
+			static constexpr bool value =
+				fold_kernel<M>::instance && !std::is_same<T,bool>::value;
+		};
+	}
+}
+
+#endif
@@ -34,6 +34,9 @@
 #include <stdexcept>
 #include <functional>
 #include "../type_functions.h"
+#include "../instrument.h"
+#include "../pooled_allocator.h"
+#include "function_fwd.h"
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -42,36 +45,35 @@
 
 namespace ftl {
 
-	template<typename> class function;
-
 	template<typename>
 	struct force_function_heap_allocation : std::false_type {};
 
 	// Namespace for internal details
 	namespace _dtl {
+		template<std::size_t>
 		struct manager_storage_type;
 
+		template<std::size_t Size>
 		struct functor_padding {
 		protected:
-			size_t padding_fst;
-			size_t padding_snd;
+			size_t padding[(Size + sizeof(size_t) - 1) / sizeof(size_t)];
 		};
 
 		struct empty_struct {};
 
-		template<typename R, typename...Ps>
-		R empty_call(const functor_padding&, Ps...) {
+		template<std::size_t N, typename R, typename...Ps>
+		R empty_call(const functor_padding<N>&, Ps...) {
 			throw std::bad_function_call();
 		}
 
-		template<typename T, typename Alloc>
+		template<typename T, typename Alloc, std::size_t N = function_capacity>
 		struct is_inplace_allocated {
 			static constexpr bool value
 				// so that it fits
-				= sizeof(T) <= sizeof(functor_padding)
+				= sizeof(T) <= sizeof(functor_padding<N>)
 
 				// so that it will be aligned
-				&& (std::alignment_of<functor_padding>::value
+				&& (std::alignment_of<functor_padding<N>>::value
 					% std::alignment_of<T>::value == 0)
 
 				// so that we can offer noexcept move
@@ -119,18 +121,25 @@ namespace ftl {
 			return fp == nullptr;
 		}
 
-		template<typename, typename>
+		template<typename, typename, std::size_t = function_capacity>
 		struct is_valid_function_argument {
 			static constexpr bool value = false;
 		};
 
-		template<typename R, typename...Ps>
-		struct is_valid_function_argument<function<R(Ps...)>, R (Ps...)> {
+		template<typename R, typename...Ps, std::size_t N>
+		struct is_valid_function_argument<function<R(Ps...),N>, R (Ps...), N> {
+			static constexpr bool value = false;
+		};
+
+		template<typename R, typename...Ps, std::size_t N>
+		struct is_valid_function_argument<
+				unique_function<R(Ps...),N>, R (Ps...), N
+		> {
 			static constexpr bool value = false;
 		};
 
-		template<typename T, typename R, typename...Ps>
-		struct is_valid_function_argument<T, R (Ps...)> {
+		template<typename T, typename R, typename...Ps, std::size_t N>
+		struct is_valid_function_argument<T, R (Ps...), N> {
 
 			template<typename U>
 			static decltype(
@@ -145,6 +154,142 @@ namespace ftl {
 				= std::is_convertible<decltype(check<T>(nullptr)), R>::value;
 		};
 
+		/*
+		 * Handle to a functor kept in memory obtained from a stateful allocator.
+		 *
+		 * The allocator is stored next to the functor, so the handle itself is
+		 * a single pointer and can be stored in place by the function manager,
+		 * which only ever holds empty allocators.
+		 */
+		template<typename F, typename Allocator>
+		class allocated_functor {
+			struct node {
+				Allocator alloc;
+				F f;
+			};
+
+			using node_allocator = typename std::allocator_traits<Allocator>
+				::template rebind_alloc<node>;
+
+			using node_traits = std::allocator_traits<node_allocator>;
+
+		public:
+			allocated_functor(const Allocator& alloc, F f)
+			: n(make(alloc, std::move(f))) {}
+
+			allocated_functor(const allocated_functor& other)
+			: n(make(other.n->alloc, other.n->f)) {}
+
+			allocated_functor(allocated_functor&& other) noexcept
+			: n(other.n) {
+				other.n = nullptr;
+			}
+
+			allocated_functor& operator= (const allocated_functor&) = delete;
+
+			~allocated_functor() {
+				if(n) {
+					node_allocator alloc(n->alloc);
+					n->~node();
+					node_traits::deallocate(alloc, n, 1);
+				}
+			}
+
+			template<typename...Ps>
+			auto operator() (Ps&&...ps) const
+			-> decltype(std::declval<F&>()(std::forward<Ps>(ps)...)) {
+				return n->f(std::forward<Ps>(ps)...);
+			}
+
+		private:
+			template<typename G>
+			static node* make(const Allocator& alloc, G&& g) {
+				node_allocator na(alloc);
+				node* p = node_traits::allocate(na, 1);
+				FTL_COUNT_ALLOCATION(function, sizeof(node));
+
+				try {
+					new (p) node{alloc, std::forward<G>(g)};
+				}
+				catch(...) {
+					node_traits::deallocate(na, p, 1);
+					throw;
+				}
+
+				return p;
+			}
+
+			node* n;
+		};
+
+		/*
+		 * How a functor is stored when constructed with a given allocator.
+		 *
+		 * Empty allocators go in the manager as they are. Stateful ones
+		 * cannot, so functors small enough are stored in place without using
+		 * the allocator at all, and bigger ones go behind an allocated_functor.
+		 */
+		template<
+				typename F,
+				typename Allocator,
+				std::size_t N,
+				typename = void
+		>
+		struct allocator_storage {
+			static constexpr bool nothrow
+				= is_inplace_allocated<F, Allocator, N>::value;
+
+			static F wrap(F&& f, const Allocator&) {
+				return std::move(f);
+			}
+
+			static Allocator allocator(const Allocator& alloc) {
+				return alloc;
+			}
+		};
+
+		template<typename F, typename Allocator, std::size_t N>
+		struct allocator_storage<
+				F, Allocator, N,
+				typename std::enable_if<
+					!std::is_empty<Allocator>::value
+					&& is_inplace_allocated<F, std::allocator<F>, N>::value
+				>::type
+		> {
+			static constexpr bool nothrow = true;
+
+			static F wrap(F&& f, const Allocator&) {
+				return std::move(f);
+			}
+
+			static std::allocator<F> allocator(const Allocator&) {
+				return std::allocator<F>();
+			}
+		};
+
+		template<typename F, typename Allocator, std::size_t N>
+		struct allocator_storage<
+				F, Allocator, N,
+				typename std::enable_if<
+					!std::is_empty<Allocator>::value
+					&& !is_inplace_allocated<F, std::allocator<F>, N>::value
+				>::type
+		> {
+			static constexpr bool nothrow = false;
+
+			static allocated_functor<F,Allocator> wrap(
+					F&& f, const Allocator& alloc
+			) {
+				return allocated_functor<F,Allocator>(alloc, std::move(f));
+			}
+
+			static std::allocator<allocated_functor<F,Allocator>> allocator(
+					const Allocator&
+			) {
+				return std::allocator<allocated_functor<F,Allocator>>();
+			}
+		};
+
 		enum function_manager_calls
 		{
 			call_move_and_destroy,
@@ -153,7 +298,13 @@ namespace ftl {
 			call_destroy,
 		};
 
-		template<typename T, typename Allocator>
+		// Copyable is false for managers of move-only functors
+		template<
+				typename T,
+				typename Allocator,
+				std::size_t N,
+				bool Copyable = true
+		>
 		void* function_manager(
 				void* first_arg,
 				void* second_arg,
@@ -161,6 +312,7 @@ namespace ftl {
 
 		typedef void *(*manager_type)(void*, void*, function_manager_calls);
 
+		template<std::size_t N>
 		struct manager_storage_type {
 
 			template<typename Allocator>
@@ -173,70 +325,78 @@ namespace ftl {
 				return reinterpret_cast<const Allocator&>(manager);
 			}
 
-			functor_padding functor;
+			functor_padding<N> functor;
 			manager_type manager;
 		};
 
-		template<typename T, typename Allocator, typename Enable = void>
+		template<
+				typename T,
+				typename Allocator,
+				std::size_t N,
+				typename Enable = void
+		>
 		struct function_manager_inplace_specialisation {
+			using storage_type = manager_storage_type<N>;
 
 			template<typename R, typename...Ps>
-			static R call(const functor_padding& storage, Ps... ps) {
+			static R call(const functor_padding<N>& storage, Ps... ps) {
 				// do not call get_functor_ref because I want this function to
 				// be fast in debug when nothing gets inlined
 				return
 					reinterpret_cast<T&>(
-						const_cast<functor_padding&>(storage))(std::forward<Ps>(ps)...);
+						const_cast<functor_padding<N>&>(storage))(std::forward<Ps>(ps)...);
 			}
 
-			static void store_functor(manager_storage_type& storage, T to_store) {
+			static void store_functor(storage_type& storage, T to_store) {
 				new (&get_functor_ref(storage)) T(std::forward<T>(to_store));
 			}
 
 			static void move_functor(
-					manager_storage_type& lhs, manager_storage_type&& rhs
+					storage_type& lhs, storage_type&& rhs
 			)
 			noexcept {
 				new (&get_functor_ref(lhs)) T(std::move(get_functor_ref(rhs)));
 			}
 
 			static void destroy_functor(
-					Allocator &, manager_storage_type & storage
+					Allocator &, storage_type & storage
 			)
 			noexcept {
 				get_functor_ref(storage).~T();
 			}
 
-			static T& get_functor_ref(const manager_storage_type& storage) noexcept {
+			static T& get_functor_ref(const storage_type& storage) noexcept {
 				return reinterpret_cast<T&>(
-					const_cast<functor_padding&>(storage.functor)
+					const_cast<functor_padding<N>&>(storage.functor)
 				);
 			}
 		};
 
-		template<typename T, typename Allocator>
+		template<typename T, typename Allocator, std::size_t N>
 		struct function_manager_inplace_specialisation<
 					T,
 					Allocator,
+					N,
 					typename std::enable_if<
-						!is_inplace_allocated<T, Allocator>::value>::type> {
+						!is_inplace_allocated<T, Allocator, N>::value>::type> {
 
+			using storage_type = manager_storage_type<N>;
 			using alloc_traits = std::allocator_traits<Allocator>;
 			using ptr_t = typename alloc_traits::pointer;
 
 			template<typename R, typename...Ps>
-			static R call(const functor_padding& storage, Ps... ps) {
+			static R call(const functor_padding<N>& storage, Ps... ps) {
 				// do not call get_functor_ptr_ref because I want this function
 				// to be fast in debug when nothing gets inlined
 				return
-					(*reinterpret_cast<ptr_t&>(const_cast<functor_padding&>(storage)))(
+					(*reinterpret_cast<ptr_t&>(const_cast<functor_padding<N>&>(storage)))(
 						std::forward<Ps>(ps)...
 					);
 			}
 
-			static void store_functor(manager_storage_type& self, T to_store) {
+			static void store_functor(storage_type& self, T to_store) {
 
-				Allocator& allocator = self.get_allocator<Allocator>();;
+				Allocator& allocator = self.template get_allocator<Allocator>();;
 				static_assert(
 						sizeof(ptr_t) <= sizeof(self.functor),
 						"The allocator's pointer type is too big"
@@ -245,12 +405,13 @@ namespace ftl {
 				ptr_t* ptr = new (&get_functor_ptr_ref(self)) ptr_t(
 						alloc_traits::allocate(allocator, 1)
 				);
+				FTL_COUNT_ALLOCATION(function, sizeof(T));
 
 				alloc_traits::construct(allocator, *ptr, std::forward<T>(to_store));
 			}
 
 			static void move_functor(
-					manager_storage_type& lhs, manager_storage_type&& rhs
+					storage_type& lhs, storage_type&& rhs
 			)
 			noexcept {
 
@@ -269,7 +430,7 @@ namespace ftl {
 			}
 
 			static void destroy_functor(
-					Allocator& allocator, manager_storage_type& storage
+					Allocator& allocator, storage_type& storage
 			)
 			noexcept {
 
@@ -281,35 +442,86 @@ namespace ftl {
 				alloc_traits::deallocate(allocator, pointer, 1);
 			}
 
-			static T & get_functor_ref(const manager_storage_type& storage) noexcept {
+			static T & get_functor_ref(const storage_type& storage) noexcept {
 				return *get_functor_ptr_ref(storage);
 			}
 
-			static ptr_t& get_functor_ptr_ref(const manager_storage_type& storage)
+			static ptr_t& get_functor_ptr_ref(const storage_type& storage)
 			noexcept {
 				return reinterpret_cast<ptr_t&>(
-						const_cast<functor_padding&>(storage.functor)
+						const_cast<functor_padding<N>&>(storage.functor)
 				);
 			}
 		};
 
-		template<typename T, typename Allocator>
-		static void create_manager(manager_storage_type& storage, Allocator&& allocator)
-		{
-			new (&storage.get_allocator<Allocator>()) Allocator(std::move(allocator));
-			storage.manager = &function_manager<T, Allocator>;
+		template<
+				typename T,
+				typename Allocator,
+				std::size_t N,
+				bool Copyable = true
+		>
+		static void create_manager(
+				manager_storage_type<N>& storage, Allocator&& allocator
+		) {
+			new (&storage.template get_allocator<Allocator>())
+				Allocator(std::move(allocator));
+			storage.manager = &function_manager<T, Allocator, N, Copyable>;
 		}
 
+		// The copying parts of function_manager
+		template<typename T, typename Allocator, std::size_t N, bool Copyable>
+		struct function_manager_copy {
+			using specialisation
+				= function_manager_inplace_specialisation<T,Allocator,N>;
+			using storage_type = manager_storage_type<N>;
+
+			static void copy(void* first_arg, void* second_arg) {
+				storage_type& lhs =
+					*static_cast<storage_type*>(first_arg);
+
+				const storage_type& rhs =
+					*static_cast<const storage_type*>(second_arg);
+
+				create_manager<T,Allocator,N>(
+						lhs, Allocator(rhs.template get_allocator<Allocator>())
+				);
+
+				specialisation::store_functor(
+						lhs, const_cast<const T&>(specialisation::get_functor_ref(rhs))
+				);
+			}
+
+			static void copy_functor_only(void* first_arg, void* second_arg) {
+				specialisation::store_functor(
+						*static_cast<storage_type *>(first_arg),
+						const_cast<const T&>(
+							specialisation::get_functor_ref(
+								*static_cast<const storage_type*>(second_arg)
+							)
+						)
+				);
+			}
+		};
+
+		// Move-only functors are never asked to be copied
+		template<typename T, typename Allocator, std::size_t N>
+		struct function_manager_copy<T,Allocator,N,false> {
+			static void copy(void*, void*) noexcept {}
+			static void copy_functor_only(void*, void*) noexcept {}
+		};
+
 		// this function acts as a vtable. it is an optimization to prevent
 		// code-bloat from rtti. see the documentation of boost::function
-		template<typename T, typename Allocator>
+		template<typename T, typename Allocator, std::size_t N, bool Copyable>
 		void* function_manager(
 				void* first_arg, void* second_arg,
 				function_manager_calls call_type
 		)
 		{
 			using specialisation
-				= function_manager_inplace_specialisation<T,Allocator>;
+				= function_manager_inplace_specialisation<T,Allocator,N>;
+			using copying = function_manager_copy<T,Allocator,N,Copyable>;
+			using storage_type = manager_storage_type<N>;
 
 			static_assert(
 				std::is_empty<Allocator>::value,
@@ -320,65 +532,49 @@ namespace ftl {
 
 			case call_move_and_destroy: {
 
-				manager_storage_type& lhs =
-					*static_cast<manager_storage_type*>(first_arg);
+				storage_type& lhs =
+					*static_cast<storage_type*>(first_arg);
 
-				manager_storage_type& rhs =
-					*static_cast<manager_storage_type*>(second_arg);
+				storage_type& rhs =
+					*static_cast<storage_type*>(second_arg);
 
 				specialisation::move_functor(lhs, std::move(rhs));
-				specialisation::destroy_functor(rhs.get_allocator<Allocator>(), rhs);
+				specialisation::destroy_functor(
+						rhs.template get_allocator<Allocator>(), rhs
+				);
 
-				create_manager<T,Allocator>(
-						lhs, std::move(rhs.get_allocator<Allocator>())
+				create_manager<T,Allocator,N,Copyable>(
+						lhs, std::move(rhs.template get_allocator<Allocator>())
 				);
 
-				rhs.get_allocator<Allocator>().~Allocator();
+				rhs.template get_allocator<Allocator>().~Allocator();
 
 				return nullptr;
 			}
 
-			case call_copy: {
-
-				manager_storage_type& lhs =
-					*static_cast<manager_storage_type*>(first_arg);
-
-				const manager_storage_type& rhs =
-					*static_cast<const manager_storage_type*>(second_arg);
+			case call_copy:
 
-				create_manager<T, Allocator>(
-						lhs, Allocator(rhs.get_allocator<Allocator>())
-				);
-
-				specialisation::store_functor(
-						lhs, const_cast<const T&>(specialisation::get_functor_ref(rhs))
-				);
+				copying::copy(first_arg, second_arg);
 
 				return nullptr;
-			}
 
 			case call_destroy: {
 
-				manager_storage_type& self =
-					*static_cast<manager_storage_type *>(first_arg);
+				storage_type& self =
+					*static_cast<storage_type *>(first_arg);
 
-				specialisation::destroy_functor(self.get_allocator<Allocator>(), self);
+				specialisation::destroy_functor(
+						self.template get_allocator<Allocator>(), self
+				);
 
-				self.get_allocator<Allocator>().~Allocator();
+				self.template get_allocator<Allocator>().~Allocator();
 
 				return nullptr;
 			}
 
 			case call_copy_functor_only:
 
-				specialisation::store_functor(
-						*static_cast<manager_storage_type *>(first_arg),
-						const_cast<const T&>(
-							specialisation::get_functor_ref(
-								*static_cast<const manager_storage_type*>(second_arg)
-							)
-						)
-				);
+				copying::copy_functor_only(first_arg, second_arg);
 
 				return nullptr;
 
@@ -387,31 +583,38 @@ namespace ftl {
 			}
 		}
 
-		template<typename...>
+		template<std::size_t, typename...>
 		struct curried {};
 
-		template<typename R>
-		struct curried<R> {
+		template<std::size_t N, typename R>
+		struct curried<N,R> {
 			R operator()() const {
 				throw(std::logic_error("Curried calling of parameterless function"));
 			}
 		};
 
-		template<typename R, typename P>
-		struct curried<R,P> {
+		template<std::size_t N, typename R, typename P>
+		struct curried<N,R,P> {
 			function<R()> operator()(P) const {
 				throw(std::logic_error("Curried calling of parameterless function"));
 			}
 		};
 
-		template<typename R, typename P1, typename P2, typename...Ps>
-		struct curried<R,P1,P2,Ps...> {
+		template<
+				std::size_t N,
+				typename R,
+				typename P1,
+				typename P2,
+				typename...Ps
+		>
+		struct curried<N,R,P1,P2,Ps...> {
         private:
             using applied_type = function<R(P2,Ps...)>;
 
             // Apply one argument.
             applied_type apply_one(P1 p1) const {
-				auto self = *reinterpret_cast<const function<R(P1,P2,Ps...)>*>(this);
+				auto self =
+					*reinterpret_cast<const function<R(P1,P2,Ps...),N>*>(this);
 				return [self,p1] (P2 p2, Ps...ps) {
 					return self.operator()(
 							p1, std::forward<P2>(p2), std::forward<Ps>(ps)...
@@ -435,6 +638,60 @@ namespace ftl {
 			}
 		};
 
+		// A move-only function with its first argument applied
+		template<typename F, typename P1, typename R, typename...Ps>
+		struct unique_partial {
+			R operator()(Ps...ps) const {
+				return f(p1, std::forward<Ps>(ps)...);
+			}
+
+			F f;
+			P1 p1;
+		};
+
+		/*
+		 * Curried calling for unique_function.
+		 *
+		 * As a unique_function cannot be copied, partial application moves
+		 * the function into the result, and is hence only available on
+		 * rvalues.
+		 */
+		template<std::size_t N, typename R, typename...Ps>
+		struct unique_curried : curried<N,R,Ps...> {};
+
+		template<
+				std::size_t N,
+				typename R,
+				typename P1,
+				typename P2,
+				typename...Ps
+		>
+		struct unique_curried<N,R,P1,P2,Ps...> {
+		private:
+			using self_type = unique_function<R(P1,P2,Ps...),N>;
+			using applied_type = unique_function<R(P2,Ps...)>;
+
+			applied_type apply_one(P1 p1) {
+				return unique_partial<self_type,P1,R,P2,Ps...>{
+					std::move(*reinterpret_cast<self_type*>(this)),
+					std::move(p1)
+				};
+			}
+
+		public:
+			applied_type operator() (P1 p1) && {
+				return apply_one(std::move(p1));
+			}
+
+			template<typename...Ps2>
+			auto operator()(P1 p1, P2 p2, Ps2&&...ps2) &&
+			-> typename std::result_of<applied_type(P2,Ps2...)>::type
+			{
+				applied_type g = apply_one(std::move(p1));
+				return g(std::move(p2), std::forward<Ps2>(ps2)...);
+			}
+		};
+
 	}
 }
 
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_FUNCTION_FWD_H
+#define FTL_FUNCTION_FWD_H
+
+#include <cstddef>
+
+namespace ftl {
+	namespace _dtl {
+		// Bytes of in-place functor storage in an ftl::function by default
+		constexpr std::size_t function_capacity = 2*sizeof(std::size_t);
+	}
+
+	template<typename, std::size_t = _dtl::function_capacity>
+	class function;
+
+	template<typename, std::size_t = _dtl::function_capacity>
+	class unique_function;
+}
+
+#endif
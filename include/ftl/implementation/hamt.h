@@ -0,0 +1,574 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_HAMT_H
+#define FTL_HAMT_H
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <iterator>
+#include "mix_hash.h"
+#include "../instrument.h"
+
+namespace ftl {
+	namespace _dtl {
+		/*
+		 * Hash array mapped trie shared by the persistent hash containers.
+		 *
+		 * Every node consumes 5 bits of the hash. Entries that are alone in
+		 * their slot are stored in the node itself, others in child nodes,
+		 * each set having its own bitmap (the "CHAMP" layout). Erasing keeps
+		 * the trie canonical: a child left with a single entry is inlined
+		 * into its parent. Once all bits of the hash are consumed, the
+		 * remaining entries, whose hashes are all equal, are kept in a
+		 * collision node and searched linearly.
+		 *
+		 * Nodes are never modified once shared. Updates copy the path from
+		 * the root, anything else is shared with the original trie.
+		 */
+		constexpr std::size_t hamt_bits = 5;
+		constexpr std::size_t hamt_hash_bits =
+			std::numeric_limits<std::size_t>::digits;
+		constexpr std::size_t hamt_max_depth =
+			(hamt_hash_bits + hamt_bits - 1) / hamt_bits + 1;
+
+		inline std::size_t popcount32(std::uint32_t x) noexcept {
+			x = x - ((x >> 1) & 0x55555555u);
+			x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+			return (((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+		}
+
+		template<typename E>
+		struct hamt_node {
+			using ptr = std::shared_ptr<const hamt_node>;
+
+			std::uint32_t datamap = 0;
+			std::uint32_t nodemap = 0;
+			std::vector<E> entries;
+			std::vector<ptr> kids;
+		};
+
+		struct hamt_identity {
+			template<typename T>
+			static const T& key(const T& t) noexcept {
+				return t;
+			}
+		};
+
+		struct hamt_first {
+			template<typename P>
+			static const typename P::first_type& key(const P& p) noexcept {
+				return p.first;
+			}
+		};
+
+		/*
+		 * E is the type of the entries and K that of their keys, as given by
+		 * KeyOf::key(e).
+		 */
+		template<typename E, typename K, typename KeyOf, typename H, typename Eq>
+		class hamt {
+			using node = hamt_node<E>;
+			using ptr = typename node::ptr;
+
+		public:
+			class iterator {
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = E;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const E*;
+				using reference = const E&;
+
+				iterator() = default;
+
+				reference operator* () const {
+					return cur->entries[i];
+				}
+
+				pointer operator-> () const {
+					return &cur->entries[i];
+				}
+
+				iterator& operator++ () {
+					if(++i == cur->entries.size())
+						next_node();
+
+					return *this;
+				}
+
+				iterator operator++ (int) {
+					auto tmp = *this;
+					++*this;
+					return tmp;
+				}
+
+				bool operator== (const iterator& it) const {
+					return cur == it.cur && i == it.i;
+				}
+
+				bool operator!= (const iterator& it) const {
+					return !(*this == it);
+				}
+
+			private:
+				friend class hamt;
+
+				// A node on the path to cur, and the next child to visit
+				struct frame {
+					const node* n;
+					std::size_t kid;
+				};
+
+				void push(const node* n, std::size_t kid) {
+					path[depth++] = frame{n, kid};
+				}
+
+				// Entries of a node are visited before those of its children
+				void next_node() {
+					while(depth > 0) {
+						auto& f = path[depth - 1];
+						if(f.kid < f.n->kids.size()) {
+							auto c = f.n->kids[f.kid++].get();
+							push(c, 0);
+							if(!c->entries.empty()) {
+								cur = c;
+								i = 0;
+								return;
+							}
+						}
+						else {
+							--depth;
+						}
+					}
+
+					cur = nullptr;
+					i = 0;
+				}
+
+				const node* cur = nullptr;
+				std::size_t i = 0;
+				std::array<frame, hamt_max_depth> path;
+				std::size_t depth = 0;
+			};
+
+			hamt() = default;
+
+			hamt(const H& hash, const Eq& eq) : hash(hash), eq(eq) {}
+
+			hamt(ptr root, std::size_t len, const H& hash, const Eq& eq)
+			: root(std::move(root)), len(len), hash(hash), eq(eq) {}
+
+			std::size_t size() const noexcept {
+				return len;
+			}
+
+			iterator begin() const {
+				iterator it;
+				if(root) {
+					it.push(root.get(), 0);
+					if(root->entries.empty()) {
+						it.next_node();
+					}
+					else {
+						it.cur = root.get();
+					}
+				}
+
+				return it;
+			}
+
+			iterator end() const {
+				return iterator();
+			}
+
+			iterator find(const K& k) const {
+				iterator it;
+				if(!root)
+					return it;
+
+				auto h = hash_of(k);
+				const node* n = root.get();
+				for(std::size_t shift = 0; ; shift += hamt_bits) {
+					if(shift >= hamt_hash_bits) {
+						for(std::size_t i = 0; i < n->entries.size(); ++i) {
+							if(eq(KeyOf::key(n->entries[i]), k)) {
+								it.push(n, 0);
+								it.cur = n;
+								it.i = i;
+								return it;
+							}
+						}
+
+						return iterator();
+					}
+
+					auto bit = bit_of(h, shift);
+					if(n->datamap & bit) {
+						auto i = index(n->datamap, bit);
+						if(!eq(KeyOf::key(n->entries[i]), k))
+							return iterator();
+
+						it.push(n, 0);
+						it.cur = n;
+						it.i = i;
+						return it;
+					}
+
+					if(!(n->nodemap & bit))
+						return iterator();
+
+					auto i = index(n->nodemap, bit);
+					it.push(n, i + 1);
+					n = n->kids[i].get();
+				}
+			}
+
+			/*
+			 * Adds e, or replaces the entry with the same key if overwrite
+			 * is set. Gives back *this when nothing changed.
+			 */
+			hamt insert(E e, bool overwrite) const {
+				if(!root) {
+					auto r = std::make_shared<node>();
+					FTL_COUNT_ALLOCATION(persistent, sizeof(node));
+					r->datamap = bit_of(hash_of(KeyOf::key(e)), 0);
+					r->entries.push_back(std::move(e));
+					return hamt(std::move(r), 1, hash, eq);
+				}
+
+				bool added = false;
+				auto h = hash_of(KeyOf::key(e));
+				auto r = insert(root, 0, h, e, overwrite, added);
+				return hamt(std::move(r), len + added, hash, eq);
+			}
+
+			hamt erase(const K& k) const {
+				if(!root)
+					return *this;
+
+				bool removed = false;
+				auto r = erase(root, 0, hash_of(k), k, removed);
+				return hamt(std::move(r), len - removed, hash, eq);
+			}
+
+			/*
+			 * Applies f to every entry, keeping the layout of the trie. f must
+			 * not change the keys.
+			 */
+			template<typename E2, typename F>
+			hamt<E2,K,KeyOf,H,Eq> remap(F&& f) const {
+				if(!root)
+					return hamt<E2,K,KeyOf,H,Eq>(hash, eq);
+
+				return hamt<E2,K,KeyOf,H,Eq>(remap<E2>(f, *root), len, hash, eq);
+			}
+
+			/*
+			 * Like remap for a function from E to E, except that nodes where
+			 * f changed no entry are shared with the original trie.
+			 */
+			template<typename F>
+			hamt update(F&& f) const {
+				if(!root)
+					return *this;
+
+				return hamt(update(f, root), len, hash, eq);
+			}
+
+			const H& hash_function() const noexcept {
+				return hash;
+			}
+
+			const Eq& key_eq() const noexcept {
+				return eq;
+			}
+
+			bool same_root(const hamt& t) const noexcept {
+				return root == t.root;
+			}
+
+		private:
+			template<typename, typename, typename, typename, typename>
+			friend class hamt;
+
+			std::size_t hash_of(const K& k) const {
+				return mix_hash(hash(k));
+			}
+
+			static std::uint32_t bit_of(std::size_t h, std::size_t shift) {
+				return std::uint32_t(1) << ((h >> shift) & 31);
+			}
+
+			static std::size_t index(std::uint32_t map, std::uint32_t bit) {
+				return popcount32(map & (bit - 1));
+			}
+
+			static std::shared_ptr<node> copy(const ptr& n) {
+				FTL_COUNT_ALLOCATION(persistent, sizeof(node));
+				return std::make_shared<node>(*n);
+			}
+
+			// A node holding a and b, whose hashes agree below shift
+			ptr pair_node(
+					const E& a, std::size_t ha,
+					E&& b, std::size_t hb,
+					std::size_t shift) const {
+				auto r = std::make_shared<node>();
+				FTL_COUNT_ALLOCATION(persistent, sizeof(node));
+				if(shift >= hamt_hash_bits) {
+					r->entries.push_back(a);
+					r->entries.push_back(std::move(b));
+					return r;
+				}
+
+				auto ba = bit_of(ha, shift);
+				auto bb = bit_of(hb, shift);
+				if(ba == bb) {
+					r->nodemap = ba;
+					r->kids.push_back(
+						pair_node(a, ha, std::move(b), hb, shift + hamt_bits)
+					);
+				}
+				else {
+					r->datamap = ba | bb;
+					r->entries.reserve(2);
+					if(ba < bb) {
+						r->entries.push_back(a);
+						r->entries.push_back(std::move(b));
+					}
+					else {
+						r->entries.push_back(std::move(b));
+						r->entries.push_back(a);
+					}
+				}
+
+				return r;
+			}
+
+			ptr insert(
+					const ptr& n, std::size_t shift, std::size_t h,
+					E& e, bool overwrite, bool& added) const {
+				if(shift >= hamt_hash_bits) {
+					for(std::size_t i = 0; i < n->entries.size(); ++i) {
+						if(eq(KeyOf::key(n->entries[i]), KeyOf::key(e))) {
+							if(!overwrite)
+								return n;
+
+							auto r = copy(n);
+							r->entries[i] = std::move(e);
+							return r;
+						}
+					}
+
+					auto r = copy(n);
+					r->entries.push_back(std::move(e));
+					added = true;
+					return r;
+				}
+
+				auto bit = bit_of(h, shift);
+				if(n->datamap & bit) {
+					auto i = index(n->datamap, bit);
+					auto& old = n->entries[i];
+					if(eq(KeyOf::key(old), KeyOf::key(e))) {
+						if(!overwrite)
+							return n;
+
+						auto r = copy(n);
+						r->entries[i] = std::move(e);
+						return r;
+					}
+
+					// Push both entries down a level
+					auto kid = pair_node(
+						old, hash_of(KeyOf::key(old)),
+						std::move(e), h,
+						shift + hamt_bits
+					);
+
+					auto r = copy(n);
+					r->entries.erase(r->entries.begin() + i);
+					r->datamap ^= bit;
+					r->nodemap |= bit;
+					r->kids.insert(
+						r->kids.begin() + index(r->nodemap, bit), std::move(kid)
+					);
+
+					added = true;
+					return r;
+				}
+
+				if(n->nodemap & bit) {
+					auto i = index(n->nodemap, bit);
+					auto kid = insert(
+						n->kids[i], shift + hamt_bits, h, e, overwrite, added
+					);
+
+					if(kid == n->kids[i])
+						return n;
+
+					auto r = copy(n);
+					r->kids[i] = std::move(kid);
+					return r;
+				}
+
+				auto r = copy(n);
+				r->entries.insert(
+					r->entries.begin() + index(n->datamap, bit), std::move(e)
+				);
+				r->datamap |= bit;
+
+				added = true;
+				return r;
+			}
+
+			// Gives back n if k is not there, and null if n ends up empty
+			ptr erase(
+					const ptr& n, std::size_t shift, std::size_t h,
+					const K& k, bool& removed) const {
+				if(shift >= hamt_hash_bits) {
+					for(std::size_t i = 0; i < n->entries.size(); ++i) {
+						if(eq(KeyOf::key(n->entries[i]), k)) {
+							removed = true;
+							if(n->entries.size() == 1)
+								return nullptr;
+
+							auto r = copy(n);
+							r->entries.erase(r->entries.begin() + i);
+							return r;
+						}
+					}
+
+					return n;
+				}
+
+				auto bit = bit_of(h, shift);
+				if(n->datamap & bit) {
+					auto i = index(n->datamap, bit);
+					if(!eq(KeyOf::key(n->entries[i]), k))
+						return n;
+
+					removed = true;
+					if(n->entries.size() == 1 && n->kids.empty())
+						return nullptr;
+
+					auto r = copy(n);
+					r->entries.erase(r->entries.begin() + i);
+					r->datamap ^= bit;
+					return r;
+				}
+
+				if(!(n->nodemap & bit))
+					return n;
+
+				auto i = index(n->nodemap, bit);
+				auto kid = erase(n->kids[i], shift + hamt_bits, h, k, removed);
+				if(kid == n->kids[i])
+					return n;
+
+				auto r = copy(n);
+				if(kid && (!kid->kids.empty() || kid->entries.size() > 1)) {
+					r->kids[i] = std::move(kid);
+					return r;
+				}
+
+				// Inline the last entry of the child, or just drop the child
+				r->kids.erase(r->kids.begin() + i);
+				r->nodemap ^= bit;
+				if(kid) {
+					r->datamap |= bit;
+					r->entries.insert(
+						r->entries.begin() + index(r->datamap, bit),
+						kid->entries.front()
+					);
+				}
+
+				if(r->entries.empty() && r->kids.empty())
+					return nullptr;
+
+				return r;
+			}
+
+			template<typename E2, typename F>
+			static typename hamt_node<E2>::ptr remap(F& f, const node& n) {
+				auto r = std::make_shared<hamt_node<E2>>();
+				FTL_COUNT_ALLOCATION(persistent, sizeof(hamt_node<E2>));
+				r->datamap = n.datamap;
+				r->nodemap = n.nodemap;
+
+				r->entries.reserve(n.entries.size());
+				for(auto& e : n.entries) {
+					r->entries.push_back(f(e));
+				}
+
+				r->kids.reserve(n.kids.size());
+				for(auto& k : n.kids) {
+					r->kids.push_back(remap<E2>(f, *k));
+				}
+
+				return r;
+			}
+
+			template<typename F>
+			static ptr update(F& f, const ptr& n) {
+				std::shared_ptr<node> r;
+				for(std::size_t i = 0; i < n->entries.size(); ++i) {
+					auto e = f(n->entries[i]);
+					if(!r && e == n->entries[i])
+						continue;
+
+					if(!r)
+						r = copy(n);
+
+					r->entries[i] = std::move(e);
+				}
+
+				for(std::size_t i = 0; i < n->kids.size(); ++i) {
+					auto k = update(f, n->kids[i]);
+					if(k == n->kids[i])
+						continue;
+
+					if(!r)
+						r = copy(n);
+
+					r->kids[i] = std::move(k);
+				}
+
+				if(!r)
+					return n;
+
+				return r;
+			}
+
+			ptr root;
+			std::size_t len = 0;
+			H hash;
+			Eq eq;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_IMPL_LAZY_CELL_H
+#define FTL_IMPL_LAZY_CELL_H
+
+#include <atomic>
+#include <new>
+#include <utility>
+#include "../function.h"
+#include "../instrument.h"
+#include "../memory_resource.h"
+#include "../trace.h"
+
+namespace ftl {
+	namespace _dtl {
+		/*
+		 * Place of a lazy computation in a schedule being evaluated.
+		 *
+		 * While a node is part of a running ftl::evaluate, forcing it goes
+		 * through its slot, which either computes it on the spot or waits for
+		 * whichever thread already is.
+		 */
+		struct lazy_slot {
+			void (*claim)(lazy_slot&);
+		};
+
+		/*
+		 * Type erased part of a lazy_cell.
+		 *
+		 * Besides the reference count and state, a deferred node records up
+		 * to two of the deferred computations it was built from, so that a
+		 * graph of them can be discovered without forcing anything. The
+		 * record is only a hint: dependencies that were not recorded are
+		 * still forced whenever the computation asks for them.
+		 */
+		class lazy_node {
+		public:
+			static constexpr unsigned max_dependencies = 2;
+
+			lazy_node(const lazy_node&) = delete;
+			lazy_node& operator= (const lazy_node&) = delete;
+
+			bool is_ready() const noexcept {
+				return ready.load(std::memory_order_acquire);
+			}
+
+			// Record n as a dependency, unless it is already computed
+			void depend_on(const lazy_node* n) noexcept {
+				if(n && !n->is_ready() && ndeps < max_dependencies)
+					deps[ndeps++] = const_cast<lazy_node*>(n);
+			}
+
+			// Record the dependencies of n, as when fusing n into this node
+			void inherit(const lazy_node& n) noexcept {
+				for(unsigned i = 0; i < n.ndeps; ++i)
+					depend_on(n.deps[i]);
+			}
+
+			unsigned dependencies() const noexcept {
+				return ndeps;
+			}
+
+			lazy_node* dependency(unsigned i) const noexcept {
+				return deps[i];
+			}
+
+			// Compute the value, bypassing any schedule
+			virtual void compute() = 0;
+
+			bool unique() const noexcept {
+				return refs.load(std::memory_order_acquire) == 1;
+			}
+
+			void acquire() noexcept {
+				refs.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			void release() noexcept {
+				if(refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					destroy();
+			}
+
+			// Set by ftl::evaluate only, while no other thread forces the node
+			lazy_slot* slot = nullptr;
+
+		protected:
+			explicit lazy_node(bool r) noexcept : ready(r) {}
+			~lazy_node() = default;
+
+			virtual void destroy() noexcept = 0;
+
+			void set_ready() noexcept {
+				ndeps = 0;
+				ready.store(true, std::memory_order_release);
+			}
+
+		private:
+			std::atomic<std::size_t> refs{1};
+			std::atomic<bool> ready;
+			unsigned char ndeps = 0;
+			lazy_node* deps[max_dependencies];
+		};
+
+		/*
+		 * Single allocation storage of a lazy computation.
+		 *
+		 * Keeps the reference count, the state tag and the thunk or computed
+		 * value in one block. The thunk is destroyed as soon as the value
+		 * has been computed, releasing anything it might have captured.
+		 *
+		 * Cells created with a memory resource are returned to it when the
+		 * last reference is dropped, others are simply deleted.
+		 */
+		// Tag used to construct a lazy_cell that is already computed
+		struct lazy_ready_t {};
+
+		template<typename T>
+		class lazy_cell final : public lazy_node {
+		public:
+			template<typename...Args>
+			explicit lazy_cell(lazy_ready_t, Args&&...args) : lazy_node(true) {
+				new (&value) T(std::forward<Args>(args)...);
+			}
+
+			explicit lazy_cell(unique_function<T()>&& f) noexcept
+			: lazy_node(false) {
+				new (&thunk) unique_function<T()>(std::move(f));
+			}
+
+			// Must be placed in memory allocated from r
+			lazy_cell(memory_resource* r, unique_function<T()>&& f) noexcept
+			: lazy_node(false), origin(r) {
+				new (&thunk) unique_function<T()>(std::move(f));
+			}
+
+			~lazy_cell() {
+				if(is_ready())
+					value.~T();
+				else
+					thunk.~unique_function();
+			}
+
+			const T& force() {
+				if(slot)
+					slot->claim(*slot);
+				else if(!is_ready())
+					compute();
+
+				return value;
+			}
+
+			void compute() override {
+				if(is_ready())
+					return;
+
+				auto f = std::move(thunk);
+				thunk.~unique_function();
+
+				try {
+					FTL_TRACE_SCOPE(lazy, label);
+					new (&value) T(f());
+				}
+				catch(...) {
+					new (&thunk) unique_function<T()>(std::move(f));
+					throw;
+				}
+
+				set_ready();
+			}
+
+			const T& get() const noexcept {
+				return value;
+			}
+
+			// Names the events of forcing the cell, if tracing
+			void set_label(trace_label l) noexcept {
+#ifdef FTL_TRACE
+				label = l.name;
+#else
+				(void)l;
+#endif
+			}
+
+			/*
+			 * Moves the thunk out of a deferred cell.
+			 *
+			 * Leaves the cell in a deferred state with an empty thunk, so
+			 * it must not be forced again afterwards.
+			 */
+			unique_function<T()> take_thunk() noexcept {
+				return std::move(thunk);
+			}
+
+			/// The resource the cell was allocated from, if any
+			memory_resource* resource() const noexcept {
+				return origin;
+			}
+
+		private:
+			void destroy() noexcept override {
+				if(memory_resource* r = origin) {
+					this->~lazy_cell();
+					r->deallocate(this, sizeof(lazy_cell), alignof(lazy_cell));
+				}
+				else
+					delete this;
+			}
+
+			memory_resource* origin = nullptr;
+#ifdef FTL_TRACE
+			const char* label = nullptr;
+#endif
+
+			union {
+				unique_function<T()> thunk;
+				T value;
+			};
+		};
+
+		/*
+		 * Intrusive, reference counted handle to a lazy_cell.
+		 */
+		template<typename T>
+		class lazy_ptr {
+		public:
+			lazy_ptr() noexcept = default;
+
+			explicit lazy_ptr(lazy_cell<T>* c) noexcept : cell(c) {}
+
+			lazy_ptr(const lazy_ptr& p) noexcept : cell(p.cell) {
+				if(cell)
+					cell->acquire();
+			}
+
+			lazy_ptr(lazy_ptr&& p) noexcept : cell(p.cell) {
+				p.cell = nullptr;
+			}
+
+			~lazy_ptr() {
+				if(cell)
+					cell->release();
+			}
+
+			lazy_ptr& operator= (lazy_ptr p) noexcept {
+				std::swap(cell, p.cell);
+				return *this;
+			}
+
+			lazy_cell<T>* operator->() const noexcept {
+				return cell;
+			}
+
+			lazy_cell<T>* get() const noexcept {
+				return cell;
+			}
+
+		private:
+			lazy_cell<T>* cell = nullptr;
+		};
+
+		template<typename T, typename F>
+		lazy_ptr<T> make_lazy_cell(F&& f) {
+			FTL_COUNT_ALLOCATION(lazy, sizeof(lazy_cell<T>));
+			return lazy_ptr<T>(new lazy_cell<T>(std::forward<F>(f)));
+		}
+
+		template<typename T, typename F>
+		lazy_ptr<T> make_lazy_cell(memory_resource* r, F&& f) {
+			void* p = r->allocate(sizeof(lazy_cell<T>), alignof(lazy_cell<T>));
+
+			try {
+				return lazy_ptr<T>(new (p) lazy_cell<T>(r, std::forward<F>(f)));
+			}
+			catch(...) {
+				r->deallocate(p, sizeof(lazy_cell<T>), alignof(lazy_cell<T>));
+				throw;
+			}
+		}
+
+		template<typename T, typename...Args>
+		lazy_ptr<T> make_ready_lazy_cell(Args&&...args) {
+			FTL_COUNT_ALLOCATION(lazy, sizeof(lazy_cell<T>));
+			return lazy_ptr<T>(
+				new lazy_cell<T>(lazy_ready_t{}, std::forward<Args>(args)...)
+			);
+		}
+	}
+}
+
+#endif
+
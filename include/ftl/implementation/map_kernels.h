@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_MAP_KERNELS_H
+#define FTL_MAP_KERNELS_H
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define FTL_RESTRICT __restrict
+#else
+#define FTL_RESTRICT
+#endif
+
+namespace ftl {
+	namespace _dtl {
+		/*
+		 * Element-wise loops over contiguous storage of numbers, used to map
+		 * and zip vectors of them.
+		 *
+		 * Rather than pushing results onto the output one at a time, the
+		 * output is sized up front and written through a pointer declared
+		 * not to alias the inputs. As with the fold kernels, the body then
+		 * handles several independent elements per iteration, which is what
+		 * lets compilers vectorise the loop once fn is inlined.
+		 *
+		 * A handful of standard function objects, such as std::plus, are
+		 * known to have a vector equivalent. With compilers supporting GNU
+		 * vector extensions, those are applied to whole simd_bytes wide
+		 * vectors explicitly, which does not depend on the optimiser
+		 * deciding to vectorise at all.
+		 */
+		template<typename T>
+		struct is_kernel_number : std::integral_constant<
+			bool, std::is_arithmetic<T>::value && !std::is_same<T,bool>::value
+		> {};
+
+		constexpr std::size_t map_kernel_lanes = 4;
+
+		template<typename Fn, typename T, typename U>
+		void map_kernel(
+				Fn& fn, const T* FTL_RESTRICT xs, U* FTL_RESTRICT out,
+				std::size_t n) {
+			const std::size_t m = n - n % map_kernel_lanes;
+
+			std::size_t i = 0;
+			for(; i < m; i += map_kernel_lanes) {
+				out[i] = fn(xs[i]);
+				out[i+1] = fn(xs[i+1]);
+				out[i+2] = fn(xs[i+2]);
+				out[i+3] = fn(xs[i+3]);
+			}
+
+			for(; i < n; ++i) {
+				out[i] = fn(xs[i]);
+			}
+		}
+
+		// Every element only ever aliases itself, so no restrict is needed
+		template<typename Fn, typename T>
+		void map_kernel_in_place(Fn& fn, T* xs, std::size_t n) {
+			const std::size_t m = n - n % map_kernel_lanes;
+
+			std::size_t i = 0;
+			for(; i < m; i += map_kernel_lanes) {
+				xs[i] = fn(xs[i]);
+				xs[i+1] = fn(xs[i+1]);
+				xs[i+2] = fn(xs[i+2]);
+				xs[i+3] = fn(xs[i+3]);
+			}
+
+			for(; i < n; ++i) {
+				xs[i] = fn(xs[i]);
+			}
+		}
+
+		template<typename Fn, typename T, typename T2, typename U>
+		void zip_kernel(
+				Fn& fn, const T* FTL_RESTRICT xs, const T2* FTL_RESTRICT ys,
+				U* FTL_RESTRICT out, std::size_t n) {
+			const std::size_t m = n - n % map_kernel_lanes;
+
+			std::size_t i = 0;
+			for(; i < m; i += map_kernel_lanes) {
+				out[i] = fn(xs[i], ys[i]);
+				out[i+1] = fn(xs[i+1], ys[i+1]);
+				out[i+2] = fn(xs[i+2], ys[i+2]);
+				out[i+3] = fn(xs[i+3], ys[i+3]);
+			}
+
+			for(; i < n; ++i) {
+				out[i] = fn(xs[i], ys[i]);
+			}
+		}
+
+		// Number types GNU vector extensions apply to
+		template<typename T>
+		struct is_simd_number : std::integral_constant<
+			bool,
+			(std::is_integral<T>::value && !std::is_same<T,bool>::value)
+			|| std::is_same<T,float>::value
+			|| std::is_same<T,double>::value
+		> {};
+
+		/*
+		 * Vector equivalent of Fn on elements of type T, if any.
+		 *
+		 * Only function objects taking and returning exactly T qualify, and
+		 * division only for floating point, which is the only kind with a
+		 * vector instruction to speak of.
+		 */
+		template<typename Fn, typename T>
+		struct simd_op {
+			static constexpr bool instance = false;
+		};
+
+		template<typename T>
+		struct simd_op<std::plus<T>,T> {
+			static constexpr bool instance = is_simd_number<T>::value;
+
+			template<typename V>
+			static V apply(const V& a, const V& b) {
+				return a + b;
+			}
+		};
+
+		template<typename T>
+		struct simd_op<std::minus<T>,T> {
+			static constexpr bool instance = is_simd_number<T>::value;
+
+			template<typename V>
+			static V apply(const V& a, const V& b) {
+				return a - b;
+			}
+		};
+
+		template<typename T>
+		struct simd_op<std::multiplies<T>,T> {
+			static constexpr bool instance = is_simd_number<T>::value;
+
+			template<typename V>
+			static V apply(const V& a, const V& b) {
+				return a * b;
+			}
+		};
+
+		template<typename T>
+		struct simd_op<std::divides<T>,T> {
+			static constexpr bool instance =
+				is_simd_number<T>::value && std::is_floating_point<T>::value;
+
+			template<typename V>
+			static V apply(const V& a, const V& b) {
+				return a / b;
+			}
+		};
+
+		template<typename T>
+		struct simd_op<std::negate<T>,T> {
+			static constexpr bool instance = is_simd_number<T>::value;
+
+			template<typename V>
+			static V apply(const V& a) {
+				return -a;
+			}
+		};
+
+#if __cplusplus >= 201402L
+		template<typename T>
+		struct simd_op<std::plus<>,T> : simd_op<std::plus<T>,T> {};
+
+		template<typename T>
+		struct simd_op<std::minus<>,T> : simd_op<std::minus<T>,T> {};
+
+		template<typename T>
+		struct simd_op<std::multiplies<>,T> : simd_op<std::multiplies<T>,T> {};
+
+		template<typename T>
+		struct simd_op<std::divides<>,T> : simd_op<std::divides<T>,T> {};
+
+		template<typename T>
+		struct simd_op<std::negate<>,T> : simd_op<std::negate<T>,T> {};
+#endif
+
+		// The vector equivalent of whatever kind of reference to Fn
+		template<typename Fn, typename T>
+		using simd_op_of = simd_op<typename std::decay<Fn>::type,T>;
+
+#ifdef __GNUC__
+		// Wider vectors than the target has would be passed around in memory
+#ifdef __AVX__
+		constexpr std::size_t simd_bytes = 32;
+#else
+		constexpr std::size_t simd_bytes = 16;
+#endif
+
+		template<typename T>
+		struct simd_vector {
+			typedef T type __attribute__((vector_size(simd_bytes)));
+			static constexpr std::size_t width = simd_bytes / sizeof(T);
+		};
+
+		/*
+		 * Vectors are loaded and stored with memcpy, as the storage of a
+		 * std::vector need not be aligned to simd_bytes. Compilers turn
+		 * those into unaligned vector moves.
+		 */
+		template<typename Op, typename T>
+		void simd_map_kernel(const T* xs, T* out, std::size_t n) {
+			using V = typename simd_vector<T>::type;
+			constexpr std::size_t w = simd_vector<T>::width;
+
+			const std::size_t m = n - n % w;
+
+			std::size_t i = 0;
+			for(; i < m; i += w) {
+				V a;
+				std::memcpy(&a, xs + i, sizeof(V));
+				V r = Op::apply(a);
+				std::memcpy(out + i, &r, sizeof(V));
+			}
+
+			for(; i < n; ++i) {
+				out[i] = Op::apply(xs[i]);
+			}
+		}
+
+		template<typename Op, typename T>
+		void simd_zip_kernel(const T* xs, const T* ys, T* out, std::size_t n) {
+			using V = typename simd_vector<T>::type;
+			constexpr std::size_t w = simd_vector<T>::width;
+
+			const std::size_t m = n - n % w;
+
+			std::size_t i = 0;
+			for(; i < m; i += w) {
+				V a, b;
+				std::memcpy(&a, xs + i, sizeof(V));
+				std::memcpy(&b, ys + i, sizeof(V));
+				V r = Op::apply(a, b);
+				std::memcpy(out + i, &r, sizeof(V));
+			}
+
+			for(; i < n; ++i) {
+				out[i] = Op::apply(xs[i], ys[i]);
+			}
+		}
+
+		// Whether Fn on T has a vector equivalent, yielding U
+		template<typename Fn, typename T, typename U>
+		struct has_simd_kernel : std::integral_constant<
+			bool,
+			simd_op_of<Fn,T>::instance && std::is_same<T,U>::value
+		> {};
+#else
+		template<typename Fn, typename T, typename U>
+		struct has_simd_kernel : std::false_type {};
+#endif
+
+		template<typename Fn, typename T, typename U>
+		void map_numbers(
+				Fn& fn, const T* xs, U* out, std::size_t n, std::false_type) {
+			map_kernel(fn, xs, out, n);
+		}
+
+		template<typename Fn, typename T, typename U>
+		void map_numbers(
+				Fn& fn, const T* xs, U* out, std::size_t n, std::true_type) {
+#ifdef __GNUC__
+			(void)fn;
+			simd_map_kernel<simd_op_of<Fn,T>>(xs, out, n);
+#else
+			map_kernel(fn, xs, out, n);
+#endif
+		}
+
+		// Map fn over [xs, xs+n) into out, which must not overlap it
+		template<typename Fn, typename T, typename U>
+		void map_numbers(Fn& fn, const T* xs, U* out, std::size_t n) {
+			map_numbers(fn, xs, out, n, has_simd_kernel<Fn,T,U>{});
+		}
+
+		template<typename Fn, typename T>
+		void map_numbers_in_place(Fn& fn, T* xs, std::size_t n, std::false_type) {
+			map_kernel_in_place(fn, xs, n);
+		}
+
+		template<typename Fn, typename T>
+		void map_numbers_in_place(Fn& fn, T* xs, std::size_t n, std::true_type) {
+#ifdef __GNUC__
+			(void)fn;
+			simd_map_kernel<simd_op_of<Fn,T>>(xs, xs, n);
+#else
+			map_kernel_in_place(fn, xs, n);
+#endif
+		}
+
+		// Replace every element of [xs, xs+n) with the result of fn on it
+		template<typename Fn, typename T>
+		void map_numbers_in_place(Fn& fn, T* xs, std::size_t n) {
+			map_numbers_in_place(fn, xs, n, has_simd_kernel<Fn,T,T>{});
+		}
+
+		template<typename Fn, typename T, typename T2, typename U>
+		void zip_numbers(
+				Fn& fn, const T* xs, const T2* ys, U* out, std::size_t n,
+				std::false_type) {
+			zip_kernel(fn, xs, ys, out, n);
+		}
+
+		template<typename Fn, typename T, typename T2, typename U>
+		void zip_numbers(
+				Fn& fn, const T* xs, const T2* ys, U* out, std::size_t n,
+				std::true_type) {
+#ifdef __GNUC__
+			(void)fn;
+			simd_zip_kernel<simd_op_of<Fn,T>>(xs, ys, out, n);
+#else
+			zip_kernel(fn, xs, ys, out, n);
+#endif
+		}
+
+		// Zip xs and ys with fn into out, which must overlap neither
+		template<typename Fn, typename T, typename T2, typename U>
+		void zip_numbers(
+				Fn& fn, const T* xs, const T2* ys, U* out, std::size_t n) {
+			zip_numbers(
+				fn, xs, ys, out, n,
+				std::integral_constant<
+					bool,
+					has_simd_kernel<Fn,T,U>::value
+					&& std::is_same<T,T2>::value
+				>{}
+			);
+		}
+	}
+}
+
+#endif
@@ -24,6 +24,7 @@
 #define FTL_MAYBE_ITERATOR_H
 
 #include <memory>
+#include <type_traits>
 
 namespace ftl {
 	template<typename...Ts>
@@ -41,7 +42,12 @@ namespace ftl {
 
 		template<typename T>
 		class maybe_iterator
-		: public std::iterator<std::forward_iterator_tag,T> {
+		: public std::iterator<
+			std::forward_iterator_tag, typename std::remove_reference<T>::type
+		> {
+			// For maybe<T&>, iterate over the referent
+			using V = typename std::remove_reference<T>::type;
+
 		public:
 			maybe_iterator() = default;
 			maybe_iterator(const maybe_iterator&) = default;
@@ -62,11 +68,11 @@ namespace ftl {
 				return it;
 			}
 
-			constexpr T& operator* () const {
+			constexpr V& operator* () const {
 				return get<T>(*this->ref);
 			}
 
-			constexpr T* operator-> () const {
+			constexpr V* operator-> () const {
 				return std::addressof(get<T>(*this->ref));
 			}
 
@@ -87,7 +93,12 @@ namespace ftl {
 
 		template<typename T>
 		class const_maybe_iterator
-		: public std::iterator<std::forward_iterator_tag,T> {
+		: public std::iterator<
+			std::forward_iterator_tag, typename std::remove_reference<T>::type
+		> {
+			// For maybe<T&>, iterate over the referent
+			using V = typename std::remove_reference<T>::type;
+
 		public:
 			const_maybe_iterator() = default;
 			const_maybe_iterator(const const_maybe_iterator&) = default;
@@ -109,11 +120,11 @@ namespace ftl {
 				return it;
 			}
 
-			constexpr const T& operator* () const {
+			constexpr const V& operator* () const {
 				return get<T>(*this->ref);
 			}
 
-			constexpr const T* operator-> () const {
+			constexpr const V* operator-> () const {
 				return std::addressof(get<T>(*this->ref));
 			}
 
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_MIX_HASH_H
+#define FTL_MIX_HASH_H
+
+#include <cstddef>
+
+namespace ftl {
+	namespace _dtl {
+		// Spreads all the bits of weak hashes (e.g. the identity) about
+		inline std::size_t mix_hash(std::size_t h) noexcept {
+			h *= static_cast<std::size_t>(0x9E3779B97F4A7C15ull);
+			return h ^ (h >> (sizeof(std::size_t) * 4));
+		}
+
+		// Order dependent combination of the hash of one more value
+		inline std::size_t hash_combine(std::size_t seed, std::size_t h)
+		noexcept {
+			h += static_cast<std::size_t>(0x9E3779B97F4A7C15ull)
+				+ (seed << 6) + (seed >> 2);
+			return mix_hash(seed ^ h);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_SORTED_VECTOR_H
+#define FTL_SORTED_VECTOR_H
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+namespace ftl {
+	namespace _dtl {
+		/*
+		 * Algorithms shared by the containers that keep their elements in a
+		 * sorted vector, without duplicates. Cmp is always a strict weak
+		 * ordering of whole elements. Wherever elements compare equivalent,
+		 * the one that was first in the container or range is kept, just as
+		 * with std::set::insert.
+		 */
+
+		// Sorts and removes duplicates from an arbitrary vector, taking
+		// the linear fast path if it happens to already be sorted.
+		template<typename V, typename Cmp>
+		void sort_unique(V& v, const Cmp& cmp) {
+			using T = typename V::value_type;
+
+			if(!std::is_sorted(v.begin(), v.end(), cmp))
+				std::stable_sort(v.begin(), v.end(), cmp);
+
+			v.erase(
+				std::unique(
+					v.begin(), v.end(),
+					[&cmp](const T& a, const T& b) { return !cmp(a, b); }
+				),
+				v.end()
+			);
+		}
+
+		// Linear union of two sorted, duplicate free vectors
+		template<typename V, typename Cmp>
+		V merge_unique(const V& a, const V& b, const Cmp& cmp) {
+			V r(a.get_allocator());
+			r.reserve(a.size() + b.size());
+			std::set_union(
+				a.begin(), a.end(), b.begin(), b.end(),
+				std::back_inserter(r), cmp
+			);
+
+			return r;
+		}
+
+		template<typename V, typename Cmp>
+		V merge_unique(V&& a, const V& b, const Cmp& cmp) {
+			// Nothing new would be added, so a is the result as is
+			if(b.empty())
+				return std::move(a);
+
+			V r(a.get_allocator());
+			r.reserve(a.size() + b.size());
+			std::set_union(
+				std::make_move_iterator(a.begin()),
+				std::make_move_iterator(a.end()),
+				b.begin(), b.end(),
+				std::back_inserter(r), cmp
+			);
+
+			return r;
+		}
+
+		template<typename V, typename Cmp>
+		V merge_unique(const V& a, V&& b, const Cmp& cmp) {
+			if(a.empty())
+				return std::move(b);
+
+			V r(b.get_allocator());
+			r.reserve(a.size() + b.size());
+			std::set_union(
+				a.begin(), a.end(),
+				std::make_move_iterator(b.begin()),
+				std::make_move_iterator(b.end()),
+				std::back_inserter(r), cmp
+			);
+
+			return r;
+		}
+
+		template<typename V, typename Cmp>
+		V merge_unique(V&& a, V&& b, const Cmp& cmp) {
+			if(b.empty())
+				return std::move(a);
+			if(a.empty())
+				return std::move(b);
+
+			V r(a.get_allocator());
+			r.reserve(a.size() + b.size());
+			std::set_union(
+				std::make_move_iterator(a.begin()),
+				std::make_move_iterator(a.end()),
+				std::make_move_iterator(b.begin()),
+				std::make_move_iterator(b.end()),
+				std::back_inserter(r), cmp
+			);
+
+			return r;
+		}
+
+		// Incorporates the unordered range [first, last) into the sorted v
+		template<typename V, typename It, typename Cmp>
+		void insert_unique(V& v, It first, It last, const Cmp& cmp) {
+			V tail(first, last, v.get_allocator());
+			sort_unique(tail, cmp);
+			v = merge_unique(std::move(v), std::move(tail), cmp);
+		}
+	}
+}
+
+#endif
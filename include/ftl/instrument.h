@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_INSTRUMENT_H
+#define FTL_INSTRUMENT_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace ftl {
+	/**
+	 * \defgroup instrument Instrumentation
+	 *
+	 * Opt-in counting of the heap allocations made by ftl itself.
+	 *
+	 * When `FTL_INSTRUMENT_ALLOCATIONS` is defined, every allocation made on
+	 * behalf of an ftl component&mdash;a lazy cell, an `ftl::function` that
+	 * does not fit its small buffer, the shared state of a promise, and so
+	 * on&mdash;is tallied against that component. Otherwise the hooks expand
+	 * to nothing and all counts stay zero.
+	 *
+	 * The macro must be defined the same way in every translation unit of a
+	 * program, typically on the compiler's command line.
+	 *
+	 * Counts cover the object requested; the control block of a
+	 * `std::shared_ptr` and allocations made by standard containers on
+	 * ftl's behalf are not included.
+	 *
+	 * \code
+	 *   #include <ftl/instrument.h>
+	 * \endcode
+	 *
+	 * \par Examples
+	 *
+	 * Verifying that an expression does not allocate:
+	 * \code
+	 *   ftl::reset_allocation_counts();
+	 *   ftl::function<int(int)> f = [](int x){ return x+1; };
+	 *   assert(ftl::allocation_count(ftl::alloc_source::function).allocations == 0);
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<atomic>`
+	 * - `<cstddef>`
+	 */
+
+	/**
+	 * The components allocations are counted against.
+	 *
+	 * \ingroup instrument
+	 */
+	enum class alloc_source : unsigned char {
+		/// Heap storage of `ftl::function` and `ftl::unique_function`
+		function,
+		/// Cells of `ftl::lazy`, `ftl::shared_lazy` and the lazy transformers
+		lazy,
+		/// Shared states of promises, futures, joins, channels and cancellation
+		async,
+		/// Jobs of the parallel algorithms
+		parallel,
+		/// Nodes of `ftl::trampoline` and continuations of `ftl::codensity`
+		monad,
+		/// Nodes of the persistent containers
+		persistent,
+		/// Tables of `ftl::hash_map`
+		hash_map,
+		/// Memory handed out by `ftl::new_delete_resource()`
+		memory_resource,
+		/// Heap storage of `ftl::small_vector`s beyond their inline capacity
+		small_vector
+	};
+
+	/// Number of distinct ftl::alloc_source values
+	constexpr std::size_t alloc_sources = 9;
+
+	/**
+	 * Whether allocations are being counted in this build.
+	 *
+	 * \ingroup instrument
+	 */
+#ifdef FTL_INSTRUMENT_ALLOCATIONS
+	constexpr bool allocation_counting = true;
+#else
+	constexpr bool allocation_counting = false;
+#endif
+
+	/**
+	 * Number of allocations and bytes counted against a component.
+	 *
+	 * \ingroup instrument
+	 */
+	struct allocation_stats {
+		std::size_t allocations;
+		std::size_t bytes;
+	};
+
+	/**
+	 * Human readable name of a component, as used by `report_allocations`.
+	 *
+	 * \ingroup instrument
+	 */
+	inline const char* alloc_source_name(alloc_source s) noexcept {
+		static const char* const names[alloc_sources] = {
+			"function", "lazy", "async", "parallel",
+			"monad", "persistent", "hash_map", "memory_resource",
+			"small_vector"
+		};
+
+		return names[static_cast<std::size_t>(s)];
+	}
+
+	namespace _dtl {
+		struct allocation_counter {
+			std::atomic<std::size_t> allocations;
+			std::atomic<std::size_t> bytes;
+		};
+
+		inline allocation_counter* allocation_counters() noexcept {
+			static allocation_counter counters[alloc_sources] = {};
+			return counters;
+		}
+
+		inline void count_allocation(alloc_source s, std::size_t bytes) noexcept {
+			auto& c = allocation_counters()[static_cast<std::size_t>(s)];
+			c.allocations.fetch_add(1, std::memory_order_relaxed);
+			c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * Allocations counted against `s` since the last reset.
+	 *
+	 * Always zero unless `FTL_INSTRUMENT_ALLOCATIONS` is defined.
+	 *
+	 * \ingroup instrument
+	 */
+	inline allocation_stats allocation_count(alloc_source s) noexcept {
+		auto& c = _dtl::allocation_counters()[static_cast<std::size_t>(s)];
+		return allocation_stats{
+			c.allocations.load(std::memory_order_relaxed),
+			c.bytes.load(std::memory_order_relaxed)
+		};
+	}
+
+	/**
+	 * Allocations counted against all components since the last reset.
+	 *
+	 * \ingroup instrument
+	 */
+	inline allocation_stats total_allocation_count() noexcept {
+		allocation_stats r{0, 0};
+		for(std::size_t i = 0; i < alloc_sources; ++i) {
+			auto s = allocation_count(static_cast<alloc_source>(i));
+			r.allocations += s.allocations;
+			r.bytes += s.bytes;
+		}
+
+		return r;
+	}
+
+	/**
+	 * Set the counts of all components back to zero.
+	 *
+	 * \ingroup instrument
+	 */
+	inline void reset_allocation_counts() noexcept {
+		for(std::size_t i = 0; i < alloc_sources; ++i) {
+			auto& c = _dtl::allocation_counters()[i];
+			c.allocations.store(0, std::memory_order_relaxed);
+			c.bytes.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * Write the non-zero counts, one component per line, to a stream.
+	 *
+	 * \tparam OStream any type with `std::ostream`'s `operator<<`
+	 *
+	 * \ingroup instrument
+	 */
+	template<typename OStream>
+	OStream& report_allocations(OStream& os) {
+		for(std::size_t i = 0; i < alloc_sources; ++i) {
+			auto s = static_cast<alloc_source>(i);
+			auto n = allocation_count(s);
+			if(n.allocations == 0)
+				continue;
+
+			os << alloc_source_name(s) << ": " << n.allocations
+				<< " allocations, " << n.bytes << " bytes\n";
+		}
+
+		return os;
+	}
+}
+
+/**
+ * Count an allocation of `bytes` bytes against component `source`.
+ *
+ * `source` is the name of an ftl::alloc_source value. Expands to nothing
+ * unless `FTL_INSTRUMENT_ALLOCATIONS` is defined.
+ *
+ * \ingroup instrument
+ */
+#ifdef FTL_INSTRUMENT_ALLOCATIONS
+#define FTL_COUNT_ALLOCATION(source, bytes) \
+	::ftl::_dtl::count_allocation(::ftl::alloc_source::source, (bytes))
+#else
+#define FTL_COUNT_ALLOCATION(source, bytes) ((void)0)
+#endif
+
+#endif
+
@@ -23,10 +23,12 @@
 #ifndef FTL_LAZY_H
 #define FTL_LAZY_H
 
+#include <functional>
 #include <memory>
 #include "prelude.h"
 #include "concepts/monoid.h"
 #include "either.h"
+#include "implementation/lazy_cell.h"
 
 namespace ftl {
 	/**
@@ -42,6 +44,8 @@ namespace ftl {
 	 * - \ref prelude
 	 * - \ref monoid
 	 * - \ref either
+	 * - \ref memory_resource
+	 * - \ref trace
 	 */
 
 	/**
@@ -58,6 +62,10 @@ namespace ftl {
 		ready
 	};
 
+	namespace _dtl {
+		struct lazy_access;
+	}
+
 	/**
 	 * The lazy data type.
 	 *
@@ -69,7 +77,9 @@ namespace ftl {
 	 * refer to a shared object representing either the computed value, or the
 	 * computation that will yield the value. Hence, the computation will only
 	 * be made _once_ for every set of copies ultimately derived from the same
-	 * source.
+	 * source. This shared object is allocated in a single block, and the
+	 * computation&mdash;along with anything it captured&mdash;is destroyed as
+	 * soon as the value has been computed.
 	 *
 	 * If no instance of a particular computation ever forces it, then it simply
 	 * won't be evaluated at all.
@@ -113,9 +123,45 @@ namespace ftl {
 		 * object will be invoked to compute it. Any subsequent calls to methods
 		 * that would normally force evaluation will simply use the now computed
 		 * value.
+		 *
+		 * As the function object is invoked at most once, it need not be
+		 * copyable.
+		 */
+		explicit lazy(unique_function<T()> f)
+		: cell(_dtl::make_lazy_cell<T>(std::move(f)))
+		{}
+
+		/**
+		 * Construct from a function object, labelling the computation.
+		 *
+		 * Otherwise equivalent of `lazy(unique_function<T()>)`. `l` names
+		 * the trace events of forcing the value, and is ignored unless
+		 * `FTL_TRACE` is defined.
+		 *
+		 * \see \ref trace
+		 */
+		lazy(trace_label l, unique_function<T()> f)
+		: lazy(std::move(f)) {
+			cell->set_label(l);
+		}
+
+		/**
+		 * Construct from a function object, allocating from a memory resource.
+		 *
+		 * The internal state, and the function object if it does not fit in
+		 * place, are allocated from `alloc.resource()`. So are any lazy
+		 * computations derived from this one by `map`, `apply` or `bind`,
+		 * meaning a whole graph of them can be allocated from e.g. one
+		 * ftl::monotonic_buffer_resource.
+		 *
+		 * The resource must outlive every computation allocated from it.
 		 */
-		explicit lazy(const function<T()>& f)
-		: val(new either<function<T()>,T>(make_left<T>(f)))
+		template<typename A, typename F>
+		lazy(std::allocator_arg_t, const resource_allocator<A>& alloc, F f)
+		: cell(_dtl::make_lazy_cell<T>(
+			alloc.resource(),
+			unique_function<T()>(std::allocator_arg, alloc, std::move(f))
+		))
 		{}
 
 		/**
@@ -124,8 +170,7 @@ namespace ftl {
 		 * This method forces evaluation.
 		 */
 		const T& operator*() const {
-			force();
-			return *get<1>(*val);
+			return cell->force();
 		}
 
 		/**
@@ -134,11 +179,7 @@ namespace ftl {
 		 * This method forces evaluation.
 		 */
 		const T* operator->() const {
-			if(val->template is<Right<T>>())
-				return std::addressof(*get<1>(*val));
-
-			force();
-			return std::addressof(*get<1>(*val));
+			return std::addressof(cell->force());
 		}
 
 		lazy& operator= (const lazy&) = default;
@@ -150,22 +191,20 @@ namespace ftl {
 		 * \return value_status::deferred if computation has not yet been run,
 		 *         and value_status::ready if it has.
 		 */
-		value_status status() const {
-			if(val->template is<Right<T>>())
+		value_status status() const noexcept {
+			if(cell->is_ready())
 				return value_status::ready;
 
 			return value_status::deferred;
 		}
 
 	private:
-		void force() const {
-			if(val->template is<Right<T>>())
-				return;
+		friend struct monad<lazy<T>>;
+		friend struct _dtl::lazy_access;
 
-			*val = make_right<function<T()>>((*get<0>(*val))());
-		}
+		explicit lazy(_dtl::lazy_ptr<T>&& c) noexcept : cell(std::move(c)) {}
 
-		mutable std::shared_ptr<either<function<T()>,T>> val;
+		_dtl::lazy_ptr<T> cell;
 	};
 
 	// Bool specialisation to allow contextual conversion
@@ -177,41 +216,105 @@ namespace ftl {
 		lazy(lazy&&) = default;
 		~lazy() = default;
 
-		explicit lazy(const function<bool()>& f)
-		: val(new either<function<bool()>,bool>(make_left<bool>(f)))
+		explicit lazy(unique_function<bool()> f)
+		: cell(_dtl::make_lazy_cell<bool>(std::move(f)))
+		{}
+
+		lazy(trace_label l, unique_function<bool()> f)
+		: lazy(std::move(f)) {
+			cell->set_label(l);
+		}
+
+		template<typename A, typename F>
+		lazy(std::allocator_arg_t, const resource_allocator<A>& alloc, F f)
+		: cell(_dtl::make_lazy_cell<bool>(
+			alloc.resource(),
+			unique_function<bool()>(std::allocator_arg, alloc, std::move(f))
+		))
 		{}
 
 		const bool& operator*() const {
-			force();
-			return *get<Right<bool>>(*val);
+			return cell->force();
 		}
 
 		lazy& operator= (const lazy&) = default;
 		lazy& operator= (lazy&&) = default;
 
 		explicit operator bool() {
-			force();
-			return *get<Right<bool>>(*val);
+			return cell->force();
 		}
 
-		value_status status() const {
-			if(val->is<Right<bool>>())
+		value_status status() const noexcept {
+			if(cell->is_ready())
 				return value_status::ready;
 
 			return value_status::deferred;
 		}
 
 	private:
-		void force() const {
-			if(val->is<Right<bool>>())
-				return;
+		friend struct monad<lazy<bool>>;
+		friend struct _dtl::lazy_access;
 
-			*val = make_right<function<bool()>>((*get<0>(*val))());
-		}
+		explicit lazy(_dtl::lazy_ptr<bool>&& c) noexcept : cell(std::move(c)) {}
 
-		mutable std::shared_ptr<either<function<bool()>,bool>> val;
+		_dtl::lazy_ptr<bool> cell;
 	};
 
+	namespace _dtl {
+		// Reaches the cells of lazy values, for scheduling them
+		struct lazy_access {
+			template<typename T>
+			static lazy_node* node(const lazy<T>& l) noexcept {
+				return l.cell.get();
+			}
+
+			template<typename U>
+			static const lazy_node* dependency(const lazy<U>& l) noexcept {
+				return node(l);
+			}
+
+			template<typename U>
+			static const lazy_node* dependency(const U&) noexcept {
+				return nullptr;
+			}
+		};
+
+		/*
+		 * The cells of whichever of a set of arguments are lazy values.
+		 *
+		 * Taken before the arguments are moved into a thunk, and recorded
+		 * as dependencies of the result afterwards.
+		 */
+		template<std::size_t N>
+		struct lazy_dependencies {
+			template<typename...Args>
+			explicit lazy_dependencies(const Args&...args) noexcept
+			: nodes{lazy_access::dependency(args)...} {}
+
+			template<typename T>
+			void record(const lazy<T>& l) const noexcept {
+				for(auto n : nodes)
+					lazy_access::node(l)->depend_on(n);
+			}
+
+			const lazy_node* nodes[N+1];
+		};
+
+		// Defers f, allocating from r unless it is null
+		template<typename T, typename F>
+		lazy<T> defer_on(memory_resource* r, F&& f) {
+			if(r) {
+				return lazy<T>{
+					std::allocator_arg,
+					resource_allocator<T>(r),
+					std::forward<F>(f)
+				};
+			}
+
+			return lazy<T>{unique_function<T()>{std::forward<F>(f)}};
+		}
+	}
+
 	/**
 	 * Create a lazy computation from an arbitrary function.
 	 *
@@ -229,83 +332,252 @@ namespace ftl {
 	template<
 			typename F,
 			typename...Args,
+			typename = Requires<
+				!std::is_same<F,std::allocator_arg_t>::value
+				&& !std::is_same<F,trace_label>::value
+			>,
 			typename T = result_of<F(Args...)>
 	>
 	lazy<T> defer(F f, Args&&...args) {
 		// TODO: C++14: _move_ tuple of args into lambda
 		// TODO: Make this work with zero-argument fs
+		_dtl::lazy_dependencies<sizeof...(Args)> deps(args...);
+		auto t = std::make_tuple(std::forward<Args>(args)...);
+		lazy<T> r{[f,t]() {
+				return tuple_apply(f, t);
+		}};
+
+		deps.record(r);
+		return r;
+	}
+
+	/**
+	 * Create a labelled lazy computation.
+	 *
+	 * Otherwise equivalent of the regular `defer`.
+	 *
+	 * \see lazy::lazy(trace_label, unique_function<T()>)
+	 *
+	 * \ingroup lazy
+	 */
+	template<
+			typename L,
+			typename F,
+			typename...Args,
+			typename = Requires<std::is_same<L,trace_label>::value>,
+			typename T = result_of<F(Args...)>
+	>
+	lazy<T> defer(L l, F f, Args&&...args) {
+		_dtl::lazy_dependencies<sizeof...(Args)> deps(args...);
+		auto t = std::make_tuple(std::forward<Args>(args)...);
+		lazy<T> r{l, [f,t]() {
+				return tuple_apply(f, t);
+		}};
+
+		deps.record(r);
+		return r;
+	}
+
+	/**
+	 * Create a lazy computation allocated from a memory resource.
+	 *
+	 * Otherwise equivalent of the regular `defer`.
+	 *
+	 * \see lazy::lazy(std::allocator_arg_t, const resource_allocator<A>&, F)
+	 *
+	 * \ingroup lazy
+	 */
+	template<
+			typename A,
+			typename F,
+			typename...Args,
+			typename T = result_of<F(Args...)>
+	>
+	lazy<T> defer(
+			std::allocator_arg_t,
+			const resource_allocator<A>& alloc,
+			F f,
+			Args&&...args
+	) {
+		_dtl::lazy_dependencies<sizeof...(Args)> deps(args...);
 		auto t = std::make_tuple(std::forward<Args>(args)...);
-		return lazy<T>{[f,t]() {
+		lazy<T> r{std::allocator_arg, alloc, [f,t]() {
 				return tuple_apply(f, t);
 		}};
+
+		deps.record(r);
+		return r;
+	}
+
+	namespace _dtl {
+		// Deferred form of a comparison, for when one is explicitly kept
+		template<typename T, typename Cmp>
+		struct lazy_compare_thunk {
+			bool operator() () const {
+				return Cmp()(*l1, *l2);
+			}
+
+			lazy<T> l1;
+			lazy<T> l2;
+		};
 	}
 
+	/**
+	 * Result of comparing two lazy values.
+	 *
+	 * Comparisons of lazy values do not immediately yield a `lazy<bool>`, as
+	 * that would mean allocating a new computation every time, including
+	 * the common case of a comparison that is forced right away. Instead,
+	 * they yield one of these, which holds on to the two operands without
+	 * evaluating any of them.
+	 *
+	 * Converting to `bool`, or dereferencing, forces both operands and
+	 * compares them on the spot; nothing is allocated or memoised. This is
+	 * what happens in e.g. `if(l1 < l2)`, and when sorting a container of
+	 * lazy values. Converting to a `lazy<bool>` instead defers the
+	 * comparison, and is the only time a new computation is allocated.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto l1 = ftl::defer(f, 1);
+	 *   auto l2 = ftl::defer(f, 2);
+	 *
+	 *   // Evaluates both, allocates nothing
+	 *   if(l1 < l2) { ... }
+	 *
+	 *   // Evaluates nothing, yet
+	 *   ftl::lazy<bool> b = l1 == l2;
+	 * \endcode
+	 *
+	 * \ingroup lazy
+	 */
+	template<typename T, typename Cmp>
+	class lazy_comparison {
+	public:
+		lazy_comparison(lazy<T> l1, lazy<T> l2) noexcept
+		: l1(std::move(l1)), l2(std::move(l2)) {}
+
+		/// Force both operands and compare them
+		bool operator*() const {
+			return Cmp()(*l1, *l2);
+		}
+
+		/**
+		 * \copydoc operator*()
+		 *
+		 * Implicit, so that lazy values may be compared wherever a `bool`
+		 * is expected, such as by `std::sort`.
+		 */
+		operator bool() const {
+			return **this;
+		}
+
+		/// Defer the comparison
+		operator lazy<bool>() const& {
+			lazy<bool> b{unique_function<bool()>{
+				_dtl::lazy_compare_thunk<T,Cmp>{l1, l2}
+			}};
+
+			_dtl::lazy_dependencies<2>(l1, l2).record(b);
+			return b;
+		}
+
+		/// \overload
+		operator lazy<bool>() && {
+			_dtl::lazy_dependencies<2> deps(l1, l2);
+			lazy<bool> b{unique_function<bool()>{
+				_dtl::lazy_compare_thunk<T,Cmp>{std::move(l1), std::move(l2)}
+			}};
+
+			deps.record(b);
+			return b;
+		}
+
+	private:
+		lazy<T> l1;
+		lazy<T> l2;
+	};
+
 	/**
 	 * Equality comparison.
 	 *
-	 * Does not evaluate `l1` or `l2` until the returned computation is
-	 * itself evaluated.
+	 * Neither `l1` nor `l2` is evaluated until the result is converted to
+	 * `bool`, or, if it is converted to a `lazy<bool>`, until that is.
 	 *
 	 * \tparam T must have an `operator==`.
 	 *
+	 * \see lazy_comparison
+	 *
 	 * \ingroup lazy
 	 */
 	template<typename T>
-	lazy<bool> operator==(lazy<T> l1, lazy<T> l2) {
-		return lazy<bool>{[l1,l2]() {
-			return *l1 == *l2;
-		}};
+	lazy_comparison<T,std::equal_to<T>> operator==(lazy<T> l1, lazy<T> l2) {
+		return {std::move(l1), std::move(l2)};
 	}
 
 	/**
 	 * Not equal comparison.
 	 *
-	 * Does not evaluate `l1` or `l2` until the returned computation is
-	 * itself evaluated.
+	 * Neither `l1` nor `l2` is evaluated until the result is converted to
+	 * `bool`, or, if it is converted to a `lazy<bool>`, until that is.
 	 *
 	 * \tparam T must have an `operator!=`.
 	 *
+	 * \see lazy_comparison
+	 *
 	 * \ingroup lazy
 	 */
 	template<typename T>
-	lazy<bool> operator!=(lazy<T> l1, lazy<T> l2) {
-		return lazy<bool>{[l1,l2]() {
-			return *l1 != *l2;
-		}};
+	lazy_comparison<T,std::not_equal_to<T>> operator!=(lazy<T> l1, lazy<T> l2) {
+		return {std::move(l1), std::move(l2)};
 	}
 
 	/**
 	 * Less than comparison
 	 *
-	 * Does not evaluate `lhs` or `rhs` until the returned computation is
-	 * itself evaluated.
+	 * Neither `lhs` nor `rhs` is evaluated until the result is converted to
+	 * `bool`, or, if it is converted to a `lazy<bool>`, until that is.
 	 *
 	 * \tparam T must have an `operator<`.
 	 *
+	 * \see lazy_comparison
+	 *
 	 * \ingroup lazy
 	 */
 	template<typename T>
-	lazy<bool> operator< (lazy<T> lhs, lazy<T> rhs) {
-		return lazy<bool>{[lhs,rhs]() {
-			return *lhs < *rhs;
-		}};
+	lazy_comparison<T,std::less<T>> operator< (lazy<T> lhs, lazy<T> rhs) {
+		return {std::move(lhs), std::move(rhs)};
 	}
 
 	/**
 	 * Greater than comparison
 	 *
-	 * Does not evaluate `lhs` or `rhs` until the returned computation is
-	 * itself evaluated.
+	 * Neither `lhs` nor `rhs` is evaluated until the result is converted to
+	 * `bool`, or, if it is converted to a `lazy<bool>`, until that is.
 	 *
 	 * \tparam T must have an `operator>`.
 	 *
+	 * \see lazy_comparison
+	 *
 	 * \ingroup lazy
 	 */
 	template<typename T>
-	lazy<bool> operator> (lazy<T> lhs, lazy<T> rhs) {
-		return lazy<bool>{[lhs,rhs]() {
-			return *lhs > *rhs;
-		}};
+	lazy_comparison<T,std::greater<T>> operator> (lazy<T> lhs, lazy<T> rhs) {
+		return {std::move(lhs), std::move(rhs)};
+	}
+
+	namespace _dtl {
+		// Thunk of two fused lazy computations
+		template<typename F, typename T, typename U>
+		struct lazy_compose {
+			U operator() () const {
+				return f(g());
+			}
+
+			F f;
+			unique_function<T()> g;
+		};
 	}
 
 	/**
@@ -314,23 +586,29 @@ namespace ftl {
 	 * Allows users to build "thunks" of computations, all left uncomputed until
 	 * forced.
 	 *
+	 * Chains of `map` are fused whenever possible: mapping a function over a
+	 * temporary, not yet computed `lazy` that has no other copies does not
+	 * keep the intermediate computation around. Instead, its thunk is composed
+	 * with the mapped function, and intermediate results are passed along as
+	 * temporaries rather than memoised and copied.
+	 *
 	 * \ingroup lazy
 	 */
 	template<typename T>
 	struct monad<lazy<T>>
-   	: deriving_join<in_terms_of_bind<lazy<T>>>
-	, deriving_apply<in_terms_of_bind<lazy<T>>> {
+	: deriving_join<in_terms_of_bind<lazy<T>>> {
 		/**
 		 * Create a computation that computes `t`
 		 *
 		 * Sounds a bit silly&mdash;we already know `t` after all&mdash;but
 		 * there are situations when it can be useful (e.g. algorithms
 		 * generalised over any monad).
+		 *
+		 * The returned `lazy` is, naturally, already computed.
 		 */
 		static lazy<T> pure(T t) {
-			return lazy<T>{[t](){ return t; }};
+			return lazy<T>{_dtl::make_ready_lazy_cell<T>(std::move(t))};
 		}
-		// TODO: C++14: Add a pure that captures Ts by move
 
 		/**
 		 * Map a function to the deferred value.
@@ -340,10 +618,50 @@ namespace ftl {
 		 * the computation of `l` until someone forces the _returned_ lazy
 		 * copmutation (though technically, `l` could be forced by another,
 		 * independant computation ahead of that).
+		 *
+		 * If `l` is a deferred computation that is not shared with any other
+		 * `lazy`, it is fused into the returned computation.
+		 *
+		 * The returned computation is allocated from the same memory resource
+		 * as `l`, if any.
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static lazy<U> map(F f, lazy<T> l) {
-			return lazy<U>{function<U()>{[f,l]() { return f(*l); }}};
+			memory_resource* r = l.cell->resource();
+
+			if(l.cell->unique() && !l.cell->is_ready()) {
+				auto u = _dtl::defer_on<U>(
+					r,
+					_dtl::lazy_compose<F,T,U>{
+						std::move(f), l.cell->take_thunk()
+					}
+				);
+
+				_dtl::lazy_access::node(u)->inherit(*l.cell.get());
+				return u;
+			}
+
+			auto u = _dtl::defer_on<U>(r, [f,l]() { return f(*l); });
+			_dtl::lazy_access::node(u)->depend_on(l.cell.get());
+			return u;
+		}
+
+		/**
+		 * Apply a deferred function to a deferred value.
+		 *
+		 * If the function is already computed, e.g. because it was created
+		 * using `pure`, this is equivalent of mapping it over `l`, meaning
+		 * `l` may be fused as described for `map`.
+		 */
+		template<typename F, typename U = result_of<F(T)>>
+		static lazy<U> apply(lazy<F> lf, lazy<T> l) {
+			if(lf.status() == value_status::ready)
+				return map(*lf, std::move(l));
+
+			memory_resource* r = l.cell->resource();
+			auto u = _dtl::defer_on<U>(r, [lf,l]() { return (*lf)(*l); });
+			_dtl::lazy_dependencies<2>(lf, l).record(u);
+			return u;
 		}
 
 		/**
@@ -362,9 +680,13 @@ namespace ftl {
 				typename U = Value_type<result_of<F(T)>>
 		>
 		static lazy<U> bind(lazy<T> l, F f) {
-			return lazy<U>{[f,l]() {
+			memory_resource* r = l.cell->resource();
+			auto u = _dtl::defer_on<U>(r, [f,l]() {
 				return *(f(*l));
-			}};
+			});
+
+			_dtl::lazy_access::node(u)->depend_on(l.cell.get());
+			return u;
 		}
 
 		static constexpr bool instance = true;
@@ -397,7 +719,9 @@ namespace ftl {
 		 * They are, of course, forced when the result of this computation is.
 		 */
 		static lazy<T> append(lazy<T> l1, lazy<T> l2) {
-			return lazy<T>([l1,l2](){ return monoid<T>::append(*l1, *l2); });
+			lazy<T> l([l1,l2](){ return monoid<T>::append(*l1, *l2); });
+			_dtl::lazy_dependencies<2>(l1, l2).record(l);
+			return l;
 		}
 
 		static constexpr bool instance = monoid<T>::instance;
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_LAZY_GRAPH_H
+#define FTL_LAZY_GRAPH_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "lazy.h"
+#include "executor.h"
+
+namespace ftl {
+	/**
+	 * \defgroup lazy_graph Lazy Graph
+	 *
+	 * Parallel evaluation of graphs of interdependent lazy values.
+	 *
+	 * \code
+	 *   #include <ftl/lazy_graph.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<condition_variable>`
+	 * - `<mutex>`
+	 * - `<unordered_map>`
+	 * - `<vector>`
+	 * - \ref lazy
+	 * - \ref executor
+	 */
+
+	namespace _dtl {
+		class lazy_schedule;
+
+		// A node of the graph being evaluated, and what waits for it
+		struct lazy_record : lazy_slot {
+			enum : int { pending, running, done };
+
+			lazy_node* node = nullptr;
+			lazy_schedule* owner = nullptr;
+			std::vector<std::size_t> dependents;
+			std::atomic<std::size_t> waiting{0};
+			std::atomic<int> state{pending};
+			std::exception_ptr error;
+		};
+
+		/*
+		 * The state of one call to ftl::evaluate.
+		 *
+		 * Every node of the graph is scheduled exactly once, as soon as the
+		 * last of its recorded dependencies is done, and is computed by
+		 * whichever thread claims it first: either its own task, or one
+		 * that forces it without having recorded it as a dependency. Tasks
+		 * finding their node claimed already do nothing; whoever computed
+		 * it schedules its dependents.
+		 *
+		 * Each task counts towards `tasks` until it has finished with the
+		 * schedule, which is what the evaluating thread waits for.
+		 */
+		class lazy_schedule {
+		public:
+			template<typename It>
+			lazy_schedule(It first, It last) {
+				discover(first, last);
+			}
+
+			lazy_schedule(const lazy_schedule&) = delete;
+			lazy_schedule& operator= (const lazy_schedule&) = delete;
+
+			// Detaches and releases every node, forced or not
+			~lazy_schedule() {
+				for(std::size_t i = 0; i < size; ++i) {
+					records[i].node->slot = nullptr;
+					records[i].node->release();
+				}
+			}
+
+			template<typename E>
+			void run(E& ex) {
+				executor = std::addressof(ex);
+				spawn = &lazy_schedule::spawn_on<E>;
+				tasks = size;
+
+				// Once the first task runs, it may bring others down to zero
+				std::vector<std::size_t> leaves;
+				for(std::size_t i = 0; i < size; ++i) {
+					if(records[i].waiting.load(std::memory_order_relaxed) == 0)
+						leaves.push_back(i);
+				}
+
+				for(auto i : leaves)
+					(*spawn)(*this, i);
+
+				std::unique_lock<std::mutex> lock(m);
+				cv.wait(lock, [this](){ return tasks == 0; });
+
+				if(first_error)
+					std::rethrow_exception(first_error);
+			}
+
+		private:
+			struct task {
+				void operator() () const {
+					auto& r = s->records[i];
+					if(claim(r))
+						s->compute(r);
+
+					s->task_done();
+				}
+
+				lazy_schedule* s;
+				std::size_t i;
+			};
+
+			template<typename E>
+			static void spawn_on(lazy_schedule& s, std::size_t i) {
+				static_cast<E*>(s.executor)->execute(task{&s, i});
+			}
+
+			static bool claim(lazy_record& r) noexcept {
+				int p = lazy_record::pending;
+				return r.state.compare_exchange_strong(
+					p, lazy_record::running, std::memory_order_acquire
+				);
+			}
+
+			// Forcing of a node from within a computation, on any thread
+			static void force(lazy_slot& s) {
+				auto& r = static_cast<lazy_record&>(s);
+				r.owner->force(r);
+			}
+
+			void force(lazy_record& r) {
+				if(claim(r))
+					compute(r);
+				else {
+					std::unique_lock<std::mutex> lock(m);
+					cv.wait(lock, [&r](){
+						return r.state.load(std::memory_order_acquire)
+							== lazy_record::done;
+					});
+				}
+
+				if(r.error)
+					std::rethrow_exception(r.error);
+			}
+
+			// Computes a claimed node, then schedules what waited for it
+			void compute(lazy_record& r) {
+				try {
+					r.node->compute();
+				}
+				catch(...) {
+					r.error = std::current_exception();
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(m);
+					if(r.error && !first_error)
+						first_error = r.error;
+
+					r.state.store(lazy_record::done, std::memory_order_release);
+					cv.notify_all();
+				}
+
+				for(auto d : r.dependents) {
+					auto& dr = records[d];
+					if(dr.waiting.fetch_sub(1, std::memory_order_acq_rel) == 1)
+						(*spawn)(*this, d);
+				}
+			}
+
+			void task_done() noexcept {
+				std::lock_guard<std::mutex> lock(m);
+				if(--tasks == 0)
+					cv.notify_all();
+			}
+
+			/*
+			 * Find every deferred node reachable from [first, last).
+			 *
+			 * The nodes are all acquired, so that none of them is released
+			 * while the schedule refers to it.
+			 */
+			template<typename It>
+			void discover(It first, It last) {
+				std::unordered_map<const lazy_node*,std::size_t> index;
+				std::vector<lazy_node*> nodes;
+				std::vector<std::pair<std::size_t,std::size_t>> edges;
+
+				auto visit = [&](lazy_node* n) -> std::size_t {
+					auto it = index.find(n);
+					if(it != index.end())
+						return it->second;
+
+					index.emplace(n, nodes.size());
+					nodes.push_back(n);
+					return nodes.size() - 1;
+				};
+
+				for(; first != last; ++first) {
+					auto n = lazy_access::node(*first);
+					if(!n->is_ready())
+						visit(n);
+				}
+
+				// nodes grows as it is walked
+				for(std::size_t i = 0; i < nodes.size(); ++i) {
+					auto n = nodes[i];
+					for(unsigned k = 0; k < n->dependencies(); ++k) {
+						auto d = n->dependency(k);
+						if(!d->is_ready())
+							edges.emplace_back(visit(d), i);
+					}
+				}
+
+				size = nodes.size();
+				records.reset(new lazy_record[size]);
+
+				for(std::size_t i = 0; i < size; ++i) {
+					auto& r = records[i];
+					r.claim = &lazy_schedule::force;
+					r.node = nodes[i];
+					r.owner = this;
+					r.node->acquire();
+					r.node->slot = &r;
+				}
+
+				for(auto& e : edges) {
+					records[e.first].dependents.push_back(e.second);
+					records[e.second].waiting.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+
+			std::unique_ptr<lazy_record[]> records;
+			std::size_t size = 0;
+
+			void* executor = nullptr;
+			void (*spawn)(lazy_schedule&, std::size_t) = nullptr;
+
+			std::mutex m;
+			std::condition_variable cv;
+			std::size_t tasks = 0;
+			std::exception_ptr first_error;
+		};
+	}
+
+	/**
+	 * Force a graph of lazy values in parallel.
+	 *
+	 * Forcing a lazy value that depends on others normally computes all of
+	 * them in turn, depth first, on the forcing thread. `evaluate` instead
+	 * discovers the deferred computations reachable from `roots`, and runs
+	 * them on `ex` in topological order, computing independent ones
+	 * concurrently. Given enough threads, the time taken is that of the
+	 * longest chain of dependencies rather than of all of them together.
+	 *
+	 * Dependencies are recorded when lazy values are built by `map`,
+	 * `apply`, `bind`, `defer` and the monoid and comparison operations,
+	 * up to two per value. A computation that forces a lazy value it did not
+	 * record&mdash;such as the one returned by the function passed to
+	 * `bind`&mdash;still gets it: values that are part of the graph are
+	 * computed on the spot if no other thread has started on them, or
+	 * waited for if one has. Values outside the graph are forced like any
+	 * other. Either way, each computation runs exactly once.
+	 *
+	 * Blocks until every value is computed. Should any computation throw,
+	 * those depending on it fail with the same exception, the others are
+	 * still computed, and the first exception is rethrown once all of them
+	 * are done; the failed values remain deferred.
+	 *
+	 * \note While `evaluate` runs, the values of the graph must not be
+	 *       forced, or copies of them assigned to, by any other thread. The
+	 *       calling thread waits without running any tasks itself, so it
+	 *       must not be one of the threads of `ex` unless there are others
+	 *       to do the work.
+	 *
+	 * \tparam C a container of `ftl::lazy<T>`
+	 * \tparam E must satisfy \ref executorpg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::thread_pool pool;
+	 *
+	 *   auto sales = ftl::defer(load, "sales");
+	 *   auto costs = ftl::defer(load, "costs");
+	 *   auto report = ftl::curry<2>(summarise) % sales * costs;
+	 *
+	 *   // Both loads run at once, summarise once they are done
+	 *   ftl::evaluate(std::vector<ftl::lazy<table>>{report}, pool);
+	 * \endcode
+	 *
+	 * \ingroup lazy_graph
+	 */
+	template<
+			typename C,
+			typename E,
+			typename = Requires<Executor<E>{}>,
+			typename = decltype(
+				_dtl::lazy_access::node(*std::begin(std::declval<const C&>()))
+			)
+	>
+	void evaluate(const C& roots, E& ex) {
+		_dtl::lazy_schedule s(std::begin(roots), std::end(roots));
+		s.run(ex);
+	}
+
+	/**
+	 * Force a single lazy value, evaluating its graph in parallel.
+	 *
+	 * \return The value of `root`
+	 *
+	 * \see evaluate(const C&, E&)
+	 *
+	 * \ingroup lazy_graph
+	 */
+	template<typename T, typename E, typename = Requires<Executor<E>{}>>
+	const T& evaluate(const lazy<T>& root, E& ex) {
+		_dtl::lazy_schedule s(&root, &root + 1);
+		s.run(ex);
+		return *root;
+	}
+}
+
+#endif
@@ -23,8 +23,11 @@
 #ifndef FTL_LAZY_TRANS_H
 #define FTL_LAZY_TRANS_H
 
+#include <vector>
+#include <iterator>
 #include "prelude.h"
 #include "lazy.h"
+#include "concepts/foldable.h"
 
 namespace ftl {
 	/**
@@ -37,8 +40,11 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * \par Dependencies
+	 * - <vector>
+	 * - <iterator>
 	 * - \ref prelude
 	 * - \ref lazy
+	 * - \ref foldable
 	 */
 
 	/**
@@ -268,6 +274,383 @@ namespace ftl {
 
 		// TODO: automatic hoisting too
 	};
+
+	namespace _dtl {
+		struct batch_access;
+
+		template<typename M>
+		struct lazy_value {
+			M operator() () {
+				return std::move(m);
+			}
+
+			M m;
+		};
+
+		template<typename M>
+		struct lazy_slice {
+			M operator() () const {
+				auto b = std::next(src->begin(), first);
+				return M(b, std::next(b, last - first));
+			}
+
+			std::shared_ptr<const M> src;
+			std::size_t first;
+			std::size_t last;
+		};
+	}
+
+	/**
+	 * Lazy transformer deferring the whole of `M` at once.
+	 *
+	 * Where `lazyT` defers each element of `M` separately, with one lazy
+	 * cell, and thus one allocation, per element, `batch_lazyT` holds one
+	 * single `lazy<M>`. Every `map` or `bind` adds one more cell for the
+	 * whole container, which is computed in full the first time it is
+	 * dereferenced.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref deref to the (forced) underlying `M`
+	 * - \ref functor
+	 * - \ref applicative
+	 * - \ref monad
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<int> v(1000000, 1);
+	 *   ftl::batch_lazyT<std::vector<int>> l{v};
+	 *
+	 *   // Nothing computed yet, and a single allocation made
+	 *   auto m = [](int x){ return x*2; } % l;
+	 *
+	 *   // Computes all of m
+	 *   auto x = (*m)[10];
+	 * \endcode
+	 *
+	 * \tparam M must be a \ref monad
+	 *
+	 * \ingroup lazyT
+	 */
+	template<typename M>
+	class batch_lazyT {
+	public:
+		/// Convenient access to parameter type
+		using T = Value_type<M>;
+
+		/// Defer a computation of the entire `M`
+		explicit batch_lazyT(lazy<M> l) noexcept : mLazy(std::move(l)) {}
+
+		/// Wrap an already computed `M`
+		explicit batch_lazyT(M m)
+		: mLazy(unique_function<M()>(_dtl::lazy_value<M>{std::move(m)})) {}
+
+		/// Force the computation, if it has not been already
+		const M& operator* () const {
+			return *mLazy;
+		}
+
+		const M* operator-> () const {
+			return mLazy.operator->();
+		}
+
+		/// Whether the underlying `M` has been computed yet
+		value_status status() const noexcept {
+			return mLazy.status();
+		}
+
+	private:
+		friend struct _dtl::batch_access;
+
+		lazy<M> mLazy;
+	};
+
+	template<typename M>
+	struct parametric_type_traits<batch_lazyT<M>> {
+		using value_type = Value_type<M>;
+
+		template<typename T>
+		using rebind = batch_lazyT<Rebind<M,T>>;
+	};
+
+	namespace _dtl {
+		template<typename M>
+		const M& force_batch(const batch_lazyT<M>& b) {
+			return *b;
+		}
+
+		template<typename M>
+		const M& force_batch(batch_lazyT<M>&& b) {
+			return *b;
+		}
+
+		// Functions binding directly to the base monad need no forcing
+		template<typename M>
+		M&& force_batch(M&& m) noexcept {
+			return std::forward<M>(m);
+		}
+
+		template<typename M, typename F, typename R>
+		struct batch_map {
+			R operator() () const {
+				return f % *l;
+			}
+
+			F f;
+			lazy<M> l;
+		};
+
+		template<typename M, typename F, typename R>
+		struct batch_bind {
+			struct step {
+				template<typename T>
+				R operator() (T&& t) const {
+					return force_batch(f(std::forward<T>(t)));
+				}
+
+				F f;
+			};
+
+			R operator() () const {
+				return *l >>= step{f};
+			}
+
+			F f;
+			lazy<M> l;
+		};
+
+		struct batch_access {
+			template<typename M>
+			static const lazy<M>& get(const batch_lazyT<M>& b) noexcept {
+				return b.mLazy;
+			}
+		};
+	}
+
+	/**
+	 * Monad instance for `batch_lazyT`.
+	 *
+	 * Functions given to `bind` may return either a `batch_lazyT` or a plain
+	 * `M`. Either way, binding defers one computation of the entire result.
+	 *
+	 * \ingroup lazyT
+	 */
+	template<typename M>
+	struct monad<batch_lazyT<M>>
+	: deriving_join<in_terms_of_bind<batch_lazyT<M>>>
+	, deriving_apply<in_terms_of_bind<batch_lazyT<M>>> {
+		using T = Value_type<M>;
+
+		template<typename U>
+		using M_ = Rebind<M,U>;
+
+		template<typename U>
+		using bT = batch_lazyT<M_<U>>;
+
+		static bT<T> pure(T t) {
+			return bT<T>{monad<M>::pure(std::move(t))};
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static bT<U> map(F f, const bT<T>& b) {
+			return bT<U>{lazy<M_<U>>{unique_function<M_<U>()>(
+				_dtl::batch_map<M,F,M_<U>>{
+					std::move(f), _dtl::batch_access::get(b)
+				}
+			)}};
+		}
+
+		template<typename F, typename U = Value_type<result_of<F(T)>>>
+		static bT<U> bind(const bT<T>& b, F f) {
+			return bT<U>{lazy<M_<U>>{unique_function<M_<U>()>(
+				_dtl::batch_bind<M,F,M_<U>>{
+					std::move(f), _dtl::batch_access::get(b)
+				}
+			)}};
+		}
+
+		static constexpr bool instance = monad<M>::instance;
+	};
+
+	/**
+	 * Lazy container split into blocks, each of which is forced on its own.
+	 *
+	 * A middle ground between `lazyT` and `batch_lazyT`: the elements of
+	 * a sequence container `M` are deferred in blocks of a fixed size,
+	 * with one lazy cell per block. Accessing an element computes only the
+	 * block it is in, and folds force one block at a time.
+	 *
+	 * The source container is shared by all the initial blocks, which copy
+	 * their part of it only when first forced.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref functor
+	 * - \ref foldablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<int> v(1000000, 1);
+	 *   ftl::chunked_lazyT<std::vector<int>> l{v, 4096};
+	 *
+	 *   // 245 allocations, one per block
+	 *   auto m = [](int x){ return x*2; } % l;
+	 *
+	 *   // Only computes the first block of m
+	 *   auto x = m.at(10);
+	 * \endcode
+	 *
+	 * \tparam M must be a \ref functor and a sequence container
+	 *
+	 * \ingroup lazyT
+	 */
+	template<typename M>
+	class chunked_lazyT {
+	public:
+		/// Convenient access to parameter type
+		using T = Value_type<M>;
+
+		/// Defer the elements of `m` in blocks of `block_size` elements
+		chunked_lazyT(M m, std::size_t block_size)
+		: mSize(m.size()), mBlockSize(block_size ? block_size : 1) {
+			auto src = std::make_shared<const M>(std::move(m));
+			FTL_COUNT_ALLOCATION(lazy, sizeof(M));
+
+			mBlocks.reserve((mSize + mBlockSize - 1) / mBlockSize);
+			for(std::size_t i = 0; i < mSize; i += mBlockSize) {
+				mBlocks.emplace_back(unique_function<M()>(
+					_dtl::lazy_slice<M>{
+						src, i, std::min(mSize, i + mBlockSize)
+					}
+				));
+			}
+		}
+
+		/// Total number of elements
+		std::size_t size() const noexcept {
+			return mSize;
+		}
+
+		/// Number of elements per block; only the last may have fewer
+		std::size_t block_size() const noexcept {
+			return mBlockSize;
+		}
+
+		/// Number of blocks
+		std::size_t blocks() const noexcept {
+			return mBlocks.size();
+		}
+
+		/// The `i`:th block, forcing it if need be
+		const M& block(std::size_t i) const {
+			return *mBlocks[i];
+		}
+
+		/// The `i`:th element, forcing only the block it is in
+		const T& at(std::size_t i) const {
+			auto& b = block(i / mBlockSize);
+			return *std::next(b.begin(), i % mBlockSize);
+		}
+
+		/// Force every block, and concatenate them
+		M force() const {
+			M m;
+			for(auto& b : mBlocks) {
+				m.insert(m.end(), b->begin(), b->end());
+			}
+
+			return m;
+		}
+
+	private:
+		template<typename> friend struct functor;
+
+		chunked_lazyT(
+				std::vector<lazy<M>> blocks,
+				std::size_t size, std::size_t block_size) noexcept
+		: mBlocks(std::move(blocks)), mSize(size), mBlockSize(block_size) {}
+
+		std::vector<lazy<M>> mBlocks;
+		std::size_t mSize;
+		std::size_t mBlockSize;
+	};
+
+	template<typename M>
+	struct parametric_type_traits<chunked_lazyT<M>> {
+		using value_type = Value_type<M>;
+
+		template<typename T>
+		using rebind = chunked_lazyT<Rebind<M,T>>;
+	};
+
+	/**
+	 * Functor instance for `chunked_lazyT`.
+	 *
+	 * Defers the mapping of each block separately. As blocks keep their
+	 * sizes, so does the result.
+	 *
+	 * \ingroup lazyT
+	 */
+	template<typename M>
+	struct functor<chunked_lazyT<M>> {
+		using T = Value_type<M>;
+
+		template<typename U>
+		using M_ = Rebind<M,U>;
+
+		template<typename F, typename U = result_of<F(T)>>
+		static chunked_lazyT<M_<U>> map(F f, const chunked_lazyT<M>& c) {
+			std::vector<lazy<M_<U>>> blocks;
+			blocks.reserve(c.mBlocks.size());
+
+			for(auto& b : c.mBlocks) {
+				blocks.emplace_back(unique_function<M_<U>()>(
+					_dtl::batch_map<M,F,M_<U>>{f, b}
+				));
+			}
+
+			return chunked_lazyT<M_<U>>(
+				std::move(blocks), c.mSize, c.mBlockSize
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for `chunked_lazyT`.
+	 *
+	 * Blocks are forced one at a time, in the order they are folded.
+	 *
+	 * \ingroup lazyT
+	 */
+	template<typename M>
+	struct foldable<chunked_lazyT<M>>
+	: deriving_foldMap<chunked_lazyT<M>>, deriving_fold<chunked_lazyT<M>> {
+		using T = Value_type<M>;
+
+		template<typename F, typename U>
+		static U foldl(F f, U z, const chunked_lazyT<M>& c) {
+			for(std::size_t i = 0; i < c.blocks(); ++i) {
+				z = foldable<M>::foldl(f, std::move(z), c.block(i));
+			}
+
+			return z;
+		}
+
+		template<typename F, typename U>
+		static U foldr(F f, U z, const chunked_lazyT<M>& c) {
+			for(std::size_t i = c.blocks(); i > 0; --i) {
+				z = foldable<M>::foldr(f, std::move(z), c.block(i-1));
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = foldable<M>::instance;
+	};
 }
 
 #endif
@@ -68,9 +68,37 @@ namespace ftl {
 		using rebind = std::list<U,rebind_allocator<U>>;
 	};
 
+	namespace _dtl {
+		// Moves the elements of c to the end of l
+		template<typename T, typename A, typename C>
+		void append_moved(std::list<T,A>& l, C& c) {
+			l.insert(
+				l.end(),
+				std::make_move_iterator(c.begin()),
+				std::make_move_iterator(c.end())
+			);
+		}
+
+		// Relinks the nodes of c instead, when they can be shared
+		template<typename T, typename A>
+		void append_moved(std::list<T,A>& l, std::list<T,A>& c) {
+			if(l.get_allocator() == c.get_allocator())
+				l.splice(l.end(), c);
+			else
+				l.insert(
+					l.end(),
+					std::make_move_iterator(c.begin()),
+					std::make_move_iterator(c.end())
+				);
+		}
+	}
+
 	/**
 	 * Maps and concatenates in one step.
 	 *
+	 * If `f` returns lists of the same type as the result, their nodes are
+	 * spliced into it rather than copied.
+	 *
 	 * \tparam F must satisfy \ref fn`<`\ref container`<U>(T)>`
 	 *
 	 * \ingroup list
@@ -85,15 +113,15 @@ namespace ftl {
 	std::list<U,Au> concatMap(F&& f, const std::list<T,A>& l) {
 
 		std::list<U,Au> result;
-		auto nested = std::forward<F>(f) % l;
-
-		for(auto& el : nested) {
-			result.splice(result.end(), el);
+		for(const auto& e : l) {
+			auto c = f(e);
+			_dtl::append_moved(result, c);
 		}
 
 		return result;
 	}
 
+	/// \overload
 	template<
 			typename F,
 			typename T,
@@ -104,14 +132,142 @@ namespace ftl {
 	std::list<U,Au> concatMap(F&& f, std::list<T,A>&& l) {
 
 		std::list<U,Au> result;
-		auto nested = std::forward<F>(f) % std::move(l);
+		for(auto& e : l) {
+			auto c = f(std::move(e));
+			_dtl::append_moved(result, c);
+		}
+
+		return result;
+	}
+
+	/**
+	 * The elements of `l` that satisfy `p`, in order.
+	 *
+	 * \tparam P must satisfy \ref fn`<bool(T)>`
+	 *
+	 * \ingroup list
+	 */
+	template<typename P, typename T, typename A>
+	std::list<T,A> filter(P&& p, const std::list<T,A>& l) {
+		std::list<T,A> result(l.get_allocator());
+		for(auto& e : l) {
+			if(p(e))
+				result.push_back(e);
+		}
+
+		return result;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Unlinks the elements of `l` that fail `p`, keeping the nodes of the
+	 * others. Nothing is allocated, or moved.
+	 *
+	 * \ingroup list
+	 */
+	template<typename P, typename T, typename A>
+	std::list<T,A> filter(P&& p, std::list<T,A>&& l) {
+		l.remove_if([&p](const T& t){ return !p(t); });
+		return std::move(l);
+	}
 
-		for(auto& el : nested)
-			result.splice(result.end(), el);
+	/**
+	 * Maps and keeps only the results that are present.
+	 *
+	 * Equivalent of `concatMap(f, l)` for an `f` returning ftl::maybe, but
+	 * the values are moved straight out of each result into the output.
+	 *
+	 * \tparam F must satisfy \ref fn`<maybe<U>(T)>`, or more generally,
+	 *           return any \ref fwditerable of at most one element.
+	 *
+	 * \ingroup list
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			typename U = Value_type<result_of<F(T)>>,
+			typename Au = Rebind<A,U>
+	>
+	std::list<U,Au> mapMaybe(F&& f, const std::list<T,A>& l) {
+		std::list<U,Au> result{Au(l.get_allocator())};
+		for(auto& e : l) {
+			auto m = f(e);
+			for(auto& u : m) {
+				result.push_back(std::move(u));
+			}
+		}
 
 		return result;
 	}
 
+	/**
+	 * \overload
+	 *
+	 * Elements are moved into `f`.
+	 *
+	 * \ingroup list
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			typename U = Value_type<result_of<F(T)>>,
+			typename Au = Rebind<A,U>,
+			typename = Requires<
+				!std::is_same<U,T>::value
+				|| !std::is_move_assignable<T>::value
+			>
+	>
+	std::list<U,Au> mapMaybe(F&& f, std::list<T,A>&& l) {
+		std::list<U,Au> result{Au(l.get_allocator())};
+		for(auto& e : l) {
+			auto m = f(std::move(e));
+			for(auto& u : m) {
+				result.push_back(std::move(u));
+			}
+		}
+
+		return result;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * If `f` returns the type it is given, each result replaces its
+	 * argument in the same node, and nodes without a result are unlinked.
+	 * Nothing is allocated.
+	 *
+	 * \ingroup list
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			typename = Requires<
+				std::is_same<Value_type<result_of<F(T)>>,T>::value
+				&& std::is_move_assignable<T>::value
+			>
+	>
+	std::list<T,A> mapMaybe(F&& f, std::list<T,A>&& l) {
+		for(auto it = l.begin(); it != l.end();) {
+			auto m = f(std::move(*it));
+			bool present = false;
+			for(auto& u : m) {
+				*it = std::move(u);
+				present = true;
+			}
+
+			if(present)
+				++it;
+			else
+				it = l.erase(it);
+		}
+
+		return std::move(l);
+	}
+
 	/**
 	 * Monoid implementation for std::list.
 	 *
@@ -140,14 +296,14 @@ namespace ftl {
 				std::list<Ts...>&& l1,
 				const std::list<Ts...>& l2) {
 			l1.insert(l1.end(), l2.begin(), l2.end());
-			return l1;
+			return std::move(l1);
 		}
 
 		static std::list<Ts...> append(
 				const std::list<Ts...>& l1,
 				std::list<Ts...>&& l2) {
 			l2.insert(l2.begin(), l1.begin(), l1.end());
-			return l2;
+			return std::move(l2);
 		}
 
 		static std::list<Ts...> append(
@@ -161,7 +317,52 @@ namespace ftl {
 				std::move(l2.begin(), l2.end(), std::back_inserter(l1));
 			}
 
-			return l1;
+			return std::move(l1);
+		}
+
+		/**
+		 * Concatenates an entire sequence of lists.
+		 *
+		 * Every element is copied once, straight to the end of the result.
+		 *
+		 * \tparam I must satisfy \ref fwditerable, with lists as elements
+		 */
+		template<
+				typename I,
+				typename = Requires<ForwardIterable<I>()>
+		>
+		static std::list<Ts...> mconcat(const I& ls) {
+			std::list<Ts...> rl;
+			for(auto& l : ls) {
+				rl.insert(rl.end(), l.begin(), l.end());
+			}
+
+			return rl;
+		}
+
+		/**
+		 * \overload
+		 *
+		 * Lists sharing the result's allocator are spliced onto it, which
+		 * neither copies nor allocates anything.
+		 */
+		template<
+				typename I,
+				typename = Requires<
+					!std::is_lvalue_reference<I>::value
+					&& ForwardIterable<plain_type<I>>()
+				>
+		>
+		static std::list<Ts...> mconcat(I&& ls) {
+			std::list<Ts...> rl;
+			for(auto& l : ls) {
+				if(l.get_allocator() == rl.get_allocator())
+					rl.splice(rl.end(), l);
+				else
+					std::move(l.begin(), l.end(), std::back_inserter(rl));
+			}
+
+			return rl;
 		}
 
 		static constexpr bool instance = true;
@@ -179,11 +380,11 @@ namespace ftl {
 	struct monad<std::list<T,A>>
 	: deriving_monad<back_insertable_container<std::list<T,A>>> {
 
-#ifdef DOCUMENTATION_GENERATOR
 		/// Alias to make type signatures cleaner
 		template<typename U>
 		using list = Rebind<std::list<T,A>,U>;
 
+#ifdef DOCUMENTATION_GENERATOR
 		/**
 		 * Produces a singleton list.
 		 *
@@ -224,11 +425,15 @@ namespace ftl {
 		 * The resulting list contains every element of every list contained
 		 * in the original list. Relative order is preserved (from the
 		 * perspective of depth first iteration).
+		 *
+		 * If `l` is a temporary, the nodes of the nested lists are spliced
+		 * into the result, without allocating.
 		 */
 		static list<T> join(const list<list<T>>& l);
 
 		/// \overload
 		static list<T> join(list<list<T>>&& l);
+#endif
 
 		/**
 		 * Monad bind operation.
@@ -258,19 +463,30 @@ namespace ftl {
 				typename U = Value_type<Cu>,
 				typename = Requires<ForwardIterable<Cu>()>
 		>
-		static list<U> bind(const list<T>& l, F&& f);
+		static list<U> bind(const list<T>& l, F&& f) {
+			return concatMap(std::forward<F>(f), l);
+		}
 
 		/// \overload
 		template<
 				typename F,
 				typename Cu = result_of<F(T)>,
 				typename U = Value_type<Cu>,
-				typename = Requries<ForwardIterable<Cu>()>
+				typename = Requires<ForwardIterable<Cu>()>
 		>
-		static list<U> bind(list<T>&& l, F&& f);
-#endif
+		static list<U> bind(list<T>&& l, F&& f) {
+			return concatMap(std::forward<F>(f), std::move(l));
+		}
 	};
 
+	/**
+	 * Lists apply every function to every element, in order.
+	 *
+	 * \ingroup list
+	 */
+	template<typename T, typename A>
+	struct cartesian_apply<std::list<T,A>> : std::true_type {};
+
 	/**
 	 * Foldable instance for std::lists.
 	 *
@@ -283,9 +499,9 @@ namespace ftl {
 	/**
 	 * \ref zippablepg instance for `std::list`.
 	 *
-	 * This particular instance allows a `vector` to be zipped with
-	 * any type that satisfies \ref fwditerable. Thus, one can zip a
-	 * `vector` with a `forward_list`, `list` or even `ftl::maybe`.
+	 * This particular instance allows a `list` to be zipped with any number
+	 * of values of types that satisfy \ref fwditerable. Thus, one can zip a
+	 * `list` with a `forward_list`, `vector` or even `ftl::maybe`.
 	 *
 	 * \ingroup list
 	 */
@@ -26,6 +26,7 @@
 #include <map>
 #include "concepts/functor.h"
 #include "concepts/foldable.h"
+#include "maybe.h"
 
 namespace ftl {
 
@@ -44,6 +45,7 @@ namespace ftl {
 	 * \par Dependencies
 	 * - \ref functor
 	 * - \ref foldable
+	 * - \ref maybe
 	 */
 
 	template<typename K, typename V, typename C, typename A>
@@ -77,9 +79,10 @@ namespace ftl {
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static Map<U> map(F&& f, const Map<T>& m) {
+			// Keys are visited in order, so each belongs at the end of rm
 			Map<U> rm;
 			for(const auto& kv : m) {
-				rm.insert(std::make_pair(kv.first, f(kv.second)));
+				rm.emplace_hint(rm.end(), kv.first, f(kv.second));
 			}
 
 			return rm;
@@ -98,7 +101,7 @@ namespace ftl {
 		static Map<U> map(F&& f, Map<T>&& m) {
 			Map<U> rm;
 			for(auto& kv : m) {
-				rm.emplace(std::move(kv.first), f(std::move(kv.second)));
+				rm.emplace_hint(rm.end(), kv.first, f(std::move(kv.second)));
 			}
 
 			return rm;
@@ -117,10 +120,10 @@ namespace ftl {
 		>
 		static Map<T> map(F&& f, Map<T>&& m) {
 			for(auto& kv : m) {
-				m[kv.first] = f(std::move(kv.second));
+				kv.second = f(std::move(kv.second));
 			}
 
-			return m;
+			return std::move(m);
 		}
 
 		static constexpr bool instance = true;
@@ -144,7 +147,7 @@ namespace ftl {
 		>
 		static U foldl(F&& f, U z, const std::map<K,T,C,A>& m) {
 			for(auto& kv : m) {
-				z = f(z, kv.second);
+				z = f(std::move(z), kv.second);
 			}
 
 			return z;
@@ -159,7 +162,7 @@ namespace ftl {
 		>
 		static U foldr(F&& f, U z, const std::map<K,T,C,A>& m) {
 			for(auto it = m.rbegin(); it != m.rend(); ++it) {
-				z = f(it->second, z);
+				z = f(it->second, std::move(z));
 			}
 
 			return z;
@@ -168,6 +171,145 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	/**
+	 * The entries of `m` whose values satisfy `p`.
+	 *
+	 * Like `fmap`, this only looks at the values, keys being kept as they
+	 * are. Entries are visited in order, so each survivor is inserted at
+	 * the end of the result, in constant time.
+	 *
+	 * \tparam P must satisfy \ref fn`<bool(T)>`
+	 *
+	 * \ingroup map
+	 */
+	template<typename P, typename K, typename T, typename C, typename A>
+	std::map<K,T,C,A> filter(P&& p, const std::map<K,T,C,A>& m) {
+		std::map<K,T,C,A> rm(m.key_comp(), m.get_allocator());
+		for(auto& kv : m) {
+			if(p(kv.second))
+				rm.emplace_hint(rm.end(), kv);
+		}
+
+		return rm;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Erases the entries of `m` that fail `p`, keeping the nodes of the
+	 * others. Nothing is allocated.
+	 *
+	 * \ingroup map
+	 */
+	template<typename P, typename K, typename T, typename C, typename A>
+	std::map<K,T,C,A> filter(P&& p, std::map<K,T,C,A>&& m) {
+		for(auto it = m.begin(); it != m.end();) {
+			if(p(static_cast<const T&>(it->second)))
+				++it;
+			else
+				it = m.erase(it);
+		}
+
+		return std::move(m);
+	}
+
+	/**
+	 * Maps the values of `m`, keeping only the entries with a result.
+	 *
+	 * \tparam F must satisfy \ref fn`<maybe<U>(T)>`, or more generally,
+	 *           return any \ref fwditerable of at most one element.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::map<int,std::string> m{{1, "1"}, {2, "two"}};
+	 *
+	 *   // r == {{1, 1}}
+	 *   auto r = ftl::mapMaybe(parse_int, m);
+	 * \endcode
+	 *
+	 * \ingroup map
+	 */
+	template<
+			typename F,
+			typename K,
+			typename T,
+			typename C,
+			typename A,
+			typename U = Value_type<result_of<F(T)>>
+	>
+	Rebind<std::map<K,T,C,A>,U> mapMaybe(F&& f, const std::map<K,T,C,A>& m) {
+		Rebind<std::map<K,T,C,A>,U> rm;
+		for(auto& kv : m) {
+			auto r = f(kv.second);
+			for(auto& u : r) {
+				rm.emplace_hint(rm.end(), kv.first, std::move(u));
+			}
+		}
+
+		return rm;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Values are moved into `f`.
+	 *
+	 * \ingroup map
+	 */
+	template<
+			typename F,
+			typename K,
+			typename T,
+			typename C,
+			typename A,
+			typename U = Value_type<result_of<F(T)>>
+	>
+	Rebind<std::map<K,T,C,A>,U> mapMaybe(F&& f, std::map<K,T,C,A>&& m) {
+		Rebind<std::map<K,T,C,A>,U> rm;
+		for(auto& kv : m) {
+			auto r = f(std::move(kv.second));
+			for(auto& u : r) {
+				rm.emplace_hint(rm.end(), kv.first, std::move(u));
+			}
+		}
+
+		return rm;
+	}
+
+	/**
+	 * Find the value associated with `k` in `m`, without copying it.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::map<int,std::string> m{{1, "one"}};
+	 *
+	 *   auto v = lookup(1, m);
+	 *   // v refers to m[1], lookup(2, m) would be Nothing
+	 * \endcode
+	 *
+	 * \ingroup map
+	 */
+	template<typename K, typename T, typename C, typename A>
+	maybe<T&> lookup(const K& k, std::map<K,T,C,A>& m) {
+		auto it = m.find(k);
+		if(it == m.end())
+			return nothing<T&>();
+
+		return maybe<T&>{constructor<T&>(), it->second};
+	}
+
+	/// \overload
+	template<typename K, typename T, typename C, typename A>
+	maybe<const T&> lookup(const K& k, const std::map<K,T,C,A>& m) {
+		auto it = m.find(k);
+		if(it == m.end())
+			return nothing<const T&>();
+
+		return maybe<const T&>{constructor<const T&>(), it->second};
+	}
+
 }
 
 #endif
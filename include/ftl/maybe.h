@@ -86,6 +86,12 @@ namespace ftl {
 	 * Note that all iterators referencing a `just` instance of `maybe` are
 	 * rendered invalid if it is changed to `Nothing`.
 	 *
+	 * `maybe<T&>` refers to a value instead of holding a copy of it, and is
+	 * no larger than a pointer. It is constructed with
+	 * `maybe<T&>{constructor<T&>(), t}`, and assigning to it rebinds it.
+	 * `maybe<T*>` is no larger than a pointer either, as long as `T` is a
+	 * scalar type, and both are usable in constant expressions.
+	 *
 	 * \see sum_type
 	 *
 	 * \ingroup maybe
@@ -232,6 +238,9 @@ namespace ftl {
 	 * except it can at most hold one value. The monadic operations then become
 	 * easier to remember.
 	 *
+	 * For literal types `T`, and functions usable in constant expressions,
+	 * every operation is usable in constant expressions as well.
+	 *
 	 * \ingroup maybe
 	 */
 	template<typename T>
@@ -239,20 +248,24 @@ namespace ftl {
 		/**
 		 * Embeds a value in the `maybe` context/container.
 		 *
-		 * Exactly equivalent to invoking `just` on the value.
+		 * Equivalent to invoking `just` on the value, except that for
+		 * `maybe<T&>`, the reference is kept rather than decayed.
 		 */
 		static constexpr maybe<T> pure(const T& t)
 		noexcept(std::is_nothrow_copy_constructible<T>::value) {
-			return just(t);
+			return maybe<T>{constructor<T>(), t};
 		}
 
 		/// \overload
+		template<
+				typename U = T,
+				typename = Requires<!std::is_reference<U>::value>
+		>
 		static constexpr maybe<T> pure(T&& t)
 		noexcept(std::is_nothrow_move_constructible<T>::value) {
 			return just(std::move(t));
 		}
 
-		// TODO: C++14: capture f with forwarding instead of copy
 		/**
 		 * Maybe maps a function to a contained value.
 		 *
@@ -280,22 +293,17 @@ namespace ftl {
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static constexpr maybe<U> map(F f, const maybe<T>& m) {
-			return m.match(
-				[f](const T& t){ return just(f(t)); },
-				[](Nothing){ return Nothing{}; }
-			);
+			return m.template is<T>() ? just(f(get<T>(m))) : nothing<U>();
 		}
 
 		/// \overload
 		template<typename F, typename U = result_of<F(T)>>
 		static constexpr maybe<U> map(F f, maybe<T>&& m) {
-			return m.match(
-				[f](T& t){ return just(f(std::move(t))); },
-				[](Nothing){ return Nothing{}; }
-			);
+			return m.template is<T>()
+				? just(f(std::forward<T>(get<T>(m))))
+				: nothing<U>();
 		}
 
-		// TODO: C++14: capture m by copy/move as appropriate
 		/**
 		 * Apply a contained function to a contained value and embed the result.
 		 *
@@ -322,22 +330,17 @@ namespace ftl {
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static constexpr maybe<U> apply(const maybe<F>& mf, maybe<T> m) {
-			return mf.match(
-				[m](const F& f){ return fmap(f, m); },
-				[](Nothing){ return Nothing{}; }
-			);
+			return mf.template is<F>() ? map(get<F>(mf), m) : nothing<U>();
 		}
 
 		/// \overload
 		template<typename F, typename U = result_of<F(T)>>
 		static constexpr maybe<U> apply(maybe<F>&& mf, maybe<T> m) {
-			return mf.match(
-				[m](F& f){ return fmap(std::move(f), m); },
-				[](Nothing){ return Nothing{}; }
-			);
+			return mf.template is<F>()
+				? map(std::move(get<F>(mf)), std::move(m))
+				: nothing<U>();
 		}
 
-		// TODO: C++14: capture f by forwarding
 		/**
 		 * Extract `m`'s value and forward to `f` if non-`Nothing`.
 		 *
@@ -361,19 +364,15 @@ namespace ftl {
 		 */
 		template<typename F, typename U = Value_type<result_of<F(T)>>>
 		static constexpr maybe<U> bind(const maybe<T>& m, F f) {
-			return m.match(
-				[f](const T& t){ return f(t); },
-				[](Nothing){ return Nothing{}; }
-			);
+			return m.template is<T>() ? maybe<U>(f(get<T>(m))) : nothing<U>();
 		}
 
 		/// \overload
 		template<typename F, typename U = Value_type<result_of<F(T)>>>
 		static constexpr maybe<U> bind(maybe<T>&& m, F f) {
-			return m.match(
-				[f](T& t){ return f(std::move(t)); },
-				[](Nothing){ return Nothing{}; }
-			);
+			return m.template is<T>()
+				? maybe<U>(f(std::forward<T>(get<T>(m))))
+				: nothing<U>();
 		}
 
 		/**
@@ -383,18 +382,39 @@ namespace ftl {
 		 * otherwise `Nothing` is returned.
 		 */
 		static constexpr maybe<T> join(const maybe<maybe<T>>& m) {
-			return m.match(
-				[](maybe<T> m){ return m; },
-				[](Nothing) { return Nothing{}; }
-			);
+			return m.template is<maybe<T>>()
+				? get<maybe<T>>(m)
+				: nothing<T>();
 		}
 
 		/// \overload
 		static constexpr maybe<T> join(maybe<maybe<T>>&& m) {
-			return m.match(
-				[](maybe<T>& m){ return std::move(m); },
-				[](Nothing) { return Nothing{}; }
-			);
+			return m.template is<maybe<T>>()
+				? std::move(get<maybe<T>>(m))
+				: nothing<T>();
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * `Nothing` is a failure that absorbs any `apply`.
+	 *
+	 * \ingroup maybe
+	 */
+	template<typename T>
+	struct short_circuiting<maybe<T>> {
+		static bool failed(const maybe<T>& m) noexcept {
+			return !m.template is<T>();
+		}
+
+		static T&& value(maybe<T>&& m) noexcept {
+			return std::move(get<T>(m));
+		}
+
+		template<typename U>
+		static maybe<U> propagate(maybe<T>&&) noexcept {
+			return nothing<U>();
 		}
 
 		static constexpr bool instance = true;
@@ -425,7 +445,7 @@ namespace ftl {
 			);
 
 			return m.template is<Nothing>()
-				? z
+				? plain_type<U>(std::forward<U>(z))
 				: std::forward<F>(f)(std::forward<U>(z), get<T>(m));
 		}
 
@@ -441,7 +461,7 @@ namespace ftl {
 			);
 
 			return m.template is<Nothing>()
-				? z
+				? plain_type<U>(std::forward<U>(z))
 				: std::forward<F>(f)(get<T>(m), std::forward<U>(z));
 		}
 
@@ -519,6 +539,14 @@ namespace ftl {
 				: std::move(m2);
 		}
 
+		/// Values that are absorbing in `T` are absorbing here as well
+		template<typename U = T, typename = Requires<AbsorbingMonoid<U>{}>>
+		static constexpr bool absorbing(const maybe<T>& m) {
+			return m.template is<T>() && monoid<T>::absorbing(get<T>(m));
+		}
+
+		static constexpr bool commutative = CommutativeMonoid<T>::value;
+
 		static constexpr bool instance = true;
 	};
 
@@ -546,5 +574,15 @@ namespace ftl {
 	}
 }
 
+namespace std {
+	/// All Nothings are equal, and hash the same
+	template<>
+	struct hash<ftl::Nothing> {
+		size_t operator() (ftl::Nothing) const noexcept {
+			return 0;
+		}
+	};
+}
+
 #endif
 
@@ -124,17 +124,66 @@ namespace ftl {
 		using rebind = maybeT<Rebind<M,T>>;
 	};
 
+	namespace _dtl {
+		// Applies a maybe<F> to a maybe<T>
+		template<typename F, typename T, typename U>
+		struct maybet_ap {
+			maybe<U> operator() (const maybe<T>& t) const {
+				return f.template is<F>() && t.template is<T>()
+					? just(get<F>(f)(get<T>(t)))
+					: nothing<U>();
+			}
+
+			maybe<F> f;
+		};
+
+		template<typename M, bool = independent_apply<M>::value>
+		struct maybet_apply : deriving_apply<in_terms_of_bind<maybeT<M>>> {};
+
+		/*
+		 * Base monads that apply independently are applied through without
+		 * binding, so their effects may overlap.
+		 */
+		template<typename M>
+		struct maybet_apply<M,true> {
+			using T = Value_type<M>;
+
+			template<typename U>
+			using M_ = Rebind<M,U>;
+
+			template<
+					typename Mf,
+					typename F = Value_type<plain_type<Mf>>,
+					typename U = result_of<F(T)>
+			>
+			static maybeT<M_<U>> apply(const Mf& mf, const maybeT<M>& m) {
+				using ap = maybet_ap<F,T,U>;
+
+				auto mg = monad<M_<maybe<F>>>::map(
+					[](const maybe<F>& f) { return ap{f}; },
+					*mf
+				);
+
+				return maybeT<M_<U>>{monad<M_<maybe<T>>>::apply(mg, *m)};
+			}
+		};
+	}
+
 	/**
 	 * `maybeT`'s monad instance.
 	 *
 	 * "Stacks" `M` on top of `maybe`.
 	 *
+	 * If `M` is an \ref independent_apply "independent applicative", such as
+	 * ftl::future, `apply` is that of `M` rather than one in terms of `bind`.
+	 * Both operands' effects are then run, even if the first is `nothing`.
+	 *
 	 * \ingroup maybeT
 	 */
 	template<typename M>
 	struct monad<maybeT<M>>
 	: deriving_join<in_terms_of_bind<maybeT<M>>>
-	, deriving_apply<in_terms_of_bind<maybeT<M>>> {
+	, _dtl::maybet_apply<M> {
 		/// Shorthand for the concept parameter
 		using T = typename maybeT<M>::T;
 
@@ -316,6 +365,10 @@ namespace ftl {
 
 	// Forward declarations
 	template<typename> struct foldable;
+	/// maybeT applies independently whenever its base monad does
+	template<typename M>
+	struct independent_apply<maybeT<M>> : independent_apply<M> {};
+
 	template<typename> struct deriving_fold;
 	template<typename> struct deriving_foldMap;
 
@@ -343,11 +396,11 @@ namespace ftl {
 			return foldable<Mmt>::foldl(
 				[f](U z, const maybe<T>& m) {
 					if(m.template is<T>())
-						return f(z, get<T>(m));
+						return f(std::move(z), get<T>(m));
 
 					return z;
 				},
-				z,
+				std::move(z),
 				*mT
 			);
 		}
@@ -361,12 +414,12 @@ namespace ftl {
 			return foldable<Mmt>::foldr(
 				[f](const maybe<T>& m, U z){
 					if(m.template is<T>())
-						return f(get<T>(m), z);
+						return f(get<T>(m), std::move(z));
 
 					else
 						return z;
 				},
-				z,
+				std::move(z),
 				*mT
 			);
 		}
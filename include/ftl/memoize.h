@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_MEMOIZE_H
+#define FTL_MEMOIZE_H
+
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "function.h"
+#include "hash_map.h"
+#include "maybe.h"
+#include "tuple.h"
+#include "implementation/mix_hash.h"
+
+namespace ftl {
+	/**
+	 * \defgroup memoize Memoize
+	 *
+	 * Caching the results of pure functions.
+	 *
+	 * ftl::memoize wraps a function in one that looks its arguments up in a
+	 * cache before calling it. The result is an ftl::function with the same
+	 * signature, so it is curried just like the original.
+	 *
+	 * \code
+	 *   #include <ftl/memoize.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<functional>`
+	 * - `<limits>`
+	 * - `<list>`
+	 * - `<memory>`
+	 * - `<mutex>`
+	 * - `<tuple>`
+	 * - `<type_traits>`
+	 * - `<vector>`
+	 * - \ref function
+	 * - \ref hash_map
+	 * - \ref maybe
+	 * - \ref tuple
+	 */
+
+	/**
+	 * Key that the arguments of a memoised function are stored under.
+	 *
+	 * \ingroup memoize
+	 */
+	template<typename...Ps>
+	using memo_key = std::tuple<plain_type<Ps>...>;
+
+	/**
+	 * Number of lookups a cache could and could not answer.
+	 *
+	 * \ingroup memoize
+	 */
+	struct memo_stats {
+		std::size_t hits;
+		std::size_t misses;
+	};
+
+	/**
+	 * Cache that keeps every result it is given.
+	 *
+	 * Caches are what ftl::memoize stores results in. Each has
+	 * - `const V* find(const K&)`, returning the cached value or `nullptr`
+	 *   and counting a hit or a miss. The pointer is valid until the cache
+	 *   is next modified.
+	 * - `const V& insert(const K&, V)`, storing a value unless the key
+	 *   already has one, and returning whichever is kept.
+	 * - `template<typename F> V get(const K&, F compute)`, returning the
+	 *   cached result or storing that of `compute()`.
+	 * - `stats()`, `size()` and `clear()`. Clearing keeps the counters.
+	 *
+	 * None of them but concurrent_cache may be used from several threads at
+	 * once. Its `find` and `insert` return copies instead, as a reference
+	 * could be invalidated by another thread.
+	 *
+	 * \ingroup memoize
+	 */
+	template<
+			typename K, typename V,
+			typename H = tuple_hash, typename Eq = std::equal_to<K>
+	>
+	class unbounded_cache {
+	public:
+		using key_type = K;
+		using mapped_type = V;
+
+		unbounded_cache() = default;
+
+		/// Make room for `n` results up front
+		explicit unbounded_cache(std::size_t n) : results(n) {}
+
+		const V* find(const K& k) {
+			auto it = results.find(k);
+			if(it == results.end()) {
+				++counts.misses;
+				return nullptr;
+			}
+
+			++counts.hits;
+			return &it->second;
+		}
+
+		const V& insert(const K& k, V v) {
+			return results.try_emplace(k, std::move(v)).first->second;
+		}
+
+		template<typename F>
+		V get(const K& k, F&& compute) {
+			if(auto v = find(k))
+				return *v;
+
+			// compute may well look up other keys, moving elements about
+			return insert(k, compute());
+		}
+
+		memo_stats stats() const noexcept {
+			return counts;
+		}
+
+		std::size_t size() const noexcept {
+			return results.size();
+		}
+
+		void clear() noexcept {
+			results.clear();
+		}
+
+	private:
+		hash_map<K,V,H,Eq> results;
+		memo_stats counts{0, 0};
+	};
+
+	/**
+	 * Cache of a bounded number of results, evicting the least recently used.
+	 *
+	 * Both hits and insertions count as uses.
+	 *
+	 * \see unbounded_cache for the interface of caches
+	 *
+	 * \ingroup memoize
+	 */
+	template<
+			typename K, typename V,
+			typename H = tuple_hash, typename Eq = std::equal_to<K>
+	>
+	class lru_cache {
+		using entry = std::pair<K,V>;
+		using entry_it = typename std::list<entry>::iterator;
+
+	public:
+		using key_type = K;
+		using mapped_type = V;
+
+		/// Keep at most `capacity` results, which must be at least 1
+		explicit lru_cache(std::size_t capacity)
+		: index(capacity + 1), cap(capacity) {}
+
+		const V* find(const K& k) {
+			auto it = index.find(k);
+			if(it == index.end()) {
+				++counts.misses;
+				return nullptr;
+			}
+
+			++counts.hits;
+			order.splice(order.begin(), order, it->second);
+			return &it->second->second;
+		}
+
+		const V& insert(const K& k, V v) {
+			auto it = index.find(k);
+			if(it != index.end()) {
+				order.splice(order.begin(), order, it->second);
+				return it->second->second;
+			}
+
+			order.emplace_front(k, std::move(v));
+			index.try_emplace(k, order.begin());
+
+			if(order.size() > cap) {
+				index.erase(order.back().first);
+				order.pop_back();
+			}
+
+			return order.front().second;
+		}
+
+		template<typename F>
+		V get(const K& k, F&& compute) {
+			if(auto v = find(k))
+				return *v;
+
+			return insert(k, compute());
+		}
+
+		memo_stats stats() const noexcept {
+			return counts;
+		}
+
+		std::size_t size() const noexcept {
+			return order.size();
+		}
+
+		std::size_t capacity() const noexcept {
+			return cap;
+		}
+
+		void clear() noexcept {
+			index.clear();
+			order.clear();
+		}
+
+	private:
+		std::list<entry> order;
+		hash_map<K,entry_it,H,Eq> index;
+		std::size_t cap;
+		memo_stats counts{0, 0};
+	};
+
+	/**
+	 * Thread safe cache, sharded over a number of other caches.
+	 *
+	 * Every key belongs to one shard, each guarded by a mutex of its own, so
+	 * that threads looking up different keys rarely contend. The lock is not
+	 * held while computing a missing result. Two threads missing the same
+	 * key at once may thus both compute it, after which one result is kept.
+	 *
+	 * \tparam C Cache type of the shards, e.g. ftl::lru_cache
+	 *
+	 * \see unbounded_cache for the interface of caches
+	 *
+	 * \ingroup memoize
+	 */
+	template<
+			typename K, typename V,
+			typename C = unbounded_cache<K,V>, typename H = tuple_hash
+	>
+	class concurrent_cache {
+		struct shard {
+			template<typename...Args>
+			explicit shard(Args&&...args) : cache(std::forward<Args>(args)...) {}
+
+			std::mutex m;
+			C cache;
+		};
+
+	public:
+		using key_type = K;
+		using mapped_type = V;
+
+		/**
+		 * Construct `shards` caches, rounded up to a power of two.
+		 *
+		 * Each shard's cache is constructed from `args`. To bound an LRU
+		 * cache to `n` results overall, give every shard `n / shards`.
+		 */
+		template<typename...Args>
+		explicit concurrent_cache(std::size_t shards = 16, const Args&...args) {
+			while((std::size_t(1) << bits) < shards)
+				++bits;
+
+			for(std::size_t i = 0; i < (std::size_t(1) << bits); ++i)
+				parts.emplace_back(new shard(args...));
+		}
+
+		/// Copy of the cached result, if any, counting a hit or miss
+		maybe<V> find(const K& k) {
+			auto& s = shard_of(k);
+			std::lock_guard<std::mutex> lock(s.m);
+
+			if(auto v = s.cache.find(k))
+				return just(*v);
+
+			return nothing<V>();
+		}
+
+		V insert(const K& k, V v) {
+			auto& s = shard_of(k);
+			std::lock_guard<std::mutex> lock(s.m);
+			return s.cache.insert(k, std::move(v));
+		}
+
+		template<typename F>
+		V get(const K& k, F&& compute) {
+			auto& s = shard_of(k);
+			{
+				std::lock_guard<std::mutex> lock(s.m);
+				if(auto v = s.cache.find(k))
+					return *v;
+			}
+
+			auto v = compute();
+
+			std::lock_guard<std::mutex> lock(s.m);
+			return s.cache.insert(k, std::move(v));
+		}
+
+		/// Sum of the counters of every shard
+		memo_stats stats() const {
+			memo_stats r{0, 0};
+			for(auto& s : parts) {
+				std::lock_guard<std::mutex> lock(s->m);
+				auto st = s->cache.stats();
+				r.hits += st.hits;
+				r.misses += st.misses;
+			}
+
+			return r;
+		}
+
+		std::size_t size() const {
+			std::size_t n = 0;
+			for(auto& s : parts) {
+				std::lock_guard<std::mutex> lock(s->m);
+				n += s->cache.size();
+			}
+
+			return n;
+		}
+
+		void clear() {
+			for(auto& s : parts) {
+				std::lock_guard<std::mutex> lock(s->m);
+				s->cache.clear();
+			}
+		}
+
+	private:
+		// The high bits pick the shard, leaving the low ones for its table
+		shard& shard_of(const K& k) const {
+			if(bits == 0)
+				return *parts.front();
+
+			auto h = _dtl::mix_hash(H()(k));
+			return *parts[h >> (std::numeric_limits<std::size_t>::digits - bits)];
+		}
+
+		std::vector<std::unique_ptr<shard>> parts;
+		std::size_t bits = 0;
+	};
+
+	namespace _dtl {
+		template<typename F, typename C, typename R, typename...Ps>
+		struct memoized {
+			R operator() (Ps...ps) const {
+				return cache->get(
+					memo_key<Ps...>(ps...),
+					[&]() -> R { return f(std::forward<Ps>(ps)...); }
+				);
+			}
+
+			F f;
+			std::shared_ptr<C> cache;
+		};
+
+		template<typename R, typename...Ps>
+		using default_memo_cache = unbounded_cache<memo_key<Ps...>,plain_type<R>>;
+	}
+
+	/**
+	 * Memoise a pure function.
+	 *
+	 * Returns a function of the same signature, which only calls `f` for
+	 * arguments it has not seen before. Results are kept in `cache`, which
+	 * may be shared with other memoised functions of the same signature, and
+	 * is how its hit and miss counters are read:
+	 * \code
+	 *   auto cache = std::make_shared<ftl::lru_cache<ftl::memo_key<int>,int>>(64);
+	 *   auto g = ftl::memoize(expensive, cache);
+	 *
+	 *   g(1); g(1);
+	 *   // cache->stats().hits == 1, cache->stats().misses == 1
+	 * \endcode
+	 *
+	 * Copies of the returned function share the cache. An
+	 * ftl::concurrent_cache is needed for it to be called from several
+	 * threads at once.
+	 *
+	 * Both the parameter types and `R` must be copyable, and the former also
+	 * hashable and equality comparable. `R` may not be a reference.
+	 *
+	 * \ingroup memoize
+	 */
+	template<
+			typename R, typename...Ps,
+			typename C = _dtl::default_memo_cache<R,Ps...>
+	>
+	function<R(Ps...)> memoize(
+			R (*f) (Ps...), std::shared_ptr<C> cache = std::make_shared<C>()) {
+		static_assert(
+			!std::is_reference<R>::value,
+			"Functions returning references cannot be memoised"
+		);
+
+		return _dtl::memoized<R(*)(Ps...),C,R,Ps...>{f, std::move(cache)};
+	}
+
+	/// \overload
+	template<
+			typename R, typename...Ps, std::size_t N,
+			typename C = _dtl::default_memo_cache<R,Ps...>
+	>
+	function<R(Ps...)> memoize(
+			function<R(Ps...),N> f,
+			std::shared_ptr<C> cache = std::make_shared<C>()) {
+		static_assert(
+			!std::is_reference<R>::value,
+			"Functions returning references cannot be memoised"
+		);
+
+		return _dtl::memoized<function<R(Ps...),N>,C,R,Ps...>{
+			std::move(f), std::move(cache)
+		};
+	}
+
+	/// \overload
+	template<
+			typename R, typename...Ps,
+			typename C = _dtl::default_memo_cache<R,Ps...>
+	>
+	function<R(Ps...)> memoize(
+			std::function<R(Ps...)> f,
+			std::shared_ptr<C> cache = std::make_shared<C>()) {
+		static_assert(
+			!std::is_reference<R>::value,
+			"Functions returning references cannot be memoised"
+		);
+
+		return _dtl::memoized<std::function<R(Ps...)>,C,R,Ps...>{
+			std::move(f), std::move(cache)
+		};
+	}
+}
+
+#endif
+
@@ -33,17 +33,25 @@ namespace ftl {
 	/**
 	 * \defgroup memory Memory
 	 *
-	 * Concepts instances for std::shared_ptr.
+	 * Concepts instances for std::shared_ptr and std::unique_ptr.
 	 *
 	 * \code
 	 *   #include <ftl/memory.h>
 	 * \endcode
 	 *
-	 * This module adds the following concept instances to std::share_ptr:
+	 * This module adds the following concept instances to std::share_ptr and
+	 * std::unique_ptr:
 	 * - \ref monoid
 	 * - \ref functor
 	 * - \ref applicative
 	 * - \ref monad
+	 * - \ref foldable
+	 *
+	 * A unique_ptr, which always owns its object alone, has its object
+	 * updated in place whenever a function from `T` to `T` is mapped over it
+	 * as an rvalue. Shared pointers only do so when asked to, through
+	 * `map_in_place` and `append_in_place`, as no count of owners can tell
+	 * whether a `std::weak_ptr` is still watching the object.
 	 *
 	 * \par Dependencies
 	 * - <memory>
@@ -52,6 +60,73 @@ namespace ftl {
 	 * - \ref foldable
 	 */
 
+	namespace _dtl {
+		// Whether mapping a shared_ptr<T> to a shared_ptr<U> can be in place
+		template<typename T, typename U>
+		using shared_reusable = std::integral_constant<
+			bool,
+			std::is_same<T,U>::value && std::is_move_assignable<T>::value
+		>;
+
+		// Map the object of a non-null p, in place if p is its sole owner
+		template<typename U, typename T, typename F>
+		std::shared_ptr<U> shared_map(
+				F& f, std::shared_ptr<T> p, std::true_type) {
+			if(p.use_count() == 1) {
+				*p = f(std::move(*p));
+				return p;
+			}
+
+			return std::make_shared<U>(f(*p));
+		}
+
+		template<typename U, typename T, typename F>
+		std::shared_ptr<U> shared_map(
+				F& f, std::shared_ptr<T> p, std::false_type) {
+			return std::make_shared<U>(f(*p));
+		}
+
+		// Append b to the object of a non-null a, in place if a is its sole owner
+		template<typename T>
+		std::shared_ptr<T> shared_append(
+				std::shared_ptr<T> a, const T& b, std::true_type) {
+			if(a.use_count() == 1) {
+				*a = monoid<T>::append(std::move(*a), b);
+				return a;
+			}
+
+			return std::make_shared<T>(monoid<T>::append(*a, b));
+		}
+
+		template<typename T>
+		std::shared_ptr<T> shared_append(
+				std::shared_ptr<T> a, const T& b, std::false_type) {
+			return std::make_shared<T>(monoid<T>::append(*a, b));
+		}
+
+		// Map the object of a non-null unique_ptr rvalue, in place if possible
+		template<typename U, typename T, typename D, typename F>
+		std::unique_ptr<T,D> unique_map(
+				F& f, std::unique_ptr<T,D>&& p, std::true_type) {
+			*p = f(std::move(*p));
+			return std::move(p);
+		}
+
+		template<typename U, typename T, typename D, typename F>
+		std::unique_ptr<U> unique_map(
+				F& f, std::unique_ptr<T,D>&& p, std::false_type) {
+			return std::unique_ptr<U>(new U(f(std::move(*p))));
+		}
+
+		// Result of mapping an F over a unique_ptr<T,D> rvalue
+		template<typename T, typename D, typename U>
+		using unique_mapped = typename std::conditional<
+			shared_reusable<T,U>::value,
+			std::unique_ptr<T,D>,
+			std::unique_ptr<U>
+		>::type;
+	}
+
 	/**
 	 * Monoid instance for shared_ptr.
 	 *
@@ -82,6 +157,8 @@ namespace ftl {
 		 * And finally, if both the pointers point to some object, then
 		 * \c make_shared is invoked to create a new object that is the result
 		 * of applying the monoid operation on the two values.
+		 *
+		 * \see append_in_place
 		 */
 		static auto append(
 				std::shared_ptr<T> a,
@@ -113,6 +190,11 @@ namespace ftl {
 	/**
 	 * Monad instance of shared_ptr.
 	 *
+	 * Mapping always makes a new object, leaving the one mapped over as it
+	 * was for anyone else still looking at it.
+	 *
+	 * \see map_in_place
+	 *
 	 * \ingroup memory
 	 */
 	template<typename T>
@@ -124,6 +206,10 @@ namespace ftl {
 			return std::make_shared<T>(std::forward<T>(a));
 		}
 
+		static std::shared_ptr<T> pure(const T& a) {
+			return std::make_shared<T>(a);
+		}
+
 		template<typename F, typename U = result_of<F(T)>>
 		static std::shared_ptr<U> map(F f, std::shared_ptr<T> p) {
 			if(p)
@@ -183,6 +269,363 @@ namespace ftl {
 
 		static constexpr bool instance = true;
 	};
+
+	/**
+	 * Allocator aware version of `fmap` for shared_ptr.
+	 *
+	 * Behaves like `monad<std::shared_ptr<T>>::map`, except any new object is
+	 * created using `std::allocate_shared` with `alloc`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::monotonic_buffer_resource arena;
+	 *   ftl::resource_allocator<int> alloc(&arena);
+	 *
+	 *   auto p = std::allocate_shared<int>(alloc, 2);
+	 *   auto q = ftl::allocate_map(alloc, [](int x){ return x * 1.5f; }, p);
+	 * \endcode
+	 *
+	 * \ingroup memory
+	 */
+	template<
+			typename A,
+			typename F,
+			typename T,
+			typename U = result_of<F(T)>
+	>
+	std::shared_ptr<U> allocate_map(const A& alloc, F f, std::shared_ptr<T> p) {
+		if(p)
+			return std::allocate_shared<U>(alloc, f(*p));
+
+		return std::shared_ptr<U>();
+	}
+
+	/**
+	 * Map `f` over `p`, reusing its object if `p` is the sole owner.
+	 *
+	 * `f` must be a function from `T` to `T`, and `T` move assignable, for
+	 * the object to be reused; otherwise, or if anything else shares the
+	 * object, this is the same as `fmap`.
+	 *
+	 * \warning Only owners are counted. A `std::weak_ptr` to the object,
+	 *          including one kept by `enable_shared_from_this` within it,
+	 *          may still lock it afterwards and see it changed. Nor may
+	 *          another thread be copying `p` meanwhile. Use this only on
+	 *          objects known to have no such observers.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto p = std::make_shared<std::vector<int>>(1000, 1);
+	 *   auto q = ftl::map_in_place(sort_vector, std::move(p));
+	 *   // q points to the same vector, now sorted
+	 * \endcode
+	 *
+	 * \ingroup memory
+	 */
+	template<typename F, typename T, typename U = result_of<F(T)>>
+	std::shared_ptr<U> map_in_place(F f, std::shared_ptr<T> p) {
+		if(p)
+			return _dtl::shared_map<U>(
+				f, std::move(p), _dtl::shared_reusable<T,U>{}
+			);
+
+		return std::shared_ptr<U>();
+	}
+
+	/**
+	 * Monoid append of `a` and `b`, updating `a`'s object if it is the sole
+	 * owner.
+	 *
+	 * Otherwise the same as `monoid<std::shared_ptr<T>>::append`, and with
+	 * the same caveats on observers that `map_in_place` has.
+	 *
+	 * \ingroup memory
+	 */
+	template<
+			typename T,
+			typename = typename std::enable_if<monoid<T>::instance>::type
+	>
+	std::shared_ptr<T> append_in_place(
+			std::shared_ptr<T> a, const std::shared_ptr<T>& b) {
+		if(a && b)
+			return _dtl::shared_append<T>(
+				std::move(a), *b, _dtl::shared_reusable<T,T>{}
+			);
+
+		return monoid<std::shared_ptr<T>>::append(std::move(a), b);
+	}
+
+	/**
+	 * Pointer to a member of the object `p` points to.
+	 *
+	 * The result shares ownership with `p`, keeping the whole object alive,
+	 * but nothing is allocated and no copy of the member made. A null `p`
+	 * gives a null result.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   struct config { std::string name; int port; };
+	 *
+	 *   auto c = std::make_shared<config>(config{"ftl", 80});
+	 *   std::shared_ptr<int> port = ftl::project(c, &config::port);
+	 * \endcode
+	 *
+	 * \ingroup memory
+	 */
+	template<typename T, typename M>
+	std::shared_ptr<M> project(const std::shared_ptr<T>& p, M T::*m) noexcept {
+		if(p)
+			return std::shared_ptr<M>(p, &((*p).*m));
+
+		return std::shared_ptr<M>();
+	}
+
+	/// \overload
+	template<typename T, typename M>
+	std::shared_ptr<const M> project(
+			const std::shared_ptr<const T>& p, M T::*m) noexcept {
+		if(p)
+			return std::shared_ptr<const M>(p, &((*p).*m));
+
+		return std::shared_ptr<const M>();
+	}
+
+	/**
+	 * Parametric type traits for unique_ptr.
+	 *
+	 * Rebinding drops any custom deleter, as it could not be expected to
+	 * delete objects of another type.
+	 *
+	 * \ingroup memory
+	 */
+	template<typename T, typename D>
+	struct parametric_type_traits<std::unique_ptr<T,D>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = std::unique_ptr<U>;
+	};
+
+	/**
+	 * Monoid instance for unique_ptr.
+	 *
+	 * Works just like the one for shared_ptr, except a null \c a or \c b
+	 * given by const reference means the other pointer's object must be
+	 * copied. When \c a is an rvalue pointing to an object, the result of
+	 * the append is assigned to that object and \c a returned.
+	 *
+	 * \ingroup memory
+	 */
+	template<typename T>
+	struct monoid<std::unique_ptr<T>> {
+		/// Simply creates an "empty" pointer.
+		static constexpr auto id() noexcept
+		-> typename std::enable_if<
+				monoid<T>::instance,
+				std::unique_ptr<T>>::type {
+			return std::unique_ptr<T>();
+		}
+
+		static std::unique_ptr<T> append(
+				std::unique_ptr<T>&& a, const std::unique_ptr<T>& b) {
+			if(a && b)
+				*a = monoid<T>::append(std::move(*a), *b);
+			else if(b)
+				return copy(b);
+
+			return std::move(a);
+		}
+
+		/// \overload
+		static std::unique_ptr<T> append(
+				std::unique_ptr<T>&& a, std::unique_ptr<T>&& b) {
+			if(a) {
+				if(b)
+					*a = monoid<T>::append(std::move(*a), std::move(*b));
+
+				return std::move(a);
+			}
+
+			return std::move(b);
+		}
+
+		/// \overload
+		static std::unique_ptr<T> append(
+				const std::unique_ptr<T>& a, std::unique_ptr<T>&& b) {
+			if(a && b)
+				*b = monoid<T>::append(*a, std::move(*b));
+			else if(a)
+				return copy(a);
+
+			return std::move(b);
+		}
+
+		/// \overload
+		static std::unique_ptr<T> append(
+				const std::unique_ptr<T>& a, const std::unique_ptr<T>& b) {
+			if(a && b)
+				return std::unique_ptr<T>(new T(monoid<T>::append(*a, *b)));
+
+			return copy(a ? a : b);
+		}
+
+		/// \c unique_ptr is only a monoid instance if T is.
+		static constexpr bool instance = monoid<T>::instance;
+
+	private:
+		static std::unique_ptr<T> copy(const std::unique_ptr<T>& p) {
+			return p ? std::unique_ptr<T>(new T(*p)) : std::unique_ptr<T>();
+		}
+	};
+
+	/**
+	 * Monad instance of unique_ptr.
+	 *
+	 * Mapping a function from `T` to `T` over a unique_ptr rvalue assigns
+	 * the result to the object already pointed to and hands back the same
+	 * pointer, deleter and all. In every other case a new object is created
+	 * with `new`, owned by a `std::unique_ptr` with the default deleter.
+	 *
+	 * Null pointers are treated like `nothing`, mapping and binding to
+	 * another null pointer.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto p = ftl::monad<std::unique_ptr<int>>::pure(2);
+	 *   auto q = [](int x){ return x * 2; } % std::move(p);
+	 * \endcode
+	 *
+	 * \ingroup memory
+	 */
+	template<typename T, typename D>
+	struct monad<std::unique_ptr<T,D>> {
+
+		static std::unique_ptr<T> pure(T&& a) {
+			return std::unique_ptr<T>(new T(std::move(a)));
+		}
+
+		static std::unique_ptr<T> pure(const T& a) {
+			return std::unique_ptr<T>(new T(a));
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static std::unique_ptr<U> map(F f, const std::unique_ptr<T,D>& p) {
+			if(p)
+				return std::unique_ptr<U>(new U(f(*p)));
+
+			return std::unique_ptr<U>();
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static _dtl::unique_mapped<T,D,U> map(F f, std::unique_ptr<T,D>&& p) {
+			if(p)
+				return _dtl::unique_map<U>(
+					f, std::move(p), _dtl::shared_reusable<T,U>{}
+				);
+
+			return _dtl::unique_mapped<T,D,U>();
+		}
+
+		template<
+				typename F,
+				typename U = typename result_of<F(T)>::element_type
+		>
+		static std::unique_ptr<U> bind(const std::unique_ptr<T,D>& a, F f) {
+			if(a)
+				return f(*a);
+
+			return std::unique_ptr<U>();
+		}
+
+		template<
+				typename F,
+				typename U = typename result_of<F(T)>::element_type
+		>
+		static std::unique_ptr<U> bind(std::unique_ptr<T,D>&& a, F f) {
+			if(a)
+				return f(std::move(*a));
+
+			return std::unique_ptr<U>();
+		}
+
+		template<
+				typename F,
+				typename U = result_of<F(T)>,
+				typename E
+		>
+		static std::unique_ptr<U> apply(
+				const std::unique_ptr<F,E>& f, const std::unique_ptr<T,D>& p) {
+			if(f && p)
+				return std::unique_ptr<U>(new U((*f)(*p)));
+
+			return std::unique_ptr<U>();
+		}
+
+		template<
+				typename F,
+				typename U = result_of<F(T)>,
+				typename E
+		>
+		static std::unique_ptr<U> apply(
+				const std::unique_ptr<F,E>& f, std::unique_ptr<T,D>&& p) {
+			if(f && p)
+				return std::unique_ptr<U>(new U((*f)(std::move(*p))));
+
+			return std::unique_ptr<U>();
+		}
+
+		/// Moves the inner pointer out of the outer one
+		template<typename E>
+		static std::unique_ptr<T,E> join(
+				std::unique_ptr<std::unique_ptr<T,E>,D>&& m) {
+			if(m)
+				return std::move(*m);
+
+			return std::unique_ptr<T,E>();
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for unique_ptr
+	 *
+	 * \ingroup memory
+	 */
+	template<typename T, typename D>
+	struct foldable<std::unique_ptr<T,D>>
+	: deriving_foldMap<std::unique_ptr<T,D>>
+	, deriving_fold<std::unique_ptr<T,D>> {
+		template<
+				typename Fn,
+				typename U,
+				typename = Requires<std::is_same<U, result_of<Fn(U,T)>>::value>
+		>
+		static U foldl(Fn&& fn, U z, const std::unique_ptr<T,D>& p) {
+			if(p)
+				return fn(std::move(z), *p);
+
+			return z;
+		}
+
+		template<
+				typename Fn,
+				typename U,
+				typename = Requires<std::is_same<U, result_of<Fn(T,U)>>::value>
+		>
+		static U foldr(Fn&& fn, U z, const std::unique_ptr<T,D>& p) {
+			if(p)
+				return fn(*p, std::move(z));
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
 }
 
 #endif
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_MEMORY_RESOURCE_H
+#define FTL_MEMORY_RESOURCE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include "instrument.h"
+
+namespace ftl {
+	/**
+	 * \defgroup memory_resource Memory resource
+	 *
+	 * Polymorphic memory resources and an allocator that draws from them.
+	 *
+	 * Lets a whole computation graph&mdash;thunks, lazy cells, containers
+	 * built by combinators&mdash;be allocated from e.g. one monotonic buffer,
+	 * which is then released in one go rather than one node at a time.
+	 *
+	 * \code
+	 *   #include <ftl/memory_resource.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<algorithm>`
+	 * - `<cstddef>`
+	 * - `<cstdint>`
+	 * - `<new>`
+	 */
+
+	/**
+	 * Interface of a source of raw memory.
+	 *
+	 * Mirrors `std::pmr::memory_resource`. Implementations override the
+	 * private `do_` methods.
+	 *
+	 * \ingroup memory_resource
+	 */
+	class memory_resource {
+	public:
+		/// Largest alignment that is guaranteed to be honoured
+		static constexpr std::size_t max_align = alignof(std::max_align_t);
+
+		virtual ~memory_resource() = default;
+
+		/// Allocate at least `bytes` bytes aligned to `alignment`
+		void* allocate(std::size_t bytes, std::size_t alignment = max_align) {
+			return do_allocate(bytes, alignment);
+		}
+
+		/// Return memory acquired through `allocate` with the same arguments
+		void deallocate(
+				void* p, std::size_t bytes, std::size_t alignment = max_align
+		) {
+			do_deallocate(p, bytes, alignment);
+		}
+
+		/**
+		 * Check if memory allocated from `this` can be released by `other`.
+		 */
+		bool is_equal(const memory_resource& other) const noexcept {
+			return do_is_equal(other);
+		}
+
+	private:
+		virtual void* do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+
+		virtual void do_deallocate(
+				void* p, std::size_t bytes, std::size_t alignment) = 0;
+
+		virtual bool do_is_equal(const memory_resource&) const noexcept = 0;
+	};
+
+	namespace _dtl {
+		class new_delete_resource_t : public memory_resource {
+			void* do_allocate(std::size_t bytes, std::size_t) override {
+				FTL_COUNT_ALLOCATION(memory_resource, bytes);
+				return ::operator new(bytes);
+			}
+
+			void do_deallocate(void* p, std::size_t, std::size_t) override {
+				::operator delete(p);
+			}
+
+			bool do_is_equal(const memory_resource& other) const noexcept
+			override {
+				return this == &other;
+			}
+		};
+	}
+
+	/**
+	 * Memory resource using the global `operator new` and `operator delete`.
+	 *
+	 * This is the default resource of ftl::resource_allocator.
+	 *
+	 * \ingroup memory_resource
+	 */
+	inline memory_resource* new_delete_resource() noexcept {
+		static _dtl::new_delete_resource_t resource;
+		return &resource;
+	}
+
+	/**
+	 * Memory resource that only ever grows.
+	 *
+	 * Allocation is a pointer bump into the current block; when it runs out,
+	 * a new, larger block is requested from the upstream resource.
+	 * Deallocation does nothing. All memory is handed back to upstream at
+	 * once, by `release()` or by destroying the resource.
+	 *
+	 * Not thread safe.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::monotonic_buffer_resource arena;
+	 *   ftl::resource_allocator<int> alloc(&arena);
+	 *
+	 *   auto l = ftl::lazy<int>(std::allocator_arg, alloc, []{ return 12; });
+	 *   auto l2 = (+[](int x){ return x*2; }) % l;  // also built in arena
+	 * \endcode
+	 *
+	 * \ingroup memory_resource
+	 */
+	class monotonic_buffer_resource : public memory_resource {
+	public:
+		explicit monotonic_buffer_resource(
+				memory_resource* upstream = new_delete_resource()
+		) noexcept
+		: upstream(upstream) {}
+
+		/// Make the first block requested from `upstream` `initial_size` big
+		explicit monotonic_buffer_resource(
+				std::size_t initial_size,
+				memory_resource* upstream = new_delete_resource()
+		) noexcept
+		: upstream(upstream)
+		, next_size(std::max(initial_size, std::size_t(min_block))) {}
+
+		/// Allocate from `buffer` before turning to `upstream`
+		monotonic_buffer_resource(
+				void* buffer, std::size_t size,
+				memory_resource* upstream = new_delete_resource()
+		) noexcept
+		: upstream(upstream), initial(buffer), initial_size(size)
+		, current(static_cast<char*>(buffer)), space(size)
+		, next_size(std::max(size, std::size_t(min_block))) {}
+
+		monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+		monotonic_buffer_resource& operator= (
+				const monotonic_buffer_resource&) = delete;
+
+		~monotonic_buffer_resource() {
+			release();
+		}
+
+		/**
+		 * Hand all allocated blocks back to the upstream resource.
+		 *
+		 * Any initial buffer is reused by subsequent allocations.
+		 */
+		void release() noexcept {
+			while(blocks) {
+				block* b = blocks;
+				blocks = b->next;
+				upstream->deallocate(b, b->size, alignof(block));
+			}
+
+			current = static_cast<char*>(initial);
+			space = initial_size;
+		}
+
+		memory_resource* upstream_resource() const noexcept {
+			return upstream;
+		}
+
+	private:
+		// Header of every block acquired from upstream
+		struct block {
+			block* next;
+			std::size_t size;
+		};
+
+		static constexpr std::size_t min_block = 1024;
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			void* p = align(bytes, alignment);
+			if(!p) {
+				grow(bytes, alignment);
+				p = align(bytes, alignment);
+			}
+
+			current = static_cast<char*>(p) + bytes;
+			space -= bytes;
+			return p;
+		}
+
+		void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+		bool do_is_equal(const memory_resource& other) const noexcept
+		override {
+			return this == &other;
+		}
+
+		// Align current to alignment, if there is room enough for bytes
+		void* align(std::size_t bytes, std::size_t alignment) noexcept {
+			if(!current)
+				return nullptr;
+
+			auto address = reinterpret_cast<std::uintptr_t>(current);
+			std::size_t pad = (alignment - address % alignment) % alignment;
+			if(space < pad || space - pad < bytes)
+				return nullptr;
+
+			current += pad;
+			space -= pad;
+			return current;
+		}
+
+		void grow(std::size_t bytes, std::size_t alignment) {
+			std::size_t size = std::max(
+				next_size, sizeof(block) + bytes + alignment
+			);
+
+			block* b = static_cast<block*>(
+				upstream->allocate(size, alignof(block))
+			);
+
+			b->next = blocks;
+			b->size = size;
+			blocks = b;
+
+			current = reinterpret_cast<char*>(b + 1);
+			space = size - sizeof(block);
+			next_size = size * 2;
+		}
+
+		memory_resource* upstream;
+		void* initial = nullptr;
+		std::size_t initial_size = 0;
+		block* blocks = nullptr;
+		char* current = nullptr;
+		std::size_t space = 0;
+		std::size_t next_size = min_block;
+	};
+
+	/**
+	 * Allocator that draws memory from a memory_resource.
+	 *
+	 * Mirrors `std::pmr::polymorphic_allocator`, except that copies of a
+	 * container keep the resource of the original. This is what allows
+	 * combinators to propagate it to the values they build.
+	 *
+	 * The resource is not owned and must outlive anything allocated with it.
+	 *
+	 * \ingroup memory_resource
+	 */
+	template<typename T>
+	class resource_allocator {
+	public:
+		using value_type = T;
+
+		/// Allocate from ftl::new_delete_resource()
+		resource_allocator() noexcept : r(new_delete_resource()) {}
+
+		resource_allocator(memory_resource* r) noexcept : r(r) {}
+
+		template<typename U>
+		resource_allocator(const resource_allocator<U>& a) noexcept
+		: r(a.resource()) {}
+
+		T* allocate(std::size_t n) {
+			return static_cast<T*>(r->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* p, std::size_t n) {
+			r->deallocate(p, n * sizeof(T), alignof(T));
+		}
+
+		memory_resource* resource() const noexcept {
+			return r;
+		}
+
+	private:
+		memory_resource* r;
+	};
+
+	/// \ingroup memory_resource
+	template<typename T, typename U>
+	bool operator== (
+			const resource_allocator<T>& a, const resource_allocator<U>& b
+	) noexcept {
+		return a.resource() == b.resource()
+			|| a.resource()->is_equal(*b.resource());
+	}
+
+	/// \ingroup memory_resource
+	template<typename T, typename U>
+	bool operator!= (
+			const resource_allocator<T>& a, const resource_allocator<U>& b
+	) noexcept {
+		return !(a == b);
+	}
+}
+
+#endif
+
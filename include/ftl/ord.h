@@ -162,12 +162,87 @@ namespace ftl {
 		return lhs < rhs ? ord::Lt : (lhs == rhs ? ord::Eq : ord::Gt);
 	}
 
+	namespace _dtl {
+		template<typename T>
+		struct is_comparator : std::false_type {};
+
+		template<typename T>
+		struct default_comparator {
+			ord operator() (const T& a, const T& b) const {
+				return compare(a, b);
+			}
+		};
+
+		template<typename A, typename R>
+		struct method_comparator {
+			ord operator() (const A& a, const A& b) const {
+				return compare((a.*method)(), (b.*method)());
+			}
+
+			R (A::*method)() const;
+		};
+
+		template<typename A, typename R>
+		struct member_comparator {
+			ord operator() (const A& a, const A& b) const {
+				return compare(a.*member, b.*member);
+			}
+
+			R A::*member;
+		};
+
+		template<typename F>
+		struct projection_comparator {
+			template<typename A>
+			ord operator() (const A& a, const A& b) const {
+				return compare(f(a), f(b));
+			}
+
+			F f;
+		};
+
+		// Only asks c2 when c1 finds a and b equal
+		template<typename C1, typename C2>
+		struct comparator_chain {
+			template<typename A>
+			ord operator() (const A& a, const A& b) const {
+				ord o = c1(a, b);
+				return o == ord::Eq ? ord(c2(a, b)) : o;
+			}
+
+			C1 c1;
+			C2 c2;
+		};
+
+		template<typename T>
+		struct is_comparator<default_comparator<T>> : std::true_type {};
+
+		template<typename A, typename R>
+		struct is_comparator<method_comparator<A,R>> : std::true_type {};
+
+		template<typename A, typename R>
+		struct is_comparator<member_comparator<A,R>> : std::true_type {};
+
+		template<typename F>
+		struct is_comparator<projection_comparator<F>> : std::true_type {};
+
+		template<typename C1, typename C2>
+		struct is_comparator<comparator_chain<C1,C2>> : std::true_type {};
+	}
+
 	/**
 	 * Convenience function to get a comparator for a certain type.
 	 *
 	 * This can be a very useful function for compositional purposes. I.e.,
-	 * it is possible to compose a comparator using the composite \ref monoidpg
-	 * instance of `ftl::function` and `ftl::ord`.
+	 * it is possible to compose comparators with `operator^`, which compares
+	 * by its right-hand side wherever its left-hand side finds the elements
+	 * equal.
+	 *
+	 * The comparators returned by `getComparator` and `comparing`, and those
+	 * composed of them, are small function objects of distinct types rather
+	 * than `ftl::function`s. Calls to them can thus be inlined all the way
+	 * down, in e.g. `std::sort`. They convert to `ftl::function` where type
+	 * erasure is wanted.
 	 *
 	 * Example:
 	 * \code
@@ -182,8 +257,13 @@ namespace ftl {
 	 * \ingroup ord
 	 */
 	template<typename T>
-	function<ord(const T&,const T&)> getComparator() {
-		return [] ( const T& a, const T& b) { return compare(a, b); };
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::default_comparator<T>
+#else
+	ImplementationDefined
+#endif
+	getComparator() {
+		return _dtl::default_comparator<T>{};
 	}
 
 	/**
@@ -213,6 +293,47 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	/**
+	 * Composes two comparators, the second breaking ties of the first.
+	 *
+	 * Applies whenever either side is one of the comparators of this module,
+	 * the other side being any function object giving an `ord`, e.g. an
+	 * `ftl::function`. The result compares like `monoid<ord>::append` of
+	 * both comparisons, except that the right-hand side is only called for
+	 * elements that the left-hand side finds equal.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   using ftl::operator^;
+	 *
+	 *   auto by_name_then_age =
+	 *       ftl::comparing(&person::name) ^ ftl::comparing(&person::age);
+	 *
+	 *   std::sort(v.begin(), v.end(), ftl::asc(by_name_then_age));
+	 * \endcode
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename C1,
+			typename C2,
+			typename = Requires<
+				_dtl::is_comparator<plain_type<C1>>::value
+				|| _dtl::is_comparator<plain_type<C2>>::value
+			>
+	>
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::comparator_chain<plain_type<C1>,plain_type<C2>>
+#else
+	ImplementationDefined
+#endif
+	operator^ (C1&& c1, C2&& c2) {
+		return _dtl::comparator_chain<plain_type<C1>,plain_type<C2>>{
+			std::forward<C1>(c1), std::forward<C2>(c2)
+		};
+	}
+
 	/**
 	 * Convenience function to compare objects by getter.
 	 *
@@ -239,10 +360,47 @@ namespace ftl {
 			typename R,
 			typename = Requires<Orderable<R>{}>
 	>
-	function<ord(const A&,const A&)> comparing(R (A::*method)() const) {
-		return [=] (const A& a, const A& b) {
-			return compare((a.*method)(), (b.*method)());
-		};
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::method_comparator<A,R>
+#else
+	ImplementationDefined
+#endif
+	comparing(R (A::*method)() const) {
+		return _dtl::method_comparator<A,R>{method};
+	}
+
+	/**
+	 * Convenience function to compare objects by data member.
+	 *
+	 * \tparam R Must satisfy \ref orderablepg.
+	 *
+	 * Example:
+	 * \code
+	 *   vector<pair<string,int>> v{{"b", 2}, {"a", 2}, {"c", 1}};
+	 *
+	 *   sort(v.begin(), v.end(), asc(
+	 *       comparing(&pair<string,int>::second)
+	 *       ^ comparing(&pair<string,int>::first)
+	 *   ));
+	 * \endcode
+	 * Resulting vector: `{{"c", 1}, {"a", 2}, {"b", 2}}`
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename A,
+			typename R,
+			typename = Requires<
+				!std::is_function<R>::value && Orderable<R>{}
+			>
+	>
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::member_comparator<A,R>
+#else
+	ImplementationDefined
+#endif
+	comparing(R A::*member) {
+		return _dtl::member_comparator<A,R>{member};
 	}
 
 	/**
@@ -273,9 +431,63 @@ namespace ftl {
 			typename B,
 			typename = Requires<Orderable<B>{}>
 	>
-	function<ord(A,A)> comparing(function<B(A)> f) {
-		return [=] (A a, A b) {
-			return compare(f(a), f(b));
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::projection_comparator<function<B(A)>>
+#else
+	ImplementationDefined
+#endif
+	comparing(function<B(A)> f) {
+		return _dtl::projection_comparator<function<B(A)>>{std::move(f)};
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Takes any function object, such as a lambda, without erasing its type.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto by_length = comparing([](const string& s){ return s.size(); });
+	 * \endcode
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename F,
+			typename = Requires<
+				!std::is_member_pointer<plain_type<F>>::value
+			>
+	>
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::projection_comparator<plain_type<F>>
+#else
+	ImplementationDefined
+#endif
+	comparing(F&& f) {
+		return _dtl::projection_comparator<plain_type<F>>{std::forward<F>(f)};
+	}
+
+	namespace _dtl {
+		// Predicate checking a comparison for a particular ordering
+		template<typename A, ord::ordering O>
+		struct ordering_is {
+			bool operator() (const A& a, const A& b) const {
+				return cmp(a, b) == O;
+			}
+
+			function_ref<ord(const A&,const A&)> cmp;
+		};
+
+		// Same as ordering_is, for one of the comparators above
+		template<typename Cmp, ord::ordering O>
+		struct ordering_by {
+			template<typename A>
+			bool operator() (const A& a, const A& b) const {
+				return cmp(a, b) == O;
+			}
+
+			Cmp cmp;
 		};
 	}
 
@@ -297,6 +509,53 @@ namespace ftl {
 		};
 	}
 
+	/**
+	 * \overload
+	 *
+	 * Takes `cmp` by `function_ref`, see there for when that pays off.
+	 *
+	 * \warning The predicate refers to `cmp` and must not outlive it.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto cmp = comparing(&string::size);
+	 *   function_ref<ord(const string&,const string&)> ref = cmp;
+	 *
+	 *   sort(v.begin(), v.end(), asc(ref));
+	 * \endcode
+	 *
+	 * \ingroup ord
+	 */
+	template<typename A>
+	_dtl::ordering_is<A,ord::Lt> asc(function_ref<ord(const A&,const A&)> cmp)
+	noexcept {
+		return _dtl::ordering_is<A,ord::Lt>{cmp};
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Keeps the type of a comparator from `comparing`, `getComparator` or
+	 * `operator^`, so that the whole comparison can be inlined.
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename Cmp,
+			typename = Requires<_dtl::is_comparator<plain_type<Cmp>>::value>
+	>
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::ordering_by<plain_type<Cmp>,ord::Lt>
+#else
+	ImplementationDefined
+#endif
+	asc(Cmp&& cmp) {
+		return _dtl::ordering_by<plain_type<Cmp>,ord::Lt>{
+			std::forward<Cmp>(cmp)
+		};
+	}
+
 	/**
 	 * Convenience function to ease integration with stdlib's sort.
 	 *
@@ -315,6 +574,53 @@ namespace ftl {
 		};
 	}
 
+	/**
+	 * \overload
+	 *
+	 * Takes `cmp` by `function_ref`, see there for when that pays off.
+	 *
+	 * \warning The predicate refers to `cmp` and must not outlive it.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto cmp = comparing(&string::size);
+	 *   function_ref<ord(const string&,const string&)> ref = cmp;
+	 *
+	 *   sort(v.begin(), v.end(), desc(ref));
+	 * \endcode
+	 *
+	 * \ingroup ord
+	 */
+	template<typename A>
+	_dtl::ordering_is<A,ord::Gt> desc(function_ref<ord(const A&,const A&)> cmp)
+	noexcept {
+		return _dtl::ordering_is<A,ord::Gt>{cmp};
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Keeps the type of a comparator from `comparing`, `getComparator` or
+	 * `operator^`, so that the whole comparison can be inlined.
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename Cmp,
+			typename = Requires<_dtl::is_comparator<plain_type<Cmp>>::value>
+	>
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::ordering_by<plain_type<Cmp>,ord::Gt>
+#else
+	ImplementationDefined
+#endif
+	desc(Cmp&& cmp) {
+		return _dtl::ordering_by<plain_type<Cmp>,ord::Gt>{
+			std::forward<Cmp>(cmp)
+		};
+	}
+
 	/**
 	 * Convenience function to ease integration with stdlib's sort.
 	 *
@@ -332,6 +638,53 @@ namespace ftl {
 			return cmp(a, b) == ord::Eq;
 		};
 	}
+
+	/**
+	 * \overload
+	 *
+	 * Takes `cmp` by `function_ref`, see there for when that pays off.
+	 *
+	 * \warning The predicate refers to `cmp` and must not outlive it.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto cmp = comparing(&string::size);
+	 *   function_ref<ord(const string&,const string&)> ref = cmp;
+	 *
+	 *   auto last = unique(v.begin(), v.end(), equal(ref));
+	 * \endcode
+	 *
+	 * \ingroup ord
+	 */
+	template<typename A>
+	_dtl::ordering_is<A,ord::Eq> equal(function_ref<ord(const A&,const A&)> cmp)
+	noexcept {
+		return _dtl::ordering_is<A,ord::Eq>{cmp};
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Keeps the type of a comparator from `comparing`, `getComparator` or
+	 * `operator^`, so that the whole comparison can be inlined.
+	 *
+	 * \ingroup ord
+	 */
+	template<
+			typename Cmp,
+			typename = Requires<_dtl::is_comparator<plain_type<Cmp>>::value>
+	>
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::ordering_by<plain_type<Cmp>,ord::Eq>
+#else
+	ImplementationDefined
+#endif
+	equal(Cmp&& cmp) {
+		return _dtl::ordering_by<plain_type<Cmp>,ord::Eq>{
+			std::forward<Cmp>(cmp)
+		};
+	}
 }
 
 #endif
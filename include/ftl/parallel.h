@@ -0,0 +1,783 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PARALLEL_H
+#define FTL_PARALLEL_H
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "executor.h"
+#include "instrument.h"
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup parallel Parallel
+	 *
+	 * Execution policies and parallel concept instances.
+	 *
+	 * \code
+	 *   #include <ftl/parallel.h>
+	 * \endcode
+	 *
+	 * Parallel versions of concept operations are selected by passing an
+	 * execution policy as their first argument:
+	 * \code
+	 *   auto r1 = ftl::fmap(ftl::par, f, v);
+	 *
+	 *   // Same as above, but on a particular executor
+	 *   ftl::thread_pool pool;
+	 *   auto r2 = ftl::fmap(ftl::par.on(pool), f, v);
+	 *
+	 *   // Folds rely on the monoid operation being associative
+	 *   auto s = ftl::foldMap(ftl::par, ftl::sum<int>, v);
+	 * \endcode
+	 *
+	 * Folds into monoids that are also commutative (see
+	 * `CommutativeMonoid`) accumulate into one partial result per thread,
+	 * in no particular order, instead of one per chunk combined in order.
+	 *
+	 * The work is split in chunks that are handed to the executor. The calling
+	 * thread also processes chunks, and only ever waits for chunks that
+	 * are actively being processed by other threads. It is therefore safe to
+	 * use the parallel operations from within tasks run by the very executor
+	 * they use.
+	 *
+	 * Exceptions thrown by the mapped functions are propagated to the caller
+	 * once all chunks are done. Should several be thrown, one of them is
+	 * propagated and the rest are discarded.
+	 *
+	 * This module adds \ref parallel_functor instances to:
+	 * - `std::vector`
+	 * - `std::list`
+	 * - `std::map`
+	 * - `std::unordered_map`
+	 *
+	 * And \ref parallel_foldable instances to:
+	 * - `std::vector`
+	 * - `std::list`
+	 * - `std::map`
+	 * - `std::set`
+	 *
+	 * \par Dependencies
+	 * - `<algorithm>`
+	 * - `<list>`
+	 * - `<map>`
+	 * - `<set>`
+	 * - `<unordered_map>`
+	 * - `<vector>`
+	 * - \ref executor
+	 * - \ref functor
+	 * - \ref foldable
+	 */
+
+	/**
+	 * Execution policy running parallel operations on an executor.
+	 *
+	 * \tparam E must satisfy \ref executorpg
+	 *
+	 * \ingroup parallel
+	 */
+	template<typename E>
+	struct parallel_policy {
+		/// Executor chunks are scheduled on.
+		E* executor;
+
+		/**
+		 * The smallest number of elements processed as a single chunk.
+		 *
+		 * Inputs smaller than twice this are processed entirely on the
+		 * calling thread.
+		 */
+		std::size_t grain;
+
+		/// Get a copy of this policy using a different grain size.
+		constexpr parallel_policy with_grain(std::size_t g) const noexcept {
+			return parallel_policy{executor, g};
+		}
+	};
+
+	namespace _dtl {
+		inline work_stealing_pool& default_parallel_pool() {
+			static work_stealing_pool pool;
+			return pool;
+		}
+
+		constexpr std::size_t default_grain = 1024;
+	}
+
+	/**
+	 * The default parallel execution policy.
+	 *
+	 * Runs parallel operations on a process wide \ref work_stealing_pool, with
+	 * one thread per hardware thread. The pool is created the first time it
+	 * is used.
+	 *
+	 * \ingroup parallel
+	 */
+	struct par_t {
+		/// Get a policy running operations on `ex` instead.
+		template<typename E>
+		constexpr parallel_policy<E> on(E& ex) const noexcept {
+			return parallel_policy<E>{&ex, _dtl::default_grain};
+		}
+
+		/// Get a policy using a different grain size.
+		parallel_policy<work_stealing_pool> with_grain(std::size_t g) const {
+			return parallel_policy<work_stealing_pool>{
+				&_dtl::default_parallel_pool(), g
+			};
+		}
+	};
+
+	/**
+	 * Instance of the default execution policy.
+	 *
+	 * \ingroup parallel
+	 */
+	constexpr par_t par{};
+
+	/**
+	 * Predicate to check whether a type is a parallel execution policy.
+	 *
+	 * \ingroup parallel
+	 */
+	template<typename P>
+	struct ParallelPolicy {
+		static constexpr bool value = false;
+
+		constexpr operator bool() const noexcept {
+			return value;
+		}
+	};
+
+	template<>
+	struct ParallelPolicy<par_t> {
+		static constexpr bool value = true;
+
+		constexpr operator bool() const noexcept {
+			return value;
+		}
+	};
+
+	template<typename E>
+	struct ParallelPolicy<parallel_policy<E>> {
+		static constexpr bool value = true;
+
+		constexpr operator bool() const noexcept {
+			return value;
+		}
+	};
+
+	namespace _dtl {
+		inline parallel_policy<work_stealing_pool> to_policy(par_t) {
+			return parallel_policy<work_stealing_pool>{
+				&default_parallel_pool(), default_grain
+			};
+		}
+
+		template<typename E>
+		constexpr parallel_policy<E> to_policy(parallel_policy<E> p) noexcept {
+			return p;
+		}
+
+		/*
+		 * Number of threads an executor runs tasks on: its size(), for
+		 * those that have one, otherwise the number of threads of the
+		 * machine.
+		 */
+		template<typename E>
+		auto executor_size(const E& e, int)
+		-> decltype(static_cast<std::size_t>(e.size())) {
+			return std::max<std::size_t>(e.size(), 1);
+		}
+
+		template<typename E>
+		std::size_t executor_size(const E&, long) {
+			return std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		/*
+		 * Chunks of work shared by the calling thread and the tasks it
+		 * schedules.
+		 *
+		 * Chunks are claimed from an atomic counter, so a task that starts
+		 * after all chunks have been claimed simply returns. This is also
+		 * why the job is reference counted: such a task may run long after
+		 * the caller is done with it.
+		 */
+		class parallel_job {
+		public:
+			parallel_job(std::size_t chunks, function<void(std::size_t)> body)
+			: chunks(chunks), body(std::move(body)) {}
+
+			void run() {
+				while(run_one()) {}
+			}
+
+			void wait() {
+				std::unique_lock<std::mutex> lock(m);
+				cv.wait(lock, [this](){ return done == chunks; });
+
+				if(error)
+					std::rethrow_exception(error);
+			}
+
+		private:
+			bool run_one() {
+				auto c = next.fetch_add(1, std::memory_order_relaxed);
+				if(c >= chunks)
+					return false;
+
+				std::exception_ptr e;
+				try {
+					body(c);
+				}
+				catch(...) {
+					e = std::current_exception();
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(m);
+					if(e && !error)
+						error = e;
+
+					if(++done < chunks)
+						return true;
+				}
+
+				cv.notify_all();
+				return true;
+			}
+
+			std::atomic<std::size_t> next{0};
+			const std::size_t chunks;
+			function<void(std::size_t)> body;
+
+			std::mutex m;
+			std::condition_variable cv;
+			std::size_t done = 0;
+			std::exception_ptr error;
+		};
+
+		/*
+		 * Partitioning of [0,n) into consecutive chunks.
+		 *
+		 * Chunk boundaries are always multiples of 64, so that neighbouring
+		 * chunks never write to the same word of a packed container such as
+		 * std::vector<bool>.
+		 */
+		struct chunk_plan {
+			chunk_plan(std::size_t n, std::size_t grain) : n(n) {
+				grain = (std::max<std::size_t>(grain, 1) + 63) / 64 * 64;
+
+				count = n / grain;
+				if(count < 2) {
+					count = 1;
+					size = n;
+					return;
+				}
+
+				size = ((n + count - 1) / count + 63) / 64 * 64;
+				count = (n + size - 1) / size;
+			}
+
+			std::size_t first(std::size_t c) const noexcept {
+				return c * size;
+			}
+
+			std::size_t last(std::size_t c) const noexcept {
+				return std::min(n, (c + 1) * size);
+			}
+
+			std::size_t n;
+			std::size_t count;
+			std::size_t size;
+		};
+
+		// Invokes body(t) for every t in [0,count), in parallel
+		template<typename P, typename Body>
+		void run_tasks(const P& policy, std::size_t count, Body& body) {
+			if(count < 2) {
+				body(std::size_t(0));
+				return;
+			}
+
+			auto p = to_policy(policy);
+			auto job = std::make_shared<parallel_job>(
+				count,
+				[&body](std::size_t t) { body(t); }
+			);
+			FTL_COUNT_ALLOCATION(parallel, sizeof(parallel_job));
+
+			for(std::size_t i = 1; i < count; ++i) {
+				p.executor->execute([job](){ job->run(); });
+			}
+
+			job->run();
+			job->wait();
+		}
+
+		// Invokes body(c) for every chunk c in plan, in parallel
+		template<typename P, typename Body>
+		void run_chunks(const P& policy, const chunk_plan& plan, Body body) {
+			run_tasks(policy, plan.count, body);
+		}
+
+		// Invokes body(first, last) for consecutive ranges covering [0,n).
+		template<typename P, typename Body>
+		void parallel_for(const P& policy, std::size_t n, Body body) {
+			chunk_plan plan(n, to_policy(policy).grain);
+
+			run_chunks(policy, plan, [&body,&plan](std::size_t c) {
+				body(plan.first(c), plan.last(c));
+			});
+		}
+
+		/*
+		 * Folds fn(x) for every x in [first, first+n) with M's monoid
+		 * operation.
+		 *
+		 * Every chunk is folded into a partial result of its own, after
+		 * which the partial results are combined pairwise, level by level,
+		 * without ever changing their relative order. Once some chunk has
+		 * reached an absorbing element of M, chunks not yet started are
+		 * skipped.
+		 */
+		template<typename M, typename P, typename F, typename It>
+		M parallel_fold(
+				const P& p, F& fn, It first, std::size_t n, std::false_type) {
+			chunk_plan plan(n, to_policy(p).grain);
+
+			std::vector<M> parts(plan.count, monoid<M>::id());
+			std::atomic<bool> absorbed{false};
+			run_chunks(p, plan, [&](std::size_t c) {
+				// Any chunk left as id does not change an absorbed result
+				if(absorbed.load(std::memory_order_relaxed))
+					return;
+
+				auto acc = monoid<M>::id();
+				for(auto i = plan.first(c); i < plan.last(c); ++i) {
+					acc = monoid<M>::append(std::move(acc), fn(first[i]));
+					if(_dtl::absorbed(acc)) {
+						absorbed.store(true, std::memory_order_relaxed);
+						break;
+					}
+				}
+
+				parts[c] = std::move(acc);
+			});
+
+			for(std::size_t step = 1; step < parts.size(); step *= 2) {
+				for(std::size_t i = 0; i + step < parts.size(); i += 2*step) {
+					parts[i] = monoid<M>::append(
+						std::move(parts[i]), std::move(parts[i+step])
+					);
+				}
+			}
+
+			return std::move(parts[0]);
+		}
+
+		/*
+		 * As above, but for commutative M, whose partial results may be
+		 * combined in any order.
+		 *
+		 * There is one task per thread of the executor rather than per
+		 * chunk, each of which keeps claiming chunks for as long as there
+		 * are any left and folds all of them into an accumulator of its
+		 * own. The few accumulators are then appended one after another.
+		 */
+		template<typename M, typename P, typename F, typename It>
+		M parallel_fold(
+				const P& p, F& fn, It first, std::size_t n, std::true_type) {
+			auto policy = to_policy(p);
+			chunk_plan plan(n, policy.grain);
+
+			auto tasks = std::min<std::size_t>(
+				plan.count, executor_size(*policy.executor, 0)
+			);
+
+			std::vector<M> parts(tasks, monoid<M>::id());
+			std::atomic<std::size_t> next{0};
+			std::atomic<bool> absorbed{false};
+			auto body = [&](std::size_t t) {
+				auto acc = monoid<M>::id();
+				while(!absorbed.load(std::memory_order_relaxed)) {
+					auto c = next.fetch_add(1, std::memory_order_relaxed);
+					if(c >= plan.count)
+						break;
+
+					for(auto i = plan.first(c); i < plan.last(c); ++i) {
+						acc = monoid<M>::append(std::move(acc), fn(first[i]));
+						if(_dtl::absorbed(acc)) {
+							absorbed.store(true, std::memory_order_relaxed);
+							break;
+						}
+					}
+				}
+
+				parts[t] = std::move(acc);
+			};
+			run_tasks(p, tasks, body);
+
+			for(std::size_t i = 1; i < parts.size(); ++i) {
+				parts[0] = monoid<M>::append(
+					std::move(parts[0]), std::move(parts[i])
+				);
+			}
+
+			return std::move(parts[0]);
+		}
+
+		// Folds in order, unless M is commutative
+		template<typename M, typename P, typename F, typename It>
+		M parallel_fold(const P& p, F& fn, It first, std::size_t n) {
+			return parallel_fold<M>(
+				p, fn, first, n,
+				std::integral_constant<bool, CommutativeMonoid<M>::value>{}
+			);
+		}
+
+		// Iterator over a sequence of iterators, dereferencing twice
+		template<typename It>
+		struct indirect_iterator {
+			auto operator[] (std::size_t i) const -> decltype(**std::declval<It>()) {
+				return *it[i];
+			}
+
+			It it;
+		};
+
+		template<typename It>
+		std::vector<It> collect_iterators(It first, It last) {
+			std::vector<It> its;
+			its.reserve(std::distance(first, last));
+			for(; first != last; ++first)
+				its.push_back(first);
+
+			return its;
+		}
+
+		/*
+		 * Computes f applied to every element in [first,last) in parallel,
+		 * collecting the results in a vector.
+		 */
+		template<
+				typename P,
+				typename F,
+				typename It,
+				typename U = plain_type<decltype(std::declval<F&>()(*std::declval<It>()))>
+		>
+		std::vector<U> parallel_collect(const P& p, F& f, It first, It last) {
+			auto its = collect_iterators(first, last);
+
+			std::vector<U> rs(its.size());
+			parallel_for(p, its.size(), [&](std::size_t b, std::size_t e) {
+				for(auto i = b; i < e; ++i) {
+					rs[i] = f(*its[i]);
+				}
+			});
+
+			return rs;
+		}
+	}
+
+	/**
+	 * Parallel functor instance for `std::vector`.
+	 *
+	 * The result is allocated up front, and each element is assigned exactly
+	 * once, in place.
+	 *
+	 * \note The result type of the mapped function must be
+	 *       \ref defcons and \ref moveassignable.
+	 *
+	 * \ingroup parallel
+	 */
+	template<typename T, typename A>
+	struct parallel_functor<std::vector<T,A>> {
+		template<typename U>
+		using vector = std::vector<
+			U, typename std::allocator_traits<A>::template rebind_alloc<U>
+		>;
+
+		template<
+				typename P,
+				typename F,
+				typename U = result_of<F(T)>,
+				typename = Requires<ParallelPolicy<P>::value>
+		>
+		static vector<U> map(const P& p, F&& f, const std::vector<T,A>& v) {
+			vector<U> rs(v.size());
+			_dtl::parallel_for(p, v.size(), [&](std::size_t b, std::size_t e) {
+				for(auto i = b; i < e; ++i) {
+					rs[i] = f(v[i]);
+				}
+			});
+
+			return rs;
+		}
+
+		/// \overload
+		template<
+				typename P,
+				typename F,
+				typename U = result_of<F(T)>,
+				typename = Requires<ParallelPolicy<P>::value>
+		>
+		static vector<U> map(const P& p, F&& f, std::vector<T,A>&& v) {
+			vector<U> rs(v.size());
+			_dtl::parallel_for(p, v.size(), [&](std::size_t b, std::size_t e) {
+				for(auto i = b; i < e; ++i) {
+					rs[i] = f(std::move(v[i]));
+				}
+			});
+
+			return rs;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Parallel functor instance for `std::list`.
+	 *
+	 * Results are computed in parallel, and then moved into the resulting
+	 * list.
+	 *
+	 * \note The result type of the mapped function must be
+	 *       \ref defcons and \ref moveassignable.
+	 *
+	 * \ingroup parallel
+	 */
+	template<typename T, typename A>
+	struct parallel_functor<std::list<T,A>> {
+		template<typename U>
+		using list = std::list<
+			U, typename std::allocator_traits<A>::template rebind_alloc<U>
+		>;
+
+		template<
+				typename P,
+				typename F,
+				typename U = result_of<F(T)>,
+				typename = Requires<ParallelPolicy<P>::value>
+		>
+		static list<U> map(const P& p, F&& f, const std::list<T,A>& l) {
+			auto rs = _dtl::parallel_collect(p, f, l.begin(), l.end());
+
+			return list<U>(
+				std::make_move_iterator(rs.begin()),
+				std::make_move_iterator(rs.end())
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Parallel functor instance for `std::map`.
+	 *
+	 * Values are computed in parallel. As keys are left untouched, the
+	 * resulting map is then built in linear time.
+	 *
+	 * \note The result type of the mapped function must be
+	 *       \ref defcons and \ref moveassignable.
+	 *
+	 * \ingroup parallel
+	 */
+	template<typename K, typename T, typename C, typename A>
+	struct parallel_functor<std::map<K,T,C,A>> {
+		template<typename U>
+		using map_ = std::map<
+			K, U, C,
+			typename std::allocator_traits<A>
+				::template rebind_alloc<std::pair<const K,U>>
+		>;
+
+		template<
+				typename P,
+				typename F,
+				typename U = result_of<F(T)>,
+				typename = Requires<ParallelPolicy<P>::value>
+		>
+		static map_<U> map(const P& p, F&& f, const std::map<K,T,C,A>& m) {
+			auto g = [&f](const std::pair<const K,T>& kv) { return f(kv.second); };
+			auto rs = _dtl::parallel_collect(p, g, m.begin(), m.end());
+
+			map_<U> rm(m.key_comp());
+			auto it = rs.begin();
+			for(const auto& kv : m) {
+				rm.emplace_hint(rm.end(), kv.first, std::move(*it++));
+			}
+
+			return rm;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Parallel functor instance for `std::unordered_map`.
+	 *
+	 * \note The result type of the mapped function must be
+	 *       \ref defcons and \ref moveassignable.
+	 *
+	 * \ingroup parallel
+	 */
+	template<typename K, typename T, typename H, typename C, typename A>
+	struct parallel_functor<std::unordered_map<K,T,H,C,A>> {
+		template<typename U>
+		using unordered_map = std::unordered_map<
+			K, U, H, C,
+			typename std::allocator_traits<A>
+				::template rebind_alloc<std::pair<const K,U>>
+		>;
+
+		template<
+				typename P,
+				typename F,
+				typename U = result_of<F(T)>,
+				typename = Requires<ParallelPolicy<P>::value>
+		>
+		static unordered_map<U> map(
+				const P& p, F&& f, const std::unordered_map<K,T,H,C,A>& m) {
+
+			auto g = [&f](const std::pair<const K,T>& kv) { return f(kv.second); };
+			auto rs = _dtl::parallel_collect(p, g, m.begin(), m.end());
+
+			unordered_map<U> rm(m.bucket_count(), m.hash_function(), m.key_eq());
+			auto it = rs.begin();
+			for(const auto& kv : m) {
+				rm.emplace(kv.first, std::move(*it++));
+			}
+
+			return rm;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Parallel foldable instance for `std::vector`.
+	 *
+	 * \ingroup parallel
+	 */
+	template<typename T, typename A>
+	struct parallel_foldable<std::vector<T,A>> {
+		template<
+				typename P,
+				typename F,
+				typename M = result_of<F(T)>,
+				typename = Requires<ParallelPolicy<P>::value && Monoid<M>{}>
+		>
+		static M foldMap(const P& p, F&& f, const std::vector<T,A>& v) {
+			return _dtl::parallel_fold<M>(p, f, v.begin(), v.size());
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Parallel foldable instance for `std::list`.
+	 *
+	 * \ingroup parallel
+	 */
+	template<typename T, typename A>
+	struct parallel_foldable<std::list<T,A>> {
+		template<
+				typename P,
+				typename F,
+				typename M = result_of<F(T)>,
+				typename = Requires<ParallelPolicy<P>::value && Monoid<M>{}>
+		>
+		static M foldMap(const P& p, F&& f, const std::list<T,A>& l) {
+			auto its = _dtl::collect_iterators(l.begin(), l.end());
+			return _dtl::parallel_fold<M>(
+				p, f, _dtl::indirect_iterator<decltype(its.begin())>{its.begin()},
+				its.size()
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Parallel foldable instance for `std::map`.
+	 *
+	 * Folds the values of the map, in key order.
+	 *
+	 * \ingroup parallel
+	 */
+	template<typename K, typename T, typename C, typename A>
+	struct parallel_foldable<std::map<K,T,C,A>> {
+		template<
+				typename P,
+				typename F,
+				typename M = result_of<F(T)>,
+				typename = Requires<ParallelPolicy<P>::value && Monoid<M>{}>
+		>
+		static M foldMap(const P& p, F&& f, const std::map<K,T,C,A>& m) {
+			auto g = [&f](const std::pair<const K,T>& kv) { return f(kv.second); };
+			auto its = _dtl::collect_iterators(m.begin(), m.end());
+			return _dtl::parallel_fold<M>(
+				p, g, _dtl::indirect_iterator<decltype(its.begin())>{its.begin()},
+				its.size()
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Parallel foldable instance for `std::set`.
+	 *
+	 * \ingroup parallel
+	 */
+	template<typename T, typename C, typename A>
+	struct parallel_foldable<std::set<T,C,A>> {
+		template<
+				typename P,
+				typename F,
+				typename M = result_of<F(T)>,
+				typename = Requires<ParallelPolicy<P>::value && Monoid<M>{}>
+		>
+		static M foldMap(const P& p, F&& f, const std::set<T,C,A>& s) {
+			auto its = _dtl::collect_iterators(s.begin(), s.end());
+			return _dtl::parallel_fold<M>(
+				p, f, _dtl::indirect_iterator<decltype(its.begin())>{its.begin()},
+				its.size()
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
+
@@ -0,0 +1,435 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PERSISTENT_HASH_MAP_H
+#define FTL_PERSISTENT_HASH_MAP_H
+
+#include <utility>
+#include <stdexcept>
+#include <functional>
+#include <initializer_list>
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+#include "implementation/hamt.h"
+#include "maybe.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup persistent_hash_map Persistent Hash Map
+	 *
+	 * An immutable hash map with structural sharing, and its concept
+	 * instances.
+	 *
+	 * Adds the \ref functorpg, \ref foldablepg and \ref monoidpg concept
+	 * instances, all of which work on the values of the map.
+	 *
+	 * \code
+	 *   #include <ftl/persistent_hash_map.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - <utility>
+	 * - <stdexcept>
+	 * - <functional>
+	 * - <initializer_list>
+	 * - \ref functor
+	 * - \ref foldable
+	 * - \ref maybe
+	 */
+
+	namespace _dtl {
+		struct persistent_hash_map_access;
+	}
+
+	/**
+	 * Immutable, persistent unordered associative container.
+	 *
+	 * Implemented as a hash array mapped trie with 32-way nodes. None of the
+	 * operations modify a map; `set`, `insert` and `erase` instead return a
+	 * new map, which shares all nodes but the `O(log32 n)` ones on the path
+	 * to the key with the original. Copies are constant time, which makes
+	 * persistent maps well suited for snapshots of state that is updated a
+	 * little at a time.
+	 *
+	 * Elements are `std::pair<K,V>`, and are visited in an order that
+	 * depends on the hashes of the keys.
+	 *
+	 * \par Concepts
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 * - \ref monoidpg, given a monoid `V`
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::persistent_hash_map<std::string,int> m1{{"a", 1}};
+	 *   auto m2 = m1.set("b", 2).erase("a");
+	 *
+	 *   // m1 == {{"a", 1}}, m2 == {{"b", 2}}
+	 * \endcode
+	 *
+	 * \ingroup persistent_hash_map
+	 */
+	template<
+			typename K,
+			typename V,
+			typename H = std::hash<K>,
+			typename Eq = std::equal_to<K>
+	>
+	class persistent_hash_map {
+		using trie = _dtl::hamt<std::pair<K,V>,K,_dtl::hamt_first,H,Eq>;
+
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<K,V>;
+		using size_type = std::size_t;
+		using hasher = H;
+		using key_equal = Eq;
+		using reference = const value_type&;
+		using const_reference = const value_type&;
+		using iterator = typename trie::iterator;
+		using const_iterator = iterator;
+
+		persistent_hash_map() = default;
+
+		explicit persistent_hash_map(const H& hash, const Eq& eq = Eq())
+		: t(hash, eq) {}
+
+		persistent_hash_map(
+				std::initializer_list<value_type> l,
+				const H& hash = H(), const Eq& eq = Eq())
+		: persistent_hash_map(l.begin(), l.end(), hash, eq) {}
+
+		/// Where a key occurs more than once, the first one is kept
+		template<
+				typename It,
+				typename = Requires<!std::is_integral<It>::value>
+		>
+		persistent_hash_map(
+				It first, It last,
+				const H& hash = H(), const Eq& eq = Eq())
+		: t(hash, eq) {
+			for(; first != last; ++first) {
+				t = t.insert(*first, false);
+			}
+		}
+
+		size_type size() const noexcept {
+			return t.size();
+		}
+
+		bool empty() const noexcept {
+			return t.size() == 0;
+		}
+
+		iterator begin() const {
+			return t.begin();
+		}
+
+		iterator end() const {
+			return t.end();
+		}
+
+		iterator cbegin() const {
+			return begin();
+		}
+
+		iterator cend() const {
+			return end();
+		}
+
+		iterator find(const K& k) const {
+			return t.find(k);
+		}
+
+		size_type count(const K& k) const {
+			return find(k) == end() ? 0 : 1;
+		}
+
+		const V& at(const K& k) const {
+			auto it = find(k);
+			if(it == end())
+				throw std::out_of_range("ftl::persistent_hash_map::at");
+
+			return it->second;
+		}
+
+		/// A map where `k` is associated with `v`, whether it was before or not
+		persistent_hash_map set(K k, V v) const {
+			return persistent_hash_map(
+				t.insert(value_type(std::move(k), std::move(v)), true)
+			);
+		}
+
+		/// A map with `kv` added, unless its key was already in the map
+		persistent_hash_map insert(value_type kv) const {
+			return persistent_hash_map(t.insert(std::move(kv), false));
+		}
+
+		/// A map without the key `k`
+		persistent_hash_map erase(const K& k) const {
+			return persistent_hash_map(t.erase(k));
+		}
+
+		hasher hash_function() const {
+			return t.hash_function();
+		}
+
+		key_equal key_eq() const {
+			return t.key_eq();
+		}
+
+		friend bool operator== (
+				const persistent_hash_map& m1, const persistent_hash_map& m2) {
+			if(m1.size() != m2.size())
+				return false;
+
+			if(m1.t.same_root(m2.t))
+				return true;
+
+			for(auto& kv : m1) {
+				auto it = m2.find(kv.first);
+				if(it == m2.end() || !(it->second == kv.second))
+					return false;
+			}
+
+			return true;
+		}
+
+		friend bool operator!= (
+				const persistent_hash_map& m1, const persistent_hash_map& m2) {
+			return !(m1 == m2);
+		}
+
+	private:
+		friend struct _dtl::persistent_hash_map_access;
+
+		explicit persistent_hash_map(trie t) : t(std::move(t)) {}
+
+		trie t;
+	};
+
+	namespace _dtl {
+		struct persistent_hash_map_access {
+			template<typename M>
+			static const typename M::trie& trie(const M& m) noexcept {
+				return m.t;
+			}
+
+			template<typename M, typename T>
+			static M make(T&& t) {
+				return M(std::forward<T>(t));
+			}
+		};
+	}
+
+	/**
+	 * Find the value associated with `k` in `m`, without copying it.
+	 *
+	 * \see lookup(const K&, std::map<K,T,C,A>&)
+	 *
+	 * \ingroup persistent_hash_map
+	 */
+	template<typename K, typename V, typename H, typename Eq>
+	maybe<const V&> lookup(
+			const K& k, const persistent_hash_map<K,V,H,Eq>& m) {
+		auto it = m.find(k);
+		if(it == m.end())
+			return nothing<const V&>();
+
+		return maybe<const V&>{constructor<const V&>(), it->second};
+	}
+
+	template<typename K, typename V, typename H, typename Eq>
+	struct parametric_type_traits<persistent_hash_map<K,V,H,Eq>> {
+		using value_type = V;
+
+		template<typename W>
+		using rebind = persistent_hash_map<K,W,H,Eq>;
+	};
+
+	/**
+	 * Functor instance for `ftl::persistent_hash_map`.
+	 *
+	 * The keys do not change, so the result has exactly the layout of the
+	 * original and nothing is rehashed. Mapping an endofunction over values
+	 * that are \ref eq, nodes where no value changed are shared with the
+	 * original, so that e.g. a function that only touches a few values only
+	 * allocates the paths to them.
+	 *
+	 * \ingroup persistent_hash_map
+	 */
+	template<typename K, typename T, typename H, typename Eq>
+	struct functor<persistent_hash_map<K,T,H,Eq>> {
+
+		/// Type alias for more easily read type signatures.
+		template<typename U>
+		using Map = persistent_hash_map<K,U,H,Eq>;
+
+		/// Maps the function `f` over all values in `m`.
+		template<typename F, typename U = result_of<F(T)>>
+		static Map<U> map(F&& f, const Map<T>& m) {
+			return map_<U>(
+				f, m,
+				std::integral_constant<
+					bool,
+					std::is_same<T,U>::value && has_eq<T>::value
+				>{}
+			);
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		template<typename U, typename F>
+		static Map<U> map_(F& f, const Map<T>& m, std::false_type) {
+			using access = _dtl::persistent_hash_map_access;
+
+			return access::make<Map<U>>(
+				access::trie(m).template remap<std::pair<K,U>>(
+					[&f](const std::pair<K,T>& kv) {
+						return std::pair<K,U>(kv.first, f(kv.second));
+					}
+				)
+			);
+		}
+
+		template<typename U, typename F>
+		static Map<T> map_(F& f, const Map<T>& m, std::true_type) {
+			using access = _dtl::persistent_hash_map_access;
+
+			return access::make<Map<T>>(access::trie(m).update(
+				[&f](const std::pair<K,T>& kv) {
+					return std::pair<K,T>(kv.first, f(kv.second));
+				}
+			));
+		}
+	};
+
+	/**
+	 * Foldable instance for `ftl::persistent_hash_map`.
+	 *
+	 * As with `ftl::hash_map`, the order in which values are visited is
+	 * unspecified, so folds are only well defined for functions and monoids
+	 * that do not depend on the order of the elements.
+	 *
+	 * \ingroup persistent_hash_map
+	 */
+	template<typename K, typename T, typename H, typename Eq>
+	struct foldable<persistent_hash_map<K,T,H,Eq>>
+	: deriving_fold<persistent_hash_map<K,T,H,Eq>>
+	, deriving_foldMap<persistent_hash_map<K,T,H,Eq>> {
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(U,T)>>::value
+				>
+		>
+		static U foldl(F&& f, U z, const persistent_hash_map<K,T,H,Eq>& m) {
+			for(auto& kv : m) {
+				z = f(std::move(z), kv.second);
+			}
+
+			return z;
+		}
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(T,U)>>::value
+				>
+		>
+		static U foldr(F&& f, U z, const persistent_hash_map<K,T,H,Eq>& m) {
+			for(auto& kv : m) {
+				z = f(kv.second, std::move(z));
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid instance for `ftl::persistent_hash_map`, given a monoid of values.
+	 *
+	 * Behaviour:
+	 * \code
+	 *   id()         <=> persistent_hash_map{}
+	 *   append(a, b) <=> the union of a and b
+	 * \endcode
+	 *
+	 * Where a key is in both maps, its values are combined with the monoid
+	 * operation of `V`, `a`'s value on the left. The entries of the smaller
+	 * map are added to the larger one, so the result shares most of its
+	 * nodes with the larger argument.
+	 *
+	 * \ingroup persistent_hash_map
+	 */
+	template<typename K, typename V, typename H, typename Eq>
+	struct monoid<persistent_hash_map<K,V,H,Eq>> {
+	private:
+		using map = persistent_hash_map<K,V,H,Eq>;
+
+		// Adds from to into, from being the right-hand side if Right
+		template<bool Right>
+		static map merge(map into, const map& from) {
+			for(auto& kv : from) {
+				auto it = into.find(kv.first);
+				if(it == into.end())
+					into = into.insert(kv);
+				else if(Right)
+					into = into.set(
+						kv.first, monoid<V>::append(it->second, kv.second)
+					);
+				else
+					into = into.set(
+						kv.first, monoid<V>::append(kv.second, it->second)
+					);
+			}
+
+			return into;
+		}
+
+	public:
+		static map id() {
+			return map{};
+		}
+
+		static map append(const map& m1, const map& m2) {
+			if(m1.size() < m2.size())
+				return merge<false>(m2, m1);
+
+			return merge<true>(m1, m2);
+		}
+
+		static constexpr bool instance = Monoid<V>();
+	};
+
+}
+
+#endif
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PERSISTENT_HASH_SET_H
+#define FTL_PERSISTENT_HASH_SET_H
+
+#include <functional>
+#include <initializer_list>
+#include "concepts/foldable.h"
+#include "concepts/monoid.h"
+#include "implementation/hamt.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup persistent_hash_set Persistent Hash Set
+	 *
+	 * An immutable hash set with structural sharing, and its concept
+	 * instances.
+	 *
+	 * \code
+	 *   #include <ftl/persistent_hash_set.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - <functional>
+	 * - <initializer_list>
+	 * - \ref foldable
+	 * - \ref monoid
+	 */
+
+	/**
+	 * Immutable, persistent unordered set.
+	 *
+	 * The set counterpart of `ftl::persistent_hash_map`, with which it shares
+	 * its implementation. `insert` and `erase` return a new set, sharing all
+	 * but `O(log32 n)` nodes with the original.
+	 *
+	 * \par Concepts
+	 * - \ref foldablepg
+	 * - \ref monoidpg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::persistent_hash_set<int> s1{1,2,3};
+	 *   auto s2 = s1.insert(4).erase(1);
+	 *
+	 *   // s1 == {1,2,3}, s2 == {2,3,4}
+	 * \endcode
+	 *
+	 * \ingroup persistent_hash_set
+	 */
+	template<
+			typename T,
+			typename H = std::hash<T>,
+			typename Eq = std::equal_to<T>
+	>
+	class persistent_hash_set {
+		using trie = _dtl::hamt<T,T,_dtl::hamt_identity,H,Eq>;
+
+	public:
+		using key_type = T;
+		using value_type = T;
+		using size_type = std::size_t;
+		using hasher = H;
+		using key_equal = Eq;
+		using reference = const T&;
+		using const_reference = const T&;
+		using iterator = typename trie::iterator;
+		using const_iterator = iterator;
+
+		persistent_hash_set() = default;
+
+		explicit persistent_hash_set(const H& hash, const Eq& eq = Eq())
+		: t(hash, eq) {}
+
+		persistent_hash_set(
+				std::initializer_list<T> l,
+				const H& hash = H(), const Eq& eq = Eq())
+		: persistent_hash_set(l.begin(), l.end(), hash, eq) {}
+
+		template<
+				typename It,
+				typename = Requires<!std::is_integral<It>::value>
+		>
+		persistent_hash_set(
+				It first, It last,
+				const H& hash = H(), const Eq& eq = Eq())
+		: t(hash, eq) {
+			for(; first != last; ++first) {
+				t = t.insert(*first, false);
+			}
+		}
+
+		size_type size() const noexcept {
+			return t.size();
+		}
+
+		bool empty() const noexcept {
+			return t.size() == 0;
+		}
+
+		iterator begin() const {
+			return t.begin();
+		}
+
+		iterator end() const {
+			return t.end();
+		}
+
+		iterator cbegin() const {
+			return begin();
+		}
+
+		iterator cend() const {
+			return end();
+		}
+
+		iterator find(const T& k) const {
+			return t.find(k);
+		}
+
+		size_type count(const T& k) const {
+			return find(k) == end() ? 0 : 1;
+		}
+
+		/// A set with `k` added
+		persistent_hash_set insert(T k) const {
+			return persistent_hash_set(t.insert(std::move(k), false));
+		}
+
+		/// A set without `k`
+		persistent_hash_set erase(const T& k) const {
+			return persistent_hash_set(t.erase(k));
+		}
+
+		hasher hash_function() const {
+			return t.hash_function();
+		}
+
+		key_equal key_eq() const {
+			return t.key_eq();
+		}
+
+		friend bool operator== (
+				const persistent_hash_set& s1, const persistent_hash_set& s2) {
+			if(s1.size() != s2.size())
+				return false;
+
+			if(s1.t.same_root(s2.t))
+				return true;
+
+			for(auto& k : s1) {
+				if(!s2.count(k))
+					return false;
+			}
+
+			return true;
+		}
+
+		friend bool operator!= (
+				const persistent_hash_set& s1, const persistent_hash_set& s2) {
+			return !(s1 == s2);
+		}
+
+	private:
+		explicit persistent_hash_set(trie t) : t(std::move(t)) {}
+
+		trie t;
+	};
+
+	template<typename T, typename H, typename Eq>
+	struct parametric_type_traits<persistent_hash_set<T,H,Eq>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = persistent_hash_set<U>;
+	};
+
+	/**
+	 * Foldable instance for `ftl::persistent_hash_set`.
+	 *
+	 * Elements are visited in an unspecified order, so folds are only well
+	 * defined for functions and monoids that do not depend on it.
+	 *
+	 * \ingroup persistent_hash_set
+	 */
+	template<typename T, typename H, typename Eq>
+	struct foldable<persistent_hash_set<T,H,Eq>>
+	: deriving_foldl<persistent_hash_set<T,H,Eq>>
+	, deriving_fold<persistent_hash_set<T,H,Eq>>
+	, deriving_foldMap<persistent_hash_set<T,H,Eq>> {
+
+		template<
+				typename F,
+				typename U,
+				typename = Requires<
+					std::is_same<U, result_of<F(T,U)>>::value
+				>
+		>
+		static U foldr(F&& f, U z, const persistent_hash_set<T,H,Eq>& s) {
+			for(auto& e : s) {
+				z = f(e, std::move(z));
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monoid instance for `ftl::persistent_hash_set`.
+	 *
+	 * `append` is set union. The elements of the smaller set are added to
+	 * the larger one, so the result shares most of its nodes with the
+	 * larger argument.
+	 *
+	 * \ingroup persistent_hash_set
+	 */
+	template<typename T, typename H, typename Eq>
+	struct monoid<persistent_hash_set<T,H,Eq>> {
+		static persistent_hash_set<T,H,Eq> id() {
+			return persistent_hash_set<T,H,Eq>();
+		}
+
+		static persistent_hash_set<T,H,Eq> append(
+				const persistent_hash_set<T,H,Eq>& s1,
+				const persistent_hash_set<T,H,Eq>& s2) {
+			auto& small = s1.size() < s2.size() ? s1 : s2;
+			auto r = s1.size() < s2.size() ? s2 : s1;
+			for(auto& e : small) {
+				r = r.insert(e);
+			}
+
+			return r;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+}
+
+#endif
@@ -0,0 +1,825 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_PERSISTENT_VECTOR_H
+#define FTL_PERSISTENT_VECTOR_H
+
+#include <memory>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <initializer_list>
+#include "concepts/monad.h"
+#include "concepts/foldable.h"
+#include "concepts/zippable.h"
+#include "instrument.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup persistent_vector Persistent Vector
+	 *
+	 * An immutable vector with structural sharing, and its concept instances.
+	 *
+	 * \code
+	 *   #include <ftl/persistent_vector.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to
+	 * `ftl::persistent_vector`:
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref zippablepg
+	 *
+	 * \par Dependencies
+	 * - <memory>
+	 * - <vector>
+	 * - <iterator>
+	 * - <algorithm>
+	 * - <stdexcept>
+	 * - <initializer_list>
+	 * - \ref monad
+	 * - \ref foldable
+	 * - \ref zippable
+	 */
+
+	template<typename T>
+	class persistent_vector;
+
+	namespace _dtl {
+		constexpr std::size_t pv_bits = 5;
+		constexpr std::size_t pv_width = std::size_t(1) << pv_bits;
+
+		/*
+		 * Nodes of a relaxed radix balanced (RRB) tree. Leaves hold up to
+		 * pv_width elements, inner nodes up to pv_width children, along with
+		 * the cumulative sizes of the children. Nodes are never modified once
+		 * shared; updates copy the path from the root instead.
+		 */
+		template<typename T>
+		struct pv_node {
+			using ptr = std::shared_ptr<const pv_node>;
+
+			std::vector<T> elems;
+			std::vector<ptr> kids;
+			std::vector<std::size_t> sizes;
+		};
+
+		struct pv_access;
+	}
+
+	/**
+	 * Immutable, persistent random access sequence.
+	 *
+	 * Implemented as a relaxed radix balanced tree with a branching factor of
+	 * 32. None of the operations modify a vector; "updates" instead return a
+	 * new vector that shares all but `O(log n)` nodes with the original. This
+	 * makes copies constant time, and lets functional updates of large
+	 * collections avoid copying them.
+	 *
+	 * Complexities:
+	 * - Indexing, `set` and `push_back`: `O(log32 n)`
+	 * - Concatenation, through the monoid instance: `O(log n)`
+	 * - Construction from a range, `fmap`: `O(n)`, without rebalancing
+	 *
+	 * Nodes are reference counted with `std::shared_ptr`, so vectors may be
+	 * shared freely between threads.
+	 *
+	 * \par Concepts
+	 * - \ref monoidpg
+	 * - \ref foldablepg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref zippablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::persistent_vector<int> v1{1,2,3};
+	 *   auto v2 = v1.set(0, 10).push_back(4);
+	 *
+	 *   // v1 == {1,2,3}, v2 == {10,2,3,4}
+	 * \endcode
+	 *
+	 * \ingroup persistent_vector
+	 */
+	template<typename T>
+	class persistent_vector {
+		using node = _dtl::pv_node<T>;
+		using ptr = typename node::ptr;
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = const T&;
+		using const_reference = const T&;
+
+		/// Bidirectional iterator, visiting one leaf at a time
+		class iterator {
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const T*;
+			using reference = const T&;
+
+			iterator() = default;
+
+			reference operator* () const {
+				return leaf[i - first];
+			}
+
+			pointer operator-> () const {
+				return leaf + (i - first);
+			}
+
+			iterator& operator++ () {
+				if(++i == last && i < v->len)
+					load();
+
+				return *this;
+			}
+
+			iterator operator++ (int) {
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			iterator& operator-- () {
+				if(i-- == first || !leaf)
+					load();
+
+				return *this;
+			}
+
+			iterator operator-- (int) {
+				auto tmp = *this;
+				--*this;
+				return tmp;
+			}
+
+			bool operator== (const iterator& it) const {
+				return i == it.i;
+			}
+
+			bool operator!= (const iterator& it) const {
+				return i != it.i;
+			}
+
+		private:
+			friend class persistent_vector;
+
+			iterator(const persistent_vector* v, size_type i) : v(v), i(i) {
+				if(i < v->len)
+					load();
+			}
+
+			void load() {
+				auto n = v->leaf_at(i, first);
+				leaf = n->elems.data();
+				last = first + n->elems.size();
+			}
+
+			const persistent_vector* v = nullptr;
+			size_type i = 0;
+			const T* leaf = nullptr;
+			size_type first = 0;
+			size_type last = 0;
+		};
+
+		using const_iterator = iterator;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = reverse_iterator;
+
+		persistent_vector() = default;
+
+		persistent_vector(std::initializer_list<T> l)
+		: persistent_vector(l.begin(), l.end()) {}
+
+		/// Builds a perfectly balanced tree of the elements of `[first, last)`
+		template<
+				typename It,
+				typename = Requires<!std::is_integral<It>::value>
+		>
+		persistent_vector(It first, It last) {
+			builder b;
+			for(; first != last; ++first) {
+				b.push(*first);
+			}
+
+			*this = b.finish();
+		}
+
+		size_type size() const noexcept {
+			return len;
+		}
+
+		bool empty() const noexcept {
+			return len == 0;
+		}
+
+		const T& operator[] (size_type i) const {
+			size_type first;
+			auto n = leaf_at(i, first);
+			return n->elems[i - first];
+		}
+
+		const T& at(size_type i) const {
+			if(i >= len)
+				throw std::out_of_range("ftl::persistent_vector::at");
+
+			return (*this)[i];
+		}
+
+		const T& front() const {
+			return (*this)[0];
+		}
+
+		const T& back() const {
+			return (*this)[len - 1];
+		}
+
+		/// A vector with the element at index `i` replaced by `t`
+		persistent_vector set(size_type i, T t) const {
+			if(i >= len)
+				throw std::out_of_range("ftl::persistent_vector::set");
+
+			return persistent_vector(set(root, height, i, std::move(t)), len, height);
+		}
+
+		/// A vector with `t` appended at the end
+		persistent_vector push_back(T t) const {
+			if(!root)
+				return persistent_vector(path(0, std::move(t)), 1, 0);
+
+			if(auto r = push(root, height, t))
+				return persistent_vector(std::move(r), len + 1, height);
+
+			auto r = make_inner({root, path(height, std::move(t))}, height + 1);
+			return persistent_vector(std::move(r), len + 1, height + 1);
+		}
+
+		iterator begin() const {
+			return iterator(this, 0);
+		}
+
+		iterator end() const {
+			return iterator(this, len);
+		}
+
+		iterator cbegin() const {
+			return begin();
+		}
+
+		iterator cend() const {
+			return end();
+		}
+
+		reverse_iterator rbegin() const {
+			return reverse_iterator(end());
+		}
+
+		reverse_iterator rend() const {
+			return reverse_iterator(begin());
+		}
+
+		/**
+		 * Concatenation of two vectors.
+		 *
+		 * Only the nodes along the seam of the two trees are rebuilt, and
+		 * redistributed as needed to keep the tree balanced.
+		 */
+		friend persistent_vector concat(
+				const persistent_vector& a, const persistent_vector& b) {
+			if(!a.root)
+				return b;
+			if(!b.root)
+				return a;
+
+			auto h = std::max(a.height, b.height);
+			auto r = merged(a.root, a.height, b.root, b.height);
+			if(r->kids.size() == 1)
+				return persistent_vector(r->kids.front(), a.len + b.len, h);
+
+			return persistent_vector(std::move(r), a.len + b.len, h + 1);
+		}
+
+		friend bool operator== (
+				const persistent_vector& a, const persistent_vector& b) {
+			return a.len == b.len && (
+				a.root == b.root || std::equal(a.begin(), a.end(), b.begin())
+			);
+		}
+
+		friend bool operator!= (
+				const persistent_vector& a, const persistent_vector& b) {
+			return !(a == b);
+		}
+
+		friend bool operator< (
+				const persistent_vector& a, const persistent_vector& b) {
+			return std::lexicographical_compare(
+				a.begin(), a.end(), b.begin(), b.end()
+			);
+		}
+
+	private:
+		friend struct _dtl::pv_access;
+		template<typename> friend class persistent_vector;
+
+		// Fills leaves one at a time, then builds the levels above them
+		class builder {
+		public:
+			void push(T t) {
+				if(cur.size() == _dtl::pv_width)
+					flush();
+
+				cur.push_back(std::move(t));
+				++len;
+			}
+
+			persistent_vector finish() {
+				if(!cur.empty())
+					flush();
+
+				if(level.empty())
+					return persistent_vector();
+
+				size_type h = 0;
+				while(level.size() > 1) {
+					std::vector<ptr> next;
+					for(size_type i = 0; i < level.size(); i += _dtl::pv_width) {
+						auto e = std::min(i + _dtl::pv_width, level.size());
+						next.push_back(make_inner(
+							std::vector<ptr>(level.begin() + i, level.begin() + e),
+							h + 1
+						));
+					}
+
+					level = std::move(next);
+					++h;
+				}
+
+				return persistent_vector(level.front(), len, h);
+			}
+
+		private:
+			void flush() {
+				level.push_back(make_leaf(std::move(cur)));
+				cur = std::vector<T>();
+				cur.reserve(_dtl::pv_width);
+			}
+
+			std::vector<ptr> level;
+			std::vector<T> cur;
+			size_type len = 0;
+		};
+
+		persistent_vector(ptr root, size_type len, size_type height)
+		: root(std::move(root)), len(len), height(height) {}
+
+		static size_type size_of(const node& n, size_type h) {
+			return h == 0 ? n.elems.size() : n.sizes.back();
+		}
+
+		static size_type slots_of(const node& n, size_type h) {
+			return h == 0 ? n.elems.size() : n.kids.size();
+		}
+
+		static ptr make_leaf(std::vector<T> elems) {
+			auto n = std::make_shared<node>();
+			FTL_COUNT_ALLOCATION(persistent, sizeof(node));
+			n->elems = std::move(elems);
+			return n;
+		}
+
+		static ptr make_inner(std::vector<ptr> kids, size_type h) {
+			auto n = std::make_shared<node>();
+			FTL_COUNT_ALLOCATION(persistent, sizeof(node));
+			n->sizes.reserve(kids.size());
+
+			size_type s = 0;
+			for(auto& k : kids) {
+				s += size_of(*k, h - 1);
+				n->sizes.push_back(s);
+			}
+
+			n->kids = std::move(kids);
+			return n;
+		}
+
+		/*
+		 * No child can hold more than 32^h elements, so the radix index is a
+		 * lower bound of the child containing i. In a tree that was never
+		 * concatenated, it is also exact.
+		 */
+		static size_type child_index(const node& n, size_type h, size_type i) {
+			auto c = std::min(i >> (_dtl::pv_bits * h), n.kids.size() - 1);
+			while(n.sizes[c] <= i) {
+				++c;
+			}
+
+			return c;
+		}
+
+		const node* leaf_at(size_type i, size_type& first) const {
+			const node* n = root.get();
+			first = 0;
+			for(auto h = height; h > 0; --h) {
+				auto c = child_index(*n, h, i - first);
+				if(c > 0)
+					first += n->sizes[c - 1];
+
+				n = n->kids[c].get();
+			}
+
+			return n;
+		}
+
+		static ptr set(const ptr& n, size_type h, size_type i, T&& t) {
+			auto r = std::make_shared<node>(*n);
+			FTL_COUNT_ALLOCATION(persistent, sizeof(node));
+			if(h == 0) {
+				r->elems[i] = std::move(t);
+			}
+			else {
+				auto c = child_index(*n, h, i);
+				auto offset = c > 0 ? n->sizes[c - 1] : 0;
+				r->kids[c] = set(n->kids[c], h - 1, i - offset, std::move(t));
+			}
+
+			return r;
+		}
+
+		// A chain of single child nodes, of height h, ending in a leaf of t
+		static ptr path(size_type h, T&& t) {
+			std::vector<T> elems;
+			elems.reserve(_dtl::pv_width);
+			elems.push_back(std::move(t));
+
+			auto n = make_leaf(std::move(elems));
+			for(size_type i = 1; i <= h; ++i) {
+				n = make_inner({std::move(n)}, i);
+			}
+
+			return n;
+		}
+
+		// Appends along the rightmost path, or gives null if it is full
+		static ptr push(const ptr& n, size_type h, T& t) {
+			if(h == 0) {
+				if(n->elems.size() == _dtl::pv_width)
+					return nullptr;
+
+				auto r = std::make_shared<node>(*n);
+				FTL_COUNT_ALLOCATION(persistent, sizeof(node));
+				r->elems.push_back(std::move(t));
+				return r;
+			}
+
+			if(auto k = push(n->kids.back(), h - 1, t)) {
+				auto r = std::make_shared<node>(*n);
+				FTL_COUNT_ALLOCATION(persistent, sizeof(node));
+				r->kids.back() = std::move(k);
+				++r->sizes.back();
+				return r;
+			}
+
+			if(n->kids.size() == _dtl::pv_width)
+				return nullptr;
+
+			auto r = std::make_shared<node>(*n);
+			FTL_COUNT_ALLOCATION(persistent, sizeof(node));
+			r->kids.push_back(path(h - 1, std::move(t)));
+			r->sizes.push_back(r->sizes.back() + 1);
+			return r;
+		}
+
+		/*
+		 * Concatenates the trees a and b, of heights ha and hb, into an
+		 * inner node of height max(ha, hb) + 1, with one or two children.
+		 */
+		static ptr merged(const ptr& a, size_type ha, const ptr& b, size_type hb) {
+			if(ha == 0 && hb == 0) {
+				if(a->elems.size() + b->elems.size() <= _dtl::pv_width) {
+					auto elems = a->elems;
+					elems.insert(elems.end(), b->elems.begin(), b->elems.end());
+					return make_inner({make_leaf(std::move(elems))}, 1);
+				}
+
+				return make_inner({a, b}, 1);
+			}
+
+			std::vector<ptr> all;
+			if(ha > hb) {
+				auto m = merged(a->kids.back(), ha - 1, b, hb);
+				all.assign(a->kids.begin(), a->kids.end() - 1);
+				all.insert(all.end(), m->kids.begin(), m->kids.end());
+			}
+			else if(ha < hb) {
+				auto m = merged(a, ha, b->kids.front(), hb - 1);
+				all.assign(m->kids.begin(), m->kids.end());
+				all.insert(all.end(), b->kids.begin() + 1, b->kids.end());
+			}
+			else {
+				auto m = merged(a->kids.back(), ha - 1, b->kids.front(), hb - 1);
+				all.assign(a->kids.begin(), a->kids.end() - 1);
+				all.insert(all.end(), m->kids.begin(), m->kids.end());
+				all.insert(all.end(), b->kids.begin() + 1, b->kids.end());
+			}
+
+			return rebalance(std::move(all), std::max(ha, hb));
+		}
+
+		/*
+		 * Redistributes the nodes in all, of height h - 1, so that there are
+		 * at most two more of them than would be needed if they were all
+		 * full, and gathers them in a node of height h + 1.
+		 *
+		 * The plan is the one of the original RRB paper: skip nodes that are
+		 * (nearly) full, and spread the slots of the first one that is not
+		 * over those following it, until there are few enough nodes.
+		 */
+		static ptr rebalance(std::vector<ptr> all, size_type h) {
+			const size_type extras = 2;
+			const size_type invariant = 1;
+
+			std::vector<size_type> counts;
+			counts.reserve(all.size());
+
+			size_type total = 0;
+			for(auto& n : all) {
+				counts.push_back(slots_of(*n, h - 1));
+				total += counts.back();
+			}
+
+			auto optimal = (total + _dtl::pv_width - 1) / _dtl::pv_width;
+			auto n = counts.size();
+			size_type i = 0;
+			while(optimal + extras < n) {
+				while(counts[i] > _dtl::pv_width - invariant) {
+					++i;
+				}
+
+				auto remaining = counts[i];
+				do {
+					auto m = std::min(remaining + counts[i + 1], _dtl::pv_width);
+					remaining = remaining + counts[i + 1] - m;
+					counts[i] = m;
+					++i;
+				} while(remaining > 0);
+
+				for(auto j = i; j < n - 1; ++j) {
+					counts[j] = counts[j + 1];
+				}
+
+				--n;
+				--i;
+			}
+
+			std::vector<ptr> nodes;
+			nodes.reserve(n);
+
+			size_type src = 0, offset = 0;
+			for(size_type k = 0; k < n; ++k) {
+				// Nodes that are left as they were are simply shared
+				if(offset == 0 && slots_of(*all[src], h - 1) == counts[k]) {
+					nodes.push_back(all[src++]);
+					continue;
+				}
+
+				if(h == 1) {
+					std::vector<T> elems;
+					elems.reserve(_dtl::pv_width);
+					while(elems.size() < counts[k]) {
+						auto& s = all[src]->elems;
+						auto take = std::min(counts[k] - elems.size(), s.size() - offset);
+						elems.insert(
+							elems.end(),
+							s.begin() + offset, s.begin() + offset + take
+						);
+
+						offset += take;
+						if(offset == s.size()) {
+							++src;
+							offset = 0;
+						}
+					}
+
+					nodes.push_back(make_leaf(std::move(elems)));
+				}
+				else {
+					std::vector<ptr> kids;
+					kids.reserve(_dtl::pv_width);
+					while(kids.size() < counts[k]) {
+						auto& s = all[src]->kids;
+						auto take = std::min(counts[k] - kids.size(), s.size() - offset);
+						kids.insert(
+							kids.end(),
+							s.begin() + offset, s.begin() + offset + take
+						);
+
+						offset += take;
+						if(offset == s.size()) {
+							++src;
+							offset = 0;
+						}
+					}
+
+					nodes.push_back(make_inner(std::move(kids), h - 1));
+				}
+			}
+
+			if(nodes.size() <= _dtl::pv_width)
+				return make_inner({make_inner(std::move(nodes), h)}, h + 1);
+
+			std::vector<ptr> rest(nodes.begin() + _dtl::pv_width, nodes.end());
+			nodes.resize(_dtl::pv_width);
+			return make_inner(
+				{make_inner(std::move(nodes), h), make_inner(std::move(rest), h)},
+				h + 1
+			);
+		}
+
+		ptr root;
+		size_type len = 0;
+		size_type height = 0;
+	};
+
+	namespace _dtl {
+		struct pv_access {
+			template<typename T>
+			using builder = typename persistent_vector<T>::builder;
+
+			// Maps every leaf, leaving the shape of the tree as it is
+			template<typename U, typename F, typename T>
+			static typename pv_node<U>::ptr map(
+					F& f, const pv_node<T>& n, std::size_t h) {
+				auto r = std::make_shared<pv_node<U>>();
+				FTL_COUNT_ALLOCATION(persistent, sizeof(pv_node<U>));
+				if(h == 0) {
+					r->elems.reserve(n.elems.size());
+					for(auto& e : n.elems) {
+						r->elems.push_back(f(e));
+					}
+				}
+				else {
+					r->kids.reserve(n.kids.size());
+					for(auto& k : n.kids) {
+						r->kids.push_back(map<U>(f, *k, h - 1));
+					}
+
+					r->sizes = n.sizes;
+				}
+
+				return r;
+			}
+
+			template<typename U, typename F, typename T>
+			static persistent_vector<U> map(F& f, const persistent_vector<T>& v) {
+				if(!v.root)
+					return persistent_vector<U>();
+
+				return persistent_vector<U>(map<U>(f, *v.root, v.height), v.len, v.height);
+			}
+		};
+	}
+
+	template<typename T>
+	struct parametric_type_traits<persistent_vector<T>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = persistent_vector<U>;
+	};
+
+	/**
+	 * Monoid instance for persistent vectors.
+	 *
+	 * `append` is `concat`, which shares all but `O(log n)` nodes of its
+	 * arguments.
+	 *
+	 * \ingroup persistent_vector
+	 */
+	template<typename T>
+	struct monoid<persistent_vector<T>> {
+		static persistent_vector<T> id() {
+			return persistent_vector<T>();
+		}
+
+		static persistent_vector<T> append(
+				const persistent_vector<T>& v1,
+				const persistent_vector<T>& v2) {
+			return concat(v1, v2);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monad instance for persistent vectors.
+	 *
+	 * `map` builds a tree of exactly the same shape as the original, and
+	 * `bind` concatenates the vectors resulting from each element.
+	 *
+	 * \ingroup persistent_vector
+	 */
+	template<typename T>
+	struct monad<persistent_vector<T>>
+	: deriving_join<in_terms_of_bind<persistent_vector<T>>>
+	, deriving_apply<in_terms_of_bind<persistent_vector<T>>> {
+
+		static persistent_vector<T> pure(T t) {
+			return persistent_vector<T>().push_back(std::move(t));
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static persistent_vector<U> map(F&& f, const persistent_vector<T>& v) {
+			return _dtl::pv_access::map<U>(f, v);
+		}
+
+		template<
+				typename F,
+				typename U = Value_type<result_of<F(T)>>
+		>
+		static persistent_vector<U> bind(const persistent_vector<T>& v, F&& f) {
+			persistent_vector<U> r;
+			for(auto& e : v) {
+				r = concat(r, f(e));
+			}
+
+			return r;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for persistent vectors.
+	 *
+	 * \ingroup persistent_vector
+	 */
+	template<typename T>
+	struct foldable<persistent_vector<T>>
+	: deriving_foldable<bidirectional_iterable<persistent_vector<T>>> {};
+
+	/**
+	 * Zippable instance for persistent vectors.
+	 *
+	 * Like that of `std::vector`, it zips with any \ref fwditerable.
+	 *
+	 * \ingroup persistent_vector
+	 */
+	template<typename T>
+	struct zippable<persistent_vector<T>> {
+		template<
+				typename F, typename Iterable,
+				typename U = result_of<F(T,Value_type<Iterable>)>,
+				typename = Requires<ForwardIterable<Iterable>()>
+		>
+		static persistent_vector<U> zipWith(
+				F&& f, const persistent_vector<T>& v, const Iterable& i) {
+			_dtl::pv_access::builder<U> b;
+
+			auto it1 = v.begin();
+			auto it2 = i.begin();
+			while(it1 != v.end() && it2 != i.end()) {
+				b.push(f(*it1, *it2));
+				++it1; ++it2;
+			}
+
+			return b.finish();
+		}
+
+		static constexpr bool instance = true;
+	};
+
+}
+
+#endif
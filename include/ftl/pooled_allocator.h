@@ -0,0 +1,445 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_POOLED_ALLOCATOR_H
+#define FTL_POOLED_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include "memory_resource.h"
+
+namespace ftl {
+	/**
+	 * \defgroup pooled_allocator Pooled allocator
+	 *
+	 * Size classed, thread caching storage for small objects.
+	 *
+	 * Blocks of up to 256 bytes are handed out from per-thread free lists,
+	 * one per multiple of 16 bytes, without taking any lock. A thread whose
+	 * list runs dry takes a batch of blocks from a shared depot, and one
+	 * whose list grows long&mdash;as happens when objects are allocated on
+	 * one thread and freed on another&mdash;returns half of it. Only the
+	 * depot ever asks `operator new` for memory, a slab of blocks at a time.
+	 * Larger or over-aligned requests go straight to `operator new`.
+	 *
+	 * This is where `ftl::function` and `ftl::unique_function` keep function
+	 * objects that do not fit their small buffer. The same storage is
+	 * available as a standard allocator, e.g. for the nodes of a
+	 * `std::list`, and as a memory resource, e.g. for lazy cells.
+	 *
+	 * Memory taken by the depot is kept for reuse for the rest of the
+	 * program, and is never handed back to the system.
+	 *
+	 * \code
+	 *   #include <ftl/pooled_allocator.h>
+	 * \endcode
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::list<int, ftl::pooled_allocator<int>> xs{1, 2, 3};
+	 *
+	 *   ftl::resource_allocator<int> alloc(ftl::pooled_resource());
+	 *   auto l = ftl::lazy<int>(std::allocator_arg, alloc, []{ return 12; });
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<atomic>`
+	 * - `<cstddef>`
+	 * - `<limits>`
+	 * - `<mutex>`
+	 * - `<new>`
+	 * - \ref memory_resource
+	 */
+
+	/**
+	 * What the pool did on behalf of the calling thread.
+	 *
+	 * \ingroup pooled_allocator
+	 */
+	struct pool_stats {
+		/// Blocks allocated by the thread
+		std::size_t allocations;
+		/// Allocations served from the thread's own free lists
+		std::size_t cache_hits;
+		/// Batches of blocks the thread took from the shared depot
+		std::size_t refills;
+		/// Batches of blocks the thread returned to the shared depot
+		std::size_t spills;
+		/// Free blocks currently held by the thread
+		std::size_t cached_blocks;
+		/// Bytes the depot has obtained from `operator new`, for all threads
+		std::size_t reserved_bytes;
+	};
+
+	namespace _dtl {
+		constexpr std::size_t pool_granule = 16;
+		constexpr std::size_t pool_classes = 16;
+		constexpr std::size_t pool_max_block = pool_granule * pool_classes;
+
+		// Blocks moved between a thread and the depot at once
+		constexpr std::size_t pool_batch = 32;
+
+		// Free blocks of one class a thread keeps before returning some
+		constexpr std::size_t pool_cache_limit = 2 * pool_batch;
+
+		inline bool is_pooled(std::size_t bytes, std::size_t alignment) noexcept {
+			return bytes <= pool_max_block
+				&& alignment <= alignof(std::max_align_t);
+		}
+
+		inline std::size_t pool_class(std::size_t bytes) noexcept {
+			return bytes == 0 ? 0 : (bytes - 1) / pool_granule;
+		}
+
+		struct pool_block {
+			pool_block* next;
+		};
+
+		// Last block of a non-empty list
+		inline pool_block* pool_tail(pool_block* b) noexcept {
+			while(b->next)
+				b = b->next;
+
+			return b;
+		}
+
+		/*
+		 * The free blocks shared by all threads, one locked list per class.
+		 *
+		 * Slabs carved into blocks are never released, as their blocks may
+		 * be in any thread's hands at any time.
+		 */
+		class pool_depot {
+		public:
+			// Moves a batch of blocks of class c into a list, returning its size
+			std::size_t take(std::size_t c, pool_block*& head) {
+				auto& s = shelves[c];
+				{
+					std::lock_guard<std::mutex> lock(s.m);
+					if(s.head) {
+						std::size_t n = 0;
+						pool_block* last = nullptr;
+						for(auto b = s.head; b && n < pool_batch; b = b->next) {
+							last = b;
+							++n;
+						}
+
+						head = s.head;
+						s.head = last->next;
+						last->next = nullptr;
+						return n;
+					}
+				}
+
+				return carve(c, head);
+			}
+
+			// Adds the list from head to tail to the blocks of class c
+			void give(
+					std::size_t c, pool_block* head, pool_block* tail
+			) noexcept {
+				auto& s = shelves[c];
+				std::lock_guard<std::mutex> lock(s.m);
+				tail->next = s.head;
+				s.head = head;
+			}
+
+			std::size_t reserved() const noexcept {
+				return reserved_bytes.load(std::memory_order_relaxed);
+			}
+
+		private:
+			struct shelf {
+				std::mutex m;
+				pool_block* head = nullptr;
+			};
+
+			std::size_t carve(std::size_t c, pool_block*& head) {
+				std::size_t size = (c + 1) * pool_granule;
+				auto slab = static_cast<char*>(::operator new(size * pool_batch));
+				reserved_bytes.fetch_add(size * pool_batch, std::memory_order_relaxed);
+
+				for(std::size_t i = 0; i < pool_batch; ++i) {
+					auto b = reinterpret_cast<pool_block*>(slab + i * size);
+					b->next = i + 1 < pool_batch
+						? reinterpret_cast<pool_block*>(slab + (i + 1) * size)
+						: nullptr;
+				}
+
+				head = reinterpret_cast<pool_block*>(slab);
+				return pool_batch;
+			}
+
+			shelf shelves[pool_classes];
+			std::atomic<std::size_t> reserved_bytes{0};
+		};
+
+		// Never destroyed, so that exiting threads may always return blocks
+		inline pool_depot& shared_pool_depot() {
+			static pool_depot* d = new pool_depot;
+			return *d;
+		}
+
+		// The free lists of one thread, returned to the depot when it exits
+		class pool_cache {
+		public:
+			pool_cache() = default;
+			pool_cache(const pool_cache&) = delete;
+			pool_cache& operator= (const pool_cache&) = delete;
+
+			~pool_cache() {
+				for(std::size_t c = 0; c < pool_classes; ++c) {
+					auto& l = lists[c];
+					if(l.head)
+						shared_pool_depot().give(c, l.head, pool_tail(l.head));
+				}
+
+				retired() = true;
+			}
+
+			void* allocate(std::size_t c) {
+				auto& l = lists[c];
+				if(l.head) {
+					++stats.cache_hits;
+				}
+				else {
+					l.count = shared_pool_depot().take(c, l.head);
+					++stats.refills;
+				}
+
+				auto b = l.head;
+				l.head = b->next;
+				--l.count;
+				++stats.allocations;
+				return b;
+			}
+
+			void deallocate(void* p, std::size_t c) noexcept {
+				auto& l = lists[c];
+				auto b = static_cast<pool_block*>(p);
+				b->next = l.head;
+				l.head = b;
+
+				if(++l.count > pool_cache_limit)
+					spill(c);
+			}
+
+			pool_stats statistics() const noexcept {
+				pool_stats s = stats;
+				s.cached_blocks = 0;
+				for(auto& l : lists)
+					s.cached_blocks += l.count;
+
+				s.reserved_bytes = shared_pool_depot().reserved();
+				return s;
+			}
+
+			// Whether the calling thread's cache has been destroyed
+			static bool& retired() noexcept {
+				static thread_local bool r = false;
+				return r;
+			}
+
+		private:
+			struct free_list {
+				pool_block* head = nullptr;
+				std::size_t count = 0;
+			};
+
+			// Returns all but a batch of the blocks of class c to the depot
+			void spill(std::size_t c) noexcept {
+				auto& l = lists[c];
+				auto last = l.head;
+				for(std::size_t i = 1; i < pool_batch; ++i)
+					last = last->next;
+
+				auto head = last->next;
+				last->next = nullptr;
+				shared_pool_depot().give(c, head, pool_tail(head));
+
+				l.count = pool_batch;
+				++stats.spills;
+			}
+
+			free_list lists[pool_classes];
+			pool_stats stats{0, 0, 0, 0, 0, 0};
+		};
+
+		// The calling thread's cache, or null if the thread is exiting
+		inline pool_cache* local_pool_cache() noexcept {
+			if(pool_cache::retired())
+				return nullptr;
+
+			static thread_local pool_cache cache;
+			return &cache;
+		}
+	}
+
+	/**
+	 * Allocate `bytes` bytes aligned to `alignment` from the pool.
+	 *
+	 * Throws `std::bad_alloc` if no memory is available.
+	 *
+	 * \ingroup pooled_allocator
+	 */
+	inline void* pooled_allocate(
+			std::size_t bytes,
+			std::size_t alignment = alignof(std::max_align_t)
+	) {
+		using namespace _dtl;
+
+		if(!is_pooled(bytes, alignment))
+			return ::operator new(bytes);
+
+		auto c = pool_class(bytes);
+		if(auto cache = local_pool_cache())
+			return cache->allocate(c);
+
+		// The thread is exiting, so keep none of the batch
+		pool_block* head = nullptr;
+		if(shared_pool_depot().take(c, head) > 1)
+			shared_pool_depot().give(c, head->next, pool_tail(head));
+
+		return head;
+	}
+
+	/**
+	 * Return memory acquired through `pooled_allocate` with the same sizes.
+	 *
+	 * May be called from any thread, not only the one that allocated.
+	 *
+	 * \ingroup pooled_allocator
+	 */
+	inline void pooled_deallocate(
+			void* p,
+			std::size_t bytes,
+			std::size_t alignment = alignof(std::max_align_t)
+	) noexcept {
+		using namespace _dtl;
+
+		if(!is_pooled(bytes, alignment)) {
+			::operator delete(p);
+			return;
+		}
+
+		auto c = pool_class(bytes);
+		if(auto cache = local_pool_cache()) {
+			cache->deallocate(p, c);
+			return;
+		}
+
+		auto b = static_cast<pool_block*>(p);
+		shared_pool_depot().give(c, b, b);
+	}
+
+	/**
+	 * What the pool did on behalf of the calling thread, so far.
+	 *
+	 * \ingroup pooled_allocator
+	 */
+	inline pool_stats pool_statistics() noexcept {
+		if(auto cache = _dtl::local_pool_cache())
+			return cache->statistics();
+
+		return pool_stats{0, 0, 0, 0, 0, _dtl::shared_pool_depot().reserved()};
+	}
+
+	/**
+	 * Stateless allocator drawing from the pool.
+	 *
+	 * All instances compare equal, and memory may be freed by a different
+	 * thread than the one that allocated it.
+	 *
+	 * \ingroup pooled_allocator
+	 */
+	template<typename T>
+	class pooled_allocator {
+	public:
+		using value_type = T;
+
+		pooled_allocator() noexcept = default;
+
+		template<typename U>
+		pooled_allocator(const pooled_allocator<U>&) noexcept {}
+
+		T* allocate(std::size_t n) {
+			if(n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+				throw std::bad_alloc();
+
+			return static_cast<T*>(pooled_allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* p, std::size_t n) noexcept {
+			pooled_deallocate(p, n * sizeof(T), alignof(T));
+		}
+	};
+
+	/// \ingroup pooled_allocator
+	template<typename T, typename U>
+	constexpr bool operator== (
+			const pooled_allocator<T>&, const pooled_allocator<U>&) noexcept {
+		return true;
+	}
+
+	/// \ingroup pooled_allocator
+	template<typename T, typename U>
+	constexpr bool operator!= (
+			const pooled_allocator<T>&, const pooled_allocator<U>&) noexcept {
+		return false;
+	}
+
+	namespace _dtl {
+		class pooled_resource_t : public memory_resource {
+			void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+				FTL_COUNT_ALLOCATION(memory_resource, bytes);
+				return pooled_allocate(bytes, alignment);
+			}
+
+			void do_deallocate(
+					void* p, std::size_t bytes, std::size_t alignment) override {
+				pooled_deallocate(p, bytes, alignment);
+			}
+
+			bool do_is_equal(const memory_resource& other) const noexcept
+			override {
+				return this == &other;
+			}
+		};
+	}
+
+	/**
+	 * Memory resource drawing from the pool.
+	 *
+	 * \ingroup pooled_allocator
+	 */
+	inline memory_resource* pooled_resource() noexcept {
+		static _dtl::pooled_resource_t resource;
+		return &resource;
+	}
+}
+
+#endif
+
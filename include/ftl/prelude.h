@@ -23,6 +23,7 @@
 #ifndef FTL_PRELUDE_H
 #define FTL_PRELUDE_H
 
+#include <functional>
 #include <tuple>
 #include "function.h"
 #include "concepts/basic.h"
@@ -42,6 +43,7 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * \par Dependencies
+	 * - `<functional>`
 	 * - `<tuple>`
 	 * - \ref function
 	 * - \ref concepts_basic
@@ -185,6 +187,36 @@ namespace ftl {
 		T val;
 	};
 
+	/**
+	 * Identity wrapper of a reference.
+	 *
+	 * Refers to the wrapped object rather than holding a copy of it, e.g. in
+	 * `either<L,R&>`. Like any reference, it cannot be re-seated, and is
+	 * therefore not assignable.
+	 *
+	 * \ingroup prelude
+	 */
+	template<typename T>
+	struct Identity<T&> {
+		using value_type = T&;
+
+		explicit constexpr Identity(T& t) noexcept : val(t) {}
+
+		constexpr operator T& () const noexcept {
+			return val;
+		}
+
+		constexpr T& operator*() const noexcept {
+			return val;
+		}
+
+		T* operator->() const noexcept {
+			return std::addressof(val);
+		}
+
+		T& val;
+	};
+
 	// ## Operators for Identity type transformer
 
 	template<typename T, typename = Requires<Eq<T>{}>>
@@ -381,40 +413,147 @@ namespace ftl {
 		};
 	}
 
-	/**
-	 * Function composition first base case.
-	 *
-	 * Composes an arbitrary function object with a function pointer.
-	 *
-	 * \ingroup prelude
-	 */
-	template<
-		typename F,
-		typename A,
-		typename B = typename std::result_of<F(A)>::type,
-		typename...Ps>
-	function<B(Ps...)> compose(F f, A (*fn)(Ps...)) {
-		return [f,fn](Ps...ps) {
-			return f(fn(std::forward<Ps>(ps)...));
+	namespace _dtl {
+		// f . g as a concrete function object, calling f with the result of g
+		template<typename F, typename G>
+		struct composed {
+			template<typename...Ps>
+			constexpr auto operator() (Ps&&...ps) const
+			-> decltype(std::declval<const F&>()(
+				std::declval<const G&>()(std::declval<Ps>()...)
+			)) {
+				return f(g(std::forward<Ps>(ps)...));
+			}
+
+			F f;
+			G g;
 		};
+
+		/*
+		 * What compose(f, g) yields.
+		 *
+		 * When g is of a known, fixed arity greater than one, the composition
+		 * is curried in g's arguments, as it would be had it been an
+		 * ftl::function. This holds for g that are themselves such
+		 * compositions, too.
+		 */
+		template<typename F, typename G>
+		struct compose_result {
+			using type = composed<F,G>;
+		};
+
+		template<typename F, typename A, typename P1, typename P2, typename...Ps>
+		struct compose_result<F, A(*)(P1,P2,Ps...)> {
+			using type = curried_fn_n<
+				2+sizeof...(Ps), composed<F,A(*)(P1,P2,Ps...)>
+			>;
+		};
+
+		template<typename F, typename A, typename P1, typename P2, typename...Ps>
+		struct compose_result<F, function<A(P1,P2,Ps...)>> {
+			using type = curried_fn_n<
+				2+sizeof...(Ps), composed<F,function<A(P1,P2,Ps...)>>
+			>;
+		};
+
+		template<typename F, size_t N, typename G>
+		struct compose_result<F, curried_fn_n<N,G>> {
+			using type = curried_fn_n<N, composed<F,curried_fn_n<N,G>>>;
+		};
+
+		template<typename...Fs>
+		struct composition;
+
+		template<typename F, typename G>
+		struct composition<F,G> : compose_result<F,G> {};
+
+		template<typename F, typename G, typename...Fs>
+		struct composition<F,G,Fs...>
+		: compose_result<F, typename composition<G,Fs...>::type> {};
+
+		// A binary function object with its parameters swapped
+		template<typename F>
+		struct flipped : curried_binf<flipped<F>> {
+			constexpr explicit flipped(F f) : f(std::move(f)) {}
+
+			template<typename B, typename A>
+			constexpr auto operator() (B&& b, A&& a) const
+			-> decltype(std::declval<const F&>()(
+				std::declval<A>(), std::declval<B>()
+			)) {
+				return f(std::forward<A>(a), std::forward<B>(b));
+			}
+
+			using curried_binf<flipped<F>>::operator();
+
+			F f;
+		};
+
+		// Same as flipped, but for functions of the form (a) -> (b) -> r
+		template<typename F>
+		struct flipped_curried : curried_binf<flipped_curried<F>> {
+			constexpr explicit flipped_curried(F f) : f(std::move(f)) {}
+
+			template<typename B, typename A>
+			constexpr auto operator() (B&& b, A&& a) const
+			-> decltype(std::declval<const F&>()(std::declval<A>())(
+				std::declval<B>()
+			)) {
+				return f(std::forward<A>(a))(std::forward<B>(b));
+			}
+
+			using curried_binf<flipped_curried<F>>::operator();
+
+			F f;
+		};
+
+		template<typename>
+		struct is_curried_binary : std::false_type {};
+
+		template<typename R, typename A, typename B>
+		struct is_curried_binary<function<function<R(B)>(A)>>
+		: std::true_type {};
 	}
 
 	/**
-	 * Function composition second base case.
+	 * Function composition.
+	 *
+	 * Composes two arbitrary function objects, function pointers or
+	 * references to functions, such that `compose(f, g)(ps...)` is
+	 * `f(g(ps...))`.
+	 *
+	 * The result is a concrete function object holding copies of `f` and `g`,
+	 * which is `constexpr` whenever they are. No type erasure takes place; the
+	 * composition converts to an ftl::function if and when it has to.
+	 *
+	 * If `g` is a function pointer or an ftl::function of two or more
+	 * parameters, the composition supports curried calling.
 	 *
-	 * Composes an arbitrary function object with an ftl::function.
+	 * \par Examples
+	 * \code
+	 *   auto f = ftl::compose([](int x){ return x+1; }, curry_me);
+	 *
+	 *   // f(1, 2) == f(1)(2) == 4
+	 * \endcode
 	 *
 	 * \ingroup prelude
 	 */
-	template<
-		typename F,
-		typename A,
-		typename B = typename std::result_of<F(A)>::type,
-		typename...Ps>
-	function<B(Ps...)> compose(F f, function<A(Ps...)> fn) {
-		return [f,fn](Ps...ps) {
-			return f(fn(std::forward<Ps>(ps)...));
-		};
+	template<typename F, typename G>
+#ifndef DOCUMENTATION_GENERATOR
+	constexpr typename _dtl::composition<
+		typename std::decay<F>::type, typename std::decay<G>::type
+	>::type
+#else
+	ImplementationDefined
+#endif
+	compose(F&& f, G&& g) {
+		return typename _dtl::composition<
+			typename std::decay<F>::type, typename std::decay<G>::type
+		>::type(
+			_dtl::composed<
+				typename std::decay<F>::type, typename std::decay<G>::type
+			>{std::forward<F>(f), std::forward<G>(g)}
+		);
 	}
 
 	/**
@@ -426,50 +565,92 @@ namespace ftl {
 	 * left. Return values must match parameter type of the next one in the
 	 * chain.
 	 *
+	 * The result is a nesting of the same concrete function objects binary
+	 * composition yields, and so is just as cheap to call.
+	 *
 	 * \ingroup prelude
 	 */
-	template<typename F, typename...Fs>
-	auto compose(F&& f, Fs&&...fs)
-	-> decltype(compose(std::forward<F>(f), compose(std::forward<Fs>(fs)...))) {
-		return compose(std::forward<F>(f), compose(std::forward<Fs>(fs)...));
+	template<
+			typename F, typename G, typename H, typename...Fs
+	>
+#ifndef DOCUMENTATION_GENERATOR
+	constexpr typename _dtl::composition<
+		typename std::decay<F>::type,
+		typename std::decay<G>::type,
+		typename std::decay<H>::type,
+		typename std::decay<Fs>::type...
+	>::type
+#else
+	ImplementationDefined
+#endif
+	compose(F&& f, G&& g, H&& h, Fs&&...fs) {
+		return compose(
+			std::forward<F>(f),
+			compose(
+				std::forward<G>(g), std::forward<H>(h), std::forward<Fs>(fs)...
+			)
+		);
 	}
 
 	/**
 	 * Flip the parameter order of a binary function.
 	 *
-	 * \ingroup prelude
-	 */
-	template<typename A, typename B, typename R>
-	function<R(B,A)> flip(function<R(A,B)> f) {
-		return [f](B b, A a) {
-			return f(std::forward<A>(a), std::forward<B>(b));
-		};
-	}
-
-	/**
-	 * \overload
+	 * Works on any binary function object, function pointer or reference to
+	 * function. The result is a concrete function object that calls `f`
+	 * directly, with no type erasure involved, and which also supports
+	 * curried calling:
+	 * \code
+	 *   auto g = ftl::flip(f);
+	 *
+	 *   // g(b, a) == g(b)(a) == f(a, b)
+	 * \endcode
 	 *
 	 * \ingroup prelude
 	 */
-	template<typename A, typename B, typename R>
-	function<R(B,A)> flip(R (&f) (A,B)) {
-		return [&f](B b, A a) {
-			return f(std::forward<A>(a), std::forward<B>(b));
-		};
+	template<
+			typename F,
+			typename = Requires<
+				!_dtl::is_curried_binary<typename std::decay<F>::type>::value
+			>
+	>
+#ifndef DOCUMENTATION_GENERATOR
+	constexpr _dtl::flipped<typename std::decay<F>::type>
+#else
+	ImplementationDefined
+#endif
+	flip(F&& f) {
+		return _dtl::flipped<typename std::decay<F>::type>(std::forward<F>(f));
 	}
 
 	/**
 	 * Flip parameter order of a curried binary function.
 	 *
+	 * The result is a function object such that `flip(f)(b)(a)` is
+	 * `f(a)(b)`.
+	 *
 	 * \ingroup prelude
 	 */
 	template<typename R, typename A, typename B>
-	function<function<R(A)>(B)> flip(function<function<R(B)>(A)> f) {
-		return [f](B b) {
-			return [f,b](A a) {
-				return f(std::forward<A>(a))(b);
-			};
-		};
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::flipped_curried<function<function<R(B)>(A)>>
+#else
+	ImplementationDefined
+#endif
+	flip(function<function<R(B)>(A)> f) {
+		return _dtl::flipped_curried<function<function<R(B)>(A)>>(std::move(f));
+	}
+
+	namespace _dtl {
+		// Whether iterating an F directly yields its Value_type elements
+		template<typename F, bool = has_begin<F>::value && has_end<F>::value>
+		struct iterates_values : std::false_type {};
+
+		template<typename F>
+		struct iterates_values<F,true>
+		: std::is_same<
+			Value_type<F>,
+			plain_type<decltype(*begin(std::declval<const F&>()))>
+		> {};
 	}
 
 	/**
@@ -494,11 +675,11 @@ namespace ftl {
 	constexpr bool ForwardIterable() {
 		return has_begin<T>::value &&
 			has_end<T>::value &&
-			has_pre_inc<decltype(begin(std::declval<T>()))>::value &&
-			has_post_inc<decltype(begin(std::declval<T>()))>::value &&
+			has_pre_inc<_dtl::begin_type<T>>::value &&
+			has_post_inc<_dtl::begin_type<T>>::value &&
 			std::is_same<
 				Value_type<T>,
-				plain_type<decltype(*begin(std::declval<T>()))>
+				plain_type<decltype(*std::declval<_dtl::begin_type<T>>())>
 			>::value;
 	}
 
@@ -641,5 +822,16 @@ namespace ftl {
 #endif
 
 }
+
+namespace std {
+	/// Hash of the wrapped value, or referent
+	template<typename T>
+	struct hash<ftl::Identity<T>> {
+		size_t operator() (const ftl::Identity<T>& x) const {
+			return hash<ftl::plain_type<T>>()(*x);
+		}
+	};
+}
+
 #endif
 
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_SEGMENT_TREE_H
+#define FTL_SEGMENT_TREE_H
+
+#include <vector>
+#include <initializer_list>
+#include "concepts/monoid.h"
+#include "concepts/foldable.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup segment_tree Segment Tree
+	 *
+	 * A vector that keeps the monoidal summaries of its elements up to date.
+	 *
+	 * \code
+	 *   #include <ftl/segment_tree.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to
+	 * `ftl::segment_tree`:
+	 * - \ref foldablepg
+	 *
+	 * \par Dependencies
+	 * - <vector>
+	 * - <initializer_list>
+	 * - \ref monoid
+	 * - \ref foldable
+	 */
+
+	namespace _dtl {
+		// Default measure of a segment_tree, converting elements to M
+		template<typename M>
+		struct to_monoid {
+			template<typename T>
+			M operator() (const T& t) const {
+				return M(t);
+			}
+		};
+	}
+
+	/**
+	 * A sequence of elements together with the fold of every segment of it.
+	 *
+	 * Each element `x` is measured as the monoid value `measure(x)`, and the
+	 * tree keeps the `monoid<M>::append` of the measures of every power of
+	 * two aligned segment. The fold of the whole sequence is hence always at
+	 * hand, that of any range can be had by appending O(log n) of these,
+	 * and changing an element only has to update the O(log n) segments it
+	 * is part of. The order of the elements is respected throughout, so `M`
+	 * need not be commutative.
+	 *
+	 * Elements are read-only through the interface of the container, as any
+	 * change to them must go through `update`.
+	 *
+	 * \tparam T Type of the elements
+	 * \tparam M must satisfy \ref monoidpg
+	 * \tparam Measure Function object of type `M(const T&)`. By default,
+	 *                 elements are converted to `M`.
+	 *
+	 * \par Concepts
+	 * - \ref fwditerable
+	 * - \ref eq, if `T` is
+	 * - \ref foldablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::segment_tree<int,ftl::sum_monoid<int>> t{1, 2, 3, 4};
+	 *
+	 *   t.update(0, 10);
+	 *
+	 *   int all = t.total();      // 19
+	 *   int some = t.fold(1, 3);  // 5
+	 * \endcode
+	 *
+	 * \ingroup segment_tree
+	 */
+	template<typename T, typename M = T, typename Measure = _dtl::to_monoid<M>>
+	class segment_tree {
+		static_assert(Monoid<M>{}, "M must be an instance of Monoid");
+
+	public:
+		using value_type = T;
+
+		/// Type of the cached folds
+		using summary_type = M;
+
+		using size_type = typename std::vector<T>::size_type;
+
+		using const_iterator = typename std::vector<T>::const_iterator;
+		using iterator = const_iterator;
+
+		using const_reverse_iterator
+			= typename std::vector<T>::const_reverse_iterator;
+		using reverse_iterator = const_reverse_iterator;
+
+		segment_tree() : nodes(2, monoid<M>::id()) {}
+
+		explicit segment_tree(Measure measure)
+		: measure(std::move(measure)), nodes(2, monoid<M>::id()) {}
+
+		/// Builds the tree over `v`, in O(n)
+		explicit segment_tree(std::vector<T> v, Measure measure = Measure())
+		: elems(std::move(v)), measure(std::move(measure)) {
+			build();
+		}
+
+		segment_tree(
+				std::initializer_list<T> l, Measure measure = Measure())
+		: elems(l), measure(std::move(measure)) {
+			build();
+		}
+
+		template<typename It>
+		segment_tree(It first, It last, Measure measure = Measure())
+		: elems(first, last), measure(std::move(measure)) {
+			build();
+		}
+
+		size_type size() const noexcept {
+			return elems.size();
+		}
+
+		bool empty() const noexcept {
+			return elems.empty();
+		}
+
+		const T& operator[] (size_type i) const noexcept {
+			return elems[i];
+		}
+
+		const_iterator begin() const noexcept {
+			return elems.begin();
+		}
+
+		const_iterator end() const noexcept {
+			return elems.end();
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		const_reverse_iterator rbegin() const noexcept {
+			return elems.rbegin();
+		}
+
+		const_reverse_iterator rend() const noexcept {
+			return elems.rend();
+		}
+
+		/// The fold of every element, in O(1)
+		const M& total() const noexcept {
+			return nodes[1];
+		}
+
+		/**
+		 * The fold of the elements in `[first,last)`, in O(log n).
+		 *
+		 * An empty range folds to `monoid<M>::id()`.
+		 */
+		M fold(size_type first, size_type last) const {
+			auto l = monoid<M>::id();
+			auto r = monoid<M>::id();
+			for(first += leaves(), last += leaves(); first < last;
+					first /= 2, last /= 2) {
+				if(first & 1)
+					l = monoid<M>::append(std::move(l), nodes[first++]);
+
+				if(last & 1)
+					r = monoid<M>::append(nodes[--last], std::move(r));
+			}
+
+			return monoid<M>::append(std::move(l), std::move(r));
+		}
+
+		/// Replace the `i`:th element, in O(log n)
+		void update(size_type i, T x) {
+			elems[i] = std::move(x);
+			refresh(i);
+		}
+
+		/**
+		 * Apply `f` to the `i`:th element in place, in O(log n).
+		 *
+		 * \tparam F must be callable as `void(T&)`
+		 */
+		template<typename F>
+		void modify(size_type i, F&& f) {
+			f(elems[i]);
+			refresh(i);
+		}
+
+		/**
+		 * Append an element, in amortised O(log n).
+		 *
+		 * The tree is rebuilt, at twice the capacity, whenever it is full.
+		 */
+		void push_back(T x) {
+			elems.push_back(std::move(x));
+			if(elems.size() > leaves())
+				build();
+			else
+				refresh(elems.size() - 1);
+		}
+
+		/// Remove the last element, in O(log n)
+		void pop_back() {
+			elems.pop_back();
+
+			auto p = leaves() + elems.size();
+			nodes[p] = monoid<M>::id();
+			combine_above(p);
+		}
+
+		void clear() {
+			elems.clear();
+			nodes.assign(2, monoid<M>::id());
+		}
+
+		bool operator== (const segment_tree& t) const {
+			return elems == t.elems;
+		}
+
+		bool operator!= (const segment_tree& t) const {
+			return elems != t.elems;
+		}
+
+	private:
+		// Number of leaves, the smallest power of two that fits elems
+		size_type leaves() const noexcept {
+			return nodes.size() / 2;
+		}
+
+		void build() {
+			size_type n = 1;
+			while(n < elems.size())
+				n *= 2;
+
+			nodes.assign(2*n, monoid<M>::id());
+			for(size_type i = 0; i < elems.size(); ++i)
+				nodes[n + i] = measure(elems[i]);
+
+			for(auto p = n - 1; p > 0; --p)
+				nodes[p] = monoid<M>::append(nodes[2*p], nodes[2*p + 1]);
+		}
+
+		void refresh(size_type i) {
+			auto p = leaves() + i;
+			nodes[p] = measure(elems[i]);
+			combine_above(p);
+		}
+
+		void combine_above(size_type p) {
+			for(p /= 2; p > 0; p /= 2)
+				nodes[p] = monoid<M>::append(nodes[2*p], nodes[2*p + 1]);
+		}
+
+		std::vector<T> elems;
+		Measure measure;
+
+		// Implicit binary tree; the root is at 1, the leaves from leaves()
+		std::vector<M> nodes;
+	};
+
+	/**
+	 * Foldable instance for segment_tree.
+	 *
+	 * Folds over the elements themselves, like any other container. To get
+	 * at the cached summaries, use `segment_tree::total` and
+	 * `segment_tree::fold`.
+	 *
+	 * \ingroup segment_tree
+	 */
+	template<typename T, typename M, typename Measure>
+	struct foldable<segment_tree<T,M,Measure>>
+	: deriving_foldable<bidirectional_iterable<segment_tree<T,M,Measure>>> {};
+}
+
+#endif
+
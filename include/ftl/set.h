@@ -23,7 +23,10 @@
 #ifndef FTL_SET_H
 #define FTL_SET_H
 
+#include <iterator>
 #include <set>
+#include <vector>
+#include <algorithm>
 #include "concepts/monad.h"
 #include "concepts/foldable.h"
 
@@ -46,7 +49,10 @@ namespace ftl {
 	 * - \ref monadpg
 	 *
 	 * \par Dependencies
+	 * - <iterator>
 	 * - <set>
+	 * - <vector>
+	 * - <algorithm>
 	 * - \ref monad
 	 * - \ref foldable
 	 */
@@ -69,6 +75,76 @@ namespace ftl {
 		using rebind = std::set<U,Rebind<Cmp,U>,rebind_allocator<U>>;
 	};
 
+	namespace _dtl {
+		inline std::size_t log2_of(std::size_t n) noexcept {
+			std::size_t lg = 0;
+			for(; n > 1; n >>= 1)
+				++lg;
+
+			return lg;
+		}
+
+		/*
+		 * Inserts the elements of s into rs. Large sets are merged in one
+		 * linear pass, each element inserted with an exact hint in constant
+		 * time; sets much smaller than rs are inserted element by element.
+		 */
+		template<typename S>
+		void merge_into(S& rs, const S& s) {
+			auto n1 = rs.size(), n2 = s.size();
+			if(n2 * log2_of(n1 + 1) < n1) {
+				rs.insert(s.begin(), s.end());
+				return;
+			}
+
+			auto cmp = rs.value_comp();
+			auto pos = rs.begin();
+			for(const auto& e : s) {
+				while(pos != rs.end() && cmp(*pos, e))
+					++pos;
+
+				if(pos == rs.end() || cmp(e, *pos))
+					rs.emplace_hint(pos, e);
+			}
+		}
+
+		// K-way merge of a range of sets, appending to the result in order
+		template<typename S, typename I>
+		S merge_all(const I& ss) {
+			using It = typename S::const_iterator;
+			using head = std::pair<It,It>;
+
+			S rs;
+			auto cmp = rs.value_comp();
+
+			std::vector<head> heads;
+			for(const auto& s : ss) {
+				if(!s.empty())
+					heads.emplace_back(s.begin(), s.end());
+			}
+
+			auto later = [&cmp](const head& a, const head& b) {
+				return cmp(*b.first, *a.first);
+			};
+
+			std::make_heap(heads.begin(), heads.end(), later);
+			while(!heads.empty()) {
+				std::pop_heap(heads.begin(), heads.end(), later);
+				auto& h = heads.back();
+
+				if(rs.empty() || cmp(*std::prev(rs.end()), *h.first))
+					rs.emplace_hint(rs.end(), *h.first);
+
+				if(++h.first == h.second)
+					heads.pop_back();
+				else
+					std::push_heap(heads.begin(), heads.end(), later);
+			}
+
+			return rs;
+		}
+	}
+
 	/**
 	 * Implementation of the \ref monoidpg concept.
 	 *
@@ -78,8 +154,10 @@ namespace ftl {
 	 *   append(a, b) == set{a}.insert(b.begin(), b.end())
 	 * \endcode
 	 *
-	 * In cases where e.g. one of the sets is a temporary, `append`
-	 * might actually mutate one of the sets instead of making a copy.
+	 * Both sets being sorted, `append` merges them in linear time, rather
+	 * than inserting the elements of one set into the other one by one.
+	 * Should one of the sets be a temporary, `append` merges into it instead
+	 * of making a copy, reusing its nodes.
 	 *
 	 * \ingroup set
 	 */
@@ -95,8 +173,11 @@ namespace ftl {
 				const std::set<T,Cmp,A>& s1,
 				const std::set<T,Cmp,A>& s2) {
 
+			if(s1.size() < s2.size())
+				return append(s2, s1);
+
 			std::set<T,Cmp,A> rs{s1};
-			rs.insert(s2.begin(), s2.end());
+			_dtl::merge_into(rs, s2);
 
 			return rs;
 		}
@@ -105,16 +186,16 @@ namespace ftl {
 				std::set<T,Cmp,A>&& s1,
 				const std::set<T,Cmp,A>& s2) {
 
-			s1.insert(s2.begin(), s2.end());
-			return s1;
+			_dtl::merge_into(s1, s2);
+			return std::move(s1);
 		}
 
 		static std::set<T,Cmp,A> append(
 				const std::set<T,Cmp,A>& s1,
 				std::set<T,Cmp,A>&& s2) {
 
-			s2.insert(s1.begin(), s1.end());
-			return s2;
+			_dtl::merge_into(s2, s1);
+			return std::move(s2);
 		}
 
 		static std::set<T,Cmp,A> append(
@@ -122,21 +203,182 @@ namespace ftl {
 				std::set<T,Cmp,A>&& s2) {
 
 			if(s1.size() > s2.size()) {
-				s1.insert(s2.begin(), s2.end());
+				_dtl::merge_into(s1, s2);
 
-				return s1;
+				return std::move(s1);
 			}
 
 			else {
-				s2.insert(s1.begin(), s1.end());
+				_dtl::merge_into(s2, s1);
 
-				return s2;
+				return std::move(s2);
 			}
 		}
 
+		/**
+		 * Unites an entire sequence of sets.
+		 *
+		 * The sets are merged all at once, a k-way merge appending every
+		 * element of the result in order.
+		 *
+		 * \tparam I must satisfy \ref fwditerable, with sets as elements
+		 */
+		template<
+				typename I,
+				typename = Requires<ForwardIterable<I>()>
+		>
+		static std::set<T,Cmp,A> mconcat(const I& ss) {
+			return _dtl::merge_all<std::set<T,Cmp,A>>(ss);
+		}
+
+		/**
+		 * \overload
+		 *
+		 * The largest set is moved from, reusing its nodes, and all the
+		 * others are merged into it.
+		 */
+		template<
+				typename I,
+				typename = Requires<
+					!std::is_lvalue_reference<I>::value
+					&& ForwardIterable<plain_type<I>>()
+				>
+		>
+		static std::set<T,Cmp,A> mconcat(I&& ss) {
+			auto largest = find_largest(ss);
+			if(largest == ss.end())
+				return std::set<T,Cmp,A>{};
+
+			std::set<T,Cmp,A> rs{std::move(*largest)};
+			insert_rest(rs, ss, largest);
+			return rs;
+		}
+
+		/// Union does not depend on the order of the sets
+		static constexpr bool commutative = true;
+
 		static constexpr bool instance = true;
+
+	private:
+		template<typename I>
+		static auto find_largest(I& ss) -> decltype(ss.begin()) {
+			auto largest = ss.begin();
+			for(auto it = ss.begin(); it != ss.end(); ++it) {
+				if(it->size() > largest->size())
+					largest = it;
+			}
+
+			return largest;
+		}
+
+		template<typename I, typename It>
+		static void insert_rest(std::set<T,Cmp,A>& rs, I& ss, It largest) {
+			for(auto it = ss.begin(); it != ss.end(); ++it) {
+				if(it != largest)
+					_dtl::merge_into(rs, *it);
+			}
+		}
 	};
 
+	namespace _dtl {
+		/*
+		 * Builds a set from the results of a map by sorting them first,
+		 * unless the mapping happened to preserve the order already, so that
+		 * each element is inserted at the end in constant time.
+		 *
+		 * The sort is stable, so that of several equivalent results, the
+		 * first one is kept, as when inserting them one by one.
+		 */
+		template<typename S, typename U>
+		S set_from_results(std::vector<U>&& v) {
+			S rs;
+			auto cmp = rs.value_comp();
+
+			if(!std::is_sorted(v.begin(), v.end(), cmp))
+				std::stable_sort(v.begin(), v.end(), cmp);
+
+			for(auto& e : v) {
+				rs.emplace_hint(rs.end(), std::move(e));
+			}
+
+			return rs;
+		}
+	}
+
+	/**
+	 * The elements of `s` that satisfy `p`.
+	 *
+	 * The elements are visited in order, so each survivor is inserted at the
+	 * end of the result, in constant time.
+	 *
+	 * \tparam P must satisfy \ref fn`<bool(T)>`
+	 *
+	 * \ingroup set
+	 */
+	template<typename P, typename T, typename Cmp, typename A>
+	std::set<T,Cmp,A> filter(P&& p, const std::set<T,Cmp,A>& s) {
+		std::set<T,Cmp,A> result(s.key_comp(), s.get_allocator());
+		for(auto& e : s) {
+			if(p(e))
+				result.emplace_hint(result.end(), e);
+		}
+
+		return result;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Erases the elements of `s` that fail `p`, keeping the nodes of the
+	 * others. Nothing is allocated.
+	 *
+	 * \ingroup set
+	 */
+	template<typename P, typename T, typename Cmp, typename A>
+	std::set<T,Cmp,A> filter(P&& p, std::set<T,Cmp,A>&& s) {
+		for(auto it = s.begin(); it != s.end();) {
+			if(p(*it))
+				++it;
+			else
+				it = s.erase(it);
+		}
+
+		return std::move(s);
+	}
+
+	/**
+	 * Maps and keeps only the results that are present.
+	 *
+	 * Like `fmap`, the results are gathered in a vector reserved for all of
+	 * `s` first, and only then sorted into a set.
+	 *
+	 * \tparam F must satisfy \ref fn`<maybe<U>(T)>`, or more generally,
+	 *           return any \ref fwditerable of at most one element.
+	 *
+	 * \ingroup set
+	 */
+	template<
+			typename F,
+			typename T,
+			typename Cmp,
+			typename A,
+			typename U = Value_type<result_of<F(T)>>
+	>
+	Rebind<std::set<T,Cmp,A>,U> mapMaybe(F&& f, const std::set<T,Cmp,A>& s) {
+		std::vector<U> v;
+		v.reserve(s.size());
+		for(auto& e : s) {
+			auto m = f(e);
+			for(auto& u : m) {
+				v.push_back(std::move(u));
+			}
+		}
+
+		return _dtl::set_from_results<Rebind<std::set<T,Cmp,A>,U>>(
+			std::move(v)
+		);
+	}
+
 	/**
 	 * \ref monadpg implementation for std::set with parametrised comparator.
 	 *
@@ -146,9 +388,7 @@ namespace ftl {
 	 * \ingroup set
 	 */
 	template<typename T, typename Cmp, typename A>
-	struct monad<std::set<T,Cmp,A>>
-	: deriving_bind<std::set<T,Cmp,A>>
-	, deriving_apply<std::set<T,Cmp,A>> {
+	struct monad<std::set<T,Cmp,A>> {
 
 		/// Alias for cleaner type signatures
 		template<typename U>
@@ -187,23 +427,25 @@ namespace ftl {
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static set<U> map(F&& f, const set<T>& s) {
-			set<U> rs;
+			std::vector<U> v;
+			v.reserve(s.size());
 			for(const auto& e : s) {
-				rs.insert(f(e));
+				v.push_back(f(e));
 			}
 
-			return rs;
+			return _dtl::set_from_results<set<U>>(std::move(v));
 		}
 
 		/// \overload
 		template<typename F, typename U = result_of<F(T)>>
 		static set<U> map(F&& f, set<T>&& s) {
-			set<U> rs;
+			std::vector<U> v;
+			v.reserve(s.size());
 			for(auto& e : s) {
-				rs.insert(f(std::move(e)));
+				v.push_back(f(std::move(e)));
 			}
 
-			return rs;
+			return _dtl::set_from_results<set<U>>(std::move(v));
 		}
 
 		/**
@@ -213,6 +455,9 @@ namespace ftl {
 		 * iteration of the original set of sets) is not guaranteed, simply
 		 * because the resulting set is (naturally) sorted.
 		 *
+		 * The inner sets being sorted already, they are all merged in a
+		 * single k-way merge.
+		 *
 		 * Example:
 		 * \code
 		 *   auto s = ftl::mjoin(std::set<std::set<int>>{{1,3},{2,3,4},{0,5}});
@@ -221,31 +466,69 @@ namespace ftl {
 		 * \endcode
 		 */
 		static set<T> join(const set<set<T>>& s) {
-			 set<T> rs;
-			 for(const auto& ss : s) {
-				 for(const auto& e : ss) {
-					 rs.insert(e);
-				 }
-			 }
-
-			return rs;
+			return _dtl::merge_all<set<T>>(s);
 		}
 
-#ifdef DOCUMENTATION_GENERATOR
 		/**
+		 * Unites the sets `f` maps the elements of `s` to.
+		 *
+		 * The results of `f` are merged as by `monoid::mconcat`, reusing the
+		 * nodes of the largest.
+		 *
 		 * \tparam F must satisfy \ref fn`<set<U>(T)>`, for some type `U` that
 		 *           is comparable using `Cmp<U>`.
 		 */
 		template<
 				typename F,
-				typename U = typename result_of<F(T)>::value_type
+				typename U = Value_type<result_of<F(T)>>
 		>
-		static set<U> bind(const set<T>& s, F&& f);
-#endif
+		static set<U> bind(const set<T>& s, F&& f) {
+			std::vector<set<U>> v;
+			v.reserve(s.size());
+			for(const auto& e : s) {
+				v.push_back(f(e));
+			}
+
+			return monoid<set<U>>::mconcat(std::move(v));
+		}
+
+		/**
+		 * Applies every function in `fs` to every element of `s`.
+		 *
+		 * Like `map`, the results are gathered in a vector of the exact size
+		 * first, and only then sorted into a set.
+		 *
+		 * \tparam Sf must be a set of functions returning some type `U` that
+		 *           is comparable using `Cmp<U>`.
+		 */
+		template<
+				typename Sf,
+				typename F = Value_type<plain_type<Sf>>,
+				typename U = result_of<F(T)>
+		>
+		static set<U> apply(Sf&& fs, const set<T>& s) {
+			std::vector<U> v;
+			v.reserve(fs.size() * s.size());
+			for(auto& f : fs) {
+				for(auto& e : s) {
+					v.push_back(f(e));
+				}
+			}
+
+			return _dtl::set_from_results<set<U>>(std::move(v));
+		}
 
 		static constexpr bool instance = true;
 	};
 
+	/**
+	 * Sets apply every function to every element, keeping the results sorted.
+	 *
+	 * \ingroup set
+	 */
+	template<typename T, typename Cmp, typename A>
+	struct cartesian_apply<std::set<T,Cmp,A>> : std::true_type {};
+
 	/**
 	 * Foldable instance for `std::set`.
 	 *
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_SHARED_LAZY_H
+#define FTL_SHARED_LAZY_H
+
+#include <atomic>
+#include <mutex>
+#include "lazy.h"
+#include "executor.h"
+
+namespace ftl {
+	/**
+	 * \defgroup shared_lazy Shared Lazy
+	 *
+	 * A thread safe variant of the lazy data type, and its concept instances.
+	 *
+	 * \code
+	 *   #include <ftl/shared_lazy.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<atomic>`
+	 * - `<mutex>`
+	 * - \ref lazy
+	 * - \ref executor
+	 */
+
+	namespace _dtl {
+		/*
+		 * The shared state of a set of shared_lazy copies.
+		 *
+		 * Once the value is computed, `ready` is set with release semantics,
+		 * which means readers need only a single acquiring load to safely
+		 * access it. Threads arriving while the computation is in progress
+		 * block inside call_once until it finishes.
+		 */
+		template<typename T>
+		struct shared_lazy_cell {
+			explicit shared_lazy_cell(const function<T()>& f)
+			: val(make_left<T>(f))
+			{}
+
+			const T& force() {
+				if(!ready.load(std::memory_order_acquire)) {
+					std::call_once(once, [this]() {
+						val = make_right<function<T()>>((*get<0>(val))());
+						ready.store(true, std::memory_order_release);
+					});
+				}
+
+				return *get<1>(val);
+			}
+
+			std::atomic<bool> ready{false};
+			std::once_flag once;
+			either<function<T()>,T> val;
+		};
+	}
+
+	/**
+	 * A lazy value that may safely be shared between threads.
+	 *
+	 * Behaves exactly like ftl::lazy, except that copies of a `shared_lazy`
+	 * may be forced concurrently from any number of threads. The deferred
+	 * computation is guaranteed to run exactly once; any thread forcing the
+	 * value while it is being computed blocks until it is ready. Once
+	 * computed, reading the value costs a single atomic load.
+	 *
+	 * If the deferred computation throws, the exception is propagated to
+	 * the thread that forced it, and the next attempt to force the value
+	 * will retry the computation.
+	 *
+	 * \note Only the forcing of the value is synchronised. Assigning to the
+	 *       very same `shared_lazy` object from several threads is no more
+	 *       safe than doing so with a `std::shared_ptr`.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref assignable
+	 * - \ref deref to `T` (_forces_ evaluation).
+	 * - \ref functor
+	 * - \ref applicative
+	 * - \ref monad
+	 *
+	 * \ingroup shared_lazy
+	 */
+	template<typename T>
+	class shared_lazy {
+	public:
+		shared_lazy() = delete;
+		shared_lazy(const shared_lazy&) = default;
+		shared_lazy(shared_lazy&&) = default;
+		~shared_lazy() = default;
+
+		/**
+		 * Construct from a no-argument function object.
+		 *
+		 * The function object is invoked the first time any copy of this
+		 * `shared_lazy` is forced, and never again after it has returned.
+		 */
+		explicit shared_lazy(const function<T()>& f)
+		: cell((
+			FTL_COUNT_ALLOCATION(lazy, sizeof(_dtl::shared_lazy_cell<T>)),
+			std::make_shared<_dtl::shared_lazy_cell<T>>(f)
+		))
+		{}
+
+		/**
+		 * Construct from a regular lazy value.
+		 *
+		 * The resulting `shared_lazy` forces `l` when it is itself forced.
+		 * Because `l` may still be shared with other, unsynchronised copies,
+		 * none of those should be forced concurrently with this one.
+		 */
+		explicit shared_lazy(lazy<T> l)
+		: shared_lazy(function<T()>{[l]() { return *l; }})
+		{}
+
+		/**
+		 * Get a reference to the value.
+		 *
+		 * This method forces evaluation.
+		 */
+		const T& operator*() const {
+			return cell->force();
+		}
+
+		/**
+		 * Access members of the lazy value.
+		 *
+		 * This method forces evaluation.
+		 */
+		const T* operator->() const {
+			return std::addressof(cell->force());
+		}
+
+		shared_lazy& operator= (const shared_lazy&) = default;
+		shared_lazy& operator= (shared_lazy&&) = default;
+
+		/**
+		 * Check the state of the deferred computation.
+		 *
+		 * \return value_status::deferred if computation has not yet finished,
+		 *         and value_status::ready if it has.
+		 */
+		value_status status() const noexcept {
+			if(cell->ready.load(std::memory_order_acquire))
+				return value_status::ready;
+
+			return value_status::deferred;
+		}
+
+	private:
+		std::shared_ptr<_dtl::shared_lazy_cell<T>> cell;
+	};
+
+	/**
+	 * Monad instance for shared lazy values.
+	 *
+	 * Equivalent of the instance for ftl::lazy, except that every computation
+	 * built is itself a `shared_lazy`.
+	 *
+	 * \ingroup shared_lazy
+	 */
+	template<typename T>
+	struct monad<shared_lazy<T>>
+	: deriving_join<in_terms_of_bind<shared_lazy<T>>>
+	, deriving_apply<in_terms_of_bind<shared_lazy<T>>> {
+
+		/// Create a computation that computes `t`
+		static shared_lazy<T> pure(T t) {
+			return shared_lazy<T>{function<T()>{[t](){ return t; }}};
+		}
+
+		/// Map a function to the deferred value, without forcing it.
+		template<typename F, typename U = result_of<F(T)>>
+		static shared_lazy<U> map(F f, shared_lazy<T> l) {
+			return shared_lazy<U>{function<U()>{[f,l]() { return f(*l); }}};
+		}
+
+		/// Sequences two shared lazy computations, without forcing either.
+		template<
+				typename F,
+				typename U = Value_type<result_of<F(T)>>
+		>
+		static shared_lazy<U> bind(shared_lazy<T> l, F f) {
+			return shared_lazy<U>{function<U()>{[f,l]() {
+				return *(f(*l));
+			}}};
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	namespace _dtl {
+		template<typename T>
+		struct spark_task {
+			void operator() () const noexcept {
+				// Whoever forces l next sees the exception, and retries
+				try {
+					*l;
+				}
+				catch(...) {}
+			}
+
+			shared_lazy<T> l;
+		};
+	}
+
+	/**
+	 * Start computing a shared lazy value in the background.
+	 *
+	 * Schedules a task on `ex` that forces `l`, so that its value may be
+	 * ready by the time it is needed, much like Haskell's `par`. Nothing
+	 * is computed twice:
+	 * - if some copy of `l` is forced before the task has started, it is
+	 *   computed on the forcing thread, and the task does nothing once it
+	 *   runs;
+	 * - if it is forced while the task is computing it, the forcing thread
+	 *   waits for the task's result.
+	 *
+	 * Should the computation throw in the task, the exception is dropped
+	 * and the computation is attempted again by whoever forces `l` next.
+	 *
+	 * The task keeps a copy of `l`, which is released once it has run.
+	 *
+	 * \tparam E must satisfy \ref executorpg
+	 *
+	 * \return `l`, for convenience.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::thread_pool pool;
+	 *
+	 *   auto x = ftl::spark(
+	 *       ftl::shared_lazy<int>{[](){ return expensive(); }}, pool
+	 *   );
+	 *
+	 *   doOtherWork();
+	 *   use(*x);
+	 * \endcode
+	 *
+	 * \ingroup shared_lazy
+	 */
+	template<typename T, typename E, typename = Requires<Executor<E>{}>>
+	shared_lazy<T> spark(shared_lazy<T> l, E& ex) {
+		if(l.status() == value_status::deferred)
+			ex.execute(_dtl::spark_task<T>{l});
+
+		return l;
+	}
+}
+
+#endif
+
@@ -0,0 +1,1004 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_SMALL_VECTOR_H
+#define FTL_SMALL_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "prelude.h"
+#include "instrument.h"
+#include "concepts/foldable.h"
+#include "concepts/monad.h"
+#include "concepts/zippable.h"
+#include "implementation/fold_kernels.h"
+
+namespace ftl {
+	/**
+	 * \defgroup small_vector Small Vector
+	 *
+	 * A vector keeping its first few elements inline.
+	 *
+	 * \code
+	 *   #include <ftl/small_vector.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to ftl::small_vector,
+	 * matching those of std::vector:
+	 * - \ref monoid
+	 * - \ref foldable
+	 * - \ref functor
+	 * - \ref applicative
+	 * - \ref monad
+	 * - \ref zippable
+	 *
+	 * Results of the same inline capacity as their input, so that monadic
+	 * code producing a few elements at a time does not allocate at all.
+	 *
+	 * \par Dependencies
+	 * - `<algorithm>`
+	 * - `<cstddef>`
+	 * - `<initializer_list>`
+	 * - `<iterator>`
+	 * - `<memory>`
+	 * - `<new>`
+	 * - `<stdexcept>`
+	 * - `<type_traits>`
+	 * - `<utility>`
+	 * - \ref prelude
+	 * - \ref instrument
+	 * - \ref foldable
+	 * - \ref monad
+	 * - \ref zippable
+	 */
+
+	/**
+	 * Contiguous sequence container with room for `N` elements inline.
+	 *
+	 * Up to `N` elements are kept within the object itself, and only
+	 * beyond that does the vector allocate, after which it grows like
+	 * `std::vector`. Such allocations are counted as
+	 * ftl::alloc_source::small_vector.
+	 *
+	 * The interface follows that of `std::vector`, except that moving a
+	 * vector whose elements are inline moves the elements one by one, and
+	 * hence invalidates iterators to them. A moved from vector is left
+	 * empty.
+	 *
+	 * \ingroup small_vector
+	 */
+	template<typename T, std::size_t N>
+	class small_vector {
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = T&;
+		using const_reference = const T&;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using iterator = T*;
+		using const_iterator = const T*;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		/// Number of elements that fit without allocating
+		static constexpr size_type inline_capacity = N;
+
+		small_vector() noexcept : b(inline_data()) {}
+
+		/// `n` value initialised elements
+		explicit small_vector(size_type n) : small_vector() {
+			resize(n);
+		}
+
+		small_vector(size_type n, const T& t) : small_vector() {
+			resize(n, t);
+		}
+
+		template<
+				typename It,
+				typename = Requires<!std::is_integral<It>::value>
+		>
+		small_vector(It first, It last) : small_vector() {
+			insert(end(), first, last);
+		}
+
+		small_vector(std::initializer_list<T> l)
+		: small_vector(l.begin(), l.end()) {}
+
+		small_vector(const small_vector& v) : small_vector() {
+			reserve(v.size());
+			std::uninitialized_copy(v.begin(), v.end(), b);
+			n = v.size();
+		}
+
+		small_vector(small_vector&& v)
+		noexcept(std::is_nothrow_move_constructible<T>::value)
+		: small_vector() {
+			take(v);
+		}
+
+		~small_vector() {
+			clear();
+			release();
+		}
+
+		small_vector& operator= (const small_vector& v) {
+			if(this != &v)
+				assign(v.begin(), v.end());
+
+			return *this;
+		}
+
+		small_vector& operator= (small_vector&& v)
+		noexcept(std::is_nothrow_move_constructible<T>::value) {
+			if(this != &v) {
+				clear();
+				if(!v.is_inline())
+					release();
+
+				take(v);
+			}
+
+			return *this;
+		}
+
+		small_vector& operator= (std::initializer_list<T> l) {
+			assign(l.begin(), l.end());
+			return *this;
+		}
+
+		template<
+				typename It,
+				typename = Requires<!std::is_integral<It>::value>
+		>
+		void assign(It first, It last) {
+			clear();
+			insert(end(), first, last);
+		}
+
+		iterator begin() noexcept {
+			return b;
+		}
+
+		const_iterator begin() const noexcept {
+			return b;
+		}
+
+		const_iterator cbegin() const noexcept {
+			return b;
+		}
+
+		iterator end() noexcept {
+			return b + n;
+		}
+
+		const_iterator end() const noexcept {
+			return b + n;
+		}
+
+		const_iterator cend() const noexcept {
+			return b + n;
+		}
+
+		reverse_iterator rbegin() noexcept {
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept {
+			return const_reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept {
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept {
+			return const_reverse_iterator(begin());
+		}
+
+		bool empty() const noexcept {
+			return n == 0;
+		}
+
+		size_type size() const noexcept {
+			return n;
+		}
+
+		size_type capacity() const noexcept {
+			return cap;
+		}
+
+		size_type max_size() const noexcept {
+			return std::allocator<T>().max_size();
+		}
+
+		/// Whether the elements are kept inline, i.e. nothing is allocated
+		bool is_inline() const noexcept {
+			return b == inline_data();
+		}
+
+		T* data() noexcept {
+			return b;
+		}
+
+		const T* data() const noexcept {
+			return b;
+		}
+
+		T& operator[] (size_type i) noexcept {
+			return b[i];
+		}
+
+		const T& operator[] (size_type i) const noexcept {
+			return b[i];
+		}
+
+		T& at(size_type i) {
+			if(i >= n)
+				throw std::out_of_range("small_vector::at");
+
+			return b[i];
+		}
+
+		const T& at(size_type i) const {
+			if(i >= n)
+				throw std::out_of_range("small_vector::at");
+
+			return b[i];
+		}
+
+		T& front() noexcept {
+			return b[0];
+		}
+
+		const T& front() const noexcept {
+			return b[0];
+		}
+
+		T& back() noexcept {
+			return b[n-1];
+		}
+
+		const T& back() const noexcept {
+			return b[n-1];
+		}
+
+		/// Make room for at least `k` elements
+		void reserve(size_type k) {
+			if(k > cap)
+				reallocate(k);
+		}
+
+		void clear() noexcept {
+			destroy(b, b + n);
+			n = 0;
+		}
+
+		void push_back(const T& t) {
+			emplace_back(t);
+		}
+
+		void push_back(T&& t) {
+			emplace_back(std::move(t));
+		}
+
+		template<typename...Args>
+		T& emplace_back(Args&&...args) {
+			if(n == cap) {
+				// args may refer to an element, so construct before moving
+				auto k = grown(n + 1);
+				auto p = allocate(k);
+				try {
+					new (p + n) T(std::forward<Args>(args)...);
+				}
+				catch(...) {
+					deallocate(p, k);
+					throw;
+				}
+
+				relocate(p, k, n + 1);
+			}
+			else {
+				new (b + n) T(std::forward<Args>(args)...);
+				++n;
+			}
+
+			return back();
+		}
+
+		void pop_back() noexcept {
+			b[--n].~T();
+		}
+
+		void resize(size_type k) {
+			resize_with(k, [](T* p){ new (p) T(); });
+		}
+
+		void resize(size_type k, const T& t) {
+			resize_with(k, [&t](T* p){ new (p) T(t); });
+		}
+
+		iterator insert(const_iterator pos, const T& t) {
+			return emplace(pos, t);
+		}
+
+		iterator insert(const_iterator pos, T&& t) {
+			return emplace(pos, std::move(t));
+		}
+
+		template<typename...Args>
+		iterator emplace(const_iterator pos, Args&&...args) {
+			auto i = pos - begin();
+			emplace_back(std::forward<Args>(args)...);
+			std::rotate(b + i, b + n - 1, b + n);
+			return b + i;
+		}
+
+		/// Insert `[first,last)` before `pos`, allocating at most once
+		template<
+				typename It,
+				typename = Requires<!std::is_integral<It>::value>
+		>
+		iterator insert(const_iterator pos, It first, It last) {
+			auto i = pos - begin();
+			auto m = n;
+
+			append(
+				first, last,
+				typename std::iterator_traits<It>::iterator_category()
+			);
+
+			std::rotate(b + i, b + m, b + n);
+			return b + i;
+		}
+
+		iterator insert(const_iterator pos, std::initializer_list<T> l) {
+			return insert(pos, l.begin(), l.end());
+		}
+
+		iterator erase(const_iterator pos) {
+			return erase(pos, pos + 1);
+		}
+
+		iterator erase(const_iterator first, const_iterator last) {
+			auto f = b + (first - begin());
+			auto l = b + (last - begin());
+
+			auto e = std::move(l, end(), f);
+			destroy(e, end());
+			n -= l - f;
+
+			return f;
+		}
+
+		void swap(small_vector& v)
+		noexcept(std::is_nothrow_move_constructible<T>::value) {
+			small_vector tmp(std::move(v));
+			v = std::move(*this);
+			*this = std::move(tmp);
+		}
+
+	private:
+		T* inline_data() noexcept {
+			return reinterpret_cast<T*>(&buffer);
+		}
+
+		const T* inline_data() const noexcept {
+			return reinterpret_cast<const T*>(&buffer);
+		}
+
+		static T* allocate(size_type k) {
+			FTL_COUNT_ALLOCATION(small_vector, k * sizeof(T));
+			return std::allocator<T>().allocate(k);
+		}
+
+		static void deallocate(T* p, size_type k) noexcept {
+			std::allocator<T>().deallocate(p, k);
+		}
+
+		static void destroy(T* first, T* last) noexcept {
+			for(; first != last; ++first)
+				first->~T();
+		}
+
+		// Capacity to grow to, to fit at least k elements
+		size_type grown(size_type k) const noexcept {
+			return std::max(k, 2 * cap);
+		}
+
+		// Free any heap storage, without touching elements
+		void release() noexcept {
+			if(!is_inline())
+				deallocate(b, cap);
+
+			b = inline_data();
+			cap = N;
+		}
+
+		/*
+		 * Move the first n elements to p, of capacity k, and own it from
+		 * then on, with size m. Moves that may throw are copies instead,
+		 * so that the elements stay put if one does.
+		 */
+		void relocate(T* p, size_type k, size_type m) {
+			size_type i = 0;
+			try {
+				for(; i < n; ++i)
+					new (p + i) T(std::move_if_noexcept(b[i]));
+			}
+			catch(...) {
+				destroy(p, p + i);
+				if(m > n)
+					destroy(p + n, p + m);
+
+				deallocate(p, k);
+				throw;
+			}
+
+			destroy(b, b + n);
+			release();
+
+			b = p;
+			cap = k;
+			n = m;
+		}
+
+		void reallocate(size_type k) {
+			relocate(allocate(k), k, n);
+		}
+
+		// Steal v's heap storage, or move its inline elements one by one
+		void take(small_vector& v) {
+			if(!v.is_inline()) {
+				b = v.b;
+				cap = v.cap;
+				n = v.n;
+
+				v.b = v.inline_data();
+				v.cap = N;
+				v.n = 0;
+			}
+			else {
+				for(; n < v.n; ++n)
+					new (b + n) T(std::move(v.b[n]));
+
+				v.clear();
+			}
+		}
+
+		template<typename It>
+		void append(It first, It last, std::input_iterator_tag) {
+			for(; first != last; ++first)
+				emplace_back(*first);
+		}
+
+		template<typename It>
+		void append(It first, It last, std::forward_iterator_tag) {
+			auto k = static_cast<size_type>(std::distance(first, last));
+			if(n + k > cap)
+				reallocate(grown(n + k));
+
+			for(; first != last; ++first) {
+				new (b + n) T(*first);
+				++n;
+			}
+		}
+
+		template<typename F>
+		void resize_with(size_type k, F init) {
+			if(k < n) {
+				destroy(b + k, b + n);
+				n = k;
+				return;
+			}
+
+			reserve(k);
+			for(; n < k; ++n)
+				init(b + n);
+		}
+
+		T* b;
+		size_type n = 0;
+		size_type cap = N;
+		typename std::aligned_storage<
+			sizeof(T) * (N ? N : 1), alignof(T)
+		>::type buffer;
+	};
+
+	template<typename T, std::size_t N>
+	constexpr std::size_t small_vector<T,N>::inline_capacity;
+
+	template<typename T, std::size_t N>
+	bool operator== (const small_vector<T,N>& a, const small_vector<T,N>& b) {
+		return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+	}
+
+	template<typename T, std::size_t N>
+	bool operator!= (const small_vector<T,N>& a, const small_vector<T,N>& b) {
+		return !(a == b);
+	}
+
+	template<typename T, std::size_t N>
+	bool operator< (const small_vector<T,N>& a, const small_vector<T,N>& b) {
+		return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+	}
+
+	template<typename T, std::size_t N>
+	void swap(small_vector<T,N>& a, small_vector<T,N>& b)
+	noexcept(noexcept(a.swap(b))) {
+		a.swap(b);
+	}
+
+	template<typename T, std::size_t N>
+	struct parametric_type_traits<small_vector<T,N>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = small_vector<U,N>;
+	};
+
+	namespace _dtl {
+		template<typename U, std::size_t N, typename C>
+		void append_moved(small_vector<U,N>& result, C& c) {
+			result.insert(
+					result.end(),
+					std::make_move_iterator(c.begin()),
+					std::make_move_iterator(c.end())
+			);
+		}
+
+		// The first result can simply become the output
+		template<typename U, std::size_t N>
+		void append_moved(small_vector<U,N>& result, small_vector<U,N>& c) {
+			if(result.empty()) {
+				result = std::move(c);
+			}
+			else {
+				result.insert(
+						result.end(),
+						std::make_move_iterator(c.begin()),
+						std::make_move_iterator(c.end())
+				);
+			}
+		}
+
+		// Gives the first result's heap buffer to the output, if it fits all
+		template<typename U, std::size_t N, typename Cs>
+		bool adopt_front(small_vector<U,N>&, Cs&, std::size_t) {
+			return false;
+		}
+
+		template<typename U, std::size_t N, std::size_t M>
+		bool adopt_front(
+				small_vector<U,N>& result,
+				small_vector<small_vector<U,N>,M>& nested,
+				std::size_t size
+		) {
+			auto& front = nested.front();
+			if(front.is_inline() || front.capacity() < size)
+				return false;
+
+			result = std::move(front);
+			return true;
+		}
+
+		/*
+		 * Concatenates nested, reserving the exact total size once. If that
+		 * fits inline, nothing is allocated.
+		 */
+		template<typename U, std::size_t N, typename Cs>
+		small_vector<U,N> flatten_small(Cs& nested) {
+			small_vector<U,N> result;
+			if(nested.empty())
+				return result;
+
+			std::size_t size = 0;
+			for(auto& c : nested) {
+				size += std::distance(c.begin(), c.end());
+			}
+
+			auto it = nested.begin();
+			if(adopt_front(result, nested, size))
+				++it;
+
+			result.reserve(size);
+			for(; it != nested.end(); ++it) {
+				append_moved(result, *it);
+			}
+
+			return result;
+		}
+	}
+
+	/**
+	 * Maps and concatenates in one step.
+	 *
+	 * The size of the result is reserved exactly, once all the results of
+	 * `f` are known, so if they fit in its inline capacity, nothing is
+	 * allocated. If `f` returns heap allocated small_vectors of the result
+	 * type, the first one's buffer may become the result's.
+	 *
+	 * \tparam F must satisfy \ref fn`<`\ref container`<B>(A)>`
+	 *
+	 * \ingroup small_vector
+	 */
+	template<
+			typename F,
+			typename T,
+			std::size_t N,
+			typename U = typename result_of<F(T)>::value_type
+	>
+	small_vector<U,N> concatMap(F f, const small_vector<T,N>& v) {
+		auto nested = f % v;
+		return _dtl::flatten_small<U,N>(nested);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup small_vector
+	 */
+	template<
+			typename F,
+			typename T,
+			std::size_t N,
+			typename U = typename result_of<F(T)>::value_type
+	>
+	small_vector<U,N> concatMap(F f, small_vector<T,N>&& v) {
+		auto nested = f % std::move(v);
+		return _dtl::flatten_small<U,N>(nested);
+	}
+
+	/**
+	 * Monoid instance for small_vectors, concatenating them.
+	 *
+	 * \ingroup small_vector
+	 */
+	template<typename T, std::size_t N>
+	struct monoid<small_vector<T,N>> {
+		static small_vector<T,N> id() noexcept {
+			return small_vector<T,N>();
+		}
+
+		static small_vector<T,N> append(
+				const small_vector<T,N>& v1,
+				const small_vector<T,N>& v2) {
+			small_vector<T,N> rv;
+			rv.reserve(v1.size() + v2.size());
+			rv.insert(rv.end(), v1.begin(), v1.end());
+			rv.insert(rv.end(), v2.begin(), v2.end());
+			return rv;
+		}
+
+		static small_vector<T,N> append(
+				small_vector<T,N>&& v1,
+				const small_vector<T,N>& v2) {
+			v1.insert(v1.end(), v2.begin(), v2.end());
+			return std::move(v1);
+		}
+
+		// Prepends in place only if v2 need not grow for it
+		static small_vector<T,N> append(
+				const small_vector<T,N>& v1,
+				small_vector<T,N>&& v2) {
+			if(v2.capacity() - v2.size() >= v1.size()) {
+				v2.insert(v2.begin(), v1.begin(), v1.end());
+				return std::move(v2);
+			}
+
+			small_vector<T,N> rv;
+			rv.reserve(v1.size() + v2.size());
+			rv.insert(rv.end(), v1.begin(), v1.end());
+			_dtl::append_moved(rv, v2);
+			return rv;
+		}
+
+		static small_vector<T,N> append(
+				small_vector<T,N>&& v1,
+				small_vector<T,N>&& v2) {
+			_dtl::append_moved(v1, v2);
+			return std::move(v1);
+		}
+
+		/**
+		 * Concatenates an entire sequence of small_vectors.
+		 *
+		 * The total size is computed first, and reserved at once.
+		 *
+		 * \tparam I must satisfy \ref fwditerable, with small_vectors as
+		 *           elements
+		 */
+		template<
+				typename I,
+				typename = Requires<ForwardIterable<I>()>
+		>
+		static small_vector<T,N> mconcat(const I& vs) {
+			std::size_t size = 0;
+			for(auto& v : vs) {
+				size += v.size();
+			}
+
+			small_vector<T,N> rv;
+			rv.reserve(size);
+			for(auto& v : vs) {
+				rv.insert(rv.end(), v.begin(), v.end());
+			}
+
+			return rv;
+		}
+
+		/// \overload
+		template<
+				typename I,
+				typename = Requires<
+					!std::is_lvalue_reference<I>::value
+					&& ForwardIterable<plain_type<I>>()
+				>
+		>
+		static small_vector<T,N> mconcat(I&& vs) {
+			return _dtl::flatten_small<T,N>(vs);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monad instance for small_vectors.
+	 *
+	 * Behaves like the one of std::vector, modelling non-deterministic
+	 * computations. Every result has the inline capacity of the input.
+	 *
+	 * \ingroup small_vector
+	 */
+	template<typename T, std::size_t N>
+	struct monad<small_vector<T,N>>
+	: deriving_join<in_terms_of_bind<small_vector<T,N>>> {
+
+		/// Alias to make type signatures cleaner
+		template<typename U>
+		using vector = small_vector<U,N>;
+
+		/// Creates a one element small_vector, which never allocates if N > 0
+		static vector<T> pure(const T& t) {
+			vector<T> v;
+			v.emplace_back(t);
+			return v;
+		}
+
+		/// \overload
+		static vector<T> pure(T&& t) {
+			vector<T> v;
+			v.emplace_back(std::move(t));
+			return v;
+		}
+
+		/// Applies `f` to each element, reserving the result's size once
+		template<typename F, typename U = result_of<F(T)>>
+		static vector<U> map(F&& f, const vector<T>& v) {
+			vector<U> result;
+			result.reserve(v.size());
+			for(auto& e : v) {
+				result.emplace_back(f(e));
+			}
+
+			return result;
+		}
+
+		/// \overload
+		template<
+				typename F, typename U = result_of<F(T)>,
+				typename = Requires<
+					!std::is_same<U,T>::value
+					|| (!std::is_copy_assignable<T>::value
+					&& !std::is_move_assignable<T>::value)
+				>
+		>
+		static vector<U> map(F&& f, vector<T>&& v) {
+			vector<U> result;
+			result.reserve(v.size());
+			for(auto& e : v) {
+				result.emplace_back(f(std::move(e)));
+			}
+
+			return result;
+		}
+
+		/// Maps in place, if `f` returns the type it is given
+		template<
+				typename F,
+				typename = Requires<
+					std::is_same<result_of<F(T)>,T>::value
+					&& (std::is_copy_assignable<T>::value
+					|| std::is_move_assignable<T>::value)
+				>
+		>
+		static vector<T> map(F&& f, vector<T>&& v) {
+			for(auto& e : v) {
+				e = f(std::move(e));
+			}
+
+			return std::move(v);
+		}
+
+		/// Applies every function to every element, in that order
+		template<
+				typename Vf,
+				typename Vf_ = plain_type<Vf>,
+				typename F = Value_type<Vf_>,
+				typename U = result_of<F(T)>
+		>
+		static vector<U> apply(Vf&& fs, const vector<T>& v) {
+			vector<U> result;
+			result.reserve(fs.size() * v.size());
+			for(auto& f : fs) {
+				for(auto& e : v) {
+					result.emplace_back(f(e));
+				}
+			}
+
+			return result;
+		}
+
+		/**
+		 * Applies `f` to each element and concatenates the results.
+		 *
+		 * Each result is appended as soon as it is returned. If `f` returns
+		 * small_vectors of the same inline capacity, which fit it, neither
+		 * they nor the first of them to become the output allocate.
+		 *
+		 * \note `f` may return any \ref fwditerable, not only small_vectors.
+		 */
+		template<
+				typename F,
+				typename Cu = result_of<F(T)>,
+				typename U = Value_type<Cu>
+		>
+		static vector<U> bind(const vector<T>& v, F&& f) {
+			static_assert(
+				ForwardIterable<Cu>(),
+				"F(T) does not return an instance of ForwardIterable"
+			);
+
+			vector<U> result;
+			for(auto& e : v) {
+				auto c = f(e);
+				_dtl::append_moved(result, c);
+			}
+
+			return result;
+		}
+
+		/// \overload
+		template<
+				typename F,
+				typename Cu = result_of<F(T)>,
+				typename U = Value_type<Cu>
+		>
+		static vector<U> bind(vector<T>&& v, F&& f) {
+			static_assert(
+				ForwardIterable<Cu>(),
+				"F(T) does not return an instance of ForwardIterable"
+			);
+
+			vector<U> result;
+			for(auto& e : v) {
+				auto c = f(std::move(e));
+				_dtl::append_moved(result, c);
+			}
+
+			return result;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Small vectors apply every function to every element, in order.
+	 *
+	 * \ingroup small_vector
+	 */
+	template<typename T, std::size_t N>
+	struct cartesian_apply<small_vector<T,N>> : std::true_type {};
+
+	/**
+	 * Foldable instance for small_vectors.
+	 *
+	 * Like that of std::vector, folds into `sum_monoid` or `prod_monoid` of
+	 * an arithmetic type go through a vectorisable loop over the elements.
+	 *
+	 * \ingroup small_vector
+	 */
+	template<typename T, std::size_t N>
+	struct foldable<small_vector<T,N>>
+	: deriving_foldl<small_vector<T,N>>, deriving_foldr<small_vector<T,N>>
+	, deriving_fold<small_vector<T,N>> {
+
+		template<typename Fn, typename M = result_of<Fn(T)>>
+		static M foldMap(Fn fn, const small_vector<T,N>& v) {
+			return foldMap_<M>(
+				fn, v,
+				std::integral_constant<
+					bool, _dtl::has_fold_kernel<T,M>::value
+				>{}
+			);
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		template<typename M, typename Fn>
+		static M foldMap_(Fn& fn, const small_vector<T,N>& v, std::false_type) {
+			return deriving_foldMap<small_vector<T,N>>::foldMap(fn, v);
+		}
+
+		template<typename M, typename Fn>
+		static M foldMap_(Fn& fn, const small_vector<T,N>& v, std::true_type) {
+			return _dtl::fold_kernel<M>::run(fn, v.data(), v.size());
+		}
+	};
+
+	/**
+	 * Zippable instance for small_vectors.
+	 *
+	 * May be zipped with any number of \ref fwditerable of other types.
+	 * Whenever all of them know their size, the result is reserved once.
+	 *
+	 * \ingroup small_vector
+	 */
+	template<typename T, std::size_t N>
+	struct zippable<small_vector<T,N>> {
+		template<
+				typename F, typename...Iterables,
+				typename U = result_of<F(T,Value_type<Iterables>...)>,
+				typename = Requires<
+					_dtl::forward_iterables<Iterables...>::value
+				>
+		>
+		static small_vector<U,N> zipWith(
+				F f, const small_vector<T,N>& v, const Iterables&...is) {
+
+			small_vector<U,N> result;
+			result.reserve(_dtl::zip_size_hint(v, is...));
+
+			_dtl::zip_each(
+				_dtl::push_back_sink<small_vector<U,N>>{result},
+				f, v, is...
+			);
+
+			return result;
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+#endif
+
@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_SOA_VECTOR_H
+#define FTL_SOA_VECTOR_H
+
+#include <tuple>
+#include <vector>
+#include <initializer_list>
+#include "vector.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup soa_vector Structure of Arrays
+	 *
+	 * A vector of tuples that stores each field in an array of its own.
+	 *
+	 * \code
+	 *   #include <ftl/soa_vector.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to
+	 * `ftl::soa_vector`:
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 * - \ref zippablepg
+	 *
+	 * \par Dependencies
+	 * - <tuple>
+	 * - <vector>
+	 * - <initializer_list>
+	 * - \ref vector
+	 */
+
+	template<typename T, typename...Ts>
+	class soa_vector;
+
+	namespace _dtl {
+		struct soa_access;
+
+		template<size_t I, typename U, typename S, typename...Ts>
+		struct soa_replace_impl;
+
+		template<size_t I, typename U, size_t...J, typename...Ts>
+		struct soa_replace_impl<I,U,seq<J...>,Ts...> {
+			using type = soa_vector<if_<I == J, U, Ts>...>;
+		};
+
+		// soa_vector<Ts...> with its I:th field type replaced by U
+		template<size_t I, typename U, typename...Ts>
+		using soa_replace = typename soa_replace_impl<
+			I, U, _dtl::index_seq<sizeof...(Ts)>, Ts...
+		>::type;
+	}
+
+	/**
+	 * A sequence of tuples, stored one field at a time.
+	 *
+	 * Where a `std::vector<std::tuple<T,Ts...>>` keeps each tuple in one
+	 * piece, a `soa_vector<T,Ts...>` keeps one `std::vector` per field. A
+	 * computation that only touches some of the fields then only touches
+	 * the memory of those, contiguously.
+	 *
+	 * Rows are read with `operator[]`, which gives a tuple of references
+	 * into the columns, while the columns themselves are available as
+	 * `const std::vector`s through `column`.
+	 *
+	 * As far as its concept instances are concerned, a `soa_vector` is a
+	 * sequence of its first field, with the others carried along. This is
+	 * the same choice as the instances of `std::tuple`, which act on its
+	 * first element. In particular, `begin` and `end` traverse the first
+	 * column only. To map some other field, use `mapColumn`, and to fold
+	 * one, fold its `column`.
+	 *
+	 * \par Concepts
+	 * - \ref fwditerable
+	 * - \ref eq, if all of `T,Ts...` are
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 * - \ref zippablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::soa_vector<int,std::string> v{
+	 *       std::make_tuple(1, "one"), std::make_tuple(2, "two")
+	 *   };
+	 *
+	 *   // Only ever reads the ints
+	 *   auto total = ftl::foldMap(ftl::sum<int>, v);
+	 *
+	 *   auto names = ftl::column<1>(v);
+	 * \endcode
+	 *
+	 * \ingroup soa_vector
+	 */
+	template<typename T, typename...Ts>
+	class soa_vector {
+	public:
+		/// A complete row, as stored in a plain vector of tuples
+		using row_type = std::tuple<T,Ts...>;
+
+		/// Read-only view of a row, referring into the columns
+		using reference = std::tuple<const T&, const Ts&...>;
+
+		/// Type of the first field, which the concept instances act on
+		using value_type = T;
+
+		using size_type = typename std::vector<T>::size_type;
+
+		/// Traverses the first column
+		using const_iterator = typename std::vector<T>::const_iterator;
+		using iterator = const_iterator;
+
+		/// Type of the `I`:th column
+		template<size_t I>
+		using column_type = std::vector<type_at<I,T,Ts...>>;
+
+		soa_vector() = default;
+		soa_vector(const soa_vector&) = default;
+		soa_vector(soa_vector&&) = default;
+		soa_vector& operator= (const soa_vector&) = default;
+		soa_vector& operator= (soa_vector&&) = default;
+
+		soa_vector(std::initializer_list<row_type> rows) {
+			reserve(rows.size());
+			for(auto& r : rows) {
+				push_back(r);
+			}
+		}
+
+		size_type size() const noexcept {
+			return std::get<0>(cols).size();
+		}
+
+		bool empty() const noexcept {
+			return std::get<0>(cols).empty();
+		}
+
+		void reserve(size_type n) {
+			each_column(reserver{n}, indices{});
+		}
+
+		void clear() noexcept {
+			each_column(clearer{}, indices{});
+		}
+
+		void push_back(const row_type& r) {
+			push_back_(r, indices{});
+		}
+
+		void push_back(row_type&& r) {
+			push_back_(std::move(r), indices{});
+		}
+
+		/// Append a row, given a value for each field
+		template<typename U, typename...Us>
+		void emplace_back(U&& u, Us&&...us) {
+			static_assert(
+				sizeof...(Us) == sizeof...(Ts),
+				"emplace_back requires exactly one value per field"
+			);
+			push_back_(
+				std::forward_as_tuple(std::forward<U>(u), std::forward<Us>(us)...),
+				indices{}
+			);
+		}
+
+		reference operator[] (size_type i) const {
+			return row_(i, indices{});
+		}
+
+		/// The `I`:th column, in the order of the template parameters
+		template<size_t I>
+		const column_type<I>& column() const noexcept {
+			return std::get<I>(cols);
+		}
+
+		const_iterator begin() const noexcept {
+			return std::get<0>(cols).begin();
+		}
+
+		const_iterator end() const noexcept {
+			return std::get<0>(cols).end();
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		bool operator== (const soa_vector& v) const {
+			return cols == v.cols;
+		}
+
+		bool operator!= (const soa_vector& v) const {
+			return cols != v.cols;
+		}
+
+	private:
+		friend struct _dtl::soa_access;
+
+		using columns = std::tuple<std::vector<T>, std::vector<Ts>...>;
+		using indices = _dtl::index_seq<sizeof...(Ts)+1>;
+
+		explicit soa_vector(columns cols) : cols(std::move(cols)) {}
+
+		struct reserver {
+			template<typename C>
+			void operator() (C& c) const {
+				c.reserve(n);
+			}
+
+			size_type n;
+		};
+
+		struct clearer {
+			template<typename C>
+			void operator() (C& c) const noexcept {
+				c.clear();
+			}
+		};
+
+		template<typename F, size_t...I>
+		void each_column(F f, seq<I...>) {
+			(void)std::initializer_list<int>{(f(std::get<I>(cols)), 0)...};
+		}
+
+		template<typename R, size_t...I>
+		void push_back_(R&& r, seq<I...>) {
+			(void)std::initializer_list<int>{
+				(std::get<I>(cols).push_back(std::get<I>(std::forward<R>(r))), 0)...
+			};
+		}
+
+		template<size_t...I>
+		reference row_(size_type i, seq<I...>) const {
+			return reference(std::get<I>(cols)[i]...);
+		}
+
+		columns cols;
+	};
+
+	namespace _dtl {
+		struct soa_access {
+			template<typename T, typename...Ts>
+			static const std::tuple<std::vector<T>,std::vector<Ts>...>&
+			columns(const soa_vector<T,Ts...>& v) noexcept {
+				return v.cols;
+			}
+
+			template<typename T, typename...Ts>
+			static std::tuple<std::vector<T>,std::vector<Ts>...>&&
+			columns(soa_vector<T,Ts...>&& v) noexcept {
+				return std::move(v.cols);
+			}
+
+			template<typename T, typename...Ts>
+			static soa_vector<T,Ts...> make(
+					std::tuple<std::vector<T>,std::vector<Ts>...>&& cols) {
+				return soa_vector<T,Ts...>(std::move(cols));
+			}
+
+			// The freshly mapped column, or one of the untouched ones
+			template<size_t J, typename Cs, typename V>
+			static V&& pick(Cs&&, V& mapped, std::true_type) noexcept {
+				return std::move(mapped);
+			}
+
+			template<size_t J, typename Cs, typename V>
+			static auto pick(Cs&& cs, V&, std::false_type) noexcept
+			-> decltype(std::get<J>(std::forward<Cs>(cs))) {
+				return std::get<J>(std::forward<Cs>(cs));
+			}
+
+			template<
+					size_t I, typename F, typename Cs,
+					typename...Ts, size_t...J,
+					typename U = result_of<F(type_at<I,Ts...>)>
+			>
+			static soa_replace<I,U,Ts...> map(
+					F& f, Cs&& cs, type_seq<Ts...>, seq<J...>) {
+				auto mapped = functor<std::vector<type_at<I,Ts...>>>::map(
+					f, std::get<I>(std::forward<Cs>(cs))
+				);
+
+				return make(std::make_tuple(
+					pick<J>(
+						std::forward<Cs>(cs), mapped,
+						std::integral_constant<bool, I == J>{}
+					)...
+				));
+			}
+
+			template<typename C>
+			static C prefix(const C& c, size_t n) {
+				return C(c.begin(), c.begin() + n);
+			}
+
+			// All but the first column cut to the length of the new first one
+			template<typename U, typename T, typename...Ts, size_t...J>
+			static soa_vector<U,Ts...> with_first(
+					std::vector<U>&& first, const soa_vector<T,Ts...>& v,
+					seq<J...>) {
+				const auto n = first.size();
+				return make(std::make_tuple(
+					std::move(first), prefix(std::get<J+1>(v.cols), n)...
+				));
+			}
+		};
+	}
+
+	/**
+	 * The `I`:th column of `v`.
+	 *
+	 * Shorthand for `v.template column<I>()`.
+	 *
+	 * \ingroup soa_vector
+	 */
+	template<size_t I, typename T, typename...Ts>
+	auto column(const soa_vector<T,Ts...>& v) noexcept
+	-> decltype(v.template column<I>()) {
+		return v.template column<I>();
+	}
+
+	/**
+	 * Map the `I`:th field of every row of `v` with `f`.
+	 *
+	 * All the other columns are copied as is---or moved, if `v` is an
+	 * rvalue. With `I == 0`, this is the same as `fmap`.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::soa_vector<int,std::string> v{...};
+	 *
+	 *   // soa_vector<int,size_t>
+	 *   auto w = ftl::mapColumn<1>(
+	 *       [](const std::string& s){ return s.size(); }, v
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup soa_vector
+	 */
+	template<
+			size_t I, typename F, typename T, typename...Ts,
+			typename U = result_of<F(type_at<I,T,Ts...>)>
+	>
+	_dtl::soa_replace<I,U,T,Ts...> mapColumn(
+			F&& f, const soa_vector<T,Ts...>& v) {
+		return _dtl::soa_access::map<I>(
+			f, _dtl::soa_access::columns(v),
+			type_seq<T,Ts...>{}, _dtl::index_seq<sizeof...(Ts)+1>{}
+		);
+	}
+
+	/// \overload
+	template<
+			size_t I, typename F, typename T, typename...Ts,
+			typename U = result_of<F(type_at<I,T,Ts...>)>
+	>
+	_dtl::soa_replace<I,U,T,Ts...> mapColumn(
+			F&& f, soa_vector<T,Ts...>&& v) {
+		return _dtl::soa_access::map<I>(
+			f, _dtl::soa_access::columns(std::move(v)),
+			type_seq<T,Ts...>{}, _dtl::index_seq<sizeof...(Ts)+1>{}
+		);
+	}
+
+	/**
+	 * Functor instance for soa_vector.
+	 *
+	 * Maps the first field, like the instance of `std::tuple`.
+	 *
+	 * \ingroup soa_vector
+	 */
+	template<typename T, typename...Ts>
+	struct functor<soa_vector<T,Ts...>> {
+		template<typename F, typename U = result_of<F(T)>>
+		static soa_vector<U,Ts...> map(F&& f, const soa_vector<T,Ts...>& v) {
+			return mapColumn<0>(std::forward<F>(f), v);
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static soa_vector<U,Ts...> map(F&& f, soa_vector<T,Ts...>&& v) {
+			return mapColumn<0>(std::forward<F>(f), std::move(v));
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for soa_vector.
+	 *
+	 * Folds the first column, which is a plain `std::vector`, so the folds
+	 * of that instance apply. In particular, `foldMap` into the sum and
+	 * product monoids runs over contiguous memory.
+	 *
+	 * \ingroup soa_vector
+	 */
+	template<typename T, typename...Ts>
+	struct foldable<soa_vector<T,Ts...>> {
+		using column = std::vector<T>;
+
+		template<typename Fn, typename U>
+		static U foldl(Fn&& fn, U z, const soa_vector<T,Ts...>& v) {
+			return foldable<column>::foldl(
+				std::forward<Fn>(fn), std::move(z), v.template column<0>()
+			);
+		}
+
+		template<typename Fn, typename U>
+		static U foldr(Fn&& fn, U z, const soa_vector<T,Ts...>& v) {
+			return foldable<column>::foldr(
+				std::forward<Fn>(fn), std::move(z), v.template column<0>()
+			);
+		}
+
+		template<typename Fn, typename M = result_of<Fn(T)>>
+		static M foldMap(Fn&& fn, const soa_vector<T,Ts...>& v) {
+			return foldable<column>::foldMap(
+				std::forward<Fn>(fn), v.template column<0>()
+			);
+		}
+
+		template<typename M = T>
+		static M fold(const soa_vector<T,Ts...>& v) {
+			return foldable<column>::template fold<M>(v.template column<0>());
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Zippable instance for soa_vector.
+	 *
+	 * Zips the first column with any number of \ref fwditerable "iterables",
+	 * presizing the result as `std::vector` does. The remaining columns are
+	 * carried over, up to the length of the zip.
+	 *
+	 * \ingroup soa_vector
+	 */
+	template<typename T, typename...Ts>
+	struct zippable<soa_vector<T,Ts...>> {
+		template<
+				typename F, typename...Iterables,
+				typename U = result_of<F(T,Value_type<Iterables>...)>,
+				typename = Requires<
+					_dtl::forward_iterables<Iterables...>::value
+				>
+		>
+		static soa_vector<U,Ts...> zipWith(
+				F f, const soa_vector<T,Ts...>& v, const Iterables&...is) {
+			return _dtl::soa_access::with_first(
+				zippable<std::vector<T>>::zipWith(
+					f, v.template column<0>(), is...
+				),
+				v, _dtl::index_seq<sizeof...(Ts)>{}
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+}
+
+#endif
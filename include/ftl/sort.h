@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_SORT_H
+#define FTL_SORT_H
+
+#include <array>
+#include <limits>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include "ord.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup sort Sort
+	 *
+	 * Sorting by a key function, computing every key only once.
+	 *
+	 * \code
+	 *   #include <ftl/sort.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - <array>
+	 * - <limits>
+	 * - <string>
+	 * - <vector>
+	 * - <iterator>
+	 * - <algorithm>
+	 * - \ref ord
+	 */
+
+	namespace _dtl {
+		// Below this many elements, sorting by comparison is faster
+		constexpr std::size_t radix_threshold = 64;
+
+		// Maps integers to unsigned ones of the same order
+		template<typename K>
+		typename std::make_unsigned<K>::type radix_bits(K k) noexcept {
+			using U = typename std::make_unsigned<K>::type;
+			return std::is_signed<K>::value
+				? U(U(k) ^ (U(1) << (std::numeric_limits<U>::digits - 1)))
+				: U(k);
+		}
+
+		// Least significant digit first, skipping digits that are all equal
+		template<typename K>
+		std::vector<std::size_t> sorted_order(
+				const std::vector<K>& keys, std::true_type) {
+			using U = typename std::make_unsigned<K>::type;
+			struct entry {
+				U k;
+				std::size_t i;
+			};
+
+			const auto n = keys.size();
+			std::vector<entry> es(n), tmp(n);
+			std::vector<std::array<std::size_t,256>> counts(sizeof(U));
+			for(auto& c : counts) {
+				c.fill(0);
+			}
+
+			for(std::size_t i = 0; i < n; ++i) {
+				es[i] = entry{radix_bits(keys[i]), i};
+				for(std::size_t d = 0; d < sizeof(U); ++d) {
+					++counts[d][(es[i].k >> (8 * d)) & 255];
+				}
+			}
+
+			for(std::size_t d = 0; d < sizeof(U); ++d) {
+				auto& c = counts[d];
+				if(c[(es[0].k >> (8 * d)) & 255] == n)
+					continue;
+
+				std::size_t offset = 0;
+				for(auto& x : c) {
+					auto count = x;
+					x = offset;
+					offset += count;
+				}
+
+				for(auto& e : es) {
+					tmp[c[(e.k >> (8 * d)) & 255]++] = e;
+				}
+
+				es.swap(tmp);
+			}
+
+			std::vector<std::size_t> order;
+			order.reserve(n);
+			for(auto& e : es) {
+				order.push_back(e.i);
+			}
+
+			return order;
+		}
+
+		// Compares the suffixes of a and b, from character d on
+		inline bool suffix_less(
+				const std::string& a, const std::string& b, std::size_t d) {
+			return a.compare(d, std::string::npos, b, d, std::string::npos) < 0;
+		}
+
+		/*
+		 * Most significant digit first, with the end of a string sorting
+		 * below any character. Buckets that are small, or that are nested
+		 * too deep, are left to a comparison sort.
+		 */
+		inline void msd_sort(
+				const std::vector<std::string>& keys,
+				std::size_t* first, std::size_t* last,
+				std::size_t* tmp, std::size_t d, unsigned depth) {
+			const std::size_t n = last - first;
+			if(n < radix_threshold || depth > 64) {
+				std::stable_sort(first, last,
+					[&keys,d](std::size_t a, std::size_t b) {
+						return suffix_less(keys[a], keys[b], d);
+					}
+				);
+
+				return;
+			}
+
+			std::array<std::size_t,258> c;
+			c.fill(0);
+
+			auto bucket = [&keys,d](std::size_t i) -> std::size_t {
+				auto& k = keys[i];
+				return k.size() > d
+					? std::size_t(static_cast<unsigned char>(k[d])) + 1
+					: 0;
+			};
+
+			for(auto p = first; p != last; ++p) {
+				++c[bucket(*p) + 1];
+			}
+
+			for(std::size_t b = 1; b < c.size(); ++b) {
+				c[b] += c[b - 1];
+			}
+
+			auto pos = c;
+			for(auto p = first; p != last; ++p) {
+				tmp[pos[bucket(*p)]++] = *p;
+			}
+
+			std::copy(tmp, tmp + n, first);
+
+			// Bucket 0 holds the strings that end at d, and are all equal
+			for(std::size_t b = 1; b < 257; ++b) {
+				if(c[b + 1] - c[b] > 1) {
+					msd_sort(
+						keys, first + c[b], first + c[b + 1],
+						tmp, d + 1, depth + 1
+					);
+				}
+			}
+		}
+
+		inline std::vector<std::size_t> sorted_order(
+				const std::vector<std::string>& keys, std::false_type) {
+			std::vector<std::size_t> order(keys.size()), tmp(keys.size());
+			for(std::size_t i = 0; i < order.size(); ++i) {
+				order[i] = i;
+			}
+
+			msd_sort(keys, order.data(), order.data() + order.size(),
+				tmp.data(), 0, 0);
+
+			return order;
+		}
+
+		template<typename K>
+		std::vector<std::size_t> sorted_order(
+				const std::vector<K>& keys, std::false_type) {
+			std::vector<std::size_t> order(keys.size());
+			for(std::size_t i = 0; i < order.size(); ++i) {
+				order[i] = i;
+			}
+
+			std::stable_sort(order.begin(), order.end(),
+				[&keys](std::size_t a, std::size_t b) {
+					return keys[a] < keys[b];
+				}
+			);
+
+			return order;
+		}
+
+		template<typename K>
+		std::vector<std::size_t> sorted_order(const std::vector<K>& keys) {
+			using radix = std::integral_constant<
+				bool,
+				std::is_integral<K>::value && !std::is_same<K,bool>::value
+			>;
+
+			if(keys.size() < radix_threshold)
+				return sorted_order(keys, std::false_type{});
+
+			return sorted_order(keys, radix{});
+		}
+
+		template<typename It, typename F>
+		void sort_on(It first, It last, F& f, std::random_access_iterator_tag) {
+			using T = typename std::iterator_traits<It>::value_type;
+			using K = plain_type<result_of<F(const T&)>>;
+
+			const auto n = static_cast<std::size_t>(std::distance(first, last));
+			if(n < 2)
+				return;
+
+			std::vector<K> keys;
+			keys.reserve(n);
+			for(auto it = first; it != last; ++it) {
+				keys.push_back(f(*it));
+			}
+
+			auto order = sorted_order(keys);
+
+			std::vector<T> sorted;
+			sorted.reserve(n);
+			for(auto i : order) {
+				sorted.push_back(std::move(first[i]));
+			}
+
+			std::move(sorted.begin(), sorted.end(), first);
+		}
+
+		template<typename It, typename F>
+		void sort_on(It first, It last, F& f, std::forward_iterator_tag) {
+			using T = typename std::iterator_traits<It>::value_type;
+
+			std::vector<T> v(
+				std::make_move_iterator(first), std::make_move_iterator(last)
+			);
+
+			sort_on(v.begin(), v.end(), f, std::random_access_iterator_tag{});
+			std::move(v.begin(), v.end(), first);
+		}
+	}
+
+	/**
+	 * Sorts `[first, last)` in ascending order of the keys given by `f`.
+	 *
+	 * Gives the same order as
+	 * \code
+	 *   std::stable_sort(first, last, ftl::asc(ftl::comparing(f)));
+	 * \endcode
+	 * but `f` is called exactly once per element (the "Schwartzian
+	 * transform"), rather than twice per comparison. Integral keys are then
+	 * sorted by an LSD radix sort and `std::string` keys by an MSD radix
+	 * sort. Any other key is compared with `operator<`.
+	 *
+	 * The price is `O(n)` extra memory, for the keys and for moving the
+	 * elements into their place.
+	 *
+	 * \tparam It must be a forward iterator, to elements that are
+	 *            \ref movecons and \ref moveassignable.
+	 * \tparam F must satisfy \ref fn`<K(const T&)>`, where `K` is
+	 *           \ref orderablepg.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<std::string> v{"ccc", "a", "bb"};
+	 *   ftl::sortOn(v.begin(), v.end(), [](const std::string& s){
+	 *       return s.size();
+	 *   });
+	 *
+	 *   // v == {"a", "bb", "ccc"}
+	 * \endcode
+	 *
+	 * \ingroup sort
+	 */
+	template<typename It, typename F>
+	void sortOn(It first, It last, F&& f) {
+		_dtl::sort_on(
+			first, last, f,
+			typename std::iterator_traits<It>::iterator_category{}
+		);
+	}
+
+	/**
+	 * Gives `c` sorted in ascending order of the keys given by `f`.
+	 *
+	 * Equivalent of Haskell's `sortOn`. Pass `c` as an rvalue to sort it
+	 * without copying.
+	 *
+	 * \see sortOn(It,It,F&&)
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto v = ftl::sortOn(
+	 *       [](const person& p){ return p.age; },
+	 *       std::move(people)
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup sort
+	 */
+	template<
+			typename F,
+			typename C,
+			typename = Requires<ForwardIterable<C>()>
+	>
+	C sortOn(F&& f, C c) {
+		sortOn(c.begin(), c.end(), std::forward<F>(f));
+		return c;
+	}
+
+}
+
+#endif
@@ -0,0 +1,599 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_STREAM_H
+#define FTL_STREAM_H
+
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "lazy.h"
+#include "maybe.h"
+#include "instrument.h"
+#include "concepts/foldable.h"
+#include "concepts/monad.h"
+#include "concepts/zippable.h"
+
+namespace ftl {
+
+	/**
+	 * \defgroup stream Stream
+	 *
+	 * Lazy, possibly infinite, lists and their concept instances.
+	 *
+	 * \code
+	 *   #include <ftl/stream.h>
+	 * \endcode
+	 *
+	 * This module adds the following concept instances to `ftl::stream`:
+	 * - \ref monoidpg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref foldablepg
+	 * - \ref zippablepg
+	 *
+	 * \par Dependencies
+	 * - <iterator>
+	 * - <memory>
+	 * - <tuple>
+	 * - <vector>
+	 * - \ref lazy
+	 * - \ref maybe
+	 * - \ref foldable
+	 * - \ref monad
+	 * - \ref zippable
+	 */
+
+	template<typename T>
+	class stream;
+
+	namespace _dtl {
+		template<typename T>
+		struct stream_node {
+			stream_node(T head, lazy<stream<T>> tail)
+			: head(std::move(head)), tail(std::move(tail)) {}
+
+			T head;
+			lazy<stream<T>> tail;
+		};
+
+		template<typename T>
+		lazy<stream<T>> ready_stream(stream<T> s) {
+			return monad<lazy<stream<T>>>::pure(std::move(s));
+		}
+	}
+
+	/**
+	 * A list whose tail is not computed until it is needed.
+	 *
+	 * A stream is either empty, or a head element followed by a
+	 * `lazy<stream<T>>`. Tails are computed at most once, when first
+	 * reached, and are then shared by every copy of the stream, which makes
+	 * copying a stream as cheap as copying a `shared_ptr`. As nothing is
+	 * computed before it is asked for, streams may be infinite, as long as
+	 * only a finite prefix of them is ever traversed.
+	 *
+	 * The operations in this module that yield streams, like `fmap`,
+	 * `filter` or `take`, are themselves lazy, allocating one cell per
+	 * element as the result is traversed. Where only a strict result is
+	 * wanted, the cells of the intermediate stages can be avoided entirely
+	 * by working on an ftl::view of the stream instead, the stages of which
+	 * run as a single loop over the stream:
+	 * \code
+	 *   auto s = ftl::iterate([](int x){ return x+1; }, 0);
+	 *
+	 *   // One pass over the first 20 naturals, no intermediate streams
+	 *   auto v = ftl::collect<std::vector>(ftl::take(5, ftl::filter(
+	 *       [](int x){ return x % 4 == 0; },
+	 *       [](int x){ return x*x; } % ftl::as_view(s)
+	 *   )));
+	 * \endcode
+	 *
+	 * Iterators refer into the cells of the stream, which must hence outlive
+	 * them. Incrementing an iterator forces the tail it moves to.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref movecons
+	 * - \ref fwditerable
+	 * - \ref monoidpg
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 * - \ref foldablepg
+	 * - \ref zippablepg
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	class stream {
+		using node_type = _dtl::stream_node<T>;
+
+	public:
+		using value_type = T;
+
+		class iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const T*;
+			using reference = const T&;
+
+			iterator() = default;
+			explicit iterator(const node_type* n) noexcept : n(n) {}
+
+			reference operator* () const noexcept {
+				return n->head;
+			}
+
+			pointer operator-> () const noexcept {
+				return std::addressof(n->head);
+			}
+
+			iterator& operator++ () {
+				n = (*n->tail).node.get();
+				return *this;
+			}
+
+			iterator operator++ (int) {
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			bool operator== (const iterator& i) const noexcept {
+				return n == i.n;
+			}
+
+			bool operator!= (const iterator& i) const noexcept {
+				return n != i.n;
+			}
+
+		private:
+			const node_type* n = nullptr;
+		};
+
+		using const_iterator = iterator;
+
+		/// The empty stream
+		stream() noexcept = default;
+
+		/// A stream of `head` followed by whatever `tail` computes
+		stream(T head, lazy<stream> tail)
+		: node(std::make_shared<const node_type>(
+			std::move(head), std::move(tail)
+		)) {
+			FTL_COUNT_ALLOCATION(lazy, sizeof(node_type));
+		}
+
+		/// A stream of `head` followed by the already known `tail`
+		stream(T head, stream tail)
+		: stream(std::move(head), _dtl::ready_stream(std::move(tail))) {}
+
+		stream(const stream&) = default;
+		stream(stream&&) = default;
+
+		/*
+		 * Releases whatever cells only this stream refers to one at a time,
+		 * rather than recursively, so that dropping a long stream does not
+		 * exhaust the call stack.
+		 */
+		~stream() {
+			while(node && node.use_count() == 1
+					&& node->tail.status() == value_status::ready) {
+				auto next = (*node->tail).node;
+				node = std::move(next);
+			}
+		}
+
+		stream& operator= (stream s) noexcept {
+			std::swap(node, s.node);
+			return *this;
+		}
+
+		bool empty() const noexcept {
+			return !node;
+		}
+
+		/// The first element. The stream must not be empty.
+		const T& head() const noexcept {
+			return node->head;
+		}
+
+		/// Everything but the first element, forcing it if need be
+		const stream& tail() const {
+			return *node->tail;
+		}
+
+		/// The tail, without forcing it
+		const lazy<stream>& deferred_tail() const noexcept {
+			return node->tail;
+		}
+
+		iterator begin() const noexcept {
+			return iterator(node.get());
+		}
+
+		iterator end() const noexcept {
+			return iterator();
+		}
+
+		iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		iterator cend() const noexcept {
+			return end();
+		}
+
+	private:
+		std::shared_ptr<const node_type> node;
+	};
+
+	/**
+	 * Equality comparison of streams.
+	 *
+	 * Forces both streams up to their first difference, and hence does not
+	 * terminate for two equal infinite streams.
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	bool operator== (const stream<T>& s1, const stream<T>& s2) {
+		auto i1 = s1.begin(), i2 = s2.begin();
+		for(; i1 != s1.end() && i2 != s2.end(); ++i1, ++i2) {
+			if(!(*i1 == *i2))
+				return false;
+		}
+
+		return i1 == s1.end() && i2 == s2.end();
+	}
+
+	template<typename T>
+	bool operator!= (const stream<T>& s1, const stream<T>& s2) {
+		return !(s1 == s2);
+	}
+
+	/**
+	 * Prepend `x` to a deferred stream.
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	stream<T> cons(T x, lazy<stream<T>> xs) {
+		return stream<T>(std::move(x), std::move(xs));
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	stream<T> cons(T x, stream<T> xs) {
+		return stream<T>(std::move(x), std::move(xs));
+	}
+
+	/**
+	 * The infinite stream `x, f(x), f(f(x)), ...`
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto naturals = ftl::iterate([](int x){ return x+1; }, 0);
+	 * \endcode
+	 *
+	 * \ingroup stream
+	 */
+	template<typename F, typename T>
+	stream<T> iterate(F f, T x) {
+		return stream<T>(x, lazy<stream<T>>([f,x]() {
+			return iterate(f, f(x));
+		}));
+	}
+
+	/**
+	 * Build a stream from a seed.
+	 *
+	 * `f` is called with the seed to get either `nothing`, which ends the
+	 * stream, or the next element together with the next seed.
+	 *
+	 * \tparam F must be callable as `maybe<std::tuple<T,S>>(S)`
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   // 10, 9, ..., 1
+	 *   auto s = ftl::unfold<int>([](int n) {
+	 *       return n > 0
+	 *           ? ftl::just(std::make_tuple(n, n-1))
+	 *           : ftl::nothing<std::tuple<int,int>>();
+	 *   }, 10);
+	 * \endcode
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T, typename F, typename S>
+	stream<T> unfold(F f, S seed) {
+		auto m = f(std::move(seed));
+		if(!m.template is<std::tuple<T,S>>())
+			return stream<T>();
+
+		auto& t = get<std::tuple<T,S>>(m);
+		auto next = std::get<1>(t);
+		return stream<T>(std::get<0>(t), lazy<stream<T>>([f,next]() {
+			return unfold<T>(f, next);
+		}));
+	}
+
+	/**
+	 * At most the first `n` elements of `s`.
+	 *
+	 * Lazy, and never forces anything past the `n`:th element.
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	stream<T> take(std::size_t n, stream<T> s) {
+		if(n == 0 || s.empty())
+			return stream<T>();
+
+		if(n == 1)
+			return stream<T>(s.head(), stream<T>());
+
+		return stream<T>(s.head(), lazy<stream<T>>([n,s]() {
+			return take(n-1, s.tail());
+		}));
+	}
+
+	/**
+	 * The elements of `s` up until the first not satisfying `p`.
+	 *
+	 * \ingroup stream
+	 */
+	template<typename P, typename T>
+	stream<T> takeWhile(P p, stream<T> s) {
+		if(s.empty() || !p(s.head()))
+			return stream<T>();
+
+		return stream<T>(s.head(), lazy<stream<T>>([p,s]() {
+			return takeWhile(p, s.tail());
+		}));
+	}
+
+	/**
+	 * All but the first `n` elements of `s`.
+	 *
+	 * Forces the first `n` tails straight away.
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	stream<T> drop(std::size_t n, stream<T> s) {
+		for(; n > 0 && !s.empty(); --n)
+			s = s.tail();
+
+		return s;
+	}
+
+	/**
+	 * The elements of `s` that satisfy `p`.
+	 *
+	 * Forces `s` up to its first element satisfying `p`, and the rest as
+	 * the result is traversed.
+	 *
+	 * \ingroup stream
+	 */
+	template<typename P, typename T>
+	stream<T> filter(P p, stream<T> s) {
+		while(!s.empty() && !p(s.head()))
+			s = s.tail();
+
+		if(s.empty())
+			return s;
+
+		return stream<T>(s.head(), lazy<stream<T>>([p,s]() {
+			return filter(p, s.tail());
+		}));
+	}
+
+	namespace _dtl {
+		// s1 followed by the stream s2 computes, forcing s2 only once needed
+		template<typename T>
+		stream<T> stream_append(stream<T> s1, lazy<stream<T>> s2) {
+			if(s1.empty())
+				return *s2;
+
+			return stream<T>(s1.head(), lazy<stream<T>>([s1,s2]() {
+				return stream_append(s1.tail(), s2);
+			}));
+		}
+	}
+
+	/**
+	 * Monoid instance for streams.
+	 *
+	 * The identity is the empty stream, and append is lazy concatenation:
+	 * no element of `s2` is computed before all of `s1` has been traversed.
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	struct monoid<stream<T>> {
+		static stream<T> id() noexcept {
+			return stream<T>();
+		}
+
+		static stream<T> append(stream<T> s1, stream<T> s2) {
+			if(s2.empty())
+				return s1;
+
+			return _dtl::stream_append(
+				std::move(s1), _dtl::ready_stream(std::move(s2))
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Monad instance for streams.
+	 *
+	 * Works like that of lists, except lazily: mapping or binding a stream
+	 * computes nothing until the result is traversed, so infinite streams
+	 * can be mapped and bound just as well as finite ones.
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	struct monad<stream<T>>
+	: deriving_join<in_terms_of_bind<stream<T>>>
+	, deriving_apply<in_terms_of_bind<stream<T>>> {
+
+		/// A stream of one element
+		static stream<T> pure(T x) {
+			return stream<T>(std::move(x), stream<T>());
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static stream<U> map(F f, stream<T> s) {
+			if(s.empty())
+				return stream<U>();
+
+			return stream<U>(f(s.head()), lazy<stream<U>>([f,s]() {
+				return map(f, s.tail());
+			}));
+		}
+
+		/**
+		 * Concatenate the streams `f` maps `s` to.
+		 *
+		 * Note that if `f` returns empty streams for all remaining elements
+		 * of an infinite `s`, traversing the result does not terminate.
+		 */
+		template<
+				typename F,
+				typename U = Value_type<result_of<F(T)>>
+		>
+		static stream<U> bind(stream<T> s, F f) {
+			if(s.empty())
+				return stream<U>();
+
+			return _dtl::stream_append(
+				f(s.head()),
+				lazy<stream<U>>([s,f]() { return bind(s.tail(), f); })
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for streams.
+	 *
+	 * Left folds traverse the stream from the front, and so only terminate
+	 * for finite streams. The same goes for right folds, which buffer the
+	 * elements before folding them from the back.
+	 *
+	 * `foldMap` into a monoid with an absorbing element, such as `any` or
+	 * `all`, stops as soon as the result is absorbed. It can hence answer
+	 * questions about infinite streams, provided the answer is eventually
+	 * found.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto s = ftl::iterate([](int x){ return x*2; }, 1);
+	 *
+	 *   // true, after looking at 11 elements
+	 *   bool big = ftl::foldMap([](int x){ return ftl::any(x > 1000); }, s);
+	 * \endcode
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	struct foldable<stream<T>>
+	: deriving_foldl<stream<T>>, deriving_foldMap<stream<T>>
+	, deriving_fold<stream<T>> {
+		template<typename Fn, typename U>
+		static U foldr(Fn&& fn, U z, const stream<T>& s) {
+			std::vector<const T*> buf;
+			for(auto& x : s) {
+				buf.push_back(std::addressof(x));
+			}
+
+			for(auto it = buf.rbegin(); it != buf.rend(); ++it) {
+				z = fn(**it, std::move(z));
+			}
+
+			return z;
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Zippable instance for streams.
+	 *
+	 * Zipping is lazy, and stops with the shortest argument, so a finite
+	 * stream may be zipped with an infinite one.
+	 *
+	 * \ingroup stream
+	 */
+	template<typename T>
+	struct zippable<stream<T>> {
+		template<
+				typename F, typename...Us,
+				typename V = result_of<F(T,Us...)>
+		>
+		static stream<V> zipWith(
+				F f, const stream<T>& s, const stream<Us>&...ss) {
+			if(s.empty() || any_empty(ss...))
+				return stream<V>();
+
+			return stream<V>(
+				f(s.head(), ss.head()...),
+				lazy<stream<V>>([f,s,ss...]() {
+					return zipWith(f, s.tail(), ss.tail()...);
+				})
+			);
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		static constexpr bool any_empty() noexcept {
+			return false;
+		}
+
+		template<typename U, typename...Us>
+		static bool any_empty(const stream<U>& s, const stream<Us>&...ss) {
+			return s.empty() || any_empty(ss...);
+		}
+	};
+}
+
+#endif
+
@@ -24,6 +24,7 @@
 #define FTL_STRING_H
 
 #include <string>
+#include <deque>
 #include "concepts/monoid.h"
 
 namespace ftl {
@@ -35,6 +36,7 @@ namespace ftl {
 	 *
 	 * \par Dependencies
 	 * - <string>
+	 * - <deque>
 	 * - \ref monoid
 	 */
 
@@ -94,11 +96,247 @@ namespace ftl {
 			return std::move(s1);
 		}
 
+		/**
+		 * Concatenates an entire sequence of strings.
+		 *
+		 * The total length is computed first, so the characters are copied
+		 * straight into a single, exactly sized buffer.
+		 *
+		 * \tparam I must satisfy \ref fwditerable, with strings as elements
+		 */
+		template<
+				typename I,
+				typename = Requires<ForwardIterable<I>()>
+		>
+		static std::basic_string<Ts...> mconcat(const I& ss) {
+			typename std::basic_string<Ts...>::size_type size = 0;
+			for(auto& s : ss) {
+				size += s.size();
+			}
+
+			std::basic_string<Ts...> rs;
+			rs.reserve(size);
+			for(auto& s : ss) {
+				rs += s;
+			}
+
+			return rs;
+		}
+
 		static constexpr bool instance = true;
 
 	};
 
+	/**
+	 * Accumulates string fragments, to be joined in a single allocation.
+	 *
+	 * Appending to a builder, at either end, only moves fragments around, so
+	 * folding any number of strings into one costs no more than the final
+	 * copy of their characters. This makes builders a better choice than
+	 * plain strings as the monoid of `foldMap` and friends, when the number
+	 * of fragments is large.
+	 *
+	 * Fragments given as lvalues are copied into the builder, while rvalues
+	 * are moved.
+	 *
+	 * \par Concepts
+	 * - \ref monoidpg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::list<std::string> words{"a", "few", "words"};
+	 *
+	 *   auto line = ftl::foldMap(
+	 *       [](const std::string& w){ return ftl::string_builder(w + " "); },
+	 *       words
+	 *   ).str();
+	 *   // line == "a few words "
+	 * \endcode
+	 *
+	 * \ingroup string
+	 */
+	template<
+			typename Ch,
+			typename Tr = std::char_traits<Ch>,
+			typename A = std::allocator<Ch>
+	>
+	class basic_string_builder {
+	public:
+		/// The type of string built
+		using string_type = std::basic_string<Ch,Tr,A>;
+
+		using size_type = typename string_type::size_type;
+
+		/// Constructs an empty builder
+		basic_string_builder() = default;
+
+		/// Constructs a builder holding a single fragment
+		basic_string_builder(const string_type& s) : fragments{s}, len(s.size()) {}
+
+		/// \overload
+		basic_string_builder(string_type&& s) : len(s.size()) {
+			fragments.push_back(std::move(s));
+		}
+
+		/// \overload
+		basic_string_builder(const Ch* s) : basic_string_builder(string_type(s)) {}
+
+		/// Append `s` as a new fragment
+		basic_string_builder& operator+= (string_type s) {
+			len += s.size();
+			fragments.push_back(std::move(s));
+			return *this;
+		}
+
+		/// \overload
+		basic_string_builder& operator+= (const Ch* s) {
+			return *this += string_type(s);
+		}
+
+		/// Append all the fragments of another builder
+		basic_string_builder& operator+= (const basic_string_builder& b) {
+			fragments.insert(fragments.end(), b.fragments.begin(), b.fragments.end());
+			len += b.len;
+			return *this;
+		}
+
+		/**
+		 * \overload
+		 *
+		 * The fragments of the smaller of the two builders are moved into the
+		 * larger one, keeping the cost of a sequence of appends low.
+		 */
+		basic_string_builder& operator+= (basic_string_builder&& b) {
+			if(fragments.size() < b.fragments.size()) {
+				for(auto it = fragments.rbegin(); it != fragments.rend(); ++it) {
+					b.fragments.push_front(std::move(*it));
+				}
+
+				fragments = std::move(b.fragments);
+			}
+			else {
+				for(auto& f : b.fragments) {
+					fragments.push_back(std::move(f));
+				}
+			}
+
+			len += b.len;
+			return *this;
+		}
+
+		/// Prepend all the fragments of another builder
+		basic_string_builder& prepend(const basic_string_builder& b) {
+			fragments.insert(fragments.begin(), b.fragments.begin(), b.fragments.end());
+			len += b.len;
+			return *this;
+		}
+
+		/// Total length of the string being built
+		size_type size() const noexcept {
+			return len;
+		}
+
+		/// Check whether the built string would be empty
+		bool empty() const noexcept {
+			return len == 0;
+		}
+
+		/**
+		 * Join all the fragments.
+		 *
+		 * The resulting string is allocated once, with exactly the required
+		 * capacity.
+		 */
+		string_type str() const & {
+			string_type s;
+			s.reserve(len);
+			for(auto& f : fragments) {
+				s += f;
+			}
+
+			return s;
+		}
+
+		/**
+		 * \overload
+		 *
+		 * A builder consisting of only one fragment simply gives it away.
+		 */
+		string_type str() && {
+			if(fragments.size() == 1)
+				return std::move(fragments.front());
+
+			return static_cast<const basic_string_builder&>(*this).str();
+		}
+
+		/// Equivalent of `str()`
+		explicit operator string_type() const {
+			return str();
+		}
+
+	private:
+		std::deque<string_type> fragments;
+		size_type len = 0;
+	};
+
+	/**
+	 * Builder of `std::string`s.
+	 *
+	 * \ingroup string
+	 */
+	using string_builder = basic_string_builder<char>;
+
+	/**
+	 * Builder of `std::wstring`s.
+	 *
+	 * \ingroup string
+	 */
+	using wstring_builder = basic_string_builder<wchar_t>;
+
+	/**
+	 * Monoid instance for string builders.
+	 *
+	 * Behaviour:
+	 * \code
+	 *   id()         <=> basic_string_builder()
+	 *   append(a, b) <=> a += b
+	 * \endcode
+	 *
+	 * \ingroup string
+	 */
+	template<typename Ch, typename Tr, typename A>
+	struct monoid<basic_string_builder<Ch,Tr,A>> {
+		using builder = basic_string_builder<Ch,Tr,A>;
+
+		static builder id() {
+			return builder{};
+		}
+
+		static builder append(const builder& b1, const builder& b2) {
+			builder b(b1);
+			b += b2;
+			return b;
+		}
+
+		static builder append(builder&& b1, const builder& b2) {
+			b1 += b2;
+			return std::move(b1);
+		}
+
+		static builder append(const builder& b1, builder&& b2) {
+			b2.prepend(b1);
+			return std::move(b2);
+		}
+
+		static builder append(builder&& b1, builder&& b2) {
+			b1 += std::move(b2);
+			return std::move(b1);
+		}
+
+		static constexpr bool instance = true;
+	};
+
 }
 
 #endif
-
@@ -23,12 +23,16 @@
 #ifndef FTL_SUM_TYPE_H
 #define FTL_SUM_TYPE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <stdexcept>
 #include <memory>
 #include <string>
 #include "type_functions.h"
 #include "concepts/basic.h"
 #include "concepts/orderable.h"
+#include "implementation/mix_hash.h"
 
 namespace ftl {
 
@@ -42,6 +46,9 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * \par Dependencies
+	 * - `<cstddef>`
+	 * - `<cstdint>`
+	 * - `<functional>`
 	 * - `<stdexcept>`
 	 * - `<memory>`
 	 * - `<string>`
@@ -124,25 +131,20 @@ namespace ftl {
 
 	namespace _dtl {
 
-		template<typename, typename...>
-		struct is_type_set;
-
-		template<typename T>
-		struct is_type_set<T> {
-			static constexpr bool value = true;
-		};
+		// No type occurs twice iff every type is first found where it is
+		template<typename S, typename...Ts>
+		struct is_type_set_at;
 
-		template<typename T, typename U, typename...Ts>
-		struct is_type_set<T,U,Ts...> {
-			static constexpr bool value =
-				is_type_set<T,Ts...>::value
-				&& is_type_set<U,Ts...>::value;
+		template<size_t...I, typename...Ts>
+		struct is_type_set_at<seq<I...>,Ts...> {
+			static constexpr bool value = std::is_same<
+				seq<index_of<Ts,Ts...>::value...>, seq<I...>
+			>::value;
 		};
 
-		template<typename T, typename...Ts>
-		struct is_type_set<T,T,Ts...> {
-			static constexpr bool value = false;
-		};
+		template<typename...Ts>
+		struct is_type_set
+		: is_type_set_at<make_index_seq<sizeof...(Ts)>,Ts...> {};
 
 		template<typename,typename...>
 		struct find_call_match {
@@ -235,332 +237,925 @@ namespace ftl {
 		template<typename...>
 		struct recursive_union {};
 
-		template<size_t I, typename T, typename...Ts>
-		struct union_indexer {
-			static constexpr auto ref(recursive_union<T,Ts...>& u)
-			-> decltype(union_indexer<I-1,Ts...>::ref(u.r)) {
-				return union_indexer<I-1,Ts...>::ref(u.r);
-			}
+		// Reference alternatives are stored as a pointer to the referent
+		template<typename T>
+		struct ref_element {
+			explicit constexpr ref_element(T& t) noexcept
+			: p(std::addressof(t)) {}
 
-			static constexpr auto ref(const recursive_union<T,Ts...>& u)
-			-> decltype(union_indexer<I-1,Ts...>::ref(u.r)) {
-				return union_indexer<I-1,Ts...>::ref(u.r);
-			}
+			explicit constexpr ref_element(std::nullptr_t) noexcept
+			: p(nullptr) {}
 
-			static constexpr auto ptr(recursive_union<T,Ts...>& u)
-			-> decltype(union_indexer<I-1,Ts...>::ptr(u.r)) {
-				return union_indexer<I-1,Ts...>::ptr(u.r);
-			}
+			T* p;
 		};
 
-		template<typename T, typename...Ts>
-		struct union_indexer<0,T,Ts...> {
-			static constexpr T& ref(recursive_union<T,Ts...>& u) {
-				return u.v;
+		template<typename T>
+		struct union_element {
+			using type = T;
+
+			static constexpr T& get(T& t) noexcept {
+				return t;
 			}
 
-			static constexpr const T& ref(const recursive_union<T,Ts...>& u) {
-				return u.v;
+			static constexpr const T& get(const T& t) noexcept {
+				return t;
 			}
+		};
 
-			static constexpr T* ptr(recursive_union<T,Ts...>& u) {
-				return std::addressof(u.v);
+		template<typename T>
+		struct union_element<T&> {
+			using type = ref_element<T>;
+
+			static constexpr T& get(const ref_element<T>& r) noexcept {
+				return *r.p;
 			}
 		};
 
+		template<typename T>
+		using element_type = typename union_element<T>::type;
+
+		// Assigns to an alternative of the same type, or reconstructs it if
+		// the type cannot be assigned to
+		template<typename E, typename V>
+		void assign_element(E& e, V&& x, std::true_type) {
+			e = std::forward<V>(x);
+		}
+
+		template<typename E, typename V>
+		void assign_element(E& e, V&& x, std::false_type) {
+			e.~E();
+			new (std::addressof(e)) E(std::forward<V>(x));
+		}
+
 		template<typename T>
 		struct overload_tag {};
 
 		template<typename R, typename T, typename...>
 		struct union_visitor {
+			// V is T, possibly const, or the referent of a reference T
 			template<
-				typename O, typename F, typename...Fs,
-				typename = typename std::enable_if<
-					is_callable<F,T>::value
-				>::type
-			>
-			static R visit(overload_tag<O>, const T& t, F&& f, Fs&&...) {
-				return std::forward<F>(f)(t);
-			}
-
-			template<
-				typename O, typename F, typename...Fs,
+				typename O, typename V, typename F, typename...Fs,
 				typename = typename std::enable_if<
 					is_callable<F,T>::value
 				>::type
 			>
-			static R visit(overload_tag<O>, T& t, F&& f, Fs&&...) {
+			static R visit(overload_tag<O>, V& t, F&& f, Fs&&...) {
 				return std::forward<F>(f)(t);
 			}
 
 			template<
-				typename F, typename O, typename...Fs,
+				typename F, typename O, typename V, typename...Fs,
 				typename = typename std::enable_if<
 					!is_callable<F,T>::value
 				>::type
 			>
-			static R visit(overload_tag<O> o, const T& t, F&&, Fs&&...fs) {
-				return union_visitor::visit(o, t, std::forward<Fs>(fs)...);
-			}
-
-			template<
-				typename F, typename O, typename...Fs,
-				typename = typename std::enable_if<
-					!is_callable<F,T>::value
-				>::type
-			>
-			static R visit(overload_tag<O> o, T& t, F&&, Fs&&...fs) {
+			static R visit(overload_tag<O> o, V& t, F&&, Fs&&...fs) {
 				return union_visitor::visit(o, t, std::forward<Fs>(fs)...);
 			}
 		};
 
 		template<typename T, typename...Ts>
 		struct union_visitor<void,T,Ts...> {
+			// V is T, possibly const, or the referent of a reference T
 			template<
-				typename O, typename F, typename...Fs,
+				typename O, typename V, typename F, typename...Fs,
 				typename = typename std::enable_if<
 					is_callable<F,T>::value
 				>::type
 			>
-			static void visit(overload_tag<O>, const T& t, F&& f, Fs&&...) {
+			static void visit(overload_tag<O>, V& t, F&& f, Fs&&...) {
 				std::forward<F>(f)(t);
 			}
 
 			template<
-				typename O, typename F, typename...Fs,
-				typename = typename std::enable_if<
-					is_callable<F,T>::value
-				>::type
-			>
-			static void visit(overload_tag<O>, T& t, F&& f, Fs&&...) {
-				std::forward<F>(f)(t);
-			}
-
-			template<
-				typename F, typename O, typename...Fs,
+				typename F, typename O, typename V, typename...Fs,
 				typename = typename std::enable_if<
 					!is_callable<F,T>::value
 				>::type
 			>
-			static void visit(overload_tag<O> o, const T& t, F&&, Fs&&...fs) {
+			static void visit(overload_tag<O> o, V& t, F&&, Fs&&...fs) {
 				union_visitor::visit(o, t, std::forward<Fs>(fs)...);
 			}
+		};
 
-			template<
-				typename F, typename O, typename...Fs,
-				typename = typename std::enable_if<
-					!is_callable<F,T>::value
-				>::type
-			>
-			static void visit(overload_tag<O> o, T& t, F&&, Fs&&...fs) {
-				union_visitor::visit(o, t, std::forward<Fs>(fs)...);
-			}
+		template<>
+		struct recursive_union<> {
+			void copy(size_t, const recursive_union&) noexcept {}
+			void move(size_t, recursive_union&&) noexcept {}
+			void destruct(size_t) noexcept {}
+
+			constexpr bool compare( size_t,const recursive_union&) const noexcept
+			{ return false; }
 		};
 
-		template<typename R, typename...Ts>
-		struct union_visitor<R,seq<>,Ts...> {
-			template<typename...Fs>
-			static R visit(const recursive_union<Ts...>&, size_t, Fs&&...) {
-				throw invalid_sum_type_access{""};
+		// Tags selecting the half of a recursive_union to construct
+		struct union_left_t {};
+		struct union_right_t {};
+
+		/*
+		 * The storage of a single alternative of a recursive_union.
+		 *
+		 * An anonymous union with a member that is not trivially destructible
+		 * has a deleted destructor, so one must be provided, but doing so
+		 * unconditionally would keep unions of trivial types from being
+		 * trivial themselves.
+		 */
+		template<bool Trivial, typename T>
+		struct union_leaf {
+			constexpr union_leaf() noexcept {}
+
+			template<typename...Args>
+			explicit constexpr union_leaf(constructor<T>, Args&&...args)
+			noexcept(
+				std::is_nothrow_constructible<element_type<T>,Args...>::value
+			)
+			: v(std::forward<Args>(args)...) {}
+
+			~union_leaf() {}
+
+			union {
+				element_type<T> v;
+			};
+		};
+
+		template<typename T>
+		struct union_leaf<true,T> {
+			constexpr union_leaf() noexcept {}
+
+			template<typename...Args>
+			explicit constexpr union_leaf(constructor<T>, Args&&...args)
+			noexcept(
+				std::is_nothrow_constructible<element_type<T>,Args...>::value
+			)
+			: v(std::forward<Args>(args)...) {}
+
+			union {
+				element_type<T> v;
+			};
+		};
+
+		// The storage of two halves of a recursive_union, L and R
+		template<bool Trivial, typename L, typename R>
+		struct union_node {
+			constexpr union_node() noexcept {}
+
+			template<typename...Args>
+			explicit constexpr union_node(union_left_t, Args&&...args)
+			noexcept(std::is_nothrow_constructible<L,Args...>::value)
+			: l(std::forward<Args>(args)...) {}
+
+			template<typename...Args>
+			explicit constexpr union_node(union_right_t, Args&&...args)
+			noexcept(std::is_nothrow_constructible<R,Args...>::value)
+			: r(std::forward<Args>(args)...) {}
+
+			~union_node() {}
+
+			union {
+				L l;
+				R r;
+			};
+		};
+
+		template<typename L, typename R>
+		struct union_node<true,L,R> {
+			constexpr union_node() noexcept {}
+
+			template<typename...Args>
+			explicit constexpr union_node(union_left_t, Args&&...args)
+			noexcept(std::is_nothrow_constructible<L,Args...>::value)
+			: l(std::forward<Args>(args)...) {}
+
+			template<typename...Args>
+			explicit constexpr union_node(union_right_t, Args&&...args)
+			noexcept(std::is_nothrow_constructible<R,Args...>::value)
+			: r(std::forward<Args>(args)...) {}
+
+			union {
+				L l;
+				R r;
+			};
+		};
+
+		template<typename T>
+		using union_leaf_of = union_leaf<
+			std::is_trivially_destructible<element_type<T>>::value, T
+		>;
+
+		template<typename T>
+		struct recursive_union<T> : union_leaf_of<T> {
+			using base = union_leaf_of<T>;
+			using E = element_type<T>;
+
+			using base::base;
+
+			constexpr recursive_union() noexcept {}
+
+			void copy(size_t, const recursive_union& u)
+			noexcept(std::is_nothrow_copy_constructible<E>::value) {
+				new (std::addressof(this->v)) E(u.v);
 			}
 
-			template<typename...Fs>
-			static R visit(recursive_union<Ts...>&, size_t, Fs&&...) {
-				throw invalid_sum_type_access{""};
+			void move(size_t, recursive_union&& u)
+			noexcept(std::is_nothrow_move_constructible<E>::value) {
+				new (std::addressof(this->v)) E(std::move(u.v));
+			}
+
+			void destruct(size_t)
+			noexcept(std::is_nothrow_destructible<E>::value) {
+				this->v.~E();
+			}
+
+			void copy_assign(size_t, const recursive_union& u) {
+				assign_element(this->v, u.v, std::is_copy_assignable<E>{});
+			}
+
+			void move_assign(size_t, recursive_union&& u) {
+				assign_element(
+					this->v, std::move(u.v), std::is_move_assignable<E>{}
+				);
+			}
+
+			constexpr bool compare(size_t, const recursive_union& rhs) const
+			noexcept {
+				return union_element<T>::get(this->v)
+					== union_element<T>::get(rhs.v);
 			}
 		};
 
+		template<typename>
+		struct union_of;
+
 		template<typename...Ts>
-		struct union_visitor<void,seq<>,Ts...> {
-			template<typename...Fs>
-			static void visit(const recursive_union<Ts...>&, size_t, Fs&&...) {
-				throw invalid_sum_type_access{""};
+		struct union_of<type_seq<Ts...>> {
+			using type = recursive_union<Ts...>;
+		};
+
+		// The unions of the first and second half of Ts
+		template<typename...Ts>
+		struct union_halves {
+			static constexpr size_t split = sizeof...(Ts)/2;
+
+			using left = typename union_of<
+				typename take_types<split,Ts...>::type
+			>::type;
+
+			using right = typename union_of<
+				typename drop_types<split,Ts...>::type
+			>::type;
+		};
+
+		template<typename...Ts>
+		using union_node_of = union_node<
+			std::is_trivially_destructible<
+				typename union_halves<Ts...>::left
+			>::value
+			&& std::is_trivially_destructible<
+				typename union_halves<Ts...>::right
+			>::value,
+			typename union_halves<Ts...>::left,
+			typename union_halves<Ts...>::right
+		>;
+
+		/*
+		 * Two or more alternatives, as a union of two halves.
+		 *
+		 * The alternatives form a balanced tree, so that reaching any one of
+		 * them takes O(log N) steps and levels of instantiation, instead of
+		 * one per alternative ahead of it.
+		 */
+		template<typename T1, typename T2, typename...Ts>
+		struct recursive_union<T1,T2,Ts...> : union_node_of<T1,T2,Ts...> {
+			using base = union_node_of<T1,T2,Ts...>;
+			using left_type = typename union_halves<T1,T2,Ts...>::left;
+			using right_type = typename union_halves<T1,T2,Ts...>::right;
+
+			static constexpr size_t split = union_halves<T1,T2,Ts...>::split;
+
+			// The half U is in
+			template<typename U>
+			using side = typename std::conditional<
+				(index_of<U,T1,T2,Ts...>::value < split),
+				union_left_t,
+				union_right_t
+			>::type;
+
+			constexpr recursive_union() noexcept {}
+
+			template<typename U, typename...Args>
+			explicit constexpr recursive_union(constructor<U> t, Args&&...args)
+			noexcept(
+				std::is_nothrow_constructible<
+					base, side<U>, constructor<U>, Args...
+				>::value
+			)
+			: base(side<U>{}, t, std::forward<Args>(args)...) {}
+
+			void copy(size_t i, const recursive_union& u)
+			noexcept(
+				noexcept(std::declval<left_type&>().copy(i, u.l))
+				&& noexcept(std::declval<right_type&>().copy(i, u.r))
+			)
+			{
+				if(i < split) {
+					this->l.copy(i, u.l);
+				}
+				else {
+					this->r.copy(i - split, u.r);
+				}
 			}
 
-			template<typename...Fs>
-			static void visit(recursive_union<Ts...>&, size_t, Fs&&...) {
-				throw invalid_sum_type_access{""};
+			void move(size_t i, recursive_union&& u)
+			noexcept(
+				noexcept(std::declval<left_type&>().move(i, std::move(u.l)))
+				&& noexcept(std::declval<right_type&>().move(i, std::move(u.r)))
+			)
+			{
+				if(i < split) {
+					this->l.move(i, std::move(u.l));
+				}
+				else {
+					this->r.move(i - split, std::move(u.r));
+				}
 			}
-		};
 
-		template<typename R, size_t I, size_t...Is, typename T, typename...Ts>
-		struct union_visitor<R,seq<I,Is...>,T,Ts...> {
-			template<typename...Fs>
-			static R visit(
-					const recursive_union<T,Ts...>& u, size_t i, Fs&&...fs
-			) {
-				if(i == I) {
-					return union_visitor<R,T>::visit(
-						overload_tag<T>{}, u.v, std::forward<Fs>(fs)...
-					);
+			void destruct(size_t i)
+			noexcept(
+				noexcept(std::declval<left_type&>().destruct(i))
+				&& noexcept(std::declval<right_type&>().destruct(i))
+			)
+			{
+				if(i < split) {
+					this->l.destruct(i);
 				}
 				else {
-					return union_visitor<R,seq<Is...>,Ts...>::visit(
-						u.r, i, std::forward<Fs>(fs)...
-					);
+					this->r.destruct(i - split);
 				}
 			}
 
-			template<typename...Fs>
-			static R visit(
-					recursive_union<T,Ts...>& u, size_t i, Fs&&...fs
-			) {
-				if(i == I) {
-					return union_visitor<R,T>::visit(
-						overload_tag<T>{}, u.v, std::forward<Fs>(fs)...
-					);
+			void copy_assign(size_t i, const recursive_union& u) {
+				if(i < split) {
+					this->l.copy_assign(i, u.l);
 				}
 				else {
-					return union_visitor<R,seq<Is...>,Ts...>::visit(
-						u.r, i, std::forward<Fs>(fs)...
-					);
+					this->r.copy_assign(i - split, u.r);
 				}
 			}
+
+			void move_assign(size_t i, recursive_union&& u) {
+				if(i < split) {
+					this->l.move_assign(i, std::move(u.l));
+				}
+				else {
+					this->r.move_assign(i - split, std::move(u.r));
+				}
+			}
+
+			constexpr bool compare(size_t i, const recursive_union& rhs) const
+			noexcept {
+				return i < split
+					? this->l.compare(i, rhs.l)
+					: this->r.compare(i - split, rhs.r);
+			}
 		};
 
-		template<size_t I, size_t...Is, typename T, typename...Ts>
-		struct union_visitor<void,seq<I,Is...>,T,Ts...> {
-			template<typename...Fs>
-			static void visit(
-					const recursive_union<T,Ts...>& u, size_t i, Fs&&...fs
+		template<typename T1, typename T2, typename...Ts>
+		constexpr size_t recursive_union<T1,T2,Ts...>::split;
+
+		// Reaches the element at I of the recursive union U
+		template<size_t I, typename U>
+		struct union_locator;
+
+		template<size_t I, typename T>
+		struct union_locator<I,recursive_union<T>> {
+			static constexpr auto ref(recursive_union<T>& u)
+			-> decltype(union_element<T>::get(u.v)) {
+				return union_element<T>::get(u.v);
+			}
+
+			static constexpr auto ref(const recursive_union<T>& u)
+			-> decltype(union_element<T>::get(u.v)) {
+				return union_element<T>::get(u.v);
+			}
+
+			static constexpr element_type<T>* ptr(recursive_union<T>& u) {
+				return std::addressof(u.v);
+			}
+
+			static constexpr const element_type<T>* ptr(
+					const recursive_union<T>& u
 			) {
+				return std::addressof(u.v);
+			}
+		};
+
+		template<size_t I, typename U, bool = (I < U::split)>
+		struct union_branch {
+			using next = union_locator<I, typename U::left_type>;
+
+			static constexpr auto ref(U& u) -> decltype(next::ref(u.l)) {
+				return next::ref(u.l);
+			}
+
+			static constexpr auto ref(const U& u) -> decltype(next::ref(u.l)) {
+				return next::ref(u.l);
+			}
+
+			static constexpr auto ptr(U& u) -> decltype(next::ptr(u.l)) {
+				return next::ptr(u.l);
+			}
+
+			static constexpr auto ptr(const U& u) -> decltype(next::ptr(u.l)) {
+				return next::ptr(u.l);
+			}
+		};
+
+		template<size_t I, typename U>
+		struct union_branch<I,U,false> {
+			using next = union_locator<I - U::split, typename U::right_type>;
+
+			static constexpr auto ref(U& u) -> decltype(next::ref(u.r)) {
+				return next::ref(u.r);
+			}
+
+			static constexpr auto ref(const U& u) -> decltype(next::ref(u.r)) {
+				return next::ref(u.r);
+			}
+
+			static constexpr auto ptr(U& u) -> decltype(next::ptr(u.r)) {
+				return next::ptr(u.r);
+			}
+
+			static constexpr auto ptr(const U& u) -> decltype(next::ptr(u.r)) {
+				return next::ptr(u.r);
+			}
+		};
+
+		template<size_t I, typename T1, typename T2, typename...Ts>
+		struct union_locator<I,recursive_union<T1,T2,Ts...>>
+		: union_branch<I,recursive_union<T1,T2,Ts...>> {};
+
+		template<size_t I, typename...Ts>
+		struct union_indexer : union_locator<I,recursive_union<Ts...>> {};
+
+		// Compares the active index with each of the indices in S in turn
+		template<typename R, typename S, typename...Ts>
+		struct union_chain_visitor;
+
+		template<typename R, typename...Ts>
+		struct union_chain_visitor<R,seq<>,Ts...> {
+			template<typename V, typename...Fs>
+			static R visit(V&, size_t, Fs&&...) {
+				throw invalid_sum_type_access{""};
+			}
+		};
+
+		template<typename R, size_t I, size_t...Is, typename...Ts>
+		struct union_chain_visitor<R,seq<I,Is...>,Ts...> {
+			// V is recursive_union<Ts...>, possibly const
+			template<typename V, typename...Fs>
+			static R visit(V& u, size_t i, Fs&&...fs) {
+				using T = type_at<I,Ts...>;
+
 				if(i == I) {
-					union_visitor<void,T>::visit(
-						overload_tag<T>{}, u.v, std::forward<Fs>(fs)...
+					return union_visitor<R,T>::visit(
+						overload_tag<T>{},
+						union_indexer<I,Ts...>::ref(u),
+						std::forward<Fs>(fs)...
 					);
 				}
 				else {
-					union_visitor<void,seq<Is...>,Ts...>::visit(
-						u.r, i, std::forward<Fs>(fs)...
+					return union_chain_visitor<R,seq<Is...>,Ts...>::visit(
+						u, i, std::forward<Fs>(fs)...
 					);
 				}
 			}
+		};
+
+		// Dispatches on the active index through the recursive members
+		template<typename...Ts>
+		struct union_chain {
+			using U = recursive_union<Ts...>;
+
+			static void copy(size_t i, U& dst, const U& src) {
+				dst.copy(i, src);
+			}
+
+			static void move(size_t i, U& dst, U& src) {
+				dst.move(i, std::move(src));
+			}
+
+			static void destruct(size_t i, U& u) {
+				u.destruct(i);
+			}
+
+			static void copy_assign(size_t i, U& dst, const U& src) {
+				dst.copy_assign(i, src);
+			}
+
+			static void move_assign(size_t i, U& dst, U& src) {
+				dst.move_assign(i, std::move(src));
+			}
+
+			template<typename R, typename V, typename...Fs>
+			static R visit(V& u, size_t i, Fs&&...fs) {
+				return union_chain_visitor<R,gen_seq<0,sizeof...(Ts)-1>,Ts...>
+					::visit(u, i, std::forward<Fs>(fs)...);
+			}
+		};
+
+		/*
+		 * Dispatches on the active index with a table of function pointers.
+		 *
+		 * One indirect call, instead of one comparison per alternative ahead
+		 * of the active one, and one level of template recursion per
+		 * alternative.
+		 */
+		template<typename, typename...>
+		struct union_table;
+
+		template<size_t...I, typename...Ts>
+		struct union_table<seq<I...>,Ts...> {
+			using U = recursive_union<Ts...>;
+
+			template<size_t J>
+			static void copy_at(U& dst, const U& src) {
+				using E = element_type<type_at<J,Ts...>>;
+				new (union_indexer<J,Ts...>::ptr(dst))
+					E(*union_indexer<J,Ts...>::ptr(src));
+			}
+
+			template<size_t J>
+			static void move_at(U& dst, U& src) {
+				using E = element_type<type_at<J,Ts...>>;
+				new (union_indexer<J,Ts...>::ptr(dst))
+					E(std::move(*union_indexer<J,Ts...>::ptr(src)));
+			}
+
+			template<size_t J>
+			static void destruct_at(U& u) {
+				using E = element_type<type_at<J,Ts...>>;
+				union_indexer<J,Ts...>::ptr(u)->~E();
+			}
+
+			template<size_t J>
+			static void copy_assign_at(U& dst, const U& src) {
+				using E = element_type<type_at<J,Ts...>>;
+				assign_element(
+					*union_indexer<J,Ts...>::ptr(dst),
+					*union_indexer<J,Ts...>::ptr(src),
+					std::is_copy_assignable<E>{}
+				);
+			}
+
+			template<size_t J>
+			static void move_assign_at(U& dst, U& src) {
+				using E = element_type<type_at<J,Ts...>>;
+				assign_element(
+					*union_indexer<J,Ts...>::ptr(dst),
+					std::move(*union_indexer<J,Ts...>::ptr(src)),
+					std::is_move_assignable<E>{}
+				);
+			}
+
+			template<typename R, typename V, size_t J, typename...Fs>
+			static R visit_at(V& u, Fs&&...fs) {
+				using T = type_at<J,Ts...>;
+				return union_visitor<R,T>::visit(
+					overload_tag<T>{},
+					union_indexer<J,Ts...>::ref(u),
+					std::forward<Fs>(fs)...
+				);
+			}
+
+			static void copy(size_t i, U& dst, const U& src) {
+				static constexpr void (*table[])(U&, const U&) = {
+					&copy_at<I>...
+				};
+
+				table[i](dst, src);
+			}
+
+			static void move(size_t i, U& dst, U& src) {
+				static constexpr void (*table[])(U&, U&) = {&move_at<I>...};
+
+				table[i](dst, src);
+			}
+
+			static void destruct(size_t i, U& u) {
+				static constexpr void (*table[])(U&) = {&destruct_at<I>...};
+
+				table[i](u);
+			}
+
+			static void copy_assign(size_t i, U& dst, const U& src) {
+				static constexpr void (*table[])(U&, const U&) = {
+					&copy_assign_at<I>...
+				};
+
+				table[i](dst, src);
+			}
+
+			static void move_assign(size_t i, U& dst, U& src) {
+				static constexpr void (*table[])(U&, U&) = {
+					&move_assign_at<I>...
+				};
+
+				table[i](dst, src);
+			}
+
+			template<typename R, typename V, typename...Fs>
+			static R visit(V& u, size_t i, Fs&&...fs) {
+				static constexpr R (*table[])(V&, Fs&&...) = {
+					&visit_at<R,V,I,Fs...>...
+				};
+
+				return table[i](u, std::forward<Fs>(fs)...);
+			}
+		};
+
+		// Sum types with more alternatives than this use jump tables. For
+		// fewer, the chain of comparisons is cheap and easily inlined.
+		constexpr size_t union_chain_limit = 4;
+
+		template<typename...Ts>
+		using union_dispatch = typename std::conditional<
+			(sizeof...(Ts) > union_chain_limit),
+			union_table<gen_seq<0,sizeof...(Ts)-1>,Ts...>,
+			union_chain<Ts...>
+		>::type;
+
+		// Smallest unsigned type able to index N alternatives
+		template<size_t N>
+		using index_type = typename std::conditional<
+			(N <= 0xff),
+			std::uint8_t,
+			typename std::conditional<
+				(N <= 0xffff), std::uint16_t, std::size_t
+			>::type
+		>::type;
+
+		// Tag selecting the constructor of sum_storage that leaves it empty
+		struct uninitialised_t {};
+
+		/*
+		 * Object whose address no valid pointer to a U compares equal to.
+		 *
+		 * A static of U itself, rather than some buffer cast to U*, so that
+		 * both taking its address and comparing against it are constant
+		 * expressions.
+		 */
+		template<typename U>
+		struct pointer_niche {
+			static U object;
+		};
+
+		template<typename U>
+		U pointer_niche<U>::object{};
+
+		/*
+		 * Whether the active alternative of sum_type<Ts...> can be told from
+		 * the stored value alone.
+		 *
+		 * This is the case for a pointer to a scalar and an empty, trivial
+		 * alternative, e.g. `maybe<int*>`: the pointer is set to the address
+		 * of pointer_niche's object when the empty alternative is active.
+		 * Pointers to classes are left out, as the class may be incomplete or
+		 * abstract, leaving no object to point to that is usable in constant
+		 * expressions. For a reference, e.g. `maybe<T&>`, the pointer is null
+		 * when the empty alternative is active.
+		 */
+		template<typename...Ts>
+		struct has_niche : std::false_type {};
+
+		template<typename E>
+		struct is_niche_filler : std::integral_constant<bool,
+			std::is_empty<E>::value
+			&& std::is_trivially_copyable<E>::value
+			&& std::is_trivially_destructible<E>::value
+		> {};
+
+		template<typename T, typename E>
+		struct has_niche<T*,E> : std::integral_constant<bool,
+			std::is_scalar<T>::value && is_niche_filler<E>::value
+		> {};
+
+		template<typename T, typename E>
+		struct has_niche<T&,E> : is_niche_filler<E> {};
+
+		/*
+		 * The alternatives of a sum type and the index of the active one.
+		 *
+		 * The index is set after the alternative it refers to has been
+		 * constructed.
+		 */
+		template<bool Niche, typename...Ts>
+		struct sum_storage_impl {
+			template<typename T, typename...Args>
+			explicit constexpr sum_storage_impl(constructor<T> t, Args&&...args)
+			noexcept(
+				std::is_nothrow_constructible<
+					recursive_union<Ts...>,constructor<T>,Args...
+				>::value
+			)
+			: data(t, std::forward<Args>(args)...)
+			, cons(index_of<T,Ts...>::value) {}
+
+			template<typename T, typename U>
+			constexpr sum_storage_impl(
+					constructor<T> t, std::initializer_list<U> l
+			)
+			noexcept(
+				std::is_nothrow_constructible<
+					recursive_union<Ts...>,
+					constructor<T>,
+					std::initializer_list<U>
+				>::value
+			)
+			: data(t, l), cons(index_of<T,Ts...>::value) {}
+
+			explicit constexpr sum_storage_impl(uninitialised_t) noexcept
+			: cons(0) {}
+
+			constexpr size_t index() const noexcept {
+				return cons;
+			}
+
+			void set_index(size_t i) noexcept {
+				cons = static_cast<index_type<sizeof...(Ts)>>(i);
+			}
+
+			constexpr bool compare(size_t i, const sum_storage_impl& s) const {
+				return data.compare(i, s.data);
+			}
+
+			recursive_union<Ts...> data;
+			index_type<sizeof...(Ts)> cons;
+		};
+
+		template<typename T, typename E>
+		struct sum_storage_impl<true,T*,E> {
+			template<typename...Args>
+			explicit constexpr sum_storage_impl(
+					constructor<T*> t, Args&&...args
+			) noexcept
+			: data(t, std::forward<Args>(args)...) {}
+
+			// E is empty and trivial, it suffices to have constructed it
+			template<typename...Args>
+			explicit constexpr sum_storage_impl(constructor<E>, Args&&...args)
+			noexcept(std::is_nothrow_constructible<E,Args...>::value)
+			: data(
+				constructor<T*>(),
+				((void)E(std::forward<Args>(args)...), niche())
+			) {}
+
+			explicit constexpr sum_storage_impl(uninitialised_t) noexcept {}
+
+			constexpr size_t index() const noexcept {
+				return union_indexer<0,T*,E>::ref(data) == niche() ? 1 : 0;
+			}
+
+			void set_index(size_t i) noexcept {
+				if(i == 1)
+					union_indexer<0,T*,E>::ref(data) = niche();
+			}
 
-			template<typename...Fs>
-			static void visit(
-					recursive_union<T,Ts...>& u, size_t i, Fs&&...fs
-			) {
-				if(i == I) {
-					union_visitor<void,T>::visit(
-						overload_tag<T>{}, u.v, std::forward<Fs>(fs)...
-					);
-				}
-				else {
-					return union_visitor<void,seq<Is...>,Ts...>::visit(
-						u.r, i, std::forward<Fs>(fs)...
-					);
-				}
+			// The empty alternative is never actually stored, so not compared
+			constexpr bool compare(size_t i, const sum_storage_impl& s) const {
+				return i == 1 || data.compare(i, s.data);
 			}
-		};
 
-		template<>
-		struct recursive_union<> {
-			void copy(size_t, const recursive_union&) noexcept {}
-			void move(size_t, recursive_union&&) noexcept {}
-			void destruct(size_t) noexcept {}
+			static constexpr T* niche() noexcept {
+				return &pointer_niche<typename std::remove_cv<T>::type>::object;
+			}
 
-			constexpr bool compare( size_t,const recursive_union&) const noexcept
-			{ return false; }
+			recursive_union<T*,E> data;
 		};
 
-		template<typename T, typename...Ts>
-		struct recursive_union<T,Ts...> {
-			constexpr recursive_union() noexcept {}
+		template<typename T, typename E>
+		struct sum_storage_impl<true,T&,E> {
+			explicit constexpr sum_storage_impl(constructor<T&> t, T& r) noexcept
+			: data(t, r) {}
 
-			// Construct this element type
+			// E is empty and trivial, it suffices to have constructed it
 			template<typename...Args>
-			explicit constexpr recursive_union(constructor<T>, Args&&...args)
-			noexcept(std::is_nothrow_constructible<T,Args...>::value)
-			: v(std::forward<Args>(args)...) {}
+			explicit constexpr sum_storage_impl(constructor<E>, Args&&...args)
+			noexcept(std::is_nothrow_constructible<E,Args...>::value)
+			: data(
+				constructor<T&>(),
+				((void)E(std::forward<Args>(args)...), nullptr)
+			) {}
 
-			// Forward construction to U
-			template<typename U, typename...Args>
-			explicit constexpr recursive_union(constructor<U> t, Args&&...args)
-			noexcept(
-				std::is_nothrow_constructible<
-					recursive_union<Ts...>,constructor<U>,Args...
-				>::value
-			)
-			: r(t, std::forward<Args>(args)...) {}
+			explicit constexpr sum_storage_impl(uninitialised_t) noexcept {}
 
-			// Construct this element using an initializer_list
-			template<typename U>
-			constexpr recursive_union(constructor<T>, std::initializer_list<U> l)
-			noexcept(
-				std::is_nothrow_constructible<T,std::initializer_list<U>>::value
-			) : v(l) {}
+			constexpr size_t index() const noexcept {
+				return union_indexer<0,T&,E>::ptr(data)->p == nullptr ? 1 : 0;
+			}
 
-			// Forward construction using initializer_list to U
-			template<typename U, typename V>
-			constexpr recursive_union(
-					constructor<U> t, std::initializer_list<V> l
-			)
-			noexcept(
-				std::is_nothrow_constructible<
-					recursive_union<Ts...>,
-					constructor<U>,
-					std::initializer_list<V>
-				>::value
-			) : r(t, l) {}
+			void set_index(size_t i) noexcept {
+				if(i == 1)
+					union_indexer<0,T&,E>::ptr(data)->p = nullptr;
+			}
 
-			~recursive_union() {}
+			constexpr bool compare(size_t i, const sum_storage_impl& s) const {
+				return i == 1 || data.compare(i, s.data);
+			}
 
-			void copy(size_t i, const recursive_union& u)
-			noexcept(
-				std::is_nothrow_copy_constructible<T>::value
-				&& noexcept(std::declval<recursive_union>().r.copy(i-1, u.r))
-			)
-			{
-				if(i == 0) {
-					new (std::addressof(v)) T(u.v);
-				}
-				else {
-					r.copy(i-1, u.r);
-				}
+			recursive_union<T&,E> data;
+		};
+
+		/*
+		 * Copies, moves and destroys whichever alternative of S is active.
+		 *
+		 * Only used when some alternative is not trivially copyable, so that
+		 * sum types of trivial alternatives are trivial themselves and may be
+		 * copied with memcpy.
+		 */
+		template<typename S, typename...Ts>
+		struct managed_storage : S {
+			using S::S;
+
+			managed_storage(const managed_storage& s)
+			: S(uninitialised_t{}) {
+				size_t i = s.index();
+				union_dispatch<Ts...>::copy(i, this->data, s.data);
+				this->set_index(i);
 			}
 
-			void move(size_t i, recursive_union&& u)
-			noexcept(
-				std::is_nothrow_move_constructible<T>::value
-				&& noexcept(
-					std::declval<recursive_union>().r.move(i-1, std::move(u.r))
-				)
-			)
-			{
-				if(i == 0) {
-					new (std::addressof(v)) T(std::move(u.v));
-				}
-				else {
-					r.move(i-1, std::move(u.r));
-				}
+			managed_storage(managed_storage&& s)
+			: S(uninitialised_t{}) {
+				size_t i = s.index();
+				union_dispatch<Ts...>::move(i, this->data, s.data);
+				this->set_index(i);
 			}
 
-			void destruct(size_t i)
-			noexcept(
-				std::is_nothrow_destructible<T>::value
-				&& noexcept(std::declval<recursive_union>().r.destruct(i))
+			~managed_storage() noexcept(
+				noexcept(std::declval<recursive_union<Ts...>>().destruct(0))
 			)
 			{
-				if(i == 0)
-				{
-					v.~T();
-				}
-				else {
-					r.destruct(i-1);
-				}
+				union_dispatch<Ts...>::destruct(this->index(), this->data);
 			}
 
-			constexpr bool compare(size_t i, const recursive_union& rhs) const
-			noexcept {
-				return i == 0 ? v == rhs.v : r.compare(i-1, rhs.r);
+			// Alternatives of the same type are assigned to, so that they
+			// may reuse whatever resources they hold
+			managed_storage& operator= (const managed_storage& s) {
+				// Deal with self assignment
+				if(std::addressof(s) == this)
+					return *this;
+
+				size_t i = s.index();
+				if(i == this->index()) {
+					union_dispatch<Ts...>::copy_assign(i, this->data, s.data);
+					return *this;
+				}
+
+				union_dispatch<Ts...>::destruct(this->index(), this->data);
+				union_dispatch<Ts...>::copy(i, this->data, s.data);
+				this->set_index(i);
+
+				return *this;
 			}
 
-			union {
-				T v;
-				recursive_union<Ts...> r;
-			};
+			managed_storage& operator= (managed_storage&& s) {
+				// Deal with self assignment
+				if(std::addressof(s) == this)
+					return *this;
+
+				size_t i = s.index();
+				if(i == this->index()) {
+					union_dispatch<Ts...>::move_assign(i, this->data, s.data);
+					return *this;
+				}
+
+				union_dispatch<Ts...>::destruct(this->index(), this->data);
+				union_dispatch<Ts...>::move(i, this->data, s.data);
+				this->set_index(i);
+
+				return *this;
+			}
 		};
 
+		// Trivially copyable types may still have deleted assignment, which
+		// sum_type works around by constructing
+		template<typename T>
+		struct is_trivial_alternative : std::integral_constant<bool,
+			std::is_trivially_copy_constructible<T>::value
+			&& std::is_trivially_move_constructible<T>::value
+			&& std::is_trivially_copy_assignable<T>::value
+			&& std::is_trivially_move_assignable<T>::value
+			&& std::is_trivially_destructible<T>::value
+		> {};
+
+		template<typename...Ts>
+		using sum_storage = typename std::conditional<
+			All<is_trivial_alternative, element_type<Ts>...>::value,
+			sum_storage_impl<has_niche<Ts...>::value, Ts...>,
+			managed_storage<
+				sum_storage_impl<has_niche<Ts...>::value, Ts...>, Ts...
+			>
+		>::type;
+
 		template<size_t I, typename...Ts>
 		class get_sum_type_element;
 
@@ -586,6 +1181,9 @@ namespace ftl {
 	 * - \ref copyassignable, if all sub-types are CopyConstructible
 	 * - \ref moveassignable, if all sub-types are MoveConstructible
 	 *
+	 * If every sub-type is trivially copyable, assignable and destructible,
+	 * then so is the sum type, meaning it may be copied with `memcpy`.
+	 *
 	 * \ingroup sum_type
 	 */
 	template<typename...Ts>
@@ -602,13 +1200,8 @@ namespace ftl {
 
 	public:
 		sum_type() = delete;
-		sum_type(const sum_type& st) : cons(st.cons) {
-			data.copy(cons, st.data);
-		}
-
-		sum_type(sum_type&& st) : cons(st.cons) {
-			data.move(cons, std::move(st.data));
-		}
+		sum_type(const sum_type&) = default;
+		sum_type(sum_type&&) = default;
 
 		/**
 		 * Construct the sum type as an instance of `T`.
@@ -619,11 +1212,10 @@ namespace ftl {
 		explicit constexpr sum_type(constructor<T> t, Args&&...args)
 		noexcept(
 			std::is_nothrow_constructible<
-				_dtl::recursive_union<Ts...>,constructor<T>,Args...
+				_dtl::sum_storage<Ts...>,constructor<T>,Args...
 			>::value
 		)
-		: data(t, std::forward<Args>(args)...)
-		, cons(index_of<T,Ts...>::value) {}
+		: storage(t, std::forward<Args>(args)...) {}
 
 		/**
 		 * Construct as an instance of `T`, using an initializer_list.
@@ -640,20 +1232,15 @@ namespace ftl {
 		)
 		noexcept(
 			std::is_nothrow_constructible<
-				_dtl::recursive_union<Ts...>,
+				_dtl::sum_storage<Ts...>,
 				constructor<T>,
 				std::initializer_list<U>
 			>::value
 		)
-		: data(t, l), cons(index_of<T,Ts...>::value)
+		: storage(t, l)
 		{}
 
-		~sum_type() noexcept(
-			noexcept(std::declval<_dtl::recursive_union<Ts...>>().destruct(0))
-		)
-		{
-			data.destruct(cons);
-		}
+		~sum_type() = default;
 
 		/**
 		 * Check whether the `sum_type` is currently an instance of `T`.
@@ -669,7 +1256,7 @@ namespace ftl {
 		 */
 		template<typename T>
 		constexpr bool is() const noexcept {
-			return cons == index_of<T,Ts...>::value;
+			return storage.index() == index_of<T,Ts...>::value;
 		}
 
 		/**
@@ -686,33 +1273,56 @@ namespace ftl {
 		 */
 		template<size_t I>
 		constexpr bool isTypeAt() const noexcept {
-			return cons == I;
+			return storage.index() == I;
 		}
 
-		// TODO: Use assignment instead of construction if cons and s.cons
-		// are equal
-		sum_type& operator= (const sum_type& s) {
-			// Deal with self assignment
-			if(std::addressof(s) == this)
-				return *this;
-
-			data.destruct(cons);
-			cons = s.cons;
-			data.copy(cons, s.data);
+		/**
+		 * Assign from another sum type.
+		 *
+		 * If both hold the same alternative, it is assigned to using its own
+		 * assignment operator, so that e.g. a `std::vector` keeps its
+		 * capacity. Otherwise the active alternative is destroyed and a copy
+		 * of the other constructed in its place.
+		 */
+		sum_type& operator= (const sum_type&) = default;
 
-			return *this;
-		}
+		/// \overload
+		sum_type& operator= (sum_type&&) = default;
 
-		sum_type& operator= (sum_type&& s) {
-			// Deal with self assignment
-			if(std::addressof(s) == this)
-				return *this;
+		/**
+		 * Make the `sum_type` an instance of `T`, constructed in place.
+		 *
+		 * All the arguments are forwarded to `T`'s constructor. The current
+		 * alternative is destroyed first, unless that constructor may throw,
+		 * in which case the new value is built before anything else is
+		 * touched and then assigned as by `operator=`.
+		 *
+		 * \return Reference to the new value.
+		 *
+		 * \par Examples
+		 *
+		 * \code
+		 *   sum_type<int,std::string> x{constructor<int>(), 1};
+		 *
+		 *   x.emplace<std::string>(3, 'a');
+		 *   // x.is<std::string>() == true, holding "aaa"
+		 * \endcode
+		 */
+		template<typename T, typename...Args>
+		T& emplace(Args&&...args) {
+			emplace_as<T>(
+				std::is_nothrow_constructible<_dtl::element_type<T>,Args...>{},
+				std::forward<Args>(args)...
+			);
 
-			data.destruct(cons);
-			cons = s.cons;
-			data.move(cons, std::move(s.data));
+			return _dtl::union_indexer<index_of<T,Ts...>::value,Ts...>
+				::ref(storage.data);
+		}
 
-			return *this;
+		/// \overload
+		template<typename T, typename U>
+		T& emplace(std::initializer_list<U> l) {
+			return emplace<T,std::initializer_list<U>>(std::move(l));
 		}
 
 		/**
@@ -769,13 +1379,13 @@ namespace ftl {
 			type_seq<Ts...>,type_seq<Fs...>
 		>::type {
 
-			using indices = gen_seq<0,sizeof...(Ts)-1>;
 			using return_type = typename _dtl::common_return_type<
 				type_seq<Ts...>,type_seq<Fs...>
 			>::type;
 
-			return _dtl::union_visitor<return_type,indices,Ts...>
-				::visit(data, cons, std::forward<Fs>(fs)...);
+			return _dtl::union_dispatch<Ts...>::template visit<return_type>(
+				storage.data, storage.index(), std::forward<Fs>(fs)...
+			);
 		}
 
 		/// \overload
@@ -784,13 +1394,13 @@ namespace ftl {
 			type_seq<Ts...>,type_seq<Fs...>
 		>::type {
 
-			using indices = gen_seq<0,sizeof...(Ts)-1>;
 			using return_type = typename _dtl::common_return_type<
 				type_seq<Ts...>,type_seq<Fs...>
 			>::type;
 
-			return _dtl::union_visitor<return_type,indices,Ts...>
-				::visit(data, cons, std::forward<Fs>(fs)...);
+			return _dtl::union_dispatch<Ts...>::template visit<return_type>(
+				storage.data, storage.index(), std::forward<Fs>(fs)...
+			);
 		}
 
 		/**
@@ -848,34 +1458,66 @@ namespace ftl {
 		template<typename...Fs>
 		void matchE(Fs&&...fs) {
 
-			using indices = gen_seq<0,sizeof...(Ts)-1>;
-
-			::ftl::_dtl::union_visitor<void,indices,Ts...>
-				::visit(data, cons, std::forward<Fs>(fs)...);
+			::ftl::_dtl::union_dispatch<Ts...>::template visit<void>(
+				storage.data, storage.index(), std::forward<Fs>(fs)...
+			);
 		}
 
 		/// \overload
 		template<typename...Fs>
 		void matchE(Fs&&...fs) const {
 
-			using indices = gen_seq<0,sizeof...(Ts)-1>;
-
-			::ftl::_dtl::union_visitor<void,indices,Ts...>
-				::visit(data, cons, std::forward<Fs>(fs)...);
+			::ftl::_dtl::union_dispatch<Ts...>::template visit<void>(
+				storage.data, storage.index(), std::forward<Fs>(fs)...
+			);
 		}
 
 	private:
-		_dtl::recursive_union<Ts...> data;
-		size_t cons;
+		template<typename T, typename...Args>
+		void emplace_as(std::true_type, Args&&...args) {
+			using E = _dtl::element_type<T>;
+			constexpr size_t i = index_of<T,Ts...>::value;
+
+			_dtl::union_dispatch<Ts...>::destruct(storage.index(), storage.data);
+			new (_dtl::union_indexer<i,Ts...>::ptr(storage.data))
+				E(std::forward<Args>(args)...);
+			storage.set_index(i);
+		}
+
+		template<typename T, typename...Args>
+		void emplace_as(std::false_type, Args&&...args) {
+			*this = sum_type(constructor<T>(), std::forward<Args>(args)...);
+		}
+
+		_dtl::sum_storage<Ts...> storage;
 	};
 
 	namespace _dtl {
+		struct hash_element {
+			template<typename T>
+			size_t operator() (const T& t) const {
+				return std::hash<T>()(t);
+			}
+		};
+
 		class sum_type_accessor {
 		public:
 			template<typename...Ts>
 			static constexpr size_t activeIndex(const sum_type<Ts...>& u)
 			noexcept {
-				return u.cons;
+				return u.storage.index();
+			}
+
+			template<size_t I, typename...Ts>
+			static constexpr auto ref(const sum_type<Ts...>& u) noexcept
+			-> decltype(union_indexer<I,Ts...>::ref(u.storage.data)) {
+				return union_indexer<I,Ts...>::ref(u.storage.data);
+			}
+
+			template<size_t I, typename...Ts>
+			static auto ref(sum_type<Ts...>& u) noexcept
+			-> decltype(union_indexer<I,Ts...>::ref(u.storage.data)) {
+				return union_indexer<I,Ts...>::ref(u.storage.data);
 			}
 
 			template<typename...Ts>
@@ -883,39 +1525,51 @@ namespace ftl {
 					const sum_type<Ts...>& a, const sum_type<Ts...>& b
 			) noexcept
 			{
-				return a.data.compare(i, b.data);
+				return a.storage.compare(i, b.storage);
+			}
+
+			// Invoke f on the active element, whatever its type
+			template<typename R, typename F, typename...Ts>
+			static R visit(const sum_type<Ts...>& u, F&& f) {
+				return union_dispatch<Ts...>::template visit<R>(
+					u.storage.data, u.storage.index(), std::forward<F>(f)
+				);
+			}
+
+			template<typename...Ts>
+			static size_t hash(const sum_type<Ts...>& u) {
+				return hash_combine(
+					u.storage.index(), visit<size_t>(u, hash_element{})
+				);
 			}
 		};
 
 		template<size_t I, typename...Ts>
 		class get_sum_type_element {
 		public:
-			// TODO: C++14: With relaxed constexpr requirements,
-			// these are possible candidates
-			static auto get(sum_type<Ts...>& u)
-			-> decltype(union_indexer<I,Ts...>::ref(u.data)) {
-				if(u.cons != I)
-					throw invalid_sum_type_access{
-						std::string("Indexing with ")
-						+ std::to_string(I)
-						+ std::string(", but active index is ")
-						+ std::to_string(u.cons)
-					};
-
-				return union_indexer<I,Ts...>::ref(u.data);
-			}
-
-			static auto get(const sum_type<Ts...>& u)
-			-> decltype(union_indexer<I,Ts...>::ref(u.data)) {
-				if(u.cons != I)
-					throw invalid_sum_type_access{
-						std::string("Indexing with ")
-						+ std::to_string(I)
-						+ std::string(", but active index is ")
-						+ std::to_string(u.cons)
-					};
-
-				return union_indexer<I,Ts...>::ref(u.data);
+			[[noreturn]] static void invalid_access(size_t active) {
+				throw invalid_sum_type_access{
+					std::string("Indexing with ")
+					+ std::to_string(I)
+					+ std::string(", but active index is ")
+					+ std::to_string(active)
+				};
+			}
+
+			static constexpr auto get(sum_type<Ts...>& u)
+			-> decltype(union_indexer<I,Ts...>::ref(u.storage.data)) {
+				return u.storage.index() == I
+					? union_indexer<I,Ts...>::ref(u.storage.data)
+					: (invalid_access(u.storage.index()),
+						union_indexer<I,Ts...>::ref(u.storage.data));
+			}
+
+			static constexpr auto get(const sum_type<Ts...>& u)
+			-> decltype(union_indexer<I,Ts...>::ref(u.storage.data)) {
+				return u.storage.index() == I
+					? union_indexer<I,Ts...>::ref(u.storage.data)
+					: (invalid_access(u.storage.index()),
+						union_indexer<I,Ts...>::ref(u.storage.data));
 			}
 		};
 	}
@@ -982,22 +1636,314 @@ namespace ftl {
 		return get<index_of<T,Ts...>::value>(x);
 	}
 
+	namespace _dtl {
+		template<typename>
+		struct sum_type_size;
+
+		template<typename...Ts>
+		struct sum_type_size<sum_type<Ts...>>
+		: std::integral_constant<size_t, sizeof...(Ts)> {};
+
+		template<typename S>
+		struct sum_type_size<const S> : sum_type_size<S> {};
+
+		template<typename...Ss>
+		struct sum_type_sizes : std::integral_constant<size_t, 1> {};
+
+		template<typename S, typename...Ss>
+		struct sum_type_sizes<S,Ss...>
+		: std::integral_constant<size_t,
+			sum_type_size<S>::value * sum_type_sizes<Ss...>::value
+		> {};
+
+		// Reference to the element at I of S, as const as S
+		template<typename S, size_t I>
+		struct sum_type_element;
+
+		template<typename...Ts, size_t I>
+		struct sum_type_element<sum_type<Ts...>,I> {
+			using type = type_at<I,Ts...>&;
+		};
+
+		template<typename...Ts, size_t I>
+		struct sum_type_element<const sum_type<Ts...>,I> {
+			using type = const type_at<I,Ts...>&;
+		};
+
+		template<typename>
+		struct seq_tuple;
+
+		template<typename...Ts>
+		struct seq_tuple<type_seq<Ts...>> {
+			using type = std::tuple<Ts...>;
+		};
+
+		/*
+		 * The I:th combination of active elements of the sum types Ss, which
+		 * are stored from position P onwards in some tuple. Combinations are
+		 * numbered as digits, with the first sum type the most significant.
+		 */
+		template<size_t I, size_t P, typename...Ss>
+		struct sum_type_combination {
+			using type = type_seq<>;
+
+			template<typename T>
+			static std::tuple<> refs(const T&) noexcept {
+				return std::tuple<>{};
+			}
+		};
+
+		template<size_t I, size_t P, typename S, typename...Ss>
+		struct sum_type_combination<I,P,S,Ss...> {
+			static constexpr size_t stride = sum_type_sizes<Ss...>::value;
+
+			using element = typename sum_type_element<S,I / stride>::type;
+			using rest = sum_type_combination<I % stride, P+1, Ss...>;
+			using type = prepend_type<element, typename rest::type>;
+
+			template<typename T>
+			static typename seq_tuple<type>::type refs(const T& t) noexcept {
+				return std::tuple_cat(
+					std::tuple<element>(
+						sum_type_accessor::template ref<I / stride>(
+							std::get<P>(t)
+						)
+					),
+					rest::refs(t)
+				);
+			}
+		};
+
+		// Result of the first of Fs callable with the elements of As
+		template<typename As, typename...Fs>
+		struct find_multi_call_match {
+			using type = _dtl::no;
+		};
+
+		template<typename...As, typename F, typename...Fs>
+		struct find_multi_call_match<type_seq<As...>,F,Fs...> {
+			using type = if_<is_callable<F,As...>::value,
+				typename is_callable<F,As...>::type,
+				typename find_multi_call_match<type_seq<As...>,Fs...>::type
+			>;
+		};
+
+		constexpr bool all_true() noexcept {
+			return true;
+		}
+
+		template<typename...Bs>
+		constexpr bool all_true(bool b, Bs...bs) noexcept {
+			return b && all_true(bs...);
+		}
+
+		template<typename Is, typename Ss, typename Fs>
+		struct multi_match_type;
+
+		template<size_t...I, typename...Ss, typename...Fs>
+		struct multi_match_type<seq<I...>,type_seq<Ss...>,type_seq<Fs...>> {
+			static_assert(
+				all_true(
+					!std::is_same<
+						typename find_multi_call_match<
+							typename sum_type_combination<I,0,Ss...>::type,
+							Fs...
+						>::type,
+						_dtl::no
+					>::value...
+				),
+				"Match expressions must be exhaustive"
+			);
+
+			using type = typename std::common_type<
+				typename find_multi_call_match<
+					typename sum_type_combination<I,0,Ss...>::type, Fs...
+				>::type...
+			>::type;
+		};
+
+		template<typename R>
+		struct multi_visitor {
+			template<
+				typename...As, size_t...P, typename F, typename...Fs,
+				typename = typename std::enable_if<
+					is_callable<F,As...>::value
+				>::type
+			>
+			static R visit(
+					const std::tuple<As...>& as, seq<P...>, F&& f, Fs&&...
+			) {
+				return std::forward<F>(f)(std::get<P>(as)...);
+			}
+
+			template<
+				typename F, typename...As, size_t...P, typename...Fs,
+				typename = typename std::enable_if<
+					!is_callable<F,As...>::value
+				>::type
+			>
+			static R visit(
+					const std::tuple<As...>& as, seq<P...> p, F&&, Fs&&...fs
+			) {
+				return multi_visitor::visit(as, p, std::forward<Fs>(fs)...);
+			}
+		};
+
+		// Table of every combination of active elements of the sum types Ss
+		template<typename R, typename, typename...Ss>
+		struct multi_match_table;
+
+		template<typename R, size_t...I, typename...Ss>
+		struct multi_match_table<R,seq<I...>,Ss...> {
+			template<size_t K, typename...Fs>
+			static R visit_at(const std::tuple<Ss&...>& sts, Fs&&...fs) {
+				return multi_visitor<R>::visit(
+					sum_type_combination<K,0,Ss...>::refs(sts),
+					gen_seq<0,sizeof...(Ss)-1>{},
+					std::forward<Fs>(fs)...
+				);
+			}
+
+			template<typename...Fs>
+			static R visit(
+					size_t i, const std::tuple<Ss&...>& sts, Fs&&...fs
+			) {
+				static constexpr R (*table[])(
+					const std::tuple<Ss&...>&, Fs&&...
+				) = {
+					&visit_at<I,Fs...>...
+				};
+
+				return table[i](sts, std::forward<Fs>(fs)...);
+			}
+		};
+
+		template<typename...Ss>
+		class multi_matcher {
+		public:
+			explicit multi_matcher(Ss&...ss) noexcept : sts(ss...) {}
+
+			template<typename...Fs>
+			auto operator() (Fs&&...fs) const -> typename multi_match_type<
+				gen_seq<0,sum_type_sizes<Ss...>::value-1>,
+				type_seq<Ss...>,
+				type_seq<Fs...>
+			>::type {
+				using indices = gen_seq<0,sum_type_sizes<Ss...>::value-1>;
+				using return_type = typename multi_match_type<
+					indices, type_seq<Ss...>, type_seq<Fs...>
+				>::type;
+
+				return multi_match_table<return_type,indices,Ss...>::visit(
+					index(sts, gen_seq<0,sizeof...(Ss)-1>{}),
+					sts,
+					std::forward<Fs>(fs)...
+				);
+			}
+
+		private:
+			template<size_t...P>
+			static size_t index(const std::tuple<Ss&...>& t, seq<P...>) {
+				return flat_index(
+					0,
+					std::pair<size_t,size_t>(
+						sum_type_accessor::activeIndex(std::get<P>(t)),
+						sum_type_size<Ss>::value
+					)...
+				);
+			}
+
+			static constexpr size_t flat_index(size_t acc) noexcept {
+				return acc;
+			}
+
+			// Active indices, most significant first, as one number
+			template<typename...Ps>
+			static constexpr size_t flat_index(
+					size_t acc, std::pair<size_t,size_t> d, Ps...ds
+			) noexcept {
+				return flat_index(acc * d.second + d.first, ds...);
+			}
+
+			std::tuple<Ss&...> sts;
+		};
+	}
+
+	/**
+	 * Pattern match on several sum types at once.
+	 *
+	 * Returns a function object that takes the case clauses. Each clause
+	 * takes one argument per sum type, and the first clause callable with
+	 * the active elements is invoked. As with sum_type::match, the clauses
+	 * must be exhaustive, and `otherwise` matches anything.
+	 *
+	 * Rather than nesting one match per sum type, the combination of
+	 * active elements is looked up in a single table.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   either<E,int> a = ..., b = ...;
+	 *
+	 *   auto sum = match(a, b)(
+	 *       [](Right<int> x, Right<int> y){ return *x + *y; },
+	 *       [](otherwise, otherwise){ return 0; }
+	 *   );
+	 * \endcode
+	 *
+	 * \ingroup sum_type
+	 */
+	template<typename S, typename...Ss>
+#ifndef DOCUMENTATION_GENERATOR
+	_dtl::multi_matcher<S,Ss...>
+#else
+	ImplementationDefined
+#endif
+	match(S& s, Ss&...ss) noexcept {
+		return _dtl::multi_matcher<S,Ss...>(s, ss...);
+	}
+
 	template<
 			typename...Ts,
 			typename = typename std::enable_if<All<Eq,Ts...>{}>::type
 	>
-	bool operator== (const sum_type<Ts...>& a, const sum_type<Ts...>& b) {
-		size_t i1 = ::ftl::_dtl::sum_type_accessor::activeIndex(a);
-		size_t i2 = ::ftl::_dtl::sum_type_accessor::activeIndex(b);
-
-		return i1 == i2 && ::ftl::_dtl::sum_type_accessor::compareAt(i1, a, b);
+	constexpr bool operator== (
+			const sum_type<Ts...>& a, const sum_type<Ts...>& b
+	) {
+		return ::ftl::_dtl::sum_type_accessor::activeIndex(a)
+			== ::ftl::_dtl::sum_type_accessor::activeIndex(b)
+			&& ::ftl::_dtl::sum_type_accessor::compareAt(
+				::ftl::_dtl::sum_type_accessor::activeIndex(a), a, b
+			);
 	}
 
 	template<typename...Ts>
-	bool operator!= (const sum_type<Ts...>& a, const sum_type<Ts...>& b) {
+	constexpr bool operator!= (
+			const sum_type<Ts...>& a, const sum_type<Ts...>& b
+	) {
 		return !(a == b);
 	}
 }
 
+namespace std {
+	/**
+	 * Hash of a sum type, if all of its alternatives are hashable.
+	 *
+	 * Combines the index of the active alternative with its `std::hash`,
+	 * dispatching on the index the same way `match` does. Sum types that
+	 * compare equal thus hash equal, and an alternative hashes differently
+	 * from another one holding the same value, e.g. a `Left<int>` and a
+	 * `Right<int>`.
+	 *
+	 * \ingroup sum_type
+	 */
+	template<typename...Ts>
+	struct hash<ftl::sum_type<Ts...>> {
+		size_t operator() (const ftl::sum_type<Ts...>& s) const {
+			return ::ftl::_dtl::sum_type_accessor::hash(s);
+		}
+	};
+}
+
 #endif
 
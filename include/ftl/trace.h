@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_TRACE_H
+#define FTL_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ftl {
+	/**
+	 * \defgroup trace Tracing
+	 *
+	 * Opt-in begin and end events for lazy forcing and asynchronous work.
+	 *
+	 * When `FTL_TRACE` is defined, forcing an `ftl::lazy`, running a task
+	 * started by `ftl::async`, running a future's continuation and running a
+	 * task on one of the thread pools each report a begin event and an end
+	 * event to the installed trace sink, if there is one. Otherwise the hooks
+	 * expand to nothing and labels are not stored at all.
+	 *
+	 * Lazy values and async tasks may be given a label, using the
+	 * `ftl::trace_label` overloads of `lazy`'s constructor, `ftl::defer` and
+	 * `ftl::async`, which names their events.
+	 *
+	 * Like `FTL_INSTRUMENT_ALLOCATIONS`, the macro must be defined the same
+	 * way in every translation unit of a program.
+	 *
+	 * \code
+	 *   #include <ftl/trace.h>
+	 * \endcode
+	 *
+	 * \par Examples
+	 *
+	 * Recording a trace that can be opened with `chrome://tracing` or
+	 * Perfetto:
+	 * \code
+	 *   ftl::chrome_trace trace;
+	 *   trace.install();
+	 *
+	 *   auto l = ftl::lazy<int>(ftl::trace_label{"answer"}, [](){ return 42; });
+	 *   use(*l);
+	 *
+	 *   ftl::set_trace_sink(nullptr);
+	 *   std::ofstream out("trace.json");
+	 *   trace.write(out);
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<atomic>`
+	 * - `<chrono>`
+	 * - `<cstddef>`
+	 * - `<cstdint>`
+	 * - `<mutex>`
+	 * - `<thread>`
+	 * - `<vector>`
+	 */
+
+	/**
+	 * The kinds of work events are reported for.
+	 *
+	 * \ingroup trace
+	 */
+	enum class trace_source : unsigned char {
+		/// Forcing of an `ftl::lazy`
+		lazy,
+		/// A task started by `ftl::async`
+		async,
+		/// A continuation of an `ftl::future`, as added by `map` and friends
+		continuation,
+		/// A task run by `ftl::thread_pool` or `ftl::work_stealing_pool`
+		executor
+	};
+
+	/**
+	 * Human readable name of a trace source.
+	 *
+	 * \ingroup trace
+	 */
+	inline const char* trace_source_name(trace_source s) noexcept {
+		static const char* const names[] = {
+			"lazy", "async", "continuation", "executor"
+		};
+
+		return names[static_cast<std::size_t>(s)];
+	}
+
+	/**
+	 * Whether an event marks the start or the end of some work.
+	 *
+	 * \ingroup trace
+	 */
+	enum class trace_phase : unsigned char {
+		begin,
+		end
+	};
+
+	/**
+	 * User supplied name of a lazy value or an async task.
+	 *
+	 * `name` is not copied, and must outlive any trace it appears in;
+	 * string literals are the typical choice.
+	 *
+	 * \ingroup trace
+	 */
+	struct trace_label {
+		const char* name;
+	};
+
+	/**
+	 * Whether trace events are emitted in this build.
+	 *
+	 * \ingroup trace
+	 */
+#ifdef FTL_TRACE
+	constexpr bool tracing = true;
+#else
+	constexpr bool tracing = false;
+#endif
+
+	/**
+	 * A single begin or end event.
+	 *
+	 * `label` is null for work that was not given a trace_label.
+	 *
+	 * \ingroup trace
+	 */
+	struct trace_event {
+		trace_source source;
+		trace_phase phase;
+		const char* label;
+		std::thread::id thread;
+		std::chrono::steady_clock::time_point time;
+	};
+
+	/**
+	 * Function receiving trace events.
+	 *
+	 * Called on whichever thread the work is done, concurrently if need be,
+	 * with the context given to `set_trace_sink`. Must not throw.
+	 *
+	 * \ingroup trace
+	 */
+	using trace_sink = void (*)(const trace_event&, void*);
+
+	namespace _dtl {
+		struct trace_hook {
+			std::atomic<trace_sink> sink;
+			std::atomic<void*> context;
+		};
+
+		inline trace_hook& current_trace_hook() noexcept {
+			static trace_hook h{{nullptr}, {nullptr}};
+			return h;
+		}
+
+		/*
+		 * Reports the begin event of some work on construction, and its end
+		 * event on destruction.
+		 *
+		 * Both go to the sink installed when the work began, so that events
+		 * always come in pairs.
+		 */
+		class trace_scope {
+		public:
+			trace_scope(trace_source s, const char* label) noexcept
+			: source(s), label(label) {
+				auto& h = current_trace_hook();
+				sink = h.sink.load(std::memory_order_acquire);
+				if(sink) {
+					context = h.context.load(std::memory_order_relaxed);
+					emit(trace_phase::begin);
+				}
+			}
+
+			trace_scope(const trace_scope&) = delete;
+			trace_scope& operator= (const trace_scope&) = delete;
+
+			~trace_scope() {
+				if(sink)
+					emit(trace_phase::end);
+			}
+
+		private:
+			void emit(trace_phase p) noexcept {
+				sink(trace_event{
+					source, p, label,
+					std::this_thread::get_id(), std::chrono::steady_clock::now()
+				}, context);
+			}
+
+			trace_source source;
+			const char* label;
+			trace_sink sink;
+			void* context = nullptr;
+		};
+
+		/*
+		 * Label stored with a task when tracing, and nothing otherwise.
+		 *
+		 * Meant to be inherited from, so that it takes no space when empty.
+		 */
+#ifdef FTL_TRACE
+		class trace_name {
+		public:
+			trace_name() noexcept = default;
+			explicit trace_name(trace_label l) noexcept : label(l.name) {}
+
+			const char* name() const noexcept {
+				return label;
+			}
+
+		private:
+			const char* label = nullptr;
+		};
+#else
+		struct trace_name {
+			trace_name() noexcept = default;
+			explicit trace_name(trace_label) noexcept {}
+
+			const char* name() const noexcept {
+				return nullptr;
+			}
+		};
+#endif
+	}
+
+	/**
+	 * Install `sink` as the receiver of all trace events.
+	 *
+	 * Passing a null sink stops tracing. Work already in progress reports
+	 * its end event to the sink that received its begin event, so the old
+	 * sink and its `context` must outlive any such work. The sink should
+	 * not be replaced while traced work is starting on other threads.
+	 *
+	 * Has no effect on a build without `FTL_TRACE`.
+	 *
+	 * \ingroup trace
+	 */
+	inline void set_trace_sink(trace_sink sink, void* context = nullptr) noexcept {
+		auto& h = _dtl::current_trace_hook();
+		h.context.store(context, std::memory_order_relaxed);
+		h.sink.store(sink, std::memory_order_release);
+	}
+
+	/**
+	 * Trace sink recording events in the Chrome trace event format.
+	 *
+	 * The written JSON can be loaded by `chrome://tracing` and by
+	 * Perfetto's UI. Events are named after their label, or their source
+	 * if they have none; timestamps are relative to the construction of
+	 * the recorder, and threads are numbered in order of appearance.
+	 *
+	 * \ingroup trace
+	 */
+	class chrome_trace {
+	public:
+		chrome_trace() : origin(std::chrono::steady_clock::now()) {}
+
+		chrome_trace(const chrome_trace&) = delete;
+		chrome_trace& operator= (const chrome_trace&) = delete;
+
+		/// Make this recorder the trace sink.
+		void install() noexcept {
+			set_trace_sink(&chrome_trace::record, this);
+		}
+
+		/// The trace_sink that adds an event to the chrome_trace at `self`.
+		static void record(const trace_event& e, void* self) noexcept {
+			auto t = static_cast<chrome_trace*>(self);
+			std::lock_guard<std::mutex> lock(t->m);
+
+			try {
+				t->recorded.push_back(e);
+			}
+			catch(...) {
+				// Out of memory; the event is lost
+			}
+		}
+
+		/// Copy of the events recorded so far, in order of arrival.
+		std::vector<trace_event> events() const {
+			std::lock_guard<std::mutex> lock(m);
+			return recorded;
+		}
+
+		/// Forget all events recorded so far.
+		void clear() {
+			std::lock_guard<std::mutex> lock(m);
+			recorded.clear();
+		}
+
+		/**
+		 * Write the recorded events as a JSON trace to a stream.
+		 *
+		 * \tparam OStream any type with `std::ostream`'s `operator<<`
+		 */
+		template<typename OStream>
+		OStream& write(OStream& os) const {
+			auto es = events();
+			std::vector<std::thread::id> threads;
+
+			os << "{\"traceEvents\":[";
+			for(std::size_t i = 0; i < es.size(); ++i) {
+				auto& e = es[i];
+				auto d = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					e.time - origin
+				).count();
+				auto ns = static_cast<std::uint64_t>(d < 0 ? 0 : d);
+
+				if(i > 0)
+					os << ',';
+
+				os << "\n{\"name\":\"";
+				write_escaped(os, e.label ? e.label : trace_source_name(e.source));
+				os << "\",\"cat\":\"" << trace_source_name(e.source)
+					<< "\",\"ph\":\"" << (e.phase == trace_phase::begin ? 'B' : 'E')
+					<< "\",\"ts\":" << ns / 1000 << '.'
+					<< char('0' + ns / 100 % 10)
+					<< char('0' + ns / 10 % 10)
+					<< char('0' + ns % 10)
+					<< ",\"pid\":1,\"tid\":" << thread_number(threads, e.thread)
+					<< '}';
+			}
+
+			os << "\n]}\n";
+			return os;
+		}
+
+	private:
+		static std::size_t thread_number(
+				std::vector<std::thread::id>& ts, std::thread::id t) {
+			for(std::size_t i = 0; i < ts.size(); ++i) {
+				if(ts[i] == t)
+					return i;
+			}
+
+			ts.push_back(t);
+			return ts.size() - 1;
+		}
+
+		template<typename OStream>
+		static void write_escaped(OStream& os, const char* s) {
+			static const char hex[] = "0123456789abcdef";
+
+			for(; *s; ++s) {
+				auto c = static_cast<unsigned char>(*s);
+				if(c == '"' || c == '\\')
+					os << '\\' << char(c);
+				else if(c < 0x20)
+					os << "\\u00" << hex[c >> 4] << hex[c & 15];
+				else
+					os << char(c);
+			}
+		}
+
+		std::chrono::steady_clock::time_point origin;
+		mutable std::mutex m;
+		std::vector<trace_event> recorded;
+	};
+}
+
+/**
+ * Report the begin and end of the enclosing scope as work of `source`.
+ *
+ * `source` is the name of an ftl::trace_source value, and `label` a
+ * possibly null string. Expands to nothing, without evaluating `label`,
+ * unless `FTL_TRACE` is defined.
+ *
+ * \ingroup trace
+ */
+#ifdef FTL_TRACE
+#define FTL_TRACE_SCOPE(source, label) \
+	::ftl::_dtl::trace_scope ftl_trace_scope_( \
+		::ftl::trace_source::source, (label))
+#else
+#define FTL_TRACE_SCOPE(source, label) ((void)0)
+#endif
+
+#endif
+
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_TRAMPOLINE_H
+#define FTL_TRAMPOLINE_H
+
+#include <memory>
+#include <vector>
+#include "function.h"
+#include "instrument.h"
+#include "concepts/monad.h"
+
+namespace ftl {
+	/**
+	 * \defgroup trampoline Trampoline
+	 *
+	 * Monadic computations that run in a loop, in constant stack space.
+	 *
+	 * \code
+	 *   #include <ftl/trampoline.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - <memory>
+	 * - <vector>
+	 * - \ref function
+	 * - \ref monad
+	 */
+
+	template<typename T>
+	class trampoline;
+
+	namespace _dtl {
+		struct tramp_node;
+
+		using tramp_ptr = std::shared_ptr<tramp_node>;
+		using tramp_box = std::shared_ptr<const void>;
+
+		/* A trampoline is a tree of steps, whose values are type erased so
+		 * that a single loop can run steps of any type. Binds record their
+		 * continuation instead of calling it, which is what keeps the stack
+		 * from growing with the depth of the computation.
+		 */
+		struct tramp_node {
+			enum class kind { done, suspend, bind };
+
+			explicit tramp_node(tramp_box v)
+			: k(kind::done), value(std::move(v)) {}
+
+			explicit tramp_node(function<tramp_ptr()> t)
+			: k(kind::suspend), thunk(std::move(t)) {}
+
+			tramp_node(tramp_ptr s, function<tramp_ptr(const tramp_box&)> c)
+			: k(kind::bind), sub(std::move(s)), cont(std::move(c)) {}
+
+			// Left nested chains would otherwise be destroyed recursively
+			~tramp_node() {
+				while(sub && sub.use_count() == 1) {
+					tramp_ptr next = std::move(sub->sub);
+					sub = std::move(next);
+				}
+			}
+
+			kind k;
+			tramp_box value;
+			function<tramp_ptr()> thunk;
+			tramp_ptr sub;
+			function<tramp_ptr(const tramp_box&)> cont;
+		};
+
+		inline tramp_box run_trampoline(tramp_ptr t) {
+			// Binds whose sub-computation is being run, innermost last
+			std::vector<tramp_ptr> binds;
+
+			for(;;) {
+				switch(t->k) {
+				case tramp_node::kind::done:
+					if(binds.empty())
+						return t->value;
+
+					{
+						auto b = std::move(binds.back());
+						binds.pop_back();
+						t = b->cont(t->value);
+					}
+					break;
+
+				case tramp_node::kind::suspend:
+					t = t->thunk();
+					break;
+
+				case tramp_node::kind::bind:
+					binds.push_back(t);
+					t = t->sub;
+					break;
+				}
+			}
+		}
+
+		struct tramp_access {
+			template<typename T>
+			static const tramp_ptr& node(const trampoline<T>& t) noexcept {
+				return t.node;
+			}
+
+			template<typename T>
+			static trampoline<T> make(tramp_ptr n) {
+				return trampoline<T>(std::move(n));
+			}
+		};
+
+		template<typename T>
+		tramp_ptr tramp_done(T&& t) {
+			FTL_COUNT_ALLOCATION(monad, sizeof(tramp_node));
+			FTL_COUNT_ALLOCATION(monad, sizeof(plain_type<T>));
+			return std::make_shared<tramp_node>(
+				tramp_box(std::make_shared<plain_type<T>>(std::forward<T>(t)))
+			);
+		}
+
+		template<typename T>
+		const T& tramp_unbox(const tramp_box& b) noexcept {
+			return *static_cast<const T*>(b.get());
+		}
+
+		template<typename F>
+		struct tramp_suspend {
+			tramp_ptr operator() () const {
+				return tramp_access::node(f());
+			}
+
+			F f;
+		};
+
+		template<typename T, typename F>
+		struct tramp_bind {
+			tramp_ptr operator() (const tramp_box& b) const {
+				return tramp_access::node(f(tramp_unbox<T>(b)));
+			}
+
+			F f;
+		};
+
+		template<typename T, typename F>
+		struct tramp_map {
+			tramp_ptr operator() (const tramp_box& b) const {
+				return tramp_done(f(tramp_unbox<T>(b)));
+			}
+
+			F f;
+		};
+	}
+
+	/**
+	 * A computation that is run iteratively, in constant stack space.
+	 *
+	 * Trampolines are built from `done` values, `suspend`ed computations,
+	 * `map`, and `bind`. None of these run anything; `run` then evaluates
+	 * the whole computation in a loop, keeping its pending continuations
+	 * on the heap. Recursive definitions, where every recursive step is
+	 * suspended, can therefore be arbitrarily deep.
+	 *
+	 * Trampolines are immutable, cheap to copy, and may be run any number
+	 * of times. Each run evaluates the computation anew.
+	 *
+	 * \par Concepts
+	 * - \ref copycons
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 * - \ref monadpg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   ftl::trampoline<long> sum(long n) {
+	 *       using ftl::operator>>=;
+	 *       if(n == 0)
+	 *           return ftl::done(0L);
+	 *
+	 *       return ftl::suspend([n]{ return sum(n-1); })
+	 *           >>= [n](long s){ return ftl::done(s + n); };
+	 *   }
+	 *
+	 *   // No stack overflow
+	 *   auto s = sum(1000000).run();
+	 * \endcode
+	 *
+	 * \ingroup trampoline
+	 */
+	template<typename T>
+	class trampoline {
+	public:
+		using value_type = T;
+
+		trampoline(const trampoline&) = default;
+		trampoline(trampoline&&) = default;
+		trampoline& operator= (const trampoline&) = default;
+		trampoline& operator= (trampoline&&) = default;
+
+		/// Run the computation to its end, and get its result
+		T run() const {
+			return _dtl::tramp_unbox<T>(_dtl::run_trampoline(node));
+		}
+
+	private:
+		friend struct _dtl::tramp_access;
+
+		explicit trampoline(_dtl::tramp_ptr n) : node(std::move(n)) {}
+
+		_dtl::tramp_ptr node;
+	};
+
+	/**
+	 * A trampoline that is already finished, with result `t`.
+	 *
+	 * \ingroup trampoline
+	 */
+	template<typename T, typename T_ = plain_type<T>>
+	trampoline<T_> done(T&& t) {
+		return _dtl::tramp_access::make<T_>(_dtl::tramp_done(std::forward<T>(t)));
+	}
+
+	/**
+	 * Suspend a computation until the trampoline is run.
+	 *
+	 * `f` must take no arguments and return a `trampoline`. It is typically
+	 * the recursive step of a definition.
+	 *
+	 * \ingroup trampoline
+	 */
+	template<
+			typename F,
+			typename F_ = plain_type<F>,
+			typename T = Value_type<result_of<F_()>>
+	>
+	trampoline<T> suspend(F&& f) {
+		FTL_COUNT_ALLOCATION(monad, sizeof(_dtl::tramp_node));
+		return _dtl::tramp_access::make<T>(
+			std::make_shared<_dtl::tramp_node>(
+				function<_dtl::tramp_ptr()>(
+					_dtl::tramp_suspend<F_>{std::forward<F>(f)}
+				)
+			)
+		);
+	}
+
+	/**
+	 * Monad instance of trampolines.
+	 *
+	 * `bind` appends to the computation, and is itself constant time, no
+	 * matter how the binds are nested.
+	 *
+	 * \ingroup trampoline
+	 */
+	template<typename T>
+	struct monad<trampoline<T>>
+	: deriving_join<in_terms_of_bind<trampoline<T>>>
+	, deriving_apply<in_terms_of_bind<trampoline<T>>> {
+
+		static trampoline<T> pure(T t) {
+			return done(std::move(t));
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static trampoline<U> map(F f, const trampoline<T>& t) {
+			return bind_node<U>(t, _dtl::tramp_map<T,F>{std::move(f)});
+		}
+
+		template<typename F, typename U = Value_type<result_of<F(T)>>>
+		static trampoline<U> bind(const trampoline<T>& t, F f) {
+			return bind_node<U>(t, _dtl::tramp_bind<T,F>{std::move(f)});
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		template<typename U, typename C>
+		static trampoline<U> bind_node(const trampoline<T>& t, C c) {
+			FTL_COUNT_ALLOCATION(monad, sizeof(_dtl::tramp_node));
+			return _dtl::tramp_access::make<U>(
+				std::make_shared<_dtl::tramp_node>(
+					_dtl::tramp_access::node(t),
+					function<_dtl::tramp_ptr(const _dtl::tramp_box&)>(
+						std::move(c)
+					)
+				)
+			);
+		}
+	};
+}
+
+#endif
@@ -23,9 +23,12 @@
 #ifndef FTL_TUPLE_H
 #define FTL_TUPLE_H
 
+#include <functional>
 #include <tuple>
+#include <utility>
 #include "concepts/monoid.h"
 #include "concepts/monad.h"
+#include "implementation/mix_hash.h"
 
 namespace ftl {
 
@@ -39,7 +42,9 @@ namespace ftl {
 	 * \endcode
 	 *
 	 * \par Dependencies
+	 * - <functional>
 	 * - <tuple>
+	 * - <utility>
 	 * - \ref monoid
 	 * - \ref monad
 	 */
@@ -49,9 +54,19 @@ namespace ftl {
 
 		template<std::size_t N, typename T>
 		struct tup {
-			static void app(T& ret, const T& t2) {
-				tup<N-1, T>::app(ret, t2);
-				std::get<N>(ret) = std::get<N>(ret) ^ std::get<N>(t2);
+			// Appends each element of t2 to that of ret, moving from t2 if
+			// it is an rvalue
+			template<typename U>
+			static void app(T& ret, U&& t2) {
+				tup<N-1, T>::app(ret, std::forward<U>(t2));
+				std::get<N>(ret) = std::move(std::get<N>(ret))
+					^ std::get<N>(std::forward<U>(t2));
+			}
+
+			// Prepends each element of t1 to that of ret
+			static void prep(const T& t1, T& ret) {
+				tup<N-1, T>::prep(t1, ret);
+				std::get<N>(ret) = std::get<N>(t1) ^ std::move(std::get<N>(ret));
 			}
 
 			template<typename F, typename O>
@@ -69,8 +84,14 @@ namespace ftl {
 
 		template<typename T>
 		struct tup<0, T> {
-			static void app(T& ret, const T& t2) {
-				std::get<0>(ret) = std::get<0>(ret) ^ std::get<0>(t2);
+			template<typename U>
+			static void app(T& ret, U&& t2) {
+				std::get<0>(ret) = std::move(std::get<0>(ret))
+					^ std::get<0>(std::forward<U>(t2));
+			}
+
+			static void prep(const T& t1, T& ret) {
+				std::get<0>(ret) = std::get<0>(t1) ^ std::move(std::get<0>(ret));
 			}
 
 			template<typename F, typename O>
@@ -132,6 +153,17 @@ namespace ftl {
 				= monoid<T>::instance && allMonoids<Ts...>::value;
 		};
 
+		template<typename...>
+		struct allCommutative {
+			static constexpr bool value = true;
+		};
+
+		template<typename T, typename...Ts>
+		struct allCommutative<T,Ts...> {
+			static constexpr bool value
+				= CommutativeMonoid<T>::value && allCommutative<Ts...>::value;
+		};
+
 	}
 
 	/**
@@ -163,6 +195,10 @@ namespace ftl {
 	 *       std::get<N>(tuple1) ^ std::get<N>(tuple2))
 	 * \endcode
 	 *
+	 * Whichever of the tuples is an rvalue is appended to in place, and has
+	 * its elements moved into the result, so large elements such as maps are
+	 * not copied for every append of a fold.
+	 *
 	 * \tparam Ts Each of the types must be an instance of \ref monoid.
 	 *
 	 * \ingroup tuple
@@ -188,6 +224,52 @@ namespace ftl {
 			return ret;
 		}
 
+		/**
+		 * \overload
+		 *
+		 * Each element of `t1` is appended to in place, by way of the
+		 * rvalue `append` of its monoid.
+		 */
+		static auto append(
+				std::tuple<Ts...>&& t1,
+				const std::tuple<Ts...>& t2)
+		-> typename std::enable_if<
+				_dtl::allMonoids<Ts...>::value,
+				std::tuple<Ts...>>::type {
+
+			_dtl::tup<sizeof...(Ts)-1, std::tuple<Ts...>>::app(t1, t2);
+			return std::move(t1);
+		}
+
+		/// \overload
+		static auto append(
+				const std::tuple<Ts...>& t1,
+				std::tuple<Ts...>&& t2)
+		-> typename std::enable_if<
+				_dtl::allMonoids<Ts...>::value,
+				std::tuple<Ts...>>::type {
+
+			_dtl::tup<sizeof...(Ts)-1, std::tuple<Ts...>>::prep(t1, t2);
+			return std::move(t2);
+		}
+
+		/// \overload
+		static auto append(
+				std::tuple<Ts...>&& t1,
+				std::tuple<Ts...>&& t2)
+		-> typename std::enable_if<
+				_dtl::allMonoids<Ts...>::value,
+				std::tuple<Ts...>>::type {
+
+			_dtl::tup<sizeof...(Ts)-1, std::tuple<Ts...>>::app(
+				t1, std::move(t2)
+			);
+			return std::move(t1);
+		}
+
+		static constexpr bool commutative
+			= _dtl::allCommutative<Ts...>::value;
+
 		static constexpr bool instance = _dtl::allMonoids<Ts...>::value;
 	};
 
@@ -283,6 +365,70 @@ namespace ftl {
 		static constexpr bool instance = true;
 	};
 
+	namespace _dtl {
+		template<typename T>
+		std::size_t hash_value(const T& t) {
+			return std::hash<T>()(t);
+		}
+
+		template<typename...Ts>
+		std::size_t hash_value(const std::tuple<Ts...>& t);
+
+		template<typename A, typename B>
+		std::size_t hash_value(const std::pair<A,B>& p) {
+			return hash_combine(
+				hash_combine(2, hash_value(p.first)), hash_value(p.second)
+			);
+		}
+
+		template<std::size_t I, std::size_t N>
+		struct hash_elements {
+			template<typename...Ts>
+			static std::size_t apply(const std::tuple<Ts...>& t, std::size_t h) {
+				return hash_elements<I+1,N>::apply(
+					t, hash_combine(h, hash_value(std::get<I>(t)))
+				);
+			}
+		};
+
+		template<std::size_t N>
+		struct hash_elements<N,N> {
+			template<typename...Ts>
+			static std::size_t apply(const std::tuple<Ts...>&, std::size_t h) {
+				return h;
+			}
+		};
+
+		template<typename...Ts>
+		std::size_t hash_value(const std::tuple<Ts...>& t) {
+			return hash_elements<0,sizeof...(Ts)>::apply(t, sizeof...(Ts));
+		}
+	}
+
+	/**
+	 * Hash function object for tuples and pairs.
+	 *
+	 * Combines the `std::hash` of every element, in order, mixing the bits
+	 * after each one. Elements that are themselves tuples or pairs are
+	 * hashed the same way. Since `std::hash` may not be specialised for
+	 * `std::tuple`, pass this as the hasher of containers keyed on them:
+	 * \code
+	 *   std::unordered_map<std::tuple<int,std::string>,V,ftl::tuple_hash> m;
+	 * \endcode
+	 *
+	 * \ingroup tuple
+	 */
+	struct tuple_hash {
+		template<typename...Ts>
+		std::size_t operator() (const std::tuple<Ts...>& t) const {
+			return _dtl::hash_value(t);
+		}
+
+		template<typename A, typename B>
+		std::size_t operator() (const std::pair<A,B>& p) const {
+			return _dtl::hash_value(p);
+		}
+	};
 }
 
 #endif
@@ -234,58 +234,195 @@ namespace ftl {
 	template<typename T, typename TSeq>
 	using prepend_type = typename _dtl::prepend_type_impl<T,TSeq>::type;
 
+	/**
+	 * A number sequence.
+	 *
+	 * \ingroup typelevel
+	 */
+	template<size_t...> struct seq {};
+
+	/*
+	 * Whatever builtins the compiler offers to generate integer sequences or
+	 * index type packs are used instead of recursive templates.
+	 */
+#ifdef __has_builtin
+#	if __has_builtin(__make_integer_seq)
+#		define FTL_HAS_MAKE_INTEGER_SEQ
+#	elif __has_builtin(__integer_pack)
+#		define FTL_HAS_INTEGER_PACK
+#	endif
+#	if __has_builtin(__type_pack_element)
+#		define FTL_HAS_TYPE_PACK_ELEMENT
+#	endif
+#endif
+
 	namespace _dtl {
-		template<template<typename> class F, typename...Ts>
-		struct map_types_impl;
+		/*
+		 * seq<0,...,N-1>, also for N == 0.
+		 *
+		 * Without builtins, the sequence is the concatenation of two of half
+		 * the length, so generating it takes O(log N) levels of
+		 * instantiation rather than O(N).
+		 */
+#if defined(FTL_HAS_MAKE_INTEGER_SEQ)
+		template<typename T, T...I>
+		struct integer_seq_to_seq {
+			using type = seq<I...>;
+		};
 
-		template<template<typename> class F>
-		struct map_types_impl<F> {
-			using type = type_seq<>;
+		template<size_t N>
+		using make_index_seq =
+			typename __make_integer_seq<integer_seq_to_seq,size_t,N>::type;
+#elif defined(FTL_HAS_INTEGER_PACK)
+		template<size_t N>
+		using make_index_seq = seq<__integer_pack(N)...>;
+#else
+		template<typename, typename>
+		struct double_seq;
+
+		template<size_t...I, size_t...J>
+		struct double_seq<seq<I...>,seq<J...>> {
+			using type = seq<I..., (sizeof...(I) + J)...>;
 		};
 
-		template<template<typename> class F, typename T, typename...Ts>
-		struct map_types_impl<F,T,Ts...> {
-			using type =
-				prepend_type<
-					typename F<T>::type,
-					typename map_types_impl<F,Ts...>::type
-				>;
+		template<size_t N>
+		struct make_index_seq_impl : double_seq<
+			typename make_index_seq_impl<N/2>::type,
+			typename make_index_seq_impl<N - N/2>::type
+		> {};
+
+		template<>
+		struct make_index_seq_impl<0> {
+			using type = seq<>;
 		};
 
-		template<template<typename> class F, typename...Ts>
-		struct map_types_impl<F,type_seq<Ts...>> {
-			using type = typename map_types_impl<F,Ts...>::type;
+		template<>
+		struct make_index_seq_impl<1> {
+			using type = seq<0>;
 		};
 
-		template<template<typename,typename> class F, typename L1, typename L2>
-		struct zip_types_impl;
+		template<size_t N>
+		using make_index_seq = typename make_index_seq_impl<N>::type;
+#endif
 
-		template<template<typename,typename> class F>
-		struct zip_types_impl<F,type_seq<>,type_seq<>> {
-			using type = type_seq<>;
+		template<size_t Z, typename S>
+		struct offset_seq;
+
+		template<size_t Z, size_t...I>
+		struct offset_seq<Z,seq<I...>> {
+			using type = seq<(Z + I)...>;
 		};
 
-		template<template<typename,typename> class F, typename U, typename...Us>
-		struct zip_types_impl<F,type_seq<>,type_seq<U,Us...>> {
-			using type = type_seq<>;
+		template<typename T>
+		struct type_tag {
+			using type = T;
 		};
 
-		template<template<typename,typename> class F, typename T, typename...Ts>
-		struct zip_types_impl<F,type_seq<T,Ts...>,type_seq<>> {
-			using type = type_seq<>;
+		/*
+		 * Indexing into a pack in O(1) instantiations: a class deriving from
+		 * one indexed_type per element is built once per pack, after which
+		 * the type at I is deduced from the one base that has that index.
+		 */
+		template<size_t I, typename T>
+		struct indexed_type {};
+
+		template<typename, typename...>
+		struct indexed_types;
+
+		template<size_t...I, typename...Ts>
+		struct indexed_types<seq<I...>,Ts...> : indexed_type<I,Ts>... {};
+
+		template<size_t I, typename T>
+		type_tag<T> type_at_index(const indexed_type<I,T>*);
+
+#ifdef FTL_HAS_TYPE_PACK_ELEMENT
+		template<size_t I, typename...Ts>
+		struct type_at_impl {
+			using type = __type_pack_element<I,Ts...>;
+		};
+#else
+		template<size_t I, typename...Ts>
+		struct type_at_impl {
+			using type = typename decltype(type_at_index<I>(
+				static_cast<
+					indexed_types<make_index_seq<sizeof...(Ts)>,Ts...>*
+				>(nullptr)
+			))::type;
+		};
+#endif
+
+		template<typename S, typename...Ts>
+		struct select_types;
+
+		template<size_t...I, typename...Ts>
+		struct select_types<seq<I...>,Ts...> {
+			using type = type_seq<typename type_at_impl<I,Ts...>::type...>;
+		};
+
+		template<size_t>
+		struct any_pointer {
+			using type = const volatile void*;
+		};
+
+		/*
+		 * Drops sizeof...(I) types from a pack in one overload resolution:
+		 * its leading parameters accept anything, the rest are deduced.
+		 */
+		template<typename>
+		struct type_dropper;
+
+		template<size_t...I>
+		struct type_dropper<seq<I...>> {
+			template<typename...Ts>
+			static type_seq<Ts...> drop(
+				typename any_pointer<I>::type..., type_tag<Ts>*...
+			);
+		};
+
+		template<template<typename> class F, typename...Ts>
+		struct map_types_impl {
+			using type = type_seq<typename F<Ts>::type...>;
+		};
+
+		template<template<typename> class F, typename...Ts>
+		struct map_types_impl<F,type_seq<Ts...>> {
+			using type = type_seq<typename F<Ts>::type...>;
 		};
 
 		template<
 				template<typename,typename> class F,
-				typename T, typename U,
-				typename...Ts, typename...Us
+				typename S, typename L1, typename L2
 		>
-		struct zip_types_impl<F,type_seq<T,Ts...>,type_seq<U,Us...>> {
-			using type = prepend_type<
-				typename F<T,U>::type,
-				typename zip_types_impl<F,type_seq<Ts...>,type_seq<Us...>>::type
-			>;
+		struct zip_types_at;
+
+		template<
+				template<typename,typename> class F,
+				size_t...I, typename...Ts, typename...Us
+		>
+		struct zip_types_at<F,seq<I...>,type_seq<Ts...>,type_seq<Us...>> {
+			using type = type_seq<typename F<
+				typename type_at_impl<I,Ts...>::type,
+				typename type_at_impl<I,Us...>::type
+			>::type...>;
 		};
+
+		template<template<typename,typename> class F, typename L1, typename L2>
+		struct zip_types_impl;
+
+		// The result is as long as the shorter of the two sequences
+		template<
+				template<typename,typename> class F,
+				typename...Ts, typename...Us
+		>
+		struct zip_types_impl<F,type_seq<Ts...>,type_seq<Us...>>
+		: zip_types_at<
+			F,
+			make_index_seq<
+				(sizeof...(Ts) < sizeof...(Us) ? sizeof...(Ts) : sizeof...(Us))
+			>,
+			type_seq<Ts...>,
+			type_seq<Us...>
+		> {};
 	}
 
 	/**
@@ -357,29 +494,46 @@ namespace ftl {
 	template<template<typename,typename> class F, typename Ts1, typename Ts2>
 	using zip_types = typename _dtl::zip_types_impl<F,Ts1,Ts2>::type;
 
-	template<size_t I, typename T, typename...Ts>
-	struct index_of_impl;
-
-	template<size_t I, typename T, typename...Ts>
-	struct index_of_impl<I,T,type_seq<T,Ts...>> {
-		static constexpr size_t value = I;
-	};
+	namespace _dtl {
+		// The first index in [lo,hi) where b is true, or hi, in O(log N)
+		// levels of recursion
+		constexpr size_t first_true(const bool* b, size_t lo, size_t hi);
+
+		constexpr size_t first_true_of(
+				size_t left, size_t mid, const bool* b, size_t hi) {
+			return left != mid ? left : first_true(b, mid, hi);
+		}
+
+		constexpr size_t first_true(const bool* b, size_t lo, size_t hi) {
+			return hi - lo <= 1
+				? (lo != hi && b[lo] ? lo : hi)
+				: first_true_of(
+					first_true(b, lo, lo + (hi - lo)/2),
+					lo + (hi - lo)/2, b, hi
+				);
+		}
 
-	template<size_t I, typename X, typename T, typename...Ts>
-	struct index_of_impl<I,X,type_seq<T,Ts...>> {
-		static constexpr size_t value
-			= index_of_impl<I+1,X,type_seq<Ts...>>::value;
-	};
+		template<typename T, typename...Ts>
+		struct index_of_impl {
+			static constexpr bool matches[] = {
+				std::is_same<T,Ts>::value..., false
+			};
+
+			static constexpr size_t value =
+				first_true(matches, 0, sizeof...(Ts));
+
+			static_assert(
+				value < sizeof...(Ts),
+				"The type is not among those searched"
+			);
+		};
 
-	template<size_t I, typename T, typename...Ts>
-	struct index_of_impl<I,T,T,Ts...> {
-		static constexpr size_t value = I;
-	};
+		template<typename T, typename...Ts>
+		constexpr bool index_of_impl<T,Ts...>::matches[];
 
-	template<size_t I, typename X, typename T, typename...Ts>
-	struct index_of_impl<I,X,T,Ts...> {
-		static constexpr size_t value = index_of_impl<I+1,X,Ts...>::value;
-	};
+		template<typename T, typename...Ts>
+		struct index_of_impl<T,type_seq<Ts...>> : index_of_impl<T,Ts...> {};
+	}
 
 	/**
 	 * Gets the index of a specific type in a pack or sequence.
@@ -408,15 +562,7 @@ namespace ftl {
 	 */
 	template<typename T, typename...Ts>
 	struct index_of {
-		static constexpr size_t value = index_of_impl<0,T,Ts...>::value;
-	};
-
-	template<size_t I, typename T, typename...Ts>
-	struct type_at_impl : type_at_impl<I-1,Ts...> {};
-
-	template<typename T, typename...Ts>
-	struct type_at_impl<0,T,Ts...> {
-		using type = T;
+		static constexpr size_t value = _dtl::index_of_impl<T,Ts...>::value;
 	};
 
 	/**
@@ -435,7 +581,7 @@ namespace ftl {
 	 * \ingroup typelevel
 	 */
 	template<size_t I, typename...Ts>
-	using type_at = typename type_at_impl<I,Ts...>::type;
+	using type_at = typename _dtl::type_at_impl<I,Ts...>::type;
 
 	/**
 	 * Concatenates two type_seqs.
@@ -497,20 +643,10 @@ namespace ftl {
 	 * \ingroup typelevel
 	 */
 	template<size_t N, typename T, typename...Ts>
-	struct get_nth : get_nth<N-1,Ts...> {};
+	struct get_nth : _dtl::type_at_impl<N,T,Ts...> {};
 
-	template<typename T, typename...Ts>
-	struct get_nth<0,T,Ts...> {
-		using type = T;
-	};
-
-	template<size_t N, typename T, typename...Ts>
-	struct get_nth<N,type_seq<T,Ts...>> : get_nth<N-1,type_seq<Ts...>> {};
-
-	template<typename T, typename...Ts>
-	struct get_nth<0,type_seq<T,Ts...>> {
-		using type = T;
-	};
+	template<size_t N, typename...Ts>
+	struct get_nth<N,type_seq<Ts...>> : _dtl::type_at_impl<N,Ts...> {};
 
 	/**
 	 * Get the final element in a type sequence
@@ -538,14 +674,8 @@ namespace ftl {
 	 * \ingroup typelevel
 	 */
 	template<size_t N, typename T, typename...Ts>
-	struct take_types : concat_type_seqs<
-						type_seq<T>,
-						typename take_types<N-1,Ts...>::type> {};
-
-	template<typename T, typename...Ts>
-	struct take_types<1,T,Ts...> {
-		using type = type_seq<T>;
-	};
+	struct take_types
+	: _dtl::select_types<_dtl::make_index_seq<N>,T,Ts...> {};
 
 	/**
 	 * Take all elements except the last one.
@@ -558,20 +688,9 @@ namespace ftl {
 	 *
 	 * \ingroup typelevel
 	 */
-	template<typename...Ts>
-	struct take_init {
-		using type = typename take_types<sizeof...(Ts)-1, Ts...>::type;
-	};
-
-	template<typename T>
-	struct take_init<T> {
-		using type = type_seq<>;
-	};
-
-	template<typename T, typename U>
-	struct take_init<T,U> {
-		using type = type_seq<T>;
-	};
+	template<typename T, typename...Ts>
+	struct take_init
+	: _dtl::select_types<_dtl::make_index_seq<sizeof...(Ts)>,T,Ts...> {};
 
 	/**
 	 * Drops a number of types from a type sequence.
@@ -590,19 +709,12 @@ namespace ftl {
 	 * \ingroup typelevel
 	 */
 	template<size_t N, typename...Ts>
-	struct drop_types {};
-
-	template<size_t N, typename T, typename...Ts>
-	struct drop_types<N,T,Ts...> : drop_types<N-1, Ts...> {};
-
-	template<typename T, typename...Ts>
-	struct drop_types<0,T,Ts...> {
-		using type = type_seq<T,Ts...>;
-	};
-
-	template<size_t N>
-	struct drop_types<N> {
-		using type = type_seq<>;
+	struct drop_types {
+		using type = decltype(
+			_dtl::type_dropper<_dtl::make_index_seq<
+				(N < sizeof...(Ts) ? N : sizeof...(Ts))
+			>>::drop(static_cast<_dtl::type_tag<Ts>*>(nullptr)...)
+		);
 	};
 
 	template<template<typename...> class To, typename From>
@@ -616,23 +728,6 @@ namespace ftl {
 		using type = To<Ts...>;
 	};
 
-	/**
-	 * A number sequence.
-	 *
-	 * \ingroup typelevel
-	 */
-	template<size_t...> struct seq {};
-
-	namespace _dtl {
-		template<size_t Z, size_t N, size_t...S>
-		struct gen_seq_impl : gen_seq_impl<Z,N-1,N,S...> {};
-
-		template<size_t Z, size_t...S>
-		struct gen_seq_impl<Z,Z,S...> {
-			using type = seq<Z,S...>;
-		};
-	}
-
 	/**
 	 * Generate a sequence of numbers.
 	 *
@@ -648,7 +743,9 @@ namespace ftl {
 	 * \ingroup typelevel
 	 */
 	template<size_t Z, size_t N>
-	using gen_seq = typename ::ftl::_dtl::gen_seq_impl<Z,N>::type;
+	using gen_seq = typename ::ftl::_dtl::offset_seq<
+		Z, ::ftl::_dtl::make_index_seq<N - Z + 1>
+	>::type;
 
 	/**
 	 * Find the first contained type of some parametrised type.
@@ -839,6 +936,16 @@ namespace ftl {
 		static constexpr bool value = std::is_same<T<Ts...>, U<Ts...>>::value;
 	};
 
+	template<
+			template<typename,size_t> class T,
+	   		template<typename,size_t> class U,
+			typename A, typename B,
+			size_t N, size_t M
+	>
+	struct is_same_template<T<A,N>,U<B,M>> {
+		static constexpr bool value = std::is_same<T<A,N>, U<A,N>>::value;
+	};
+
 }
 
 #endif
@@ -26,6 +26,7 @@
 #include <utility>
 #include <iterator>
 #include <functional>
+#include "implementation/function_fwd.h"
 
 #define FTL_GEN_PREUNOP_TEST(op, name)\
 	template<typename T>\
@@ -132,6 +133,15 @@ namespace ftl {
 		FTL_GEN_BINOP_TEST(<, lt);
 		FTL_GEN_BINOP_TEST(<, gt);
 
+		/* Lets begin and end find both std::begin and functions found by ADL,
+		 * even for types that have nothing to do with namespace std.
+		 */
+		using std::begin;
+		using std::end;
+
+		template<typename T>
+		using begin_type = decltype(begin(std::declval<T>()));
+
 		FTL_GEN_UNFN_TEST(begin, begin);
 		FTL_GEN_METH0_TEST(rbegin);
 		FTL_GEN_UNFN_TEST(end, end);
@@ -431,9 +441,6 @@ namespace ftl {
 			>::value;
 	};
 
-	template<typename>
-	class function;
-
 	/**
 	 * Checks if a certain type is a monomorphic function object.
 	 *
@@ -462,8 +469,8 @@ namespace ftl {
 		static constexpr bool value = true;
 	};
 
-	template<typename R, typename...Args>
-	struct is_monomorphic<ftl::function<R(Args...)>> {
+	template<typename R, typename...Args, std::size_t N>
+	struct is_monomorphic<ftl::function<R(Args...),N>> {
 		static constexpr bool value = true;
 	};
 
@@ -71,6 +71,14 @@ namespace ftl {
 	/**
 	 * Functor instance for std::unordered_map.
 	 *
+	 * Mapped maps are built with the bucket count, maximum load factor, hash
+	 * function, key equality and allocator of the original. No rehashing
+	 * happens as they are filled, and a stateful hash function maps each
+	 * key to the same bucket it occupied before.
+	 *
+	 * Mapping an endofunction over a temporary map updates its values in
+	 * place, without touching its keys or nodes.
+	 *
 	 * \ingroup unord_map
 	 */
 	template<typename K, typename T, typename H, typename C, typename A>
@@ -85,7 +93,7 @@ namespace ftl {
 		 */
 		template<typename F, typename U = result_of<F(T)>>
 		static unordered_map<U> map(F&& f, const unordered_map<T>& m) {
-			unordered_map<U> rm;
+			auto rm = shaped_like<U>(m);
 			for(const auto& kv : m) {
 				rm.emplace(kv.first, f(kv.second));
 			}
@@ -106,7 +114,7 @@ namespace ftl {
 				>
 		>
 		static unordered_map<U> map(F&& f, unordered_map<T>&& m) {
-			unordered_map<U> rm;
+			auto rm = shaped_like<U>(m);
 			for(auto& kv : m) {
 				rm.emplace(std::move(kv.first), f(std::move(kv.second)));
 			}
@@ -127,13 +135,26 @@ namespace ftl {
 		>
 		static unordered_map<T> map(F&& f, unordered_map<T>&& m) {
 			for(auto& kv : m) {
-				m[kv.first] = f(std::move(kv.second));
+				kv.second = f(std::move(kv.second));
 			}
 
-			return m;
+			return std::move(m);
 		}
 
 		static constexpr bool instance = true;
+
+	private:
+		// An empty map with the same buckets, hashing and allocator as m
+		template<typename U>
+		static unordered_map<U> shaped_like(const unordered_map<T>& m) {
+			unordered_map<U> rm(
+				m.bucket_count(), m.hash_function(), m.key_eq(),
+				typename unordered_map<U>::allocator_type(m.get_allocator())
+			);
+			rm.max_load_factor(m.max_load_factor());
+
+			return rm;
+		}
 	};
 
 }
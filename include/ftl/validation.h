@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_VALIDATION_H
+#define FTL_VALIDATION_H
+
+#include "either.h"
+#include "small_vector.h"
+#include "concepts/applicative.h"
+
+namespace ftl {
+	/**
+	 * \defgroup validation Validation
+	 *
+	 * An applicative functor accumulating every error, rather than
+	 * stopping at the first like either.
+	 *
+	 * \code
+	 *   #include <ftl/validation.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - \ref either
+	 * - \ref small_vector
+	 * - \ref applicative
+	 */
+
+	/**
+	 * The errors of an invalid validation.
+	 *
+	 * Errors are kept in a small_vector, the first `N` of them inline, so
+	 * that failing with only a few errors does not allocate.
+	 *
+	 * \par Concepts
+	 * - \ref fullycons
+	 * - \ref deref, to `small_vector<E,N>`
+	 * - \ref eq, if `E` is
+	 *
+	 * \ingroup validation
+	 */
+	template<typename E, std::size_t N = 4>
+	struct Invalid {
+		using value_type = small_vector<E,N>;
+
+		Invalid() = default;
+
+		explicit Invalid(const small_vector<E,N>& es) : val(es) {}
+		explicit Invalid(small_vector<E,N>&& es) : val(std::move(es)) {}
+
+		small_vector<E,N>& operator* () noexcept {
+			return val;
+		}
+
+		const small_vector<E,N>& operator* () const noexcept {
+			return val;
+		}
+
+		small_vector<E,N>* operator-> () noexcept {
+			return std::addressof(val);
+		}
+
+		const small_vector<E,N>* operator-> () const noexcept {
+			return std::addressof(val);
+		}
+
+		small_vector<E,N> val;
+	};
+
+	template<typename E, std::size_t N>
+	bool operator== (const Invalid<E,N>& a, const Invalid<E,N>& b) {
+		return a.val == b.val;
+	}
+
+	template<typename E, std::size_t N>
+	bool operator!= (const Invalid<E,N>& a, const Invalid<E,N>& b) {
+		return a.val != b.val;
+	}
+
+	/**
+	 * Either a valid value, or every error found producing it.
+	 *
+	 * Unlike either, validation is only an applicative functor, not a
+	 * monad. Applying an invalid function to an invalid argument keeps the
+	 * errors of both, in order, so that validating several fields with
+	 * `f % a * b * c` reports what was wrong with all of them.
+	 *
+	 * The errors of the function are moved rather than copied whenever it
+	 * is an rvalue, as in such chains. With at most `N` errors, nothing
+	 * then allocates.
+	 *
+	 * \par Concepts
+	 * - \ref fullycons, if `E` and `T` are
+	 * - \ref eq, if `E` and `T` are
+	 * - \ref functorpg
+	 * - \ref applicativepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   using checked = ftl::validation<std::string,int>;
+	 *
+	 *   auto age = [](int x){
+	 *       return x >= 0 ? ftl::valid<std::string>(x)
+	 *           : ftl::invalid<int>(std::string("negative age"));
+	 *   };
+	 *
+	 *   auto r = ftl::curry(make_person) % name(n) * age(a) * email(e);
+	 * \endcode
+	 *
+	 * \ingroup validation
+	 */
+	template<typename E, typename T, std::size_t N = 4>
+	using validation = sum_type<Invalid<E,N>,Right<T>>;
+
+	template<typename E, typename T, std::size_t N>
+	struct parametric_type_traits<validation<E,T,N>> {
+		using value_type = T;
+
+		template<typename U>
+		using rebind = validation<E,U,N>;
+	};
+
+	/**
+	 * Construct a valid value.
+	 *
+	 * \ingroup validation
+	 */
+	template<
+			typename E, std::size_t N = 4,
+			typename T, typename T0 = plain_type<T>
+	>
+	validation<E,T0,N> valid(T&& t) {
+		return validation<E,T0,N>{constructor<Right<T0>>(), std::forward<T>(t)};
+	}
+
+	/**
+	 * Construct an invalid value, with one error.
+	 *
+	 * \ingroup validation
+	 */
+	template<
+			typename T, std::size_t N = 4,
+			typename E, typename E0 = plain_type<E>
+	>
+	validation<E0,T,N> invalid(E&& e) {
+		validation<E0,T,N> v{constructor<Invalid<E0,N>>()};
+		get<Invalid<E0,N>>(v).val.emplace_back(std::forward<E>(e));
+		return v;
+	}
+
+	/**
+	 * The errors of `v`, or none if it is valid.
+	 *
+	 * \ingroup validation
+	 */
+	template<typename E, typename T, std::size_t N>
+	small_vector<E,N> errors(const validation<E,T,N>& v) {
+		return v.template is<Invalid<E,N>>()
+			? get<Invalid<E,N>>(v).val
+			: small_vector<E,N>();
+	}
+
+	/// \overload
+	template<typename E, typename T, std::size_t N>
+	small_vector<E,N> errors(validation<E,T,N>&& v) {
+		return v.template is<Invalid<E,N>>()
+			? std::move(get<Invalid<E,N>>(v).val)
+			: small_vector<E,N>();
+	}
+
+	/**
+	 * Validation from an either, a left value being the one error.
+	 *
+	 * \ingroup validation
+	 */
+	template<std::size_t N = 4, typename E, typename T>
+	validation<E,T,N> toValidation(const either<E,T>& e) {
+		return e.template is<Right<T>>()
+			? valid<E,N>(*get<Right<T>>(e))
+			: invalid<T,N>(*get<Left<E>>(e));
+	}
+
+	/**
+	 * Either of the errors of `v`, or of its value.
+	 *
+	 * \ingroup validation
+	 */
+	template<typename E, typename T, std::size_t N>
+	either<small_vector<E,N>,T> toEither(const validation<E,T,N>& v) {
+		return v.template is<Right<T>>()
+			? make_right<small_vector<E,N>>(*get<Right<T>>(v))
+			: make_left<T>(get<Invalid<E,N>>(v).val);
+	}
+
+	namespace _dtl {
+		// The alternative X of s, moved from if s is an rvalue
+		template<typename X, typename...Ts>
+		const X& forward_get(const sum_type<Ts...>& s) {
+			return get<X>(s);
+		}
+
+		template<typename X, typename...Ts>
+		X&& forward_get(sum_type<Ts...>&& s) {
+			return std::move(get<X>(s));
+		}
+
+		template<typename E, std::size_t N>
+		void append_errors(small_vector<E,N>& es, const Invalid<E,N>& more) {
+			es.insert(es.end(), more.val.begin(), more.val.end());
+		}
+
+		template<typename E, std::size_t N>
+		void append_errors(small_vector<E,N>& es, Invalid<E,N>&& more) {
+			es.insert(
+				es.end(),
+				std::make_move_iterator(more.val.begin()),
+				std::make_move_iterator(more.val.end())
+			);
+		}
+	}
+
+	/**
+	 * Applicative instance for validation.
+	 *
+	 * \ingroup validation
+	 */
+	template<typename E, typename T, std::size_t N>
+	struct applicative<validation<E,T,N>> {
+		template<typename U>
+		using V = validation<E,U,N>;
+
+		static V<T> pure(const T& t) {
+			return V<T>{constructor<Right<T>>(), t};
+		}
+
+		static V<T> pure(T&& t) {
+			return V<T>{constructor<Right<T>>(), std::move(t)};
+		}
+
+		/// Apply `f` to a valid value, passing errors on untouched
+		template<typename F, typename U = result_of<F(const T&)>>
+		static V<U> map(F&& f, const V<T>& v) {
+			return v.template is<Right<T>>()
+				? valid<E,N>(std::forward<F>(f)(*get<Right<T>>(v)))
+				: V<U>{constructor<Invalid<E,N>>(), get<Invalid<E,N>>(v)};
+		}
+
+		/// \overload
+		template<typename F, typename U = result_of<F(T)>>
+		static V<U> map(F&& f, V<T>&& v) {
+			return v.template is<Right<T>>()
+				? valid<E,N>(std::forward<F>(f)(std::move(*get<Right<T>>(v))))
+				: V<U>{
+					constructor<Invalid<E,N>>(), std::move(get<Invalid<E,N>>(v))
+				};
+		}
+
+		/**
+		 * Apply a valid function to a valid value.
+		 *
+		 * If either is invalid, so is the result, with the errors of the
+		 * function followed by those of the value.
+		 */
+		template<
+				typename Vf,
+				typename Fn = Value_type<plain_type<Vf>>,
+				typename U = result_of<Fn(T)>
+		>
+		static V<U> apply(Vf&& vf, const V<T>& v) {
+			return apply_(std::forward<Vf>(vf), v);
+		}
+
+		/// \overload
+		template<
+				typename Vf,
+				typename Fn = Value_type<plain_type<Vf>>,
+				typename U = result_of<Fn(T)>
+		>
+		static V<U> apply(Vf&& vf, V<T>&& v) {
+			return apply_(std::forward<Vf>(vf), std::move(v));
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		template<
+				typename Vf, typename W,
+				typename Fn = Value_type<plain_type<Vf>>,
+				typename U = result_of<Fn(T)>
+		>
+		static V<U> apply_(Vf&& vf, W&& v) {
+			using Fv = Right<Fn>;
+
+			if(vf.template is<Fv>()) {
+				if(v.template is<Right<T>>())
+					return valid<E,N>((*get<Fv>(vf))(
+						_dtl::forward_get<Right<T>>(std::forward<W>(v)).val
+					));
+
+				return V<U>{
+					constructor<Invalid<E,N>>(),
+					_dtl::forward_get<Invalid<E,N>>(std::forward<W>(v))
+				};
+			}
+
+			V<U> r{
+				constructor<Invalid<E,N>>(),
+				_dtl::forward_get<Invalid<E,N>>(std::forward<Vf>(vf))
+			};
+
+			if(v.template is<Invalid<E,N>>())
+				_dtl::append_errors(
+					get<Invalid<E,N>>(r).val,
+					_dtl::forward_get<Invalid<E,N>>(std::forward<W>(v))
+				);
+
+			return r;
+		}
+	};
+}
+
+#endif
+
@@ -23,10 +23,13 @@
 #ifndef FTL_VECTOR_H
 #define FTL_VECTOR_H
 
+#include <algorithm>
 #include <vector>
 #include "concepts/foldable.h"
 #include "concepts/monad.h"
 #include "concepts/zippable.h"
+#include "implementation/fold_kernels.h"
+#include "implementation/map_kernels.h"
 
 namespace ftl {
 
@@ -67,9 +70,89 @@ namespace ftl {
 		using rebind = std::vector<U,rebind_allocator<U>>;
 	};
 
+	namespace _dtl {
+		// Whether mapping a vector of T into one of U may use the map kernels
+		template<typename T, typename U>
+		struct has_map_kernel : std::integral_constant<
+			bool, is_kernel_number<T>::value && is_kernel_number<U>::value
+		> {};
+
+		// Whether zipping a vector of T with Is into U may use the kernels
+		template<typename T, typename U, typename...Is>
+		struct has_zip_kernel : std::false_type {};
+
+		template<typename T, typename U, typename T2, typename A2>
+		struct has_zip_kernel<T,U,std::vector<T2,A2>>
+		: std::integral_constant<
+			bool,
+			is_kernel_number<T>::value && is_kernel_number<T2>::value
+			&& is_kernel_number<U>::value
+		> {};
+
+		template<typename U, typename Au, typename C>
+		void append_moved(std::vector<U,Au>& result, C& c) {
+			result.insert(
+					result.end(),
+					std::make_move_iterator(c.begin()),
+					std::make_move_iterator(c.end())
+			);
+		}
+
+		// Gives the first result's buffer to the output, if it can be had
+		template<typename U, typename Au, typename Cs>
+		bool adopt_front(std::vector<U,Au>&, Cs&) {
+			return false;
+		}
+
+		template<typename U, typename Au, typename A>
+		bool adopt_front(
+				std::vector<U,Au>& result,
+				std::vector<std::vector<U,Au>,A>& nested
+		) {
+			if(nested.front().get_allocator() != result.get_allocator())
+				return false;
+
+			result = std::move(nested.front());
+			return true;
+		}
+
+		/*
+		 * Concatenates nested into a vector allocated with alloc, reserving
+		 * the exact total size once.
+		 */
+		template<typename U, typename Au, typename Cs>
+		std::vector<U,Au> flatten(const Au& alloc, Cs& nested) {
+			std::vector<U,Au> result(alloc);
+			if(nested.empty())
+				return result;
+
+			std::size_t size = 0;
+			for(auto& c : nested) {
+				size += std::distance(c.begin(), c.end());
+			}
+
+			auto it = nested.begin();
+			if(adopt_front(result, nested))
+				++it;
+
+			result.reserve(size);
+			for(; it != nested.end(); ++it) {
+				append_moved(result, *it);
+			}
+
+			return result;
+		}
+	}
+
 	/**
 	 * Maps and concatenates in one step.
 	 *
+	 * The result is allocated with (a rebound copy of) the allocator of `v`,
+	 * so e.g. an ftl::resource_allocator carries over to it. Its size is
+	 * reserved exactly, once all the results of `f` are known. If `f`
+	 * returns vectors of the result type, the first one's buffer becomes the
+	 * result's.
+	 *
 	 * \tparam F must satisfy \ref fn`<`\ref container`<B>(A)>`
 	 *
 	 * \ingroup vector
@@ -83,19 +166,8 @@ namespace ftl {
 	>
 	std::vector<U,Au> concatMap(F f, const std::vector<T,A>& v) {
 
-		std::vector<U,Au> result;
-		result.reserve(v.size() * 2);
 		auto nested = f % v;
-
-		for(auto& el : nested) {
-			result.insert(
-					result.end(),
-					std::make_move_iterator(el.begin()),
-					std::make_move_iterator(el.end())
-			);
-		}
-
-		return result;
+		return _dtl::flatten<U>(Au(v.get_allocator()), nested);
 	}
 
 	/**
@@ -112,22 +184,164 @@ namespace ftl {
 	>
 	std::vector<U,Au> concatMap(F f, std::vector<T,A>&& v) {
 
+		Au alloc(v.get_allocator());
 		auto nested = f % std::move(v);
+		return _dtl::flatten<U>(alloc, nested);
+	}
 
-		std::vector<U,Au> result;
-		result.reserve(nested.size() * 2);
+	/**
+	 * The elements of `v` that satisfy `p`, in order.
+	 *
+	 * The result is reserved for all of `v` up front, so the elements that
+	 * survive are copied straight into it, without it ever being grown.
+	 *
+	 * \tparam P must satisfy \ref fn`<bool(T)>`
+	 *
+	 * \ingroup vector
+	 */
+	template<typename P, typename T, typename A>
+	std::vector<T,A> filter(P&& p, const std::vector<T,A>& v) {
+		std::vector<T,A> result(v.get_allocator());
+		result.reserve(v.size());
+		for(auto& e : v) {
+			if(p(e))
+				result.push_back(e);
+		}
 
-		for(auto& el : nested) {
-			result.insert(
-					result.end(),
-					std::make_move_iterator(el.begin()),
-					std::make_move_iterator(el.end())
-			);
+		return result;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Compacts `v` in place, moving each surviving element at most once.
+	 * Nothing is allocated.
+	 *
+	 * \note Requires a \ref moveassignable `T`.
+	 *
+	 * \ingroup vector
+	 */
+	template<typename P, typename T, typename A>
+	std::vector<T,A> filter(P&& p, std::vector<T,A>&& v) {
+		auto out = v.begin();
+		for(auto it = v.begin(); it != v.end(); ++it) {
+			if(p(static_cast<const T&>(*it))) {
+				if(out != it)
+					*out = std::move(*it);
+
+				++out;
+			}
+		}
+
+		v.erase(out, v.end());
+		return std::move(v);
+	}
+
+	/**
+	 * Maps and keeps only the results that are present.
+	 *
+	 * Equivalent of `concatMap(f, v)` for an `f` returning ftl::maybe, but
+	 * the values are moved straight out of each result into the output,
+	 * which is reserved for all of `v` up front.
+	 *
+	 * \tparam F must satisfy \ref fn`<maybe<U>(T)>`, or more generally,
+	 *           return any \ref fwditerable of at most one element.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto half = [](int x){
+	 *       return x % 2 ? ftl::nothing<int>() : ftl::just(x/2);
+	 *   };
+	 *
+	 *   // v == {1, 2}
+	 *   auto v = ftl::mapMaybe(half, std::vector<int>{1, 2, 3, 4});
+	 * \endcode
+	 *
+	 * \ingroup vector
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			typename U = Value_type<result_of<F(T)>>,
+			typename Au = Rebind<A,U>
+	>
+	std::vector<U,Au> mapMaybe(F&& f, const std::vector<T,A>& v) {
+		std::vector<U,Au> result{Au(v.get_allocator())};
+		result.reserve(v.size());
+		for(auto& e : v) {
+			auto m = f(e);
+			for(auto& u : m) {
+				result.push_back(std::move(u));
+			}
 		}
 
 		return result;
 	}
 
+	/**
+	 * \overload
+	 *
+	 * Elements are moved into `f`.
+	 *
+	 * \ingroup vector
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			typename U = Value_type<result_of<F(T)>>,
+			typename Au = Rebind<A,U>,
+			typename = Requires<
+				!std::is_same<U,T>::value
+				|| !std::is_move_assignable<T>::value
+			>
+	>
+	std::vector<U,Au> mapMaybe(F&& f, std::vector<T,A>&& v) {
+		std::vector<U,Au> result{Au(v.get_allocator())};
+		result.reserve(v.size());
+		for(auto& e : v) {
+			auto m = f(std::move(e));
+			for(auto& u : m) {
+				result.push_back(std::move(u));
+			}
+		}
+
+		return result;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * If `f` returns the type it is given, the results are compacted into
+	 * `v` itself, and nothing is allocated.
+	 *
+	 * \ingroup vector
+	 */
+	template<
+			typename F,
+			typename T,
+			typename A,
+			typename = Requires<
+				std::is_same<Value_type<result_of<F(T)>>,T>::value
+				&& std::is_move_assignable<T>::value
+			>
+	>
+	std::vector<T,A> mapMaybe(F&& f, std::vector<T,A>&& v) {
+		auto out = v.begin();
+		for(auto it = v.begin(); it != v.end(); ++it) {
+			auto m = f(std::move(*it));
+			for(auto& u : m) {
+				*out = std::move(u);
+				++out;
+			}
+		}
+
+		v.erase(out, v.end());
+		return std::move(v);
+	}
+
 	/**
 	 * Monoid implementation for std::vectors.
 	 *
@@ -150,28 +364,100 @@ namespace ftl {
 			return rv;
 		}
 
+		// No exact reserve here, as that would defeat the geometric growth
+		// left folds rely on.
 		static std::vector<Ts...> append(
 				std::vector<Ts...>&& v1,
 				const std::vector<Ts...>& v2) {
-			v1.reserve(v1.size() + v2.size());
 			v1.insert(v1.end(), v2.begin(), v2.end());
-			return v1;
+			return std::move(v1);
 		}
 
+		/*
+		 * Prepending in place shifts all of v2. If v2 must grow for that
+		 * anyway, its elements are instead moved only once, straight into a
+		 * new buffer behind v1's.
+		 */
 		static std::vector<Ts...> append(
 				const std::vector<Ts...>& v1,
 				std::vector<Ts...>&& v2) {
-			v2.reserve(v2.size() + v1.size());
-			v2.insert(v2.begin(), v1.begin(), v1.end());
-			return v2;
+			if(v2.capacity() - v2.size() >= v1.size()) {
+				v2.insert(v2.begin(), v1.begin(), v1.end());
+				return std::move(v2);
+			}
+
+			std::vector<Ts...> rv(v2.get_allocator());
+			rv.reserve(v1.size() + v2.size());
+			rv.insert(rv.end(), v1.begin(), v1.end());
+			_dtl::append_moved(rv, v2);
+			return rv;
 		}
 
+		// Whichever side already has the room for both is appended into
 		static std::vector<Ts...> append(
 				std::vector<Ts...>&& v1,
 				std::vector<Ts...>&& v2) {
-			v1.reserve(v1.size() + v2.size());
-			std::move(v2.begin(), v2.end(), std::back_inserter(v1));
-			return v1;
+			if(v1.capacity() - v1.size() < v2.size()
+					&& v2.capacity() - v2.size() >= v1.size()
+					&& v1.get_allocator() == v2.get_allocator()) {
+				v2.insert(
+						v2.begin(),
+						std::make_move_iterator(v1.begin()),
+						std::make_move_iterator(v1.end())
+				);
+				return std::move(v2);
+			}
+
+			_dtl::append_moved(v1, v2);
+			return std::move(v1);
+		}
+
+		/**
+		 * Concatenates an entire sequence of vectors.
+		 *
+		 * Unlike a fold of `append`s, which in the case of right folds
+		 * shifts the accumulated vector for every element, this computes the
+		 * total size first and fills a single, exactly sized buffer.
+		 *
+		 * \tparam I must satisfy \ref fwditerable, with vectors as elements
+		 */
+		template<
+				typename I,
+				typename = Requires<ForwardIterable<I>()>
+		>
+		static std::vector<Ts...> mconcat(const I& vs) {
+			std::size_t size = 0;
+			for(auto& v : vs) {
+				size += v.size();
+			}
+
+			std::vector<Ts...> rv;
+			rv.reserve(size);
+			for(auto& v : vs) {
+				rv.insert(rv.end(), v.begin(), v.end());
+			}
+
+			return rv;
+		}
+
+		/**
+		 * \overload
+		 *
+		 * The elements of `vs` are moved, and if it is itself a vector, its
+		 * first element's buffer is reused.
+		 */
+		template<
+				typename I,
+				typename = Requires<
+					!std::is_lvalue_reference<I>::value
+					&& ForwardIterable<plain_type<I>>()
+				>
+		>
+		static std::vector<Ts...> mconcat(I&& vs) {
+			using A = typename std::vector<Ts...>::allocator_type;
+			using T = typename std::vector<Ts...>::value_type;
+
+			return _dtl::flatten<T>(A(), vs);
 		}
 
 		static constexpr bool instance = true;
@@ -186,21 +472,58 @@ namespace ftl {
 	struct monad<std::vector<T,A>>
 	: deriving_monad<back_insertable_container<std::vector<T,A>>> {
 
-#ifdef DOCUMENTATION_GENERATOR
 		/// Alias to make type signatures cleaner
 		template<typename U>
 		using vector = Rebind<std::vector<T,A>,U>;
 
-		/// Creates a one element vector
-		static vector<T> pure(const T& t);
-
-		/// Applies `f` to each element
+		/**
+		 * Applies `f` to each element.
+		 *
+		 * The result is allocated once, at the size of `v`. When both `T`
+		 * and the result of `f` are arithmetic types, it is written by a
+		 * vectorisable loop over the storage of `v`, or, if `f` is one of
+		 * the standard arithmetic function objects such as `std::negate`,
+		 * using explicit vector instructions where available.
+		 */
 		template<typename F, typename U = result_of<F(T)>>
-		static vector<U> map(F&& f, const vector<T>& v);
+		static vector<U> map(F&& f, const vector<T>& v) {
+			return map_<U>(f, v, _dtl::has_map_kernel<T,U>{});
+		}
 
 		/// Rvalue version of map
-		template<typename F, typename U = result_of<F(T)>>
-		static vector<U> map(F&& f, vector<T>&& v);
+		template<
+				typename F, typename U = result_of<F(T)>,
+				typename = Requires<
+					!std::is_same<U,T>::value
+					|| (!std::is_copy_assignable<T>::value
+					&& !std::is_move_assignable<T>::value)
+				>
+		>
+		static vector<U> map(F&& f, vector<T>&& v) {
+			return map_<U>(f, std::move(v), _dtl::has_map_kernel<T,U>{});
+		}
+
+		/**
+		 * Rvalue version of map, for functions from `T` to `T`.
+		 *
+		 * Reuses the storage of `v`, replacing each element in place.
+		 */
+		template<
+				typename F,
+				typename = Requires<
+					std::is_same<result_of<F(T)>,T>::value
+					&& (std::is_copy_assignable<T>::value
+					|| std::is_move_assignable<T>::value)
+				>
+		>
+		static vector<T> map(F&& f, vector<T>&& v) {
+			map_in_place(f, v, _dtl::has_map_kernel<T,T>{});
+			return std::move(v);
+		}
+
+#ifdef DOCUMENTATION_GENERATOR
+		/// Creates a one element vector
+		static vector<T> pure(const T& t);
 
 		/**
 		 * Joins nested vectors by way of concatenation.
@@ -221,6 +544,11 @@ namespace ftl {
 		 * element in `v`. Finally, all of the results are collected in a flat
 		 * vector.
 		 *
+		 * The results of `f` are appended to the output as soon as they are
+		 * returned, so only one of them is kept around at a time. Use
+		 * `concatMap` to have all of them computed first, and the result
+		 * allocated once at its exact size.
+		 *
 		 * \note `f` is allowed to return _any_ \ref fwditerable, not only
 		 *       vectors. The final result, however, is always a vector.
 		 *
@@ -234,46 +562,178 @@ namespace ftl {
 		 *   // v == vector<int>{0,1,2, 1,2,3, 2,3,4}
 		 * \endcode
 		 */
-		template<
-				typename F,
-				typename Cu = result_of<F(T)>,
-				typename U = Value_type<Cu>,
-				typename = Requires<ForwardIterable<Cu>()>
-		>
+		template<typename F, typename U = Value_type<result_of<F(T)>>>
 		static vector<U> bind(const vector<T>& v, F&& f);
 
 		/// \overload
-		template<
-				typename F,
-				typename Cu = result_of<F(T)>,
-				typename U = Value_type<Cu>,
-				typename = Requires<ForwardIterable<Cu>()>
-		>
+		template<typename F, typename U = Value_type<result_of<F(T)>>>
 		static vector<U> bind(vector<T>&& v, F&& f);
 #endif
+
+	private:
+		template<typename U, typename F>
+		static vector<U> map_(F& f, const vector<T>& v, std::true_type) {
+			vector<U> result(v.size());
+			_dtl::map_numbers(f, v.data(), result.data(), v.size());
+			return result;
+		}
+
+		template<typename U, typename F>
+		static vector<U> map_(F& f, const vector<T>& v, std::false_type) {
+			vector<U> result;
+			result.reserve(v.size());
+			for(auto& e : v) {
+				result.emplace_back(f(e));
+			}
+
+			return result;
+		}
+
+		template<typename U, typename F>
+		static vector<U> map_(F& f, vector<T>&& v, std::true_type) {
+			const vector<T>& cv = v;
+			return map_<U>(f, cv, std::true_type{});
+		}
+
+		template<typename U, typename F>
+		static vector<U> map_(F& f, vector<T>&& v, std::false_type) {
+			vector<U> result;
+			result.reserve(v.size());
+			for(auto& e : v) {
+				result.emplace_back(f(std::move(e)));
+			}
+
+			return result;
+		}
+
+		template<typename F>
+		static void map_in_place(F& f, vector<T>& v, std::true_type) {
+			_dtl::map_numbers_in_place(f, v.data(), v.size());
+		}
+
+		template<typename F>
+		static void map_in_place(F& f, vector<T>& v, std::false_type) {
+			for(auto& e : v) {
+				e = f(std::move(e));
+			}
+		}
 	};
 
+	/**
+	 * Vectors apply every function to every element, in order.
+	 *
+	 * \ingroup vector
+	 */
+	template<typename T, typename A>
+	struct cartesian_apply<std::vector<T,A>> : std::true_type {};
+
 	/**
 	 * Foldable instance for std::vector.
 	 *
+	 * Folding into `sum_monoid` or `prod_monoid` of an arithmetic type uses
+	 * a specialised, vectorisable loop over the contiguous storage of the
+	 * vector. Any other monoid takes the usual, element-by-element path.
+	 *
 	 * \ingroup vector
 	 */
 	template<typename T, typename A>
 	struct foldable<std::vector<T,A>>
-	: deriving_foldable<bidirectional_iterable<std::vector<T,A>>> {};
+	: deriving_foldl<std::vector<T,A>>, deriving_foldr<std::vector<T,A>>
+	, deriving_fold<std::vector<T,A>> {
+
+		template<typename Fn, typename M = result_of<Fn(T)>>
+		static M foldMap(Fn fn, const std::vector<T,A>& v) {
+			return foldMap_<M>(
+				fn, v,
+				std::integral_constant<
+					bool, _dtl::has_fold_kernel<T,M>::value
+				>{}
+			);
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		template<typename M, typename Fn>
+		static M foldMap_(Fn& fn, const std::vector<T,A>& v, std::false_type) {
+			return deriving_foldMap<std::vector<T,A>>::foldMap(fn, v);
+		}
+
+		template<typename M, typename Fn>
+		static M foldMap_(Fn& fn, const std::vector<T,A>& v, std::true_type) {
+			return _dtl::fold_kernel<M>::run(fn, v.data(), v.size());
+		}
+	};
 
 	/**
 	 * Zippable instance for std::vector.
 	 *
 	 * This particular instance allows a `vector` to be zipped with
-	 * any type that satisfies \ref fwditerable. Thus, one can zip a
-	 * `vector` with a `forward_list`, `list` or even `ftl::maybe`.
+	 * any number of values of types that satisfy \ref fwditerable. Thus, one
+	 * can zip a `vector` with a `forward_list`, `list` or even `ftl::maybe`.
+	 *
+	 * Whenever all of the zipped values know their size, the result is
+	 * allocated once, up front.
+	 *
+	 * Zipping two vectors of arithmetic types into a third is done by a
+	 * vectorisable loop over their storage. If, in addition, `f` is one of
+	 * the standard arithmetic function objects such as `std::plus<float>`,
+	 * and all three share one element type, explicit vector instructions
+	 * are used where available.
 	 *
 	 * \ingroup vector
 	 */
 	template<typename T, typename A>
-	struct zippable<std::vector<T,A>>
-	: deriving_zippable<back_insertable_container<std::vector<T,A>>> {};
+	struct zippable<std::vector<T,A>> {
+		template<typename U>
+		using A_ = Rebind<A,U>;
+
+		template<
+				typename F, typename...Iterables,
+				typename U = result_of<F(T,Value_type<Iterables>...)>,
+				typename = Requires<
+					_dtl::forward_iterables<Iterables...>::value
+				>
+		>
+		static std::vector<U,A_<U>> zipWith(
+				F f, const std::vector<T,A>& v, const Iterables&...is) {
+			return zipWith_<U>(
+				_dtl::has_zip_kernel<T,U,Iterables...>{}, f, v, is...
+			);
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		template<typename U, typename F, typename T2, typename A2>
+		static std::vector<U,A_<U>> zipWith_(
+				std::true_type, F& f,
+				const std::vector<T,A>& v, const std::vector<T2,A2>& w) {
+
+			auto n = std::min(v.size(), w.size());
+			std::vector<U,A_<U>> result(n);
+
+			_dtl::zip_numbers(f, v.data(), w.data(), result.data(), n);
+
+			return result;
+		}
+
+		template<typename U, typename F, typename...Iterables>
+		static std::vector<U,A_<U>> zipWith_(
+				std::false_type, F& f,
+				const std::vector<T,A>& v, const Iterables&...is) {
+
+			std::vector<U,A_<U>> result;
+			result.reserve(_dtl::zip_size_hint(v, is...));
+
+			_dtl::zip_each(
+				_dtl::push_back_sink<std::vector<U,A_<U>>>{result},
+				f, v, is...
+			);
+
+			return result;
+		}
+	};
 
 }
 
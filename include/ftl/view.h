@@ -0,0 +1,1139 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_VIEW_H
+#define FTL_VIEW_H
+
+#include <new>
+#include <vector>
+#include <iterator>
+#include "concepts/iterator.h"
+#include "concepts/functor.h"
+#include "concepts/foldable.h"
+#include "concepts/zippable.h"
+
+namespace ftl {
+	/**
+	 * \defgroup view View
+	 *
+	 * Lazy, non-owning views of iterable data.
+	 *
+	 * Mapping, filtering, zipping or concat-mapping a view does not compute
+	 * anything; it yields another view, whose elements are computed on demand
+	 * as it is traversed. A pipeline of several such stages thus never builds
+	 * any intermediate containers. The result is materialised exactly once,
+	 * either by `collect`ing it into a container, or by folding it.
+	 *
+	 * \code
+	 *   #include <ftl/view.h>
+	 * \endcode
+	 *
+	 * \par Dependencies
+	 * - `<new>`
+	 * - `<vector>`
+	 * - `<iterator>`
+	 * - \ref concepts_iterator
+	 * - \ref functor
+	 * - \ref foldable
+	 * - \ref zippable
+	 */
+
+	template<typename V>
+	class view;
+
+	namespace _dtl {
+		// Multi-pass iteration is only advertised by stages that preserve
+		// the underlying references; those that compute their elements are
+		// single pass, so that e.g. range constructors only evaluate them once.
+		template<typename It, typename Ref>
+		using view_category = typename std::conditional<
+			ForwardIterator<It>::value && std::is_reference<Ref>::value,
+			std::forward_iterator_tag,
+			std::input_iterator_tag
+		>::type;
+
+		template<typename F, typename It>
+		using view_result = plain_type<decltype(
+			std::declval<const F&>()(*std::declval<It&>())
+		)>;
+
+		template<typename It>
+		struct range_view {
+			using iterator = It;
+
+			iterator begin() const {
+				return b;
+			}
+
+			iterator end() const {
+				return e;
+			}
+
+			It b;
+			It e;
+		};
+
+		template<typename V, typename F>
+		struct map_view {
+			using base_iterator = typename V::iterator;
+			using result_type = view_result<F,base_iterator>;
+
+			class iterator {
+			public:
+				using iterator_category = std::input_iterator_tag;
+				using value_type = result_type;
+				using difference_type =
+					typename std::iterator_traits<base_iterator>::difference_type;
+				using pointer = void;
+				using reference = result_type;
+
+				iterator() = default;
+				iterator(const map_view* parent, base_iterator it)
+				: parent(parent), it(std::move(it)) {}
+
+				reference operator* () const {
+					return parent->fn(*it);
+				}
+
+				iterator& operator++ () {
+					++it;
+					return *this;
+				}
+
+				iterator operator++ (int) {
+					auto tmp = *this;
+					++it;
+					return tmp;
+				}
+
+				bool operator== (const iterator& i) const {
+					return it == i.it;
+				}
+
+				bool operator!= (const iterator& i) const {
+					return it != i.it;
+				}
+
+			private:
+				const map_view* parent = nullptr;
+				base_iterator it;
+			};
+
+			iterator begin() const {
+				return iterator(this, v.begin());
+			}
+
+			iterator end() const {
+				return iterator(this, v.end());
+			}
+
+			V v;
+			F fn;
+		};
+
+		/*
+		 * The element an iterator filtering `It` is at.
+		 *
+		 * Elements computed by an earlier stage, e.g. a map, are kept, so
+		 * that testing the predicate and dereferencing the iterator do not
+		 * compute them twice. References are simply taken again.
+		 */
+		template<typename It, typename Ref, bool = std::is_reference<Ref>::value>
+		struct current_element {
+			using reference = Ref;
+			using pointer = typename std::iterator_traits<It>::pointer;
+
+			reference load(const It& it) {
+				return *it;
+			}
+
+			reference get(const It& it) const {
+				return *it;
+			}
+		};
+
+		template<typename It, typename T>
+		class current_element<It,T,false> {
+		public:
+			using value_type = plain_type<T>;
+			using reference = const value_type&;
+			using pointer = const value_type*;
+
+			current_element() noexcept {}
+
+			current_element(const current_element& c) {
+				if(c.full)
+					emplace(c.t);
+			}
+
+			current_element(current_element&& c) {
+				if(c.full)
+					emplace(std::move(c.t));
+			}
+
+			~current_element() {
+				reset();
+			}
+
+			current_element& operator= (current_element c) {
+				reset();
+				if(c.full)
+					emplace(std::move(c.t));
+
+				return *this;
+			}
+
+			reference load(const It& it) {
+				reset();
+				emplace(*it);
+				return t;
+			}
+
+			reference get(const It&) const {
+				return t;
+			}
+
+		private:
+			template<typename U>
+			void emplace(U&& u) {
+				new (&t) value_type(std::forward<U>(u));
+				full = true;
+			}
+
+			void reset() noexcept {
+				if(full) {
+					t.~value_type();
+					full = false;
+				}
+			}
+
+			union {
+				value_type t;
+			};
+
+			bool full = false;
+		};
+
+		template<typename V, typename P>
+		struct filter_view {
+			using base_iterator = typename V::iterator;
+			using base_traits = std::iterator_traits<base_iterator>;
+			using element = current_element<
+				base_iterator, typename base_traits::reference
+			>;
+
+			class iterator {
+			public:
+				using iterator_category = view_category<
+					base_iterator, typename base_traits::reference
+				>;
+				using value_type = typename base_traits::value_type;
+				using difference_type = typename base_traits::difference_type;
+				using pointer = typename element::pointer;
+				using reference = typename element::reference;
+
+				iterator() = default;
+				iterator(const filter_view* parent, base_iterator it)
+				: parent(parent), it(std::move(it)) {
+					satisfy();
+				}
+
+				reference operator* () const {
+					return current.get(it);
+				}
+
+				iterator& operator++ () {
+					++it;
+					satisfy();
+					return *this;
+				}
+
+				iterator operator++ (int) {
+					auto tmp = *this;
+					++*this;
+					return tmp;
+				}
+
+				bool operator== (const iterator& i) const {
+					return it == i.it;
+				}
+
+				bool operator!= (const iterator& i) const {
+					return it != i.it;
+				}
+
+			private:
+				void satisfy() {
+					auto e = parent->v.end();
+					while(it != e && !parent->pred(current.load(it)))
+						++it;
+				}
+
+				const filter_view* parent = nullptr;
+				base_iterator it;
+				element current;
+			};
+
+			iterator begin() const {
+				return iterator(this, v.begin());
+			}
+
+			iterator end() const {
+				return iterator(this, v.end());
+			}
+
+			V v;
+			P pred;
+		};
+
+		template<typename F, typename...Vs>
+		struct zip_view {
+			using iterators = std::tuple<typename Vs::iterator...>;
+			using indices = index_seq<sizeof...(Vs)>;
+			using result_type = plain_type<decltype(
+				std::declval<const F&>()(
+					*std::declval<typename Vs::iterator&>()...
+				)
+			)>;
+
+			class iterator {
+			public:
+				using iterator_category = std::input_iterator_tag;
+				using value_type = result_type;
+				using difference_type = std::ptrdiff_t;
+				using pointer = void;
+				using reference = result_type;
+
+				iterator() = default;
+				iterator(const zip_view* parent, iterators its)
+				: parent(parent), its(std::move(its)) {}
+
+				reference operator* () const {
+					return zip_apply(parent->fn, its, indices{});
+				}
+
+				iterator& operator++ () {
+					zip_next(its, indices{});
+					return *this;
+				}
+
+				iterator operator++ (int) {
+					auto tmp = *this;
+					++*this;
+					return tmp;
+				}
+
+				// Any side reaching its end terminates the zip
+				bool operator== (const iterator& i) const {
+					return zip_done(its, i.its, indices{});
+				}
+
+				bool operator!= (const iterator& i) const {
+					return !(*this == i);
+				}
+
+			private:
+				const zip_view* parent = nullptr;
+				iterators its;
+			};
+
+			iterator begin() const {
+				return iterator(this, begins(indices{}));
+			}
+
+			iterator end() const {
+				return iterator(this, ends(indices{}));
+			}
+
+			template<size_t...I>
+			iterators begins(seq<I...>) const {
+				return iterators(std::get<I>(vs).begin()...);
+			}
+
+			template<size_t...I>
+			iterators ends(seq<I...>) const {
+				return iterators(std::get<I>(vs).end()...);
+			}
+
+			F fn;
+			std::tuple<Vs...> vs;
+		};
+
+		// Packs whatever the zipped iterators yield, references included
+		struct tie_elements {
+			template<typename...Xs>
+			std::tuple<Xs...> operator() (Xs&&...xs) const {
+				return std::tuple<Xs...>(std::forward<Xs>(xs)...);
+			}
+		};
+
+		template<typename V, typename F>
+		struct concat_view {
+			using base_iterator = typename V::iterator;
+			using inner_type = view_result<F,base_iterator>;
+			using inner_iterator = typename inner_type::const_iterator;
+
+			/* The container currently being traversed is owned by the iterator,
+			 * which is why copies must re-seat their inner iterator.
+			 */
+			class iterator {
+			public:
+				using iterator_category = std::input_iterator_tag;
+				using value_type = typename inner_type::value_type;
+				using difference_type =
+					typename std::iterator_traits<inner_iterator>::difference_type;
+				using pointer = const value_type*;
+				using reference = const value_type&;
+
+				iterator() : cur(inner.cbegin()) {}
+				iterator(const concat_view* parent, base_iterator it)
+				: parent(parent), it(std::move(it)) {
+					load();
+				}
+
+				iterator(const iterator& i)
+				: parent(i.parent), it(i.it), inner(i.inner), pos(i.pos)
+				, cur(std::next(inner.cbegin(), pos)) {}
+
+				iterator(iterator&& i)
+				: parent(i.parent), it(std::move(i.it)), inner(std::move(i.inner))
+				, pos(i.pos), cur(std::next(inner.cbegin(), pos)) {}
+
+				iterator& operator= (const iterator& i) {
+					if(this != &i) {
+						parent = i.parent;
+						it = i.it;
+						inner = i.inner;
+						pos = i.pos;
+						cur = std::next(inner.cbegin(), pos);
+					}
+
+					return *this;
+				}
+
+				iterator& operator= (iterator&& i) {
+					if(this != &i) {
+						parent = i.parent;
+						it = std::move(i.it);
+						inner = std::move(i.inner);
+						pos = i.pos;
+						cur = std::next(inner.cbegin(), pos);
+					}
+
+					return *this;
+				}
+
+				reference operator* () const {
+					return *cur;
+				}
+
+				iterator& operator++ () {
+					++pos;
+					if(++cur == inner.cend()) {
+						++it;
+						load();
+					}
+
+					return *this;
+				}
+
+				iterator operator++ (int) {
+					auto tmp = *this;
+					++*this;
+					return tmp;
+				}
+
+				bool operator== (const iterator& i) const {
+					return it == i.it && pos == i.pos;
+				}
+
+				bool operator!= (const iterator& i) const {
+					return !(*this == i);
+				}
+
+			private:
+				// Skips ahead to the next non-empty inner container
+				void load() {
+					pos = 0;
+					for(auto e = parent->v.end(); it != e; ++it) {
+						inner = parent->fn(*it);
+						cur = inner.cbegin();
+						if(cur != inner.cend())
+							return;
+					}
+
+					inner = inner_type();
+					cur = inner.cbegin();
+				}
+
+				const concat_view* parent = nullptr;
+				base_iterator it;
+				inner_type inner;
+				difference_type pos = 0;
+				inner_iterator cur;
+			};
+
+			iterator begin() const {
+				return iterator(this, v.begin());
+			}
+
+			iterator end() const {
+				return iterator(this, v.end());
+			}
+
+			V v;
+			F fn;
+		};
+
+		/* Stops after n elements. The base iterator is never advanced past
+		 * the last of them, so an infinite or expensive base is only ever
+		 * evaluated as far as is needed.
+		 */
+		template<typename V>
+		struct take_view {
+			using base_iterator = typename V::iterator;
+			using base_traits = std::iterator_traits<base_iterator>;
+
+			class iterator {
+			public:
+				using iterator_category = view_category<
+					base_iterator, typename base_traits::reference
+				>;
+				using value_type = typename base_traits::value_type;
+				using difference_type = typename base_traits::difference_type;
+				using pointer = typename base_traits::pointer;
+				using reference = typename base_traits::reference;
+
+				iterator() = default;
+				iterator(const take_view* parent, base_iterator it, std::size_t n)
+				: parent(parent), it(std::move(it)), n(n) {}
+
+				reference operator* () const {
+					return *it;
+				}
+
+				iterator& operator++ () {
+					if(--n > 0)
+						++it;
+
+					return *this;
+				}
+
+				iterator operator++ (int) {
+					auto tmp = *this;
+					++*this;
+					return tmp;
+				}
+
+				bool operator== (const iterator& i) const {
+					return done() ? i.done() : !i.done() && it == i.it;
+				}
+
+				bool operator!= (const iterator& i) const {
+					return !(*this == i);
+				}
+
+			private:
+				bool done() const {
+					return n == 0 || it == parent->v.end();
+				}
+
+				const take_view* parent = nullptr;
+				base_iterator it;
+				std::size_t n = 0;
+			};
+
+			iterator begin() const {
+				return iterator(this, v.begin(), n);
+			}
+
+			iterator end() const {
+				return iterator(this, v.end(), 0);
+			}
+
+			V v;
+			std::size_t n;
+		};
+
+		// Stops at the first element not satisfying pred
+		template<typename V, typename P>
+		struct take_while_view {
+			using base_iterator = typename V::iterator;
+			using base_traits = std::iterator_traits<base_iterator>;
+
+			class iterator {
+			public:
+				using iterator_category = view_category<
+					base_iterator, typename base_traits::reference
+				>;
+				using value_type = typename base_traits::value_type;
+				using difference_type = typename base_traits::difference_type;
+				using pointer = typename base_traits::pointer;
+				using reference = typename base_traits::reference;
+
+				iterator() = default;
+				iterator(const take_while_view* parent, base_iterator it)
+				: parent(parent), it(std::move(it)) {
+					check();
+				}
+
+				reference operator* () const {
+					return *it;
+				}
+
+				iterator& operator++ () {
+					++it;
+					check();
+					return *this;
+				}
+
+				iterator operator++ (int) {
+					auto tmp = *this;
+					++*this;
+					return tmp;
+				}
+
+				bool operator== (const iterator& i) const {
+					return done ? i.done : !i.done && it == i.it;
+				}
+
+				bool operator!= (const iterator& i) const {
+					return !(*this == i);
+				}
+
+			private:
+				void check() {
+					done = it == parent->v.end() || !parent->pred(*it);
+				}
+
+				const take_while_view* parent = nullptr;
+				base_iterator it;
+				bool done = true;
+			};
+
+			iterator begin() const {
+				return iterator(this, v.begin());
+			}
+
+			iterator end() const {
+				return iterator(this, v.end());
+			}
+
+			V v;
+			P pred;
+		};
+
+		struct view_access {
+			template<typename V>
+			static const V& get(const view<V>& v) noexcept {
+				return v.v;
+			}
+
+			template<typename V>
+			static V&& get(view<V>&& v) noexcept {
+				return std::move(v.v);
+			}
+
+			template<typename V>
+			static view<V> make(V&& v) {
+				return view<V>(std::move(v));
+			}
+		};
+
+		template<typename I>
+		struct view_of {
+			using type = range_view<
+				decltype(std::begin(std::declval<const I&>()))
+			>;
+
+			static type get(const I& i) {
+				return type{std::begin(i), std::end(i)};
+			}
+		};
+
+		template<typename V>
+		struct view_of<view<V>> {
+			using type = V;
+
+			static const V& get(const view<V>& v) {
+				return view_access::get(v);
+			}
+		};
+	}
+
+	/**
+	 * A lazily evaluated sequence of elements.
+	 *
+	 * Views are not constructed directly, but with `ftl::as_view`, and are
+	 * then transformed by the functions and concept instances of this module.
+	 * A view never owns the data it refers to, so the container it was created
+	 * from must outlive it. Iterators obtained from a view refer to that very
+	 * view object, and are only valid for as long as it is.
+	 *
+	 * Function objects given to the various stages are invoked through a
+	 * `const` reference, every time an element is visited. In particular,
+	 * filtering a mapped view evaluates the mapping function both in the test
+	 * and on dereference.
+	 *
+	 * \par Concepts
+	 * - \ref functorpg
+	 * - \ref foldablepg
+	 * - \ref zippablepg
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<int> v{1,2,3,4,5,6};
+	 *
+	 *   // No intermediate vectors are created
+	 *   auto even = [](int x){ return x % 2 == 0; };
+	 *   auto r = ftl::collect<std::vector>(
+	 *       [](int x){ return x*x; } % ftl::filter(even, ftl::as_view(v))
+	 *   );
+	 *   // r == {4,16,36}
+	 * \endcode
+	 *
+	 * \ingroup view
+	 */
+	template<typename V>
+	class view {
+	public:
+		/// Type of iterator used to traverse the view
+		using iterator = typename V::iterator;
+
+		/// Views do not permit mutation of their elements
+		using const_iterator = iterator;
+
+		/// Type of the elements of the view
+		using value_type = typename std::iterator_traits<iterator>::value_type;
+
+		view(const view&) = default;
+		view(view&&) = default;
+		view& operator= (const view&) = default;
+		view& operator= (view&&) = default;
+
+		/// Iterator to the first element of the view
+		iterator begin() const {
+			return v.begin();
+		}
+
+		/// Iterator to one past the last element of the view
+		iterator end() const {
+			return v.end();
+		}
+
+		/// Check whether the view yields no elements at all
+		bool empty() const {
+			return begin() == end();
+		}
+
+	private:
+		friend struct _dtl::view_access;
+
+		explicit view(V v) : v(std::move(v)) {}
+
+		V v;
+	};
+
+	template<typename V>
+	struct parametric_type_traits<view<V>> {
+		using value_type = typename view<V>::value_type;
+	};
+
+	/**
+	 * Create a view of the range `[b, e)`.
+	 *
+	 * \ingroup view
+	 */
+	template<typename It>
+	view<_dtl::range_view<It>> as_view(It b, It e) {
+		static_assert(InputIterator<It>(), "It must satisfy InputIterator");
+
+		return _dtl::view_access::make(
+			_dtl::range_view<It>{std::move(b), std::move(e)}
+		);
+	}
+
+	/**
+	 * Create a view of all the elements of `c`.
+	 *
+	 * `c` may be anything `std::begin` and `std::end` work on. As views do not
+	 * own their elements, rvalues are rejected.
+	 *
+	 * \ingroup view
+	 */
+	template<typename C>
+	auto as_view(C& c)
+	-> decltype(as_view(std::begin(c), std::end(c))) {
+		return as_view(std::begin(c), std::end(c));
+	}
+
+	template<typename C>
+	void as_view(const C&&) = delete;
+
+	/**
+	 * View the elements of `c` and `cs` in lockstep, as tuples of references.
+	 *
+	 * Each argument may be a container or another view. Dereferencing the
+	 * result yields a `std::tuple` of whatever each iterator yields, so no
+	 * element is copied, and a fold over the view never stores more than
+	 * one such tuple at a time. As with other zips, the view is as long as
+	 * the shortest of its arguments, all of which must outlive it.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   std::vector<int> xs{1,2,3};
+	 *   std::list<int> ys{4,5,6};
+	 *
+	 *   auto dot = ftl::foldl(
+	 *       [](int acc, std::tuple<const int&,const int&> t) {
+	 *           return acc + std::get<0>(t) * std::get<1>(t);
+	 *       },
+	 *       0, ftl::as_zip_view(xs, ys)
+	 *   );
+	 *   // dot == 32
+	 * \endcode
+	 *
+	 * \ingroup view
+	 */
+	template<
+			typename C, typename...Cs,
+			typename Z = _dtl::zip_view<
+				_dtl::tie_elements,
+				typename _dtl::view_of<C>::type,
+				typename _dtl::view_of<Cs>::type...
+			>
+	>
+	view<Z> as_zip_view(const C& c, const Cs&...cs) {
+		return _dtl::view_access::make(
+			Z{
+				_dtl::tie_elements{},
+				std::make_tuple(
+					_dtl::view_of<C>::get(c), _dtl::view_of<Cs>::get(cs)...
+				)
+			}
+		);
+	}
+
+	/**
+	 * View only the elements of `v` that satisfy `p`.
+	 *
+	 * \ingroup view
+	 */
+	template<typename P, typename V, typename P_ = plain_type<P>>
+	view<_dtl::filter_view<V,P_>> filter(P&& p, const view<V>& v) {
+		return _dtl::view_access::make(
+			_dtl::filter_view<V,P_>{
+				_dtl::view_access::get(v), std::forward<P>(p)
+			}
+		);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup view
+	 */
+	template<typename P, typename V, typename P_ = plain_type<P>>
+	view<_dtl::filter_view<V,P_>> filter(P&& p, view<V>&& v) {
+		return _dtl::view_access::make(
+			_dtl::filter_view<V,P_>{
+				_dtl::view_access::get(std::move(v)), std::forward<P>(p)
+			}
+		);
+	}
+
+	/**
+	 * View at most the first `n` elements of `v`.
+	 *
+	 * Nothing past the `n`:th element is evaluated, so `v` may well be
+	 * infinite, as a view of an ftl::stream can be.
+	 *
+	 * \ingroup view
+	 */
+	template<typename V>
+	view<_dtl::take_view<V>> take(std::size_t n, const view<V>& v) {
+		return _dtl::view_access::make(
+			_dtl::take_view<V>{_dtl::view_access::get(v), n}
+		);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup view
+	 */
+	template<typename V>
+	view<_dtl::take_view<V>> take(std::size_t n, view<V>&& v) {
+		return _dtl::view_access::make(
+			_dtl::take_view<V>{_dtl::view_access::get(std::move(v)), n}
+		);
+	}
+
+	/**
+	 * View the elements of `v` up until the first that does not satisfy `p`.
+	 *
+	 * \ingroup view
+	 */
+	template<typename P, typename V, typename P_ = plain_type<P>>
+	view<_dtl::take_while_view<V,P_>> takeWhile(P&& p, const view<V>& v) {
+		return _dtl::view_access::make(
+			_dtl::take_while_view<V,P_>{
+				_dtl::view_access::get(v), std::forward<P>(p)
+			}
+		);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup view
+	 */
+	template<typename P, typename V, typename P_ = plain_type<P>>
+	view<_dtl::take_while_view<V,P_>> takeWhile(P&& p, view<V>&& v) {
+		return _dtl::view_access::make(
+			_dtl::take_while_view<V,P_>{
+				_dtl::view_access::get(std::move(v)), std::forward<P>(p)
+			}
+		);
+	}
+
+	/**
+	 * View the concatenation of the containers `f` maps `v` to.
+	 *
+	 * Only the container of the element currently being visited is ever kept
+	 * alive, by the iterator traversing it.
+	 *
+	 * \ingroup view
+	 */
+	template<typename F, typename V, typename F_ = plain_type<F>>
+	view<_dtl::concat_view<V,F_>> concatMap(F&& f, const view<V>& v) {
+		return _dtl::view_access::make(
+			_dtl::concat_view<V,F_>{
+				_dtl::view_access::get(v), std::forward<F>(f)
+			}
+		);
+	}
+
+	/**
+	 * \overload
+	 *
+	 * \ingroup view
+	 */
+	template<typename F, typename V, typename F_ = plain_type<F>>
+	view<_dtl::concat_view<V,F_>> concatMap(F&& f, view<V>&& v) {
+		return _dtl::view_access::make(
+			_dtl::concat_view<V,F_>{
+				_dtl::view_access::get(std::move(v)), std::forward<F>(f)
+			}
+		);
+	}
+
+	/**
+	 * Materialise a view into a container of type `C`.
+	 *
+	 * The view is traversed once, and each element is inserted at the end of
+	 * the container.
+	 *
+	 * \par Examples
+	 *
+	 * \code
+	 *   auto l = ftl::collect<std::list<int>>(v);
+	 * \endcode
+	 *
+	 * \ingroup view
+	 */
+	template<typename C, typename V>
+	C collect(const view<V>& v) {
+		C c;
+		for(auto it = v.begin(); it != v.end(); ++it) {
+			c.insert(c.end(), *it);
+		}
+
+		return c;
+	}
+
+	/**
+	 * \overload
+	 *
+	 * Deduces the element type of the container from the view.
+	 *
+	 * \code
+	 *   auto s = ftl::collect<std::set>(v);
+	 * \endcode
+	 *
+	 * \ingroup view
+	 */
+	template<
+			template<typename...> class C,
+			typename V,
+			typename T = Value_type<view<V>>
+	>
+	C<T> collect(const view<V>& v) {
+		return collect<C<T>>(v);
+	}
+
+	/**
+	 * Functor instance for views.
+	 *
+	 * Mapping a view yields a new view, that applies the function to each
+	 * element as it is visited.
+	 *
+	 * \ingroup view
+	 */
+	template<typename V>
+	struct functor<view<V>> {
+		template<typename F, typename F_ = plain_type<F>>
+		static view<_dtl::map_view<V,F_>> map(F&& f, const view<V>& v) {
+			return _dtl::view_access::make(
+				_dtl::map_view<V,F_>{
+					_dtl::view_access::get(v), std::forward<F>(f)
+				}
+			);
+		}
+
+		template<typename F, typename F_ = plain_type<F>>
+		static view<_dtl::map_view<V,F_>> map(F&& f, view<V>&& v) {
+			return _dtl::view_access::make(
+				_dtl::map_view<V,F_>{
+					_dtl::view_access::get(std::move(v)), std::forward<F>(f)
+				}
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Zippable instance for views.
+	 *
+	 * The arguments after the first may be either other views or any
+	 * iterables, and the result is a new view. As with other zips, it is as
+	 * long as the shortest of them.
+	 *
+	 * \ingroup view
+	 */
+	template<typename V>
+	struct zippable<view<V>> {
+		template<
+				typename F, typename...Is,
+				typename F_ = plain_type<F>,
+				typename Z = _dtl::zip_view<
+					F_, V, typename _dtl::view_of<Is>::type...
+				>
+		>
+		static view<Z> zipWith(F&& f, const view<V>& v, const Is&...is) {
+			return _dtl::view_access::make(
+				Z{
+					std::forward<F>(f),
+					std::make_tuple(
+						_dtl::view_access::get(v), _dtl::view_of<Is>::get(is)...
+					)
+				}
+			);
+		}
+
+		static constexpr bool instance = true;
+	};
+
+	/**
+	 * Foldable instance for views.
+	 *
+	 * Folding is where a view is actually evaluated. As views can generally
+	 * not be traversed backwards, `foldr` first buffers the elements.
+	 *
+	 * \ingroup view
+	 */
+	template<typename V>
+	struct foldable<view<V>> {
+		using T = Value_type<view<V>>;
+
+		template<typename Fn, typename U>
+		static U foldl(Fn&& fn, U z, const view<V>& v) {
+			for(auto it = v.begin(); it != v.end(); ++it) {
+				z = fn(std::move(z), *it);
+			}
+
+			return z;
+		}
+
+		template<typename Fn, typename U>
+		static U foldr(Fn&& fn, U z, const view<V>& v) {
+			std::vector<T> buf;
+			for(auto it = v.begin(); it != v.end(); ++it) {
+				buf.push_back(*it);
+			}
+
+			for(auto it = buf.rbegin(); it != buf.rend(); ++it) {
+				z = fn(std::move(*it), std::move(z));
+			}
+
+			return z;
+		}
+
+		template<typename Fn, typename M = result_of<Fn(T)>>
+		static M foldMap(Fn fn, const view<V>& v) {
+			static_assert(
+				Monoid<M>(),
+				"The result of Fn(T) is not an instance of Monoid."
+			);
+
+			return foldMap_<M>(
+				fn, v, std::integral_constant<bool,AbsorbingMonoid<M>::value>{}
+			);
+		}
+
+		template<typename M = T>
+		static M fold(const view<V>& v) {
+			return foldMap(id, v);
+		}
+
+		static constexpr bool instance = true;
+
+	private:
+		template<typename M, typename Fn>
+		static M foldMap_(Fn& fn, const view<V>& v, std::false_type) {
+			auto z = monoid<M>::id();
+			for(auto it = v.begin(); it != v.end(); ++it) {
+				z = monoid<M>::append(std::move(z), fn(*it));
+			}
+
+			return z;
+		}
+
+		// Stops evaluating the view as soon as the result is known
+		template<typename M, typename Fn>
+		static M foldMap_(Fn& fn, const view<V>& v, std::true_type) {
+			auto z = monoid<M>::id();
+			for(auto it = v.begin(); it != v.end(); ++it) {
+				z = monoid<M>::append(std::move(z), fn(*it));
+				if(monoid<M>::absorbing(z))
+					break;
+			}
+
+			return z;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <stdexcept>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include <ftl/async.h>
+#include <ftl/either_trans.h>
+#include <ftl/maybe_trans.h>
+#include "async_tests.h"
+
+test_set async_tests{
+	std::string("async"),
+	{
+		std::make_tuple(
+			std::string("then runs when value is set"),
+			std::function<bool()>([]() -> bool {
+				ftl::promise<int> p;
+				int called = 0;
+
+				auto f = p.get_future().then([&called](int x){
+					++called;
+					return x+1;
+				});
+
+				if(called != 0 || f.ready())
+					return false;
+
+				p.set_value(1);
+
+				return called == 1 && f.ready() && f.get() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("then on executor"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_executor ex;
+
+				auto f = ftl::async(ex, [](){ return 1; })
+					.then(ex, [](int x){ return std::to_string(x); });
+
+				return f.get() == std::string("1");
+			})
+		),
+		std::make_tuple(
+			std::string("Exceptions propagate"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::inline_executor ex;
+				auto f = ftl::async(ex, []() -> int {
+					throw std::runtime_error("fail");
+				});
+				auto g = [](int x){ return x+1; } % f;
+
+				try {
+					g.get();
+				}
+				catch(std::runtime_error&) {
+					return true;
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::thread_executor ex;
+				auto fb = [](int x) { return std::to_string(x); }
+					% ftl::async(ex, [](){ return 1; });
+
+				return fb.get() == std::string("1");
+			})
+		),
+		std::make_tuple(
+			std::string("applicative::pure"),
+			std::function<bool()>([]() -> bool {
+
+				auto f = ftl::applicative<ftl::future<int>>::pure(10);
+
+				return f.ready() && f.get() == 10;
+			})
+		),
+		std::make_tuple(
+			std::string("applicative::apply"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+
+				ftl::function<int(int,int)> fn = [](int x, int y){ return x-y; };
+
+				ftl::promise<int> p1, p2;
+				auto f = fn % p1.get_future() * p2.get_future();
+
+				// Values may be set in any order
+				p2.set_value(1);
+				if(f.ready())
+					return false;
+
+				p1.set_value(3);
+
+				return f.ready() && f.get() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("applicative::apply[exception]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+
+				ftl::function<int(int,int)> fn = [](int x, int y){ return x-y; };
+
+				ftl::promise<int> p1, p2;
+				auto f = fn % p1.get_future() * p2.get_future();
+
+				p2.set_exception(
+					std::make_exception_ptr(std::runtime_error("fail"))
+				);
+				if(f.ready())
+					return false;
+
+				p1.set_value(3);
+
+				try {
+					f.get();
+				}
+				catch(std::runtime_error&) {
+					return true;
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("eitherT::apply[independent]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using eT = eitherT<std::string,future<int>>;
+
+				static_assert(independent_apply<eT>::value, "");
+
+				function<int(int,int)> fn = [](int x, int y){ return x+y; };
+
+				promise<either<std::string,int>> p1, p2;
+				auto e = fn % eT{p1.get_future()} * eT{p2.get_future()};
+
+				// The result is ready once both are, in either order
+				p2.set_value(make_right<std::string>(2));
+				bool early = e->ready();
+				p1.set_value(make_right<std::string>(1));
+
+				auto& r = e->get();
+				return !early && r.template is<Right<int>>()
+					&& *get<Right<int>>(r) == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("maybeT::apply[independent]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using mT = maybeT<future<int>>;
+
+				function<int(int,int)> fn = [](int x, int y){ return x+y; };
+
+				promise<maybe<int>> p1, p2;
+				auto m = fn % mT{p1.get_future()} * mT{p2.get_future()};
+
+				p1.set_value(nothing<int>());
+				bool early = m->ready();
+				p2.set_value(just(2));
+
+				return !early && m->get() == nothing<int>();
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				ftl::thread_executor ex;
+				auto f = ftl::async(ex, [](){ return 1; });
+				auto g = f >>= [&ex](int x) {
+					return ftl::async(ex, [x](){ return x+1; });
+				};
+
+				return g.get() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("monad::join"),
+			std::function<bool()>([]() -> bool {
+				using ftl::future;
+
+				ftl::promise<future<int>> p;
+				auto f = ftl::monad<future<int>>::join(p.get_future());
+
+				p.set_value(ftl::monad<future<int>>::pure(1));
+
+				return f.get() == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+
+				ftl::thread_executor ex;
+				auto f =
+					ftl::async(ex, [](){ return ftl::sum(1); })
+					^
+					ftl::async(ex, [](){ return ftl::sum(1); });
+
+				return static_cast<int>(f.get()) == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("Move-only tasks and continuations"),
+			std::function<bool()>([]() -> bool {
+				struct add {
+					int operator()(int x) const { return x + *p; }
+					std::unique_ptr<int> p;
+				};
+
+				struct get {
+					int operator()() const { return *p; }
+					std::unique_ptr<int> p;
+				};
+
+				ftl::thread_pool pool(2);
+				auto f = ftl::async(pool, get{std::unique_ptr<int>(new int(1))});
+				auto g = f.then(add{std::unique_ptr<int>(new int(2))});
+				auto h = g.then(pool, add{std::unique_ptr<int>(new int(3))});
+
+				return h.get() == 6;
+			})
+		),
+		std::make_tuple(
+			std::string("when_all[vector]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<ftl::promise<int>> ps(3);
+				std::vector<ftl::future<int>> fs;
+				for(auto& p : ps)
+					fs.push_back(p.get_future());
+
+				auto all = ftl::when_all(fs);
+				ps[2].set_value(3);
+				ps[0].set_value(1);
+				bool early = all.ready();
+				ps[1].set_value(2);
+
+				auto none = ftl::when_all(std::vector<ftl::future<int>>());
+
+				return !early && all.ready()
+					&& all.get() == std::vector<int>{1,2,3}
+					&& none.ready() && none.get().empty();
+			})
+		),
+		std::make_tuple(
+			std::string("when_all[variadic]"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(2);
+
+				auto r = ftl::when_all(
+					ftl::async(pool, [](){ return 1; }),
+					ftl::async(pool, [](){ return std::string("a"); }),
+					ftl::async(pool, [](){ return 2.5; })
+				);
+
+				return r.get() == std::make_tuple(1, std::string("a"), 2.5);
+			})
+		),
+		std::make_tuple(
+			std::string("when_all[exception]"),
+			std::function<bool()>([]() -> bool {
+				ftl::promise<int> p1, p2;
+
+				auto all = ftl::when_all(p1.get_future(), p2.get_future());
+				p2.set_exception(
+					std::make_exception_ptr(std::runtime_error("fail"))
+				);
+
+				// Failed without waiting for p1
+				bool failed = all.ready();
+				p1.set_value(1);
+
+				try {
+					all.get();
+				}
+				catch(std::runtime_error&) {
+					return failed;
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("when_any"),
+			std::function<bool()>([]() -> bool {
+				ftl::promise<int> p1, p2, p3;
+
+				auto any = ftl::when_any(
+					p1.get_future(), p2.get_future(), p3.get_future()
+				);
+				p2.set_value(20);
+				p1.set_value(10);
+
+				auto none = ftl::when_any(std::vector<ftl::future<int>>());
+
+				return any.ready()
+					&& any.get() == std::make_pair(std::size_t(1), 20)
+					&& none.ready();
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::mconcat"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(4);
+
+				std::vector<ftl::future<ftl::sum_monoid<int>>> fs;
+				for(int i = 1; i <= 100; ++i)
+					fs.push_back(ftl::async(pool, [i](){ return ftl::sum(i); }));
+
+				return static_cast<int>(ftl::mconcat(fs).get()) == 5050;
+			})
+		),
+	}
+};
+
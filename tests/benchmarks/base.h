@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_BENCHMARKS_BASE_H
+#define FTL_BENCHMARKS_BASE_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <ftl/instrument.h>
+
+/**
+ * A benchmark is a name and an operation to run a given number of times.
+ *
+ * The operation is handed the number of iterations to run, so that any
+ * setup it needs is amortised over all of them, rather than timed per
+ * iteration.
+ */
+using bench_t = std::tuple<std::string,std::function<void(std::size_t)>>;
+using bench_set = std::tuple<std::string,std::vector<bench_t>>;
+
+/// Measurements of a benchmark, all per iteration
+struct bench_result {
+	std::string name;
+	std::size_t iterations;
+	double ns;
+	double allocs;
+	double bytes;
+
+	/// Allocations counted against each ftl::alloc_source
+	std::vector<double> sources;
+};
+
+/**
+ * Keep the compiler from optimising away the computation of `t`.
+ */
+template<typename T>
+inline void keep(const T& t) {
+	asm volatile("" : : "r"(&t) : "memory");
+}
+
+/**
+ * Run every benchmark of `bs` whose full name contains `filter`.
+ *
+ * Each is run for at least `min_ms` milliseconds.
+ */
+std::vector<bench_result> run_bench_set(
+		const bench_set& bs, const std::string& filter, double min_ms);
+
+#endif
+
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <functional>
+#include <list>
+#include <string>
+#include <vector>
+#include <ftl/vector.h>
+#include <ftl/list.h>
+#include <ftl/view.h>
+#include <ftl/hash_map.h>
+#include <ftl/persistent_vector.h>
+#include "container_benchmarks.h"
+
+namespace {
+	std::vector<int> iota(int n) {
+		std::vector<int> v;
+		v.reserve(n);
+		for(int i = 0; i < n; ++i)
+			v.push_back(i);
+
+		return v;
+	}
+}
+
+bench_set container_benchmarks{
+	std::string("container"),
+	std::vector<bench_t>{
+		std::make_tuple(
+			std::string("vector::fmap[1000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator%;
+
+				auto v = iota(1000);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto w = [](int x){ return x*2; } % v;
+					keep(w);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("vector::foldMap[sum, 1000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				auto v = iota(1000);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto s = ftl::foldMap(ftl::sum<int>, v);
+					keep(s);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("vector::bind[1000x2]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator>>=;
+
+				auto v = iota(1000);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto w = v >>= [](int x){ return std::vector<int>{x, -x}; };
+					keep(w);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("vector::zipWith[1000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				auto v = iota(1000);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto w = ftl::zipWith([](int x, int y){ return x+y; }, v, v);
+					keep(w);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("vector::fmap[float, 100000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator%;
+
+				std::vector<float> v(100000, 1.5f);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto w = [](float x){ return x*2.f + 1.f; } % v;
+					keep(w);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("vector::zipWith[std::plus<float>, 100000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				std::vector<float> v(100000, 1.5f);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto w = ftl::zipWith(std::plus<float>(), v, v);
+					keep(w);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("list::fmap[1000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator%;
+
+				auto v = iota(1000);
+				std::list<int> l(v.begin(), v.end());
+				for(std::size_t i = 0; i < n; ++i) {
+					auto w = [](int x){ return x*2; } % l;
+					keep(w);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("view::map.filter.foldl[1000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator%;
+
+				auto v = iota(1000);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto s = ftl::foldl(
+						[](int z, int x){ return z+x; }, 0,
+						ftl::filter(
+							[](int x){ return x % 3 == 0; },
+							[](int x){ return x*2; } % ftl::as_view(v)
+						)
+					);
+					keep(s);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("hash_map::insert.find[1000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					ftl::hash_map<int,int> m;
+					for(int k = 0; k < 1000; ++k)
+						m[k * 7] = k;
+
+					int s = 0;
+					for(int k = 0; k < 1000; ++k)
+						s += m.find(k * 7)->second;
+
+					keep(s);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("persistent_vector::push_back[1000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					ftl::persistent_vector<int> p;
+					for(int k = 0; k < 1000; ++k)
+						p = p.push_back(k);
+
+					keep(p);
+				}
+			})
+		)
+	}
+};
+
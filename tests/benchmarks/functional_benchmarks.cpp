@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <ftl/function.h>
+#include <ftl/functional.h>
+#include <ftl/ord.h>
+#include <ftl/sort.h>
+#include "functional_benchmarks.h"
+
+namespace {
+	// A record sorted on all three of its keys
+	struct rec {
+		int a;
+		int b;
+		int c;
+	};
+
+	// Few distinct values for the first two keys, so that ties are common
+	std::vector<rec> make_records(std::size_t n) {
+		std::vector<rec> v;
+		v.reserve(n);
+
+		unsigned x = 1;
+		for(std::size_t i = 0; i < n; ++i) {
+			x = x * 1664525u + 1013904223u;
+			v.push_back(rec{int(x >> 24) % 16, int(x >> 16) % 64, int(x & 0xffff)});
+		}
+
+		return v;
+	}
+
+	const std::size_t num_records = 10000000;
+}
+
+bench_set functional_benchmarks{
+	std::string("functional"),
+	std::vector<bench_t>{
+		std::make_tuple(
+			std::string("function::call"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				ftl::function<int(int)> f = [](int x){ return x+1; };
+
+				int x = 0;
+				for(std::size_t i = 0; i < n; ++i) {
+					x = f(x);
+					keep(x);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("function::copy"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				std::vector<int> v(8, 1);
+				ftl::function<int(int)> f = [v](int x){ return x+v[0]; };
+
+				for(std::size_t i = 0; i < n; ++i) {
+					auto g = f;
+					keep(g);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("function::copy[std::allocator]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				std::vector<int> v(8, 1);
+				auto h = [v](int x){ return x+v[0]; };
+				ftl::function<int(int)> f(
+					std::allocator_arg, std::allocator<decltype(h)>(), h
+				);
+
+				for(std::size_t i = 0; i < n; ++i) {
+					auto g = f;
+					keep(g);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("function::map[chain of 4]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator%;
+
+				auto inc = [](int x){ return x+1; };
+				ftl::function<int(int)> f = inc;
+				auto g = inc % (inc % (inc % (inc % f)));
+
+				int x = 0;
+				for(std::size_t i = 0; i < n; ++i) {
+					x = g(x);
+					keep(x);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("reader::map[chain of 4]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator%;
+
+				auto inc = [](int x){ return x+1; };
+				auto g = inc % (inc % (inc % (inc % ftl::make_reader(inc))));
+
+				int x = 0;
+				for(std::size_t i = 0; i < n; ++i) {
+					x = g(x);
+					keep(x);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("unique_function::call"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				ftl::unique_function<int(int)> f = [](int x){ return x+1; };
+
+				int x = 0;
+				for(std::size_t i = 0; i < n; ++i) {
+					x = f(x);
+					keep(x);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("curry[direct call]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				auto g = [](int x, int y, int z){ return x+y+z; };
+
+				for(std::size_t i = 0; i < n; ++i) {
+					int x = g(1, 2, int(i));
+					keep(x);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("curry[1 then 2 arguments]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				auto f = ftl::curry([](int x, int y, int z){ return x+y+z; });
+
+				for(std::size_t i = 0; i < n; ++i) {
+					int x = f(1)(2, int(i));
+					keep(x);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("curry[partial application]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				auto f = ftl::curry([](int x, int y, int z){ return x+y+z; });
+
+				for(std::size_t i = 0; i < n; ++i) {
+					int x = f(1)(2)(int(i));
+					keep(x);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("sort[comparing ^ getComparator]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator^;
+
+				std::vector<std::string> v;
+				for(int i = 0; i < 1000; ++i)
+					v.push_back(std::to_string((i * 7919) % 1000));
+
+				auto cmp = ftl::comparing(&std::string::size)
+					^ ftl::getComparator<std::string>();
+
+				for(std::size_t i = 0; i < n; ++i) {
+					auto w = v;
+					std::sort(w.begin(), w.end(), ftl::asc(cmp));
+					keep(w);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("sort[3 keys, function chain, 10M records]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator^;
+				using cmp_t = ftl::function<ftl::ord(const rec&,const rec&)>;
+
+				// The comparator as it had to be built before comparators
+				// kept their types: each key erased, chained by the monoid
+				// instance of ftl::function
+				cmp_t by_a = ftl::comparing(&rec::a);
+				cmp_t by_b = ftl::comparing(&rec::b);
+				cmp_t by_c = ftl::comparing(&rec::c);
+				auto cmp = by_a ^ by_b ^ by_c;
+
+				auto v = make_records(num_records);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto w = v;
+					std::sort(w.begin(), w.end(), ftl::asc(cmp));
+					keep(w);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("sort[3 keys, comparing ^ comparing, 10M records]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator^;
+
+				auto cmp = ftl::comparing(&rec::a)
+					^ ftl::comparing(&rec::b)
+					^ ftl::comparing(&rec::c);
+
+				auto v = make_records(num_records);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto w = v;
+					std::sort(w.begin(), w.end(), ftl::asc(cmp));
+					keep(w);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("sortOn[int key]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				std::vector<int> v;
+				for(int i = 0; i < 1000; ++i)
+					v.push_back((i * 7919) % 1000);
+
+				for(std::size_t i = 0; i < n; ++i) {
+					auto w = v;
+					ftl::sortOn(w.begin(), w.end(), [](int x){ return -x; });
+					keep(w);
+				}
+			})
+		)
+	}
+};
+
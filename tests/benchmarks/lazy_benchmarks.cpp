@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ftl/lazy.h>
+#include <ftl/shared_lazy.h>
+#include <ftl/lazy_trans.h>
+#include <ftl/list.h>
+#include <ftl/vector.h>
+#include <ftl/codensity.h>
+#include <ftl/trampoline.h>
+#include "lazy_benchmarks.h"
+
+namespace {
+	/*
+	 * A program that says a number of words before finishing with a value.
+	 *
+	 * As with free monads in general, bind has to walk down to the end of the
+	 * program to find the value, rebuilding everything on the way. Binds
+	 * nested to the left thus take time quadratic in the number of words,
+	 * which is precisely the case codensity is meant to fix.
+	 */
+	template<typename T>
+	struct script {
+		// Null once the program is done and value is set
+		std::shared_ptr<const script> next;
+		int word;
+		T value;
+	};
+
+	template<typename T>
+	script<T> finish(T t) {
+		return script<T>{nullptr, 0, std::move(t)};
+	}
+
+	template<typename T>
+	script<T> say(int w, T t) {
+		return script<T>{std::make_shared<const script<T>>(finish(std::move(t))), w, T{}};
+	}
+}
+
+namespace ftl {
+	template<typename T>
+	struct monad<script<T>>
+	: deriving_join<in_terms_of_bind<script<T>>>
+	, deriving_apply<in_terms_of_bind<script<T>>> {
+
+		static script<T> pure(T t) {
+			return finish(std::move(t));
+		}
+
+		template<typename F, typename U = result_of<F(T)>>
+		static script<U> map(F f, const script<T>& s) {
+			return bind(s, [f](const T& t){ return finish(f(t)); });
+		}
+
+		template<typename F, typename U = Value_type<result_of<F(T)>>>
+		static script<U> bind(const script<T>& s, F f) {
+			if(!s.next)
+				return f(s.value);
+
+			return script<U>{
+				std::make_shared<const script<U>>(bind(*s.next, f)), s.word, U{}
+			};
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
+namespace {
+	int words(const script<int>& s) {
+		int n = 0;
+		for(auto p = &s; p->next; p = p->next.get())
+			++n;
+
+		return n;
+	}
+
+	ftl::trampoline<long> sum_to(long n) {
+		using ftl::operator>>=;
+
+		if(n == 0)
+			return ftl::done(0L);
+
+		return ftl::suspend([n]{ return sum_to(n-1); })
+			>>= [n](long s){ return ftl::done(s + n); };
+	}
+}
+
+bench_set lazy_benchmarks{
+	std::string("lazy"),
+	std::vector<bench_t>{
+		std::make_tuple(
+			std::string("lazy::force"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					ftl::lazy<int> l{ftl::unique_function<int()>([i]{ return int(i); })};
+					keep(*l);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("lazy::fmap[chain of 10]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator%;
+
+				for(std::size_t i = 0; i < n; ++i) {
+					ftl::lazy<int> l{ftl::unique_function<int()>([i]{ return int(i); })};
+					for(int k = 0; k < 10; ++k)
+						l = [](int x){ return x+1; } % l;
+
+					keep(*l);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("shared_lazy::force"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					ftl::shared_lazy<int> l{[i]{ return int(i); }};
+					keep(*l);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("batch_lazyT::fmap[1000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator%;
+
+				std::vector<int> v(1000, 1);
+				for(std::size_t i = 0; i < n; ++i) {
+					ftl::batch_lazyT<std::vector<int>> l{v};
+					auto m = [](int x){ return x*2; } % l;
+					keep(*m);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("list::bind[left nested, 100]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator>>=;
+
+				for(std::size_t i = 0; i < n; ++i) {
+					std::list<int> l{0};
+					for(int k = 0; k < 100; ++k)
+						l = l >>= [](int x){ return std::list<int>{x+1}; };
+
+					keep(l);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("codensity::bind[left nested, 100]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator>>=;
+
+				for(std::size_t i = 0; i < n; ++i) {
+					auto c = ftl::liftCodensity<std::list<int>>(std::list<int>{0});
+					for(int k = 0; k < 100; ++k)
+						c = c >>= [](int x){ return std::list<int>{x+1}; };
+
+					auto l = ftl::lowerCodensity(c);
+					keep(l);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("script::bind[left nested, 1000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator>>=;
+
+				for(std::size_t i = 0; i < n; ++i) {
+					auto s = finish(0);
+					for(int k = 0; k < 1000; ++k)
+						s = s >>= [](int x){ return say(x, x+1); };
+
+					keep(words(s));
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("codensity::bind[left nested script, 1000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator>>=;
+
+				for(std::size_t i = 0; i < n; ++i) {
+					auto c = ftl::liftCodensity<script<int>>(finish(0));
+					for(int k = 0; k < 1000; ++k)
+						c = c >>= [](int x){ return say(x, x+1); };
+
+					keep(words(ftl::lowerCodensity(c)));
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("trampoline::run[1000 deep]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				for(std::size_t i = 0; i < n; ++i) {
+					auto s = sum_to(1000).run();
+					keep(s);
+				}
+			})
+		)
+	}
+};
+
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include "functional_benchmarks.h"
+#include "sum_type_benchmarks.h"
+#include "container_benchmarks.h"
+#include "lazy_benchmarks.h"
+#include "parallel_benchmarks.h"
+#include "parser_benchmarks.h"
+
+/*
+ * Every allocation in the program goes through these, which is how the
+ * number of allocations and bytes allocated per iteration are measured.
+ * Which ftl components they were made by is counted by ftl itself; see
+ * ftl/instrument.h.
+ */
+namespace {
+	std::atomic<std::size_t> allocations{0};
+	std::atomic<std::size_t> allocated_bytes{0};
+
+	void* counted_new(std::size_t n) {
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		allocated_bytes.fetch_add(n, std::memory_order_relaxed);
+
+		if(void* p = std::malloc(n ? n : 1))
+			return p;
+
+		throw std::bad_alloc();
+	}
+}
+
+void* operator new(std::size_t n) {
+	return counted_new(n);
+}
+
+void* operator new[](std::size_t n) {
+	return counted_new(n);
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+namespace {
+	struct sample {
+		double ms;
+		std::size_t allocs;
+		std::size_t bytes;
+		std::vector<std::size_t> sources;
+	};
+
+	std::vector<std::size_t> source_counts() {
+		std::vector<std::size_t> r(ftl::alloc_sources);
+		for(std::size_t i = 0; i < ftl::alloc_sources; ++i)
+			r[i] = ftl::allocation_count(ftl::alloc_source(i)).allocations;
+
+		return r;
+	}
+
+	sample measure(const std::function<void(std::size_t)>& f, std::size_t n) {
+		using clock = std::chrono::steady_clock;
+
+		auto a = allocations.load();
+		auto b = allocated_bytes.load();
+		auto srcs = source_counts();
+		auto start = clock::now();
+
+		f(n);
+
+		std::chrono::duration<double,std::milli> t = clock::now() - start;
+		sample s{
+			t.count(), allocations.load() - a, allocated_bytes.load() - b,
+			source_counts()
+		};
+
+		for(std::size_t i = 0; i < srcs.size(); ++i)
+			s.sources[i] -= srcs[i];
+
+		return s;
+	}
+}
+
+std::vector<bench_result> run_bench_set(
+		const bench_set& bs, const std::string& filter, double min_ms) {
+	std::vector<bench_result> rs;
+
+	for(const auto& b : std::get<1>(bs)) {
+		auto name = std::get<0>(bs) + "/" + std::get<0>(b);
+		if(name.find(filter) == std::string::npos)
+			continue;
+
+		auto& f = std::get<1>(b);
+
+		// Warm up, then grow the iteration count until a run is long enough
+		measure(f, 1);
+
+		std::size_t n = 1;
+		auto s = measure(f, n);
+		while(s.ms < min_ms) {
+			double scale = s.ms > 0 ? min_ms / s.ms * 1.25 : 100;
+			n = static_cast<std::size_t>(n * std::min(std::max(scale, 2.0), 100.0));
+			s = measure(f, n);
+		}
+
+		std::vector<double> sources;
+		for(auto c : s.sources)
+			sources.push_back(double(c) / n);
+
+		rs.push_back(bench_result{
+			name, n, s.ms * 1e6 / n, double(s.allocs) / n, double(s.bytes) / n,
+			std::move(sources)
+		});
+	}
+
+	return rs;
+}
+
+namespace {
+	// The ftl components that allocated, with allocations per iteration,
+	// leaving out those that only did so once or twice in setting up
+	std::string by_source(const bench_result& r) {
+		std::ostringstream os;
+		os << std::fixed << std::setprecision(2);
+
+		for(std::size_t i = 0; i < r.sources.size(); ++i) {
+			if(r.sources[i] < 0.005)
+				continue;
+
+			if(os.tellp() > 0)
+				os << ", ";
+
+			os << ftl::alloc_source_name(ftl::alloc_source(i)) << " " << r.sources[i];
+		}
+
+		return os.str();
+	}
+
+	void print_table(const std::vector<bench_result>& rs, std::ostream& os) {
+		os << std::left << std::setw(48) << "benchmark"
+			<< std::right << std::setw(14) << "ns/op"
+			<< std::setw(14) << "allocs/op"
+			<< std::setw(14) << "bytes/op"
+			<< "  ftl allocs/op" << std::endl;
+
+		os << std::fixed;
+		for(auto& r : rs) {
+			os << std::left << std::setw(48) << r.name << std::right
+				<< std::setprecision(1) << std::setw(14) << r.ns
+				<< std::setprecision(2) << std::setw(14) << r.allocs
+				<< std::setprecision(1) << std::setw(14) << r.bytes
+				<< "  " << by_source(r) << std::endl;
+		}
+	}
+
+	void print_json(const std::vector<bench_result>& rs, std::ostream& os) {
+		os << "{\"benchmarks\": [";
+
+		bool first = true;
+		for(auto& r : rs) {
+			os << (first ? "\n" : ",\n") << "  {\"name\": \"" << r.name
+				<< "\", \"iterations\": " << r.iterations
+				<< ", \"ns_per_op\": " << r.ns
+				<< ", \"allocs_per_op\": " << r.allocs
+				<< ", \"bytes_per_op\": " << r.bytes
+				<< ", \"ftl_allocs_per_op\": {";
+
+			for(std::size_t i = 0; i < r.sources.size(); ++i) {
+				os << (i ? ", \"" : "\"")
+					<< ftl::alloc_source_name(ftl::alloc_source(i))
+					<< "\": " << r.sources[i];
+			}
+
+			os << "}}";
+
+			first = false;
+		}
+
+		os << "\n]}" << std::endl;
+	}
+}
+
+/*
+ * Usage: ftl_benchmarks [--json] [--min-time=<ms>] [filter]
+ *
+ * Runs every benchmark whose name, "<set>/<benchmark>", contains filter.
+ */
+int main(int argc, char** argv) {
+	bool json = false;
+	double min_ms = 100;
+	std::string filter;
+
+	for(int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+
+		if(arg == "--json")
+			json = true;
+		else if(arg.compare(0, 11, "--min-time=") == 0)
+			min_ms = std::atof(arg.c_str() + 11);
+		else
+			filter = arg;
+	}
+
+	bench_set* sets[] = {
+		&functional_benchmarks,
+		&sum_type_benchmarks,
+		&container_benchmarks,
+		&lazy_benchmarks,
+		&parallel_benchmarks,
+		&parser_benchmarks
+	};
+
+	std::vector<bench_result> rs;
+	for(auto s : sets) {
+		auto r = run_bench_set(*s, filter, min_ms);
+		rs.insert(rs.end(), r.begin(), r.end());
+	}
+
+	if(json)
+		print_json(rs, std::cout);
+	else
+		print_table(rs, std::cout);
+
+	return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include <ftl/vector.h>
+#include <ftl/parallel.h>
+#include <ftl/async.h>
+#include "parallel_benchmarks.h"
+
+namespace {
+	std::vector<int> ones(int n) {
+		return std::vector<int>(n, 1);
+	}
+}
+
+bench_set parallel_benchmarks{
+	std::string("parallel"),
+	std::vector<bench_t>{
+		std::make_tuple(
+			std::string("fmap[par, 100000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				auto v = ones(100000);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto r = ftl::fmap(ftl::par, [](int x){ return x*2; }, v);
+					keep(r);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap[par, sum, 100000]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				auto v = ones(100000);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto r = ftl::foldMap(ftl::par, ftl::sum<int>, v);
+					keep(r);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("future::then[ready]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				auto f = ftl::monad<ftl::future<int>>::pure(1);
+				for(std::size_t i = 0; i < n; ++i) {
+					auto g = f.then([](int x){ return x+1; });
+					keep(g.get());
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("future::apply[pending]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator%;
+				using ftl::operator*;
+
+				ftl::function<int(int,int)> fn = [](int x, int y){ return x+y; };
+				for(std::size_t i = 0; i < n; ++i) {
+					ftl::promise<int> p1, p2;
+					auto f = fn % p1.get_future() * p2.get_future();
+
+					p1.set_value(1);
+					p2.set_value(2);
+					keep(f.get());
+				}
+			})
+		)
+	}
+};
+
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include "parser_combinator/parser_combinator.h"
+#include "parser_combinator/static_parser.h"
+#include "parser_benchmarks.h"
+
+namespace {
+	std::string numbers(int n) {
+		std::string s;
+		for(int i = 0; i < n; ++i)
+			s += std::to_string(i * 7919 % 100000) + " ";
+
+		return s;
+	}
+}
+
+bench_set parser_benchmarks{
+	std::string("parser"),
+	std::vector<bench_t>{
+		std::make_tuple(
+			std::string("many1(oneOf)[digits, 1MB]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator<<;
+
+				std::string s(1 << 20, '7');
+				auto p = many1(oneOf("0123456789"));
+				for(std::size_t i = 0; i < n; ++i) {
+					auto r = run(p, s);
+					keep(r);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("takeWhile1[digits, 1MB]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				std::string s(1 << 20, '7');
+				auto p = takeWhile1("0123456789");
+				for(std::size_t i = 0; i < n; ++i) {
+					auto r = run(p, s);
+					keep(r);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("many(digits << space)[1000 numbers]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator<<;
+
+				auto s = numbers(1000);
+				auto num = takeWhile1("0123456789") << parseChar(' ');
+				auto p = many(ftl::fmap([](slice x){ return x[0]; }, num));
+				for(std::size_t i = 0; i < n; ++i) {
+					auto r = run(p, s);
+					keep(r);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("static many(digits << space)[1000 numbers]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using namespace sp;
+
+				auto s = numbers(1000);
+				auto num = take_while1("0123456789") << ch(' ');
+				auto p = erase(many([](slice x){ return x[0]; } % num));
+				for(std::size_t i = 0; i < n; ++i) {
+					auto r = run(p, s);
+					keep(r);
+				}
+			})
+		)
+	}
+};
+
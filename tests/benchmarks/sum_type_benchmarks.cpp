@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include <ftl/sum_type.h>
+#include <ftl/maybe.h>
+#include <ftl/either.h>
+#include "sum_type_benchmarks.h"
+
+namespace {
+	struct A { int x; };
+	struct B { int x; };
+	struct C { int x; };
+	struct D { int x; };
+	struct E { int x; };
+	struct F { int x; };
+	struct G { int x; };
+	struct H { int x; };
+
+	using ab = ftl::sum_type<A,B>;
+	using abc = ftl::sum_type<A,B,C>;
+	using wide = ftl::sum_type<A,B,C,D,E,F,G,H>;
+
+	template<typename T>
+	wide make_wide(int i) {
+		return wide{ftl::constructor<T>(), T{i}};
+	}
+
+	template<std::size_t N>
+	struct alt { int x; };
+
+	using widest = ftl::sum_type<
+		alt<0>,alt<1>,alt<2>,alt<3>,alt<4>,alt<5>,alt<6>,alt<7>,
+		alt<8>,alt<9>,alt<10>,alt<11>,alt<12>,alt<13>,alt<14>,alt<15>,
+		alt<16>,alt<17>,alt<18>,alt<19>,alt<20>,alt<21>,alt<22>,alt<23>,
+		alt<24>,alt<25>,alt<26>,alt<27>,alt<28>,alt<29>,alt<30>,alt<31>
+	>;
+
+	template<std::size_t N>
+	void push_widest(std::vector<widest>& v) {
+		v.push_back(widest{ftl::constructor<alt<N>>(), alt<N>{int(N)}});
+	}
+
+	template<std::size_t...Ns>
+	std::vector<widest> make_widest(ftl::seq<Ns...>) {
+		std::vector<widest> v;
+		// Expanding into an initializer list runs the pushes in order
+		auto unused = {(push_widest<Ns>(v), 0)...};
+		(void)unused;
+		return v;
+	}
+
+	struct get_x {
+		template<std::size_t N>
+		int operator() (const alt<N>& a) const noexcept {
+			return a.x;
+		}
+	};
+
+	// Match expressions take a clause per alternative, all get_x here
+	template<std::size_t>
+	using clause = get_x;
+
+	template<std::size_t...Ns>
+	int match_widest(const widest& w, ftl::seq<Ns...>) {
+		return w.match(clause<Ns>{}...);
+	}
+}
+
+bench_set sum_type_benchmarks{
+	std::string("sum_type"),
+	std::vector<bench_t>{
+		std::make_tuple(
+			std::string("match[2 alternatives]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				std::vector<ab> v{
+					ab{ftl::constructor<A>(), A{1}},
+					ab{ftl::constructor<B>(), B{2}}
+				};
+
+				int r = 0;
+				for(std::size_t i = 0; i < n; ++i) {
+					r += v[i % 2].match(
+						[](const A& a){ return a.x; },
+						[](const B& b){ return b.x*2; }
+					);
+				}
+
+				keep(r);
+			})
+		),
+		std::make_tuple(
+			std::string("match[3 alternatives]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				std::vector<abc> v{
+					abc{ftl::constructor<A>(), A{1}},
+					abc{ftl::constructor<B>(), B{2}},
+					abc{ftl::constructor<C>(), C{3}}
+				};
+
+				int r = 0;
+				for(std::size_t i = 0; i < n; ++i) {
+					r += v[i % 3].match(
+						[](const A& a){ return a.x; },
+						[](const B& b){ return b.x*2; },
+						[](const C& c){ return c.x*3; }
+					);
+				}
+
+				keep(r);
+			})
+		),
+		std::make_tuple(
+			std::string("match[8 alternatives]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				std::vector<wide> v{
+					make_wide<A>(1), make_wide<B>(2), make_wide<C>(3),
+					make_wide<D>(4), make_wide<E>(5), make_wide<F>(6),
+					make_wide<G>(7), make_wide<H>(8)
+				};
+
+				int r = 0;
+				for(std::size_t i = 0; i < n; ++i) {
+					r += v[i % 8].match(
+						[](const A& a){ return a.x; },
+						[](const B& b){ return b.x; },
+						[](const C& c){ return c.x; },
+						[](const D& d){ return d.x; },
+						[](const E& e){ return e.x; },
+						[](const F& f){ return f.x; },
+						[](const G& g){ return g.x; },
+						[](const H& h){ return h.x; }
+					);
+				}
+
+				keep(r);
+			})
+		),
+		std::make_tuple(
+			std::string("match[32 alternatives]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				auto v = make_widest(ftl::gen_seq<0,31>());
+
+				int r = 0;
+				for(std::size_t i = 0; i < n; ++i)
+					r += match_widest(v[i % 32], ftl::gen_seq<0,31>());
+
+				keep(r);
+			})
+		),
+		std::make_tuple(
+			std::string("copy[std::string alternative]"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				ftl::sum_type<int,std::string> s{
+					ftl::constructor<std::string>(), "not a small string, really"
+				};
+
+				for(std::size_t i = 0; i < n; ++i) {
+					auto t = s;
+					keep(t);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("maybe::fmap"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator%;
+
+				auto m = ftl::just(1);
+				for(std::size_t i = 0; i < n; ++i) {
+					m = [](int x){ return x+1; } % m;
+					keep(m);
+				}
+			})
+		),
+		std::make_tuple(
+			std::string("either::bind"),
+			std::function<void(std::size_t)>([](std::size_t n) {
+				using ftl::operator>>=;
+
+				auto e = ftl::make_right<std::string>(1);
+				for(std::size_t i = 0; i < n; ++i) {
+					e = e >>= [](int x){ return ftl::make_right<std::string>(x+1); };
+					keep(e);
+				}
+			})
+		)
+	}
+};
+
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <ftl/binary.h>
+#include <ftl/maybe.h>
+#include <ftl/either.h>
+#include "binary_tests.h"
+
+using maybe_layout = ftl::binary_layout<ftl::maybe<double>>;
+static_assert(maybe_layout::tag_size == 1, "");
+static_assert(maybe_layout::payload_offset == alignof(double), "");
+static_assert(maybe_layout::size == alignof(double) + sizeof(double), "");
+
+using either_layout = ftl::binary_layout<ftl::either<std::int16_t,char>>;
+static_assert(either_layout::payload_offset == 2, "");
+static_assert(either_layout::size == 4, "");
+
+test_set binary_tests{
+	std::string("binary"),
+	{
+		std::make_tuple(
+			std::string("write and read back"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using E = either<int,float>;
+
+				unsigned char buf[2 * binary_layout<E>::size + 1];
+
+				// Deliberately misaligned, which read copes with
+				auto n = write(E{make_right<int>(1.5f)}, buf + 1);
+				write(E{make_left<float>(-3)}, buf + 1 + n);
+
+				return n == binary_layout<E>::size
+					&& read<E>(buf + 1) == make_right<int>(1.5f)
+					&& read<E>(buf + 1 + n) == make_left<float>(-3);
+			})
+		),
+		std::make_tuple(
+			std::string("Stable tag and zeroed padding"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				unsigned char a[maybe_layout::size], b[maybe_layout::size];
+				std::memset(a, 0xff, sizeof a);
+				std::memset(b, 0x00, sizeof b);
+
+				write(nothing<double>(), a);
+				write(nothing<double>(), b);
+
+				return a[0] == 1 && std::memcmp(a, b, sizeof a) == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("binary_view::match in place"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				alignas(maybe_layout::alignment) unsigned char buf[maybe_layout::size];
+				write(just(2.5), buf);
+
+				binary_view<maybe<double>> v(buf, sizeof buf);
+				auto p = v.match(
+					[](const double& d){ return &d; },
+					[](Nothing){ return static_cast<const double*>(nullptr); }
+				);
+
+				return v.is<double>()
+					&& static_cast<const void*>(p) == buf + maybe_layout::payload_offset
+					&& *p == 2.5 && get<double>(v) == 2.5
+					&& v.value() == just(2.5);
+			})
+		),
+		std::make_tuple(
+			std::string("Arrays of values"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using L = binary_layout<maybe<int>>;
+				std::vector<double> storage(8 * L::size / sizeof(double) + 1);
+				auto buf = reinterpret_cast<unsigned char*>(storage.data());
+
+				for(int i = 0; i < 8; ++i)
+					write(i % 2 ? just(i) : nothing<int>(), buf + i * L::size);
+
+				int sum = 0;
+				for(int i = 0; i < 8; ++i)
+					sum += binary_view<maybe<int>>(buf + i * L::size).match(
+						[](int x){ return x; },
+						[](Nothing){ return 0; }
+					);
+
+				return sum == 1 + 3 + 5 + 7;
+			})
+		),
+		std::make_tuple(
+			std::string("Invalid buffers"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				alignas(maybe_layout::alignment) unsigned char buf[maybe_layout::size];
+				write(just(1.0), buf);
+
+				int thrown = 0;
+				try {
+					binary_view<maybe<double>> v(buf, sizeof buf - 1);
+				}
+				catch(std::invalid_argument&) {
+					++thrown;
+				}
+
+				try {
+					binary_view<maybe<double>> v(buf);
+					get<Nothing>(v);
+				}
+				catch(invalid_sum_type_access&) {
+					++thrown;
+				}
+
+				buf[0] = 2;
+				try {
+					binary_view<maybe<double>> v(buf);
+				}
+				catch(invalid_sum_type_access&) {
+					++thrown;
+				}
+
+				return thrown == 3;
+			})
+		)
+	}
+};
+
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ftl/cancellation.h>
+#include <ftl/async.h>
+#include <ftl/either_trans.h>
+#include "deferred_executor.h"
+#include "cancellation_tests.h"
+
+namespace {
+	// Whether f failed with operation_cancelled
+	template<typename T>
+	bool was_cancelled(const ftl::future<T>& f) {
+		try {
+			f.get();
+		}
+		catch(ftl::operation_cancelled&) {
+			return true;
+		}
+		catch(...) {}
+
+		return false;
+	}
+}
+
+test_set cancellation_tests{
+	std::string("cancellation"),
+	{
+		std::make_tuple(
+			std::string("cancellation_source::cancel"),
+			std::function<bool()>([]() -> bool {
+				ftl::cancellation_source s;
+				auto t = s.token();
+				int calls = 0;
+				t.on_cancel([&calls](){ ++calls; });
+
+				bool before = !t.cancelled() && !s.cancelled();
+				bool first = s.cancel();
+				bool second = s.cancel();
+
+				return before && first && !second && calls == 1
+					&& t.cancelled() && s.cancelled();
+			})
+		),
+		std::make_tuple(
+			std::string("cancellation_token::on_cancel[late]"),
+			std::function<bool()>([]() -> bool {
+				ftl::cancellation_source s;
+				s.cancel();
+
+				bool called = false;
+				s.token().on_cancel([&called](){ called = true; });
+
+				return called;
+			})
+		),
+		std::make_tuple(
+			std::string("cancellation_registration::deregister"),
+			std::function<bool()>([]() -> bool {
+				ftl::cancellation_source s;
+				auto t = s.token();
+				int a = 0, b = 0;
+				auto ra = t.on_cancel([&a](){ ++a; });
+				auto rb = t.on_cancel([&b](){ ++b; });
+
+				bool removed = ra.deregister();
+				bool again = ra.deregister();
+				s.cancel();
+
+				auto late = t.on_cancel([](){});
+
+				return removed && !again && a == 0 && b == 1
+					&& !rb.deregister() && !late.deregister();
+			})
+		),
+		std::make_tuple(
+			std::string("cancellation_token[default]"),
+			std::function<bool()>([]() -> bool {
+				ftl::cancellation_token t;
+				bool called = false;
+				t.on_cancel([&called](){ called = true; });
+				t.throw_if_cancelled();
+
+				return !t.cancelled() && !t.can_be_cancelled() && !called
+					&& ftl::cancellation_source().token().can_be_cancelled();
+			})
+		),
+		std::make_tuple(
+			std::string("cancellation_token::throw_if_cancelled"),
+			std::function<bool()>([]() -> bool {
+				ftl::cancellation_source s;
+				auto t = s.token();
+				s.cancel();
+
+				try {
+					t.throw_if_cancelled();
+				}
+				catch(ftl::operation_cancelled& e) {
+					return std::string(e.what()) == "operation cancelled";
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("cancellation_guard"),
+			std::function<bool()>([]() -> bool {
+				ftl::cancellation_source a, b;
+				{
+					ftl::cancellation_guard g(a);
+				}
+				{
+					ftl::cancellation_guard g(b);
+					g.release();
+				}
+
+				return a.cancelled() && !b.cancelled();
+			})
+		),
+		std::make_tuple(
+			std::string("async[cancelled before start]"),
+			std::function<bool()>([]() -> bool {
+				deferred_executor ex;
+				ftl::cancellation_source s;
+				bool ran = false;
+
+				auto f = ftl::async(ex, s.token(), [&ran](){
+					ran = true;
+					return 1;
+				});
+
+				s.cancel();
+				bool early = f.ready();
+				ex.run_all();
+
+				return early && !ran && was_cancelled(f);
+			})
+		),
+		std::make_tuple(
+			std::string("async[not cancelled]"),
+			std::function<bool()>([]() -> bool {
+				deferred_executor ex;
+				ftl::cancellation_source s;
+
+				auto f = ftl::async(ex, s.token(), [](){ return 4; });
+				ex.run_all();
+				s.cancel();
+
+				return f.get() == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("async[checkpoint]"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_executor ex;
+				ftl::cancellation_source s;
+				std::atomic<bool> started{false};
+				auto t = s.token();
+
+				auto f = ftl::async(ex, t, [t,&started]() -> int {
+					started = true;
+					while(true) {
+						t.throw_if_cancelled();
+						std::this_thread::yield();
+					}
+				});
+
+				while(!started)
+					std::this_thread::yield();
+
+				s.cancel();
+
+				return was_cancelled(f);
+			})
+		),
+		std::make_tuple(
+			std::string("future::then[pending, cancelled]"),
+			std::function<bool()>([]() -> bool {
+				ftl::promise<int> p;
+				ftl::cancellation_source s;
+				bool ran = false;
+
+				auto f = p.get_future().then(s.token(), [&ran](int x){
+					ran = true;
+					return x+1;
+				});
+
+				s.cancel();
+				bool early = f.ready();
+				p.set_value(1);
+
+				return early && !ran && was_cancelled(f);
+			})
+		),
+		std::make_tuple(
+			std::string("future::then[not cancelled]"),
+			std::function<bool()>([]() -> bool {
+				ftl::promise<int> p;
+				ftl::cancellation_source s;
+
+				auto f = p.get_future().then(s.token(), [](int x){
+					return x+1;
+				});
+
+				p.set_value(1);
+				s.cancel();
+
+				return f.get() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("cancel_on_failure[when_all]"),
+			std::function<bool()>([]() -> bool {
+				deferred_executor ex;
+				ftl::cancellation_source s;
+				bool sibling_ran = false;
+
+				ftl::promise<int> failing;
+				auto sibling = ftl::async(ex, s.token(), [&sibling_ran](){
+					sibling_ran = true;
+					return 2;
+				});
+
+				auto all = ftl::cancel_on_failure(
+					ftl::when_all(failing.get_future(), sibling), s
+				);
+
+				failing.set_exception(
+					std::make_exception_ptr(std::runtime_error("backend down"))
+				);
+				ex.run_all();
+
+				return s.cancelled() && !sibling_ran
+					&& was_cancelled(sibling) && !was_cancelled(all);
+			})
+		),
+		std::make_tuple(
+			std::string("cancel_on_left[eitherT]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+				using result = ftl::eitherT<std::string,ftl::future<int>>;
+
+				deferred_executor ex;
+				ftl::cancellation_source s;
+				bool sibling_ran = false;
+
+				ftl::promise<ftl::either<std::string,int>> p;
+				result a = ftl::cancel_on_left(result{p.get_future()}, s);
+				result b = ftl::cancel_on_left(
+					result{ftl::async(ex, s.token(), [&sibling_ran](){
+						sibling_ran = true;
+						return ftl::make_right<std::string>(2);
+					})},
+					s
+				);
+
+				auto sum = ftl::curry<2>([](int x, int y){ return x+y; }) % a * b;
+
+				p.set_value(ftl::make_left<int>(std::string("no such key")));
+				ex.run_all();
+
+				return s.cancelled() && !sibling_ran && was_cancelled(*sum);
+			})
+		),
+		std::make_tuple(
+			std::string("cancel_on_left[right]"),
+			std::function<bool()>([]() -> bool {
+				ftl::promise<ftl::either<std::string,int>> p;
+				ftl::cancellation_source s;
+
+				auto f = ftl::cancel_on_left(p.get_future(), s);
+				p.set_value(ftl::make_right<std::string>(3));
+
+				return !s.cancelled() && f.get() == ftl::make_right<std::string>(3);
+			})
+		),
+		std::make_tuple(
+			std::string("cancellable_executor"),
+			std::function<bool()>([]() -> bool {
+				deferred_executor ex;
+				ftl::cancellation_source s;
+				auto cex = ftl::cancellable(ex, s.token());
+				int runs = 0;
+
+				cex.execute([&runs](){ ++runs; });
+				s.cancel();
+				cex.execute([&runs](){ ++runs; });
+				ex.run_all();
+
+				return runs == 0 && ex.tasks.empty()
+					&& ftl::Executor<ftl::cancellable_executor<deferred_executor>>{};
+			})
+		),
+		std::make_tuple(
+			std::string("async[cancellable_executor]"),
+			std::function<bool()>([]() -> bool {
+				deferred_executor ex;
+				ftl::cancellation_source s;
+				auto cex = ftl::cancellable(ex, s.token());
+
+				auto a = ftl::async(cex, [](){ return 1; });
+				ex.run_all();
+
+				auto b = ftl::async(cex, [](){ return 2; });
+				auto c = ftl::async(cex, ftl::trace_label{"c"}, [](){ return 3; });
+				s.cancel();
+				auto d = ftl::async(cex, [](){ return 4; });
+				ex.run_all();
+
+				return a.get() == 1 && was_cancelled(b) && was_cancelled(c)
+					&& was_cancelled(d);
+			})
+		)
+	}
+};
+
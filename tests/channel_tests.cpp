@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ftl/channel.h>
+#include "channel_tests.h"
+
+test_set channel_tests{
+	std::string("channel"),
+	{
+		std::make_tuple(
+			std::string("push and pop"),
+			std::function<bool()>([]() -> bool {
+				ftl::channel<std::string> c(3);
+
+				bool pushed = c.push("a") && c.push("b") && c.try_push("c");
+				bool round = c.capacity() == 4 && c.try_push("d");
+				bool full = !c.try_push("e");
+
+				auto a = c.pop();
+				auto b = c.try_pop();
+				c.close();
+
+				bool closed = !c.push("f");
+				auto rest = c.pop().template is<std::string>()
+					&& c.pop().template is<std::string>();
+
+				return pushed && round && full && closed && rest
+					&& ftl::get<std::string>(a) == "a"
+					&& ftl::get<std::string>(b) == "b"
+					&& !c.pop().template is<std::string>()
+					&& !c.try_pop().template is<std::string>();
+			})
+		),
+		std::make_tuple(
+			std::string("Back pressure"),
+			std::function<bool()>([]() -> bool {
+				ftl::channel<int> c(2);
+				std::atomic<int> pushed{0};
+
+				std::thread producer([c,&pushed]() {
+					for(int i = 0; i < 100; ++i) {
+						c.push(i);
+						++pushed;
+					}
+
+					c.close();
+				});
+
+				// The producer cannot get more than the capacity ahead
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+				bool bounded = pushed <= 2;
+
+				int expect = 0;
+				bool ordered = true;
+				while(true) {
+					auto x = c.pop();
+					if(!x.template is<int>())
+						break;
+
+					ordered = ordered && ftl::get<int>(x) == expect++;
+				}
+
+				producer.join();
+
+				return bounded && ordered && expect == 100;
+			})
+		),
+		std::make_tuple(
+			std::string("Many producers and consumers"),
+			std::function<bool()>([]() -> bool {
+				ftl::channel<int> c(8);
+				std::vector<std::thread> producers, consumers;
+				std::vector<long> sums(4, 0);
+
+				for(int p = 0; p < 4; ++p) {
+					producers.emplace_back([c,p]() {
+						for(int i = 0; i < 1000; ++i)
+							c.push(p * 1000 + i);
+					});
+				}
+
+				for(std::size_t k = 0; k < sums.size(); ++k) {
+					consumers.emplace_back([c,k,&sums]() {
+						sums[k] = ftl::foldl(std::plus<long>(), 0l, c);
+					});
+				}
+
+				for(auto& t : producers)
+					t.join();
+
+				c.close();
+				for(auto& t : consumers)
+					t.join();
+
+				long total = 0;
+				for(auto s : sums)
+					total += s;
+
+				return total == 3999l * 4000l / 2;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map pipeline"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::thread_pool pool(3);
+				ftl::channel<int> in(4, pool);
+
+				auto out = [](std::size_t n){ return std::to_string(n); }
+					% ([](int x){ return std::size_t(x * 2); } % in);
+
+				std::thread producer([in]() {
+					for(int i = 0; i < 50; ++i)
+						in.push(i);
+
+					in.close();
+				});
+
+				auto r = ftl::foldl(
+					[](std::string acc, std::string s){ return acc + s + ","; },
+					std::string(), out
+				);
+
+				producer.join();
+
+				std::string expected;
+				for(int i = 0; i < 50; ++i)
+					expected += std::to_string(i * 2) + ",";
+
+				return r == expected && out.closed() && out.capacity() == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable and monoid"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				channel<int> a(4), b(4);
+				for(int i = 1; i <= 3; ++i) {
+					a.push(i);
+					b.push(i * 10);
+				}
+
+				a.close();
+				b.close();
+
+				auto merged = a ^ b ^ monoid<channel<int>>::id();
+				auto total = foldMap(sum<int>, merged);
+
+				channel<int> c(4);
+				c.push(4); c.push(8); c.push(5);
+				c.close();
+
+				return total == 66
+					&& foldr(std::minus<int>(), 3, c) == -2;
+			})
+		)
+	}
+};
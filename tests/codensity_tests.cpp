@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <list>
+#include <ftl/codensity.h>
+#include <ftl/list.h>
+#include <ftl/maybe.h>
+#include "codensity_tests.h"
+
+test_set codensity_tests{
+	std::string("codensity"),
+	{
+		std::make_tuple(
+			std::string("lift and lower"),
+			std::function<bool()>([]() -> bool {
+				std::list<int> l{1,2,3};
+
+				auto c = ftl::liftCodensity<std::list<int>>(l);
+
+				return ftl::lowerCodensity(c) == l;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto c = ftl::liftCodensity<std::list<float>>(
+					std::list<int>{1,2,3}
+				);
+
+				auto d = [](int x){ return x * .5f; } % c;
+
+				return ftl::lowerCodensity(d) == std::list<float>{.5f,1.f,1.5f};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind[lifts plain results]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+				using C = ftl::codensity<int,std::list<int>>;
+
+				auto c = ftl::liftCodensity<std::list<int>>(std::list<int>{1,2});
+
+				auto d = c >>= [](int x){ return std::list<int>{x, 10*x}; };
+				auto e = d >>= [](int x){ return ftl::monad<C>::pure(x+1); };
+
+				return ftl::lowerCodensity(e) == std::list<int>{2,11,3,21};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind[maybe short-circuits]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				int calls = 0;
+				auto c = ftl::liftCodensity<ftl::maybe<int>>(ftl::just(0));
+				for(int i = 0; i < 10; ++i) {
+					c = c >>= [&calls](int x){
+						++calls;
+						return x < 3 ? ftl::just(x+1) : ftl::nothing<int>();
+					};
+				}
+
+				return ftl::lowerCodensity(c) == ftl::nothing<int>()
+					&& calls == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind[left nested]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				int calls = 0;
+				auto c = ftl::liftCodensity<std::list<int>>(std::list<int>{0,1});
+				for(int i = 0; i < 2000; ++i) {
+					c = c >>= [&calls](int x){
+						++calls;
+						return std::list<int>{x+1};
+					};
+				}
+
+				auto l = ftl::lowerCodensity(c);
+
+				return l == std::list<int>{2000,2001} && calls == 4000;
+			})
+		)
+	}
+};
@@ -0,0 +1,66 @@
+# Times the compilation of every public ftl header on its own, and of
+# stress.cpp, failing if any of them takes longer than its budget.
+#
+# Run through the compile_times target, or by hand:
+#   cmake -DCXX=g++ "-DFLAGS=-std=c++11" -DINCLUDE_DIR=../../include
+#         -DSTRESS=stress.cpp -DWORK_DIR=/tmp
+#         [-DHEADER_BUDGET_MS=3000] [-DSTRESS_BUDGET_MS=8000]
+#         -P compile_times.cmake
+
+cmake_minimum_required(VERSION 3.23)
+
+if(NOT HEADER_BUDGET_MS)
+	set(HEADER_BUDGET_MS 3000)
+endif()
+
+if(NOT STRESS_BUDGET_MS)
+	set(STRESS_BUDGET_MS 8000)
+endif()
+
+separate_arguments(flags UNIX_COMMAND "${FLAGS}")
+
+# Compile src, setting ms to the time taken, in milliseconds
+function(time_compile src ms)
+	string(TIMESTAMP start "%s%f")
+	execute_process(
+		COMMAND ${CXX} ${flags} -I${INCLUDE_DIR} -fsyntax-only ${src}
+		RESULT_VARIABLE rc
+		ERROR_VARIABLE err)
+	string(TIMESTAMP end "%s%f")
+
+	if(NOT rc EQUAL 0)
+		message(FATAL_ERROR "${src} does not compile:\n${err}")
+	endif()
+
+	math(EXPR t "(${end} - ${start}) / 1000")
+	set(${ms} ${t} PARENT_SCOPE)
+endfunction()
+
+set(over "")
+
+file(GLOB headers RELATIVE ${INCLUDE_DIR}
+	${INCLUDE_DIR}/ftl/*.h ${INCLUDE_DIR}/ftl/concepts/*.h)
+foreach(h ${headers})
+	string(MAKE_C_IDENTIFIER ${h} id)
+	set(tu ${WORK_DIR}/${id}.cpp)
+	file(WRITE ${tu} "#include <${h}>\n")
+
+	time_compile(${tu} ms)
+	message("${ms} ms\t${h}")
+
+	if(ms GREATER HEADER_BUDGET_MS)
+		list(APPEND over "${h} (${ms} ms)")
+	endif()
+endforeach()
+
+time_compile(${STRESS} ms)
+message("${ms} ms\tstress.cpp")
+
+if(ms GREATER STRESS_BUDGET_MS)
+	list(APPEND over "stress.cpp (${ms} ms)")
+endif()
+
+if(over)
+	string(REPLACE ";" "\n  " over "${over}")
+	message(FATAL_ERROR "Over the compile time budget:\n  ${over}")
+endif()
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+
+/*
+ * Instantiates the constructs whose compile time grows fastest with the
+ * size of their input: wide sum types, up to 64 alternatives, functions
+ * curried over many parameters, long chains of maps and binds and stacks of
+ * monad transformers. It is never run, only compiled, and timed by
+ * compile_times.cmake along with every public header on its own.
+ */
+#include <string>
+#include <ftl/prelude.h>
+#include <ftl/sum_type.h>
+#include <ftl/maybe.h>
+#include <ftl/either.h>
+#include <ftl/either_trans.h>
+#include <ftl/maybe_trans.h>
+#include <ftl/lazy.h>
+#include <ftl/vector.h>
+
+namespace {
+	template<int I>
+	struct alt {
+		int x;
+	};
+
+	using wide = ftl::sum_type<
+		alt<0>, alt<1>, alt<2>, alt<3>, alt<4>, alt<5>, alt<6>, alt<7>,
+		alt<8>, alt<9>, alt<10>, alt<11>, alt<12>, alt<13>, alt<14>, alt<15>
+	>;
+
+	int match_wide(const wide& w) {
+		return w.match(
+			[](alt<0> a){ return a.x; }, [](alt<1> a){ return a.x; },
+			[](alt<2> a){ return a.x; }, [](alt<3> a){ return a.x; },
+			[](alt<4> a){ return a.x; }, [](alt<5> a){ return a.x; },
+			[](alt<6> a){ return a.x; }, [](alt<7> a){ return a.x; },
+			[](alt<8> a){ return a.x; }, [](alt<9> a){ return a.x; },
+			[](alt<10> a){ return a.x; }, [](alt<11> a){ return a.x; },
+			[](alt<12> a){ return a.x; }, [](alt<13> a){ return a.x; },
+			[](alt<14> a){ return a.x; }, [](alt<15> a){ return a.x; }
+		);
+	}
+
+	template<int I>
+	struct named {
+		std::string s;
+
+		bool operator== (const named& n) const {
+			return s == n.s;
+		}
+
+		bool operator!= (const named& n) const {
+			return s != n.s;
+		}
+	};
+
+	template<typename, template<int> class>
+	struct sum_of;
+
+	template<size_t...I, template<int> class A>
+	struct sum_of<ftl::seq<I...>,A> {
+		using type = ftl::sum_type<A<I>...>;
+	};
+
+	// Trivial and non-trivial 64 alternative sum types
+	using wide64 = sum_of<ftl::gen_seq<0,63>,alt>::type;
+	using wide64s = sum_of<ftl::gen_seq<0,63>,named>::type;
+
+	// Construct and get every alternative of wide64 in turn
+	template<size_t...I>
+	int touch_wide64(ftl::seq<I...>) {
+		int xs[] = {
+			ftl::get<I>(wide64{ftl::constructor<alt<I>>(), alt<I>{int(I)}}).x...
+		};
+
+		int r = 0;
+		for(int x : xs)
+			r += x;
+
+		return r;
+	}
+
+	int wide64_ops() {
+		wide64s s{ftl::constructor<named<63>>(), named<63>{"x"}};
+		wide64s s2 = s;
+		s2 = wide64s{ftl::constructor<named<0>>(), named<0>{"y"}};
+
+		return touch_wide64(ftl::gen_seq<0,63>{})
+			+ int(s == s2) + int(ftl::get<named<63>>(s).s.size())
+			+ int(s2.is<named<0>>());
+	}
+
+	int add6(int a, int b, int c, int d, int e, int f) {
+		return a + b + c + d + e + f;
+	}
+}
+
+int compile_time_stress() {
+	using ftl::operator%;
+	using ftl::operator>>=;
+
+	wide w{ftl::constructor<alt<15>>(), alt<15>{1}};
+	wide w2 = w;
+	w2 = wide{ftl::constructor<alt<7>>(), alt<7>{2}};
+
+	auto c = ftl::curry(add6);
+	int r = c(1)(2)(3)(4)(5)(6) + c(1, 2, 3)(4, 5, 6);
+
+	auto inc = [](int x){ return x + 1; };
+	auto m = inc % (inc % (inc % (inc % (inc % ftl::just(1)))));
+	auto e = inc % (inc % (inc % ftl::make_right<std::string>(1)));
+	auto l = inc % (inc % (inc % ftl::lazy<int>([]{ return 1; })));
+
+	auto k = [](int x){ return ftl::just(x * 2); };
+	auto b = ftl::just(1) >>= k;
+	b = (b >>= k) >>= k;
+
+	using mt = ftl::maybeT<std::vector<int>>;
+	using et = ftl::eitherT<std::string, mt>;
+	auto t = inc % ftl::monad<et>::pure(1);
+
+	auto v = inc % (inc % std::vector<int>{1, 2, 3});
+
+	return match_wide(w) + match_wide(w2) + wide64_ops() + r + *l + v[0]
+		+ int(m.is<int>()) + int(b.is<int>())
+		+ int(e.is<ftl::Right<int>>()) + int(sizeof(t));
+}
+
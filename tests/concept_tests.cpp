@@ -20,11 +20,59 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <ftl/either.h>
 #include <ftl/maybe.h>
 #include <ftl/vector.h>
 #include <ftl/list.h>
+#include <ftl/map.h>
+#include <string>
 #include "concept_tests.h"
 
+namespace {
+	// Fold accumulator that counts how many times it has been copied
+	struct copy_counter {
+		copy_counter() = default;
+		copy_counter(const copy_counter& c) : n(c.n), copies(c.copies + 1) {}
+		copy_counter(copy_counter&&) = default;
+
+		copy_counter& operator= (const copy_counter& c) {
+			n = c.n;
+			copies = c.copies + 1;
+			return *this;
+		}
+
+		copy_counter& operator= (copy_counter&&) = default;
+
+		int n = 0;
+		int copies = 0;
+	};
+
+	// Functor whose map must not be used for side effects only
+	template<typename T>
+	struct watched {
+		T x;
+		mutable bool mapped;
+	};
+}
+
+namespace ftl {
+	template<typename T>
+	struct functor<watched<T>> {
+		template<typename Fn, typename U = result_of<Fn(T)>>
+		static watched<U> map(Fn&& fn, const watched<T>& w) {
+			w.mapped = true;
+			return watched<U>{fn(w.x), false};
+		}
+
+		template<typename Fn>
+		static void forEach(Fn&& fn, const watched<T>& w) {
+			fn(w.x);
+		}
+
+		static constexpr bool instance = true;
+	};
+}
+
 test_set concept_tests{
 	std::string("concepts"),
 	{
@@ -209,6 +257,54 @@ test_set concept_tests{
 				return foldmap(v) == 10;
 			})
 		),
+		std::make_tuple(
+			std::string("Foldable: foldMap stops at absorbing element"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int calls = 0;
+				auto even = [&calls](int x) -> any {
+					++calls;
+					return x % 2 == 0;
+				};
+				auto odd = [&calls](int x) -> all {
+					++calls;
+					return x % 2 != 0;
+				};
+
+				std::vector<int> v{1,3,4,5,7,9};
+
+				bool r1 = foldMap(even, v);
+				int c1 = calls;
+
+				calls = 0;
+				bool r2 = foldMap(odd, v);
+
+				return r1 && c1 == 3 && !r2 && calls == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("Foldable: fold stops at absorbing maybe"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				static_assert(AbsorbingMonoid<maybe<prod_monoid<int>>>{}, "");
+				static_assert(!AbsorbingMonoid<prod_monoid<float>>{}, "");
+				static_assert(!AbsorbingMonoid<sum_monoid<int>>{}, "");
+
+				int calls = 0;
+				auto f = [&calls](int x) -> maybe<prod_monoid<int>> {
+					++calls;
+					return x < 0 ? nothing<prod_monoid<int>>() : just(prod(x));
+				};
+
+				std::list<int> l{2,-1,0,3,4};
+
+				auto m = foldMap(f, l);
+
+				return m == just(prod(0)) && calls == 3;
+			})
+		),
 		std::make_tuple(
 			std::string("Foldable: curried foldr"),
 			std::function<bool()>([]() -> bool {
@@ -261,6 +357,63 @@ test_set concept_tests{
 					== std::list<int>{4,3,2};
 			})
 		),
+		std::make_tuple(
+			std::string("Foldable: foldl moves accumulator"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto f = [](copy_counter c, int x){
+					c.n += x;
+					return c;
+				};
+
+				std::vector<int> v{1,2,3};
+				std::map<int,int> m{{1,4}, {2,5}};
+
+				auto r1 = foldl(f, copy_counter{}, v);
+				auto r2 = foldl(f, copy_counter{}, m);
+
+				return r1.n == 6 && r1.copies == 0
+					&& r2.n == 9 && r2.copies == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("Foldable: foldr moves accumulator"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto f = [](int x, copy_counter c){
+					c.n = c.n * 10 + x;
+					return c;
+				};
+
+				std::list<int> l{1,2,3};
+				std::map<int,int> m{{1,4}, {2,5}};
+
+				auto r1 = foldr(f, copy_counter{}, l);
+				auto r2 = foldr(f, copy_counter{}, m);
+
+				return r1.n == 321 && r1.copies == 0
+					&& r2.n == 54 && r2.copies == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("Foldable: foldInto"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto push = [](std::vector<int>& xs, int x){ xs.push_back(x); };
+				auto count = [](copy_counter& c, int x){ c.n += x; };
+
+				std::list<int> l{2,3,4};
+
+				auto v = foldInto(push, std::vector<int>{1}, l);
+				auto c = foldInto(count)(copy_counter{})(l);
+
+				return v == std::vector<int>{1,2,3,4}
+					&& c.n == 9 && c.copies == 0;
+			})
+		),
 		std::make_tuple(
 			std::string("Zippable: curried zipWith"),
 			std::function<bool()>([]() -> bool {
@@ -319,7 +472,147 @@ test_set concept_tests{
 
 				return r == std::vector<sum_monoid<int>>{sum(3), sum(7)};
 			})
+		),
+		std::make_tuple(
+			std::string("mconcat[no instance mconcat]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<sum_monoid<int>> v{sum(1), sum(2), sum(3)};
+				std::list<maybe<sum_monoid<int>>> l{
+					just(sum(1)), maybe<sum_monoid<int>>(Nothing{}), just(sum(4))
+				};
+
+				return mconcat(v) == 6 && mconcat(l) == just(sum(5));
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap[mconcat]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int calls = 0;
+				std::list<int> l{1,2,3};
+
+				auto v = foldMap(
+					[&calls](int x){ ++calls; return std::vector<int>(x, x); },
+					l
+				);
+
+				return v == std::vector<int>{1,2,2,3,3,3}
+					&& v.capacity() == v.size() && calls == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("forEach[iterable]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> v{1,2,3};
+				int sum = 0;
+				forEach([&sum](int x){ sum += x; }, v);
+				fmap([&sum](int x){ sum += x; }, std::list<int>{4,5});
+
+				std::vector<std::string> strs{"abc", "def"};
+				std::vector<std::string> moved;
+				forEach([&moved](std::string&& s){
+					moved.push_back(std::move(s));
+				}, std::move(strs));
+
+				return sum == 15
+					&& moved == std::vector<std::string>{"abc", "def"}
+					&& strs[0].empty();
+			})
+		),
+		std::make_tuple(
+			std::string("forEach[instance forEach]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				watched<int> w{4, false};
+				int seen = 0;
+				forEach([&seen](int x){ seen = x; }, w);
+				fmap([&seen](int x){ seen += x; }, w);
+
+				return seen == 8 && !w.mapped;
+			})
+		),
+		std::make_tuple(
+			std::string("forEach[fallback to map]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::map<int,int> m{{1,10}, {2,20}};
+				int sum = 0;
+				forEach([&sum](int x){ sum += x; }, m);
+				forEach([&sum](int x){ sum += x; })(just(3));
+
+				return sum == 33;
+			})
+		),
+		std::make_tuple(
+			std::string("sequence[maybe]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<maybe<int>> v1{just(1), just(2), just(3)};
+				std::vector<maybe<int>> v2{just(1), nothing<int>(), just(3)};
+
+				return sequence(v1) == just(std::vector<int>{1,2,3})
+					&& sequence(v2) == nothing<std::vector<int>>()
+					&& sequence(std::vector<maybe<int>>())
+						== just(std::vector<int>());
+			})
+		),
+		std::make_tuple(
+			std::string("traverse[stops at first failure]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int calls = 0;
+				auto check = [&calls](int x) -> either<int,int> {
+					++calls;
+					return x < 0 ? make_left<int>(x) : make_right<int>(x*2);
+				};
+
+				auto r1 = traverse(check, std::list<int>{1, -2, 3, -4});
+				auto n = calls;
+				auto r2 = traverse(check)(std::vector<int>{1, 2});
+
+				return n == 2 && r1 == make_left<std::list<int>>(-2)
+					&& r2 == make_right<int>(std::vector<int>{2,4});
+			})
+		),
+		std::make_tuple(
+			std::string("sequence[rvalue]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<maybe<std::string>> v{
+					just(std::string("abc")), just(std::string("def"))
+				};
+
+				auto r = sequence(std::move(v));
+
+				return r == just(std::vector<std::string>{"abc","def"})
+					&& v[0].template is<std::string>()
+					&& get<std::string>(v[0]).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("traverse[generic applicative]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto r = traverse(
+					[](int x){ return std::vector<int>{x, -x}; },
+					std::vector<int>{1, 2}
+				);
+
+				return r == std::vector<std::vector<int>>{
+					{1,2}, {1,-2}, {-1,2}, {-1,-2}
+				};
+			})
 		)
 	}
 };
-
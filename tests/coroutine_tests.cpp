@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <stdexcept>
+#include <string>
+#include <ftl/coroutine.h>
+#include "counting_resource.h"
+#include "coroutine_tests.h"
+
+#ifdef FTL_COROUTINES
+namespace {
+	ftl::maybe<int> add(ftl::maybe<int> a, ftl::maybe<int> b, int& steps) {
+		int x = co_await a;
+		++steps;
+		int y = co_await std::move(b);
+		++steps;
+		co_return x + y;
+	}
+
+	ftl::either<std::string,int> halve(int x) {
+		if(x % 2)
+			co_return ftl::make_left<int>(std::to_string(x) + " is odd");
+
+		co_return x / 2;
+	}
+
+	ftl::either<std::string,int> quarter(int x) {
+		int h = co_await halve(x);
+		co_return co_await halve(h);
+	}
+
+	ftl::future<int> multiply(ftl::future<int> a, ftl::future<int> b) {
+		int x = co_await a;
+		int y = co_await b;
+		co_return x * y;
+	}
+
+	ftl::future<int> checked(ftl::future<int> a) {
+		int x = co_await a;
+		if(x < 0)
+			throw std::invalid_argument("negative");
+
+		co_return x;
+	}
+
+	using result = ftl::eitherT<std::string,ftl::future<int>>;
+
+	result increment(result a, int& steps) {
+		int x = co_await a;
+		++steps;
+		co_return x + 1;
+	}
+
+	ftl::maybe<int> allocated(
+			std::allocator_arg_t, ftl::resource_allocator<char>, int x) {
+		co_return co_await ftl::just(x);
+	}
+}
+#endif
+
+test_set coroutine_tests{
+	std::string("coroutine"),
+	{
+#ifdef FTL_COROUTINES
+		std::make_tuple(
+			std::string("maybe"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int s1 = 0, s2 = 0;
+				auto r1 = add(just(1), just(2), s1);
+				auto r2 = add(nothing<int>(), just(2), s2);
+
+				return r1 == just(3) && s1 == 2
+					&& r2 == nothing<int>() && s2 == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("either"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				return quarter(12) == make_right<std::string>(3)
+					&& quarter(6) == make_left<int>(std::string("3 is odd"));
+			})
+		),
+		std::make_tuple(
+			std::string("future"),
+			std::function<bool()>([]() -> bool {
+				ftl::promise<int> p1, p2;
+
+				auto f = multiply(p1.get_future(), p2.get_future());
+				bool early = f.ready();
+				p2.set_value(3);
+				p1.set_value(4);
+
+				return !early && f.ready() && f.get() == 12;
+			})
+		),
+		std::make_tuple(
+			std::string("future[exception]"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_executor ex;
+				auto f = checked(ftl::async(ex, [](){ return -1; }));
+
+				try {
+					f.get();
+				}
+				catch(std::invalid_argument&) {
+					return true;
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("eitherT[future]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				promise<either<std::string,int>> p1, p2;
+				int s1 = 0, s2 = 0;
+
+				auto r1 = increment(result(p1.get_future()), s1);
+				auto r2 = increment(result(p2.get_future()), s2);
+				p1.set_value(make_right<std::string>(1));
+				p2.set_value(make_left<int>(std::string("failed")));
+
+				return (*r1).get() == make_right<std::string>(2) && s1 == 1
+					&& (*r2).get() == make_left<int>(std::string("failed"))
+					&& s2 == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("Frames from a memory resource"),
+			std::function<bool()>([]() -> bool {
+				counting_resource r;
+
+				auto m = allocated(
+					std::allocator_arg, ftl::resource_allocator<char>(&r), 7
+				);
+
+				return m == ftl::just(7) && r.allocations == 1 && r.live == 0;
+			})
+		)
+#endif
+	}
+};
+
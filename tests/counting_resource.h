@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_TESTS_COUNTING_RESOURCE_H
+#define FTL_TESTS_COUNTING_RESOURCE_H
+
+#include <cstddef>
+#include <ftl/memory_resource.h>
+
+/**
+ * Memory resource forwarding to another, counting allocations.
+ *
+ * `allocations` is the total number made, `live` the number not yet
+ * deallocated.
+ */
+class counting_resource : public ftl::memory_resource {
+public:
+	explicit counting_resource(
+			ftl::memory_resource* upstream = ftl::new_delete_resource())
+	: upstream(upstream) {}
+
+	int allocations = 0;
+	int live = 0;
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+		++allocations;
+		++live;
+		return upstream->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+	override {
+		--live;
+		upstream->deallocate(p, bytes, alignment);
+	}
+
+	bool do_is_equal(const ftl::memory_resource& other) const noexcept
+	override {
+		return this == &other;
+	}
+
+	ftl::memory_resource* upstream;
+};
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#ifndef FTL_TESTS_DEFERRED_EXECUTOR_H
+#define FTL_TESTS_DEFERRED_EXECUTOR_H
+
+#include <vector>
+#include <ftl/function.h>
+
+/**
+ * Executor holding on to its tasks until told to run them.
+ *
+ * Lets tests decide exactly when scheduled work happens, e.g. only after
+ * cancelling it.
+ */
+struct deferred_executor {
+	void execute(ftl::unique_function<void()> f) {
+		tasks.push_back(std::move(f));
+	}
+
+	void run_all() {
+		for(auto& f : tasks)
+			f();
+
+		tasks.clear();
+	}
+
+	std::vector<ftl::unique_function<void()>> tasks;
+};
+
+#endif
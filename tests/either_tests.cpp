@@ -23,6 +23,20 @@
 #include <ftl/either.h>
 #include "either_tests.h"
 
+static_assert(sizeof(ftl::either<char,char>) == 2, "");
+static_assert(sizeof(ftl::either<char,int>) == 2*sizeof(int), "");
+static_assert(std::is_trivially_copyable<ftl::either<int,float>>::value, "");
+static_assert(
+	std::is_trivially_destructible<ftl::either<int,float>>::value, ""
+);
+
+constexpr int twice(int x) { return 2*x; }
+
+static_assert(ftl::monad<ftl::either<float,int>>::map(
+		twice, ftl::make_right<float>(2)) == ftl::make_right<float>(4), "");
+static_assert(ftl::monad<ftl::either<float,int>>::map(
+		twice, ftl::make_left<int>(1.f)) == ftl::make_left<int>(1.f), "");
+
 test_set either_tests{
 	std::string("either"),
 	{
@@ -350,6 +364,34 @@ test_set either_tests{
 
 				return monad<either<int,int>>::join(e) == make_left<int>(2);
 			})
+		),
+		std::make_tuple(
+			std::string("either<L,R&> refers to its value"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int x = 1;
+				either<std::string,int&> e{constructor<Right<int&>>(), x};
+				auto f = e;
+
+				fromRight(f) = 2;
+
+				auto g = [](int y){ return y + 1; };
+
+				return x == 2 && (g % e) == make_right<std::string>(3);
+			})
+		),
+		std::make_tuple(
+			std::string("std::hash"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::hash<either<int,int>> h;
+
+				return h(make_left<int>(1)) == h(make_left<int>(1))
+					&& h(make_left<int>(1)) != h(make_right<int>(1))
+					&& h(make_right<int>(1)) != h(make_right<int>(2));
+			})
 		)
 	}
 };
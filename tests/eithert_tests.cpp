@@ -225,6 +225,47 @@ test_set eithert_tests{
 				return (*g)(2) == make_left<float>(0.f);
 			})
 		),
+		std::make_tuple(
+			std::string("monad::bind[hoist]"),
+			std::function<bool()>([]() -> bool {
+				using ef = ftl::eitherT<float,ftl::function<int(int)>>;
+				using namespace ftl;
+
+				ef f{inplace_tag(), [](int x){ return make_right<float>(x); }};
+				auto g = f >>= [](int x){
+					return x > 1 ? make_right<float>(x*2) : make_left<int>(1.f);
+				};
+
+				return (*g)(2) == make_right<float>(4)
+					&& (*g)(1) == make_left<int>(1.f);
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind[chain short-circuits]"),
+			std::function<bool()>([]() -> bool {
+				using ef = ftl::eitherT<float,ftl::function<int(int)>>;
+				using namespace ftl;
+
+				int calls = 0;
+				ef f{inplace_tag(), [](int x){ return make_right<float>(x); }};
+				for(int i = 0; i < 200; ++i) {
+					f = std::move(f) >>= [&calls](int x){
+						++calls;
+						return x > 0
+							? make_right<float>(x-1)
+							: make_left<int>(float(x));
+					};
+				}
+
+				auto r1 = (*f)(500);
+				auto c1 = calls;
+				calls = 0;
+				auto r2 = (*f)(10);
+
+				return r1 == make_right<float>(300) && c1 == 200
+					&& r2 == make_left<int>(0.f) && calls == 11;
+			})
+		),
 		std::make_tuple(
 			std::string("foldable::foldl"),
 			std::function<bool()>([]() -> bool {
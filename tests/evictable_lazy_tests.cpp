@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <stdexcept>
+#include <string>
+#include <ftl/evictable_lazy.h>
+#include "evictable_lazy_tests.h"
+
+test_set evictable_lazy_tests{
+	std::string("evictable_lazy"),
+	{
+		std::make_tuple(
+			std::string("Memoises until evicted"),
+			std::function<bool()>([]() -> bool {
+				int calls = 0;
+				ftl::evictable_lazy<int> l{[&calls](){ return ++calls; }};
+				auto copy = l;
+
+				bool deferred = l.status() == ftl::value_status::deferred;
+				int a = *l, b = *copy;
+
+				copy.evict();
+				bool evicted = l.status() == ftl::value_status::deferred;
+
+				return deferred && a == 1 && b == 1 && evicted
+					&& *l == 2 && calls == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("Pinned values outlive eviction"),
+			std::function<bool()>([]() -> bool {
+				ftl::evictable_lazy<std::string> l{
+					[](){ return std::string("blob"); }
+				};
+
+				auto p = l.pin();
+				l.evict();
+
+				return *p == "blob" && l->size() == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("Pool evicts least recently used"),
+			std::function<bool()>([]() -> bool {
+				ftl::eviction_pool pool(2 * sizeof(int));
+				int calls[3] = {0, 0, 0};
+
+				auto a = ftl::evictable_lazy<int>(pool, [&](){ return ++calls[0]; });
+				auto b = ftl::evictable_lazy<int>(pool, [&](){ return ++calls[1]; });
+				auto c = ftl::evictable_lazy<int>(pool, [&](){ return ++calls[2]; });
+
+				*a; *b; *a;
+				bool full = pool.used() == 2 * sizeof(int);
+
+				// b is least recently used
+				*c;
+				bool lru = b.status() == ftl::value_status::deferred
+					&& a.status() == ftl::value_status::ready
+					&& pool.size() == 2;
+
+				*a; *b;
+
+				return full && lru
+					&& calls[0] == 1 && calls[1] == 2 && calls[2] == 1
+					&& c.status() == ftl::value_status::deferred;
+			})
+		),
+		std::make_tuple(
+			std::string("Cost functions and budget changes"),
+			std::function<bool()>([]() -> bool {
+				ftl::eviction_pool pool(100);
+				auto size = [](const std::string& s){ return s.size(); };
+
+				auto small = ftl::evictable_lazy<std::string>(
+					pool, [](){ return std::string(10, 's'); }, size
+				);
+				auto big = ftl::evictable_lazy<std::string>(
+					pool, [](){ return std::string(150, 'b'); }, size
+				);
+
+				*small;
+				bool counted = pool.used() == 10;
+
+				// Over budget on its own, so it stays while it is in use
+				*big;
+				bool kept = big.status() == ftl::value_status::ready
+					&& small.status() == ftl::value_status::deferred
+					&& pool.used() == 150;
+
+				pool.set_budget(0);
+
+				return counted && kept
+					&& big.status() == ftl::value_status::deferred
+					&& pool.used() == 0 && pool.size() == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("Throwing cost functions leave the pool intact"),
+			std::function<bool()>([]() -> bool {
+				ftl::eviction_pool pool;
+				bool fail = true;
+
+				auto a = ftl::evictable_lazy<int>(pool, [](){ return 1; });
+				auto b = ftl::evictable_lazy<int>(
+					pool, [](){ return 2; },
+					[&fail](const int&) -> std::size_t {
+						if(fail)
+							throw std::runtime_error("no cost");
+						return 1;
+					}
+				);
+				auto c = ftl::evictable_lazy<int>(pool, [](){ return 3; });
+
+				*a;
+				*c;
+
+				bool threw = false;
+				try {
+					*b;
+				}
+				catch(std::runtime_error&) {
+					threw = true;
+				}
+
+				bool untouched = b.status() == ftl::value_status::deferred
+					&& pool.size() == 2;
+
+				fail = false;
+				*b;
+
+				return threw && untouched && *b == 2 && pool.size() == 3
+					&& pool.used() == 2*sizeof(int) + 1;
+			})
+		),
+		std::make_tuple(
+			std::string("Dropped values leave the pool"),
+			std::function<bool()>([]() -> bool {
+				ftl::eviction_pool pool;
+				{
+					ftl::evictable_lazy<int> l(pool, [](){ return 1; });
+					*l;
+				}
+
+				auto l2 = ftl::evictable_lazy<int>(pool, [](){ return 2; });
+				*l2;
+				pool.evict_all();
+
+				return pool.size() == 0 && pool.used() == 0
+					&& l2.status() == ftl::value_status::deferred;
+			})
+		),
+		std::make_tuple(
+			std::string("monad instance"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				eviction_pool pool;
+				int calls = 0;
+				evictable_lazy<int> l(pool, [&calls](){ ++calls; return 2; });
+
+				auto m = [](int x){ return x * 10; } % l;
+				auto b = l >>= [](int x){
+					return evictable_lazy<float>{[x](){ return float(x) / 4.f; }};
+				};
+
+				bool lazy = calls == 0;
+				int v = *m;
+				l.evict();
+
+				return lazy && v == 20 && *b == .5f && calls == 2
+					&& m.pool() == &pool && pool.size() == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("monad instance[evicted while in use]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				evictable_lazy<std::string> l{
+					[](){ return std::string("long enough to be on the heap"); }
+				};
+
+				auto m = [l](const std::string& s){
+					l.evict();
+					return s.size();
+				} % l;
+
+				auto b = l >>= [l](const std::string& s){
+					l.evict();
+					auto n = s.size();
+					return evictable_lazy<std::size_t>{[n](){ return n; }};
+				};
+
+				return *m == 29 && *b == 29;
+			})
+		)
+	}
+};
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <atomic>
+#include <string>
+#include <ftl/executor.h>
+#include <ftl/async.h>
+#include "executor_tests.h"
+
+static_assert(ftl::Executor<ftl::inline_executor>{}, "");
+static_assert(ftl::Executor<ftl::thread_pool>{}, "");
+static_assert(ftl::Executor<ftl::work_stealing_pool>{}, "");
+static_assert(!ftl::Executor<int>{}, "");
+
+test_set executor_tests{
+	std::string("executor"),
+	{
+		std::make_tuple(
+			std::string("inline_executor runs immediately"),
+			std::function<bool()>([]() -> bool {
+				ftl::inline_executor ex;
+				int x = 0;
+
+				ex.execute([&x](){ x = 1; });
+
+				return x == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("thread_pool runs all tasks"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> n{0};
+				{
+					ftl::thread_pool pool(4);
+					for(int i = 0; i < 1000; ++i)
+						pool.execute([&n](){ ++n; });
+				}
+
+				return n == 1000;
+			})
+		),
+		std::make_tuple(
+			std::string("work_stealing_pool runs nested tasks"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> n{0};
+				{
+					ftl::work_stealing_pool pool(4);
+					for(int i = 0; i < 100; ++i) {
+						pool.execute([&n,&pool](){
+							for(int j = 0; j < 10; ++j)
+								pool.execute([&n](){ ++n; });
+
+							++n;
+						});
+					}
+				}
+
+				return n == 1100;
+			})
+		),
+		std::make_tuple(
+			std::string("async on pools"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+
+				ftl::thread_pool p1(2);
+				ftl::work_stealing_pool p2(2);
+
+				ftl::function<int(int,int)> fn = [](int x, int y){ return x+y; };
+
+				auto f = fn
+					% ftl::async(p1, [](){ return 1; })
+					* ftl::async(p2, [](){ return 2; });
+
+				auto g = f.then(p2, [](int x){ return x*2; });
+
+				return g.get() == 6;
+			})
+		),
+	}
+};
+
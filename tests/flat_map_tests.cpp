@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <ftl/flat_map.h>
+#include <ftl/string.h>
+#include "flat_map_tests.h"
+
+test_set flat_map_tests{
+	std::string("flat_map"),
+	{
+		std::make_tuple(
+			std::string("construction[unsorted, duplicates]"),
+			std::function<bool()>([]() -> bool {
+				using std::make_pair;
+
+				ftl::flat_map<int,char> m{
+					make_pair(2, 'b'), make_pair(1, 'a'), make_pair(2, 'x')
+				};
+
+				return m.size() == 2 && m.at(1) == 'a' && m.at(2) == 'b';
+			})
+		),
+		std::make_tuple(
+			std::string("operator[]/emplace/erase"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_map<int,std::string> m;
+
+				m[3] = "three";
+				m.emplace(1, "one");
+				m[2] += "two";
+				bool dup = m.emplace(1, "uno").second;
+				m.erase(3);
+
+				auto it = m.begin();
+				return !dup && m.size() == 2
+					&& it->second == "one" && (++it)->second == "two";
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->b,&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using std::make_pair;
+
+				ftl::flat_map<int,std::string> m{
+					make_pair(1, std::string("a")),
+					make_pair(0, std::string("abc"))
+				};
+				auto len = [](const std::string& s){ return s.size(); };
+				auto r = len % m;
+
+				return r == ftl::flat_map<int,std::size_t>{
+					make_pair(0, std::size_t(3)),
+					make_pair(1, std::size_t(1))
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->a,&&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using std::make_pair;
+
+				auto f = [](int x){ return x+1; };
+				auto m = f % ftl::flat_map<int,int>{
+					make_pair(0, 1), make_pair(1, 2)
+				};
+
+				return m == ftl::flat_map<int,int>{
+					make_pair(0, 2), make_pair(1, 3)
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append[left biased]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+				using std::make_pair;
+				using map = ftl::flat_map<int,char>;
+
+				map m1{make_pair(1, 'a'), make_pair(3, 'c')};
+				map m2{make_pair(2, 'b'), make_pair(3, 'x')};
+
+				return (m1 ^ m2) == map{
+					make_pair(1, 'a'), make_pair(2, 'b'), make_pair(3, 'c')
+				} && (std::move(m2) ^ m1).at(3) == 'x';
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::fold"),
+			std::function<bool()>([]() -> bool {
+				using std::make_pair;
+
+				ftl::flat_map<int,std::string> m{
+					make_pair(2, std::string("c")),
+					make_pair(0, std::string("a")),
+					make_pair(1, std::string("b"))
+				};
+
+				return ftl::fold(m) == "abc";
+			})
+		)
+	}
+};
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <ftl/flat_set.h>
+#include "flat_set_tests.h"
+
+test_set flat_set_tests{
+	std::string("flat_set"),
+	{
+		std::make_tuple(
+			std::string("construction[unsorted, duplicates]"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_set<int> s{4,1,3,1,2,4};
+
+				return s.sequence() == std::vector<int>{1,2,3,4}
+					&& s.count(3) == 1 && s.find(5) == s.end();
+			})
+		),
+		std::make_tuple(
+			std::string("insert/erase"),
+			std::function<bool()>([]() -> bool {
+				ftl::flat_set<int> s{1,5};
+
+				bool fresh = s.insert(3).second;
+				bool dup = s.insert(5).second;
+				s.insert({9,0,3});
+				s.erase(1);
+
+				return fresh && !dup
+					&& s.sequence() == std::vector<int>{0,3,5,9};
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+				using ftl::flat_set;
+
+				auto s1 = flat_set<int>{1,2};
+				auto s2 = flat_set<int>{2,3,4};
+				auto s3 = flat_set<int>{3,4,5,6,7};
+
+				auto s = std::move(s2) ^ std::move(s3) ^ s1;
+				return s == flat_set<int>{1,2,3,4,5,6,7};
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[reordering, colliding]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::flat_set;
+
+				auto f = [](int x){ return (x * x) % 5; };
+				auto s = f % flat_set<int>{0,1,2,3,4,5,6};
+
+				return s == flat_set<int>{0,1,4};
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+				using ftl::flat_set;
+
+				auto s = flat_set<int>{1,2} >>= [](int x){
+					return flat_set<int>{x, x*10};
+				};
+
+				return s == flat_set<int>{1,2,10,20};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldr"),
+			std::function<bool()>([]() -> bool {
+				auto s = ftl::flat_set<int>{3,1,2};
+
+				auto r = ftl::foldr([](int x, int z){ return z*10 + x; }, 0, s);
+
+				return r == 321;
+			})
+		)
+	}
+};
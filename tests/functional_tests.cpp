@@ -21,6 +21,7 @@
  * distribution.
  */
 #include <vector>
+#include <memory>
 #include <ftl/functional.h>
 #include <ftl/ord.h>
 #include "functional_tests.h"
@@ -44,6 +45,90 @@ test_set functional_tests{
 					&& g(1,2,3) == 6;
 			})
 		),
+		std::make_tuple(
+			std::string("function with custom in-place storage"),
+			std::function<bool()>([]() -> bool {
+				using big_function = ftl::function<std::size_t(std::size_t,int),48>;
+
+				std::size_t a = 1, b = 2, c = 3, d = 4, e = 5;
+				auto l = [a,b,c,d,e](std::size_t x, int y) {
+					return a + b + c + d + e + x + std::size_t(y);
+				};
+
+				static_assert(big_function::stores_inline<decltype(l)>(), "");
+				static_assert(
+					!ftl::function<std::size_t(std::size_t,int)>
+						::stores_inline<decltype(l)>(),
+					""
+				);
+
+				big_function f = l;
+				big_function g = f;
+				big_function h = std::move(f);
+				big_function i;
+				i = g;
+
+				return g(0,1) == 16 && h(1)(1) == 17 && i(2,2) == 19 && !f;
+			})
+		),
+		std::make_tuple(
+			std::string("unique_function holds move-only objects"),
+			std::function<bool()>([]() -> bool {
+				using ftl::unique_function;
+
+				std::unique_ptr<int> p(new int(1));
+				unique_function<int(int,int)> f = std::bind(
+					[](const std::unique_ptr<int>& q, int x, int y) {
+						return *q + x + y;
+					},
+					std::move(p), std::placeholders::_1, std::placeholders::_2
+				);
+
+				unique_function<int(int,int)> g = std::move(f);
+				int r1 = g(2,3);
+
+				auto h = std::move(g)(2);
+
+				return r1 == 6 && h(3) == 6 && !f && !g;
+			})
+		),
+		std::make_tuple(
+			std::string("unique_function adopts ftl::function"),
+			std::function<bool()>([]() -> bool {
+				using ftl::unique_function;
+
+				ftl::function<int(int)> f = [](int x){ return x+1; };
+				const ftl::function<int(int)> g = f;
+
+				unique_function<int(int)> u1 = std::move(f);
+				unique_function<int(int)> u2 = g;
+				unique_function<int(int)> u3;
+				u3 = std::move(u1);
+
+				return !f && !u1 && u2(1) == 2 && u3(2) == 3 && g(3) == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("function_ref calls referenced object"),
+			std::function<bool()>([]() -> bool {
+				struct counting {
+					int operator()(int x) { return x + ++calls; }
+					int calls = 0;
+				};
+
+				counting c;
+				ftl::function<int(int)> f = [](int x){ return x*2; };
+				int (*p)(int) = [](int x){ return x - 1; };
+
+				ftl::function_ref<int(int)> r1 = c;
+				ftl::function_ref<int(int)> r2 = f;
+				ftl::function_ref<int(int)> r3 = p;
+				auto r4 = r1;
+
+				return r1(1) == 2 && r4(1) == 3 && c.calls == 2
+					&& r2(3) == 6 && r3(3) == 2;
+			})
+		),
 		std::make_tuple(
 			std::string("functor<function>::map"),
 			std::function<bool()>([]() -> bool {
@@ -60,6 +145,50 @@ test_set functional_tests{
 				;
 			})
 		),
+		std::make_tuple(
+			std::string("functor<function>::map[moves]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				// Counts the copies made of it, including those of its copies
+				struct add {
+					add(std::shared_ptr<int> n) : copies(std::move(n)) {}
+					add(const add& a) : copies(a.copies) { ++*copies; }
+					add(add&&) = default;
+
+					int operator() (int x) const { return x + 1; }
+
+					std::shared_ptr<int> copies;
+				};
+
+				auto copies = std::make_shared<int>(0);
+				ftl::function<int(int)> unary = [](int x){ return 2*x; };
+
+				auto g = add(copies) % std::move(unary);
+
+				return g(2) == 5 && *copies == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("functor<reader>::map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto f = [](int x){ return x + 1; };
+				auto g = ftl::make_reader([](int x){ return x * 2; });
+				auto h = ftl::make_reader([](int x, int y){ return x - y; });
+
+				auto k = f % g % h;
+				ftl::function<int(int,int)> erased = k;
+
+				static_assert(
+					!std::is_same<decltype(k),ftl::function<int(int,int)>>::value,
+					"Mapping a reader must not erase its type"
+				);
+
+				return k(5, 3) == 5 && erased(7, 3) == 9;
+			})
+		),
 		std::make_tuple(
 			std::string("applicative<function>::pure"),
 			std::function<bool()>([]() -> bool {
@@ -108,8 +237,12 @@ test_set functional_tests{
 				using ftl::function;
 				using ftl::operator^;
 
-				auto f = ftl::comparing(&std::vector<int>::size);
-				auto g = ftl::getComparator<std::vector<int>>();
+				using cmp = function<ftl::ord(
+					const std::vector<int>&, const std::vector<int>&
+				)>;
+
+				cmp f = ftl::comparing(&std::vector<int>::size);
+				cmp g = ftl::getComparator<std::vector<int>>();
 
 				return (f ^ g)(std::vector<int>{1,2}, std::vector<int>{1,3})
 					== ftl::ord::Lt;
@@ -21,6 +21,7 @@
  * distribution.
  */
 #include <ftl/forward_list.h>
+#include <ftl/maybe.h>
 #include "fwdlist_tests.h"
 
 test_set fwdlist_tests{
@@ -177,6 +178,20 @@ test_set fwdlist_tests{
 				return (l >>= f) == std::forward_list<int>{1,2,2,3,3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("monad::join[&&] splices"),
+			std::function<bool()>([]() -> bool {
+				using std::forward_list;
+
+				forward_list<forward_list<int>> l{{1,2},{},{3,4}};
+				auto p = &std::next(l.begin(), 2)->front();
+
+				auto r = ftl::monad<forward_list<int>>::join(std::move(l));
+
+				return r == forward_list<int>{1,2,3,4}
+					&& &*std::next(r.begin(), 2) == p;
+			})
+		),
 		std::make_tuple(
 			std::string("foldable::foldl"),
 			std::function<bool()>([]() -> bool {
@@ -293,7 +308,56 @@ test_set fwdlist_tests{
 					std::make_tuple(3,1.f)
 				};
 			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith[3-ary]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::forward_list<int> l1{1,2,3};
+				std::forward_list<int> l2{4,5};
+				std::forward_list<int> l3{7,8,9};
+
+				auto l4 = ftl::zipWith(
+					[](int x, int y, int z){ return x + y + z; }, l1, l2, l3
+				);
+
+				return l4 == std::forward_list<int>{12,15};
+			})
+		),
+		std::make_tuple(
+			std::string("liftA"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+
+				std::forward_list<int> l1{1, 2}, l2{10, 20};
+				auto plus = [](int x, int y){ return x + y; };
+
+				auto r = ftl::liftA(plus, l1, l2);
+				auto fs = ftl::curry<2>(plus) % l1;
+
+				return r == std::forward_list<int>{11, 21, 12, 22}
+					&& fs * l2 == r;
+			})
+		),
+		std::make_tuple(
+			std::string("filter and mapMaybe"),
+			std::function<bool()>([]() -> bool {
+				auto half = [](int x){
+					return x % 2 ? ftl::nothing<int>() : ftl::just(x/2);
+				};
+				auto odd = [](int x){ return x % 2 != 0; };
+
+				std::forward_list<int> l{1, 2, 3, 4};
+
+				return ftl::filter(odd, l) == std::forward_list<int>{1, 3}
+					&& ftl::mapMaybe(half, l) == std::forward_list<int>{1, 2}
+					&& ftl::filter(odd, std::move(l))
+						== std::forward_list<int>{1, 3};
+			})
 		)
+
 	}
 };
 
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <map>
+#include <ftl/hash_map.h>
+#include <ftl/string.h>
+#include "hash_map_tests.h"
+
+test_set hash_map_tests{
+	std::string("hash_map"),
+	{
+		std::make_tuple(
+			std::string("insert/erase/find[against std::map]"),
+			std::function<bool()>([]() -> bool {
+				ftl::hash_map<int,int> m;
+				std::map<int,int> ref;
+
+				// Deterministic mix of insertions and erasures, leaving
+				// plenty of tombstones behind
+				unsigned x = 1;
+				for(int i = 0; i < 20000; ++i) {
+					x = x * 1103515245u + 12345u;
+					int k = int((x >> 8) % 1000);
+					if(x % 3 == 0) {
+						if(m.erase(k) != ref.erase(k))
+							return false;
+					}
+					else {
+						m[k] += i;
+						ref[k] += i;
+					}
+				}
+
+				if(m.size() != ref.size())
+					return false;
+
+				for(auto& kv : ref) {
+					auto it = m.find(kv.first);
+					if(it == m.end() || it->second != kv.second)
+						return false;
+				}
+
+				return m.load_factor() <= 7.f/8.f;
+			})
+		),
+		std::make_tuple(
+			std::string("copy keeps layout"),
+			std::function<bool()>([]() -> bool {
+				ftl::hash_map<int,std::string> m{
+					{1, "one"}, {2, "two"}, {3, "three"}
+				};
+				auto c = m;
+
+				return c == m && c.capacity() == m.capacity()
+					&& c.begin()->first == m.begin()->first;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->b,&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::hash_map<int,std::string> m;
+				for(int i = 0; i < 100; ++i) {
+					m[i] = std::string(std::size_t(i), 'x');
+				}
+
+				auto len = [](const std::string& s){ return s.size(); };
+				auto r = len % m;
+
+				return r.capacity() == m.capacity()
+					&& r.size() == 100 && r.at(42) == 42;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->b,&&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::hash_map<int,std::string> m;
+				for(int i = 0; i < 100; ++i) {
+					m[i] = std::string(std::size_t(i), 'x');
+				}
+
+				auto cap = m.capacity();
+				auto len = [](const std::string& s){ return s.size(); };
+				auto r = len % std::move(m);
+
+				return r.capacity() == cap && r.size() == 100 && r.at(7) == 7;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->a,&&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto f = [](int x){ return x+1; };
+				auto m = f % ftl::hash_map<int,int>{{0, 1}, {1, 2}};
+
+				return m == ftl::hash_map<int,int>{{0, 2}, {1, 3}};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::fold"),
+			std::function<bool()>([]() -> bool {
+				ftl::hash_map<int,ftl::sum_monoid<int>> m{
+					{0, ftl::sum(2)}, {1, ftl::sum(3)}, {2, ftl::sum(4)}
+				};
+
+				return ftl::fold(m) == 9;
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append[unionWith]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+				using map = ftl::hash_map<int,std::string>;
+
+				map m1{{1, "a"}, {2, "b"}};
+				map m2{{2, "c"}, {3, "d"}};
+
+				auto r1 = m1 ^ m2;
+				auto r2 = m1 ^ map(m2);
+				auto r3 = map{{2, "x"}} ^ std::move(m1);
+
+				return r1 == map{{1, "a"}, {2, "bc"}, {3, "d"}}
+					&& r2 == r1
+					&& r3 == map{{1, "a"}, {2, "xb"}};
+			})
+		)
+	}
+};
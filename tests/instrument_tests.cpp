@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <array>
+#include <sstream>
+#include <ftl/instrument.h>
+#include <ftl/function.h>
+#include <ftl/lazy.h>
+#include <ftl/async.h>
+#include <ftl/memory_resource.h>
+#include <ftl/small_vector.h>
+#include <ftl/prelude.h>
+#include "instrument_tests.h"
+
+namespace {
+	// Allocations counted against s while running f
+	template<typename F>
+	std::size_t allocations_in(ftl::alloc_source s, F f) {
+		auto before = ftl::allocation_count(s).allocations;
+		f();
+		return ftl::allocation_count(s).allocations - before;
+	}
+
+	// What to expect of a component that allocates n times
+	constexpr std::size_t expected(std::size_t n) {
+		return ftl::allocation_counting ? n : 0;
+	}
+}
+
+test_set instrument_tests{
+	std::string("instrument"),
+	{
+		std::make_tuple(
+			std::string("function[small buffer]"),
+			std::function<bool()>([]() -> bool {
+				int x = 0;
+				auto n = allocations_in(ftl::alloc_source::function, [&x](){
+					ftl::function<int(int)> f = [x](int y){ return x + y; };
+					x = f(1);
+				});
+
+				return n == 0 && x == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("function[heap]"),
+			std::function<bool()>([]() -> bool {
+				int x = 0;
+				auto n = allocations_in(ftl::alloc_source::function, [&x](){
+					std::array<int,64> big{};
+					big[63] = 2;
+					ftl::function<int(int)> f = [big](int y){ return big[63] + y; };
+					x = f(1);
+				});
+
+				return n == expected(1) && x == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("lazy[cells]"),
+			std::function<bool()>([]() -> bool {
+				int x = 0;
+				auto n = allocations_in(ftl::alloc_source::lazy, [&x](){
+					ftl::lazy<int> l1{[](){ return 1; }};
+					ftl::lazy<int> l2 = l1;
+					x = *l1 + *l2;
+				});
+
+				return n == expected(1) && x == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("lazy[comparisons]"),
+			std::function<bool()>([]() -> bool {
+				ftl::lazy<int> l1{[](){ return 1; }};
+				ftl::lazy<int> l2{[](){ return 2; }};
+
+				bool b = false;
+				auto n = allocations_in(ftl::alloc_source::lazy, [&](){
+					b = l1 < l2 && l1 != l2 && !(l1 == l2);
+				});
+
+				auto m = allocations_in(ftl::alloc_source::lazy, [&](){
+					ftl::lazy<bool> d = l1 > l2;
+					b = b && !*d;
+				});
+
+				return b && n == 0 && m == expected(1);
+			})
+		),
+		std::make_tuple(
+			std::string("async[promise]"),
+			std::function<bool()>([]() -> bool {
+				int x = 0;
+				auto n = allocations_in(ftl::alloc_source::async, [&x](){
+					ftl::promise<int> p;
+					auto f = p.get_future();
+					p.set_value(4);
+					x = f.get();
+				});
+
+				return n == expected(1) && x == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("memory_resource[upstream blocks]"),
+			std::function<bool()>([]() -> bool {
+				auto n = allocations_in(ftl::alloc_source::memory_resource, [](){
+					ftl::monotonic_buffer_resource arena;
+					for(int i = 0; i < 4; ++i)
+						arena.allocate(16);
+				});
+
+				return ftl::allocation_counting ? n >= 1 : n == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("small_vector[inline capacity]"),
+			std::function<bool()>([]() -> bool {
+				ftl::small_vector<int,4> v;
+				auto inl = allocations_in(ftl::alloc_source::small_vector, [&v](){
+					for(int i = 0; i < 4; ++i)
+						v.push_back(i);
+				});
+
+				auto n = allocations_in(ftl::alloc_source::small_vector, [&v](){
+					v.push_back(4);
+				});
+
+				return inl == 0 && n == expected(1) && v.size() == 5;
+			})
+		),
+		std::make_tuple(
+			std::string("report_allocations"),
+			std::function<bool()>([]() -> bool {
+				std::array<int,64> big{};
+				ftl::function<int()> f = [big](){ return big[0]; };
+
+				std::ostringstream os;
+				ftl::report_allocations(os);
+
+				auto listed = os.str().find("function: ") != std::string::npos;
+				return listed == ftl::allocation_counting && f() == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("compose[no type erasure]"),
+			std::function<bool()>([]() -> bool {
+				int x = 0;
+				auto n = allocations_in(ftl::alloc_source::function, [&x](){
+					std::array<int,16> big{};
+					big[15] = 2;
+					auto h = ftl::compose(
+						[big](int y){ return big[15] * y; },
+						[big](int y){ return big[15] + y; },
+						ftl::flip([big](int a, int b){ return a - b + big[0]; })
+					);
+					x = h(1, 4);
+				});
+
+				return n == 0 && x == 10;
+			})
+		),
+		std::make_tuple(
+			std::string("small_vector[bind and concatMap]"),
+			std::function<bool()>([]() -> bool {
+				using sv = ftl::small_vector<int,4>;
+
+				sv v{1, 2};
+				sv b, c;
+				auto n = allocations_in(ftl::alloc_source::small_vector, [&](){
+					b = v >>= [](int x){ return sv{x, -x}; };
+					c = ftl::concatMap([](int x){ return sv{x}; }, v);
+				});
+
+				return n == 0 && b == sv{1, -1, 2, -2} && c == sv{1, 2};
+			})
+		)
+
+	}
+};
+
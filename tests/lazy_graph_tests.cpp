@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ftl/lazy_graph.h>
+#include "lazy_graph_tests.h"
+
+namespace {
+	using ilazy = ftl::lazy<int>;
+
+	// Waits, for a while at most, until n computations have arrived
+	bool rendezvous(std::atomic<int>& arrived, int n) {
+		++arrived;
+
+		auto deadline = std::chrono::steady_clock::now()
+			+ std::chrono::seconds(5);
+
+		while(arrived.load() < n) {
+			if(std::chrono::steady_clock::now() > deadline)
+				return false;
+
+			std::this_thread::yield();
+		}
+
+		return true;
+	}
+}
+
+test_set lazy_graph_tests{
+	std::string("lazy_graph"),
+	{
+		std::make_tuple(
+			std::string("dependencies[recorded]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+				using ftl::_dtl::lazy_access;
+
+				auto a = ftl::defer([](int x){ return x; }, 1);
+				auto b = ftl::defer([](int x){ return x; }, 2);
+				auto c = ftl::curry<2>([](int x, int y){ return x+y; }) % a * b;
+				auto mul = [](const ilazy& x, const ilazy& y){ return *x * *y; };
+				auto d = ftl::defer(mul, a, b);
+				auto r = ftl::monad<ilazy>::pure(3);
+				auto e = ftl::defer(mul, a, r);
+
+				return lazy_access::node(c)->dependencies() == 2
+					&& lazy_access::node(d)->dependencies() == 2
+					&& lazy_access::node(d)->dependency(0) == lazy_access::node(a)
+					&& lazy_access::node(e)->dependencies() == 1
+					&& lazy_access::node(a)->dependencies() == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("dependencies[fused map]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::_dtl::lazy_access;
+
+				auto a = ftl::defer([](int x){ return x; }, 1);
+				auto b = [](int x){ return x+1; } % ftl::defer(
+					[](const ilazy& x, int y){ return *x + y; }, a, 2
+				);
+
+				return lazy_access::node(b)->dependencies() == 1
+					&& lazy_access::node(b)->dependency(0) == lazy_access::node(a)
+					&& *b == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("evaluate[diamond]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+
+				ftl::thread_pool pool(4);
+				std::atomic<int> runs{0};
+
+				auto top = ftl::lazy<int>{[&runs](){ ++runs; return 2; }};
+				auto left = ftl::defer([&runs](const ilazy& x){
+					++runs;
+					return *x+1;
+				}, top);
+				auto right = ftl::defer([&runs](const ilazy& x){
+					++runs;
+					return *x*3;
+				}, top);
+				auto bottom = ftl::curry<2>([&runs](int x, int y){
+					++runs;
+					return x+y;
+				}) % left * right;
+
+				auto& x = ftl::evaluate(bottom, pool);
+
+				return x == 9 && runs == 4
+					&& top.status() == ftl::value_status::ready
+					&& left.status() == ftl::value_status::ready
+					&& right.status() == ftl::value_status::ready;
+			})
+		),
+		std::make_tuple(
+			std::string("evaluate[concurrent]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+
+				ftl::thread_pool pool(4);
+				std::atomic<int> arrived{0};
+
+				// Only done if both leaves are computed at the same time
+				auto leaf = [&arrived](int x){
+					return rendezvous(arrived, 2) ? x : -1;
+				};
+
+				auto a = ftl::defer(leaf, 1);
+				auto b = ftl::defer(leaf, 2);
+				auto c = ftl::curry<2>([](int x, int y){ return x+y; }) % a * b;
+
+				return ftl::evaluate(c, pool) == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("evaluate[roots]"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(4);
+				std::atomic<int> runs{0};
+
+				auto shared = ftl::lazy<int>{[&runs](){ ++runs; return 1; }};
+
+				std::vector<ftl::lazy<int>> roots;
+				for(int i = 0; i < 32; ++i) {
+					roots.push_back(ftl::defer([&runs](const ilazy& x, int y){
+						++runs;
+						return *x+y;
+					}, shared, i));
+				}
+
+				ftl::evaluate(roots, pool);
+
+				for(int i = 0; i < 32; ++i) {
+					if(roots[i].status() != ftl::value_status::ready
+							|| *roots[i] != i+1)
+						return false;
+				}
+
+				return runs == 33;
+			})
+		),
+		std::make_tuple(
+			std::string("evaluate[unrecorded dependencies]"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(4);
+				std::atomic<int> runs{0};
+
+				auto shared = ftl::lazy<int>{[&runs](){
+					++runs;
+					std::this_thread::sleep_for(std::chrono::milliseconds(10));
+					return 5;
+				}};
+
+				// Forces shared without having recorded it
+				std::vector<ftl::lazy<int>> roots;
+				for(int i = 0; i < 8; ++i) {
+					roots.push_back(ftl::lazy<int>{[shared,i](){
+						return *shared + i;
+					}});
+				}
+
+				roots.push_back(ftl::defer([](const ilazy& x){ return *x; }, shared));
+
+				// More than two lazy arguments
+				auto d = ftl::defer([](const ilazy& x, const ilazy& y, const ilazy& z){
+					return *x + *y + *z;
+				}, roots[0], roots[1], roots[2]);
+				roots.push_back(d);
+
+				ftl::evaluate(roots, pool);
+
+				return runs == 1 && *roots[7] == 12 && *roots[8] == 5
+					&& *d == 18;
+			})
+		),
+		std::make_tuple(
+			std::string("evaluate[bind]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				ftl::thread_pool pool(2);
+
+				auto a = ftl::defer([](int x){ return x; }, 2);
+				auto b = a >>= [](int x){
+					return ftl::defer([](int y){ return y*10; }, x);
+				};
+
+				return ftl::evaluate(b, pool) == 20;
+			})
+		),
+		std::make_tuple(
+			std::string("evaluate[exception]"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(4);
+				std::atomic<int> dependent_runs{0};
+
+				auto bad = ftl::lazy<int>{[]() -> int {
+					throw std::runtime_error("no data");
+				}};
+				auto good = ftl::defer([](int x){ return x; }, 1);
+				auto dependent = ftl::defer([&dependent_runs](const ilazy& x){
+					int y = *x;
+					++dependent_runs;
+					return y;
+				}, bad);
+
+				try {
+					ftl::evaluate(std::vector<ftl::lazy<int>>{dependent, good}, pool);
+				}
+				catch(std::runtime_error& e) {
+					return std::string(e.what()) == "no data"
+						&& dependent_runs == 0
+						&& bad.status() == ftl::value_status::deferred
+						&& dependent.status() == ftl::value_status::deferred
+						&& good.status() == ftl::value_status::ready;
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("evaluate[ready]"),
+			std::function<bool()>([]() -> bool {
+				ftl::inline_executor ex;
+
+				auto a = ftl::monad<ftl::lazy<int>>::pure(3);
+				auto b = ftl::defer([](const ilazy& x){ return *x+1; }, a);
+				*b;
+
+				return ftl::evaluate(b, ex) == 4
+					&& ftl::evaluate(a, ex) == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("evaluate[inline_executor]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+
+				ftl::inline_executor ex;
+				int runs = 0;
+
+				auto a = ftl::lazy<int>{[&runs](){ ++runs; return 1; }};
+				auto b = ftl::defer([&runs](const ilazy& x){
+					++runs;
+					return *x+1;
+				}, a);
+				auto c = ftl::curry<2>([&runs](int x, int y){
+					++runs;
+					return x*y;
+				}) % a * b;
+
+				return ftl::evaluate(c, ex) == 2 && runs == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("evaluate[leaf before dependent]"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(4);
+
+				for(int i = 0; i < 100; ++i) {
+					auto leaf = ftl::defer([](int x){ return x; }, i);
+					auto top = ftl::defer([](const ilazy& x){ return *x+1; }, leaf);
+
+					ftl::evaluate(std::vector<ilazy>{leaf, top}, pool);
+
+					if(*top != i+1)
+						return false;
+				}
+
+				return true;
+			})
+		)
+	}
+};
+
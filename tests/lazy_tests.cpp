@@ -20,8 +20,12 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <algorithm>
 #include <string>
+#include <memory>
+#include <vector>
 #include <ftl/lazy.h>
+#include "counting_resource.h"
 #include "lazy_tests.h"
 
 test_set lazy_tests{
@@ -84,6 +88,32 @@ test_set lazy_tests{
 					&& *l1 == x;
 			})
 		),
+		std::make_tuple(
+			std::string("Computation is released once forced"),
+			std::function<bool()>([]() -> bool {
+				auto p = std::make_shared<int>(3);
+				ftl::lazy<int> l{[p](){ return *p; }};
+
+				if(p.use_count() != 2)
+					return false;
+
+				return *l == 3 && p.use_count() == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("Move-only computations"),
+			std::function<bool()>([]() -> bool {
+				struct take {
+					int operator()() const { return *p; }
+					std::unique_ptr<int> p;
+				};
+
+				ftl::lazy<int> l{take{std::unique_ptr<int>(new int(4))}};
+				auto l2 = [](int x){ return x*2; } % l;
+
+				return *l2 == 8 && *l == 4;
+			})
+		),
 		std::make_tuple(
 			std::string("monoid::append"),
 			std::function<bool()>([]() -> bool {
@@ -117,8 +147,8 @@ test_set lazy_tests{
 				auto l2(l1);
 				auto l3 = [](int x){ return x+1; } % l1;
 
-				auto r1 = l1 == l3;
-				auto r2 = l1 != l2;
+				ftl::lazy<bool> r1 = l1 == l3;
+				ftl::lazy<bool> r2 = l1 != l2;
 
 				return r1.status() == ftl::value_status::deferred
 					&& r2.status() == ftl::value_status::deferred
@@ -145,14 +175,67 @@ test_set lazy_tests{
 				auto l2(l1);
 				auto l3 = [](int x){ return x+1; } % l1;
 
-				auto r1 = l1 < l3;
-				auto r2 = l1 > l2;
+				ftl::lazy<bool> r1 = l1 < l3;
+				ftl::lazy<bool> r2 = l1 > l2;
 
 				return r1.status() == ftl::value_status::deferred
 					&& r2.status() == ftl::value_status::deferred
 					&& r1 && !r2;
 			})
 		),
+		std::make_tuple(
+			std::string("Sorting and deduplicating lazy values"),
+			std::function<bool()>([]() -> bool {
+				auto f = [](int x){ return x; };
+				std::vector<ftl::lazy<int>> v{
+					ftl::defer(f, 3), ftl::defer(f, 1),
+					ftl::defer(f, 3), ftl::defer(f, 2)
+				};
+
+				std::sort(v.begin(), v.end());
+				auto e = std::unique(v.begin(), v.end());
+
+				return e - v.begin() == 3
+					&& *v[0] == 1 && *v[1] == 2 && *v[2] == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("Fused map chains"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				counting_resource r;
+				ftl::resource_allocator<int> alloc(&r);
+
+				int calls = 0;
+				auto l = [](int x){ return x*2; }
+					% ([](int x){ return x+1; }
+					% ftl::lazy<int>{
+						std::allocator_arg, alloc,
+						[&calls](){ ++calls; return 1; }
+					});
+
+				// The source and the intermediate cell are already gone
+				auto released = r.allocations - r.live;
+
+				return released == 2
+					&& l.status() == ftl::value_status::deferred
+					&& *l == 4 && *l == 4 && calls == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("map does not fuse shared computations"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				int calls = 0;
+				ftl::lazy<int> l1{[&calls](){ ++calls; return 1; }};
+				auto l2 = [](int x){ return x+1; } % l1;
+				auto l3 = [](int x){ return x+2; } % std::move(l2);
+
+				return *l3 == 4 && *l1 == 1 && calls == 1;
+			})
+		),
 		std::make_tuple(
 			std::string("applicative::pure"),
 			std::function<bool()>([]() -> bool {
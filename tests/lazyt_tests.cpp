@@ -21,8 +21,10 @@
  * distribution.
  */
 #include <string>
+#include <vector>
 #include <ftl/maybe.h>
 #include <ftl/lazy_trans.h>
+#include <ftl/vector.h>
 #include <ftl/functional.h>
 #include "lazyt_tests.h"
 
@@ -113,6 +115,74 @@ test_set lazyt_tests{
 
 				return *ftl::get<0>(*b) == 6;
 			})
+		),
+		std::make_tuple(
+			std::string("batch_lazyT::map[defers once]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int calls = 0;
+				batch_lazyT<std::vector<int>> l{std::vector<int>{1,2,3}};
+				auto m = [&calls](int x){ ++calls; return x*2; } % l;
+
+				bool deferred = m.status() == value_status::deferred
+					&& calls == 0;
+
+				bool forced = (*m)[2] == 6 && calls == 3;
+				bool once = m->size() == 3 && calls == 3;
+
+				return deferred && forced && once;
+			})
+		),
+		std::make_tuple(
+			std::string("batch_lazyT::bind"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using bT = batch_lazyT<std::vector<int>>;
+
+				bT l{std::vector<int>{1,2}};
+				auto b = l >>= [](int x){
+					return bT{std::vector<int>{x, x*10}};
+				};
+				auto c = l >>= [](int x){ return std::vector<int>{-x}; };
+
+				return *b == std::vector<int>{1,10,2,20}
+					&& *c == std::vector<int>{-1,-2};
+			})
+		),
+		std::make_tuple(
+			std::string("chunked_lazyT::map[forces one block]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int calls = 0;
+				chunked_lazyT<std::vector<int>> l{
+					std::vector<int>{1,2,3,4,5,6,7}, 3
+				};
+				auto m = [&calls](int x){ ++calls; return x+1; } % l;
+
+				bool deferred = calls == 0 && m.blocks() == 3;
+				bool one = m.at(4) == 6 && calls == 3;
+
+				return deferred && one
+					&& m.force() == std::vector<int>{2,3,4,5,6,7,8}
+					&& calls == 7;
+			})
+		),
+		std::make_tuple(
+			std::string("chunked_lazyT::foldl"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				chunked_lazyT<std::vector<int>> l{
+					std::vector<int>{1,2,3,4,5}, 2
+				};
+
+				auto d = foldl([](int a, int b){ return a*10 + b; }, 0, l);
+				auto r = foldr([](int a, int b){ return b*10 + a; }, 0, l);
+
+				return d == 12345 && r == 54321;
+			})
 		)
 	}
 };
@@ -218,6 +218,38 @@ test_set list_tests{
 					== std::list<int>{1,2,2,3,3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("monad::bind[streams results]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				// Remembers how many times f had been called when moved
+				static int calls = 0;
+				struct stamped {
+					stamped(int x) : x(x), at(calls) {}
+					stamped(const stamped& s) : x(s.x), at(calls) {}
+					stamped(stamped&& s) : x(s.x), at(calls) {}
+
+					int x;
+					int at;
+				};
+
+				auto f = [](int x){
+					++calls;
+					return std::vector<stamped>{x, x};
+				};
+
+				calls = 0;
+				auto l = std::list<int>{1,2,3} >>= f;
+
+				bool ok = l.size() == 6;
+				for(auto& s : l) {
+					ok = ok && s.at == s.x;
+				}
+
+				return ok;
+			})
+		),
 		std::make_tuple(
 			std::string("monad::bind[&,->maybe]"),
 			std::function<bool()>([]() -> bool {
@@ -232,6 +264,19 @@ test_set list_tests{
 				return (l >>= f) == std::list<int>{3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("monad::join[&&] splices"),
+			std::function<bool()>([]() -> bool {
+				using std::list;
+
+				list<list<int>> l{{1,2},{},{3}};
+				auto p = &l.back().front();
+
+				auto r = ftl::monad<list<int>>::join(std::move(l));
+
+				return r == list<int>{1,2,3} && &r.back() == p;
+			})
+		),
 		std::make_tuple(
 			std::string("foldable::foldl"),
 			std::function<bool()>([]() -> bool {
@@ -354,7 +399,59 @@ test_set list_tests{
 					std::make_tuple(3,1.f)
 				};
 			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith[3-ary]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::list<int> l1{1,2,3};
+				std::list<int> l2{4,5,6,7};
+				std::list<int> l3{7,8,9};
+
+				auto l4 = ftl::zipWith(
+					[](int x, int y, int z){ return x + y + z; }, l1, l2, l3
+				);
+
+				return l4 == std::list<int>{12,15,18};
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::mconcat"),
+			std::function<bool()>([]() -> bool {
+				using lst = std::list<int>;
+
+				std::vector<lst> v{lst{1}, lst{}, lst{2,3}};
+				auto l1 = ftl::monoid<lst>::mconcat(v);
+
+				auto p = &v[2].front();
+				auto l2 = ftl::monoid<lst>::mconcat(std::move(v));
+
+				return l1 == lst{1,2,3} && l2 == lst{1,2,3}
+					&& &*std::next(l2.begin()) == p;
+			})
+		),
+		std::make_tuple(
+			std::string("filter and mapMaybe"),
+			std::function<bool()>([]() -> bool {
+				auto half = [](int x){
+					return x % 2 ? ftl::nothing<int>() : ftl::just(x/2);
+				};
+				auto odd = [](int x){ return x % 2 != 0; };
+
+				std::list<int> l{1, 2, 3, 4};
+				auto odds = ftl::filter(odd, l);
+				auto halves = ftl::mapMaybe(half, l);
+
+				auto first = &l.back();
+				auto moved = ftl::mapMaybe(half, std::move(l));
+
+				return odds == std::list<int>{1, 3}
+					&& halves == std::list<int>{1, 2}
+					&& moved == halves && &moved.back() == first
+					&& ftl::filter(odd, std::list<int>{2, 5}) == std::list<int>{5};
+			})
 		)
+
 	}
 };
-
@@ -21,26 +21,57 @@
  * distribution.
  */
 #include <iostream>
+#include <ftl/instrument.h>
 #include "sum_type_tests.h"
 #include "either_tests.h"
 #include "maybe_tests.h"
 #include "future_tests.h"
+#include "async_tests.h"
+#include "cancellation_tests.h"
+#include "executor_tests.h"
 #include "lazy_tests.h"
+#include "lazy_graph_tests.h"
 #include "ord_tests.h"
+#include "sort_tests.h"
 #include "functional_tests.h"
+#include "parallel_tests.h"
 #include "prelude_tests.h"
 #include "maybet_tests.h"
 #include "eithert_tests.h"
 #include "lazyt_tests.h"
+#include "codensity_tests.h"
+#include "trampoline_tests.h"
+#include "shared_lazy_tests.h"
+#include "channel_tests.h"
+#include "evictable_lazy_tests.h"
 #include "list_tests.h"
 #include "vector_tests.h"
+#include "view_tests.h"
 #include "fwdlist_tests.h"
 #include "tuple_tests.h"
 #include "memory_tests.h"
+#include "memory_resource_tests.h"
+#include "pooled_allocator_tests.h"
 #include "string_tests.h"
 #include "set_tests.h"
 #include "map_tests.h"
+#include "flat_set_tests.h"
+#include "flat_map_tests.h"
 #include "unordered_map_tests.h"
+#include "hash_map_tests.h"
+#include "instrument_tests.h"
+#include "trace_tests.h"
+#include "persistent_vector_tests.h"
+#include "persistent_hash_map_tests.h"
+#include "persistent_hash_set_tests.h"
+#include "soa_vector_tests.h"
+#include "segment_tree_tests.h"
+#include "coroutine_tests.h"
+#include "memoize_tests.h"
+#include "binary_tests.h"
+#include "small_vector_tests.h"
+#include "validation_tests.h"
+#include "stream_tests.h"
 #include "concept_tests.h"
 
 bool run_test_set(test_set& ts, std::ostream& os) {
@@ -89,20 +120,55 @@ int main(int, char**) {
 	flawless &= run_test_set(maybe_tests, std::cout);
 	flawless &= run_test_set(maybet_tests, std::cout);
 	flawless &= run_test_set(future_tests, std::cout);
+	flawless &= run_test_set(async_tests, std::cout);
+	flawless &= run_test_set(cancellation_tests, std::cout);
+	flawless &= run_test_set(executor_tests, std::cout);
 	flawless &= run_test_set(lazy_tests, std::cout);
+	flawless &= run_test_set(lazy_graph_tests, std::cout);
 	flawless &= run_test_set(lazyt_tests, std::cout);
+	flawless &= run_test_set(codensity_tests, std::cout);
+	flawless &= run_test_set(trampoline_tests, std::cout);
+	flawless &= run_test_set(shared_lazy_tests, std::cout);
+	flawless &= run_test_set(evictable_lazy_tests, std::cout);
+	flawless &= run_test_set(channel_tests, std::cout);
 	flawless &= run_test_set(ord_tests, std::cout);
+	flawless &= run_test_set(sort_tests, std::cout);
 	flawless &= run_test_set(functional_tests, std::cout);
+	flawless &= run_test_set(parallel_tests, std::cout);
 	flawless &= run_test_set(list_tests, std::cout);
 	flawless &= run_test_set(vector_tests, std::cout);
+	flawless &= run_test_set(view_tests, std::cout);
 	flawless &= run_test_set(fwdlist_tests, std::cout);
 	flawless &= run_test_set(tuple_tests, std::cout);
 	flawless &= run_test_set(memory_tests, std::cout);
+	flawless &= run_test_set(memory_resource_tests, std::cout);
+	flawless &= run_test_set(pooled_allocator_tests, std::cout);
 	flawless &= run_test_set(string_tests, std::cout);
 	flawless &= run_test_set(set_tests, std::cout);
 	flawless &= run_test_set(map_tests, std::cout);
+	flawless &= run_test_set(flat_set_tests, std::cout);
+	flawless &= run_test_set(flat_map_tests, std::cout);
 	flawless &= run_test_set(unordered_map_tests, std::cout);
+	flawless &= run_test_set(hash_map_tests, std::cout);
+	flawless &= run_test_set(persistent_vector_tests, std::cout);
+	flawless &= run_test_set(persistent_hash_map_tests, std::cout);
+	flawless &= run_test_set(persistent_hash_set_tests, std::cout);
+	flawless &= run_test_set(soa_vector_tests, std::cout);
+	flawless &= run_test_set(segment_tree_tests, std::cout);
+	flawless &= run_test_set(stream_tests, std::cout);
+	flawless &= run_test_set(coroutine_tests, std::cout);
+	flawless &= run_test_set(memoize_tests, std::cout);
+	flawless &= run_test_set(binary_tests, std::cout);
+	flawless &= run_test_set(small_vector_tests, std::cout);
+	flawless &= run_test_set(validation_tests, std::cout);
 	flawless &= run_test_set(concept_tests, std::cout);
+	flawless &= run_test_set(instrument_tests, std::cout);
+	flawless &= run_test_set(trace_tests, std::cout);
+
+	if(ftl::allocation_counting) {
+		std::cout << std::endl << "Allocations made by ftl:" << std::endl;
+		ftl::report_allocations(std::cout);
+	}
 
 	if(!flawless)
 		return -1;
@@ -20,6 +20,7 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <string>
 #include <ftl/map.h>
 #include "map_tests.h"
 
@@ -114,7 +115,51 @@ test_set map_tests{
 
 				return fold(m) == 24;
 			})
+		),
+		std::make_tuple(
+			std::string("lookup refers to the value"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using std::make_pair;
+
+				std::map<int,std::string> m{
+					make_pair(0, std::string("zero")),
+					make_pair(1, std::string("one"))
+				};
+
+				auto v = lookup(1, m);
+				auto n = lookup(2, m);
+				get<std::string&>(v) += "!";
+
+				const auto& cm = m;
+				auto len = [](const std::string& s){ return s.size(); };
+
+				return m[1] == "one!"
+					&& n.is<Nothing>()
+					&& (len % lookup(0, cm)) == just(std::size_t(4));
+			})
+		),
+		std::make_tuple(
+			std::string("filter and mapMaybe"),
+			std::function<bool()>([]() -> bool {
+				auto parse = [](const std::string& s){
+					return s.size() == 1 && s[0] >= '0' && s[0] <= '9'
+						? ftl::just(s[0] - '0') : ftl::nothing<int>();
+				};
+				auto shortish = [](const std::string& s){ return s.size() < 3; };
+
+				std::map<int,std::string> m{{1, "1"}, {2, "two"}, {3, "3"}};
+
+				auto nums = ftl::mapMaybe(parse, m);
+				auto kept = ftl::filter(shortish, m);
+				auto moved = ftl::filter(shortish, std::move(m));
+
+				return nums == std::map<int,int>{{1, 1}, {3, 3}}
+					&& kept == std::map<int,std::string>{{1, "1"}, {3, "3"}}
+					&& moved == kept;
+			})
 		)
+
 	}
 };
 
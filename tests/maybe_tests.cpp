@@ -20,10 +20,49 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <unordered_set>
 #include <ftl/maybe.h>
 #include <ftl/type_functions.h>
 #include "maybe_tests.h"
 
+static_assert(sizeof(ftl::maybe<char>) == 2, "");
+static_assert(sizeof(ftl::maybe<int>) == 2*sizeof(int), "");
+static_assert(sizeof(ftl::maybe<int*>) == sizeof(int*), "");
+static_assert(sizeof(ftl::maybe<const int*>) == sizeof(int*), "");
+static_assert(std::is_trivially_copyable<ftl::maybe<double>>::value, "");
+static_assert(std::is_trivially_destructible<ftl::maybe<int*>>::value, "");
+static_assert(!std::is_trivially_copyable<ftl::maybe<std::string>>::value, "");
+static_assert(sizeof(ftl::maybe<std::string&>) == sizeof(std::string*), "");
+
+constexpr int twice(int x) { return 2*x; }
+
+constexpr ftl::maybe<int> half(int x) {
+	return x % 2 ? ftl::nothing<int>() : ftl::just(x/2);
+}
+
+static_assert(ftl::monad<ftl::maybe<int>>::map(twice, ftl::just(3))
+		== ftl::just(6), "");
+static_assert(ftl::monad<ftl::maybe<int>>::bind(ftl::just(4), half)
+		== ftl::just(2), "");
+static_assert(ftl::monad<ftl::maybe<int>>::bind(ftl::just(3), half)
+		== ftl::nothing<int>(), "");
+
+constexpr int answer = 42;
+constexpr ftl::maybe<const int*> no_ptr = ftl::nothing<const int*>();
+constexpr ftl::maybe<const int*> some_ptr = ftl::just(&answer);
+constexpr ftl::maybe<const int*> null_ptr = ftl::just(static_cast<const int*>(nullptr));
+
+static_assert(no_ptr.is<ftl::Nothing>(), "");
+static_assert(some_ptr.is<const int*>(), "");
+static_assert(null_ptr.is<const int*>(), "");
+static_assert(ftl::just(&answer).is<const int*>(), "");
+constexpr const int* same(const int* p) { return p; }
+
+static_assert(ftl::monad<ftl::maybe<const int*>>::map(same, no_ptr)
+		== no_ptr, "");
+static_assert(ftl::monad<ftl::maybe<const int*>>::map(same, some_ptr)
+		== some_ptr, "");
+
 test_set maybe_tests{
 	std::string("maybe"),
 	{
@@ -36,6 +75,24 @@ test_set maybe_tests{
 				return e1 == e2;
 			})
 		),
+		std::make_tuple(
+			std::string("maybe<T*> tells nullptr from Nothing"),
+			std::function<bool()>([]() -> bool {
+				int x = 1;
+				ftl::maybe<int*> m1 = ftl::just(static_cast<int*>(nullptr));
+				ftl::maybe<int*> m2 = ftl::nothing<int*>();
+				ftl::maybe<int*> m3 = ftl::just(&x);
+
+				auto m4 = m2;
+				m2 = m3;
+				m3 = m4;
+
+				return m1.is<int*>() && ftl::get<int*>(m1) == nullptr
+					&& m2.is<int*>() && ftl::get<int*>(m2) == &x
+					&& m3.is<ftl::Nothing>() && m4.is<ftl::Nothing>()
+					&& m3 == m4 && !(m1 == m3);
+			})
+		),
 		std::make_tuple(
 			std::string("Preserves Orderable"),
 			std::function<bool()>([]() -> bool {
@@ -271,7 +328,61 @@ test_set maybe_tests{
 
 				return fold(m1) == 2 && fold(m2) == 1;
 			})
+		),
+		std::make_tuple(
+			std::string("maybe<T&> refers to its value"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::string s("abc");
+				maybe<std::string&> m{constructor<std::string&>(), s};
+				maybe<std::string&> n = nothing<std::string&>();
+
+				for(auto& x : m)
+					x += "d";
+
+				auto len = [](const std::string& x){ return x.size(); };
+				auto sz = [](std::size_t z, const std::string& x){
+					return z + x.size();
+				};
+
+				return s == "abcd"
+					&& std::addressof(get<std::string&>(m)) == &s
+					&& (len % m) == just(std::size_t(4))
+					&& (len % n) == nothing<std::size_t>()
+					&& foldl(sz, std::size_t(1), m) == 5
+					&& n.is<Nothing>();
+			})
+		),
+		std::make_tuple(
+			std::string("std::hash"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::unordered_set<maybe<int>> s{just(1), just(2), nothing<int>()};
+				std::string str("abc");
+				std::hash<maybe<std::string&>> h;
+
+				return s.size() == 3 && s.count(just(2)) == 1
+					&& s.count(nothing<int>()) == 1 && s.count(just(3)) == 0
+					&& std::hash<maybe<int>>()(just(0))
+						!= std::hash<maybe<int>>()(nothing<int>())
+					&& h(maybe<std::string&>{constructor<std::string&>(), str})
+						== std::hash<maybe<std::string>>()(just(str));
+			})
+		),
+		std::make_tuple(
+			std::string("liftA"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto sum3 = [](int x, int y, int z){ return x + y + z; };
+
+				return liftA(sum3, just(1), just(2), just(3)) == just(6)
+					&& liftA(sum3, just(1), nothing<int>(), just(3)) == nothing<int>();
+			})
 		)
+
 	}
 };
 
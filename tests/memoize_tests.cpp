@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ftl/memoize.h>
+#include "memoize_tests.h"
+
+namespace {
+	int calls = 0;
+
+	int add(int x, int y) {
+		++calls;
+		return x + y;
+	}
+}
+
+test_set memoize_tests{
+	std::string("memoize"),
+	{
+		std::make_tuple(
+			std::string("Same results, fewer calls"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				calls = 0;
+				auto cache = std::make_shared<unbounded_cache<memo_key<int,int>,int>>();
+				auto f = memoize(add, cache);
+
+				bool same = f(1, 2) == 3 && f(1, 2) == 3 && f(2, 1) == 3;
+				auto s = cache->stats();
+
+				return same && calls == 2 && s.hits == 1 && s.misses == 2
+					&& cache->size() == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("Curried calls"),
+			std::function<bool()>([]() -> bool {
+				calls = 0;
+				auto f = ftl::memoize(add);
+				auto g = f(1);
+
+				return g(2) == 3 && f(1, 2) == 3 && g(3) == 4 && calls == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("Reference parameters"),
+			std::function<bool()>([]() -> bool {
+				int n = 0;
+				ftl::function<std::size_t(const std::string&)> len =
+					[&n](const std::string& s) { ++n; return s.size(); };
+
+				auto f = ftl::memoize(len);
+				std::string a("abc"), b("abc");
+
+				return f(a) == 3 && f(b) == 3 && n == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("lru_cache evicts least recently used"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				calls = 0;
+				auto cache = std::make_shared<lru_cache<memo_key<int,int>,int>>(2);
+				auto f = memoize(add, cache);
+
+				f(1, 1); f(2, 2);
+				f(1, 1);			// (2,2) is now the least recently used
+				f(3, 3);			// evicting it
+				f(1, 1);
+				bool kept = calls == 3;
+				f(2, 2);
+
+				return kept && calls == 4 && cache->size() == 2
+					&& cache->stats().hits == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("concurrent_cache from several threads"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using cache_t = concurrent_cache<memo_key<int>,int>;
+
+				std::atomic<int> n(0);
+				ftl::function<int(int)> sq = [&n](int x) { ++n; return x * x; };
+
+				auto cache = std::make_shared<cache_t>(8);
+				auto f = memoize(sq, cache);
+
+				std::vector<std::thread> ts;
+				std::atomic<bool> ok(true);
+				for(int t = 0; t < 4; ++t) {
+					ts.emplace_back([&]() {
+						for(int i = 0; i < 100; ++i)
+							if(f(i) != i * i)
+								ok = false;
+					});
+				}
+
+				for(auto& t : ts)
+					t.join();
+
+				auto s = cache->stats();
+				return ok && cache->size() == 100 && n >= 100
+					&& s.hits + s.misses == 400 && s.misses == std::size_t(n);
+			})
+		),
+		std::make_tuple(
+			std::string("concurrent_cache of lru_caches"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using key = memo_key<int,int>;
+				using cache_t = concurrent_cache<key,int,lru_cache<key,int>>;
+
+				calls = 0;
+				auto cache = std::make_shared<cache_t>(4, 2);
+				auto f = memoize(add, cache);
+
+				for(int i = 0; i < 50; ++i)
+					f(i, i);
+
+				return cache->size() <= 8 && f(49, 49) == 98
+					&& cache->find(key(49, 49)) == just(98)
+					&& cache->find(key(0, 0)) == nothing<int>();
+			})
+		)
+	}
+};
+
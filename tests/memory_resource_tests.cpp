@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include <ftl/memory_resource.h>
+#include <ftl/lazy.h>
+#include <ftl/vector.h>
+#include "counting_resource.h"
+#include "memory_resource_tests.h"
+
+test_set memory_resource_tests{
+	std::string("memory_resource"),
+	{
+		std::make_tuple(
+			std::string("monotonic_buffer_resource aligns and grows"),
+			std::function<bool()>([]() -> bool {
+				counting_resource upstream(ftl::new_delete_resource());
+				bool aligned = true;
+				{
+					ftl::monotonic_buffer_resource arena(&upstream);
+
+					for(int i = 0; i < 1000; ++i) {
+						void* p = arena.allocate(i % 13 + 1, 8);
+						aligned &= reinterpret_cast<std::uintptr_t>(p) % 8 == 0;
+						arena.deallocate(p, i % 13 + 1, 8);
+					}
+				}
+
+				return aligned && upstream.allocations > 1 && upstream.live == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("monotonic_buffer_resource uses initial buffer first"),
+			std::function<bool()>([]() -> bool {
+				alignas(std::max_align_t) char buffer[256];
+				counting_resource upstream(ftl::new_delete_resource());
+				ftl::monotonic_buffer_resource arena(
+					buffer, sizeof(buffer), &upstream
+				);
+
+				void* p = arena.allocate(64);
+				bool inside = p >= static_cast<void*>(buffer)
+					&& p < static_cast<void*>(buffer + sizeof(buffer));
+
+				arena.allocate(512);
+
+				return inside && upstream.allocations == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("resource_allocator in std::vector"),
+			std::function<bool()>([]() -> bool {
+				counting_resource r(ftl::new_delete_resource());
+				{
+					std::vector<int, ftl::resource_allocator<int>> v{&r};
+					for(int i = 0; i < 100; ++i)
+						v.push_back(i);
+				}
+
+				return r.allocations > 0 && r.live == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("lazy allocates from resource"),
+			std::function<bool()>([]() -> bool {
+				counting_resource r(ftl::new_delete_resource());
+				std::string s(100, 'a');
+				int n = 0;
+				{
+					ftl::resource_allocator<int> alloc(&r);
+					auto l = ftl::lazy<std::size_t>(
+						std::allocator_arg, alloc,
+						[s]() { return s.size(); }
+					);
+
+					n = r.live;
+					if(*l != 100)
+						return false;
+				}
+
+				// The cell, and the thunk that does not fit in place
+				return n == 2 && r.live == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("lazy propagates resource through map and bind"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator>>=;
+
+				counting_resource r(ftl::new_delete_resource());
+				int before = 0, after = 0;
+				{
+					ftl::resource_allocator<int> alloc(&r);
+					auto l = ftl::defer(
+						std::allocator_arg, alloc,
+						[](int x){ return x+1; }, 1
+					);
+
+					before = r.allocations;
+
+					auto l2 = [](int x){ return x*2; } % l;
+					auto l3 = l2 >>= [](int x){ return ftl::aPure<ftl::lazy<int>>()(x+1); };
+
+					after = r.allocations;
+					if(*l3 != 5)
+						return false;
+				}
+
+				return after > before && r.live == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("defer from monotonic_buffer_resource"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::monotonic_buffer_resource arena;
+				ftl::resource_allocator<int> alloc(&arena);
+
+				auto l = ftl::defer(
+					std::allocator_arg, alloc,
+					[](int x, int y){ return x+y; }, 2, 3
+				);
+
+				for(int i = 0; i < 10; ++i) {
+					l = [](int x){ return x+1; } % l;
+				}
+
+				return *l == 15;
+			})
+		),
+		std::make_tuple(
+			std::string("concatMap keeps allocator"),
+			std::function<bool()>([]() -> bool {
+				counting_resource r(ftl::new_delete_resource());
+				using alloc_t = ftl::resource_allocator<int>;
+				{
+					std::vector<int, alloc_t> v({1,2,3}, alloc_t(&r));
+
+					auto v2 = ftl::concatMap(
+						[](int x){ return std::vector<int>{x, x}; }, v
+					);
+
+					if(v2.get_allocator().resource() != &r)
+						return false;
+
+					if(v2 != std::vector<int, alloc_t>{1,1,2,2,3,3})
+						return false;
+				}
+
+				return r.live == 0;
+			})
+		)
+	}
+};
+
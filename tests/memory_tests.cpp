@@ -20,9 +20,49 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <string>
 #include <ftl/memory.h>
 #include "memory_tests.h"
 
+namespace {
+	// Allocator counting the allocations made through it and its copies
+	template<typename T>
+	struct counting_allocator {
+		using value_type = T;
+
+		explicit counting_allocator(std::shared_ptr<int> n) : n(std::move(n)) {}
+
+		template<typename U>
+		counting_allocator(const counting_allocator<U>& a) : n(a.n) {}
+
+		T* allocate(std::size_t k) {
+			++*n;
+			return std::allocator<T>().allocate(k);
+		}
+
+		void deallocate(T* p, std::size_t k) {
+			std::allocator<T>().deallocate(p, k);
+		}
+
+		template<typename U>
+		bool operator== (const counting_allocator<U>& a) const {
+			return n == a.n;
+		}
+
+		template<typename U>
+		bool operator!= (const counting_allocator<U>& a) const {
+			return n != a.n;
+		}
+
+		std::shared_ptr<int> n;
+	};
+
+	struct config {
+		std::string name;
+		int port;
+	};
+}
+
 test_set memory_tests{
 	std::string("memory"),
 	{
@@ -52,6 +92,31 @@ test_set memory_tests{
 				return *pr == sum(4);
 			})
 		),
+		std::make_tuple(
+			std::string("append_in_place"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using sptr = std::shared_ptr<sum_monoid<int>>;
+
+				auto p1 = std::make_shared<sum_monoid<int>>(sum(2));
+				auto p2 = std::make_shared<sum_monoid<int>>(sum(3));
+				auto a = p1.get();
+
+				// p1 is still around, so a new object is made
+				auto r1 = append_in_place(p1, p2);
+				bool kept = *p1 == sum(2);
+
+				// Nothing else points to *a any longer, so it is updated
+				auto r2 = append_in_place(std::move(p1), p2);
+
+				// The plain append never updates anything
+				auto r3 = monoid<sptr>::append(std::move(r2), p2);
+
+				return kept && r1.get() != a && *r1 == sum(5)
+					&& r2 == nullptr && r3.get() != a && *r3 == sum(8)
+					&& *p2 == sum(3);
+			})
+		),
 		std::make_tuple(
 			std::string("functor::map"),
 			std::function<bool()>([]() -> bool {
@@ -63,6 +128,65 @@ test_set memory_tests{
 				return *pr == -3;
 			})
 		),
+		std::make_tuple(
+			std::string("map_in_place"),
+			std::function<bool()>([]() -> bool {
+				auto neg = [](int x){ return -x; };
+
+				auto p = std::make_shared<int>(3);
+				auto a = p.get();
+
+				auto shared = ftl::map_in_place(neg, p);
+				auto reused = ftl::map_in_place(neg, std::move(p));
+				auto other = ftl::map_in_place([](int x){ return x * .5f; }, reused);
+
+				return *shared == -3 && shared.get() != a
+					&& *reused == -3 && reused.get() == a && *other == -1.5f;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[weakly observed]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto p = std::make_shared<int>(3);
+				std::weak_ptr<int> w = p;
+
+				// The old object goes with its last owner, never having been
+				// changed under w's watch
+				auto r = [](int x){ return -x; } % std::move(p);
+
+				return *r == -3 && w.expired();
+			})
+		),
+		std::make_tuple(
+			std::string("allocate_map"),
+			std::function<bool()>([]() -> bool {
+				auto n = std::make_shared<int>(0);
+				counting_allocator<int> alloc(n);
+
+				auto p = std::allocate_shared<int>(alloc, 2);
+				auto q = ftl::allocate_map(alloc, [](int x){ return x * 1.5f; }, p);
+				auto r = ftl::allocate_map(alloc, [](int x){ return x + 1; }, std::move(p));
+
+				return *q == 3.f && *r == 3 && *n == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("project"),
+			std::function<bool()>([]() -> bool {
+				auto c = std::make_shared<config>(config{"ftl", 80});
+				std::shared_ptr<const config> cc = c;
+
+				std::shared_ptr<int> port = ftl::project(c, &config::port);
+				std::shared_ptr<const std::string> name = ftl::project(cc, &config::name);
+
+				c.reset();
+
+				return *port == 80 && *name == "ftl" && port.use_count() == 3
+					&& ftl::project(std::shared_ptr<config>(), &config::port) == nullptr;
+			})
+		),
 		std::make_tuple(
 			std::string("applicative::pure"),
 			std::function<bool()>([]() -> bool {
@@ -232,7 +356,84 @@ test_set memory_tests{
 
 				return foldr([](int x, int y){ return x+y; }, 1, p) == 1;
 			})
+		),
+		std::make_tuple(
+			std::string("unique_ptr::fmap[&&,in place]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::unique_ptr<int> p(new int(2));
+				auto addr = p.get();
+
+				auto q = [](int x){ return x*2; } % std::move(p);
+
+				return q.get() == addr && *q == 4;
+			})
+		),
+		std::make_tuple(
+			std::string("unique_ptr::fmap[a->b]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::unique_ptr<int> p(new int(2));
+				std::unique_ptr<int> n;
+
+				std::unique_ptr<float> q = [](int x){ return x*1.5f; } % p;
+				std::unique_ptr<float> r = [](int x){ return x*1.5f; } % n;
+
+				return *p == 2 && *q == 3.f && r == nullptr;
+			})
+		),
+		std::make_tuple(
+			std::string("unique_ptr::bind"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto f = [](std::string s){
+					return std::unique_ptr<std::size_t>(
+						new std::size_t(s.size())
+					);
+				};
+
+				auto p = monad<std::unique_ptr<std::string>>::pure("abc");
+				std::unique_ptr<std::string> n;
+
+				auto q = std::move(p) >>= f;
+				auto r = n >>= f;
+
+				return *q == 3 && r == nullptr;
+			})
+		),
+		std::make_tuple(
+			std::string("unique_ptr::foldl/foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::unique_ptr<int> p(new int(2));
+				std::unique_ptr<int> n;
+				auto sub = [](int x, int y){ return x-y; };
+
+				return foldl(sub, 1, p) == -1
+					&& foldr(sub, 1, p) == 1
+					&& foldl(sub, 1, n) == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("unique_ptr::monoid::append[&&,in place]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::unique_ptr<sum_monoid<int>> a(new sum_monoid<int>(2));
+				std::unique_ptr<sum_monoid<int>> b(new sum_monoid<int>(3));
+				std::unique_ptr<sum_monoid<int>> n;
+				auto addr = a.get();
+
+				auto c = std::move(a) ^ b;
+				auto d = n ^ b;
+
+				return c.get() == addr && *c == 5
+					&& d.get() != b.get() && *d == 3;
+			})
 		)
 	}
 };
-
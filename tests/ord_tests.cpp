@@ -22,6 +22,8 @@
  */
 #include <string>
 #include <list>
+#include <vector>
+#include <algorithm>
 #include <ftl/ord.h>
 #include "ord_tests.h"
 
@@ -99,6 +101,76 @@ test_set ord_tests{
 					&& (gt ^ lt) == ord::Gt
 					&& (gt ^ eq) == ord::Gt;
 			})
+		),
+		std::make_tuple(
+			std::string("operator^[comparators]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using rec = std::pair<std::string,int>;
+				auto by_len = comparing([](const rec& r){ return r.first.size(); });
+				auto cmp = by_len
+					^ comparing(&rec::second)
+					^ getComparator<rec>();
+
+				static_assert(
+					!std::is_same<
+						decltype(cmp),
+						function<ord(const rec&,const rec&)>
+					>::value,
+					"Composed comparators should not be type erased"
+				);
+
+				std::vector<rec> v{{"bb",1}, {"a",2}, {"cc",1}, {"d",2}, {"aa",1}};
+				std::sort(v.begin(), v.end(), asc(cmp));
+
+				return v == std::vector<rec>{
+					{"a",2}, {"d",2}, {"aa",1}, {"bb",1}, {"cc",1}
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("operator^[comparator, function]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				function<ord(const std::string&,const std::string&)> rev =
+					[](const std::string& a, const std::string& b) {
+						return compare(b, a);
+					};
+
+				auto cmp = comparing(&std::string::size) ^ rev;
+
+				std::vector<std::string> v{"a", "bb", "b", "aa"};
+				std::sort(v.begin(), v.end(), asc(cmp));
+
+				return v == std::vector<std::string>{"b", "a", "bb", "aa"}
+					&& desc(cmp)(v[1], v[0]) && equal(cmp)(v[2], v[2]);
+			})
+		),
+		std::make_tuple(
+			std::string("asc/desc[function_ref]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto cmp = comparing(&std::string::size);
+				function_ref<ord(const std::string&,const std::string&)> ref = cmp;
+
+				static_assert(
+					std::is_trivially_copyable<decltype(asc(ref))>::value,
+					"Predicate from function_ref should be trivially copyable"
+				);
+
+				std::vector<std::string> v{"aaa", "a", "aaaa", "aa"};
+				std::vector<std::string> w = v;
+
+				std::sort(v.begin(), v.end(), asc(ref));
+				std::sort(w.begin(), w.end(), desc(ref));
+
+				return v == std::vector<std::string>{"a", "aa", "aaa", "aaaa"}
+					&& w == std::vector<std::string>{"aaaa", "aaa", "aa", "a"}
+					&& equal(ref)(v[0], std::string("b"));
+			})
 		)
 	}
 };
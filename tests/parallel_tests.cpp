@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <atomic>
+#include <string>
+#include <stdexcept>
+#include <ftl/parallel.h>
+#include <ftl/vector.h>
+#include <ftl/list.h>
+#include <ftl/map.h>
+#include <ftl/set.h>
+#include <ftl/string.h>
+#include <ftl/maybe.h>
+#include <ftl/tuple.h>
+#include "parallel_tests.h"
+
+namespace {
+	// Commutative sum counting how many identities are created
+	struct counted_sum {
+		int n;
+	};
+
+	std::atomic<int> counted_ids{0};
+}
+
+namespace ftl {
+	template<>
+	struct monoid<counted_sum> {
+		static counted_sum id() {
+			++counted_ids;
+			return counted_sum{0};
+		}
+
+		static counted_sum append(counted_sum a, counted_sum b) {
+			return counted_sum{a.n + b.n};
+		}
+
+		static constexpr bool commutative = true;
+
+		static constexpr bool instance = true;
+	};
+}
+
+test_set parallel_tests{
+	std::string("parallel"),
+	{
+		std::make_tuple(
+			std::string("fmap[vector]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v(100000);
+				for(std::size_t i = 0; i < v.size(); ++i)
+					v[i] = int(i);
+
+				auto r = ftl::fmap(ftl::par, [](int x){ return x*2; }, v);
+
+				if(r.size() != v.size())
+					return false;
+
+				for(std::size_t i = 0; i < v.size(); ++i)
+					if(r[i] != v[i]*2)
+						return false;
+
+				return true;
+			})
+		),
+		std::make_tuple(
+			std::string("fmap[vector&&] on executor"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(3);
+				std::vector<std::string> v(5000, std::string("a"));
+
+				auto r = ftl::fmap(
+					ftl::par.on(pool).with_grain(64),
+					[](std::string s){ return s.size(); },
+					std::move(v)
+				);
+
+				return r == std::vector<std::size_t>(5000, 1);
+			})
+		),
+		std::make_tuple(
+			std::string("fmap[vector<bool>]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v(10000);
+				for(std::size_t i = 0; i < v.size(); ++i)
+					v[i] = int(i);
+
+				auto r = ftl::fmap(
+					ftl::par.with_grain(100),
+					[](int x){ return x % 3 == 0; },
+					v
+				);
+
+				for(std::size_t i = 0; i < v.size(); ++i)
+					if(r[i] != (v[i] % 3 == 0))
+						return false;
+
+				return true;
+			})
+		),
+		std::make_tuple(
+			std::string("fmap[list]"),
+			std::function<bool()>([]() -> bool {
+				std::list<int> l;
+				for(int i = 0; i < 5000; ++i)
+					l.push_back(i);
+
+				auto r = ftl::fmap(
+					ftl::par.with_grain(64),
+					[](int x){ return x+1; },
+					l
+				);
+
+				int i = 1;
+				for(auto x : r)
+					if(x != i++)
+						return false;
+
+				return r.size() == l.size();
+			})
+		),
+		std::make_tuple(
+			std::string("fmap[map]"),
+			std::function<bool()>([]() -> bool {
+				std::map<int,int> m;
+				for(int i = 0; i < 5000; ++i)
+					m[i] = i;
+
+				auto r = ftl::fmap(
+					ftl::par.with_grain(64),
+					[](int x){ return std::to_string(x); },
+					m
+				);
+
+				for(auto& kv : r)
+					if(kv.second != std::to_string(kv.first))
+						return false;
+
+				return r.size() == m.size();
+			})
+		),
+		std::make_tuple(
+			std::string("fmap[unordered_map]"),
+			std::function<bool()>([]() -> bool {
+				std::unordered_map<int,int> m;
+				for(int i = 0; i < 5000; ++i)
+					m[i] = i;
+
+				auto r = ftl::fmap(
+					ftl::par.with_grain(64),
+					[](int x){ return x*3; },
+					m
+				);
+
+				for(auto& kv : r)
+					if(kv.second != kv.first*3)
+						return false;
+
+				return r.size() == m.size();
+			})
+		),
+		std::make_tuple(
+			std::string("Exceptions propagate"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v(10000, 1);
+				v[7777] = 0;
+
+				try {
+					ftl::fmap(
+						ftl::par.with_grain(64),
+						[](int x){
+							if(x == 0)
+								throw std::invalid_argument("zero");
+							return x;
+						},
+						v
+					);
+				}
+				catch(std::invalid_argument&) {
+					return true;
+				}
+
+				return false;
+			})
+		),
+		std::make_tuple(
+			std::string("Nested parallel maps"),
+			std::function<bool()>([]() -> bool {
+				ftl::work_stealing_pool pool(2);
+				auto p = ftl::par.on(pool).with_grain(64);
+				std::vector<std::vector<int>> v(256, std::vector<int>(256, 1));
+
+				auto r = ftl::fmap(p, [p](const std::vector<int>& xs) {
+					auto ys = ftl::fmap(p, [](int x){ return x+1; }, xs);
+					int s = 0;
+					for(auto y : ys)
+						s += y;
+
+					return s;
+				}, v);
+
+				return r == std::vector<int>(256, 512);
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap[vector]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v(100000);
+				for(std::size_t i = 0; i < v.size(); ++i)
+					v[i] = int(i % 100);
+
+				auto r = ftl::foldMap(ftl::par, ftl::sum<int>, v);
+
+				return static_cast<int>(r)
+					== static_cast<int>(ftl::foldMap(ftl::sum<int>, v));
+			})
+		),
+		std::make_tuple(
+			std::string("fold preserves order"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::string> v;
+				std::string expected;
+				for(int i = 0; i < 3000; ++i) {
+					v.push_back(std::to_string(i % 10));
+					expected += v.back();
+				}
+
+				return ftl::fold(ftl::par.with_grain(64), v) == expected;
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap skips chunks once absorbed"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v(1 << 16, 1);
+				v[0] = 0;
+
+				std::atomic<int> calls{0};
+				auto f = [&calls](int x) -> ftl::all {
+					++calls;
+					return x != 0;
+				};
+
+				bool r = ftl::foldMap(ftl::par.with_grain(64), f, v);
+
+				return !r && calls < int(v.size()/2);
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap[list] and foldMap[map]"),
+			std::function<bool()>([]() -> bool {
+				std::list<int> l;
+				std::map<int,int> m;
+				for(int i = 0; i < 5000; ++i) {
+					l.push_back(i);
+					m[i] = i;
+				}
+
+				auto p = ftl::par.with_grain(64);
+				auto r1 = ftl::foldMap(p, [](int x){ return std::vector<int>{x}; }, l);
+				auto r2 = ftl::foldMap(p, ftl::prod<int>, m);
+
+				return r1 == std::vector<int>(l.begin(), l.end())
+					&& static_cast<int>(r2) == 0;
+			})
+		),
+		std::make_tuple(
+			std::string("fold[set]"),
+			std::function<bool()>([]() -> bool {
+				std::set<ftl::sum_monoid<int>> s;
+				for(int i = 0; i < 1000; ++i)
+					s.insert(ftl::sum(i));
+
+				return static_cast<int>(ftl::fold(ftl::par.with_grain(64), s))
+					== 999*1000/2;
+			})
+		),
+		std::make_tuple(
+			std::string("CommutativeMonoid"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				static_assert(CommutativeMonoid<sum_monoid<int>>{}, "");
+				static_assert(CommutativeMonoid<any>{}, "");
+				static_assert(CommutativeMonoid<std::set<int>>{}, "");
+				static_assert(CommutativeMonoid<maybe<prod_monoid<int>>>{}, "");
+				static_assert(
+					CommutativeMonoid<std::tuple<all,sum_monoid<int>>>{}, ""
+				);
+				static_assert(!CommutativeMonoid<std::string>{}, "");
+				static_assert(!CommutativeMonoid<std::vector<int>>{}, "");
+				static_assert(
+					!CommutativeMonoid<std::tuple<any,std::string>>{}, ""
+				);
+				static_assert(!CommutativeMonoid<int>{}, "");
+
+				return true;
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap[commutative] on executor"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(3);
+
+				std::vector<int> v(20000);
+				for(std::size_t i = 0; i < v.size(); ++i)
+					v[i] = int(i % 250);
+
+				auto r = ftl::foldMap(
+					ftl::par.on(pool).with_grain(64),
+					[](int x){ return std::set<int>{x}; },
+					v
+				);
+
+				return r.size() == 250 && *r.begin() == 0 && *r.rbegin() == 249;
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap[commutative] accumulates per task"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v(1 << 16, 1);
+
+				counted_ids = 0;
+				auto r = ftl::foldMap(
+					ftl::par.with_grain(64),
+					[](int x){ return counted_sum{x}; },
+					v
+				);
+
+				auto threads = std::max(std::thread::hardware_concurrency(), 1u);
+				return r.n == int(v.size())
+					&& counted_ids <= int(2 * threads);
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap[commutative] has a task per executor thread"),
+			std::function<bool()>([]() -> bool {
+				ftl::thread_pool pool(2);
+				std::vector<int> v(1 << 16, 1);
+
+				counted_ids = 0;
+				auto r = ftl::foldMap(
+					ftl::par.on(pool).with_grain(64),
+					[](int x){ return counted_sum{x}; },
+					v
+				);
+
+				return r.n == int(v.size()) && counted_ids <= 2 * 2;
+			})
+		),
+		std::make_tuple(
+			std::string("Sequential fmap unaffected"),
+			std::function<bool()>([]() -> bool {
+				auto f = ftl::fmap([](int x){ return x+1; });
+
+				return f(std::vector<int>{1,2}) == std::vector<int>{2,3};
+			})
+		),
+	}
+};
+
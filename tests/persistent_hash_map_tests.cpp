@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <ftl/persistent_hash_map.h>
+#include <ftl/string.h>
+#include "persistent_hash_map_tests.h"
+
+// Sends every key into one of a few buckets, to get collisions at every level
+struct persistent_hash_map_weak_hash {
+	std::size_t operator() (int k) const {
+		return static_cast<std::size_t>(k % 3);
+	}
+};
+
+test_set persistent_hash_map_tests{
+	std::string("persistent_hash_map"),
+	{
+		std::make_tuple(
+			std::string("set/erase[persistence]"),
+			std::function<bool()>([]() -> bool {
+				ftl::persistent_hash_map<int,int> m;
+				for(int i = 0; i < 2000; ++i) {
+					m = m.set(i, i * 2);
+				}
+
+				auto m2 = m.set(7, -1).erase(8);
+
+				return m.size() == 2000 && m.at(7) == 14 && m.count(8)
+					&& m2.size() == 1999 && m2.at(7) == -1 && !m2.count(8);
+			})
+		),
+		std::make_tuple(
+			std::string("insert[existing key]"),
+			std::function<bool()>([]() -> bool {
+				ftl::persistent_hash_map<int,std::string> m{{1, "a"}, {1, "b"}};
+
+				auto m2 = m.insert({1, "c"}).insert({2, "d"});
+
+				return m.size() == 1 && m.at(1) == "a"
+					&& m2.size() == 2 && m2.at(1) == "a" && m2.at(2) == "d";
+			})
+		),
+		std::make_tuple(
+			std::string("collisions"),
+			std::function<bool()>([]() -> bool {
+				ftl::persistent_hash_map<int,int,persistent_hash_map_weak_hash> m;
+				for(int i = 0; i < 300; ++i) {
+					m = m.set(i, i);
+				}
+
+				for(int i = 0; i < 300; i += 2) {
+					m = m.erase(i);
+				}
+
+				bool ok = m.size() == 150;
+				for(int i = 0; i < 300; ++i) {
+					ok = ok && m.count(i) == std::size_t(i % 2);
+				}
+
+				std::size_t n = 0;
+				for(auto& kv : m) {
+					ok = ok && kv.first == kv.second;
+					++n;
+				}
+
+				return ok && n == 150;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::persistent_hash_map<int,int> m{{1,1}, {2,2}, {3,3}};
+
+				auto m2 = [](int x){ return x == 2 ? 20 : x; } % m;
+				auto m3 = [](int x){ return std::to_string(x); } % m;
+
+				return m2 == ftl::persistent_hash_map<int,int>{{1,1},{2,20},{3,3}}
+					&& m3.at(3) == "3";
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl"),
+			std::function<bool()>([]() -> bool {
+				ftl::persistent_hash_map<std::string,int> m{
+					{"a", 1}, {"b", 2}, {"c", 3}
+				};
+
+				return ftl::foldl(
+					[](int z, int x){ return z + x; }, 0, m
+				) == 6;
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+				using map = ftl::persistent_hash_map<int,std::string>;
+
+				map m1{{1, "a"}, {2, "b"}};
+				map m2{{2, "c"}, {3, "d"}, {4, "e"}};
+
+				return (m1 ^ m2) == map{{1,"a"}, {2,"bc"}, {3,"d"}, {4,"e"}}
+					&& (m2 ^ m1).at(2) == "cb";
+			})
+		),
+		std::make_tuple(
+			std::string("lookup"),
+			std::function<bool()>([]() -> bool {
+				ftl::persistent_hash_map<int,int> m{{1, 10}};
+
+				auto found = ftl::lookup(1, m);
+				auto missing = ftl::lookup(2, m);
+
+				return found.is<const int&>()
+					&& &ftl::get<const int&>(found) == &m.at(1)
+					&& missing.is<ftl::Nothing>();
+			})
+		)
+	}
+};
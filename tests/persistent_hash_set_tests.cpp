@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <algorithm>
+#include <ftl/persistent_hash_set.h>
+#include "persistent_hash_set_tests.h"
+
+test_set persistent_hash_set_tests{
+	std::string("persistent_hash_set"),
+	{
+		std::make_tuple(
+			std::string("insert/erase[persistence]"),
+			std::function<bool()>([]() -> bool {
+				ftl::persistent_hash_set<int> s{1,2,3};
+
+				auto s2 = s.insert(4).insert(2).erase(1);
+
+				return s.size() == 3 && s.count(1) && !s.count(4)
+					&& s2 == ftl::persistent_hash_set<int>{2,3,4};
+			})
+		),
+		std::make_tuple(
+			std::string("iteration"),
+			std::function<bool()>([]() -> bool {
+				ftl::persistent_hash_set<int> s;
+				for(int i = 0; i < 5000; ++i) {
+					s = s.insert(i);
+				}
+
+				std::vector<bool> seen(5000, false);
+				std::size_t n = 0;
+				for(auto e : s) {
+					seen[e] = true;
+					++n;
+				}
+
+				return n == 5000
+					&& std::find(seen.begin(), seen.end(), false) == seen.end();
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldr"),
+			std::function<bool()>([]() -> bool {
+				ftl::persistent_hash_set<int> s{1,2,3,4};
+
+				return ftl::foldr(
+					[](int x, int z){ return x + z; }, 0, s
+				) == 10;
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+				using ftl::persistent_hash_set;
+
+				return (persistent_hash_set<int>{1,2} ^ persistent_hash_set<int>{2,3})
+					== persistent_hash_set<int>{1,2,3};
+			})
+		)
+	}
+};
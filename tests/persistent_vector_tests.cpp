@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <ftl/persistent_vector.h>
+#include <ftl/vector.h>
+#include "persistent_vector_tests.h"
+
+template<typename T>
+static bool same(const ftl::persistent_vector<T>& p, const std::vector<T>& v) {
+	if(p.size() != v.size())
+		return false;
+
+	for(std::size_t i = 0; i < v.size(); ++i) {
+		if(p[i] != v[i])
+			return false;
+	}
+
+	return std::equal(v.begin(), v.end(), p.begin())
+		&& std::equal(v.rbegin(), v.rend(), p.rbegin());
+}
+
+test_set persistent_vector_tests{
+	std::string("persistent_vector"),
+	{
+		std::make_tuple(
+			std::string("push_back/set[persistence]"),
+			std::function<bool()>([]() -> bool {
+				ftl::persistent_vector<int> p;
+				std::vector<int> v;
+				for(int i = 0; i < 5000; ++i) {
+					p = p.push_back(i);
+					v.push_back(i);
+				}
+
+				auto p2 = p.set(1234, -1).set(4999, -2);
+				auto v2 = v;
+				v2[1234] = -1;
+				v2[4999] = -2;
+
+				return same(p, v) && same(p2, v2);
+			})
+		),
+		std::make_tuple(
+			std::string("construction[range]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v;
+				for(int i = 0; i < 33000; ++i) {
+					v.push_back(i * 3);
+				}
+
+				ftl::persistent_vector<int> p(v.begin(), v.end());
+
+				return same(p, v) && p.at(32999) == 98997;
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append[uneven]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+
+				ftl::persistent_vector<int> p;
+				std::vector<int> v;
+				int n = 0;
+				for(int i = 0; i < 300; ++i) {
+					std::vector<int> part;
+					for(int j = 0; j < (i * 37) % 101; ++j) {
+						part.push_back(n++);
+					}
+
+					ftl::persistent_vector<int> q(part.begin(), part.end());
+					if(i % 2)
+						p = p ^ q;
+					else
+						p = q ^ p;
+
+					v.insert(i % 2 ? v.end() : v.begin(), part.begin(), part.end());
+				}
+
+				return same(p, v);
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append[then set/push]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+
+				std::vector<int> v1(1000, 1), v2(77, 2);
+				ftl::persistent_vector<int> p1(v1.begin(), v1.end());
+				ftl::persistent_vector<int> p2(v2.begin(), v2.end());
+
+				auto p = (p2 ^ p1 ^ p2).set(1076, 3).push_back(4);
+
+				std::vector<int> v = v2;
+				v.insert(v.end(), v1.begin(), v1.end());
+				v.insert(v.end(), v2.begin(), v2.end());
+				v[1076] = 3;
+				v.push_back(4);
+
+				return same(p, v) && same(p1, v1);
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator^;
+
+				ftl::persistent_vector<int> p{1,2,3};
+				for(int i = 0; i < 6; ++i) {
+					p = p ^ p;
+				}
+
+				auto q = [](int x){ return x * 0.5; } % p;
+
+				return q.size() == 192 && q[0] == 0.5 && q[191] == 1.5;
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+				using ftl::persistent_vector;
+
+				auto p = persistent_vector<int>{1,2,3} >>= [](int x) {
+					return persistent_vector<int>{x, -x};
+				};
+
+				return p == persistent_vector<int>{1,-1,2,-2,3,-3};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable/zippable"),
+			std::function<bool()>([]() -> bool {
+				ftl::persistent_vector<int> p{1,2,3,4};
+
+				auto z = ftl::zipWith(
+					[](int x, int y){ return x * y; },
+					p, std::vector<int>{10,20,30}
+				);
+
+				auto r = ftl::foldr(
+					[](int x, int z){ return z * 10 + x; }, 0, p
+				);
+
+				return z == ftl::persistent_vector<int>{10,40,90} && r == 4321;
+			})
+		)
+	}
+};
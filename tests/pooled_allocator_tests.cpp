@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <array>
+#include <cstdint>
+#include <list>
+#include <thread>
+#include <vector>
+#include <ftl/pooled_allocator.h>
+#include <ftl/function.h>
+#include <ftl/lazy.h>
+#include "pooled_allocator_tests.h"
+
+namespace {
+	// Runs f on a thread of its own, so it starts with empty free lists
+	template<typename F>
+	bool on_fresh_thread(F f) {
+		bool r = false;
+		std::thread t([&r,&f](){ r = f(); });
+		t.join();
+
+		return r;
+	}
+}
+
+test_set pooled_allocator_tests{
+	std::string("pooled_allocator"),
+	{
+		std::make_tuple(
+			std::string("pooled_allocate[reuses freed blocks]"),
+			std::function<bool()>([]() -> bool {
+				void* p = ftl::pooled_allocate(40);
+				ftl::pooled_deallocate(p, 40);
+				void* q = ftl::pooled_allocate(40);
+				ftl::pooled_deallocate(q, 40);
+
+				return p == q;
+			})
+		),
+		std::make_tuple(
+			std::string("pooled_allocate[size classes]"),
+			std::function<bool()>([]() -> bool {
+				void* p = ftl::pooled_allocate(17);
+				ftl::pooled_deallocate(p, 17);
+				void* q = ftl::pooled_allocate(32);
+				void* r = ftl::pooled_allocate(33);
+
+				bool same_class = p == q;
+				bool other_class = r != q;
+
+				ftl::pooled_deallocate(q, 32);
+				ftl::pooled_deallocate(r, 33);
+
+				return same_class && other_class;
+			})
+		),
+		std::make_tuple(
+			std::string("pooled_allocate[aligned]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<void*> ps;
+				bool aligned = true;
+				for(std::size_t n = 1; n <= 256; n += 7) {
+					void* p = ftl::pooled_allocate(n);
+					aligned = aligned && reinterpret_cast<std::uintptr_t>(p)
+						% alignof(std::max_align_t) == 0;
+					ps.push_back(p);
+				}
+
+				std::size_t n = 1;
+				for(auto p : ps) {
+					ftl::pooled_deallocate(p, n);
+					n += 7;
+				}
+
+				return aligned;
+			})
+		),
+		std::make_tuple(
+			std::string("pooled_allocate[large blocks bypass the pool]"),
+			std::function<bool()>([]() -> bool {
+				return on_fresh_thread([]() -> bool {
+					void* p = ftl::pooled_allocate(1000);
+					auto s = ftl::pool_statistics();
+					ftl::pooled_deallocate(p, 1000);
+
+					return p != nullptr && s.allocations == 0
+						&& ftl::pool_statistics().cached_blocks == 0;
+				});
+			})
+		),
+		std::make_tuple(
+			std::string("pool_statistics[hits and refills]"),
+			std::function<bool()>([]() -> bool {
+				return on_fresh_thread([]() -> bool {
+					void* p = ftl::pooled_allocate(64);
+					auto s1 = ftl::pool_statistics();
+					void* q = ftl::pooled_allocate(64);
+					auto s2 = ftl::pool_statistics();
+
+					ftl::pooled_deallocate(p, 64);
+					ftl::pooled_deallocate(q, 64);
+					auto s3 = ftl::pool_statistics();
+
+					// The batch may be short if it came from blocks returned
+					// by other threads
+					return s1.allocations == 1 && s1.refills == 1
+						&& s1.cache_hits == 0
+						&& s1.cached_blocks < ftl::_dtl::pool_batch
+						&& s2.allocations == 2 && s2.cache_hits + s2.refills == 2
+						&& s3.cached_blocks == s2.cached_blocks + 2
+						&& s3.reserved_bytes > 0;
+				});
+			})
+		),
+		std::make_tuple(
+			std::string("pooled_deallocate[on another thread]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<void*> ps;
+				std::thread producer([&ps](){
+					for(int i = 0; i < 500; ++i)
+						ps.push_back(ftl::pooled_allocate(48));
+				});
+				producer.join();
+
+				return on_fresh_thread([&ps]() -> bool {
+					for(auto p : ps)
+						ftl::pooled_deallocate(p, 48);
+
+					auto s = ftl::pool_statistics();
+
+					// Long lists are cut back to a batch on the way
+					return s.spills > 0
+						&& s.cached_blocks <= ftl::_dtl::pool_cache_limit;
+				});
+			})
+		),
+		std::make_tuple(
+			std::string("pooled_allocator[std::list]"),
+			std::function<bool()>([]() -> bool {
+				std::list<int, ftl::pooled_allocator<int>> xs;
+				for(int i = 0; i < 100; ++i)
+					xs.push_back(i);
+
+				auto ys = xs;
+				ys.remove_if([](int x){ return x % 2 == 0; });
+
+				int sum = 0;
+				for(int y : ys)
+					sum += y;
+
+				return xs.size() == 100 && ys.size() == 50 && sum == 2500;
+			})
+		),
+		std::make_tuple(
+			std::string("pooled_allocator[equality]"),
+			std::function<bool()>([]() -> bool {
+				ftl::pooled_allocator<int> a;
+				ftl::pooled_allocator<double> b(a);
+
+				return a == b && !(a != b);
+			})
+		),
+		std::make_tuple(
+			std::string("function[heap storage is pooled]"),
+			std::function<bool()>([]() -> bool {
+				return on_fresh_thread([]() -> bool {
+					std::array<int,16> xs{{1, 2, 3}};
+					ftl::function<int(int)> f = [xs](int i){ return xs[i]; };
+					auto s1 = ftl::pool_statistics();
+
+					auto g = f;
+					auto s2 = ftl::pool_statistics();
+
+					return f(1) == 2 && g(2) == 3
+						&& s1.allocations == 1 && s2.allocations == 2;
+				});
+			})
+		),
+		std::make_tuple(
+			std::string("function[inline storage is not pooled]"),
+			std::function<bool()>([]() -> bool {
+				return on_fresh_thread([]() -> bool {
+					int x = 2;
+					ftl::function<int(int)> f = [x](int y){ return x*y; };
+					auto g = f;
+
+					return g(3) == 6 && ftl::pool_statistics().allocations == 0;
+				});
+			})
+		),
+		std::make_tuple(
+			std::string("pooled_resource[lazy]"),
+			std::function<bool()>([]() -> bool {
+				ftl::resource_allocator<int> alloc(ftl::pooled_resource());
+				ftl::lazy<int> l(std::allocator_arg, alloc, [](){ return 12; });
+
+				auto l2 = [](int x){ return x*2; } % l;
+
+				return *l2 == 24
+					&& ftl::pooled_resource()->is_equal(*ftl::pooled_resource());
+			})
+		)
+	}
+};
+
@@ -39,6 +39,32 @@ struct _curry5 : public ftl::make_curried_n<5,_curry5> {
     using ftl::make_curried_n<5,_curry5>::operator();
 } curry5;
 
+// Counts the times it is copied
+struct copy_counter {
+	explicit copy_counter(int* c) : copies(c) {}
+	copy_counter(const copy_counter& c) : copies(c.copies) { ++*copies; }
+	copy_counter(copy_counter&&) = default;
+
+	int* copies;
+};
+
+constexpr int minus(int x, int y) {
+	return x - y;
+}
+
+constexpr int twice(int x) {
+	return 2*x;
+}
+
+#ifdef FTL_CPP14
+static_assert(ftl::const_(1)(2) == 1, "Partial application is constexpr");
+static_assert(
+	ftl::compose(twice, twice, minus)(5, 2) == 12,
+	"Composition is constexpr"
+);
+static_assert(ftl::flip(minus)(1, 4) == 3, "Flipping is constexpr");
+#endif
+
 test_set prelude_tests{
 	std::string("prelude"),
 	{
@@ -215,6 +241,18 @@ test_set prelude_tests{
 					&& curry5(1,2,3,4,5)    == curry5(1)(2)(3)(4)(5);
 			})
 		),
+		std::make_tuple(
+			std::string("currying moves bound arguments"),
+			std::function<bool()>([]() -> bool {
+				auto f = [](const copy_counter&, int x, int y){ return x+y; };
+				int copies = 0;
+
+				auto x = ftl::curry<3>(f)(copy_counter(&copies))(1)(2);
+				auto y = ftl::curry(f)(copy_counter(&copies))(1)(2);
+
+				return x == 3 && y == 3 && copies == 0;
+			})
+		),
 		std::make_tuple(
 			std::string("compose[...,R(*)(Ps...)]"),
 			std::function<bool()>([]() -> bool {
@@ -243,6 +281,41 @@ test_set prelude_tests{
 
 				return g(2,4) == 2;
 			})
+		),
+		std::make_tuple(
+			std::string("compose[concrete closure]"),
+			std::function<bool()>([]() -> bool {
+				auto f = [](int x){ return 2*x; };
+				auto g = [](int x){ return x+1; };
+				auto h = ftl::compose(f, g, curry_me);
+
+				static_assert(
+					!std::is_same<decltype(h), ftl::function<int(int,int)>>::value,
+					"Composition does not type erase"
+				);
+
+				ftl::function<int(int,int)> e = h;
+
+				return h(1,2) == 8 && h(1)(2) == 8 && e(1,2) == 8;
+			})
+		),
+		std::make_tuple(
+			std::string("flip[lambda]"),
+			std::function<bool()>([]() -> bool {
+				auto f = ftl::flip([](int x, int y){ return x - y; });
+
+				return f(1,4) == 3 && f(1)(4) == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("flip[curried function]"),
+			std::function<bool()>([]() -> bool {
+				ftl::function<ftl::function<int(int)>(int)> f =
+					[](int x){ return ftl::function<int(int)>([x](int y){ return x - y; }); };
+				auto g = ftl::flip(f);
+
+				return g(1)(4) == 3 && g(1,4) == 3;
+			})
 		)
 	}
 };
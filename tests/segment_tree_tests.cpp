@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <ftl/segment_tree.h>
+#include <ftl/string.h>
+#include "segment_tree_tests.h"
+
+namespace {
+	// Measures elements by whether they are even
+	struct even {
+		ftl::sum_monoid<int> operator() (int x) const {
+			return ftl::sum(x % 2 == 0 ? 1 : 0);
+		}
+	};
+
+	std::string concat(const std::vector<std::string>& v,
+			std::size_t first, std::size_t last) {
+		std::string s;
+		for(auto i = first; i < last; ++i)
+			s += v[i];
+
+		return s;
+	}
+}
+
+test_set segment_tree_tests{
+	std::string("segment_tree"),
+	{
+		std::make_tuple(
+			std::string("total"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				segment_tree<int,sum_monoid<int>> t1{1, 2, 3, 4, 5};
+				segment_tree<int,sum_monoid<int>> t2;
+
+				return t1.total() == 15 && t1.size() == 5
+					&& t2.total() == 0 && t2.empty();
+			})
+		),
+		std::make_tuple(
+			std::string("update"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				segment_tree<int,sum_monoid<int>> t{1, 2, 3, 4, 5};
+
+				t.update(0, 10);
+				t.modify(4, [](int& x){ x *= 2; });
+
+				return t.total() == 29 && t[0] == 10 && t[4] == 10;
+			})
+		),
+		std::make_tuple(
+			std::string("fold[range] preserves order"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::string> v;
+				for(int i = 0; i < 13; ++i)
+					v.push_back(std::to_string(i));
+
+				ftl::segment_tree<std::string> t(v);
+				t.update(6, "x");
+				v[6] = "x";
+
+				for(std::size_t first = 0; first <= v.size(); ++first) {
+					for(auto last = first; last <= v.size(); ++last) {
+						if(t.fold(first, last) != concat(v, first, last))
+							return false;
+					}
+				}
+
+				return t.total() == concat(v, 0, v.size());
+			})
+		),
+		std::make_tuple(
+			std::string("push_back/pop_back"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				segment_tree<int,sum_monoid<int>> t;
+				for(int i = 1; i <= 100; ++i) {
+					t.push_back(i);
+					if(t.total() != i*(i+1)/2 || t.fold(0, i) != i*(i+1)/2)
+						return false;
+				}
+
+				for(int i = 0; i < 50; ++i)
+					t.pop_back();
+
+				return t.size() == 50 && t.total() == 50*51/2
+					&& t.fold(10, 50) == 50*51/2 - 10*11/2;
+			})
+		),
+		std::make_tuple(
+			std::string("Custom measure"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				segment_tree<int,sum_monoid<int>,even> t{1, 2, 3, 4, 6, 7};
+				t.update(0, 8);
+
+				return t.total() == 4 && t.fold(2, 6) == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl/foldr"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				segment_tree<int,sum_monoid<int>> t{1, 2, 3};
+				auto sub = [](int x, int y){ return x - y; };
+
+				return foldl(sub, 0, t) == -6 && foldr(sub, 0, t) == 2
+					&& foldMap(sum<int>, t) == 6;
+			})
+		)
+	}
+};
+
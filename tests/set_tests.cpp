@@ -20,9 +20,23 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <vector>
 #include <ftl/set.h>
+#include <ftl/maybe.h>
 #include "set_tests.h"
 
+namespace {
+	// Ordered by key alone, so that results with equal keys collide
+	struct keyed {
+		int key;
+		int value;
+
+		bool operator< (const keyed& k) const noexcept {
+			return key < k.key;
+		}
+	};
+}
+
 test_set set_tests{
 	std::string("set"),
 	{
@@ -71,6 +85,36 @@ test_set set_tests{
 				return s == std::set<int>{2,3,4};
 			})
 		),
+		std::make_tuple(
+			std::string("functor::map[reordering, colliding]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto f = [](int x){ return (x * x) % 5; };
+				auto s = f % std::set<int>{0,1,2,3,4,5,6};
+
+				return s == std::set<int>{0,1,4};
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[colliding, keeps first]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::set<int> s;
+				for(int i = 0; i < 100; ++i)
+					s.insert(i);
+
+				auto f = [](int x){ return keyed{(99 - x) % 3, x}; };
+				auto r = f % s;
+
+				std::vector<int> firsts;
+				for(auto& k : r)
+					firsts.push_back(k.value);
+
+				return firsts == std::vector<int>{0,2,1};
+			})
+		),
 		std::make_tuple(
 			std::string("applicative::pure"),
 			std::function<bool()>([]() -> bool {
@@ -138,7 +182,91 @@ test_set set_tests{
 
 				return fold(l) == 24;
 			})
+		),
+		std::make_tuple(
+			std::string("monoid::mconcat"),
+			std::function<bool()>([]() -> bool {
+				using set = std::set<int>;
+
+				std::vector<set> v{set{1,2}, set{}, set{2,3,4,5}, set{0}};
+
+				auto s1 = ftl::monoid<set>::mconcat(v);
+				auto s2 = ftl::mconcat(std::move(v));
+
+				return s1 == set{0,1,2,3,4,5} && s2 == s1;
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append[merging]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+
+				std::set<int> evens, odds;
+				for(int i = 0; i < 100; i += 2) {
+					evens.insert(i);
+					odds.insert(i+1);
+				}
+
+				auto p = &*evens.find(50);
+
+				auto r1 = evens ^ odds;
+				auto r2 = std::move(evens) ^ std::set<int>{1, 2, 99};
+
+				return r1.size() == 100 && r1.count(7) && r1.count(98)
+					&& r2.size() == 52 && r2.count(99) && &*r2.find(50) == p;
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind[k-way merge]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				std::set<int> s{1, 2, 3, 4, 5, 6, 7, 8};
+
+				auto r = s >>= [](int x) {
+					return std::set<int>{x, x*10, x*100};
+				};
+
+				std::set<int> expected;
+				for(int x : s) {
+					expected.insert(x);
+					expected.insert(x*10);
+					expected.insert(x*100);
+				}
+
+				return r == expected
+					&& ftl::mconcat(std::vector<std::set<int>>{
+						{5, 1}, {}, {3, 1}, {2, 4, 5}
+					}) == std::set<int>{1, 2, 3, 4, 5};
+			})
+		),
+		std::make_tuple(
+			std::string("liftA"),
+			std::function<bool()>([]() -> bool {
+				std::set<int> s1{1, 2, 3}, s2{10, 20};
+				auto add = [](int x, int y){ return x + y; };
+				auto mod = [](int x, int y){ return (x + y) % 2; };
+
+				return ftl::liftA(add, s1, s2)
+						== std::set<int>{11, 12, 13, 21, 22, 23}
+					&& ftl::liftA(mod, s1, s2) == std::set<int>{0, 1};
+			})
+		),
+		std::make_tuple(
+			std::string("filter and mapMaybe"),
+			std::function<bool()>([]() -> bool {
+				auto odd = [](int x){ return x % 2 != 0; };
+				auto neg = [](int x){
+					return x > 2 ? ftl::just(-x) : ftl::nothing<int>();
+				};
+
+				std::set<int> s{1, 2, 3, 4, 5};
+
+				return ftl::filter(odd, s) == std::set<int>{1, 3, 5}
+					&& ftl::mapMaybe(neg, s) == std::set<int>{-5, -4, -3}
+					&& ftl::filter(odd, std::move(s)) == std::set<int>{1, 3, 5};
+			})
 		)
+
 	}
 };
-
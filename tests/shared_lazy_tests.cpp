@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ftl/shared_lazy.h>
+#include "deferred_executor.h"
+#include "shared_lazy_tests.h"
+
+test_set shared_lazy_tests{
+	std::string("shared_lazy"),
+	{
+		std::make_tuple(
+			std::string("operator->"),
+			std::function<bool()>([]() -> bool {
+
+				ftl::shared_lazy<std::string> l1{[](){ return std::string("blah"); }};
+
+				return l1->size() == 4 && l1->at(0) == 'b';
+			})
+		),
+		std::make_tuple(
+			std::string("Concurrent forcing computes once only"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> calls{0};
+				ftl::shared_lazy<int> l{[&calls]() {
+					++calls;
+					std::this_thread::sleep_for(std::chrono::milliseconds(5));
+					return 42;
+				}};
+
+				std::vector<std::thread> threads;
+				std::vector<int> results(8, 0);
+				for(std::size_t i = 0; i < results.size(); ++i) {
+					threads.emplace_back([l,&results,i]() {
+						results[i] = *l;
+					});
+				}
+
+				for(auto& t : threads)
+					t.join();
+
+				for(auto r : results)
+					if(r != 42)
+						return false;
+
+				return calls == 1 && l.status() == ftl::value_status::ready;
+			})
+		),
+		std::make_tuple(
+			std::string("Failed computation is retried"),
+			std::function<bool()>([]() -> bool {
+				int calls = 0;
+				ftl::shared_lazy<int> l{[&calls]() {
+					if(calls++ == 0)
+						throw 0;
+
+					return 1;
+				}};
+
+				try {
+					static_cast<void>(*l);
+					return false;
+				}
+				catch(int) {}
+
+				return l.status() == ftl::value_status::deferred
+					&& *l == 1 && calls == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("From lazy"),
+			std::function<bool()>([]() -> bool {
+				auto l1 = ftl::defer([](int x){ return x+1; }, 1);
+				ftl::shared_lazy<int> l2{l1};
+
+				return l2.status() == ftl::value_status::deferred
+					&& *l2 == 2 && l1.status() == ftl::value_status::ready;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::shared_lazy<int> l1{[](){ return 1; }};
+				auto l2 = [](int x){ return x+1; } % l1;
+
+				return l2.status() == ftl::value_status::deferred
+					&& l1.status() == ftl::value_status::deferred
+					&& *l2 == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("applicative::apply"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				function<int(int,int)> fn = [](int x, int y){ return x+y; };
+
+				auto l = fn
+					% applicative<shared_lazy<int>>::pure(1)
+					* applicative<shared_lazy<int>>::pure(2);
+
+				return *l == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto f = [](int x){
+					return shared_lazy<float>{[x](){ return float(x)/2.f; }};
+				};
+				auto l1 = applicative<shared_lazy<int>>::pure(1);
+				auto l2 = l1 >>= f;
+
+				return *l2 == .5f;
+			})
+		),
+		std::make_tuple(
+			std::string("spark[computes in the background]"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> calls{0};
+				ftl::thread_pool pool(2);
+
+				auto l = ftl::spark(ftl::shared_lazy<int>{[&calls]() {
+					++calls;
+					return 42;
+				}}, pool);
+
+				auto ready = [&l](){
+					return l.status() == ftl::value_status::ready;
+				};
+
+				for(int i = 0; i < 1000 && !ready(); ++i)
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+				return ready() && calls == 1 && *l == 42;
+			})
+		),
+		std::make_tuple(
+			std::string("spark[forcing waits for the spark]"),
+			std::function<bool()>([]() -> bool {
+				std::atomic<int> calls{0};
+				std::atomic<bool> started{false};
+				ftl::thread_pool pool(1);
+
+				auto l = ftl::spark(ftl::shared_lazy<int>{[&]() {
+					started = true;
+					++calls;
+					std::this_thread::sleep_for(std::chrono::milliseconds(10));
+					return 7;
+				}}, pool);
+
+				while(!started)
+					std::this_thread::yield();
+
+				return *l == 7 && calls == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("spark[forcing first takes over]"),
+			std::function<bool()>([]() -> bool {
+				int calls = 0;
+				deferred_executor ex;
+
+				auto l = ftl::spark(ftl::shared_lazy<int>{[&calls]() {
+					++calls;
+					return 3;
+				}}, ex);
+
+				bool queued = ex.tasks.size() == 1;
+				int v = *l;
+				ex.run_all();
+
+				// Already computed values are not sparked at all
+				ftl::spark(l, ex);
+
+				return queued && v == 3 && calls == 1 && ex.tasks.empty();
+			})
+		),
+		std::make_tuple(
+			std::string("spark[failure is retried on force]"),
+			std::function<bool()>([]() -> bool {
+				int calls = 0;
+				deferred_executor ex;
+
+				auto l = ftl::spark(ftl::shared_lazy<int>{[&calls]() {
+					if(calls++ == 0)
+						throw 0;
+
+					return 1;
+				}}, ex);
+
+				ex.run_all();
+				bool deferred = l.status() == ftl::value_status::deferred;
+
+				return deferred && *l == 1 && calls == 2;
+			})
+		)
+
+	}
+};
+
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ftl/small_vector.h>
+#include "small_vector_tests.h"
+
+test_set small_vector_tests{
+	std::string("small_vector"),
+	{
+		std::make_tuple(
+			std::string("Inline until full"),
+			std::function<bool()>([]() -> bool {
+				ftl::small_vector<std::string,2> v;
+				v.push_back("a");
+				v.emplace_back("b");
+				bool inl = v.is_inline() && v.capacity() == 2;
+
+				// Refers to an element that moves as the vector grows
+				v.push_back(v[0]);
+
+				return inl && !v.is_inline() && v.size() == 3
+					&& v[0] == "a" && v[1] == "b" && v[2] == "a";
+			})
+		),
+		std::make_tuple(
+			std::string("Copy and move"),
+			std::function<bool()>([]() -> bool {
+				ftl::small_vector<std::string,2> a{"x"}, b{"x", "y", "z"};
+
+				auto c = a;
+				auto d = std::move(a);
+				auto e = b;
+				auto p = b.data();
+				auto f = std::move(b);
+
+				return c == d && d.size() == 1 && a.empty()
+					&& e == f && f.data() == p && b.empty() && b.is_inline();
+			})
+		),
+		std::make_tuple(
+			std::string("insert, erase and resize"),
+			std::function<bool()>([]() -> bool {
+				ftl::small_vector<int,4> v{1, 5};
+				std::list<int> l{2, 3, 4};
+
+				v.insert(v.begin() + 1, l.begin(), l.end());
+				bool ins = v == ftl::small_vector<int,4>{1, 2, 3, 4, 5};
+
+				v.erase(v.begin(), v.begin() + 2);
+				v.insert(v.end(), 6);
+				v.resize(6, 0);
+
+				return ins && v == ftl::small_vector<int,4>{3, 4, 5, 6, 0, 0};
+			})
+		),
+		std::make_tuple(
+			std::string("Elements are destroyed"),
+			std::function<bool()>([]() -> bool {
+				auto p = std::make_shared<int>(0);
+				{
+					ftl::small_vector<std::shared_ptr<int>,2> v(3, p);
+					auto w = v;
+					w.pop_back();
+					v = w;
+				}
+
+				return p.use_count() == 1;
+			})
+		),
+		std::make_tuple(
+			std::string("Functor and applicative"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using sv = small_vector<int,4>;
+
+				auto plus = [](int x, int y){ return x + y; };
+				auto s = [](int x){ return std::to_string(x); };
+
+				sv v{1, 2};
+				auto strs = s % v;
+				auto sums = curry(plus) % v * sv{10, 20};
+				auto inplace = [](int x){ return x * 3; } % sv{1, 2, 3, 4, 5};
+
+				return strs == small_vector<std::string,4>{"1", "2"}
+					&& sums == sv{11, 21, 12, 22}
+					&& inplace == sv{3, 6, 9, 12, 15}
+					&& monad<sv>::pure(7) == sv{7};
+			})
+		),
+		std::make_tuple(
+			std::string("Monad"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using sv = small_vector<int,2>;
+
+				auto twice = [](int x){ return sv{x, x}; };
+				auto upto = [](int x){ return std::vector<int>(x, x); };
+				sv nested[] = {sv{1}, sv{2, 3, 4}};
+
+				auto b = sv{1, 2} >>= twice;
+				auto c = sv{1, 2, 3} >>= upto;
+				auto j = monad<sv>::join(small_vector<sv,2>{nested[0], nested[1]});
+
+				return b == sv{1, 1, 2, 2}
+					&& c == sv{1, 2, 2, 3, 3, 3}
+					&& j == sv{1, 2, 3, 4}
+					&& concatMap(twice, sv{5}) == sv{5, 5};
+			})
+		),
+		std::make_tuple(
+			std::string("Foldable and monoid"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using sv = small_vector<int,4>;
+
+				sv a{1, 2, 3}, b{4, 5};
+				std::vector<sv> vs{a, b, sv{}};
+
+				auto total = foldMap(sum<int>, a ^ b);
+				auto t = foldr(std::minus<int>(), 0, a);
+				auto all = mconcat(vs);
+				auto moved = sv{9} ^ std::move(b);
+
+				return total == 15
+					&& t == 2
+					&& all == sv{1, 2, 3, 4, 5}
+					&& moved == sv{9, 4, 5};
+			})
+		),
+		std::make_tuple(
+			std::string("Zippable"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				small_vector<int,4> v{1, 2, 3};
+				std::list<int> l{10, 20, 30, 40};
+
+				auto z = zipWith(std::plus<int>(), v, l);
+
+				return z == small_vector<int,4>{11, 22, 33};
+			})
+		)
+
+	}
+};
+
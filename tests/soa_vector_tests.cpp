@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <list>
+#include <string>
+#include <vector>
+#include <ftl/soa_vector.h>
+#include "soa_vector_tests.h"
+
+test_set soa_vector_tests{
+	std::string("soa_vector"),
+	{
+		std::make_tuple(
+			std::string("push_back and rows"),
+			std::function<bool()>([]() -> bool {
+				ftl::soa_vector<int,std::string,float> v;
+				v.push_back(std::make_tuple(1, std::string("one"), 1.5f));
+				v.emplace_back(2, "two", 2.5f);
+
+				auto r = v[1];
+
+				return v.size() == 2
+					&& std::get<0>(r) == 2
+					&& std::get<1>(r) == "two"
+					&& &std::get<2>(r) == &v.column<2>()[1]
+					&& ftl::column<1>(v) == std::vector<std::string>{"one","two"};
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				ftl::soa_vector<int,std::string> v{
+					std::make_tuple(1, std::string("a")),
+					std::make_tuple(2, std::string("b"))
+				};
+
+				auto w = [](int x){ return x * .5f; } % v;
+
+				return w == ftl::soa_vector<float,std::string>{
+					std::make_tuple(.5f, std::string("a")),
+					std::make_tuple(1.f, std::string("b"))
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("mapColumn"),
+			std::function<bool()>([]() -> bool {
+				ftl::soa_vector<int,std::string> v{
+					std::make_tuple(1, std::string("a")),
+					std::make_tuple(2, std::string("bcd"))
+				};
+
+				auto w = ftl::mapColumn<1>(
+					[](const std::string& s){ return s.size(); }, v
+				);
+
+				auto u = ftl::mapColumn<1>(
+					[](std::string s){ return s + "!"; }, std::move(v)
+				);
+
+				return ftl::column<1>(w) == std::vector<size_t>{1,3}
+					&& ftl::column<0>(w) == std::vector<int>{1,2}
+					&& ftl::column<1>(u) == std::vector<std::string>{"a!","bcd!"};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl"),
+			std::function<bool()>([]() -> bool {
+				ftl::soa_vector<int,std::string> v;
+				for(int i = 1; i <= 100; ++i) {
+					v.emplace_back(i, std::to_string(i));
+				}
+
+				auto s = ftl::foldl([](int z, int x){ return z + x; }, 0, v);
+				auto m = ftl::foldMap(ftl::sum<int>, v);
+
+				return s == 5050 && static_cast<int>(m) == 5050;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldr"),
+			std::function<bool()>([]() -> bool {
+				ftl::soa_vector<std::string,int> v{
+					std::make_tuple(std::string("a"), 1),
+					std::make_tuple(std::string("b"), 2),
+					std::make_tuple(std::string("c"), 3)
+				};
+
+				auto r = ftl::foldr(
+					[](const std::string& x, std::string z){ return z + x; },
+					std::string(), v
+				);
+
+				return r == "cba";
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith"),
+			std::function<bool()>([]() -> bool {
+				ftl::soa_vector<int,char> v{
+					std::make_tuple(1, 'a'),
+					std::make_tuple(2, 'b'),
+					std::make_tuple(3, 'c')
+				};
+				std::list<int> l{10,20};
+
+				auto w = ftl::zipWith(
+					[](int x, int y){ return x * y; }, v, l
+				);
+
+				return w == ftl::soa_vector<int,char>{
+					std::make_tuple(10, 'a'),
+					std::make_tuple(40, 'b')
+				};
+			})
+		)
+	}
+};
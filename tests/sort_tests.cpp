@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <list>
+#include <string>
+#include <vector>
+#include <ftl/sort.h>
+#include "sort_tests.h"
+
+test_set sort_tests{
+	std::string("sort"),
+	{
+		std::make_tuple(
+			std::string("sortOn[keys computed once]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::string> v{"ccc", "a", "dd", "bb", "eee"};
+
+				int calls = 0;
+				ftl::sortOn(v.begin(), v.end(), [&calls](const std::string& s) {
+					++calls;
+					return s.size();
+				});
+
+				return calls == 5
+					&& v == std::vector<std::string>{"a","dd","bb","ccc","eee"};
+			})
+		),
+		std::make_tuple(
+			std::string("sortOn[integral radix]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::pair<int,int>> v;
+				for(int i = 0; i < 5000; ++i) {
+					v.emplace_back((i * 7919) % 1001 - 500, i);
+				}
+
+				auto w = v;
+				ftl::sortOn(v.begin(), v.end(), [](const std::pair<int,int>& p) {
+					return p.first;
+				});
+
+				std::stable_sort(w.begin(), w.end(),
+					[](const std::pair<int,int>& a, const std::pair<int,int>& b) {
+						return a.first < b.first;
+					}
+				);
+
+				return v == w;
+			})
+		),
+		std::make_tuple(
+			std::string("sortOn[string radix]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::string> v;
+				for(int i = 0; i < 3000; ++i) {
+					std::string s;
+					for(int j = 0; j < (i * 31) % 7; ++j) {
+						s += char('a' + (i * j + j) % 3);
+					}
+
+					v.push_back(s);
+				}
+
+				auto w = v;
+				ftl::sortOn(v.begin(), v.end(), [](const std::string& s) {
+					return s;
+				});
+
+				std::sort(w.begin(), w.end());
+
+				return v == w;
+			})
+		),
+		std::make_tuple(
+			std::string("sortOn[other keys]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v;
+				for(int i = 0; i < 200; ++i) {
+					v.push_back((i * 37) % 101);
+				}
+
+				ftl::sortOn(v.begin(), v.end(), [](int x){ return -x * 0.5; });
+
+				return std::is_sorted(v.rbegin(), v.rend());
+			})
+		),
+		std::make_tuple(
+			std::string("sortOn[container]"),
+			std::function<bool()>([]() -> bool {
+				auto l = ftl::sortOn(
+					[](int x){ return -x; }, std::list<int>{2,3,1}
+				);
+
+				return l == std::list<int>{3,2,1};
+			})
+		)
+	}
+};
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <vector>
+#include <ftl/stream.h>
+#include <ftl/view.h>
+#include <ftl/vector.h>
+#include "stream_tests.h"
+
+namespace {
+	ftl::stream<int> naturals() {
+		return ftl::iterate([](int x){ return x+1; }, 0);
+	}
+
+	std::vector<int> to_vector(const ftl::stream<int>& s) {
+		return std::vector<int>(s.begin(), s.end());
+	}
+}
+
+test_set stream_tests{
+	std::string("stream"),
+	{
+		std::make_tuple(
+			std::string("take[iterate]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto s = take(5, naturals());
+				auto e = take(0, naturals());
+
+				return to_vector(s) == std::vector<int>{0,1,2,3,4}
+					&& e.empty();
+			})
+		),
+		std::make_tuple(
+			std::string("Tails are computed once, on demand"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int calls = 0;
+				auto s = iterate([&calls](int x){ ++calls; return x*2; }, 1);
+				auto t = s;
+
+				bool lazy = s.deferred_tail().status() == value_status::deferred;
+				auto v1 = to_vector(take(4, s));
+				auto v2 = to_vector(take(4, t));
+
+				return lazy && calls == 3 && v1 == v2
+					&& v1 == std::vector<int>{1,2,4,8};
+			})
+		),
+		std::make_tuple(
+			std::string("unfold and takeWhile"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto s = unfold<int>([](int n) {
+					return n > 0
+						? just(std::make_tuple(n, n-1))
+						: nothing<std::tuple<int,int>>();
+				}, 5);
+
+				auto t = takeWhile([](int x){ return x < 4; }, naturals());
+
+				return to_vector(s) == std::vector<int>{5,4,3,2,1}
+					&& to_vector(t) == std::vector<int>{0,1,2,3};
+			})
+		),
+		std::make_tuple(
+			std::string("fmap and bind on infinite streams"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto sq = [](int x){ return x*x; } % naturals();
+				auto dup = naturals() >>= [](int x) {
+					return cons(x, monad<stream<int>>::pure(x));
+				};
+
+				return to_vector(take(4, sq)) == std::vector<int>{0,1,4,9}
+					&& to_vector(take(5, dup)) == std::vector<int>{0,0,1,1,2};
+			})
+		),
+		std::make_tuple(
+			std::string("filter, drop and append"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto odd = filter([](int x){ return x % 2 == 1; }, naturals());
+				auto s = take(2, naturals()) ^ take(2, drop(10, odd));
+
+				return to_vector(s) == std::vector<int>{0,1,21,23};
+			})
+		),
+		std::make_tuple(
+			std::string("zipWith stops at the shortest stream"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto s = zipWith(
+					[](int x, int y){ return x+y; },
+					take(3, naturals()), naturals()
+				);
+
+				return to_vector(s) == std::vector<int>{0,2,4};
+			})
+		),
+		std::make_tuple(
+			std::string("foldMap[any] terminates on infinite streams"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto s = iterate([](int x){ return x*2; }, 1);
+				bool big = foldMap([](int x){ return any(x > 1000); }, s);
+
+				auto f = take(4, naturals());
+				auto xs = foldr([](int x, std::vector<int> v) {
+					v.push_back(x);
+					return v;
+				}, std::vector<int>(), f);
+
+				return big
+					&& foldl(std::plus<int>(), 0, f) == 6
+					&& xs == std::vector<int>{3,2,1,0};
+			})
+		),
+		std::make_tuple(
+			std::string("Fused view pipeline over an infinite stream"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto s = naturals();
+				auto v = collect<std::vector>(take(3, filter(
+					[](int x){ return x % 4 == 0; },
+					[](int x){ return x*x; } % as_view(s)
+				)));
+
+				return v == std::vector<int>{0,4,16};
+			})
+		),
+		std::make_tuple(
+			std::string("Dropping a long stream"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				int n = 0;
+				{
+					auto s = take(100000, naturals());
+					for(auto& x : s)
+						n = x;
+				}
+
+				return n == 99999;
+			})
+		)
+	}
+};
+
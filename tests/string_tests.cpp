@@ -20,6 +20,7 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <ftl/vector.h>
 #include <ftl/string.h>
 #include "string_tests.h"
 
@@ -75,7 +76,65 @@ test_set string_tests{
 
 				return (std::move(s1) ^ std::move(s2)) == std::string("abcd");
 			})
+		),
+		std::make_tuple(
+			std::string("string_builder::monoid::append"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+				using ftl::string_builder;
+
+				string_builder b1("ab");
+				string_builder b2("cd");
+
+				auto b = b1 ^ (string_builder("01") ^ std::move(b2));
+				b = std::move(b) ^ b1;
+
+				return b.size() == 8 && std::move(b).str() == "ab01cdab";
+			})
+		),
+		std::make_tuple(
+			std::string("string_builder::foldMap"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::string> v{
+					"a", "few", "words", "long", "enough", "to", "need", "the", "heap"
+				};
+
+				auto s = ftl::foldMap(
+					[](const std::string& w){
+						return ftl::string_builder(w + " ");
+					},
+					v
+				).str();
+
+				return s == "a few words long enough to need the heap "
+					&& s.capacity() == s.size();
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::mconcat"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::string> v{
+					"concatenating ", "", "all of the strings ", "at once"
+				};
+
+				auto s = ftl::monoid<std::string>::mconcat(v);
+
+				return s == "concatenating all of the strings at once"
+					&& s.capacity() == s.size();
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::fold[mconcat]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<std::string> v{
+					"long enough ", "to need ", "the heap ", "in the end"
+				};
+
+				auto s = ftl::fold(v);
+
+				return s == "long enough to need the heap in the end"
+					&& s.capacity() == s.size();
+			})
 		)
 	}
 };
-
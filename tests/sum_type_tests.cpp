@@ -20,6 +20,8 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <ftl/sum_type.h>
 #include "sum_type_tests.h"
@@ -55,6 +57,28 @@ maybe<ftl::plain_type<T>> just(T&& t) {
 	};
 }
 
+// Non-trivial alternatives for wide sum types
+template<int I>
+struct alt {
+	std::string s;
+
+	bool operator== (const alt& a) const {
+		return s == a.s;
+	}
+
+	bool operator!= (const alt& a) const {
+		return s != a.s;
+	}
+};
+
+template<typename>
+struct sum_of;
+
+template<size_t...I>
+struct sum_of<ftl::seq<I...>> {
+	using type = ftl::sum_type<alt<I>...>;
+};
+
 test_set sum_type_tests{
 	std::string("sum_type"),
 	{
@@ -319,6 +343,69 @@ test_set sum_type_tests{
 				return i1 == 6 && i2 == 11;
 			})
 		),
+		std::make_tuple(
+			std::string("Many alternatives: copy, move and match"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				using big = sum_type<
+					char, short, int, long,
+					float, double, std::string, std::vector<int>
+				>;
+
+				big x{constructor<std::string>(), "string"};
+				big y{constructor<int>(), 2};
+
+				big z = x;
+				y = z;
+				big w = std::move(z);
+				w = big{constructor<std::vector<int>>(), {1,2,3}};
+
+				auto size = [](const big& b) {
+					return b.match(
+						[](const std::string& s){ return s.size(); },
+						[](const std::vector<int>& v){ return v.size(); },
+						[](otherwise){ return std::size_t(0); }
+					);
+				};
+
+				std::size_t seen = 0;
+				x.matchE(
+					[&](std::string& s){ s += "!"; seen = s.size(); },
+					[](otherwise){}
+				);
+
+				return size(x) == 7 && seen == 7 && size(y) == 6
+					&& size(w) == 3 && get<std::string>(y) == "string";
+			})
+		),
+		std::make_tuple(
+			std::string("Match on several sum types"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				struct A {};
+
+				sum_type<A,int> x{constructor<int>(), 2};
+				sum_type<A,int> y{constructor<A>()};
+				const sum_type<A,int,char> z{constructor<char>(), 'c'};
+
+				auto f = [](const sum_type<A,int>& a, const sum_type<A,int>& b) {
+					return match(a, b)(
+						[](int i, int j){ return i+j; },
+						[](int i, A){ return i; },
+						[](otherwise, otherwise){ return -1; }
+					);
+				};
+
+				match(x, z)(
+					[](int& i, char c){ i = c; },
+					[](otherwise, otherwise){}
+				);
+
+				return f(x, x) == 2*'c' && f(x, y) == 'c' && f(y, x) == -1;
+			})
+		),
 		std::make_tuple(
 			std::string("Maybe mockup"),
 			std::function<bool()>([]() -> bool {
@@ -335,6 +422,202 @@ test_set sum_type_tests{
 				return s1 == 12;
 			})
 		),
+		std::make_tuple(
+			std::string("std::hash"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using S = sum_type<int,char,std::string,double,long,short>;
+
+				std::hash<S> h;
+				S a{constructor<int>(), 1};
+				S b{constructor<int>(), 1};
+				S c{constructor<long>(), 1L};
+				S d{constructor<std::string>(), "abc"};
+
+				return h(a) == h(b) && h(a) != h(c)
+					&& h(d) == h(S{constructor<std::string>(), "abc"})
+					&& h(d) != h(S{constructor<std::string>(), "abd"});
+			})
+		),
+		std::make_tuple(
+			std::string("type functions[sequences and pack indexing]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::type_seq;
+				using std::is_same;
+
+				using ts = type_seq<char,int,float,double,bool>;
+
+				return is_same<ftl::gen_seq<2,5>, ftl::seq<2,3,4,5>>::value
+					&& is_same<ftl::gen_seq<0,0>, ftl::seq<0>>::value
+					&& is_same<ftl::type_at<3,char,int,float,double>, double>::value
+					&& is_same<ftl::get_nth<1,ts>::type, int>::value
+					&& is_same<ftl::get_last<char,int,float>::type, float>::value
+					&& ftl::index_of<double,char,int,float,double>::value == 3
+					&& ftl::index_of<int,ts>::value == 1
+					&& is_same<
+						ftl::take_types<2,char,int,float>::type,
+						type_seq<char,int>
+					>::value
+					&& is_same<
+						ftl::drop_types<2,char,int,float>::type, type_seq<float>
+					>::value
+					&& is_same<ftl::drop_types<4,char,int>::type, type_seq<>>::value
+					&& is_same<
+						ftl::take_init<char,int,float>::type, type_seq<char,int>
+					>::value
+					&& is_same<
+						ftl::map_types<std::add_pointer,ts>,
+						type_seq<char*,int*,float*,double*,bool*>
+					>::value
+					&& is_same<
+						ftl::zip_types<std::is_same,ts,type_seq<char,char>>,
+						type_seq<std::true_type,std::false_type>
+					>::value;
+			})
+		),
+		std::make_tuple(
+			std::string("sum_type[64 alternatives]"),
+			std::function<bool()>([]() -> bool {
+				using wide = sum_of<ftl::gen_seq<0,63>>::type;
+
+				wide a{ftl::constructor<alt<63>>(), alt<63>{"last"}};
+				wide b{ftl::constructor<alt<0>>(), alt<0>{"first"}};
+				wide c = a;
+
+				bool before = a == c && !(a == b);
+				c = b;
+
+				return before && c == b
+					&& ftl::get<63>(a).s == "last"
+					&& ftl::get<alt<0>>(c).s == "first"
+					&& a.is<alt<63>>() && !a.is<alt<31>>();
+			})
+		),
+		std::make_tuple(
+			std::string("operator=[same alternative keeps capacity]"),
+			std::function<bool()>([]() -> bool {
+				using st = ftl::sum_type<int,std::vector<int>>;
+
+				st a{ftl::constructor<std::vector<int>>()};
+				ftl::get<std::vector<int>>(a).reserve(64);
+				auto p = ftl::get<std::vector<int>>(a).data();
+
+				st b{ftl::constructor<std::vector<int>>(), {1,2,3}};
+				a = b;
+				bool copied = ftl::get<std::vector<int>>(a).data() == p
+					&& ftl::get<std::vector<int>>(a).capacity() >= 64;
+
+				a = st{ftl::constructor<std::vector<int>>(), {4,5}};
+				bool moved = ftl::get<std::vector<int>>(a)
+					== std::vector<int>{4,5};
+
+				return copied && moved
+					&& ftl::get<std::vector<int>>(b) == std::vector<int>{1,2,3};
+			})
+		),
+		std::make_tuple(
+			std::string("operator=[same alternative, jump table]"),
+			std::function<bool()>([]() -> bool {
+				using wide = sum_of<ftl::gen_seq<0,7>>::type;
+
+				wide a{ftl::constructor<alt<5>>(), alt<5>{"a"}};
+				ftl::get<alt<5>>(a).s.reserve(100);
+				auto p = ftl::get<alt<5>>(a).s.data();
+
+				wide b{ftl::constructor<alt<5>>(), alt<5>{"b"}};
+				a = b;
+				bool copied = ftl::get<alt<5>>(a).s.data() == p;
+
+				a = wide{ftl::constructor<alt<5>>(), alt<5>{"c"}};
+
+				return copied && ftl::get<alt<5>>(a).s == "c"
+					&& ftl::get<alt<5>>(b).s == "b";
+			})
+		),
+		std::make_tuple(
+			std::string("operator=[unassignable alternative]"),
+			std::function<bool()>([]() -> bool {
+				struct fixed {
+					const std::string s;
+				};
+
+				using st = ftl::sum_type<int,fixed>;
+
+				st a{ftl::constructor<fixed>(), fixed{"one"}};
+				st b{ftl::constructor<fixed>(), fixed{"two"}};
+				a = b;
+				bool copied = ftl::get<fixed>(a).s == "two";
+
+				a = st{ftl::constructor<fixed>(), fixed{"three"}};
+
+				return copied && ftl::get<fixed>(a).s == "three";
+			})
+		),
+		std::make_tuple(
+			std::string("emplace[other alternative]"),
+			std::function<bool()>([]() -> bool {
+				ftl::sum_type<int,std::string> x{ftl::constructor<int>(), 1};
+
+				auto& s = x.emplace<std::string>(3, 'a');
+
+				return x.is<std::string>() && s == "aaa"
+					&& &s == &ftl::get<std::string>(x);
+			})
+		),
+		std::make_tuple(
+			std::string("emplace[same alternative]"),
+			std::function<bool()>([]() -> bool {
+				ftl::sum_type<int,std::vector<int>> x{ftl::constructor<int>(), 1};
+
+				x.emplace<int>(5);
+				auto& v = x.emplace<std::vector<int>>({1,2,3});
+				x.emplace<std::vector<int>>(2, 7);
+
+				return x.is<std::vector<int>>() && v == std::vector<int>{7,7};
+			})
+		),
+		std::make_tuple(
+			std::string("emplace[throwing constructor]"),
+			std::function<bool()>([]() -> bool {
+				struct picky {
+					explicit picky(int x) : x(x) {
+						if(x < 0)
+							throw std::invalid_argument("negative");
+					}
+
+					int x;
+				};
+
+				ftl::sum_type<std::string,picky> v{
+					ftl::constructor<std::string>(), "kept"
+				};
+
+				bool threw = false;
+				try {
+					v.emplace<picky>(-1);
+				}
+				catch(std::invalid_argument&) {
+					threw = true;
+				}
+
+				bool kept = v.is<std::string>() && ftl::get<std::string>(v) == "kept";
+				v.emplace<picky>(2);
+
+				return threw && kept && ftl::get<picky>(v).x == 2;
+			})
+		),
+		std::make_tuple(
+			std::string("emplace[trivial alternatives]"),
+			std::function<bool()>([]() -> bool {
+				ftl::sum_type<int,double,char> x{ftl::constructor<int>(), 1};
+
+				x.emplace<char>('c');
+				bool c = x.is<char>() && ftl::get<char>(x) == 'c';
+				x.emplace<double>(1.5);
+
+				return c && x.is<double>() && ftl::get<double>(x) == 1.5;
+			})
+		)
 	}
 };
 
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <cstring>
+#include <sstream>
+#include <vector>
+#include <ftl/trace.h>
+#include <ftl/lazy.h>
+#include <ftl/async.h>
+#include <ftl/executor.h>
+#include "trace_tests.h"
+
+namespace {
+	// Events recorded while running f
+	template<typename F>
+	std::vector<ftl::trace_event> traced(F f) {
+		ftl::chrome_trace trace;
+		trace.install();
+		f();
+		ftl::set_trace_sink(nullptr);
+
+		return trace.events();
+	}
+
+	bool same_label(const char* a, const char* b) {
+		return a == b || (a && b && std::strcmp(a, b) == 0);
+	}
+
+	bool is_event(
+			const ftl::trace_event& e, ftl::trace_source s,
+			ftl::trace_phase p, const char* label) {
+		return e.source == s && e.phase == p && same_label(e.label, label);
+	}
+
+	// Number of events of source s
+	std::size_t count_of(
+			const std::vector<ftl::trace_event>& es, ftl::trace_source s) {
+		std::size_t n = 0;
+		for(auto& e : es) {
+			if(e.source == s)
+				++n;
+		}
+
+		return n;
+	}
+}
+
+test_set trace_tests{
+	std::string("trace"),
+	{
+		std::make_tuple(
+			std::string("lazy[labelled force]"),
+			std::function<bool()>([]() -> bool {
+				ftl::lazy<int> l(ftl::trace_label{"answer"}, [](){ return 42; });
+
+				auto es = traced([&l](){ *l; *l; });
+
+				if(!ftl::tracing)
+					return es.empty() && *l == 42;
+
+				using ftl::trace_source;
+				using ftl::trace_phase;
+				return es.size() == 2
+					&& is_event(es[0], trace_source::lazy, trace_phase::begin, "answer")
+					&& is_event(es[1], trace_source::lazy, trace_phase::end, "answer")
+					&& es[0].time <= es[1].time
+					&& *l == 42;
+			})
+		),
+		std::make_tuple(
+			std::string("lazy[unlabelled force]"),
+			std::function<bool()>([]() -> bool {
+				auto l = ftl::defer([](int x){ return x*2; }, 4);
+
+				auto es = traced([&l](){ *l; });
+
+				if(!ftl::tracing)
+					return es.empty();
+
+				using ftl::trace_source;
+				using ftl::trace_phase;
+				return es.size() == 2
+					&& is_event(es[0], trace_source::lazy, trace_phase::begin, nullptr)
+					&& is_event(es[1], trace_source::lazy, trace_phase::end, nullptr);
+			})
+		),
+		std::make_tuple(
+			std::string("defer[labelled]"),
+			std::function<bool()>([]() -> bool {
+				auto l = ftl::defer(
+					ftl::trace_label{"sum"}, [](int x, int y){ return x+y; }, 1, 2
+				);
+
+				auto es = traced([&l](){ *l; });
+
+				if(!ftl::tracing)
+					return es.empty() && *l == 3;
+
+				return es.size() == 2
+					&& same_label(es[0].label, "sum")
+					&& same_label(es[1].label, "sum")
+					&& *l == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("lazy[nested forces]"),
+			std::function<bool()>([]() -> bool {
+				ftl::lazy<int> inner(ftl::trace_label{"inner"}, [](){ return 1; });
+				ftl::lazy<int> outer(ftl::trace_label{"outer"}, [inner](){
+					return *inner + 1;
+				});
+
+				auto es = traced([&outer](){ *outer; });
+
+				if(!ftl::tracing)
+					return es.empty() && *outer == 2;
+
+				using ftl::trace_source;
+				using ftl::trace_phase;
+				return es.size() == 4
+					&& is_event(es[0], trace_source::lazy, trace_phase::begin, "outer")
+					&& is_event(es[1], trace_source::lazy, trace_phase::begin, "inner")
+					&& is_event(es[2], trace_source::lazy, trace_phase::end, "inner")
+					&& is_event(es[3], trace_source::lazy, trace_phase::end, "outer");
+			})
+		),
+		std::make_tuple(
+			std::string("lazy[no sink]"),
+			std::function<bool()>([]() -> bool {
+				ftl::chrome_trace trace;
+				trace.install();
+				ftl::set_trace_sink(nullptr);
+
+				ftl::lazy<int> l(ftl::trace_label{"quiet"}, [](){ return 1; });
+				*l;
+
+				return trace.events().empty();
+			})
+		),
+		std::make_tuple(
+			std::string("async[labelled task and continuation]"),
+			std::function<bool()>([]() -> bool {
+				ftl::inline_executor ex;
+				int r = 0;
+
+				auto es = traced([&](){
+					auto f = ftl::async(ex, ftl::trace_label{"work"}, [](){
+						return 20;
+					});
+					auto g = ftl::fmap([](int x){ return x+1; }, f);
+					r = g.get();
+				});
+
+				if(!ftl::tracing)
+					return es.empty() && r == 21;
+
+				using ftl::trace_source;
+				using ftl::trace_phase;
+				return es.size() == 4
+					&& is_event(es[0], trace_source::async, trace_phase::begin, "work")
+					&& is_event(es[1], trace_source::async, trace_phase::end, "work")
+					&& is_event(es[2], trace_source::continuation, trace_phase::begin, nullptr)
+					&& is_event(es[3], trace_source::continuation, trace_phase::end, nullptr)
+					&& r == 21;
+			})
+		),
+		std::make_tuple(
+			std::string("thread_pool[tasks]"),
+			std::function<bool()>([]() -> bool {
+				int r = 0;
+
+				auto es = traced([&r](){
+					ftl::thread_pool pool(2);
+					auto f = ftl::async(pool, ftl::trace_label{"pooled"}, [](){
+						return 7;
+					});
+					r = f.get();
+				});
+
+				if(!ftl::tracing)
+					return es.empty() && r == 7;
+
+				using ftl::trace_source;
+				using ftl::trace_phase;
+
+				// The pool's events enclose the task's, all on the same thread
+				return es.size() == 4
+					&& is_event(es[0], trace_source::executor, trace_phase::begin, nullptr)
+					&& is_event(es[1], trace_source::async, trace_phase::begin, "pooled")
+					&& is_event(es[2], trace_source::async, trace_phase::end, "pooled")
+					&& is_event(es[3], trace_source::executor, trace_phase::end, nullptr)
+					&& es[0].thread == es[3].thread
+					&& es[0].thread != std::this_thread::get_id()
+					&& r == 7;
+			})
+		),
+		std::make_tuple(
+			std::string("work_stealing_pool[tasks]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<ftl::trace_event> es;
+
+				{
+					ftl::chrome_trace trace;
+					trace.install();
+					{
+						ftl::work_stealing_pool pool(2);
+						for(int i = 0; i < 8; ++i)
+							pool.execute([](){});
+					}
+					ftl::set_trace_sink(nullptr);
+					es = trace.events();
+				}
+
+				if(!ftl::tracing)
+					return es.empty();
+
+				return count_of(es, ftl::trace_source::executor) == 16;
+			})
+		),
+		std::make_tuple(
+			std::string("chrome_trace[write]"),
+			std::function<bool()>([]() -> bool {
+				ftl::chrome_trace trace;
+				auto t = std::chrono::steady_clock::now();
+				auto id = std::this_thread::get_id();
+
+				ftl::chrome_trace::record(ftl::trace_event{
+					ftl::trace_source::lazy, ftl::trace_phase::begin,
+					"say \"hi\"", id, t
+				}, &trace);
+				ftl::chrome_trace::record(ftl::trace_event{
+					ftl::trace_source::lazy, ftl::trace_phase::end,
+					nullptr, id, t
+				}, &trace);
+
+				std::ostringstream os;
+				trace.write(os);
+				auto s = os.str();
+
+				return s.find("{\"traceEvents\":[") == 0
+					&& s.find("\"name\":\"say \\\"hi\\\"\",\"cat\":\"lazy\",\"ph\":\"B\"")
+						!= std::string::npos
+					&& s.find("\"name\":\"lazy\",\"cat\":\"lazy\",\"ph\":\"E\"")
+						!= std::string::npos
+					&& s.find("\"pid\":1,\"tid\":0}") != std::string::npos
+					&& s.rfind("]}\n") == s.size() - 3;
+			})
+		),
+		std::make_tuple(
+			std::string("chrome_trace[clear]"),
+			std::function<bool()>([]() -> bool {
+				ftl::chrome_trace trace;
+				ftl::chrome_trace::record(ftl::trace_event{
+					ftl::trace_source::async, ftl::trace_phase::begin, nullptr,
+					std::this_thread::get_id(), std::chrono::steady_clock::now()
+				}, &trace);
+
+				auto n = trace.events().size();
+				trace.clear();
+
+				std::ostringstream os;
+				trace.write(os);
+
+				return n == 1 && trace.events().empty()
+					&& os.str() == "{\"traceEvents\":[\n]}\n";
+			})
+		)
+	}
+};
+
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <ftl/trampoline.h>
+#include "trampoline_tests.h"
+
+namespace {
+	ftl::trampoline<long> sum_to(long n) {
+		using ftl::operator>>=;
+
+		if(n == 0)
+			return ftl::done(0L);
+
+		return ftl::suspend([n]{ return sum_to(n-1); })
+			>>= [n](long s){ return ftl::done(s + n); };
+	}
+
+	ftl::trampoline<bool> is_odd(int n);
+
+	ftl::trampoline<bool> is_even(int n) {
+		if(n == 0)
+			return ftl::done(true);
+
+		return ftl::suspend([n]{ return is_odd(n-1); });
+	}
+
+	ftl::trampoline<bool> is_odd(int n) {
+		if(n == 0)
+			return ftl::done(false);
+
+		return ftl::suspend([n]{ return is_even(n-1); });
+	}
+}
+
+test_set trampoline_tests{
+	std::string("trampoline"),
+	{
+		std::make_tuple(
+			std::string("done"),
+			std::function<bool()>([]() -> bool {
+				auto t = ftl::done(std::string("abc"));
+
+				return t.run() == "abc";
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				auto t = [](int x){ return x * .5f; } % ftl::done(3);
+
+				return t.run() == 1.5f;
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind[deep recursion]"),
+			std::function<bool()>([]() -> bool {
+				return sum_to(300000).run() == 45000150000L;
+			})
+		),
+		std::make_tuple(
+			std::string("monad::bind[left nested]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				auto t = ftl::done(0);
+				for(int i = 0; i < 300000; ++i) {
+					t = t >>= [](int x){ return ftl::done(x+1); };
+				}
+
+				return t.run() == 300000;
+			})
+		),
+		std::make_tuple(
+			std::string("suspend[mutual recursion]"),
+			std::function<bool()>([]() -> bool {
+				return is_even(300000).run() && is_odd(300001).run();
+			})
+		),
+		std::make_tuple(
+			std::string("run[repeatable]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator>>=;
+
+				int calls = 0;
+				auto t = ftl::done(1) >>= [&calls](int x){
+					++calls;
+					return ftl::done(x+1);
+				};
+
+				return t.run() == 2 && t.run() == 2 && calls == 2;
+			})
+		)
+	}
+};
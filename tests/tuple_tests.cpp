@@ -20,7 +20,10 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <unordered_map>
 #include <ftl/tuple.h>
+#include <ftl/string.h>
+#include <ftl/vector.h>
 #include "tuple_tests.h"
 
 test_set tuple_tests{
@@ -46,6 +49,61 @@ test_set tuple_tests{
 				return (t1 ^ t2) == std::make_tuple(sum(3), prod(6));
 			})
 		),
+		std::make_tuple(
+			std::string("monoid::append[&&,&]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> v{1,2};
+				v.reserve(4);
+				auto p = v.data();
+
+				auto t1 = std::make_tuple(std::move(v), sum(2));
+				auto t2 = std::make_tuple(std::vector<int>{3,4}, sum(1));
+
+				auto t3 = std::move(t1) ^ t2;
+
+				return t3 == std::make_tuple(std::vector<int>{1,2,3,4}, sum(3))
+					&& std::get<0>(t3).data() == p
+					&& std::get<0>(t2) == std::vector<int>{3,4};
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append[&,&&]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::string s(32, 'b');
+				s.reserve(40);
+				auto p = s.data();
+
+				auto t1 = std::make_tuple(std::string("a"), prod(2));
+				auto t2 = std::make_tuple(std::move(s), prod(3));
+
+				auto t3 = t1 ^ std::move(t2);
+
+				return std::get<0>(t3) == "a" + std::string(32, 'b')
+					&& std::get<0>(t3).data() == p
+					&& std::get<1>(t3) == 6
+					&& std::get<0>(t1) == "a";
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::append[&&,&&]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> v{1};
+				v.reserve(2);
+				auto p = v.data();
+
+				auto t = std::move(std::make_tuple(std::move(v), sum(1)))
+					^ std::make_tuple(std::vector<int>{2}, sum(2));
+
+				return t == std::make_tuple(std::vector<int>{1,2}, sum(3))
+					&& std::get<0>(t).data() == p;
+			})
+		),
 		std::make_tuple(
 			std::string("functor::map"),
 			std::function<bool()>([]() -> bool {
@@ -78,6 +136,25 @@ test_set tuple_tests{
 
 				return t == make_tuple(6, sum(5), prod(6));
 			})
+		),
+		std::make_tuple(
+			std::string("tuple_hash"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+				using std::make_tuple;
+
+				tuple_hash h;
+				std::unordered_map<std::tuple<int,std::string>,int,tuple_hash> m;
+				m[make_tuple(1, std::string("a"))] = 1;
+				m[make_tuple(2, std::string("a"))] = 2;
+
+				return h(make_tuple(1, 2)) == h(make_tuple(1, 2))
+					&& h(make_tuple(1, 2)) != h(make_tuple(2, 1))
+					&& h(make_tuple(0, 0)) != h(make_tuple(0))
+					&& h(std::make_pair(1, make_tuple(2, 3)))
+						== h(std::make_pair(1, make_tuple(2, 3)))
+					&& m.size() == 2 && m.at(make_tuple(2, std::string("a"))) == 2;
+			})
 		)
 	}
 };
@@ -20,9 +20,21 @@
  * 3. This notice may not be removed or altered from any source
  * distribution.
  */
+#include <string>
 #include <ftl/unordered_map.h>
 #include "unordered_map_tests.h"
 
+namespace {
+	// Hash function with state that must be carried over to mapped maps
+	struct seeded_hash {
+		std::size_t operator() (int x) const noexcept {
+			return std::hash<int>()(x) ^ seed;
+		}
+
+		std::size_t seed;
+	};
+}
+
 test_set unordered_map_tests{
 	std::string("unordered_map"),
 	{
@@ -87,6 +99,46 @@ test_set unordered_map_tests{
 					make_pair(2,4)
 				};
 			})
+		),
+		std::make_tuple(
+			std::string("functor::map[keeps buckets and hash]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::unordered_map<int,int,seeded_hash> m(
+					1000, seeded_hash{42}
+				);
+				m.max_load_factor(0.5f);
+				for(int i = 0; i < 100; ++i)
+					m.emplace(i, i);
+
+				auto r1 = [](int x){ return std::to_string(x); } % m;
+				auto r2 = [](int x){ return double(x); }
+					% std::unordered_map<int,int,seeded_hash>(m);
+
+				bool same_buckets = true;
+				for(int i = 0; i < 100; ++i)
+					same_buckets = same_buckets && r1.bucket(i) == m.bucket(i);
+
+				return r1.bucket_count() == m.bucket_count()
+					&& r2.bucket_count() == m.bucket_count()
+					&& r1.max_load_factor() == 0.5f
+					&& r1.hash_function().seed == 42
+					&& same_buckets && r1.at(7) == "7" && r2.at(7) == 7.0;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[a->a,&&,in place]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::unordered_map<int,int> m{{1,1}, {2,2}, {3,3}};
+				auto p = &*m.find(2);
+
+				auto r = [](int x){ return x*10; } % std::move(m);
+
+				return &*r.find(2) == p && r.at(2) == 20 && r.at(3) == 30;
+			})
 		)
 	}
 };
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <string>
+#include <vector>
+#include <ftl/validation.h>
+#include <ftl/instrument.h>
+#include <ftl/prelude.h>
+#include "validation_tests.h"
+
+namespace {
+	using checked = ftl::validation<std::string,int>;
+
+	checked positive(int x, const char* field) {
+		return x > 0 ? ftl::valid<std::string>(x)
+			: ftl::invalid<int>(std::string(field));
+	}
+
+	struct record {
+		int a, b, c, d;
+	};
+
+	auto make_record = ftl::curry([](int a, int b, int c, int d) {
+		return record{a, b, c, d};
+	});
+}
+
+test_set validation_tests{
+	std::string("validation"),
+	{
+		std::make_tuple(
+			std::string("All valid"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto r = make_record % positive(1, "a") * positive(2, "b")
+					* positive(3, "c") * positive(4, "d");
+
+				return r.is<Right<record>>() && get<Right<record>>(r)->d == 4
+					&& errors(r).empty();
+			})
+		),
+		std::make_tuple(
+			std::string("Errors accumulate in order"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto r = make_record % positive(0, "a") * positive(2, "b")
+					* positive(0, "c") * positive(-1, "d");
+
+				auto es = errors(r);
+				return es.size() == 3
+					&& es[0] == "a" && es[1] == "c" && es[2] == "d";
+			})
+		),
+		std::make_tuple(
+			std::string("Few errors do not allocate"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto count = [](){
+					return allocation_count(alloc_source::small_vector).allocations;
+				};
+
+				auto before = count();
+				auto r1 = make_record % positive(0, "a") * positive(0, "b")
+					* positive(0, "c") * positive(0, "d");
+				auto few = count() - before;
+
+				// Past the inline capacity of 2
+				auto keep = curry([](record x, int){ return x; });
+				auto r2 = invalid<record,2>(std::string("a"));
+				for(int i = 0; i < 4; ++i)
+					r2 = keep % std::move(r2) * invalid<int,2>(std::string("x"));
+				auto many = count() - before;
+
+				return few == 0 && errors(r1).size() == 4
+					&& errors(r1).is_inline()
+					&& (allocation_counting ? many > 0 : many == 0)
+					&& errors(r2).size() == 5;
+			})
+		),
+		std::make_tuple(
+			std::string("traverse collects every error"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> xs{1, -2, 3, -4};
+				auto check = [](int x){ return positive(x, x < -3 ? "-4" : "-2"); };
+
+				auto r = traverse(check, xs);
+				auto ok = traverse(check, std::vector<int>{1, 2});
+
+				return errors(r).size() == 2 && errors(r)[1] == "-4"
+					&& ok == valid<std::string>(std::vector<int>{1, 2});
+			})
+		),
+		std::make_tuple(
+			std::string("Conversions to and from either"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				auto v = toValidation(make_left<int>(std::string("bad")));
+				auto e = toEither(positive(3, "x"));
+
+				return errors(v).size() == 1 && errors(v)[0] == "bad"
+					&& e == make_right<small_vector<std::string,4>>(3);
+			})
+		)
+	}
+};
+
@@ -21,7 +21,10 @@
  * distribution.
  */
 #include <ftl/vector.h>
+#include <ftl/maybe.h>
+#include <functional>
 #include <list>
+#include <string>
 #include "vector_tests.h"
 
 test_set vector_tests{
@@ -56,6 +59,28 @@ test_set vector_tests{
 				return v == std::vector<int>{4,3,6,5,8,7};
 			})
 		),
+		std::make_tuple(
+			std::string("concatMap[uneven, adopts first]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> first;
+				first.reserve(16);
+				first.push_back(0);
+				auto p = first.data();
+
+				std::vector<std::vector<int>> v;
+				v.push_back(std::move(first));
+				v.push_back({});
+				v.push_back({1,2,3,4,5});
+				v.push_back({6});
+
+				auto r = ftl::concatMap(
+					[](std::vector<int>&& x){ return std::move(x); },
+					std::move(v)
+				);
+
+				return r == std::vector<int>{0,1,2,3,4,5,6} && r.data() == p;
+			})
+		),
 		std::make_tuple(
 			std::string("monoid::id"),
 			std::function<bool()>([]() -> bool {
@@ -108,6 +133,40 @@ test_set vector_tests{
 					(std::move(v1) ^ std::move(v2)) == std::vector<int>{1,2,2,3};
 			})
 		),
+		std::make_tuple(
+			std::string("monoid::append[&,&&,full]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator^;
+
+				auto v1 = std::vector<int>{1,2};
+				auto v2 = std::vector<int>{3,4,5};
+				v2.shrink_to_fit();
+
+				auto r = v1 ^ std::move(v2);
+
+				return r == std::vector<int>{1,2,3,4,5}
+					&& r.capacity() == r.size();
+			})
+		),
+		std::make_tuple(
+			std::string("monoid::mconcat"),
+			std::function<bool()>([]() -> bool {
+				using vec = std::vector<int>;
+
+				std::list<vec> l{vec{1}, vec{}, vec{2,3}, vec{4}};
+				auto r1 = ftl::monoid<vec>::mconcat(l);
+
+				std::vector<vec> v;
+				v.push_back(vec{1,2});
+				v.push_back(vec{3});
+				v.front().reserve(3);
+				auto p = v.front().data();
+				auto r2 = ftl::monoid<vec>::mconcat(std::move(v));
+
+				return r1 == vec{1,2,3,4} && r1.capacity() == 4
+					&& r2 == vec{1,2,3} && r2.data() == p;
+			})
+		),
 		std::make_tuple(
 			std::string("functor::map[a->b,&"),
 			std::function<bool()>([]() -> bool {
@@ -241,6 +300,24 @@ test_set vector_tests{
 				return fold(v) == 12;
 			})
 		),
+		std::make_tuple(
+			std::string("foldable::foldMap[sum,prod]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> v;
+				for(int i = 1; i <= 1003; ++i)
+					v.push_back(i);
+
+				std::vector<double> d{.5, 2., 4., .25, 2., 3., 1.5};
+
+				auto s = foldMap(sum<int>, v);
+				auto p = foldMap([](double x){ return prod(x); }, d);
+				auto e = foldMap(sum<int>, std::vector<int>{});
+
+				return s == 1003*1004/2 && p == 9. && e == 0;
+			})
+		),
 		std::make_tuple(
 			std::string("zippable::zipWith[3,3]"),
 			std::function<bool()>([]() -> bool {
@@ -322,7 +399,194 @@ test_set vector_tests{
 					std::make_tuple(3,1.f)
 				};
 			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith[3-ary]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> v1{1,2,3,4,5};
+				std::list<int> l{10,20,30};
+				std::vector<float> v2{.5f,.5f,.5f,.5f};
+
+				auto v3 = zipWith(
+					[](int x, int y, float w){ return (x + y) * w; },
+					v1, l, v2
+				);
+
+				return v3 == std::vector<float>{5.5f,11.f,16.5f}
+					&& v3.capacity() == v3.size();
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zip[3-ary]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<int> v1{1,2};
+				std::vector<char> v2{'a','b','c'};
+				std::list<float> l{3.f,2.f};
+
+				auto v3 = zip(v1, v2, l);
+
+				return v3 == std::vector<std::tuple<int,char,float>>{
+					std::make_tuple(1,'a',3.f),
+					std::make_tuple(2,'b',2.f)
+				};
+			})
+		),
+		std::make_tuple(
+			std::string("liftA"),
+			std::function<bool()>([]() -> bool {
+				auto sum3 = [](int x, int y, int z){ return x + y + z; };
+				auto pair = [](int x, char c){ return std::to_string(x) + c; };
+
+				std::vector<int> v1{1, 2}, v2{10, 20}, v3{100};
+
+				auto r = ftl::liftA(sum3, v1, v2, v3);
+				auto s = ftl::liftA(pair, v1, std::vector<char>{'a', 'b'});
+				auto t = ftl::liftA(sum3, v1, std::vector<int>{}, v3);
+
+				return r == std::vector<int>{111, 121, 112, 122}
+					&& r.capacity() == 4
+					&& s == std::vector<std::string>{"1a", "1b", "2a", "2b"}
+					&& t.empty();
+			})
+		),
+		std::make_tuple(
+			std::string("liftA[same as apply]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+				using ftl::operator*;
+
+				auto minus = [](int x, int y){ return x - y; };
+				std::vector<int> v1{5, 7, 9}, v2{1, 2};
+
+				auto applied = ftl::curry<2>(minus) % v1 * v2;
+
+				return ftl::liftA(minus, v1, v2) == applied
+					&& ftl::liftA([](int x){ return -x; }, v2)
+						== std::vector<int>{-1, -2};
+			})
+		),
+		std::make_tuple(
+			std::string("filter"),
+			std::function<bool()>([]() -> bool {
+				auto even = [](int x){ return x % 2 == 0; };
+
+				std::vector<int> v{1, 2, 3, 4, 5, 6};
+				auto copied = ftl::filter(even, v);
+
+				auto p = v.data();
+				auto moved = ftl::filter(even, std::move(v));
+
+				return copied == std::vector<int>{2, 4, 6}
+					&& copied.capacity() == 6
+					&& moved == copied && moved.data() == p;
+			})
+		),
+		std::make_tuple(
+			std::string("mapMaybe"),
+			std::function<bool()>([]() -> bool {
+				auto half = [](int x){
+					return x % 2 ? ftl::nothing<int>() : ftl::just(x/2);
+				};
+				auto named = [](int x){
+					return x > 2
+						? ftl::just(std::to_string(x)) : ftl::nothing<std::string>();
+				};
+
+				std::vector<int> v{1, 2, 3, 4};
+				auto strs = ftl::mapMaybe(named, v);
+
+				auto p = v.data();
+				auto halves = ftl::mapMaybe(half, std::move(v));
+
+				return strs == std::vector<std::string>{"3", "4"}
+					&& halves == std::vector<int>{1, 2} && halves.data() == p;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[numbers,&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<float> v;
+				for(int i = 0; i < 37; ++i)
+					v.push_back(float(i));
+
+				auto twice = [](float x){ return x*2.f; } % v;
+				auto halves = [](float x){ return double(x)/2; } % v;
+				auto negated = std::negate<float>() % v;
+
+				for(int i = 0; i < 37; ++i) {
+					if(twice[i] != 2.f*i || halves[i] != i/2.
+							|| negated[i] != -float(i))
+						return false;
+				}
+
+				return twice.size() == 37 && halves.size() == 37
+					&& negated.size() == 37;
+			})
+		),
+		std::make_tuple(
+			std::string("functor::map[numbers,&&]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> v{1, 2, 3, 4, 5, 6, 7, 8, 9};
+				auto p = v.data();
+				auto w = std::negate<int>() % std::move(v);
+				auto u = [](int x){ return x+1; } % std::move(w);
+				auto f = [](int x){ return float(x); } % std::move(u);
+
+				return u.data() == p
+					&& f == std::vector<float>{0, -1, -2, -3, -4, -5, -6, -7, -8};
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith[numbers]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<double> a, b;
+				for(int i = 0; i < 41; ++i) {
+					a.push_back(i);
+					b.push_back(i+1);
+				}
+				b.push_back(100);
+
+				auto sums = zipWith(std::plus<double>(), a, b);
+				auto quots = zipWith(std::divides<double>(), a, b);
+				auto mixed = zipWith(
+					[](double x, int y){ return x*y; }, a, std::vector<int>{2, 3}
+				);
+
+				for(int i = 0; i < 41; ++i) {
+					if(sums[i] != 2*i+1 || quots[i] != i/double(i+1))
+						return false;
+				}
+
+				return sums.size() == 41 && quots.size() == 41
+					&& mixed == std::vector<double>{0, 3};
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith[numbers, wrapping]"),
+			std::function<bool()>([]() -> bool {
+				using namespace ftl;
+
+				std::vector<unsigned char> a(35, 200), b(35, 100);
+				auto s = zipWith(std::plus<unsigned char>(), a, b);
+				auto d = zipWith(std::minus<unsigned char>(), b, a);
+				auto p = zipWith(std::multiplies<unsigned char>(), a, b);
+
+				return s == std::vector<unsigned char>(35, 44)
+					&& d == std::vector<unsigned char>(35, 156)
+					&& p == std::vector<unsigned char>(35, 32);
+			})
 		)
+
 	}
 };
 
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2013 Björn Aili
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source
+ * distribution.
+ */
+#include <list>
+#include <set>
+#include <ftl/vector.h>
+#include <ftl/view.h>
+#include "view_tests.h"
+
+static_assert(
+	ftl::ForwardIterator<
+		ftl::view<ftl::_dtl::range_view<std::vector<int>::iterator>>::iterator
+	>(),
+	"Views of containers keep their iterator category"
+);
+
+test_set view_tests{
+	std::string("view"),
+	{
+		std::make_tuple(
+			std::string("functor::map[lazy]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				int calls = 0;
+				auto f = [&calls](int x){ ++calls; return x+1; };
+				std::vector<int> v{1,2,3};
+
+				auto r = f % (f % ftl::as_view(v));
+				bool lazy = calls == 0;
+
+				auto w = ftl::collect<std::vector>(r);
+
+				return lazy && calls == 6 && w == std::vector<int>{3,4,5};
+			})
+		),
+		std::make_tuple(
+			std::string("filter"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::list<int> l{1,2,3,4,5,6};
+				auto even = [](int x){ return x % 2 == 0; };
+				auto sq = [](int x){ return x*x; };
+
+				auto r = ftl::collect<std::list>(
+					sq % ftl::filter(even, ftl::as_view(l))
+				);
+
+				return r == std::list<int>{4,16,36};
+			})
+		),
+		std::make_tuple(
+			std::string("filter[of map]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				int calls = 0;
+				auto sq = [&calls](int x){ ++calls; return x*x; };
+				auto big = [](int x){ return x > 10; };
+				std::vector<int> v{1,2,3,4,5,6};
+
+				auto r = ftl::collect<std::vector>(
+					ftl::filter(big, sq % ftl::as_view(v))
+				);
+
+				return calls == 6 && r == std::vector<int>{16,25,36};
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::vector<int> v1{1,2,3,4};
+				std::vector<int> v2{10,20,30};
+				auto f = [](int x){ return x*2; };
+
+				auto r = ftl::zipWith(
+					[](int x, int y){ return x+y; },
+					f % ftl::as_view(v1),
+					v2
+				);
+
+				return ftl::collect<std::vector>(r) == std::vector<int>{12,24,36};
+			})
+		),
+		std::make_tuple(
+			std::string("concatMap"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v{0,2,1,3};
+
+				auto r = ftl::concatMap(
+					[](int x){ return std::vector<int>(x, x); },
+					ftl::as_view(v)
+				);
+
+				return ftl::collect<std::vector>(r)
+					== std::vector<int>{2,2,1,3,3,3};
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldl"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				std::set<int> s{1,2,3,4};
+				auto f = [](int x){ return x*10; };
+
+				auto r = ftl::foldl(
+					[](int z, int x){ return z-x; }, 0, f % ftl::as_view(s)
+				);
+
+				return r == -100;
+			})
+		),
+		std::make_tuple(
+			std::string("foldable::foldMap[short-circuit]"),
+			std::function<bool()>([]() -> bool {
+				using ftl::operator%;
+
+				int calls = 0;
+				auto big = [&calls](int x){ ++calls; return ftl::any(x > 2); };
+				std::vector<int> v{1,2,3,4,5};
+
+				auto r = ftl::foldMap(big, ftl::as_view(v));
+
+				return static_cast<bool>(r) && calls == 3;
+			})
+		),
+		std::make_tuple(
+			std::string("zippable::zipWith[3-ary]"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v1{1,2,3,4};
+				std::list<int> l{10,20,30};
+				std::set<int> s{100,200,300,400};
+
+				auto r = ftl::zipWith(
+					[](int x, int y, int z){ return x+y+z; },
+					ftl::as_view(v1), l, s
+				);
+
+				return ftl::collect<std::vector>(r)
+					== std::vector<int>{111,222,333};
+			})
+		),
+		std::make_tuple(
+			std::string("as_zip_view"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v{1,2,3};
+				std::list<int> l{4,5,6,7};
+
+				auto z = ftl::as_zip_view(v, l);
+				auto& first = std::get<0>(*z.begin());
+
+				auto dot = ftl::foldl(
+					[](int acc, std::tuple<const int&,const int&> t) {
+						return acc + std::get<0>(t) * std::get<1>(t);
+					},
+					0, z
+				);
+
+				return dot == 32 && &first == &v[0];
+			})
+		),
+		std::make_tuple(
+			std::string("take and takeWhile"),
+			std::function<bool()>([]() -> bool {
+				std::vector<int> v{1,2,3,4,5,1};
+				int calls = 0;
+
+				auto sq = [&calls](int x){ ++calls; return x*x; };
+				auto t = ftl::take(3, sq % ftl::as_view(v));
+				auto w = ftl::takeWhile(
+					[](int x){ return x < 4; }, ftl::as_view(v)
+				);
+
+				auto r1 = ftl::collect<std::vector>(t);
+				auto r2 = ftl::collect<std::vector>(w);
+				auto r3 = ftl::collect<std::vector>(ftl::take(10, ftl::as_view(v)));
+
+				return r1 == std::vector<int>{1,4,9} && calls == 3
+					&& r2 == std::vector<int>{1,2,3}
+					&& r3 == v;
+			})
+		)
+	}
+};